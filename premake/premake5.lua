@@ -2,12 +2,17 @@ require("premake-qt/qt")
 
 local qt = premake.extensions.qt;
 
+newoption {
+	trigger = "deterministic",
+	description = "Build with strict floating point, so that every machine steps the simulation to the same bits"
+}
+
 workspace "MAD"
 	location "../projects"
 	language "C++"
 	architecture "x86_64"
 	configurations { "DebugEditor", "DebugGame", "ReleaseEditor", "ReleaseGame" }
-	flags { "FloatFast", "EnableSSE2", "StaticRuntime", "MultiProcessorCompile" }
+	flags { "EnableSSE2", "StaticRuntime", "MultiProcessorCompile" }
 	
 	filter { "configurations:DebugEditor" }
 		defines { "_DEBUG", "DEBUG", "MAD_EDITOR" }
@@ -31,6 +36,18 @@ workspace "MAD"
 		optimize "Speed"
 		inlining "Auto"
 
+	-- Deterministic builds step the simulation to the same bits on every machine and compiler, which rules out fast math.
+	-- Clang and GCC also have to be kept from fusing multiplies and adds, since that changes the rounding
+	filter { "options:not deterministic" }
+		flags { "FloatFast" }
+
+	filter { "options:deterministic" }
+		floatingpoint "Strict"
+		defines { "MAD_DETERMINISTIC_SIMULATION=1" }
+
+	filter { "options:deterministic", "toolset:gcc or clang" }
+		buildoptions { "-ffp-contract=off" }
+
 	filter { }
 	
 	targetdir ("%{prj.location}/build/bin/%{cfg.longname}")
@@ -106,7 +123,7 @@ function useAssimp()
 end
 
 function useDirectX()
-	links { "d3d11", "dxgi", "d3dcompiler" }
+	links { "d3d11", "dxgi", "d3dcompiler", "windowscodecs" }
 end
 
 function useDirectXTK()
@@ -184,3 +201,35 @@ project "Game"
 	entrypoint "mainCRTStartup"
 
 	postbuildcommands { "call \"$(SolutionDir)..\\premake\\MADStage.bat\" \"%{prj.name}\" \"$(TargetDir)\" \"$(SolutionDir)\"" }
+
+group "Tools"
+
+project "MeshCooker"
+	location "../projects/MeshCooker"
+	kind "ConsoleApp"
+	files "../projects/MeshCooker/src/**"
+	commonSetup()
+	useEngine()
+
+project "ParticleBenchmark"
+	location "../projects/ParticleBenchmark"
+	kind "ConsoleApp"
+	files "../projects/ParticleBenchmark/src/**"
+	commonSetup()
+	useEngine()
+
+project "PhysicsBenchmark"
+	location "../projects/PhysicsBenchmark"
+	kind "ConsoleApp"
+	files "../projects/PhysicsBenchmark/src/**"
+	commonSetup()
+	useEngine()
+
+project "ShadowCascadeTest"
+	location "../projects/ShadowCascadeTest"
+	kind "ConsoleApp"
+	files "../projects/ShadowCascadeTest/src/**"
+	commonSetup()
+	useEngine()
+
+group ""
@@ -4,6 +4,7 @@
 //=>:(Usage, PS, ps_5_0)
 //=>:(Permute, DIFFUSE)
 //=>:(Permute, OPACITY_MASK)
+//=>:(Permute, INSTANCED)
 
 // Input structs for vertex and pixel shader
 struct VS_INPUT
@@ -11,6 +12,7 @@ struct VS_INPUT
 	float3 mModelPos     : POSITION;
 	float3 mModelNormal  : NORMAL;
 	float2 mTex          : TEXCOORD;
+	INSTANCE_INPUT
 };
 
 struct PS_INPUT
@@ -28,10 +30,10 @@ PS_INPUT VS(VS_INPUT input)
 {
 	PS_INPUT psInput;
 
-	psInput.mHomogenousPos = mul(float4(input.mModelPos, 1.0f), g_objectToProjectionMatrix);
-	psInput.mWSPosition = mul(float4(input.mModelPos, 1.0f), g_objectToWorldMatrix).xyz;
+	psInput.mHomogenousPos = mul(float4(input.mModelPos, 1.0f), OBJECT_TO_PROJECTION(input));
+	psInput.mWSPosition = mul(float4(input.mModelPos, 1.0f), OBJECT_TO_WORLD(input)).xyz;
 	psInput.mTex = input.mTex;
-	psInput.mVSNormal = mul(float4(input.mModelNormal, 0.0f), g_objectToViewMatrix).xyz;
+	psInput.mVSNormal = mul(float4(input.mModelNormal, 0.0f), OBJECT_TO_VIEW(input)).xyz;
 	return psInput;
 }
 
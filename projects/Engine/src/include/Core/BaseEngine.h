@@ -2,6 +2,7 @@
 
 #include <atomic>
 
+#include <EASTL/hash_map.h>
 #include <EASTL/shared_ptr.h>
 #include <EASTL/weak_ptr.h>
 #include <EASTL/string.h>
@@ -60,6 +61,10 @@ namespace MAD
 		double GetGameTimeDouble() const { return m_gameTime; }
 		uint32_t GetGameTick() const { return m_gameTick; }
 
+		// Checksum of the entities and bodies of every world as of the end of the last tick, only computed with -SimChecksum.
+		// Each tick's checksum is logged, so that the logs of two machines can be diffed to find the tick they desynced on
+		uint64_t GetSimulationChecksum() const { return m_simulationChecksum; }
+
 		const eastl::vector<eastl::shared_ptr<class OGameWorld>>& GetWorlds() const { return m_worlds; }
 		eastl::vector<eastl::shared_ptr<class OGameWorld>>& GetWorlds() { return m_worlds; }
 		eastl::shared_ptr<class OGameWorld> GetWorld(const eastl::string& inWorldName);
@@ -77,7 +82,7 @@ namespace MAD
 		virtual void PostTick_Internal(float) {}
 		virtual void InitializeEngineContext() = 0;
 
-		// TODO Reloading world doesn't totally work with the network because we don't respawn the player again
+		// Worlds loaded by the engine reload incrementally, entities that aren't in the world file (e.g network players) are left alone
 		bool ReloadWorld(size_t inWorldIndex);
 		bool ReloadWorld(const eastl::string& inWorldName);
 	protected:
@@ -88,11 +93,13 @@ namespace MAD
 		bool m_bIsInitialized;
 		bool m_bContinue;
 		bool m_isSimulating;
+		bool m_isChecksumEnabled;
 
 		uint32_t m_gameTick; // Enough bits for 19,884 hours of gameplay @ 60Hz simulation
 		double m_gameTime;
 		double m_frameTime;
 		double m_frameAccumulator;
+		uint64_t m_simulationChecksum;
 
 		eastl::vector<eastl::shared_ptr<class OGameWorld>> m_worlds;
 		eastl::shared_ptr<class UFrameTimer> m_frameTimer;
@@ -100,9 +107,14 @@ namespace MAD
 		eastl::shared_ptr<class UGameWindow> m_gameWindow;
 		eastl::shared_ptr<class UPhysicsWorld> m_physicsWorld;
 		eastl::shared_ptr<class URenderer> m_renderer;
+		eastl::shared_ptr<class UFileWatcher> m_worldFileWatcher; // Null when world hot reloading is disabled
+		eastl::hash_map<eastl::string, eastl::shared_ptr<struct SWorldLoadSnapshot>> m_worldSnapshots; // Keyed by world relative path
 		UNetworkManager m_networkManager;
 	private:
 		int32_t GetWorldIndex(const eastl::string& inWorldName) const;
+		bool LoadWorldFile(const eastl::string& inWorldRelativePath);
+		void ReloadChangedWorldFiles();
+		void UpdateSimulationChecksum();
 		void TEMPSerializeObject();
 	};
 
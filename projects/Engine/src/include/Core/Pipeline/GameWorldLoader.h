@@ -1,31 +1,122 @@
 #pragma once
 
+#include <EASTL/hash_map.h>
 #include <EASTL/shared_ptr.h>
 #include <EASTl/stack.h>
 #include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <EASTL/weak_ptr.h>
 
+#include "Core/SimpleMath.h"
 #include "JSONTypes.h"
+#include "WorldCooker.h"
 
 namespace MAD
 {
 	class OGameWorld;
-	
+
+	// What a world looked like when it was last loaded, so that reloading it only touches the entities that changed
+	struct SWorldLoadSnapshot
+	{
+		struct SLoadedComponent
+		{
+			eastl::weak_ptr<class UComponent> m_component;
+			const class TTypeInfo* m_typeInfo;
+			bool m_isExisting;
+			uint64_t m_contentHash;
+		};
+
+		struct SLoadedEntity
+		{
+			eastl::weak_ptr<class AEntity> m_entity;
+			const class TTypeInfo* m_typeInfo;
+			uint64_t m_contentHash;
+			eastl::vector<SLoadedComponent> m_components;
+		};
+
+		// Keyed by layer and entity name
+		eastl::hash_map<eastl::string, SLoadedEntity> m_entities;
+	};
+
+	/*
+		Worlds are instantiated in batches: the world file is read into flat entity and component records first, then every
+		entity and component is created (on the main thread, constructors are free to bind input or talk to the renderer),
+		then component properties are loaded in parallel on the job system for the components that allow it, and finally the
+		entities are committed to the world in file order.
+
+		Reloading diffs the records against the snapshot of the previous load and only spawns, destroys or patches the
+		entities that changed.
+	*/
 	class UGameWorldLoader
 	{
 	public:
-		bool LoadWorld(const eastl::string& inWorldFilePath);
+		bool LoadWorld(const eastl::string& inWorldFilePath, SWorldLoadSnapshot* outSnapshot = nullptr);
+		bool ReloadWorld(eastl::shared_ptr<OGameWorld> inWorld, SWorldLoadSnapshot& inOutSnapshot);
 	private:
+		struct SComponentLoadRecord
+		{
+			const class TTypeInfo* m_typeInfo;
+			bool m_isExisting;
+			UObjectValue m_properties;
+
+			bool m_hasPosition;
+			bool m_hasRotation;
+			bool m_hasScale;
+
+			Vector3 m_position;
+			Quaternion m_rotation;
+			float m_scale;
+
+			uint64_t m_contentHash;
+
+			eastl::shared_ptr<class UComponent> m_component; // Null until the component is created or found
+			bool m_isLoaded;
+		};
+
+		struct SEntityLoadRecord
+		{
+			const class TTypeInfo* m_typeInfo;
+			eastl::string m_layerName;
+			eastl::string m_debugName;
+			eastl::string m_snapshotKey;
+
+			uint32_t m_firstComponent;
+			uint32_t m_componentCount;
+			uint64_t m_contentHash;
+
+			eastl::shared_ptr<class AEntity> m_entity;
+			bool m_isNew; // Needs to be finalized into the world
+		};
+
 		rapidjson::Document m_doc;
+		SCookedWorldData m_cookedWorld;
 
 		eastl::string m_relativeFilePath;
 		eastl::string m_fullFilePath;
 
 		eastl::shared_ptr<class OGameWorld> m_world;
 
-		bool LoadWorld(UObjectValue& inWorld);
-		bool LoadLayer(UObjectValue& inLayer);
-		bool LoadEntity(UObjectValue& inEntity, const eastl::string& inLayerName);
-		bool LoadExistingComponent(UObjectValue& inExistingComp, eastl::shared_ptr<class AEntity> inOwningEntity);
-		bool LoadNewComponent(UObjectValue& inNewComp, eastl::shared_ptr<class AEntity> inOwningEntity);
+		eastl::vector<SEntityLoadRecord> m_entityRecords;
+		eastl::vector<SComponentLoadRecord> m_componentRecords;
+
+		bool ReadWorldFile();
+		bool ReadWorld(UObjectValue& inWorld);
+		void ReadWorldSettings(UObjectValue& inWorld);
+		bool ReadLayer(UObjectValue& inLayer);
+		bool ReadEntity(UObjectValue& inEntity, const eastl::string& inLayerName);
+		bool ReadComponent(UObjectValue& inComp, bool inIsExisting);
+		bool ReadCookedWorld();
+		bool ReadCookedComponent(const SCookedComponent& inComp, const class TTypeInfo* inCompTypeInfo, bool inIsExisting);
+		bool UseWorld(const eastl::string& inWorldName);
+
+		void AddEntityRecord(const class TTypeInfo& inEntityTypeInfo, const eastl::string& inLayerName, const eastl::string& inDebugName);
+		SComponentLoadRecord& AddComponentRecord(const class TTypeInfo& inCompTypeInfo, bool inIsExisting, const UObjectValue& inProperties);
+		void FinishRecords();
+
+		void DiffAgainstSnapshot(const SWorldLoadSnapshot& inSnapshot);
+		void CreateEntity(SEntityLoadRecord& inOutRecord);
+		void ApplyComponentLoad(SComponentLoadRecord& inOutRecord) const;
+		void InstantiateEntities();
+		void WriteSnapshot(SWorldLoadSnapshot& outSnapshot) const;
 	};
 }
@@ -9,21 +9,51 @@ namespace MAD
 {
 	class UArrayValue;
 	class UObjectValue;
+	struct SCookedWorldData;
 
 	using SizeType = rapidjson::SizeType;
 
+	// Wraps either a parsed JSON value or a value inside a cooked world (see UWorldCooker), both read the same way
 	class UGenericValue
 	{
 	public:
-		UGenericValue(rapidjson::Value* inValue = nullptr) : m_value(inValue) {} // Non-explicit constructor for conversion convenience
+		UGenericValue(rapidjson::Value* inValue = nullptr) : m_value(inValue), m_cookedWorld(nullptr), m_cookedValue(0) {} // Non-explicit constructor for conversion convenience
+		UGenericValue(const SCookedWorldData& inCookedWorld, uint32_t inCookedValue) : m_value(nullptr), m_cookedWorld(&inCookedWorld), m_cookedValue(inCookedValue) {}
 
 		template <typename ValueType> bool Get(ValueType& outValue) const;
 		template <typename ValueType> bool IsA() const;
+
+		// Hash of the value and everything under it. Equal contents hash the same whichever backing they come from, and
+		// the order of object members doesn't matter
+		uint64_t GetContentHash() const;
 	private:
 		friend class UObjectValue;
 		friend class UArrayValue;
+
+		bool IsObject() const;
+		bool IsArray() const;
+		bool IsString() const;
+		bool IsBool() const;
+		bool IsFloat() const;
+		bool IsDouble() const;
+		bool IsInt() const;
+		bool IsUint() const;
+
+		double GetNumber() const;
+		bool GetBool() const;
+		const char* GetString() const;
+		SizeType GetSize() const;
+		UGenericValue GetElement(SizeType inIndex) const;
+
+		SizeType GetMemberCount() const;
+		const char* GetMemberName(SizeType inIndex) const;
+		UGenericValue GetMemberValue(SizeType inIndex) const;
+
+		bool FindMember(const char* inName, UGenericValue& outMemberValue) const;
 	private:
 		rapidjson::Value* m_value;
+		const SCookedWorldData* m_cookedWorld;
+		uint32_t m_cookedValue;
 	};
 
 	class UObjectValue
@@ -33,6 +63,8 @@ namespace MAD
 		UObjectValue(const UGenericValue& inObjectValue) : m_objectValue(inObjectValue) {}
 
 		template <typename ValueType> bool GetProperty(const char* inPropName, ValueType& outPropValue) const;
+
+		uint64_t GetContentHash() const { return m_objectValue.GetContentHash(); }
 	private:
 		UGenericValue m_objectValue;
 	};
@@ -67,15 +99,13 @@ namespace MAD
 	template <typename ValueType>
 	bool UObjectValue::GetProperty(const char* inPropName, ValueType& outPropValue) const
 	{
-		auto propFindIter = m_objectValue.m_value->FindMember(inPropName);
+		UGenericValue propertyValue;
 
-		if (propFindIter == m_objectValue.m_value->MemberEnd())
+		if (!m_objectValue.FindMember(inPropName, propertyValue))
 		{
 			return false;
 		}
 
-		UGenericValue propertyValue(&propFindIter->value);
-
 		return propertyValue.Get(outPropValue);
 	}
 
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+namespace MAD
+{
+	enum class ECookedValueType : uint8_t
+	{
+		Null,
+		Bool,
+		Number,
+		String,
+		Array,
+		Object
+	};
+
+	// What the JSON parser reported for a number, so cooked values convert exactly like the source did
+	namespace ECookedNumberFlags
+	{
+		enum Type : uint8_t
+		{
+			Int = 1 << 0,
+			Uint = 1 << 1,
+			Double = 1 << 2,
+			Float = 1 << 3
+		};
+	}
+
+	/*
+		Flattened JSON value. The members of an object (or elements of an array) are stored next to each other, starting at
+		m_first, and an object's members are sorted by name hash so they can be binary searched
+	*/
+	struct SCookedValue
+	{
+		uint32_t m_nameHash; // Member name, when this value is in an object
+		uint32_t m_nameOffset; // Into the string table
+		ECookedValueType m_type;
+		uint8_t m_numberFlags;
+		uint8_t m_bool;
+		uint8_t m_padding;
+		uint32_t m_count; // Members, elements, or the length of a string
+		uint32_t m_first; // First member or element, or the string table offset of a string
+		double m_number;
+	};
+
+	struct SCookedLayer
+	{
+		uint32_t m_nameOffset;
+		uint32_t m_firstEntity;
+		uint32_t m_entityCount;
+	};
+
+	struct SCookedEntity
+	{
+		uint32_t m_typeIndex; // Into the type name table
+		uint32_t m_nameOffset;
+		uint32_t m_firstComponent; // Existing components come first, then the new ones
+		uint32_t m_existingComponentCount;
+		uint32_t m_newComponentCount;
+	};
+
+	namespace ECookedComponentFlags
+	{
+		enum Type : uint32_t
+		{
+			HasPosition = 1 << 0,
+			HasRotation = 1 << 1,
+			HasScale = 1 << 2
+		};
+	}
+
+	// Transforms are converted ahead of time, the rotation is stored as a quaternion rather than degrees
+	struct SCookedComponent
+	{
+		uint32_t m_typeIndex;
+		uint32_t m_flags; // ECookedComponentFlags
+		float m_position[3];
+		float m_rotation[4];
+		float m_scale;
+		uint32_t m_propertiesValue; // Object value passed to UComponent::Load
+	};
+
+	// Contents of a cooked world, every table is read straight out of the cooked file
+	struct SCookedWorldData
+	{
+		uint32_t m_worldNameOffset;
+		uint32_t m_worldPropertiesValue; // Members of the world object other than its layers
+
+		eastl::vector<uint32_t> m_typeNameOffsets; // Every distinct type name, resolved to type infos once per load
+		eastl::vector<SCookedLayer> m_layers;
+		eastl::vector<SCookedEntity> m_entities;
+		eastl::vector<SCookedComponent> m_components;
+		eastl::vector<SCookedValue> m_values;
+		eastl::vector<char> m_stringTable;
+
+		const char* GetString(uint32_t inOffset) const { return &m_stringTable[inOffset]; }
+	};
+
+	/*
+		Compiles world JSON files into a binary layout that loads without any parsing: the layer, entity and component
+		hierarchy goes into flat tables, type names are de-duplicated so they're looked up once, and component properties
+		are flattened into SCookedValues. Cooked files sit next to their source with a ".madworld" extension and are
+		invalidated the same way cooked meshes are.
+
+		All paths are full paths to the source world.
+	*/
+	class UWorldCooker
+	{
+	public:
+		UWorldCooker() = delete;
+
+		static const uint32_t CookedWorldVersion;
+
+		static const uint32_t InvalidIndex = 0xFFFFFFFF;
+
+		// Name hash used for object members, stable between runs
+		static uint32_t HashName(const char* inName);
+
+		static eastl::string GetCookedWorldPath(const eastl::string& inSourcePath);
+
+		// Parses the source world and writes its cooked file
+		static bool CookWorld(const eastl::string& inSourcePath);
+
+		static bool IsCookedWorldUpToDate(const eastl::string& inSourcePath);
+
+		// Reads the cooked file through a memory mapping. Fails if the cooked file is missing or stale
+		static bool LoadCookedWorld(const eastl::string& inSourcePath, SCookedWorldData& outWorldData);
+	};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Rendering/ParticleSystem/Particle.h"
+
+#include <EASTL/array.h>
+
+namespace MAD
+{
+	// Particles just added to a pool, for the caller to write in place. Each pointer is to the first particle of the range
+	struct SParticlePoolRange
+	{
+		uint32_t m_count;
+		Vector3* m_initialPositions;
+		Vector3* m_initialVelocities;
+		Vector4* m_colors;
+		Vector2* m_sizes;
+		float* m_ages;
+		float* m_durations;
+	};
+
+	/*
+		The live particles of a system, stored as one array per attribute laid out exactly like the vertex buffer it's drawn
+		from. Live particles are always packed at the front in the order they were added, so uploading them is a copy of the
+		first GetParticleCount() elements of each array.
+
+		Doesn't touch the renderer, so pools can be simulated on any thread, or without a graphics device at all.
+	*/
+	class UParticlePool
+	{
+	public:
+		static const uint32_t s_maxNumParticles = 4096; // uint32_t because DX API takes a UINT max
+
+		static_assert(s_maxNumParticles % 4 == 0, "Particles are aged four at a time");
+	public:
+		UParticlePool();
+
+		void Clear() { m_particleCount = 0; }
+
+		// Returns false when the pool is already full
+		bool AddParticle(const SCPUParticle& inParticle);
+
+		// Adds as many of inCount particles as fit, without writing anything to them
+		SParticlePoolRange ReserveParticles(uint32_t inCount);
+
+		// Ages every particle by inDeltaTime, and removes the ones that outlived their duration
+		void AgeParticles(float inDeltaTime);
+
+		void SetInitialPositions(const Vector3& inInitialPos);
+
+		uint32_t GetParticleCount() const { return m_particleCount; }
+		bool IsFull() const { return m_particleCount == s_maxNumParticles; }
+
+		const Vector3* GetInitialPositions() const { return m_initialPositions.data(); }
+		const Vector3* GetInitialVelocities() const { return m_initialVelocities.data(); }
+		const Vector4* GetColors() const { return m_colors.data(); }
+		const Vector2* GetSizes() const { return m_sizes.data(); }
+		const float* GetAges() const { return m_ages.data(); }
+	private:
+		// The ranges may overlap, inTo is never after inFrom
+		void MoveParticles(uint32_t inFrom, uint32_t inTo, uint32_t inCount);
+	private:
+		uint32_t m_particleCount;
+
+		eastl::array<Vector3, s_maxNumParticles> m_initialPositions;
+		eastl::array<Vector3, s_maxNumParticles> m_initialVelocities;
+		eastl::array<Vector4, s_maxNumParticles> m_colors;
+		eastl::array<Vector2, s_maxNumParticles> m_sizes;
+		eastl::array<float, s_maxNumParticles> m_ages;
+		eastl::array<float, s_maxNumParticles> m_durations; // CPU only, the shaders don't need it
+	};
+}
@@ -2,10 +2,11 @@
 
 #include "Particle.h"
 
-#include <EASTL/vector.h>
-
 namespace MAD
 {
+	class UParticlePool;
+	class URandomStream;
+
 	struct SParticleEmitterSpawnParams
 	{
 		SParticleEmitterSpawnParams();
@@ -28,11 +29,13 @@ namespace MAD
 	{
 	public:
 		void Initialize(const SParticleEmitterSpawnParams& inSpawnParams);
-		void TickEmitter(float inDeltaTime, eastl::vector<SCPUParticle>& outEmittedParticles);
+
+		// Emits the particles due this tick straight into inOutPool, drawing their random numbers from inOutRandom
+		void TickEmitter(float inDeltaTime, URandomStream& inOutRandom, UParticlePool& inOutPool);
 
 		bool IsFinished() const;
 	private:
-		SCPUParticle EmitParticle();
+		void EmitParticles(uint32_t inParticleCount, URandomStream& inOutRandom, UParticlePool& inOutPool);
 	private:
 		float m_emitRate; // seconds-per-particle
 		float m_emitDuration;
@@ -17,9 +17,12 @@ namespace MAD
 
 		void OnScreenSizeChanged();
 
+		// Simulates every active system across the job system, then draws them one after the other
 		void UpdateParticleSystems(float inDeltaTime);
 		UParticleSystem* ActivateParticleSystem(const SParticleSystemSpawnParams& inSpawnParams, const eastl::vector<SParticleEmitterSpawnParams>& inEmitterParams);
 		bool DeactivateParticleSystem(const UParticleSystem* inTargetParticleSystem);
+	private:
+		void SimulateParticleSystems(float inDeltaTime);
 	private:
 		eastl::array<UParticleSystem, s_maxParticleSystems> m_particleSystemPool;
 		size_t m_firstInactiveParticleSystem;
@@ -2,12 +2,23 @@
 
 #include <EASTL/string.h>
 
+#include "Rendering/SubMesh.h"
+
 namespace MAD
 {
 	namespace RenderConstants
 	{
 		extern const uint32_t DynamicEnvironmentMapRes;
 		extern const uint32_t ShadowMapRes;
+
+		extern const uint32_t ShadowCascadeRes; // Resolution of each cascade's tile in the directional shadow map atlas
+		extern const float ShadowCascadeDistance;
+		extern const float ShadowCascadeSplitLambda;
+
+		// Items whose bounds cover less than MeshLODScreenSizes[i] of the screen's height draw LOD i + 1 or coarser
+		extern const float MeshLODScreenSizes[MaxMeshLODs - 1];
+		extern const float MeshLODHysteresis; // Fraction each threshold moves by, away from the LOD drawn last frame
+		extern const UINT ShadowLODBias; // How many LODs coarser than the G-buffer pass the shadow passes draw
 	}
 
 	namespace ShaderPaths
@@ -10,12 +10,20 @@
 #include "Core/Pipeline/GameWorldLoader.h"
 #include "Core/PhysicsWorld.h"
 #include "Misc/AssetCache.h"
+#include "Misc/AsyncAssetLoader.h"
+#include "Misc/FileWatcher.h"
+#include "Misc/JobSystem.h"
 #include "Misc/Parse.h"
 #include "Misc/Remotery.h"
+#include "Rendering/Mesh.h"
 #include "Rendering/Renderer.h"
+#include "Rendering/RenderPassProgram.h"
+#include "Rendering/Texture.h"
+#include "Rendering/TextureStreamer.h"
 
 #include "Core/Character.h"
 #include "Core/CameraComponent.h"
+#include "Core/CharacterMovementComponent.h"
 #include "Core/MeshComponent.h"
 #include "Core/LightComponent.h"
 #include "Core/DirectionalLightComponent.h"
@@ -51,6 +59,19 @@ namespace MAD
 
 	namespace
 	{
+		// Main thread time per frame that may be spent finishing asynchronous asset loads
+		const double g_assetFinalizeBudgetSeconds = 0.002;
+
+		// Default asset cache budgets, overridable with -MeshBudgetMB= and -TextureBudgetMB=. Other asset types are unbounded
+		const int g_defaultMeshBudgetMB = 256;
+		const int g_defaultTextureBudgetMB = 512;
+
+		// Memory the streamed mips of cooked textures may take up together, overridable with -TextureStreamingBudgetMB=
+		const int g_defaultTextureStreamingBudgetMB = 384;
+
+		// How often loaded world files are checked for changes, unless hot reloading is turned off with -NoHotReload
+		const double g_worldFilePollIntervalSeconds = 0.5;
+
 		// Temp testing to change render target output for GBuffer
 		void OnDisableGBufferVisualization()
 		{
@@ -114,6 +135,7 @@ namespace MAD
 			CReflectionProbeComponent::StaticClass();
 			CSkySphereComponent::StaticClass();
 			CMoveComponent::StaticClass();
+			CCharacterMovementComponent::StaticClass();
 			CDebugTransformComponent::StaticClass();
 			CParticleSystemComponent::StaticClass();
 
@@ -130,13 +152,17 @@ namespace MAD
 		: m_bIsInitialized(false)
 		, m_bContinue(true)
 		, m_isSimulating(false)
+		, m_isChecksumEnabled(false)
 		, m_gameTick(0)
 		, m_gameTime(0.0)
 		, m_frameTime(0.0)
-		, m_frameAccumulator(0.0) { }
+		, m_frameAccumulator(0.0)
+		, m_simulationChecksum(0) { }
 
 		UBaseEngine::~UBaseEngine()
 		{
+			UJobSystem::Shutdown();
+
 			if (g_pRemotery) rmt_DestroyGlobalInstance(g_pRemotery);
 		}
 
@@ -168,6 +194,24 @@ namespace MAD
 			return false;
 		}
 
+		// The renderer sizes its per-thread resources off of the job system, so it needs to be up first
+		UJobSystem::Init();
+		UAsyncAssetLoader::Init();
+
+		int meshBudgetMB = g_defaultMeshBudgetMB;
+		int textureBudgetMB = g_defaultTextureBudgetMB;
+		SParse::Get(SCmdLine::Get(), "-MeshBudgetMB=", meshBudgetMB);
+		SParse::Get(SCmdLine::Get(), "-TextureBudgetMB=", textureBudgetMB);
+
+		int textureStreamingBudgetMB = g_defaultTextureStreamingBudgetMB;
+		SParse::Get(SCmdLine::Get(), "-TextureStreamingBudgetMB=", textureStreamingBudgetMB);
+
+		UAssetCache::SetMemoryBudget<UMesh>("Mesh", static_cast<size_t>(eastl::max(meshBudgetMB, 0)) * 1024 * 1024);
+		UAssetCache::SetMemoryBudget<UTexture>("Texture", static_cast<size_t>(eastl::max(textureBudgetMB, 0)) * 1024 * 1024);
+		UAssetCache::SetMemoryBudget<URenderPassProgram>("RenderPassProgram", 0);
+		UAssetCache::SetMemoryBudget<UFontFamily>("FontFamily", 0);
+		UTextureStreamer::SetMemoryBudget(static_cast<size_t>(eastl::max(textureStreamingBudgetMB, 0)) * 1024 * 1024);
+
 		if (!Init_Internal(inGameWindow))
 		{
 			return false;
@@ -175,14 +219,26 @@ namespace MAD
 
 		InitializeEngineContext();
 
+		m_isChecksumEnabled = SParse::Find(SCmdLine::Get(), "-SimChecksum");
+
+#ifndef MAD_DETERMINISTIC_SIMULATION
+		if (m_isChecksumEnabled)
+		{
+			LOG(LogBaseEngine, Warning, "Not a deterministic build, simulation checksums will only match other machines running the same binary\n");
+		}
+#endif
+
+		if (!SParse::Find(SCmdLine::Get(), "-NoHotReload"))
+		{
+			m_worldFileWatcher = eastl::make_shared<UFileWatcher>(g_worldFilePollIntervalSeconds);
+		}
+
 		eastl::string levelPath = s_defaultLevelPath;
 
 		SParse::Get(SCmdLine::Get(), "-Level=", levelPath);
 
 		// Load the world after setting up control schemes. (We could probably define those in the world file or something as well)
-		UGameWorldLoader loader;
-
-		loader.LoadWorld(levelPath);
+		LoadWorldFile(levelPath);
 
 		m_bIsInitialized = true;
 
@@ -236,6 +292,27 @@ namespace MAD
 		return -1;
 	}
 
+	bool UBaseEngine::LoadWorldFile(const eastl::string& inWorldRelativePath)
+	{
+		auto snapshot = eastl::make_shared<SWorldLoadSnapshot>();
+
+		UGameWorldLoader loader;
+
+		if (!loader.LoadWorld(inWorldRelativePath, snapshot.get()))
+		{
+			return false;
+		}
+
+		m_worldSnapshots[inWorldRelativePath] = snapshot;
+
+		if (m_worldFileWatcher)
+		{
+			m_worldFileWatcher->WatchFile(UAssetCache::GetAssetRoot() + inWorldRelativePath);
+		}
+
+		return true;
+	}
+
 	bool UBaseEngine::ReloadWorld(size_t inWorldIndex)
 	{
 		if (inWorldIndex >= m_worlds.size())
@@ -243,16 +320,22 @@ namespace MAD
 			return false;
 		}
 
-		// Swap and pop the last world with the index specified
 		const eastl::string targetWorldRelativePath = m_worlds[inWorldIndex]->GetWorldRelativePath();
 
+		auto snapshotIter = m_worldSnapshots.find(targetWorldRelativePath);
+		if (snapshotIter != m_worldSnapshots.end())
+		{
+			UGameWorldLoader gameWorldLoader;
+
+			return gameWorldLoader.ReloadWorld(m_worlds[inWorldIndex], *snapshotIter->second);
+		}
+
+		// Worlds that weren't loaded through the engine have no snapshot, swap and pop the last world with the index specified
 		m_worlds[inWorldIndex] = m_worlds.back();
 
 		m_worlds.pop_back();
 
-		UGameWorldLoader gameWorldLoader;
-
-		return gameWorldLoader.LoadWorld(targetWorldRelativePath);
+		return LoadWorldFile(targetWorldRelativePath);
 	}
 
 	bool UBaseEngine::ReloadWorld(const eastl::string& inWorldName)
@@ -282,6 +365,42 @@ namespace MAD
 		}
 	}
 
+	void UBaseEngine::ReloadChangedWorldFiles()
+	{
+		eastl::vector<eastl::string> changedFiles;
+		m_worldFileWatcher->Poll(m_gameTime, changedFiles);
+
+		for (const auto& currentFile : changedFiles)
+		{
+			const size_t numWorlds = m_worlds.size();
+			for (size_t i = 0; i < numWorlds; ++i)
+			{
+				if (UAssetCache::GetAssetRoot() + m_worlds[i]->GetWorldRelativePath() == currentFile)
+				{
+					LOG(LogBaseEngine, Log, "World file `%s` changed on disk, reloading\n", m_worlds[i]->GetWorldRelativePath().c_str());
+					ReloadWorld(i);
+					break;
+				}
+			}
+		}
+	}
+
+	void UBaseEngine::UpdateSimulationChecksum()
+	{
+		rmt_ScopedCPUSample(Engine_UpdateSimulationChecksum, 0);
+
+		uint64_t tickChecksum = m_physicsWorld->ComputeSimulationChecksum();
+
+		for (const auto& currentWorld : m_worlds)
+		{
+			tickChecksum += currentWorld->ComputeSimulationChecksum();
+		}
+
+		m_simulationChecksum = tickChecksum;
+
+		LOG(LogBaseEngine, Log, "Tick %u simulation checksum %016llx\n", m_gameTick, static_cast<unsigned long long>(m_simulationChecksum));
+	}
+
 	void UBaseEngine::ExecuteEngineTests()
 	{
 		// Assumes that the default world loaded in correctly
@@ -345,6 +464,21 @@ namespace MAD
 			PreTick_Internal(m_frameTime);
 		}
 
+		// Finish off assets that have been loaded in the background (GPU uploads etc.), so they're available for this frame
+		UAsyncAssetLoader::ProcessFinalizeQueue(g_assetFinalizeBudgetSeconds);
+
+		// Evict least recently used assets nobody references anymore from any cache that's over budget
+		UAssetCache::Tick();
+
+		// Swap in the texture mips the last frame asked for, and drop the ones it no longer needs
+		UTextureStreamer::Tick();
+
+		// Pick up edits to the loaded world files before simulating, so the new entities tick this frame
+		if (m_worldFileWatcher)
+		{
+			ReloadChangedWorldFiles();
+		}
+
 		while (steps > 0)
 		{
 			rmt_ScopedCPUSample(Engine_TickStep, 0);
@@ -376,7 +510,7 @@ namespace MAD
 			}
 
 			// Update the physics world
-			m_physicsWorld->SimulatePhysics();
+			m_physicsWorld->SimulatePhysics(static_cast<float>(TARGET_DELTA_TIME));
 
 			// Tick the post-physics components of all Worlds
 			for (auto& currentWorld : m_worlds)
@@ -386,6 +520,11 @@ namespace MAD
 
 			m_isSimulating = false;
 
+			if (m_isChecksumEnabled)
+			{
+				UpdateSimulationChecksum();
+			}
+
 			// Send to the network
 			m_networkManager.PostTick();
 
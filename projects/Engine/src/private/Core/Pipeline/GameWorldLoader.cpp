@@ -1,5 +1,6 @@
 #include "Core/Pipeline/GameWorldLoader.h"
 
+#include <cstring>
 #include <fstream>
 #include <rapidjson/error/en.h>
 
@@ -8,7 +9,9 @@
 #include "Core/Component.h"
 #include "Core/GameWorld.h"
 #include "Misc/AssetCache.h"
+#include "Misc/JobSystem.h"
 #include "Misc/Logging.h"
+#include "Misc/Remotery.h"
 #include "Rendering/Renderer.h"
 
 using namespace rapidjson;
@@ -17,17 +20,115 @@ namespace MAD
 {
 	DECLARE_LOG_CATEGORY(LogGameWorldLoader);
 
-	bool UGameWorldLoader::LoadWorld(const eastl::string& inWorldFilePath)
+	namespace
+	{
+		uint64_t CombineHash(uint64_t inHash, uint64_t inValue)
+		{
+			return inHash ^ (inValue + 0x9e3779b97f4a7c15ull + (inHash << 6) + (inHash >> 2));
+		}
+
+		uint64_t CombineHash(uint64_t inHash, float inValue)
+		{
+			uint32_t valueBits;
+			memcpy(&valueBits, &inValue, sizeof(valueBits));
+			return CombineHash(inHash, static_cast<uint64_t>(valueBits));
+		}
+
+		// Patching in place needs the same entity type and the same number of components, failed components still take a slot
+		bool HaveSameComponentLayout(const SWorldLoadSnapshot::SLoadedEntity& inLoadedEntity, const TTypeInfo* inEntityTypeInfo, uint32_t inComponentCount)
+		{
+			return inLoadedEntity.m_typeInfo == inEntityTypeInfo && inLoadedEntity.m_components.size() == inComponentCount;
+		}
+	}
+
+	bool UGameWorldLoader::LoadWorld(const eastl::string& inWorldFilePath, SWorldLoadSnapshot* outSnapshot)
 	{
 		m_relativeFilePath = inWorldFilePath;
 		m_fullFilePath = UAssetCache::GetAssetRoot() + inWorldFilePath;
 
 		LOG(LogGameWorldLoader, Log, "Loading game world `%s`\n", inWorldFilePath.c_str());
 
+		if (!ReadWorldFile())
+		{
+			return false;
+		}
+
+		for (auto& currentRecord : m_entityRecords)
+		{
+			CreateEntity(currentRecord);
+		}
+
+		InstantiateEntities();
+
+		if (outSnapshot)
+		{
+			WriteSnapshot(*outSnapshot);
+		}
+
+		m_entityRecords.clear();
+		m_componentRecords.clear();
+
+		return true;
+	}
+
+	bool UGameWorldLoader::ReloadWorld(eastl::shared_ptr<OGameWorld> inWorld, SWorldLoadSnapshot& inOutSnapshot)
+	{
+		MAD_ASSERT_DESC(inWorld != nullptr, "Cannot reload a null world");
+
+		rmt_ScopedCPUSample(WorldLoader_ReloadWorld, 0);
+
+		m_world = inWorld;
+		m_relativeFilePath = inWorld->GetWorldRelativePath();
+		m_fullFilePath = UAssetCache::GetAssetRoot() + m_relativeFilePath;
+
+		LOG(LogGameWorldLoader, Log, "Reloading game world `%s`\n", m_relativeFilePath.c_str());
+
+		// Nothing in the world is touched if the new file can't be read, a half saved file just waits for the next change
+		if (!ReadWorldFile())
+		{
+			return false;
+		}
+
+		DiffAgainstSnapshot(inOutSnapshot);
+
+		for (auto& currentRecord : m_entityRecords)
+		{
+			if (!currentRecord.m_entity)
+			{
+				CreateEntity(currentRecord);
+			}
+		}
+
+		InstantiateEntities();
+
+		inOutSnapshot.m_entities.clear();
+		WriteSnapshot(inOutSnapshot);
+
+		m_entityRecords.clear();
+		m_componentRecords.clear();
+
+		return true;
+	}
+
+	bool UGameWorldLoader::ReadWorldFile()
+	{
+		rmt_ScopedCPUSample(WorldLoader_ReadWorldFile, 0);
+
+		m_entityRecords.clear();
+		m_componentRecords.clear();
+
+		// Prefer the cooked world, it doesn't need to be parsed
+		if (UWorldCooker::LoadCookedWorld(m_fullFilePath, m_cookedWorld))
+		{
+			return ReadCookedWorld();
+		}
+
+		LOG(LogGameWorldLoader, Warning, "Cooked world for `%s` is missing or out of date, parsing the JSON source\n", m_relativeFilePath.c_str());
+
 		std::ifstream file(m_fullFilePath.c_str());
 		if (!file)
 		{
-			LOG(LogGameWorldLoader, Warning, "Failed to open world file `%s`\n", inWorldFilePath.c_str());
+			LOG(LogGameWorldLoader, Warning, "Failed to open world file `%s`\n", m_relativeFilePath.c_str());
 			return false;
 		}
 
@@ -41,19 +142,19 @@ namespace MAD
 		file.close();
 
 		StringStream jsonStr(fileStr.c_str());
-		
+
 		if (m_doc.ParseStream(jsonStr).HasParseError())
 		{
-			LOG(LogGameWorldLoader, Warning, "Failed to parse world file `%s`. Error(offset %d) %s\n", inWorldFilePath.c_str(), m_doc.GetErrorOffset(), GetParseError_En(m_doc.GetParseError()));
+			LOG(LogGameWorldLoader, Warning, "Failed to parse world file `%s`. Error(offset %d) %s\n", m_relativeFilePath.c_str(), m_doc.GetErrorOffset(), GetParseError_En(m_doc.GetParseError()));
 			return false;
 		}
 
 		UObjectValue worldObjectValue(&m_doc);
 
-		return LoadWorld(worldObjectValue);
+		return ReadWorld(worldObjectValue);
 	}
 
-	bool UGameWorldLoader::LoadWorld(UObjectValue& inWorld)
+	bool UGameWorldLoader::ReadWorld(UObjectValue& inWorld)
 	{
 		// Load world name
 		eastl::string worldName;
@@ -64,18 +165,10 @@ namespace MAD
 		}
 		LOG(LogGameWorldLoader, Log, "World name: %s\n", worldName.c_str());
 
-		// Create world
-		eastl::weak_ptr<OGameWorld> gameWorld_weak = gEngine->SpawnGameWorld<OGameWorld>(worldName, m_relativeFilePath);
-		m_world = gameWorld_weak.lock();
+		UseWorld(worldName);
 
 		// Load world configuration
-		Color ambientColor(0.2f, 0.2f, 0.2f, 1.0f);
-		inWorld.GetProperty("ambientColor", ambientColor);
-		gEngine->GetRenderer().SetWorldAmbientColor(ambientColor);
-
-		Color backBufferClearColor(0.529f, 0.808f, 0.922f, 1.0f);
-		inWorld.GetProperty("backBufferColor", backBufferClearColor);
-		gEngine->GetRenderer().SetBackBufferClearColor(backBufferClearColor);
+		ReadWorldSettings(inWorld);
 
 		// Check layers array
 		UArrayValue layerArray;
@@ -97,13 +190,26 @@ namespace MAD
 
 			layerArray[i].Get(layerObject);
 
-			LoadLayer(layerObject);
+			ReadLayer(layerObject);
 		}
 
+		FinishRecords();
+
 		return true;
 	}
 
-	bool UGameWorldLoader::LoadLayer(UObjectValue& inLayer)
+	void UGameWorldLoader::ReadWorldSettings(UObjectValue& inWorld)
+	{
+		Color ambientColor(0.2f, 0.2f, 0.2f, 1.0f);
+		inWorld.GetProperty("ambientColor", ambientColor);
+		gEngine->GetRenderer().SetWorldAmbientColor(ambientColor);
+
+		Color backBufferClearColor(0.529f, 0.808f, 0.922f, 1.0f);
+		inWorld.GetProperty("backBufferColor", backBufferClearColor);
+		gEngine->GetRenderer().SetBackBufferClearColor(backBufferClearColor);
+	}
+
+	bool UGameWorldLoader::ReadLayer(UObjectValue& inLayer)
 	{
 		// Read layer name
 		eastl::string layerName;
@@ -132,13 +238,13 @@ namespace MAD
 
 			entityArray[i].Get(entityObject);
 
-			LoadEntity(entityObject, layerName);
+			ReadEntity(entityObject, layerName);
 		}
 
 		return true;
 	}
 
-	bool UGameWorldLoader::LoadEntity(UObjectValue& inEntity, const eastl::string& inLayerName)
+	bool UGameWorldLoader::ReadEntity(UObjectValue& inEntity, const eastl::string& inLayerName)
 	{
 		// Read entity type name
 		eastl::string entityTypeName = "AEntity";
@@ -152,13 +258,10 @@ namespace MAD
 			return false;
 		}
 
-		// Spawn entity
-		eastl::shared_ptr<AEntity> entity = m_world->SpawnEntityDeferred<AEntity>(*typeInfo, inLayerName);
-
 		eastl::string entityDebugName = "UNASSIGNED";
 		inEntity.GetProperty("name", entityDebugName);
 
-		entity->SetDebugName(entityDebugName);
+		AddEntityRecord(*typeInfo, inLayerName, entityDebugName);
 
 		// Load existing components
 		UArrayValue existingComponentArray;
@@ -174,7 +277,7 @@ namespace MAD
 
 				existingComponentArray[i].Get(existingCompObj);
 
-				LoadExistingComponent(existingCompObj, entity);
+				ReadComponent(existingCompObj, true);
 			}
 		}
 
@@ -188,23 +291,22 @@ namespace MAD
 
 				newComponentArray[i].Get(newCompObj);
 
-				LoadNewComponent(newCompObj, entity);
+				ReadComponent(newCompObj, false);
 			}
 		}
 
-		// Finalize the deferred spawning of the entity
-		m_world->FinalizeSpawnEntity(entity);
-
 		return true;
 	}
 
-	bool UGameWorldLoader::LoadExistingComponent(UObjectValue& inExistingComp, eastl::shared_ptr<class AEntity> inOwningEntity)
+	bool UGameWorldLoader::ReadComponent(UObjectValue& inComp, bool inIsExisting)
 	{
+		const char* compKind = inIsExisting ? "Existing" : "New";
+
 		// Read component type name
 		eastl::string compTypeName;
-		if (!inExistingComp.GetProperty("type", compTypeName))
+		if (!inComp.GetProperty("type", compTypeName))
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tExisting component has no specified type name, skipping\n");
+			LOG(LogGameWorldLoader, Warning, "\t\t%s component has no specified type name, skipping\n", compKind);
 			return false;
 		}
 
@@ -212,123 +314,465 @@ namespace MAD
 		auto componentTypeInfo = TTypeInfo::GetTypeInfo(compTypeName);
 		if (componentTypeInfo == nullptr)
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tExisting component `%s`: Unrecognized type name\n", compTypeName.c_str());
+			LOG(LogGameWorldLoader, Warning, "\t\t%s component `%s`: Unrecognized type name\n", compKind, compTypeName.c_str());
 			return false;
 		}
 
-		// Find component on entity
-		eastl::weak_ptr<UComponent> comp_weak = inOwningEntity->GetFirstComponentByType<UComponent>(*componentTypeInfo);
-		if (comp_weak.expired())
+		// Load the component's properties
+		UObjectValue compPropertyObj;
+
+		if (!inComp.GetProperty("properties", compPropertyObj))
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tExisting component `%s`: Component type not found on entity\n", compTypeName.c_str());
+			LOG(LogGameWorldLoader, Warning, "\t\t%s component `%s`: Could not load properties\n", compKind, compTypeName.c_str());
 			return false;
 		}
 
-		eastl::shared_ptr<UComponent> comp = comp_weak.lock();
+		// Read the component's transform, it's applied right before the properties are loaded
+		SComponentLoadRecord& loadRecord = AddComponentRecord(*componentTypeInfo, inIsExisting, compPropertyObj);
 
-		// Load the component's properties
-		UObjectValue compPropertyObj;
+		loadRecord.m_hasPosition = inComp.GetProperty("position", loadRecord.m_position);
 
-		if (!inExistingComp.GetProperty("properties", compPropertyObj))
+		Vector3 rotationAngles;
+		loadRecord.m_hasRotation = inComp.GetProperty("rotation", rotationAngles);
+		if (loadRecord.m_hasRotation)
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tExisting component `%s`: Could not load properties\n", compTypeName.c_str());
-			return false;
+			loadRecord.m_rotation = FromEulerAngles(ConvertToRadians(rotationAngles.x), ConvertToRadians(rotationAngles.y), ConvertToRadians(rotationAngles.z));
 		}
 
-		// Load the component's transform
+		loadRecord.m_hasScale = inComp.GetProperty("scale", loadRecord.m_scale);
+
+		return true;
+	}
+
+	bool UGameWorldLoader::ReadCookedWorld()
+	{
+		const eastl::string worldName = m_cookedWorld.GetString(m_cookedWorld.m_worldNameOffset);
+		LOG(LogGameWorldLoader, Log, "World name: %s (cooked)\n", worldName.c_str());
+
+		UseWorld(worldName);
+
+		// Load world configuration
+		UObjectValue worldObjectValue(UGenericValue(m_cookedWorld, m_cookedWorld.m_worldPropertiesValue));
+		ReadWorldSettings(worldObjectValue);
+
+		// Every type name in the file is resolved once, entities and components refer to them by index
+		eastl::vector<const TTypeInfo*> typeInfos;
+		typeInfos.reserve(m_cookedWorld.m_typeNameOffsets.size());
+
+		for (uint32_t currentTypeNameOffset : m_cookedWorld.m_typeNameOffsets)
 		{
-			Vector3 position;
-			if (inExistingComp.GetProperty("position", position))
-			{
-				comp->SetRelativeTranslation(position);
-			}
+			typeInfos.push_back(TTypeInfo::GetTypeInfo(eastl::string(m_cookedWorld.GetString(currentTypeNameOffset))));
+		}
 
-			Vector3 rotationAngles;
-			if (inExistingComp.GetProperty("rotation", rotationAngles))
-			{
-				rotationAngles.x = ConvertToRadians(rotationAngles.x);
-				rotationAngles.y = ConvertToRadians(rotationAngles.y);
-				rotationAngles.z = ConvertToRadians(rotationAngles.z);
+		if (m_cookedWorld.m_layers.empty())
+		{
+			LOG(LogGameWorldLoader, Warning, "World `%s` (%s) has no layers and will be empty. Was this intentional?\n", worldName.c_str(), m_fullFilePath.c_str());
+			return true;
+		}
 
-				comp->SetRelativeRotation(FromEulerAngles(rotationAngles.x, rotationAngles.y, rotationAngles.z));
-			}
+		LOG(LogGameWorldLoader, Log, "Number of layers: %i\n", static_cast<int>(m_cookedWorld.m_layers.size()));
 
-			float scale;
-			if (inExistingComp.GetProperty("scale", scale))
+		m_entityRecords.reserve(m_cookedWorld.m_entities.size());
+		m_componentRecords.reserve(m_cookedWorld.m_components.size());
+
+		for (const SCookedLayer& currentLayer : m_cookedWorld.m_layers)
+		{
+			const eastl::string layerName = m_cookedWorld.GetString(currentLayer.m_nameOffset);
+			LOG(LogGameWorldLoader, Log, "Layer `%s`\n", layerName.c_str());
+
+			for (uint32_t i = 0; i < currentLayer.m_entityCount; ++i)
 			{
-				comp->SetRelativeScale(scale);
+				const SCookedEntity& currentEntity = m_cookedWorld.m_entities[currentLayer.m_firstEntity + i];
+
+				const TTypeInfo* entityTypeInfo = typeInfos[currentEntity.m_typeIndex];
+				if (entityTypeInfo == nullptr)
+				{
+					LOG(LogGameWorldLoader, Warning, "\tEntity `%s`: Unrecognized type name\n", m_cookedWorld.GetString(m_cookedWorld.m_typeNameOffsets[currentEntity.m_typeIndex]));
+					continue;
+				}
+
+				AddEntityRecord(*entityTypeInfo, layerName, m_cookedWorld.GetString(currentEntity.m_nameOffset));
+
+				const uint32_t totalComponentCount = currentEntity.m_existingComponentCount + currentEntity.m_newComponentCount;
+
+				for (uint32_t j = 0; j < totalComponentCount; ++j)
+				{
+					const SCookedComponent& currentComponent = m_cookedWorld.m_components[currentEntity.m_firstComponent + j];
+					ReadCookedComponent(currentComponent, typeInfos[currentComponent.m_typeIndex], j < currentEntity.m_existingComponentCount);
+				}
 			}
 		}
 
-		// Update the component's properties
-		comp->Load(*this, compPropertyObj);
+		FinishRecords();
 
 		return true;
 	}
 
-	bool UGameWorldLoader::LoadNewComponent(UObjectValue& inNewComp, eastl::shared_ptr<class AEntity> inOwningEntity)
+	bool UGameWorldLoader::ReadCookedComponent(const SCookedComponent& inComp, const TTypeInfo* inCompTypeInfo, bool inIsExisting)
 	{
-		// Read component type name
-		eastl::string compTypeName;
-		if (!inNewComp.GetProperty("type", compTypeName))
+		const char* compKind = inIsExisting ? "Existing" : "New";
+		const char* compTypeName = m_cookedWorld.GetString(m_cookedWorld.m_typeNameOffsets[inComp.m_typeIndex]);
+
+		if (inCompTypeInfo == nullptr)
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tNew component has no specified type name, skipping\n");
+			LOG(LogGameWorldLoader, Warning, "\t\t%s component `%s`: Unrecognized type name\n", compKind, compTypeName);
 			return false;
 		}
 
-		// Get component type info
-		auto componentTypeInfo = TTypeInfo::GetTypeInfo(compTypeName);
-		if (componentTypeInfo == nullptr)
+		if (inComp.m_propertiesValue == UWorldCooker::InvalidIndex)
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tNew component `%s`: Unrecognized type name\n", compTypeName.c_str());
+			LOG(LogGameWorldLoader, Warning, "\t\t%s component `%s`: Could not load properties\n", compKind, compTypeName);
 			return false;
 		}
 
-		// Load the component's properties
-		UObjectValue compPropertyObj;
+		// The transform was already converted by the cooker
+		SComponentLoadRecord& loadRecord = AddComponentRecord(*inCompTypeInfo, inIsExisting, UObjectValue(UGenericValue(m_cookedWorld, inComp.m_propertiesValue)));
+
+		loadRecord.m_hasPosition = (inComp.m_flags & ECookedComponentFlags::HasPosition) != 0;
+		loadRecord.m_position = Vector3(inComp.m_position[0], inComp.m_position[1], inComp.m_position[2]);
+
+		loadRecord.m_hasRotation = (inComp.m_flags & ECookedComponentFlags::HasRotation) != 0;
+		loadRecord.m_rotation = Quaternion(inComp.m_rotation[0], inComp.m_rotation[1], inComp.m_rotation[2], inComp.m_rotation[3]);
+
+		loadRecord.m_hasScale = (inComp.m_flags & ECookedComponentFlags::HasScale) != 0;
+		loadRecord.m_scale = inComp.m_scale;
+
+		return true;
+	}
 
-		if (!inNewComp.GetProperty("properties", compPropertyObj))
+	bool UGameWorldLoader::UseWorld(const eastl::string& inWorldName)
+	{
+		// Reloads keep the world they were given
+		if (m_world)
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tNew component `%s`: Could not load properties\n", compTypeName.c_str());
-			return false;
+			m_world->SetWorldName(inWorldName);
+			return true;
 		}
 
-		// Add new component
-		eastl::shared_ptr<UComponent> comp = inOwningEntity->AddComponent<UComponent>(*componentTypeInfo);
-		if (!comp)
+		// Create world
+		eastl::weak_ptr<OGameWorld> gameWorld_weak = gEngine->SpawnGameWorld<OGameWorld>(inWorldName, m_relativeFilePath);
+		m_world = gameWorld_weak.lock();
+
+		return m_world != nullptr;
+	}
+
+	void UGameWorldLoader::AddEntityRecord(const TTypeInfo& inEntityTypeInfo, const eastl::string& inLayerName, const eastl::string& inDebugName)
+	{
+		SEntityLoadRecord entityRecord;
+		entityRecord.m_typeInfo = &inEntityTypeInfo;
+		entityRecord.m_layerName = inLayerName;
+		entityRecord.m_debugName = inDebugName;
+		entityRecord.m_firstComponent = static_cast<uint32_t>(m_componentRecords.size());
+		entityRecord.m_componentCount = 0;
+		entityRecord.m_contentHash = 0;
+		entityRecord.m_isNew = false;
+
+		m_entityRecords.push_back(entityRecord);
+	}
+
+	UGameWorldLoader::SComponentLoadRecord& UGameWorldLoader::AddComponentRecord(const TTypeInfo& inCompTypeInfo, bool inIsExisting, const UObjectValue& inProperties)
+	{
+		MAD_ASSERT_DESC(!m_entityRecords.empty(), "Components must be read after their entity");
+
+		SComponentLoadRecord loadRecord;
+		loadRecord.m_typeInfo = &inCompTypeInfo;
+		loadRecord.m_isExisting = inIsExisting;
+		loadRecord.m_properties = inProperties;
+		loadRecord.m_hasPosition = false;
+		loadRecord.m_hasRotation = false;
+		loadRecord.m_hasScale = false;
+		loadRecord.m_scale = 1.0f;
+		loadRecord.m_contentHash = 0;
+		loadRecord.m_isLoaded = false;
+
+		m_componentRecords.push_back(loadRecord);
+		++m_entityRecords.back().m_componentCount;
+
+		return m_componentRecords.back();
+	}
+
+	void UGameWorldLoader::FinishRecords()
+	{
+		// Entities are matched up between loads by layer and name. Repeated names are told apart by how many came before them
+		eastl::hash_map<eastl::string, uint32_t> keyCounts;
+
+		for (auto& currentEntity : m_entityRecords)
 		{
-			LOG(LogGameWorldLoader, Warning, "\t\tNew component `%s`: Failed to add new component to entity\n", compTypeName.c_str());
-			return false;
+			const eastl::string baseKey = currentEntity.m_layerName + "/" + currentEntity.m_debugName;
+			const uint32_t keyIndex = keyCounts[baseKey]++;
+
+			currentEntity.m_snapshotKey = baseKey;
+			if (keyIndex > 0)
+			{
+				currentEntity.m_snapshotKey.append_sprintf("#%u", keyIndex);
+			}
+
+			// Hashes are taken after the transforms are converted, so JSON and cooked worlds hash the same
+			uint64_t entityHash = CombineHash(static_cast<uint64_t>(currentEntity.m_typeInfo->GetTypeID()), static_cast<uint64_t>(currentEntity.m_componentCount));
+
+			for (uint32_t i = 0; i < currentEntity.m_componentCount; ++i)
+			{
+				SComponentLoadRecord& currentComponent = m_componentRecords[currentEntity.m_firstComponent + i];
+
+				uint64_t componentHash = CombineHash(static_cast<uint64_t>(currentComponent.m_typeInfo->GetTypeID()), static_cast<uint64_t>(currentComponent.m_isExisting));
+				componentHash = CombineHash(componentHash, currentComponent.m_properties.GetContentHash());
+
+				if (currentComponent.m_hasPosition)
+				{
+					componentHash = CombineHash(CombineHash(CombineHash(componentHash, currentComponent.m_position.x), currentComponent.m_position.y), currentComponent.m_position.z);
+				}
+
+				if (currentComponent.m_hasRotation)
+				{
+					componentHash = CombineHash(CombineHash(componentHash, currentComponent.m_rotation.x), currentComponent.m_rotation.y);
+					componentHash = CombineHash(CombineHash(componentHash, currentComponent.m_rotation.z), currentComponent.m_rotation.w);
+				}
+
+				if (currentComponent.m_hasScale)
+				{
+					componentHash = CombineHash(componentHash, currentComponent.m_scale);
+				}
+
+				currentComponent.m_contentHash = componentHash;
+				entityHash = CombineHash(entityHash, componentHash);
+			}
+
+			currentEntity.m_contentHash = entityHash;
 		}
+	}
+
+	void UGameWorldLoader::DiffAgainstSnapshot(const SWorldLoadSnapshot& inSnapshot)
+	{
+		uint32_t keptCount = 0;
+		uint32_t patchedCount = 0;
+		uint32_t respawnedCount = 0;
+		uint32_t spawnedCount = 0;
+		uint32_t destroyedCount = 0;
 
-		// Load the component's transform
+		eastl::hash_map<eastl::string, bool> matchedKeys;
+
+		for (auto& currentEntity : m_entityRecords)
 		{
-			Vector3 position;
-			if (inNewComp.GetProperty("position", position))
+			const auto loadedEntityIter = inSnapshot.m_entities.find(currentEntity.m_snapshotKey);
+			if (loadedEntityIter == inSnapshot.m_entities.end())
+			{
+				++spawnedCount;
+				continue;
+			}
+
+			matchedKeys[currentEntity.m_snapshotKey] = true;
+
+			const SWorldLoadSnapshot::SLoadedEntity& loadedEntity = loadedEntityIter->second;
+
+			eastl::shared_ptr<AEntity> liveEntity = loadedEntity.m_entity.lock();
+			if (!liveEntity || liveEntity->IsPendingForKill())
 			{
-				comp->SetRelativeTranslation(position);
+				// Killed during play, bring it back
+				++spawnedCount;
+				continue;
 			}
 
-			Vector3 rotationAngles;
-			if (inNewComp.GetProperty("rotation", rotationAngles))
+			bool canPatch = HaveSameComponentLayout(loadedEntity, currentEntity.m_typeInfo, currentEntity.m_componentCount);
+
+			for (uint32_t i = 0; canPatch && i < currentEntity.m_componentCount; ++i)
 			{
-				rotationAngles.x = ConvertToRadians(rotationAngles.x);
-				rotationAngles.y = ConvertToRadians(rotationAngles.y);
-				rotationAngles.z = ConvertToRadians(rotationAngles.z);
+				const SComponentLoadRecord& currentComponent = m_componentRecords[currentEntity.m_firstComponent + i];
+				const SWorldLoadSnapshot::SLoadedComponent& loadedComponent = loadedEntity.m_components[i];
+
+				eastl::shared_ptr<UComponent> liveComponent = loadedComponent.m_component.lock();
 
-				comp->SetRelativeRotation(FromEulerAngles(rotationAngles.x, rotationAngles.y, rotationAngles.z));
+				canPatch = loadedComponent.m_typeInfo == currentComponent.m_typeInfo
+						&& loadedComponent.m_isExisting == currentComponent.m_isExisting
+						&& (loadedComponent.m_contentHash == currentComponent.m_contentHash || (liveComponent && liveComponent->IsHotReloadable()));
 			}
 
-			float scale;
-			if (inNewComp.GetProperty("scale", scale))
+			if (!canPatch)
 			{
-				comp->SetRelativeScale(scale);
+				liveEntity->Destroy();
+				++respawnedCount;
+				continue;
+			}
+
+			// Keep the live entity, only the components that changed are loaded again
+			currentEntity.m_entity = liveEntity;
+
+			for (uint32_t i = 0; i < currentEntity.m_componentCount; ++i)
+			{
+				SComponentLoadRecord& currentComponent = m_componentRecords[currentEntity.m_firstComponent + i];
+				const SWorldLoadSnapshot::SLoadedComponent& loadedComponent = loadedEntity.m_components[i];
+
+				currentComponent.m_component = loadedComponent.m_component.lock();
+				currentComponent.m_isLoaded = loadedComponent.m_contentHash == currentComponent.m_contentHash;
+			}
+
+			if (loadedEntity.m_contentHash == currentEntity.m_contentHash)
+			{
+				++keptCount;
+			}
+			else
+			{
+				++patchedCount;
 			}
 		}
 
+		// Whatever was removed from the file
+		for (const auto& currentLoadedEntity : inSnapshot.m_entities)
+		{
+			if (matchedKeys.find(currentLoadedEntity.first) != matchedKeys.end())
+			{
+				continue;
+			}
+
+			eastl::shared_ptr<AEntity> liveEntity = currentLoadedEntity.second.m_entity.lock();
+			if (liveEntity && !liveEntity->IsPendingForKill())
+			{
+				liveEntity->Destroy();
+				++destroyedCount;
+			}
+		}
+
+		LOG(LogGameWorldLoader, Log, "Reload of `%s`: %u kept, %u patched, %u respawned, %u spawned, %u destroyed\n", m_relativeFilePath.c_str(), keptCount, patchedCount, respawnedCount, spawnedCount, destroyedCount);
+	}
+
+	void UGameWorldLoader::CreateEntity(SEntityLoadRecord& inOutRecord)
+	{
+		// Same as OGameWorld::SpawnEntityDeferred, without logging every entity of the world
+		eastl::shared_ptr<AEntity> entity = CreateDefaultObject<AEntity>(*inOutRecord.m_typeInfo, m_world.get());
+
+		entity->SetOwningWorldLayer(m_world->FindOrAddWorldLayer(inOutRecord.m_layerName));
+		entity->SetDebugName(inOutRecord.m_debugName);
+
+		inOutRecord.m_entity = entity;
+		inOutRecord.m_isNew = true;
+
+		for (uint32_t i = 0; i < inOutRecord.m_componentCount; ++i)
+		{
+			SComponentLoadRecord& currentComponent = m_componentRecords[inOutRecord.m_firstComponent + i];
+			const TTypeInfo& compTypeInfo = *currentComponent.m_typeInfo;
+
+			currentComponent.m_isLoaded = false;
+
+			if (currentComponent.m_isExisting)
+			{
+				// Find component on entity
+				currentComponent.m_component = entity->GetFirstComponentByType<UComponent>(compTypeInfo).lock();
+				if (!currentComponent.m_component)
+				{
+					LOG(LogGameWorldLoader, Warning, "\t\tExisting component `%s`: Component type not found on entity\n", compTypeInfo.GetTypeName());
+				}
+			}
+			else
+			{
+				// Add new component
+				currentComponent.m_component = entity->AddComponent<UComponent>(compTypeInfo);
+				if (!currentComponent.m_component)
+				{
+					LOG(LogGameWorldLoader, Warning, "\t\tNew component `%s`: Failed to add new component to entity\n", compTypeInfo.GetTypeName());
+				}
+			}
+		}
+	}
+
+	void UGameWorldLoader::ApplyComponentLoad(SComponentLoadRecord& inOutRecord) const
+	{
+		UComponent& comp = *inOutRecord.m_component;
+
+		if (inOutRecord.m_hasPosition)
+		{
+			comp.SetRelativeTranslation(inOutRecord.m_position);
+		}
+
+		if (inOutRecord.m_hasRotation)
+		{
+			comp.SetRelativeRotation(inOutRecord.m_rotation);
+		}
+
+		if (inOutRecord.m_hasScale)
+		{
+			comp.SetRelativeScale(inOutRecord.m_scale);
+		}
+
 		// Update the component's properties
-		comp->Load(*this, compPropertyObj);
+		comp.Load(*this, inOutRecord.m_properties);
 
-		return true;
+		inOutRecord.m_isLoaded = true;
+	}
+
+	void UGameWorldLoader::InstantiateEntities()
+	{
+		rmt_ScopedCPUSample(WorldLoader_InstantiateEntities, 0);
+
+		// Each job owns one entity and its components, the properties are only ever read
+		{
+			rmt_ScopedCPUSample(WorldLoader_LoadComponentsParallel, 0);
+
+			UJobSystem::ParallelFor(static_cast<uint32_t>(m_entityRecords.size()), [this](uint32_t inEntityIndex)
+			{
+				const SEntityLoadRecord& entityRecord = m_entityRecords[inEntityIndex];
+
+				for (uint32_t i = 0; i < entityRecord.m_componentCount; ++i)
+				{
+					SComponentLoadRecord& loadRecord = m_componentRecords[entityRecord.m_firstComponent + i];
+					if (loadRecord.m_component && !loadRecord.m_isLoaded && loadRecord.m_component->IsLoadThreadSafe())
+					{
+						ApplyComponentLoad(loadRecord);
+					}
+				}
+			});
+		}
+
+		// Commit phase, everything that has to happen in order on the main thread
+		eastl::vector<eastl::shared_ptr<AEntity>> spawnedEntities;
+		spawnedEntities.reserve(m_entityRecords.size());
+
+		for (auto& currentRecord : m_componentRecords)
+		{
+			if (currentRecord.m_component && !currentRecord.m_isLoaded)
+			{
+				ApplyComponentLoad(currentRecord);
+			}
+		}
+
+		for (const auto& currentRecord : m_entityRecords)
+		{
+			if (currentRecord.m_isNew)
+			{
+				spawnedEntities.push_back(currentRecord.m_entity);
+			}
+		}
+
+		m_world->FinalizeSpawnEntities(spawnedEntities);
+
+		LOG(LogGameWorldLoader, Log, "Instantiated %u entities with %u components\n", static_cast<uint32_t>(spawnedEntities.size()), static_cast<uint32_t>(m_componentRecords.size()));
+	}
+
+	void UGameWorldLoader::WriteSnapshot(SWorldLoadSnapshot& outSnapshot) const
+	{
+		for (const auto& currentEntity : m_entityRecords)
+		{
+			if (!currentEntity.m_entity)
+			{
+				continue;
+			}
+
+			SWorldLoadSnapshot::SLoadedEntity& loadedEntity = outSnapshot.m_entities[currentEntity.m_snapshotKey];
+			loadedEntity.m_entity = currentEntity.m_entity;
+			loadedEntity.m_typeInfo = currentEntity.m_typeInfo;
+			loadedEntity.m_contentHash = currentEntity.m_contentHash;
+			loadedEntity.m_components.clear();
+
+			for (uint32_t i = 0; i < currentEntity.m_componentCount; ++i)
+			{
+				const SComponentLoadRecord& currentComponent = m_componentRecords[currentEntity.m_firstComponent + i];
+
+				SWorldLoadSnapshot::SLoadedComponent loadedComponent;
+				loadedComponent.m_component = currentComponent.m_component;
+				loadedComponent.m_typeInfo = currentComponent.m_typeInfo;
+				loadedComponent.m_isExisting = currentComponent.m_isExisting;
+				loadedComponent.m_contentHash = currentComponent.m_contentHash;
+
+				loadedEntity.m_components.push_back(loadedComponent);
+			}
+		}
 	}
 }
@@ -1,101 +1,326 @@
 #include "Core/Pipeline/JSONTypes.h"
 
+#include <cstring>
+
+#include <EASTL/algorithm.h>
+
+#include "Core/Pipeline/WorldCooker.h"
+
 namespace MAD
 {
+	namespace
+	{
+		const SCookedValue& GetCookedValue(const SCookedWorldData& inCookedWorld, uint32_t inValueIndex)
+		{
+			return inCookedWorld.m_values[inValueIndex];
+		}
+
+		bool HasCookedNumberFlag(const SCookedValue& inValue, ECookedNumberFlags::Type inFlag)
+		{
+			return inValue.m_type == ECookedValueType::Number && (inValue.m_numberFlags & inFlag) != 0;
+		}
+
+		uint64_t CombineHash(uint64_t inHash, uint64_t inValue)
+		{
+			return inHash ^ (inValue + 0x9e3779b97f4a7c15ull + (inHash << 6) + (inHash >> 2));
+		}
+
+		uint64_t HashString(const char* inString)
+		{
+			// FNV-1a
+			uint64_t stringHash = 14695981039346656037ull;
+
+			for (const char* currentChar = inString; *currentChar; ++currentChar)
+			{
+				stringHash ^= static_cast<uint8_t>(*currentChar);
+				stringHash *= 1099511628211ull;
+			}
+
+			return stringHash;
+		}
+	}
+
+	bool UGenericValue::IsObject() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_type == ECookedValueType::Object : m_value->IsObject();
+	}
+
+	bool UGenericValue::IsArray() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_type == ECookedValueType::Array : m_value->IsArray();
+	}
+
+	bool UGenericValue::IsString() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_type == ECookedValueType::String : m_value->IsString();
+	}
+
+	bool UGenericValue::IsBool() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_type == ECookedValueType::Bool : m_value->IsBool();
+	}
+
+	bool UGenericValue::IsFloat() const
+	{
+		return m_cookedWorld ? HasCookedNumberFlag(GetCookedValue(*m_cookedWorld, m_cookedValue), ECookedNumberFlags::Float) : m_value->IsFloat();
+	}
+
+	bool UGenericValue::IsDouble() const
+	{
+		return m_cookedWorld ? HasCookedNumberFlag(GetCookedValue(*m_cookedWorld, m_cookedValue), ECookedNumberFlags::Double) : m_value->IsDouble();
+	}
+
+	bool UGenericValue::IsInt() const
+	{
+		return m_cookedWorld ? HasCookedNumberFlag(GetCookedValue(*m_cookedWorld, m_cookedValue), ECookedNumberFlags::Int) : m_value->IsInt();
+	}
+
+	bool UGenericValue::IsUint() const
+	{
+		return m_cookedWorld ? HasCookedNumberFlag(GetCookedValue(*m_cookedWorld, m_cookedValue), ECookedNumberFlags::Uint) : m_value->IsUint();
+	}
+
+	double UGenericValue::GetNumber() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_number : m_value->GetDouble();
+	}
+
+	bool UGenericValue::GetBool() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_bool != 0 : m_value->GetBool();
+	}
+
+	const char* UGenericValue::GetString() const
+	{
+		return m_cookedWorld ? m_cookedWorld->GetString(GetCookedValue(*m_cookedWorld, m_cookedValue).m_first) : m_value->GetString();
+	}
+
+	SizeType UGenericValue::GetSize() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_count : m_value->Size();
+	}
+
+	UGenericValue UGenericValue::GetElement(SizeType inIndex) const
+	{
+		if (m_cookedWorld)
+		{
+			return UGenericValue(*m_cookedWorld, GetCookedValue(*m_cookedWorld, m_cookedValue).m_first + inIndex);
+		}
+
+		return UGenericValue(&m_value->GetArray()[inIndex]);
+	}
+
+	SizeType UGenericValue::GetMemberCount() const
+	{
+		return m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_count : m_value->MemberCount();
+	}
+
+	const char* UGenericValue::GetMemberName(SizeType inIndex) const
+	{
+		if (m_cookedWorld)
+		{
+			const SCookedValue& memberValue = GetCookedValue(*m_cookedWorld, GetCookedValue(*m_cookedWorld, m_cookedValue).m_first + inIndex);
+			return m_cookedWorld->GetString(memberValue.m_nameOffset);
+		}
+
+		return (m_value->MemberBegin() + inIndex)->name.GetString();
+	}
+
+	UGenericValue UGenericValue::GetMemberValue(SizeType inIndex) const
+	{
+		if (m_cookedWorld)
+		{
+			return UGenericValue(*m_cookedWorld, GetCookedValue(*m_cookedWorld, m_cookedValue).m_first + inIndex);
+		}
+
+		return UGenericValue(&(m_value->MemberBegin() + inIndex)->value);
+	}
+
+	uint64_t UGenericValue::GetContentHash() const
+	{
+		if (IsObject())
+		{
+			// Members are summed so that their order doesn't change the hash
+			uint64_t membersHash = 0;
+			const SizeType memberCount = GetMemberCount();
+
+			for (SizeType i = 0; i < memberCount; ++i)
+			{
+				membersHash += CombineHash(HashString(GetMemberName(i)), GetMemberValue(i).GetContentHash());
+			}
+
+			return CombineHash(static_cast<uint64_t>(ECookedValueType::Object), membersHash);
+		}
+
+		if (IsArray())
+		{
+			uint64_t elementsHash = static_cast<uint64_t>(ECookedValueType::Array);
+			const SizeType elementCount = GetSize();
+
+			for (SizeType i = 0; i < elementCount; ++i)
+			{
+				elementsHash = CombineHash(elementsHash, GetElement(i).GetContentHash());
+			}
+
+			return elementsHash;
+		}
+
+		if (IsString())
+		{
+			return CombineHash(static_cast<uint64_t>(ECookedValueType::String), HashString(GetString()));
+		}
+
+		if (IsBool())
+		{
+			return CombineHash(static_cast<uint64_t>(ECookedValueType::Bool), GetBool() ? 1 : 0);
+		}
+
+		const bool isNumber = m_cookedWorld ? GetCookedValue(*m_cookedWorld, m_cookedValue).m_type == ECookedValueType::Number : m_value->IsNumber();
+		if (isNumber)
+		{
+			const double number = GetNumber();
+
+			uint64_t numberBits;
+			memcpy(&numberBits, &number, sizeof(numberBits));
+
+			return CombineHash(static_cast<uint64_t>(ECookedValueType::Number), numberBits);
+		}
+
+		return static_cast<uint64_t>(ECookedValueType::Null);
+	}
+
+	bool UGenericValue::FindMember(const char* inName, UGenericValue& outMemberValue) const
+	{
+		if (!m_cookedWorld)
+		{
+			auto memberIter = m_value->FindMember(inName);
+			if (memberIter == m_value->MemberEnd())
+			{
+				return false;
+			}
+
+			outMemberValue = UGenericValue(&memberIter->value);
+			return true;
+		}
+
+		// Cooked members are sorted by name hash
+		const SCookedValue& objectValue = GetCookedValue(*m_cookedWorld, m_cookedValue);
+		const uint32_t nameHash = UWorldCooker::HashName(inName);
+
+		const SCookedValue* membersBegin = m_cookedWorld->m_values.data() + objectValue.m_first;
+		const SCookedValue* membersEnd = membersBegin + objectValue.m_count;
+
+		const SCookedValue* memberIter = eastl::lower_bound(membersBegin, membersEnd, nameHash, [](const SCookedValue& inMember, uint32_t inHash)
+		{
+			return inMember.m_nameHash < inHash;
+		});
+
+		for (; memberIter != membersEnd && memberIter->m_nameHash == nameHash; ++memberIter)
+		{
+			if (strcmp(m_cookedWorld->GetString(memberIter->m_nameOffset), inName) == 0)
+			{
+				outMemberValue = UGenericValue(*m_cookedWorld, static_cast<uint32_t>(memberIter - m_cookedWorld->m_values.data()));
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	template <>
 	bool UGenericValue::Get(float& outFloat) const
 	{
-		if (!m_value->IsFloat())
+		if (!IsFloat())
 		{
 			return false;
 		}
 
-		outFloat = m_value->GetFloat();
+		outFloat = static_cast<float>(GetNumber());
 		return true;
 	}
 
 	template <>
 	bool UGenericValue::IsA<float>() const
 	{
-		return m_value->IsFloat();
+		return IsFloat();
 	}
 
 	template <>
 	bool UGenericValue::IsA<double>() const
 	{
-		return m_value->IsDouble();
+		return IsDouble();
 	}
 
 	template <>
 	bool UGenericValue::Get(uint32_t& outUInt) const
 	{
-		if (!m_value->IsUint())
+		if (!IsUint())
 		{
 			return false;
 		}
 
-		outUInt = m_value->GetUint();
+		outUInt = static_cast<uint32_t>(GetNumber());
 		return true;
 	}
 
 	template <>
 	bool UGenericValue::IsA<uint32_t>() const
 	{
-		return m_value->IsUint();
+		return IsUint();
 	}
 
 	template <>
 	bool UGenericValue::Get(int32_t& outInt) const
 	{
-		if (!m_value->IsInt())
+		if (!IsInt())
 		{
 			return false;
 		}
 
-		outInt = m_value->GetInt();
+		outInt = static_cast<int32_t>(GetNumber());
 		return true;
 	}
 
 	template <>
 	bool UGenericValue::IsA<int32_t>() const
 	{
-		return m_value->IsInt();
+		return IsInt();
 	}
 
 	template <>
 	bool UGenericValue::Get(eastl::string& outString) const
 	{
-		if (!m_value->IsString())
+		if (!IsString())
 		{
 			return false;
 		}
 
-		outString = m_value->GetString();
+		outString = GetString();
 		return true;
 	}
 
 	template <>
 	bool UGenericValue::IsA<eastl::string>() const
 	{
-		return m_value->IsString();
+		return IsString();
 	}
 
 	template <>
 	bool UGenericValue::Get(bool& outBool) const
 	{
-		if (!m_value->IsBool())
+		if (!IsBool())
 		{
 			return false;
 		}
 
-		outBool = m_value->GetBool();
+		outBool = GetBool();
 		return true;
 	}
 
 	template <>
 	bool UGenericValue::IsA<bool>() const
 	{
-		return m_value->IsBool();
+		return IsBool();
 	}
 
 	template <>
@@ -106,7 +331,7 @@ namespace MAD
 			return false;
 		}
 
-		UArrayValue valueArray(m_value);
+		UArrayValue valueArray(*this);
 
 		valueArray[0].Get(outVector2.x);
 		valueArray[1].Get(outVector2.y);
@@ -122,7 +347,7 @@ namespace MAD
 			return false;
 		}
 		
-		UArrayValue valueArray(m_value);
+		UArrayValue valueArray(*this);
 
 		valueArray[0].Get(outVector3.x);
 		valueArray[1].Get(outVector3.y);
@@ -134,12 +359,12 @@ namespace MAD
 	template <>
 	bool UGenericValue::IsA<Vector2>() const
 	{
-		if (!m_value->IsArray() || m_value->Size() != 2)
+		if (!IsArray() || GetSize() != 2)
 		{
 			return false;
 		}
 
-		UArrayValue valueArray(m_value);
+		UArrayValue valueArray(*this);
 
 		for (SizeType i = 0; i < 2; ++i)
 		{
@@ -155,12 +380,12 @@ namespace MAD
 	template <>
 	bool UGenericValue::IsA<Vector3>() const
 	{
-		if (!m_value->IsArray() || m_value->Size() != 3)
+		if (!IsArray() || GetSize() != 3)
 		{
 			return false;
 		}
 
-		UArrayValue valueArray(m_value);
+		UArrayValue valueArray(*this);
 
 		for (SizeType i = 0; i < 3; ++i)
 		{
@@ -176,12 +401,12 @@ namespace MAD
 	template <>
 	bool UGenericValue::IsA<Vector4>() const
 	{
-		if (!m_value->IsArray() || m_value->Size() != 4)
+		if (!IsArray() || GetSize() != 4)
 		{
 			return false;
 		}
 
-		UArrayValue valueArray(m_value);
+		UArrayValue valueArray(*this);
 
 		for (SizeType i = 0; i < 4; ++i)
 		{
@@ -202,7 +427,7 @@ namespace MAD
 			return false;
 		}
 
-		UArrayValue valueArray(m_value);
+		UArrayValue valueArray(*this);
 
 		valueArray[0].Get(outColor.x);
 		valueArray[1].Get(outColor.y);
@@ -215,23 +440,23 @@ namespace MAD
 	template <>
 	bool UGenericValue::Get(Quaternion& outQuaternion) const
 	{
-		if (!m_value->IsArray() || m_value->Size() != 4)
+		if (!IsArray() || GetSize() != 4)
 		{
 			return false;
 		}
 
-		for (SizeType i = 0; i < 3; i++)
+		for (SizeType i = 0; i < 4; i++)
 		{
-			if (!m_value[i].IsDouble())
+			if (!GetElement(i).IsDouble())
 			{
 				return false;
 			}
 		}
 
-		outQuaternion.x = m_value[0].GetFloat();
-		outQuaternion.y = m_value[1].GetFloat();
-		outQuaternion.z = m_value[2].GetFloat();
-		outQuaternion.w = m_value[3].GetFloat();
+		outQuaternion.x = static_cast<float>(GetElement(0).GetNumber());
+		outQuaternion.y = static_cast<float>(GetElement(1).GetNumber());
+		outQuaternion.z = static_cast<float>(GetElement(2).GetNumber());
+		outQuaternion.w = static_cast<float>(GetElement(3).GetNumber());
 
 		return true;
 	}
@@ -239,24 +464,24 @@ namespace MAD
 	template <>
 	bool UGenericValue::Get(UObjectValue& outObjectValue) const
 	{
-		if (!m_value->IsObject())
+		if (!IsObject())
 		{
 			return false;
 		}
 
-		outObjectValue = UObjectValue(m_value);
+		outObjectValue = UObjectValue(*this);
 		return true;
 	}
 
 	template <>
 	bool UGenericValue::Get(UArrayValue& outArrayValue) const
 	{
-		if (!m_value->IsArray())
+		if (!IsArray())
 		{
 			return false;
 		}
 
-		outArrayValue = UArrayValue(m_value);
+		outArrayValue = UArrayValue(*this);
 		return true;
 	}
 
@@ -265,39 +490,39 @@ namespace MAD
 	template <>
 	bool UObjectValue::GetProperty(const char* inPropName, UObjectValue& outObjectValue) const
 	{
-		auto propFindIter = m_objectValue.m_value->FindMember(inPropName);
+		UGenericValue propertyValue;
 
-		if (propFindIter == m_objectValue.m_value->MemberEnd())
+		if (!m_objectValue.FindMember(inPropName, propertyValue))
 		{
 			return false;
 		}
 
-		outObjectValue = UObjectValue(&propFindIter->value);
+		outObjectValue = UObjectValue(propertyValue);
 		return true;
 	}
 
 	template <>
 	bool UObjectValue::GetProperty(const char* inPropName, UArrayValue& outArrayValue) const
 	{
-		auto propFindIter = m_objectValue.m_value->FindMember(inPropName);
+		UGenericValue propertyValue;
 
-		if (propFindIter == m_objectValue.m_value->MemberEnd())
+		if (!m_objectValue.FindMember(inPropName, propertyValue))
 		{
 			return false;
 		}
 
-		outArrayValue = UArrayValue(&propFindIter->value);
+		outArrayValue = UArrayValue(propertyValue);
 		return true;
 	}
 
 	UGenericValue UArrayValue::operator[](SizeType inIndex) const
 	{
-		return UGenericValue(&m_arrayElementValue.m_value->GetArray()[inIndex]);
+		return m_arrayElementValue.GetElement(inIndex);
 	}
 
 	SizeType UArrayValue::Size() const
 	{
-		return m_arrayElementValue.m_value->GetArray().Size();
+		return m_arrayElementValue.GetSize();
 	}
 
 
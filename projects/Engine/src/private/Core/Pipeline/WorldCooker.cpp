@@ -0,0 +1,527 @@
+#include "Core/Pipeline/WorldCooker.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/hash_map.h>
+#include <EASTL/sort.h>
+
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+
+#include "Core/SimpleMath.h"
+#include "Misc/CookedFile.h"
+#include "Misc/Logging.h"
+#include "Misc/MappedFile.h"
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogWorldCooker);
+
+	const uint32_t UWorldCooker::CookedWorldVersion = 1;
+
+	namespace
+	{
+		const uint32_t g_cookedWorldMagic = 0x5744414D; // "MADW"
+
+		struct SCookedWorldHeader
+		{
+			uint32_t m_magic;
+			uint32_t m_version;
+
+			uint64_t m_sourceFileSize;
+			uint64_t m_sourceWriteTime;
+
+			uint32_t m_worldNameOffset;
+			uint32_t m_worldPropertiesValue;
+
+			uint32_t m_typeCount;
+			uint32_t m_layerCount;
+			uint32_t m_entityCount;
+			uint32_t m_componentCount;
+			uint32_t m_valueCount;
+			uint32_t m_stringTableSize;
+		};
+
+		bool IsHeaderUpToDate(const SCookedWorldHeader& inHeader, const eastl::string& inSourcePath)
+		{
+			if (inHeader.m_magic != g_cookedWorldMagic || inHeader.m_version != UWorldCooker::CookedWorldVersion)
+			{
+				return false;
+			}
+
+			uint64_t sourceFileSize = 0;
+			uint64_t sourceWriteTime = 0;
+			if (!UCookedFile::GetSourceFileStamp(inSourcePath, sourceFileSize, sourceWriteTime))
+			{
+				// Cooked files can ship without their source
+				return true;
+			}
+
+			return inHeader.m_sourceFileSize == sourceFileSize && inHeader.m_sourceWriteTime == sourceWriteTime;
+		}
+
+		class UWorldCookContext
+		{
+		public:
+			explicit UWorldCookContext(const eastl::string& inSourcePath) : m_sourcePath(inSourcePath), m_hasFailed(false) {}
+
+			SCookedWorldData m_worldData;
+
+			// Strings are de-duplicated, member names repeat a lot
+			uint32_t AddString(const char* inString)
+			{
+				const auto existingString = m_stringOffsets.find(eastl::string(inString));
+				if (existingString != m_stringOffsets.end())
+				{
+					return existingString->second;
+				}
+
+				const uint32_t stringOffset = static_cast<uint32_t>(m_worldData.m_stringTable.size());
+				m_worldData.m_stringTable.insert(m_worldData.m_stringTable.end(), inString, inString + strlen(inString) + 1);
+				m_stringOffsets.insert({ eastl::string(inString), stringOffset });
+				return stringOffset;
+			}
+
+			uint32_t AddType(const char* inTypeName)
+			{
+				const auto existingType = m_typeIndices.find(eastl::string(inTypeName));
+				if (existingType != m_typeIndices.end())
+				{
+					return existingType->second;
+				}
+
+				const uint32_t typeIndex = static_cast<uint32_t>(m_worldData.m_typeNameOffsets.size());
+				m_worldData.m_typeNameOffsets.push_back(AddString(inTypeName));
+				m_typeIndices.insert({ eastl::string(inTypeName), typeIndex });
+				return typeIndex;
+			}
+
+			// Appends a standalone value (and everything under it), returns its index. inSkippedMember is left out of objects
+			uint32_t AddValue(const rapidjson::Value& inValue, const char* inSkippedMember = nullptr)
+			{
+				const uint32_t valueIndex = static_cast<uint32_t>(m_worldData.m_values.size());
+				m_worldData.m_values.push_back(MakeValue(0, UWorldCooker::InvalidIndex));
+				FillValue(valueIndex, inValue, inSkippedMember);
+				return valueIndex;
+			}
+
+			const eastl::string& GetSourcePath() const { return m_sourcePath; }
+
+			// Set when something was found that the cooked format can't represent
+			bool HasFailed() const { return m_hasFailed; }
+
+		private:
+			SCookedValue MakeValue(uint32_t inNameHash, uint32_t inNameOffset) const
+			{
+				SCookedValue newValue;
+				memset(&newValue, 0, sizeof(newValue));
+				newValue.m_nameHash = inNameHash;
+				newValue.m_nameOffset = inNameOffset;
+				newValue.m_first = UWorldCooker::InvalidIndex;
+				return newValue;
+			}
+
+			void FillValue(uint32_t inValueIndex, const rapidjson::Value& inValue, const char* inSkippedMember)
+			{
+				// Children are appended below, so the value is only ever written through its index
+				SCookedValue filledValue = m_worldData.m_values[inValueIndex];
+
+				if (inValue.IsBool())
+				{
+					filledValue.m_type = ECookedValueType::Bool;
+					filledValue.m_bool = inValue.GetBool() ? 1 : 0;
+				}
+				else if (inValue.IsNumber())
+				{
+					filledValue.m_type = ECookedValueType::Number;
+					filledValue.m_number = inValue.GetDouble();
+					filledValue.m_numberFlags = (inValue.IsInt() ? ECookedNumberFlags::Int : 0)
+											  | (inValue.IsUint() ? ECookedNumberFlags::Uint : 0)
+											  | (inValue.IsDouble() ? ECookedNumberFlags::Double : 0)
+											  | (inValue.IsFloat() ? ECookedNumberFlags::Float : 0);
+				}
+				else if (inValue.IsString())
+				{
+					filledValue.m_type = ECookedValueType::String;
+					filledValue.m_first = AddString(inValue.GetString());
+					filledValue.m_count = inValue.GetStringLength();
+				}
+				else if (inValue.IsArray())
+				{
+					filledValue.m_type = ECookedValueType::Array;
+					filledValue.m_first = static_cast<uint32_t>(m_worldData.m_values.size());
+					filledValue.m_count = inValue.Size();
+
+					m_worldData.m_values.resize(filledValue.m_first + filledValue.m_count, MakeValue(0, UWorldCooker::InvalidIndex));
+
+					for (rapidjson::SizeType i = 0; i < inValue.Size(); ++i)
+					{
+						FillValue(filledValue.m_first + i, inValue[i], nullptr);
+					}
+				}
+				else if (inValue.IsObject())
+				{
+					eastl::vector<const rapidjson::Value::Member*> members;
+					for (auto memberIter = inValue.MemberBegin(); memberIter != inValue.MemberEnd(); ++memberIter)
+					{
+						if (!inSkippedMember || strcmp(memberIter->name.GetString(), inSkippedMember) != 0)
+						{
+							members.push_back(&*memberIter);
+						}
+					}
+
+					eastl::stable_sort(members.begin(), members.end(), [](const rapidjson::Value::Member* inFirst, const rapidjson::Value::Member* inSecond)
+					{
+						return UWorldCooker::HashName(inFirst->name.GetString()) < UWorldCooker::HashName(inSecond->name.GetString());
+					});
+
+					filledValue.m_type = ECookedValueType::Object;
+					filledValue.m_first = static_cast<uint32_t>(m_worldData.m_values.size());
+					filledValue.m_count = static_cast<uint32_t>(members.size());
+
+					for (size_t i = 0; i < members.size(); ++i)
+					{
+						const char* memberName = members[i]->name.GetString();
+						const uint32_t memberHash = UWorldCooker::HashName(memberName);
+
+						if (i > 0 && memberHash == UWorldCooker::HashName(members[i - 1]->name.GetString()) && strcmp(memberName, members[i - 1]->name.GetString()) != 0)
+						{
+							LOG(LogWorldCooker, Error, "Cannot cook world '%s', the property names `%s` and `%s` have the same hash\n", m_sourcePath.c_str(), memberName, members[i - 1]->name.GetString());
+							m_hasFailed = true;
+						}
+
+						m_worldData.m_values.push_back(MakeValue(memberHash, AddString(memberName)));
+					}
+
+					for (size_t i = 0; i < members.size(); ++i)
+					{
+						FillValue(filledValue.m_first + static_cast<uint32_t>(i), members[i]->value, nullptr);
+					}
+				}
+				else
+				{
+					filledValue.m_type = ECookedValueType::Null;
+				}
+
+				m_worldData.m_values[inValueIndex] = filledValue;
+			}
+
+			eastl::string m_sourcePath;
+			bool m_hasFailed;
+			eastl::hash_map<eastl::string, uint32_t> m_stringOffsets;
+			eastl::hash_map<eastl::string, uint32_t> m_typeIndices;
+		};
+
+		// Same checks the JSON loader makes on the transform properties, so both paths accept the same files
+		bool ReadVector3(const rapidjson::Value& inObject, const char* inName, float outVector[3])
+		{
+			const auto memberIter = inObject.FindMember(inName);
+			if (memberIter == inObject.MemberEnd() || !memberIter->value.IsArray() || memberIter->value.Size() != 3)
+			{
+				return false;
+			}
+
+			for (rapidjson::SizeType i = 0; i < 3; ++i)
+			{
+				if (!memberIter->value[i].IsDouble())
+				{
+					return false;
+				}
+
+				outVector[i] = memberIter->value[i].GetFloat();
+			}
+
+			return true;
+		}
+
+		bool CookComponent(UWorldCookContext& inOutContext, const rapidjson::Value& inComponent, SCookedComponent& outComponent)
+		{
+			memset(&outComponent, 0, sizeof(outComponent));
+
+			const auto typeIter = inComponent.FindMember("type");
+			if (typeIter == inComponent.MemberEnd() || !typeIter->value.IsString())
+			{
+				LOG(LogWorldCooker, Warning, "\t\tComponent has no specified type name, skipping\n");
+				return false;
+			}
+
+			outComponent.m_typeIndex = inOutContext.AddType(typeIter->value.GetString());
+			outComponent.m_propertiesValue = UWorldCooker::InvalidIndex;
+
+			// Components without properties are reported (and skipped) when the world is loaded, same as from JSON
+			const auto propertiesIter = inComponent.FindMember("properties");
+			if (propertiesIter != inComponent.MemberEnd() && propertiesIter->value.IsObject())
+			{
+				outComponent.m_propertiesValue = inOutContext.AddValue(propertiesIter->value);
+			}
+
+			if (ReadVector3(inComponent, "position", outComponent.m_position))
+			{
+				outComponent.m_flags |= ECookedComponentFlags::HasPosition;
+			}
+
+			float rotationAngles[3];
+			if (ReadVector3(inComponent, "rotation", rotationAngles))
+			{
+				const Quaternion rotation = FromEulerAngles(ConvertToRadians(rotationAngles[0]), ConvertToRadians(rotationAngles[1]), ConvertToRadians(rotationAngles[2]));
+
+				outComponent.m_rotation[0] = rotation.x;
+				outComponent.m_rotation[1] = rotation.y;
+				outComponent.m_rotation[2] = rotation.z;
+				outComponent.m_rotation[3] = rotation.w;
+				outComponent.m_flags |= ECookedComponentFlags::HasRotation;
+			}
+
+			const auto scaleIter = inComponent.FindMember("scale");
+			if (scaleIter != inComponent.MemberEnd() && scaleIter->value.IsFloat())
+			{
+				outComponent.m_scale = scaleIter->value.GetFloat();
+				outComponent.m_flags |= ECookedComponentFlags::HasScale;
+			}
+
+			return true;
+		}
+
+		// Components that can't be cooked are left out, the JSON loader skips them too
+		uint32_t CookComponentArray(UWorldCookContext& inOutContext, const rapidjson::Value& inEntity, const char* inArrayName)
+		{
+			const auto arrayIter = inEntity.FindMember(inArrayName);
+			if (arrayIter == inEntity.MemberEnd() || !arrayIter->value.IsArray())
+			{
+				return 0;
+			}
+
+			uint32_t componentCount = 0;
+			for (const auto& currentComponent : arrayIter->value.GetArray())
+			{
+				SCookedComponent cookedComponent;
+				if (!currentComponent.IsObject() || !CookComponent(inOutContext, currentComponent, cookedComponent))
+				{
+					continue;
+				}
+
+				inOutContext.m_worldData.m_components.push_back(cookedComponent);
+				++componentCount;
+			}
+
+			return componentCount;
+		}
+
+		bool CookWorldData(UWorldCookContext& inOutContext, const rapidjson::Document& inWorld)
+		{
+			SCookedWorldData& worldData = inOutContext.m_worldData;
+
+			const auto worldNameIter = inWorld.FindMember("worldName");
+			if (!inWorld.IsObject() || worldNameIter == inWorld.MemberEnd() || !worldNameIter->value.IsString())
+			{
+				LOG(LogWorldCooker, Error, "Cannot cook world '%s', it has no world name\n", inOutContext.GetSourcePath().c_str());
+				return false;
+			}
+
+			worldData.m_worldNameOffset = inOutContext.AddString(worldNameIter->value.GetString());
+
+			worldData.m_worldPropertiesValue = inOutContext.AddValue(inWorld, "layers");
+
+			const auto layersIter = inWorld.FindMember("layers");
+			if (layersIter == inWorld.MemberEnd() || !layersIter->value.IsArray())
+			{
+				return !inOutContext.HasFailed();
+			}
+
+			for (const auto& currentLayer : layersIter->value.GetArray())
+			{
+				const auto layerNameIter = currentLayer.IsObject() ? currentLayer.FindMember("name") : currentLayer.MemberEnd();
+				if (!currentLayer.IsObject() || layerNameIter == currentLayer.MemberEnd() || !layerNameIter->value.IsString())
+				{
+					LOG(LogWorldCooker, Warning, "Layer has no name, skipping\n");
+					continue;
+				}
+
+				SCookedLayer cookedLayer;
+				cookedLayer.m_nameOffset = inOutContext.AddString(layerNameIter->value.GetString());
+				cookedLayer.m_firstEntity = static_cast<uint32_t>(worldData.m_entities.size());
+				cookedLayer.m_entityCount = 0;
+
+				const auto entitiesIter = currentLayer.FindMember("entities");
+				if (entitiesIter != currentLayer.MemberEnd() && entitiesIter->value.IsArray())
+				{
+					for (const auto& currentEntity : entitiesIter->value.GetArray())
+					{
+						if (!currentEntity.IsObject())
+						{
+							continue;
+						}
+
+						const auto typeIter = currentEntity.FindMember("type");
+						const auto nameIter = currentEntity.FindMember("name");
+
+						SCookedEntity cookedEntity;
+						cookedEntity.m_typeIndex = inOutContext.AddType(typeIter != currentEntity.MemberEnd() && typeIter->value.IsString() ? typeIter->value.GetString() : "AEntity");
+						cookedEntity.m_nameOffset = inOutContext.AddString(nameIter != currentEntity.MemberEnd() && nameIter->value.IsString() ? nameIter->value.GetString() : "UNASSIGNED");
+						cookedEntity.m_firstComponent = static_cast<uint32_t>(worldData.m_components.size());
+
+						cookedEntity.m_existingComponentCount = CookComponentArray(inOutContext, currentEntity, "existingComponents");
+						cookedEntity.m_newComponentCount = CookComponentArray(inOutContext, currentEntity, "newComponents");
+
+						worldData.m_entities.push_back(cookedEntity);
+						++cookedLayer.m_entityCount;
+					}
+				}
+
+				worldData.m_layers.push_back(cookedLayer);
+			}
+
+			return !inOutContext.HasFailed();
+		}
+	}
+
+	uint32_t UWorldCooker::HashName(const char* inName)
+	{
+		// FNV-1a
+		uint32_t nameHash = 2166136261u;
+
+		for (const char* currentChar = inName; *currentChar; ++currentChar)
+		{
+			nameHash ^= static_cast<uint8_t>(*currentChar);
+			nameHash *= 16777619u;
+		}
+
+		return nameHash;
+	}
+
+	eastl::string UWorldCooker::GetCookedWorldPath(const eastl::string& inSourcePath)
+	{
+		return inSourcePath + ".madworld";
+	}
+
+	bool UWorldCooker::CookWorld(const eastl::string& inSourcePath)
+	{
+		SCookedWorldHeader cookedHeader = {};
+		cookedHeader.m_magic = g_cookedWorldMagic;
+		cookedHeader.m_version = CookedWorldVersion;
+
+		if (!UCookedFile::GetSourceFileStamp(inSourcePath, cookedHeader.m_sourceFileSize, cookedHeader.m_sourceWriteTime))
+		{
+			LOG(LogWorldCooker, Error, "Cannot cook world '%s', the source file doesn't exist\n", inSourcePath.c_str());
+			return false;
+		}
+
+		std::ifstream sourceStream(inSourcePath.c_str(), std::ios::in | std::ios::binary);
+		eastl::string sourceText;
+
+		sourceStream.seekg(0, sourceStream.end);
+		sourceText.resize(static_cast<size_t>(sourceStream.tellg()));
+		sourceStream.seekg(0, sourceStream.beg);
+		sourceStream.read(&sourceText[0], sourceText.size());
+
+		rapidjson::Document worldDocument;
+		if (worldDocument.Parse(sourceText.c_str()).HasParseError())
+		{
+			LOG(LogWorldCooker, Error, "Cannot cook world '%s'. Error(offset %d) %s\n", inSourcePath.c_str(), worldDocument.GetErrorOffset(), rapidjson::GetParseError_En(worldDocument.GetParseError()));
+			return false;
+		}
+
+		UWorldCookContext cookContext(inSourcePath);
+		if (!CookWorldData(cookContext, worldDocument))
+		{
+			return false;
+		}
+
+		const SCookedWorldData& worldData = cookContext.m_worldData;
+
+		cookedHeader.m_worldNameOffset = worldData.m_worldNameOffset;
+		cookedHeader.m_worldPropertiesValue = worldData.m_worldPropertiesValue;
+		cookedHeader.m_typeCount = static_cast<uint32_t>(worldData.m_typeNameOffsets.size());
+		cookedHeader.m_layerCount = static_cast<uint32_t>(worldData.m_layers.size());
+		cookedHeader.m_entityCount = static_cast<uint32_t>(worldData.m_entities.size());
+		cookedHeader.m_componentCount = static_cast<uint32_t>(worldData.m_components.size());
+		cookedHeader.m_valueCount = static_cast<uint32_t>(worldData.m_values.size());
+		cookedHeader.m_stringTableSize = static_cast<uint32_t>(worldData.m_stringTable.size());
+
+		const eastl::string cookedPath = GetCookedWorldPath(inSourcePath);
+		std::ofstream cookedStream(cookedPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!cookedStream.is_open())
+		{
+			LOG(LogWorldCooker, Error, "Failed to open '%s' for writing\n", cookedPath.c_str());
+			return false;
+		}
+
+		// Sections are written in the order LoadCookedWorld reads them
+		UCookedFile::WriteSection(cookedStream, &cookedHeader, 1);
+		UCookedFile::WriteSection(cookedStream, worldData.m_typeNameOffsets.data(), worldData.m_typeNameOffsets.size());
+		UCookedFile::WriteSection(cookedStream, worldData.m_layers.data(), worldData.m_layers.size());
+		UCookedFile::WriteSection(cookedStream, worldData.m_entities.data(), worldData.m_entities.size());
+		UCookedFile::WriteSection(cookedStream, worldData.m_components.data(), worldData.m_components.size());
+		UCookedFile::WriteSection(cookedStream, worldData.m_values.data(), worldData.m_values.size());
+		UCookedFile::WriteSection(cookedStream, worldData.m_stringTable.data(), worldData.m_stringTable.size());
+
+		if (!cookedStream.good())
+		{
+			LOG(LogWorldCooker, Error, "Failed to write cooked world '%s'\n", cookedPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool UWorldCooker::IsCookedWorldUpToDate(const eastl::string& inSourcePath)
+	{
+		std::ifstream cookedStream(GetCookedWorldPath(inSourcePath).c_str(), std::ios::in | std::ios::binary);
+		if (!cookedStream.is_open())
+		{
+			return false;
+		}
+
+		SCookedWorldHeader cookedHeader;
+		if (!cookedStream.read(reinterpret_cast<char*>(&cookedHeader), sizeof(cookedHeader)))
+		{
+			return false;
+		}
+
+		return IsHeaderUpToDate(cookedHeader, inSourcePath);
+	}
+
+	bool UWorldCooker::LoadCookedWorld(const eastl::string& inSourcePath, SCookedWorldData& outWorldData)
+	{
+		UMappedFile cookedFile;
+		if (!cookedFile.Open(GetCookedWorldPath(inSourcePath)) || cookedFile.GetSize() < sizeof(SCookedWorldHeader))
+		{
+			return false;
+		}
+
+		const uint8_t* cursor = cookedFile.GetData();
+		const uint8_t* fileEnd = cursor + cookedFile.GetSize();
+
+		SCookedWorldHeader cookedHeader;
+		memcpy(&cookedHeader, cursor, sizeof(cookedHeader));
+		cursor += UCookedFile::AlignSectionSize(sizeof(cookedHeader));
+
+		if (!IsHeaderUpToDate(cookedHeader, inSourcePath))
+		{
+			return false;
+		}
+
+		outWorldData = SCookedWorldData();
+		outWorldData.m_worldNameOffset = cookedHeader.m_worldNameOffset;
+		outWorldData.m_worldPropertiesValue = cookedHeader.m_worldPropertiesValue;
+
+		const bool readAllSections = UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_typeCount, outWorldData.m_typeNameOffsets)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_layerCount, outWorldData.m_layers)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_entityCount, outWorldData.m_entities)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_componentCount, outWorldData.m_components)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_valueCount, outWorldData.m_values)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_stringTableSize, outWorldData.m_stringTable)
+								  && !outWorldData.m_stringTable.empty() && outWorldData.m_stringTable.back() == '\0'
+								  && outWorldData.m_worldPropertiesValue < outWorldData.m_values.size();
+
+		if (!readAllSections)
+		{
+			LOG(LogWorldCooker, Warning, "Cooked world for '%s' is truncated\n", inSourcePath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -126,6 +126,11 @@ namespace MAD
 	}
 
 	void UColorTextureCube::BindCubeSideAsTarget(uint8_t inCubeSide) const
+	{
+		BindCubeSideAsTarget(URenderContext::Get().GetGraphicsDriver(), inCubeSide);
+	}
+
+	void UColorTextureCube::BindCubeSideAsTarget(UGraphicsDriver& inGraphicsDriver, uint8_t inCubeSide) const
 	{
 		MAD_ASSERT_DESC(inCubeSide < m_cubeOutputViews.size(), "Error: Invalid side number");
 		MAD_ASSERT_DESC(m_bIsDynamic, "Error: You may not bind a pre-loaded cube map as a render target");
@@ -135,12 +140,10 @@ namespace MAD
 			return;
 		}
 
-		auto& graphicsDriver = URenderContext::Get().GetGraphicsDriver();
-
-		graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::CubeMap); // If we're binding a cube side as a render target view, we must unbind it as a shader resource
-		graphicsDriver.ClearDepthStencil(m_cubeOutputViews[inCubeSide].first, true, 1.0f);
-		graphicsDriver.ClearRenderTarget(m_cubeOutputViews[inCubeSide].second, m_clearColor);
-		graphicsDriver.SetRenderTargets(&m_cubeOutputViews[inCubeSide].second, 1, m_cubeOutputViews[inCubeSide].first); // Bind the render target and depth stencil view that corresponds with the target cube side
-		graphicsDriver.SetViewport(m_viewPort); // Change the viewport to match texture cube resolution
+		inGraphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::CubeMap); // If we're binding a cube side as a render target view, we must unbind it as a shader resource
+		inGraphicsDriver.ClearDepthStencil(m_cubeOutputViews[inCubeSide].first, true, 1.0f);
+		inGraphicsDriver.ClearRenderTarget(m_cubeOutputViews[inCubeSide].second, m_clearColor);
+		inGraphicsDriver.SetRenderTargets(&m_cubeOutputViews[inCubeSide].second, 1, m_cubeOutputViews[inCubeSide].first); // Bind the render target and depth stencil view that corresponds with the target cube side
+		inGraphicsDriver.SetViewport(m_viewPort); // Change the viewport to match texture cube resolution
 	}
 }
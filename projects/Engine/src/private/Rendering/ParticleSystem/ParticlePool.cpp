@@ -0,0 +1,130 @@
+#include "Rendering/ParticleSystem/ParticlePool.h"
+
+#include <cstring>
+
+#include <DirectXMath.h>
+
+#include <EASTL/algorithm.h>
+
+namespace MAD
+{
+	UParticlePool::UParticlePool() : m_particleCount(0) {}
+
+	bool UParticlePool::AddParticle(const SCPUParticle& inParticle)
+	{
+		if (IsFull())
+		{
+			return false;
+		}
+
+		m_initialPositions[m_particleCount] = inParticle.InitialPosVS;
+		m_initialVelocities[m_particleCount] = inParticle.InitialVelVS;
+		m_colors[m_particleCount] = inParticle.ParticleColor;
+		m_sizes[m_particleCount] = inParticle.ParticleSize;
+		m_ages[m_particleCount] = inParticle.ParticleAge;
+		m_durations[m_particleCount] = inParticle.Duration;
+
+		++m_particleCount;
+		return true;
+	}
+
+	SParticlePoolRange UParticlePool::ReserveParticles(uint32_t inCount)
+	{
+		const uint32_t firstParticle = m_particleCount;
+
+		SParticlePoolRange reservedRange;
+		reservedRange.m_count = eastl::min(inCount, s_maxNumParticles - firstParticle);
+		reservedRange.m_initialPositions = m_initialPositions.data() + firstParticle;
+		reservedRange.m_initialVelocities = m_initialVelocities.data() + firstParticle;
+		reservedRange.m_colors = m_colors.data() + firstParticle;
+		reservedRange.m_sizes = m_sizes.data() + firstParticle;
+		reservedRange.m_ages = m_ages.data() + firstParticle;
+		reservedRange.m_durations = m_durations.data() + firstParticle;
+
+		m_particleCount += reservedRange.m_count;
+		return reservedRange;
+	}
+
+	void UParticlePool::AgeParticles(float inDeltaTime)
+	{
+		using namespace DirectX;
+
+		const XMVECTOR deltaTime = XMVectorReplicate(inDeltaTime);
+		const uint32_t blockEnd = m_particleCount & ~3u;
+		uint32_t liveCount = 0;
+
+		// Ages and kills four particles at a time. Survivors are packed down over the dead ones in order, so the pool stays
+		// contiguous without the shuffling that swapping the last particle into each hole would cause
+		for (uint32_t blockStart = 0; blockStart < blockEnd; blockStart += 4)
+		{
+			XMFLOAT4* blockAges = reinterpret_cast<XMFLOAT4*>(&m_ages[blockStart]);
+			const XMVECTOR ages = XMVectorAdd(XMLoadFloat4(blockAges), deltaTime);
+			XMStoreFloat4(blockAges, ages);
+
+			uint32_t comparison;
+			const XMVECTOR deadLanes = XMVectorGreaterR(&comparison, ages, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&m_durations[blockStart])));
+
+			if (XMComparisonAllTrue(comparison))
+			{
+				continue;
+			}
+
+			if (XMComparisonAllFalse(comparison))
+			{
+				// The whole block lives, which is by far the most common case. It only moves when something before it died
+				if (liveCount != blockStart)
+				{
+					MoveParticles(blockStart, liveCount, 4);
+				}
+
+				liveCount += 4;
+				continue;
+			}
+
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				if (XMVectorGetIntByIndex(deadLanes, i) == 0)
+				{
+					MoveParticles(blockStart + i, liveCount, 1);
+					++liveCount;
+				}
+			}
+		}
+
+		for (uint32_t i = blockEnd; i < m_particleCount; ++i)
+		{
+			m_ages[i] += inDeltaTime;
+
+			if (m_ages[i] <= m_durations[i])
+			{
+				MoveParticles(i, liveCount, 1);
+				++liveCount;
+			}
+		}
+
+		m_particleCount = liveCount;
+	}
+
+	void UParticlePool::SetInitialPositions(const Vector3& inInitialPos)
+	{
+		for (uint32_t i = 0; i < m_particleCount; ++i)
+		{
+			m_initialPositions[i] = inInitialPos;
+		}
+	}
+
+	void UParticlePool::MoveParticles(uint32_t inFrom, uint32_t inTo, uint32_t inCount)
+	{
+		if (inFrom == inTo)
+		{
+			return;
+		}
+
+		memmove(&m_initialPositions[inTo], &m_initialPositions[inFrom], inCount * sizeof(Vector3));
+		memmove(&m_initialVelocities[inTo], &m_initialVelocities[inFrom], inCount * sizeof(Vector3));
+		memmove(&m_colors[inTo], &m_colors[inFrom], inCount * sizeof(Vector4));
+		memmove(&m_sizes[inTo], &m_sizes[inFrom], inCount * sizeof(Vector2));
+		memmove(&m_ages[inTo], &m_ages[inFrom], inCount * sizeof(float));
+		memmove(&m_durations[inTo], &m_durations[inFrom], inCount * sizeof(float));
+	}
+}
@@ -15,6 +15,12 @@ namespace MAD
 {
 	DECLARE_LOG_CATEGORY(LogParticleSystem);
 
+	namespace
+	{
+		// Every system gets its own random numbers, systems spawned from the same parameters don't all look the same
+		uint32_t g_nextRandomSeed = 1;
+	}
+
 	void UParticleSystem::Initialize(const SParticleSystemSpawnParams& inSystemParams, const eastl::vector<SParticleEmitterSpawnParams>& inEmitterParams)
 	{
 		m_particleSystemName = inSystemParams.SystemName;
@@ -22,7 +28,8 @@ namespace MAD
 		InitializePipeline(inSystemParams);
 
 		m_firstInactiveEmitter = 0;
-		m_firstInactiveParticle = 0;
+		m_particlePool.Clear();
+		m_randomStream.Seed(g_nextRandomSeed++);
 
 		for (const auto& currEmitterSpawnParams : inEmitterParams)
 		{
@@ -59,52 +66,22 @@ namespace MAD
 
 	void UParticleSystem::TransformParticles(const Vector3& newInitPos/*, const Vector3& newInitVel*/)
 	{
-		for (size_t i = 0; i < m_firstInactiveParticle; ++i)
-		{
-			m_cpuParticlePool[i].InitialPosVS = newInitPos;
-		}
+		m_particlePool.SetInitialPositions(newInitPos);
 	}
 
-	void UParticleSystem::TickSystem(float inDeltaTime)
+	void UParticleSystem::SimulateSystem(float inDeltaTime)
 	{
-		eastl::vector<SCPUParticle> particleBuffer;
-
 		// Allow the particle emitters to emit particles if needed
+		// TODO: We need to retrieve the correct initial view space position of owning component so we can set initial vs position correctly
 		for (size_t i = 0; i < m_firstInactiveEmitter; ++i)
 		{
-			m_particleEmitters[i].TickEmitter(inDeltaTime, particleBuffer);
-
-			if (!particleBuffer.empty())
-			{
-				// TODO: We need to retrieve the correct initial view space position of owning component so we can set initial vs position correctly
-				ActivateParticles(particleBuffer);
-			}
-
-			particleBuffer.clear();
-		}
-
-		// Kill off particles if needed
-		const size_t numActiveParticles = m_firstInactiveParticle;
-		for (size_t i = 0; i < numActiveParticles; ++i)
-		{
-			if (m_cpuParticlePool[i].ParticleAge > m_cpuParticlePool[i].Duration)
-			{
-				eastl::swap(m_cpuParticlePool[i], m_cpuParticlePool[m_firstInactiveParticle - 1]);
-
-				--m_firstInactiveParticle;
-			}
-		}
-
-		// Tick all of the active particles
-		for (size_t i = 0; i < m_firstInactiveParticle; ++i)
-		{
-			m_cpuParticlePool[i].ParticleAge += inDeltaTime;
+			m_particleEmitters[i].TickEmitter(inDeltaTime, m_randomStream, m_particlePool);
 		}
 
-		//LOG(LogParticleSystem, Log, "Active Particles: %d\n", m_firstInactiveParticle);
+		// Age the active particles, and kill off the ones that are done
+		m_particlePool.AgeParticles(inDeltaTime);
 
-		// Perform draw calls on the particles that are still alive
-		DrawParticles(inDeltaTime);
+		//LOG(LogParticleSystem, Log, "Active Particles: %d\n", m_particlePool.GetParticleCount());
 	}
 
 	void UParticleSystem::InitializePipeline(const SParticleSystemSpawnParams& inSystemParams)
@@ -151,58 +128,32 @@ namespace MAD
 		}
 
 		// Initialize vertex buffers for particle data
-		m_initParticlePosVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::InitialPos), EInputLayoutSemantic::INVALID, nullptr, sizeof(SCPUParticle::InitialPosVS), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
-		m_initParticleVelVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::InitialVel), EInputLayoutSemantic::INVALID, nullptr, sizeof(SCPUParticle::InitialVelVS), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
-		m_particleColorVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::Color), EInputLayoutSemantic::INVALID, nullptr, sizeof(SCPUParticle::ParticleColor), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
-		m_particleSizeVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::Size), EInputLayoutSemantic::INVALID, nullptr, sizeof(SCPUParticle::ParticleSize), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
-		m_particleAgeVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::Age), EInputLayoutSemantic::INVALID, nullptr, sizeof(SCPUParticle::ParticleAge), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
+		m_initParticlePosVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::InitialPos), EInputLayoutSemantic::INVALID, nullptr, sizeof(Vector3), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
+		m_initParticleVelVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::InitialVel), EInputLayoutSemantic::INVALID, nullptr, sizeof(Vector3), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
+		m_particleColorVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::Color), EInputLayoutSemantic::INVALID, nullptr, sizeof(Vector4), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
+		m_particleSizeVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::Size), EInputLayoutSemantic::INVALID, nullptr, sizeof(Vector2), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
+		m_particleAgeVB = UVertexArray(graphicsDriver, AsIntegral(EParticleVertexBufferSlot::Age), EInputLayoutSemantic::INVALID, nullptr, sizeof(float), s_maxNumParticles, EResourceUsage::Dynamic, ECPUAccess::Write);
 	}
 
 	void UParticleSystem::UpdatePipelineData()
 	{
 		auto& graphicsDriver = URenderContext::Get().GetGraphicsDriver();
-
-		for (size_t i = 0; i < m_firstInactiveParticle; ++i)
-		{
-			m_gpuInitPosData[i] = m_cpuParticlePool[i].InitialPosVS;
-			m_gpuInitVelData[i] = m_cpuParticlePool[i].InitialVelVS;
-			m_gpuColorData[i] = m_cpuParticlePool[i].ParticleColor;
-			m_gpuSizeData[i] = m_cpuParticlePool[i].ParticleSize;
-			m_gpuAgeData[i] = m_cpuParticlePool[i].ParticleAge;
-		}
-
-		m_initParticlePosVB.Update(graphicsDriver, m_gpuInitPosData.data(), m_firstInactiveParticle * sizeof(SCPUParticle::InitialPosVS));
-		m_initParticleVelVB.Update(graphicsDriver, m_gpuInitVelData.data(), m_firstInactiveParticle * sizeof(SCPUParticle::InitialVelVS));
-		m_particleColorVB.Update(graphicsDriver, m_gpuColorData.data(), m_firstInactiveParticle * sizeof(SCPUParticle::ParticleColor));
-		m_particleSizeVB.Update(graphicsDriver, m_gpuSizeData.data(), m_firstInactiveParticle * sizeof(SCPUParticle::ParticleSize));
-		m_particleAgeVB.Update(graphicsDriver, m_gpuAgeData.data(), m_firstInactiveParticle * sizeof(SCPUParticle::ParticleAge));
-	}
-
-	void UParticleSystem::ActivateParticles(const eastl::vector<SCPUParticle>& inNewParticles)
-	{
-		if (m_firstInactiveParticle == UParticleSystem::s_maxNumParticles)
-		{
-			return;
-		}
-
-		uint32_t numSpawnedParticles = static_cast<uint32_t>(inNewParticles.size());
-
-		if (m_firstInactiveParticle + numSpawnedParticles > UParticleSystem::s_maxNumParticles)
-		{
-			numSpawnedParticles -= ((m_firstInactiveParticle + numSpawnedParticles) - UParticleSystem::s_maxNumParticles);
-		}
-
-		memcpy(&m_cpuParticlePool[m_firstInactiveParticle], inNewParticles.data(), numSpawnedParticles * sizeof(SCPUParticle));
-
-		m_firstInactiveParticle += numSpawnedParticles;
+		const uint32_t particleCount = m_particlePool.GetParticleCount();
+
+		// The pool is laid out like the vertex buffers, so each one is a single copy of the live range
+		m_initParticlePosVB.Update(graphicsDriver, m_particlePool.GetInitialPositions(), particleCount * sizeof(Vector3));
+		m_initParticleVelVB.Update(graphicsDriver, m_particlePool.GetInitialVelocities(), particleCount * sizeof(Vector3));
+		m_particleColorVB.Update(graphicsDriver, m_particlePool.GetColors(), particleCount * sizeof(Vector4));
+		m_particleSizeVB.Update(graphicsDriver, m_particlePool.GetSizes(), particleCount * sizeof(Vector2));
+		m_particleAgeVB.Update(graphicsDriver, m_particlePool.GetAges(), particleCount * sizeof(float));
 	}
 
-	void UParticleSystem::DrawParticles(float)
+	void UParticleSystem::DrawParticles()
 	{
 		auto& graphicsDriver = URenderContext::Get().GetGraphicsDriver();
 		auto renderContext = graphicsDriver.TEMPGetDeviceContext();
 
-		if (m_firstInactiveParticle == 0)
+		if (m_particlePool.GetParticleCount() == 0)
 		{
 			// No particles to draw, exit early
 			return;
@@ -235,7 +186,7 @@ namespace MAD
 		m_renderPassDescriptor.ApplyPassState(graphicsDriver);
 
 		// Draw the particles
-		renderContext->Draw(m_firstInactiveParticle, 0);
+		renderContext->Draw(m_particlePool.GetParticleCount(), 0);
 	}
 
 }
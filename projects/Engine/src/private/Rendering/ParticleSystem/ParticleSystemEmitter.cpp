@@ -1,29 +1,17 @@
 #include "Rendering/ParticleSystem/ParticleSystemEmitter.h"
+#include "Rendering/ParticleSystem/ParticlePool.h"
 #include "Core/GameEngine.h"
-#include <stdlib.h>
-#include <time.h>
+#include "Misc/RandomStream.h"
+
+#include <DirectXMath.h>
+
+#include <EASTL/algorithm.h>
 
 namespace
 {
-	DirectX::SimpleMath::Vector3 ComputeRandomVelocity(float inRadius, float inMinAngle, float inMaxAngle)
-	{
-		const float coneHeight = 1.0;
-		float u = rand() % static_cast<uint32_t>(coneHeight);
-		float minAngleDegrees = MAD::ConvertToDegrees(inMinAngle);
-		float maxAngleDegrees = MAD::ConvertToDegrees(inMaxAngle);
-		float randAngle = minAngleDegrees + (rand() % static_cast<uint32_t>(maxAngleDegrees - minAngleDegrees));
-		float heightCoeffFactor = (coneHeight - u) / coneHeight;
-
-		float velX = heightCoeffFactor * inRadius * cos(MAD::ConvertToRadians(randAngle));
-		float velY = heightCoeffFactor * inRadius * sin(MAD::ConvertToRadians(randAngle));
-		float velZ = u;
-
-		return DirectX::SimpleMath::Vector3(velX, velY, velZ);
-		//float velXMag = rand() % 100 - 50; // -200,200
-		//float velYMag = (rand() % 200 + 100);  // 0,400
-		//float velZMag = 0;
-		//return DirectX::SimpleMath::Vector3(velXMag, velYMag, velZMag);
-	}
+	// Particles whose random numbers are generated together. Keeps the scratch space on the stack, a multiple of four so
+	// that no random numbers go to waste
+	const uint32_t g_emitBatchSize = 64;
 }
 
 namespace MAD
@@ -65,7 +53,7 @@ namespace MAD
 		m_bRepeat = (inSpawnParams.EmitDuration == -1.0f);
 	}
 
-	void UParticleSystemEmitter::TickEmitter(float inDeltaTime, eastl::vector<SCPUParticle>& outEmittedParticles)
+	void UParticleSystemEmitter::TickEmitter(float inDeltaTime, URandomStream& inOutRandom, UParticlePool& inOutPool)
 	{
 		if (IsFinished())
 		{
@@ -75,12 +63,14 @@ namespace MAD
 		m_runningEmitDuration += inDeltaTime;
 		m_rateAccumulator += inDeltaTime;
 
-		// Accumulated enough time to emit a particle
-		if (m_rateAccumulator >= m_emitRate)
+		// Emit every particle that came due since the last tick, so that rates above the tick rate aren't capped by it
+		const float dueParticleCount = floorf(m_rateAccumulator / m_emitRate);
+		if (dueParticleCount >= 1.0f)
 		{
-			outEmittedParticles.emplace_back(EmitParticle());
+			m_rateAccumulator -= dueParticleCount * m_emitRate;
 
-			m_rateAccumulator -= m_emitRate;
+			// Whatever doesn't fit in the pool anymore is dropped, not saved up for later
+			EmitParticles(static_cast<uint32_t>(eastl::min(dueParticleCount, static_cast<float>(UParticlePool::s_maxNumParticles))), inOutRandom, inOutPool);
 		}
 	}
 
@@ -89,18 +79,63 @@ namespace MAD
 		return m_runningEmitDuration > m_emitDuration && !m_bRepeat;
 	}
 
-	SCPUParticle UParticleSystemEmitter::EmitParticle()
+	void UParticleSystemEmitter::EmitParticles(uint32_t inParticleCount, URandomStream& inOutRandom, UParticlePool& inOutPool)
 	{
-		// Emit particle with random velocity and color
-		float currentGameTime = gEngine->GetGameTime();
-		float interpolationFactor = (cos(currentGameTime) * 0.5) + 0.5;
+		using namespace DirectX;
+
+		const SParticlePoolRange emittedRange = inOutPool.ReserveParticles(inParticleCount);
+		if (emittedRange.m_count == 0)
+		{
+			return;
+		}
+
+		// Color and size pulse over time, the same for every particle emitted this tick
+		const float interpolationFactor = (cosf(gEngine->GetGameTime()) * 0.5f) + 0.5f;
+		const Vector2 currentSize = Lerp(m_startSize, m_endSize, interpolationFactor);
+		const Vector4 particleColor = Lerp(m_startColor, m_endColor, interpolationFactor);
 
-		float currentEmitRadius = Lerp(m_coneMinRadius, m_coneMaxRadius, interpolationFactor);
-		Vector2 currentSize = Lerp(m_startSize, m_endSize, interpolationFactor);
-		Vector4 particleColor = Lerp(m_startColor, m_endColor, interpolationFactor);
-		Vector3 randomVelocity = ComputeRandomVelocity(currentEmitRadius, m_coneMinAngle, m_coneMaxAngle);
+		const XMVECTOR minAngle = XMVectorReplicate(m_coneMinAngle);
+		const XMVECTOR angleRange = XMVectorReplicate(m_coneMaxAngle - m_coneMinAngle);
+		const XMVECTOR minRadius = XMVectorReplicate(m_coneMinRadius);
+		const XMVECTOR radiusRange = XMVectorReplicate(m_coneMaxRadius - m_coneMinRadius);
 
-		return { Vector3(), Vector3::Transform(randomVelocity, m_particleRotation), particleColor, currentSize, 0.0f, m_particleLifetime };
+		for (uint32_t batchStart = 0; batchStart < emittedRange.m_count; batchStart += g_emitBatchSize)
+		{
+			const uint32_t batchCount = eastl::min(emittedRange.m_count - batchStart, g_emitBatchSize);
+			const uint32_t laneCount = (batchCount + 3) & ~3u;
+
+			// The angles, then the radii
+			float randomValues[g_emitBatchSize * 2];
+			inOutRandom.GenerateFloats(randomValues, laneCount * 2);
+
+			// Each particle leaves at a random angle around the cone and a random speed, within the emitter's ranges
+			float velocitiesX[g_emitBatchSize];
+			float velocitiesY[g_emitBatchSize];
+
+			for (uint32_t i = 0; i < laneCount; i += 4)
+			{
+				const XMVECTOR angles = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&randomValues[i])), angleRange, minAngle);
+				const XMVECTOR radii = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&randomValues[laneCount + i])), radiusRange, minRadius);
+
+				XMVECTOR sines;
+				XMVECTOR cosines;
+				XMVectorSinCos(&sines, &cosines, angles);
+
+				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&velocitiesX[i]), XMVectorMultiply(radii, cosines));
+				XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&velocitiesY[i]), XMVectorMultiply(radii, sines));
+			}
+
+			for (uint32_t i = 0; i < batchCount; ++i)
+			{
+				const uint32_t particleIndex = batchStart + i;
+
+				emittedRange.m_initialPositions[particleIndex] = Vector3::Zero;
+				emittedRange.m_initialVelocities[particleIndex] = Vector3::Transform(Vector3(velocitiesX[i], velocitiesY[i], 0.0f), m_particleRotation);
+				emittedRange.m_colors[particleIndex] = particleColor;
+				emittedRange.m_sizes[particleIndex] = currentSize;
+				emittedRange.m_ages[particleIndex] = 0.0f;
+				emittedRange.m_durations[particleIndex] = m_particleLifetime;
+			}
+		}
 	}
 }
-
@@ -4,11 +4,20 @@
 #include "Rendering/Renderer.h"
 #include "Rendering/GraphicsDriver.h"
 
+#include "Misc/JobSystem.h"
 #include "Misc/utf8conv.h"
 #include "Misc/Remotery.h"
 
+#include <EASTL/algorithm.h>
+
 namespace MAD
 {
+	namespace
+	{
+		// Systems simulated by one job. A full system is a few thousand particles, so a handful is already worth a thread
+		const uint32_t g_systemsPerJob = 4;
+	}
+
 	UParticleSystemManager::UParticleSystemManager() : m_firstInactiveParticleSystem(0)
 	{
 	}
@@ -25,13 +34,15 @@ namespace MAD
 	{
 		rmt_ScopedCPUSample(UParticleSystemManager_UpdateParticleSystems, 0);
 
+		SimulateParticleSystems(inDeltaTime);
+
 		GPU_EVENT_START(&URenderContext::Get().GetGraphicsDriver(), Particles);
 
 		for (size_t i = 0; i < m_firstInactiveParticleSystem; ++i)
 		{
 			GPU_EVENT_START_STR(&URenderContext::Get().GetGraphicsDriver(), Particle_System, utf8util::UTF16FromUTF8(m_particleSystemPool[i].GetSystemName().c_str()));
 
-			m_particleSystemPool[i].TickSystem(inDeltaTime);
+			m_particleSystemPool[i].DrawParticles();
 
 			GPU_EVENT_END(&URenderContext::Get().GetGraphicsDriver());
 		}
@@ -39,6 +50,33 @@ namespace MAD
 		GPU_EVENT_END(&URenderContext::Get().GetGraphicsDriver());
 	}
 
+	void UParticleSystemManager::SimulateParticleSystems(float inDeltaTime)
+	{
+		rmt_ScopedCPUSample(UParticleSystemManager_SimulateParticleSystems, 0);
+
+		const uint32_t systemCount = static_cast<uint32_t>(m_firstInactiveParticleSystem);
+		const uint32_t jobCount = eastl::min((systemCount + g_systemsPerJob - 1) / g_systemsPerJob, UJobSystem::GetThreadCount());
+
+		// Each job takes every jobCount-th system, so that systems activated together (and usually similarly busy) get spread out.
+		// Captures no more than the job function stores in place, so that kicking the jobs doesn't allocate
+		const auto simulateSystems = [this, inDeltaTime, jobCount](uint32_t inJobIndex)
+		{
+			for (size_t i = inJobIndex; i < m_firstInactiveParticleSystem; i += jobCount)
+			{
+				m_particleSystemPool[i].SimulateSystem(inDeltaTime);
+			}
+		};
+
+		if (jobCount > 1)
+		{
+			UJobSystem::ParallelFor(jobCount, simulateSystems);
+		}
+		else if (jobCount == 1)
+		{
+			simulateSystems(0);
+		}
+	}
+
 	UParticleSystem* UParticleSystemManager::ActivateParticleSystem(const SParticleSystemSpawnParams& inSystemParams, const eastl::vector<SParticleEmitterSpawnParams>& inEmitterParams)
 	{
 		if (m_firstInactiveParticleSystem == UParticleSystemManager::s_maxParticleSystems)
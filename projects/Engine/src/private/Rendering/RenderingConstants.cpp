@@ -6,6 +6,14 @@ namespace MAD
 	{
 		const uint32_t DynamicEnvironmentMapRes = 512;
 		const uint32_t ShadowMapRes = 512;
+
+		const uint32_t ShadowCascadeRes = 1024;
+		const float ShadowCascadeDistance = 5000.0f;
+		const float ShadowCascadeSplitLambda = 0.75f;
+
+		const float MeshLODScreenSizes[MaxMeshLODs - 1] = { 0.25f, 0.1f, 0.04f };
+		const float MeshLODHysteresis = 0.1f;
+		const UINT ShadowLODBias = 1;
 	}
 
 	namespace ShaderPaths
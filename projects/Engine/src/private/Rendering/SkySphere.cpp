@@ -36,7 +36,8 @@ namespace MAD
 		// Bind the vertex buffer
 		m_skyboxMesh->m_gpuPositions.Bind(graphicsDriver, 0);
 		
-		graphicsDriver.SetIndexBuffer(m_skyboxMesh->m_gpuIndexBuffer, 0);
+		const SSubMesh& skyboxSubMesh = m_skyboxMesh->m_subMeshes[0];
+		graphicsDriver.SetIndexBuffer(m_skyboxMesh->m_gpuIndexBuffer, skyboxSubMesh.m_lods[0].m_indexStart, skyboxSubMesh.m_indexSize);
 
 		// Set the light accumulation buffer as render target since we dont want that the skybox to be lit (remember to unbind the depth buffer as input incase previous steps needed it as a SRV)
 		graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::DepthBuffer);
@@ -54,7 +55,7 @@ namespace MAD
 
 		graphicsDriver.SetPixelShaderResource(m_boxCubeMapSRV, ETextureSlot::CubeMap);
 
-		graphicsDriver.DrawIndexed(static_cast<UINT>(m_skyboxMesh->m_indexBuffer.size()), 0, 0);
+		graphicsDriver.DrawIndexed(skyboxSubMesh.m_lods[0].m_indexCount, 0, 0);
 
 		GPU_EVENT_END(&graphicsDriver);
 	}
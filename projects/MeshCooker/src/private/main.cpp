@@ -0,0 +1,286 @@
+#ifndef WIN32_LEAN_AND_MEAN
+	#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <objbase.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/string.h>
+#include <EASTL/utility.h>
+#include <EASTL/vector.h>
+
+#include "Core/Pipeline/WorldCooker.h"
+#include "Rendering/MeshCooker.h"
+#include "Rendering/TextureCooker.h"
+
+/*
+ * Offline mesh and world cook step. Usage:
+ *
+ *   MeshCooker [-force] <mesh, world or directory> ...
+ *
+ * Directories are searched recursively for source meshes, and for world JSON files inside any "worlds" directory.
+ * The textures referenced by each mesh's materials are cooked to block compressed DDS files along with it.
+ * Assets whose cooked file is already up to date are skipped unless -force is given. Reports the vertex cache efficiency
+ * (ACMR) of each cooked mesh before and after optimization, and the triangle count of each of its LODs.
+ * Returns non-zero if any asset failed to cook.
+ */
+
+namespace
+{
+	const char* g_sourceMeshExtensions[] = { ".obj", ".fbx", ".dae", ".3ds", ".blend" };
+
+	eastl::string GetLowerExtension(const eastl::string& inFilePath)
+	{
+		const size_t extensionStart = inFilePath.find_last_of('.');
+		if (extensionStart == eastl::string::npos)
+		{
+			return eastl::string();
+		}
+
+		eastl::string extension = inFilePath.substr(extensionStart);
+		extension.make_lower();
+		return extension;
+	}
+
+	bool IsSourceMesh(const eastl::string& inFilePath)
+	{
+		const eastl::string extension = GetLowerExtension(inFilePath);
+
+		for (const char* currentExtension : g_sourceMeshExtensions)
+		{
+			if (extension == currentExtension)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool IsSourceWorld(const eastl::string& inFilePath)
+	{
+		return GetLowerExtension(inFilePath) == ".json";
+	}
+
+	// Everything but the mesh filename, material texture paths are relative to it
+	eastl::string GetMeshDirectory(const eastl::string& inMeshPath)
+	{
+		return inMeshPath.substr(0, inMeshPath.find_last_of("\\/") + 1);
+	}
+
+	// Adds each texture referenced by the cooked mesh's materials once, with the usage of the first slot it's found in
+	void GatherMeshTextures(const eastl::string& inMeshPath, eastl::vector<eastl::pair<eastl::string, MAD::ETextureUsage>>& inOutTextures)
+	{
+		MAD::SMeshData meshData;
+		if (!MAD::UMeshCooker::LoadCookedMesh(inMeshPath, meshData))
+		{
+			return;
+		}
+
+		const eastl::string meshDirectory = GetMeshDirectory(inMeshPath);
+
+		for (const auto& currentMaterial : meshData.m_materials)
+		{
+			const eastl::pair<const eastl::string*, MAD::ETextureUsage> materialTextures[] =
+			{
+				{ &currentMaterial.m_diffuseTex, MAD::ETextureUsage::Color },
+				{ &currentMaterial.m_specularTex, MAD::ETextureUsage::Color },
+				{ &currentMaterial.m_emissiveTex, MAD::ETextureUsage::Color },
+				{ &currentMaterial.m_normalMap, MAD::ETextureUsage::NormalMap },
+				{ &currentMaterial.m_opacityMask, MAD::ETextureUsage::Mask },
+			};
+
+			for (const auto& currentTexture : materialTextures)
+			{
+				if (currentTexture.first->empty())
+				{
+					continue;
+				}
+
+				const eastl::string texturePath = meshDirectory + *currentTexture.first;
+
+				auto existingTexture = eastl::find_if(inOutTextures.begin(), inOutTextures.end(), [&texturePath](const eastl::pair<eastl::string, MAD::ETextureUsage>& inTexture)
+				{
+					return inTexture.first == texturePath;
+				});
+
+				if (existingTexture == inOutTextures.end())
+				{
+					inOutTextures.emplace_back(texturePath, currentTexture.second);
+				}
+			}
+		}
+	}
+
+	bool IsWorldDirectory(const char* inDirectoryName)
+	{
+		return _stricmp(inDirectoryName, "worlds") == 0;
+	}
+
+	// Other JSON assets (fonts and so on) live next to meshes, so only JSON under a "worlds" directory is a world
+	void GatherSourceAssets(const eastl::string& inDirectory, bool inIsWorldDirectory, eastl::vector<eastl::string>& inOutSourceMeshes, eastl::vector<eastl::string>& inOutSourceWorlds)
+	{
+		WIN32_FIND_DATAA findData;
+		HANDLE findHandle = FindFirstFileA((inDirectory + "\\*").c_str(), &findData);
+		if (findHandle == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		do
+		{
+			if (strcmp(findData.cFileName, ".") == 0 || strcmp(findData.cFileName, "..") == 0)
+			{
+				continue;
+			}
+
+			const eastl::string childPath = inDirectory + "\\" + findData.cFileName;
+
+			if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				GatherSourceAssets(childPath, inIsWorldDirectory || IsWorldDirectory(findData.cFileName), inOutSourceMeshes, inOutSourceWorlds);
+			}
+			else if (IsSourceMesh(childPath))
+			{
+				inOutSourceMeshes.push_back(childPath);
+			}
+			else if (inIsWorldDirectory && IsSourceWorld(childPath))
+			{
+				inOutSourceWorlds.push_back(childPath);
+			}
+		} while (FindNextFileA(findHandle, &findData));
+
+		FindClose(findHandle);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bool forceCook = false;
+	eastl::vector<eastl::string> sourceMeshes;
+	eastl::vector<eastl::string> sourceWorlds;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-force") == 0)
+		{
+			forceCook = true;
+			continue;
+		}
+
+		const DWORD pathAttributes = GetFileAttributesA(argv[i]);
+		if (pathAttributes == INVALID_FILE_ATTRIBUTES)
+		{
+			printf("Skipping '%s', it doesn't exist\n", argv[i]);
+		}
+		else if (pathAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			GatherSourceAssets(argv[i], false, sourceMeshes, sourceWorlds);
+		}
+		else if (IsSourceWorld(argv[i]))
+		{
+			sourceWorlds.push_back(argv[i]);
+		}
+		else
+		{
+			sourceMeshes.push_back(argv[i]);
+		}
+	}
+
+	if (sourceMeshes.empty() && sourceWorlds.empty())
+	{
+		printf("Usage: MeshCooker [-force] <mesh, world or directory> ...\n");
+		return 1;
+	}
+
+	// Texture decoding goes through WIC
+	CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+	int failedCount = 0;
+	int skippedCount = 0;
+	eastl::vector<eastl::pair<eastl::string, MAD::ETextureUsage>> sourceTextures;
+
+	for (const auto& currentMesh : sourceMeshes)
+	{
+		if (!forceCook && MAD::UMeshCooker::IsCookedMeshUpToDate(currentMesh))
+		{
+			GatherMeshTextures(currentMesh, sourceTextures);
+			++skippedCount;
+			continue;
+		}
+
+		printf("Cooking '%s'\n", currentMesh.c_str());
+
+		MAD::SMeshOptimizationStats optimizationStats;
+		if (!MAD::UMeshCooker::CookMesh(currentMesh, &optimizationStats))
+		{
+			printf("\tFailed to cook '%s'\n", currentMesh.c_str());
+			++failedCount;
+			continue;
+		}
+
+		printf("\t%u triangles, ACMR %.3f -> %.3f\n", optimizationStats.m_triangleCount, optimizationStats.m_sourceACMR, optimizationStats.m_optimizedACMR);
+
+		printf("\tLOD triangles:");
+		for (uint32_t lodTriangleCount : optimizationStats.m_lodTriangleCounts)
+		{
+			printf(" %u", lodTriangleCount);
+		}
+		printf("\n");
+
+		GatherMeshTextures(currentMesh, sourceTextures);
+	}
+
+	printf("Cooked %d mesh(es), %d up to date, %d failed\n", static_cast<int>(sourceMeshes.size()) - skippedCount - failedCount, skippedCount, failedCount);
+
+	int failedTextureCount = 0;
+	int skippedTextureCount = 0;
+
+	for (const auto& currentTexture : sourceTextures)
+	{
+		if (!forceCook && MAD::UTextureCooker::IsCookedTextureUpToDate(currentTexture.first))
+		{
+			++skippedTextureCount;
+			continue;
+		}
+
+		printf("Cooking '%s'\n", currentTexture.first.c_str());
+
+		if (!MAD::UTextureCooker::CookTexture(currentTexture.first, currentTexture.second))
+		{
+			printf("\tFailed to cook '%s'\n", currentTexture.first.c_str());
+			++failedTextureCount;
+		}
+	}
+
+	printf("Cooked %d texture(s), %d up to date, %d failed\n", static_cast<int>(sourceTextures.size()) - skippedTextureCount - failedTextureCount, skippedTextureCount, failedTextureCount);
+
+	int failedWorldCount = 0;
+	int skippedWorldCount = 0;
+
+	for (const auto& currentWorld : sourceWorlds)
+	{
+		if (!forceCook && MAD::UWorldCooker::IsCookedWorldUpToDate(currentWorld))
+		{
+			++skippedWorldCount;
+			continue;
+		}
+
+		printf("Cooking '%s'\n", currentWorld.c_str());
+
+		if (!MAD::UWorldCooker::CookWorld(currentWorld))
+		{
+			printf("\tFailed to cook '%s'\n", currentWorld.c_str());
+			++failedWorldCount;
+		}
+	}
+
+	printf("Cooked %d world(s), %d up to date, %d failed\n", static_cast<int>(sourceWorlds.size()) - skippedWorldCount - failedWorldCount, skippedWorldCount, failedWorldCount);
+
+	CoUninitialize();
+
+	return failedCount > 0 || failedTextureCount > 0 || failedWorldCount > 0 ? 1 : 0;
+}
@@ -0,0 +1,241 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/vector.h>
+
+#include "Core/FrameTimer.h"
+#include "Misc/JobSystem.h"
+#include "Misc/RandomStream.h"
+#include "Rendering/ParticleSystem/ParticlePool.h"
+#include "Rendering/ParticleSystem/ParticleSystemManager.h"
+
+/*
+ * Headless benchmark of the CPU side of the particle systems. Usage:
+ *
+ *   ParticleBenchmark [-ticks <count>] [-workers <count>]
+ *
+ * Simulates as many systems as the particle system manager can hold, each one kept full at 4096 particles, first on the
+ * calling thread only and then spread over the job system the way the manager does it. Lifetimes are scattered so that
+ * every tick kills particles all over each pool, and each system is topped back up to full right after, like emitters
+ * running flat out. Also times copying the live ranges out, which is all the vertex buffer update does on the CPU.
+ *
+ * No graphics device is created. Returns non-zero if the two runs didn't end up with the same particles.
+ */
+
+namespace
+{
+	const uint32_t g_systemCount = static_cast<uint32_t>(MAD::UParticleSystemManager::s_maxParticleSystems);
+	const uint32_t g_defaultTickCount = 300;
+	const float g_deltaTime = 1.0f / 60.0f;
+	const float g_minLifetime = 0.5f;
+	const float g_maxLifetime = 2.0f;
+	const uint32_t g_fillBatchSize = 64;
+
+	struct SBenchmarkSystem
+	{
+		MAD::UParticlePool m_pool;
+		MAD::URandomStream m_randomStream;
+	};
+
+	// Stand-in for the vertex buffers, one stream per pool attribute
+	struct SUploadStreams
+	{
+		SUploadStreams()
+			: m_initialPositions(MAD::UParticlePool::s_maxNumParticles)
+			, m_initialVelocities(MAD::UParticlePool::s_maxNumParticles)
+			, m_colors(MAD::UParticlePool::s_maxNumParticles)
+			, m_sizes(MAD::UParticlePool::s_maxNumParticles)
+			, m_ages(MAD::UParticlePool::s_maxNumParticles) {}
+
+		eastl::vector<MAD::Vector3> m_initialPositions;
+		eastl::vector<MAD::Vector3> m_initialVelocities;
+		eastl::vector<MAD::Vector4> m_colors;
+		eastl::vector<MAD::Vector2> m_sizes;
+		eastl::vector<float> m_ages;
+	};
+
+	// Tops the pool back up to full through a reserved range, the way emitters write into it
+	void FillSystem(SBenchmarkSystem& inOutSystem, bool inIsStaggered)
+	{
+		const MAD::SParticlePoolRange filledRange = inOutSystem.m_pool.ReserveParticles(MAD::UParticlePool::s_maxNumParticles);
+
+		for (uint32_t batchStart = 0; batchStart < filledRange.m_count; batchStart += g_fillBatchSize)
+		{
+			const uint32_t batchCount = eastl::min(filledRange.m_count - batchStart, g_fillBatchSize);
+
+			// The lifetimes, then how far into them the particles start
+			float randomValues[g_fillBatchSize * 2];
+			inOutSystem.m_randomStream.GenerateFloats(randomValues, g_fillBatchSize * 2);
+
+			for (uint32_t i = 0; i < batchCount; ++i)
+			{
+				const uint32_t particleIndex = batchStart + i;
+				const float lifetime = g_minLifetime + (g_maxLifetime - g_minLifetime) * randomValues[i];
+
+				filledRange.m_initialPositions[particleIndex] = MAD::Vector3::Zero;
+				filledRange.m_initialVelocities[particleIndex] = MAD::Vector3::Up;
+				filledRange.m_colors[particleIndex] = MAD::Vector4::One;
+				filledRange.m_sizes[particleIndex] = MAD::Vector2::One;
+				filledRange.m_durations[particleIndex] = lifetime;
+
+				// The first particles start part way through their lives, otherwise they'd all live on until the first one dies
+				filledRange.m_ages[particleIndex] = inIsStaggered ? lifetime * randomValues[g_fillBatchSize + i] : 0.0f;
+			}
+		}
+	}
+
+	void ResetSystems(eastl::vector<SBenchmarkSystem>& inOutSystems)
+	{
+		for (uint32_t i = 0; i < g_systemCount; ++i)
+		{
+			inOutSystems[i].m_pool.Clear();
+			inOutSystems[i].m_randomStream.Seed(i + 1);
+
+			FillSystem(inOutSystems[i], true);
+		}
+	}
+
+	void TickSystem(SBenchmarkSystem& inOutSystem)
+	{
+		inOutSystem.m_pool.AgeParticles(g_deltaTime);
+		FillSystem(inOutSystem, false);
+	}
+
+	void UploadSystem(const MAD::UParticlePool& inPool, SUploadStreams& outStreams)
+	{
+		const uint32_t particleCount = inPool.GetParticleCount();
+
+		memcpy(outStreams.m_initialPositions.data(), inPool.GetInitialPositions(), particleCount * sizeof(MAD::Vector3));
+		memcpy(outStreams.m_initialVelocities.data(), inPool.GetInitialVelocities(), particleCount * sizeof(MAD::Vector3));
+		memcpy(outStreams.m_colors.data(), inPool.GetColors(), particleCount * sizeof(MAD::Vector4));
+		memcpy(outStreams.m_sizes.data(), inPool.GetSizes(), particleCount * sizeof(MAD::Vector2));
+		memcpy(outStreams.m_ages.data(), inPool.GetAges(), particleCount * sizeof(float));
+	}
+
+	// Sum of every live particle's age, to check that both runs simulated the same thing
+	double SumParticleAges(const eastl::vector<SBenchmarkSystem>& inSystems)
+	{
+		double ageSum = 0.0;
+
+		for (const auto& currentSystem : inSystems)
+		{
+			const float* ages = currentSystem.m_pool.GetAges();
+
+			for (uint32_t i = 0; i < currentSystem.m_pool.GetParticleCount(); ++i)
+			{
+				ageSum += ages[i];
+			}
+		}
+
+		return ageSum;
+	}
+
+	// Returns the average simulation time of a tick, in seconds
+	double RunTicks(eastl::vector<SBenchmarkSystem>& inOutSystems, uint32_t inTickCount, bool inIsParallel, SUploadStreams& outStreams, double& outUploadSeconds)
+	{
+		const uint32_t jobCount = inIsParallel ? MAD::UJobSystem::GetThreadCount() : 1;
+		MAD::UFrameTimer tickTimer;
+		double simulateSeconds = 0.0;
+
+		outUploadSeconds = 0.0;
+
+		for (uint32_t tick = 0; tick < inTickCount; ++tick)
+		{
+			tickTimer.Start();
+
+			if (jobCount > 1)
+			{
+				// Strided over the jobs like UParticleSystemManager does it
+				MAD::UJobSystem::ParallelFor(jobCount, [&inOutSystems, jobCount](uint32_t inJobIndex)
+				{
+					for (uint32_t i = inJobIndex; i < g_systemCount; i += jobCount)
+					{
+						TickSystem(inOutSystems[i]);
+					}
+				});
+			}
+			else
+			{
+				for (auto& currentSystem : inOutSystems)
+				{
+					TickSystem(currentSystem);
+				}
+			}
+
+			simulateSeconds += tickTimer.TimeSinceCheckpoint();
+			tickTimer.Checkpoint();
+
+			for (const auto& currentSystem : inOutSystems)
+			{
+				UploadSystem(currentSystem.m_pool, outStreams);
+			}
+
+			outUploadSeconds += tickTimer.TimeSinceCheckpoint();
+		}
+
+		outUploadSeconds /= inTickCount;
+		return simulateSeconds / inTickCount;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t tickCount = g_defaultTickCount;
+	uint32_t workerCount = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-ticks") == 0 && i + 1 < argc)
+		{
+			tickCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-workers") == 0 && i + 1 < argc)
+		{
+			workerCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			printf("Usage: ParticleBenchmark [-ticks <count>] [-workers <count>]\n");
+			return 1;
+		}
+	}
+
+	if (tickCount == 0)
+	{
+		tickCount = g_defaultTickCount;
+	}
+
+	MAD::UJobSystem::Init(workerCount);
+
+	eastl::vector<SBenchmarkSystem> benchmarkSystems(g_systemCount);
+	SUploadStreams uploadStreams;
+
+	printf("%u systems x %u particles, %u ticks\n", g_systemCount, MAD::UParticlePool::s_maxNumParticles, tickCount);
+
+	double serialUploadSeconds;
+	ResetSystems(benchmarkSystems);
+	const double serialSeconds = RunTicks(benchmarkSystems, tickCount, false, uploadStreams, serialUploadSeconds);
+	const double serialAgeSum = SumParticleAges(benchmarkSystems);
+
+	double parallelUploadSeconds;
+	ResetSystems(benchmarkSystems);
+	const double parallelSeconds = RunTicks(benchmarkSystems, tickCount, true, uploadStreams, parallelUploadSeconds);
+	const double parallelAgeSum = SumParticleAges(benchmarkSystems);
+
+	const double particlesPerTick = static_cast<double>(g_systemCount) * MAD::UParticlePool::s_maxNumParticles;
+
+	printf("1 thread:   %.3f ms/tick simulating (%.1f M particles/s), %.3f ms/tick uploading\n", serialSeconds * 1000.0, particlesPerTick / serialSeconds / 1000000.0, serialUploadSeconds * 1000.0);
+	printf("%u threads: %.3f ms/tick simulating (%.1f M particles/s), %.2fx speedup\n", MAD::UJobSystem::GetThreadCount(), parallelSeconds * 1000.0, particlesPerTick / parallelSeconds / 1000000.0, serialSeconds / parallelSeconds);
+
+	MAD::UJobSystem::Shutdown();
+
+	if (serialAgeSum != parallelAgeSum)
+	{
+		printf("The parallel run ended up with different particles than the serial one (age sums %f and %f)\n", serialAgeSum, parallelAgeSum);
+		return 1;
+	}
+
+	return 0;
+}
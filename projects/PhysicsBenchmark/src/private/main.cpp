@@ -0,0 +1,325 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+#include <EASTL/vector.h>
+
+#include "Core/DynamicAABBTree.h"
+#include "Core/FrameTimer.h"
+#include "Misc/JobSystem.h"
+#include "Misc/RandomStream.h"
+
+/*
+ * Headless benchmark of the physics broadphase. Usage:
+ *
+ *   PhysicsBenchmark [-ticks <count>] [-maxbodies <count>] [-workers <count>]
+ *
+ * Runs a UDynamicAABBTree the way UPhysicsWorld drives it every fixed step, at 1000 bodies and then twice as many each
+ * run until -maxbodies. Every body is a box that flies around a room sized so that the bodies are as crowded at every
+ * count. Each tick moves all of their proxies, then rebuilds the pairs of the proxies that left their fat boxes over the
+ * job system and sorts the pair list, like UPhysicsWorld::UpdateBroadphase and UpdateOverlapPairs. The rest of the world
+ * needs bodies spawned through the engine, so it isn't run here.
+ *
+ * No engine or graphics device is created. Returns non-zero if the pair list doesn't match a brute force test of every
+ * pair of fat boxes after the last tick of a run.
+ */
+
+namespace
+{
+	const uint32_t g_minBodyCount = 1000;
+	const uint32_t g_defaultMaxBodyCount = 16000;
+	const uint32_t g_defaultTickCount = 300;
+	const float g_deltaTime = 1.0f / 60.0f;
+
+	// Same as UPhysicsWorld's
+	const float g_broadphaseMargin = 10.0f;
+	const uint32_t g_dirtyProxiesPerJob = 128;
+
+	const float g_bodyHalfExtent = 50.0f;
+	const float g_roomSizePerBody = 400.0f; // Cube root of the room's volume per body
+	const float g_maxSpeed = 300.0f;
+
+	struct SBroadphasePair
+	{
+		int32_t m_proxyA;
+		int32_t m_proxyB;
+
+		bool operator==(const SBroadphasePair& inOther) const { return m_proxyA == inOther.m_proxyA && m_proxyB == inOther.m_proxyB; }
+		bool operator<(const SBroadphasePair& inOther) const { return m_proxyA < inOther.m_proxyA || (m_proxyA == inOther.m_proxyA && m_proxyB < inOther.m_proxyB); }
+	};
+
+	struct SBenchmarkWorld
+	{
+		MAD::UDynamicAABBTree m_broadphase;
+		eastl::vector<MAD::Vector3> m_positions;
+		eastl::vector<MAD::Vector3> m_velocities;
+		eastl::vector<int32_t> m_proxyIDs;
+		float m_roomSize;
+
+		eastl::vector<int32_t> m_dirtyProxies;
+		eastl::vector<uint8_t> m_isProxyDirty;
+		eastl::vector<eastl::vector<SBroadphasePair>> m_threadPairs;
+		eastl::vector<SBroadphasePair> m_overlapPairs;
+	};
+
+	struct SRunResult
+	{
+		double m_moveSeconds;
+		double m_pairSeconds;
+		double m_dirtyProxies; // Per tick
+		size_t m_pairCount;
+		int32_t m_treeHeight;
+		bool m_arePairsCorrect;
+	};
+
+	MAD::SAABB GetBodyBounds(const MAD::Vector3& inPosition)
+	{
+		const MAD::Vector3 halfExtents(g_bodyHalfExtent, g_bodyHalfExtent, g_bodyHalfExtent);
+		return MAD::SAABB(inPosition - halfExtents, inPosition + halfExtents);
+	}
+
+	void MarkProxyDirty(SBenchmarkWorld& inOutWorld, int32_t inProxyID)
+	{
+		if (static_cast<uint32_t>(inProxyID) >= inOutWorld.m_isProxyDirty.size())
+		{
+			inOutWorld.m_isProxyDirty.resize(inProxyID + 1, 0);
+		}
+
+		if (!inOutWorld.m_isProxyDirty[inProxyID])
+		{
+			inOutWorld.m_isProxyDirty[inProxyID] = 1;
+			inOutWorld.m_dirtyProxies.push_back(inProxyID);
+		}
+	}
+
+	void CreateWorld(SBenchmarkWorld& outWorld, uint32_t inBodyCount)
+	{
+		MAD::URandomStream randomStream(inBodyCount);
+
+		outWorld.m_roomSize = g_roomSizePerBody * cbrtf(static_cast<float>(inBodyCount));
+		outWorld.m_threadPairs.resize(MAD::UJobSystem::GetThreadCount());
+
+		for (uint32_t i = 0; i < inBodyCount; ++i)
+		{
+			// The position, then the velocity. The last value of each four is unused
+			float randomValues[8];
+			randomStream.GenerateFloats(randomValues, 8);
+
+			const MAD::Vector3 position(randomValues[0] * outWorld.m_roomSize, randomValues[1] * outWorld.m_roomSize, randomValues[2] * outWorld.m_roomSize);
+			const MAD::Vector3 velocity((randomValues[4] * 2.0f - 1.0f) * g_maxSpeed, (randomValues[5] * 2.0f - 1.0f) * g_maxSpeed, (randomValues[6] * 2.0f - 1.0f) * g_maxSpeed);
+
+			outWorld.m_positions.push_back(position);
+			outWorld.m_velocities.push_back(velocity);
+			outWorld.m_proxyIDs.push_back(outWorld.m_broadphase.CreateProxy(GetBodyBounds(position), g_broadphaseMargin, i));
+
+			MarkProxyDirty(outWorld, outWorld.m_proxyIDs.back());
+		}
+	}
+
+	// Integrates the bodies, bouncing them off the walls, and moves their proxies
+	void MoveBodies(SBenchmarkWorld& inOutWorld)
+	{
+		for (uint32_t i = 0; i < inOutWorld.m_positions.size(); ++i)
+		{
+			MAD::Vector3& position = inOutWorld.m_positions[i];
+			MAD::Vector3& velocity = inOutWorld.m_velocities[i];
+
+			position += velocity * g_deltaTime;
+
+			float* positionAxes = &position.x;
+			float* velocityAxes = &velocity.x;
+
+			for (uint32_t axis = 0; axis < 3; ++axis)
+			{
+				if ((positionAxes[axis] < 0.0f && velocityAxes[axis] < 0.0f) || (positionAxes[axis] > inOutWorld.m_roomSize && velocityAxes[axis] > 0.0f))
+				{
+					velocityAxes[axis] = -velocityAxes[axis];
+				}
+			}
+
+			if (inOutWorld.m_broadphase.MoveProxy(inOutWorld.m_proxyIDs[i], GetBodyBounds(position), g_broadphaseMargin, velocity * g_deltaTime))
+			{
+				MarkProxyDirty(inOutWorld, inOutWorld.m_proxyIDs[i]);
+			}
+		}
+	}
+
+	// Replaces the pairs of the dirty proxies, the pairs of the others can't have changed
+	void UpdateOverlapPairs(SBenchmarkWorld& inOutWorld)
+	{
+		inOutWorld.m_overlapPairs.erase(eastl::remove_if(inOutWorld.m_overlapPairs.begin(), inOutWorld.m_overlapPairs.end(), [&inOutWorld](const SBroadphasePair& inPair)
+		{
+			return inOutWorld.m_isProxyDirty[inPair.m_proxyA] || inOutWorld.m_isProxyDirty[inPair.m_proxyB];
+		}), inOutWorld.m_overlapPairs.end());
+
+		const uint32_t dirtyProxyCount = static_cast<uint32_t>(inOutWorld.m_dirtyProxies.size());
+		const uint32_t jobCount = eastl::min((dirtyProxyCount + g_dirtyProxiesPerJob - 1) / g_dirtyProxiesPerJob, MAD::UJobSystem::GetThreadCount());
+
+		const auto queryDirtyProxies = [&inOutWorld, dirtyProxyCount, jobCount](uint32_t inJobIndex)
+		{
+			eastl::vector<SBroadphasePair>& outPairs = inOutWorld.m_threadPairs[MAD::UJobSystem::GetCurrentThreadIndex()];
+
+			for (uint32_t i = inJobIndex; i < dirtyProxyCount; i += jobCount)
+			{
+				const int32_t dirtyProxyID = inOutWorld.m_dirtyProxies[i];
+
+				inOutWorld.m_broadphase.Query(inOutWorld.m_broadphase.GetFatBounds(dirtyProxyID), [&inOutWorld, dirtyProxyID, &outPairs](int32_t inOtherProxyID)
+				{
+					// When both proxies are dirty, only the lower one adds the pair
+					if (inOtherProxyID != dirtyProxyID && (!inOutWorld.m_isProxyDirty[inOtherProxyID] || dirtyProxyID < inOtherProxyID))
+					{
+						outPairs.push_back({ eastl::min(dirtyProxyID, inOtherProxyID), eastl::max(dirtyProxyID, inOtherProxyID) });
+					}
+
+					return true;
+				});
+			}
+		};
+
+		if (jobCount > 1)
+		{
+			MAD::UJobSystem::ParallelFor(jobCount, queryDirtyProxies);
+		}
+		else if (jobCount == 1)
+		{
+			queryDirtyProxies(0);
+		}
+
+		for (auto& currentThreadPairs : inOutWorld.m_threadPairs)
+		{
+			inOutWorld.m_overlapPairs.insert(inOutWorld.m_overlapPairs.end(), currentThreadPairs.begin(), currentThreadPairs.end());
+			currentThreadPairs.clear();
+		}
+
+		eastl::sort(inOutWorld.m_overlapPairs.begin(), inOutWorld.m_overlapPairs.end());
+
+		for (int32_t currentProxyID : inOutWorld.m_dirtyProxies)
+		{
+			inOutWorld.m_isProxyDirty[currentProxyID] = 0;
+		}
+
+		inOutWorld.m_dirtyProxies.clear();
+	}
+
+	bool ArePairsCorrect(const SBenchmarkWorld& inWorld)
+	{
+		eastl::vector<SBroadphasePair> expectedPairs;
+
+		for (uint32_t i = 0; i < inWorld.m_proxyIDs.size(); ++i)
+		{
+			const MAD::SAABB& fatBounds = inWorld.m_broadphase.GetFatBounds(inWorld.m_proxyIDs[i]);
+
+			for (uint32_t j = i + 1; j < inWorld.m_proxyIDs.size(); ++j)
+			{
+				if (fatBounds.Overlaps(inWorld.m_broadphase.GetFatBounds(inWorld.m_proxyIDs[j])))
+				{
+					expectedPairs.push_back({ eastl::min(inWorld.m_proxyIDs[i], inWorld.m_proxyIDs[j]), eastl::max(inWorld.m_proxyIDs[i], inWorld.m_proxyIDs[j]) });
+				}
+			}
+		}
+
+		eastl::sort(expectedPairs.begin(), expectedPairs.end());
+		return expectedPairs == inWorld.m_overlapPairs;
+	}
+
+	SRunResult RunBodyCount(uint32_t inBodyCount, uint32_t inTickCount)
+	{
+		SBenchmarkWorld benchmarkWorld;
+		CreateWorld(benchmarkWorld, inBodyCount);
+
+		// The first tick pairs up every body, which is what loading a level costs rather than a step
+		UpdateOverlapPairs(benchmarkWorld);
+
+		SRunResult runResult = {};
+		MAD::UFrameTimer tickTimer;
+		size_t dirtyProxyTotal = 0;
+
+		for (uint32_t tick = 0; tick < inTickCount; ++tick)
+		{
+			tickTimer.Start();
+
+			MoveBodies(benchmarkWorld);
+
+			runResult.m_moveSeconds += tickTimer.TimeSinceCheckpoint();
+			tickTimer.Checkpoint();
+
+			dirtyProxyTotal += benchmarkWorld.m_dirtyProxies.size();
+			UpdateOverlapPairs(benchmarkWorld);
+
+			runResult.m_pairSeconds += tickTimer.TimeSinceCheckpoint();
+		}
+
+		runResult.m_moveSeconds /= inTickCount;
+		runResult.m_pairSeconds /= inTickCount;
+		runResult.m_dirtyProxies = static_cast<double>(dirtyProxyTotal) / inTickCount;
+		runResult.m_pairCount = benchmarkWorld.m_overlapPairs.size();
+		runResult.m_treeHeight = benchmarkWorld.m_broadphase.GetHeight();
+		runResult.m_arePairsCorrect = ArePairsCorrect(benchmarkWorld);
+
+		return runResult;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t tickCount = g_defaultTickCount;
+	uint32_t maxBodyCount = g_defaultMaxBodyCount;
+	uint32_t workerCount = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-ticks") == 0 && i + 1 < argc)
+		{
+			tickCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-maxbodies") == 0 && i + 1 < argc)
+		{
+			maxBodyCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-workers") == 0 && i + 1 < argc)
+		{
+			workerCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			printf("Usage: PhysicsBenchmark [-ticks <count>] [-maxbodies <count>] [-workers <count>]\n");
+			return 1;
+		}
+	}
+
+	if (tickCount == 0)
+	{
+		tickCount = g_defaultTickCount;
+	}
+
+	MAD::UJobSystem::Init(workerCount);
+
+	printf("%u ticks per run, %u threads, %.1f ms per fixed step\n", tickCount, MAD::UJobSystem::GetThreadCount(), g_deltaTime * 1000.0f);
+
+	bool arePairsCorrect = true;
+
+	for (uint32_t bodyCount = g_minBodyCount; bodyCount <= eastl::max(maxBodyCount, g_minBodyCount); bodyCount *= 2)
+	{
+		const SRunResult runResult = RunBodyCount(bodyCount, tickCount);
+		const double tickSeconds = runResult.m_moveSeconds + runResult.m_pairSeconds;
+
+		printf("%6u bodies: %.3f ms/tick moving, %.3f ms/tick pairing (%.0f reinserted), %u pairs, tree height %d, %.1f%% of a step%s\n",
+			bodyCount, runResult.m_moveSeconds * 1000.0, runResult.m_pairSeconds * 1000.0, runResult.m_dirtyProxies, static_cast<uint32_t>(runResult.m_pairCount),
+			runResult.m_treeHeight, tickSeconds / g_deltaTime * 100.0, runResult.m_arePairsCorrect ? "" : ", WRONG PAIRS");
+
+		arePairsCorrect = arePairsCorrect && runResult.m_arePairsCorrect;
+	}
+
+	MAD::UJobSystem::Shutdown();
+
+	if (!arePairsCorrect)
+	{
+		printf("The broadphase pair list didn't match testing every pair of fat boxes\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,334 @@
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Misc/RandomStream.h"
+#include "Rendering/CameraInstance.h"
+#include "Rendering/RenderingCommon.h"
+#include "Rendering/RenderingConstants.h"
+#include "Rendering/ShadowCascades.h"
+
+/*
+ * Headless test of the CPU side of the directional shadow cascades. Usage:
+ *
+ *   ShadowCascadeTest [-cameras <count>]
+ *
+ * Fits the cascades of a default camera through UShadowCascades::FitCascades with the renderer's settings, for a few light
+ * directions and a number of random camera positions and orientations, and checks that:
+ *   - the split distances increase up to the shadow distance, and are the uniform and logarithmic splits at lambda 0 and 1
+ *   - the slices start at the near plane, each one starts where the previous one ends, and they end on those splits
+ *   - every corner of a slice is inside its cascade, in light space and through the cascade's view projection matrix
+ *   - a cascade's window is the same size however the camera is turned, and only ever moves by whole shadow map texels
+ *   - UShadowCascades::CanCastIntoCascade keeps the casters inside a cascade or between it and the light, and skips the
+ *     ones beside or behind it
+ *
+ * No engine or graphics device is created. Returns non-zero if any check fails.
+ */
+
+namespace
+{
+	const uint32_t g_cascadeCount = MAD::SPerDirectionalLightConstants::CascadeCount;
+	const uint32_t g_defaultCameraCount = 200;
+	const float g_aspectRatio = 16.0f / 9.0f;
+	const float g_maxCameraDistance = 2000.0f; // From the origin, along each axis
+	const float g_maxCameraPitch = MAD::ConvertToRadians(80.0f);
+	const float g_maxCameraNudge = 2.0f; // Small enough that the nudged camera's window usually stays in place
+
+	// Light space positions are a few thousand units from the origin, these are a few float ulps at that distance
+	const float g_positionTolerance = 0.01f;
+	const float g_ndcTolerance = 1.0e-4f;
+	const float g_texelTolerance = 1.0e-3f;
+
+	const MAD::Vector3 g_lightDirections[] =
+	{
+		MAD::Vector3(0.0f, -1.0f, 0.0f), // Straight down, which needs the other up vector
+		MAD::Vector3(0.5f, -1.0f, 0.25f),
+		MAD::Vector3(-1.0f, -0.2f, 0.6f),
+		MAD::Vector3(0.1f, 0.3f, -1.0f)
+	};
+
+	uint32_t g_checkCount = 0;
+	uint32_t g_failedCheckCount = 0;
+
+	void Check(bool inHasPassed, const char* inFailureFormat, ...)
+	{
+		++g_checkCount;
+
+		if (inHasPassed)
+		{
+			return;
+		}
+
+		++g_failedCheckCount;
+
+		va_list formatArgs;
+		va_start(formatArgs, inFailureFormat);
+		printf("FAILED: ");
+		vprintf(inFailureFormat, formatArgs);
+		printf("\n");
+		va_end(formatArgs);
+	}
+
+	bool IsNearlyEqual(float inA, float inB, float inTolerance)
+	{
+		return fabsf(inA - inB) <= inTolerance;
+	}
+
+	bool IsOnTexelGrid(float inValue, float inTexelSize)
+	{
+		const float texels = inValue / inTexelSize;
+		return IsNearlyEqual(texels, roundf(texels), g_texelTolerance);
+	}
+
+	struct STestCamera
+	{
+		MAD::SCameraInstance m_instance;
+		MAD::Matrix m_inverseViewMatrix;
+		MAD::Matrix m_projectionMatrix;
+		float m_shadowDistance;
+	};
+
+	STestCamera CreateCamera(const MAD::Vector3& inPosition, float inYaw, float inPitch)
+	{
+		STestCamera camera;
+
+		const MAD::Vector3 forward(cosf(inPitch) * sinf(inYaw), sinf(inPitch), -cosf(inPitch) * cosf(inYaw));
+
+		camera.m_inverseViewMatrix = MAD::Matrix::CreateLookAt(inPosition, inPosition + forward, MAD::Vector3::Up).Invert();
+		camera.m_projectionMatrix = MAD::Matrix::CreatePerspectiveFieldOfView(camera.m_instance.m_verticalFOV, g_aspectRatio, camera.m_instance.m_nearPlaneDistance, camera.m_instance.m_farPlaneDistance);
+		camera.m_shadowDistance = fminf(camera.m_instance.m_farPlaneDistance, MAD::RenderConstants::ShadowCascadeDistance);
+
+		return camera;
+	}
+
+	// With the same arguments as URenderer::FitDirectionalShadowCascades
+	void FitCascades(const MAD::Vector3& inLightDirection, const STestCamera& inCamera, MAD::SShadowCascade* outCascades)
+	{
+		MAD::UShadowCascades::FitCascades(inLightDirection,
+										  inCamera.m_inverseViewMatrix,
+										  inCamera.m_projectionMatrix,
+										  inCamera.m_instance.m_nearPlaneDistance,
+										  inCamera.m_shadowDistance,
+										  MAD::RenderConstants::ShadowCascadeSplitLambda,
+										  g_cascadeCount,
+										  MAD::RenderConstants::ShadowCascadeRes,
+										  MAD::RenderConstants::ShadowCascadeDistance,
+										  outCascades);
+	}
+
+	// Worked out from the camera's field of view rather than taken from the projection matrix like FitCascade does it
+	void GetSliceCorners(const STestCamera& inCamera, float inSliceNear, float inSliceFar, MAD::Vector3* outWSCorners)
+	{
+		const float tanHalfFovY = tanf(inCamera.m_instance.m_verticalFOV * 0.5f);
+		const float tanHalfFovX = tanHalfFovY * g_aspectRatio;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			const float distance = (i < 4) ? inSliceNear : inSliceFar;
+			const MAD::Vector3 vsCorner((i & 1) ? distance * tanHalfFovX : -distance * tanHalfFovX, (i & 2) ? distance * tanHalfFovY : -distance * tanHalfFovY, -distance);
+
+			outWSCorners[i] = MAD::Vector3::Transform(vsCorner, inCamera.m_inverseViewMatrix);
+		}
+	}
+
+	float GetTexelSize(const MAD::SShadowCascade& inCascade)
+	{
+		return (inCascade.m_lightSpaceMax.x - inCascade.m_lightSpaceMin.x) / MAD::RenderConstants::ShadowCascadeRes;
+	}
+
+	void TestSplitDistances()
+	{
+		const MAD::SCameraInstance cameraInstance;
+		const float nearPlane = cameraInstance.m_nearPlaneDistance;
+		const float shadowDistance = fminf(cameraInstance.m_farPlaneDistance, MAD::RenderConstants::ShadowCascadeDistance);
+		const float tolerance = shadowDistance * 1.0e-5f;
+
+		float splitDistances[g_cascadeCount];
+		MAD::UShadowCascades::CalculateSplitDistances(nearPlane, shadowDistance, MAD::RenderConstants::ShadowCascadeSplitLambda, g_cascadeCount, splitDistances);
+
+		float previousSplit = nearPlane;
+		for (uint32_t i = 0; i < g_cascadeCount; ++i)
+		{
+			Check(splitDistances[i] > previousSplit, "Split %u at %f isn't past the previous one at %f", i, splitDistances[i], previousSplit);
+			previousSplit = splitDistances[i];
+		}
+
+		Check(IsNearlyEqual(splitDistances[g_cascadeCount - 1], shadowDistance, tolerance), "The last split is at %f instead of the shadow distance %f", splitDistances[g_cascadeCount - 1], shadowDistance);
+
+		float uniformSplits[g_cascadeCount];
+		float logSplits[g_cascadeCount];
+		MAD::UShadowCascades::CalculateSplitDistances(nearPlane, shadowDistance, 0.0f, g_cascadeCount, uniformSplits);
+		MAD::UShadowCascades::CalculateSplitDistances(nearPlane, shadowDistance, 1.0f, g_cascadeCount, logSplits);
+
+		for (uint32_t i = 0; i < g_cascadeCount; ++i)
+		{
+			const float slicePercent = static_cast<float>(i + 1) / g_cascadeCount;
+			const float expectedUniformSplit = nearPlane + (shadowDistance - nearPlane) * slicePercent;
+			const float expectedLogSplit = nearPlane * powf(shadowDistance / nearPlane, slicePercent);
+
+			Check(IsNearlyEqual(uniformSplits[i], expectedUniformSplit, tolerance), "Uniform split %u is at %f instead of %f", i, uniformSplits[i], expectedUniformSplit);
+			Check(IsNearlyEqual(logSplits[i], expectedLogSplit, tolerance), "Logarithmic split %u is at %f instead of %f", i, logSplits[i], expectedLogSplit);
+		}
+	}
+
+	// The slices have to cover [near, shadow distance] without gaps or overlaps, split where CalculateSplitDistances says
+	void TestSliceChain(const MAD::SShadowCascade* inCascades, const STestCamera& inCamera)
+	{
+		float splitDistances[g_cascadeCount];
+		MAD::UShadowCascades::CalculateSplitDistances(inCamera.m_instance.m_nearPlaneDistance, inCamera.m_shadowDistance, MAD::RenderConstants::ShadowCascadeSplitLambda, g_cascadeCount, splitDistances);
+
+		float expectedSliceNear = inCamera.m_instance.m_nearPlaneDistance;
+		for (uint32_t i = 0; i < g_cascadeCount; ++i)
+		{
+			Check(inCascades[i].m_splitNear == expectedSliceNear && inCascades[i].m_splitFar == splitDistances[i],
+				  "Cascade %u: slice is [%f, %f] instead of [%f, %f]", i, inCascades[i].m_splitNear, inCascades[i].m_splitFar, expectedSliceNear, splitDistances[i]);
+
+			expectedSliceNear = splitDistances[i];
+		}
+	}
+
+	void TestCascadeFit(const MAD::SShadowCascade& inCascade, const STestCamera& inCamera, uint32_t inCascadeIndex)
+	{
+		MAD::Vector3 wsCorners[8];
+		GetSliceCorners(inCamera, inCascade.m_splitNear, inCascade.m_splitFar, wsCorners);
+
+		for (const auto& currentCorner : wsCorners)
+		{
+			const MAD::Vector3 lsCorner = MAD::Vector3::Transform(currentCorner, inCascade.m_lightViewMatrix);
+			const float lsDepth = -lsCorner.z;
+
+			Check(lsCorner.x >= inCascade.m_lightSpaceMin.x - g_positionTolerance && lsCorner.x <= inCascade.m_lightSpaceMax.x + g_positionTolerance &&
+				  lsCorner.y >= inCascade.m_lightSpaceMin.y - g_positionTolerance && lsCorner.y <= inCascade.m_lightSpaceMax.y + g_positionTolerance,
+				  "Cascade %u: corner (%f, %f) is outside of the window (%f, %f) to (%f, %f)", inCascadeIndex, lsCorner.x, lsCorner.y,
+				  inCascade.m_lightSpaceMin.x, inCascade.m_lightSpaceMin.y, inCascade.m_lightSpaceMax.x, inCascade.m_lightSpaceMax.y);
+
+			Check(lsDepth >= inCascade.m_lightSpaceNear - g_positionTolerance && lsDepth <= inCascade.m_lightSpaceFar + g_positionTolerance,
+				  "Cascade %u: corner depth %f is outside of [%f, %f]", inCascadeIndex, lsDepth, inCascade.m_lightSpaceNear, inCascade.m_lightSpaceFar);
+
+			const MAD::Vector3 ndcCorner = MAD::Vector3::Transform(currentCorner, inCascade.m_viewProjectionMatrix);
+
+			Check(fabsf(ndcCorner.x) <= 1.0f + g_ndcTolerance && fabsf(ndcCorner.y) <= 1.0f + g_ndcTolerance && ndcCorner.z >= -g_ndcTolerance && ndcCorner.z <= 1.0f + g_ndcTolerance,
+				  "Cascade %u: corner projects to (%f, %f, %f), off the shadow map", inCascadeIndex, ndcCorner.x, ndcCorner.y, ndcCorner.z);
+		}
+
+		const float texelSize = GetTexelSize(inCascade);
+
+		Check(IsOnTexelGrid(inCascade.m_lightSpaceMin.x, texelSize) && IsOnTexelGrid(inCascade.m_lightSpaceMin.y, texelSize),
+			  "Cascade %u: window origin (%f, %f) isn't on the %f texel grid", inCascadeIndex, inCascade.m_lightSpaceMin.x, inCascade.m_lightSpaceMin.y, texelSize);
+	}
+
+	void TestCasterCulling(const MAD::SShadowCascade& inCascade, uint32_t inCascadeIndex)
+	{
+		const MAD::Matrix lightInverseViewMatrix = inCascade.m_lightViewMatrix.Invert();
+		const MAD::Vector2 lsWindowCenter = (inCascade.m_lightSpaceMin + inCascade.m_lightSpaceMax) * 0.5f;
+		const float windowHalfSize = (inCascade.m_lightSpaceMax.x - inCascade.m_lightSpaceMin.x) * 0.5f;
+		const float lsMidDepth = (inCascade.m_lightSpaceNear + inCascade.m_lightSpaceFar) * 0.5f;
+		const float casterRadius = 10.0f;
+
+		const auto canCast = [&inCascade, &lightInverseViewMatrix](float inLSX, float inLSY, float inLSDepth, float inRadius)
+		{
+			const MAD::Vector3 wsCenter = MAD::Vector3::Transform(MAD::Vector3(inLSX, inLSY, -inLSDepth), lightInverseViewMatrix);
+			return MAD::UShadowCascades::CanCastIntoCascade(inCascade, wsCenter, inRadius);
+		};
+
+		Check(canCast(lsWindowCenter.x, lsWindowCenter.y, lsMidDepth, casterRadius), "Cascade %u: skipped a caster in its middle", inCascadeIndex);
+		Check(canCast(inCascade.m_lightSpaceMax.x + casterRadius * 0.5f, lsWindowCenter.y, lsMidDepth, casterRadius), "Cascade %u: skipped a caster overlapping its side", inCascadeIndex);
+		Check(canCast(lsWindowCenter.x, lsWindowCenter.y, inCascade.m_lightSpaceNear - windowHalfSize * 4.0f, casterRadius), "Cascade %u: skipped a caster between it and the light", inCascadeIndex);
+		Check(canCast(lsWindowCenter.x, lsWindowCenter.y, inCascade.m_lightSpaceFar + casterRadius * 0.5f, casterRadius), "Cascade %u: skipped a caster overlapping its far plane", inCascadeIndex);
+		Check(canCast(lsWindowCenter.x, lsWindowCenter.y, inCascade.m_lightSpaceFar + windowHalfSize, -1.0f), "Cascade %u: skipped an unbounded caster", inCascadeIndex);
+
+		Check(!canCast(inCascade.m_lightSpaceMax.x + casterRadius * 2.0f, lsWindowCenter.y, lsMidDepth, casterRadius), "Cascade %u: kept a caster beside it in x", inCascadeIndex);
+		Check(!canCast(lsWindowCenter.x, inCascade.m_lightSpaceMin.y - casterRadius * 2.0f, lsMidDepth, casterRadius), "Cascade %u: kept a caster beside it in y", inCascadeIndex);
+		Check(!canCast(lsWindowCenter.x, lsWindowCenter.y, inCascade.m_lightSpaceFar + casterRadius * 2.0f, casterRadius), "Cascade %u: kept a caster behind it", inCascadeIndex);
+	}
+
+	void TestCameras(const MAD::Vector3& inLightDirection, uint32_t inCameraCount, MAD::URandomStream& inOutRandomStream)
+	{
+		float windowSizes[g_cascadeCount] = {};
+
+		for (uint32_t cameraIndex = 0; cameraIndex < inCameraCount; ++cameraIndex)
+		{
+			// The position, yaw and pitch, then the nudge. The last value is unused
+			float randomValues[8];
+			inOutRandomStream.GenerateFloats(randomValues, 8);
+
+			const MAD::Vector3 position((randomValues[0] * 2.0f - 1.0f) * g_maxCameraDistance, (randomValues[1] * 2.0f - 1.0f) * g_maxCameraDistance, (randomValues[2] * 2.0f - 1.0f) * g_maxCameraDistance);
+			const float yaw = randomValues[3] * DirectX::XM_2PI;
+			const float pitch = (randomValues[4] * 2.0f - 1.0f) * g_maxCameraPitch;
+			const MAD::Vector3 nudge((randomValues[5] * 2.0f - 1.0f) * g_maxCameraNudge, (randomValues[6] * 2.0f - 1.0f) * g_maxCameraNudge, 0.0f);
+
+			const STestCamera camera = CreateCamera(position, yaw, pitch);
+			const STestCamera nudgedCamera = CreateCamera(position + nudge, yaw, pitch);
+
+			MAD::SShadowCascade cascades[g_cascadeCount];
+			MAD::SShadowCascade nudgedCascades[g_cascadeCount];
+			FitCascades(inLightDirection, camera, cascades);
+			FitCascades(inLightDirection, nudgedCamera, nudgedCascades);
+
+			TestSliceChain(cascades, camera);
+
+			for (uint32_t i = 0; i < g_cascadeCount; ++i)
+			{
+				TestCascadeFit(cascades[i], camera, i);
+				TestCasterCulling(cascades[i], i);
+
+				const float windowSize = cascades[i].m_lightSpaceMax.x - cascades[i].m_lightSpaceMin.x;
+
+				if (cameraIndex == 0)
+				{
+					windowSizes[i] = windowSize;
+				}
+
+				// Measured off the window's bounds, so only as precise as they are. A radius rounding step is far larger
+				Check(IsNearlyEqual(windowSize, windowSizes[i], g_positionTolerance) && IsNearlyEqual(cascades[i].m_lightSpaceMax.y - cascades[i].m_lightSpaceMin.y, windowSizes[i], g_positionTolerance),
+					  "Cascade %u: window is %f wide for this camera and %f for the first one", i, windowSize, windowSizes[i]);
+
+				const float texelSize = GetTexelSize(cascades[i]);
+				const MAD::Vector2 windowShift = nudgedCascades[i].m_lightSpaceMin - cascades[i].m_lightSpaceMin;
+
+				Check(IsOnTexelGrid(windowShift.x, texelSize) && IsOnTexelGrid(windowShift.y, texelSize),
+					  "Cascade %u: moving the camera moved the window by (%f, %f), which isn't whole %f texels", i, windowShift.x, windowShift.y, texelSize);
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t cameraCount = g_defaultCameraCount;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-cameras") == 0 && i + 1 < argc)
+		{
+			cameraCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			printf("Usage: ShadowCascadeTest [-cameras <count>]\n");
+			return 1;
+		}
+	}
+
+	if (cameraCount == 0)
+	{
+		cameraCount = g_defaultCameraCount;
+	}
+
+	printf("%u cascades at %u x %u, %u cameras under each of %u light directions\n", g_cascadeCount, MAD::RenderConstants::ShadowCascadeRes, MAD::RenderConstants::ShadowCascadeRes,
+		   cameraCount, static_cast<uint32_t>(sizeof(g_lightDirections) / sizeof(g_lightDirections[0])));
+
+	TestSplitDistances();
+
+	MAD::URandomStream randomStream;
+	for (const auto& currentLightDirection : g_lightDirections)
+	{
+		TestCameras(currentLightDirection, cameraCount, randomStream);
+	}
+
+	printf("%u of %u checks failed\n", g_failedCheckCount, g_checkCount);
+
+	return g_failedCheckCount == 0 ? 0 : 1;
+}
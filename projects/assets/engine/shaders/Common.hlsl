@@ -1,5 +1,7 @@
 #pragma pack_matrix(row_major)
 
+#define SHADOW_CASCADE_COUNT 4
+
 struct PointLight
 {
 	float3 m_lightPosition;
@@ -62,6 +64,11 @@ cbuffer CBPerPointLightConstants : register(b2)
 cbuffer CBPerDirectionalLightConstants : register(b3)
 {
 	DirectionalLight g_directionalLight;
+
+	// Cascade i covers view space depths up to g_cascadeSplitDepths[i] and is stored in tile i of the 2x2 shadow map atlas
+	float4x4 g_cascadeViewProjectionMatrices[SHADOW_CASCADE_COUNT];
+	float4 g_cascadeSplitDepths;
+	float g_shadowAtlasTexelSize;
 };
 
 cbuffer CBPerMaterialConstants : register(b4)
@@ -76,6 +83,19 @@ cbuffer CBPerDrawConstants : register(b5)
 	float4x4 g_objectToProjectionMatrix;
 };
 
+// Instanced draws don't have per draw constants, the object transform comes from the per-instance vertex stream instead
+#ifdef INSTANCED
+#define INSTANCE_INPUT float4x4 mInstanceObjectToWorld : INSTANCE_TRANSFORM;
+#define OBJECT_TO_WORLD(input) (input.mInstanceObjectToWorld)
+#define OBJECT_TO_VIEW(input) mul(input.mInstanceObjectToWorld, g_cameraViewMatrix)
+#define OBJECT_TO_PROJECTION(input) mul(input.mInstanceObjectToWorld, g_cameraViewProjectionMatrix)
+#else
+#define INSTANCE_INPUT
+#define OBJECT_TO_WORLD(input) g_objectToWorldMatrix
+#define OBJECT_TO_VIEW(input) g_objectToViewMatrix
+#define OBJECT_TO_PROJECTION(input) g_objectToProjectionMatrix
+#endif
+
 SamplerState g_pointSampler					: register(s0);
 SamplerState g_linearSampler				: register(s1);
 SamplerState g_trilinearSampler				: register(s2);
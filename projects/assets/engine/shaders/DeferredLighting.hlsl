@@ -102,8 +102,17 @@ float CalculateShadowFactor(float3 positionVS)
 	
 	return g_cubeMap.SampleCmpLevelZero(g_shadowMapSampler, sampleVec, calculatedDepth).r;
 #elif DIRECTIONAL_LIGHT
+	// Pick the first cascade whose split is past this pixel (view space looks down -z)
+	const float viewDepth = -positionVS.z;
+	const uint cascadeIndex = (uint)dot(float4(viewDepth > g_cascadeSplitDepths), float4(1.0, 1.0, 1.0, 1.0));
+
+	if (cascadeIndex >= SHADOW_CASCADE_COUNT)
+	{
+		return 1.0;
+	}
+
 	float4 positionWS = mul(float4(positionVS, 1.0), g_cameraInverseViewMatrix);
-	float4 positionLS = mul(positionWS, g_directionalLight.m_viewProjectionMatrix);
+	float4 positionLS = mul(positionWS, g_cascadeViewProjectionMatrices[cascadeIndex]);
 	positionLS.xyz /= positionLS.w;
 
 	if (positionLS.z > 1.0)
@@ -114,9 +123,11 @@ float CalculateShadowFactor(float3 positionVS)
 	positionLS.x = positionLS.x * 0.5 + 0.5;
 	positionLS.y = 0.5 - positionLS.y * 0.5;
 
-	//float w, h;
-	//g_shadowMap.GetDimensions(w, h);
-	const float dx = 1.0 / 4096;
+	// Move into the cascade's tile of the atlas, keeping the filter taps from bleeding into the neighbouring tiles
+	const float dx = g_shadowAtlasTexelSize;
+	const float2 tileOffset = float2(cascadeIndex % 2, cascadeIndex / 2) * 0.5;
+	positionLS.xy = tileOffset + clamp(positionLS.xy * 0.5, dx * 2.0, 0.5 - dx * 2.0);
+
 	const float2 offsets[5] =
 	{
 		                   float2(0.0f,  -dx),
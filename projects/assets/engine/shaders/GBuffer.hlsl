@@ -7,6 +7,7 @@
 //=>:(Permute, EMISSIVE)
 //=>:(Permute, OPACITY_MASK)
 //=>:(Permute, NORMAL_MAP)
+//=>:(Permute, INSTANCED)
 
 // Input structs for vertex and pixel shader
 struct VS_INPUT
@@ -17,6 +18,7 @@ struct VS_INPUT
 	float4 mModelTangent : TANGENT;
 #endif
 	float2 mTex          : TEXCOORD;
+	INSTANCE_INPUT
 };
 
 struct PS_INPUT
@@ -65,12 +67,14 @@ PS_INPUT VS(VS_INPUT input)
 {
 	PS_INPUT psInput;
 
-	psInput.mHomogenousPos = mul(float4(input.mModelPos, 1.0f), g_objectToProjectionMatrix);
-	psInput.mWSPosition = mul(float4(input.mModelPos, 1.0f), g_objectToWorldMatrix).xyz;
+	const float4x4 objectToViewMatrix = OBJECT_TO_VIEW(input);
+
+	psInput.mHomogenousPos = mul(float4(input.mModelPos, 1.0f), OBJECT_TO_PROJECTION(input));
+	psInput.mWSPosition = mul(float4(input.mModelPos, 1.0f), OBJECT_TO_WORLD(input)).xyz;
 	psInput.mTex = input.mTex;
-	psInput.mVSNormal = mul(float4(input.mModelNormal, 0.0f), g_objectToViewMatrix).xyz;
+	psInput.mVSNormal = mul(float4(input.mModelNormal, 0.0f), objectToViewMatrix).xyz;
 #ifdef NORMAL_MAP
-	psInput.mVSTangent = mul(float4(input.mModelTangent.xyz, 0.0f), g_objectToViewMatrix).xyz;
+	psInput.mVSTangent = mul(float4(input.mModelTangent.xyz, 0.0f), objectToViewMatrix).xyz;
 	psInput.mVSBitangent = cross(psInput.mVSNormal, psInput.mVSTangent.xyz) * input.mModelTangent.w;
 #endif
 
@@ -3,11 +3,13 @@
 //=>:(Usage, VS, vs_5_0)
 //=>:(Permute, DIRECTIONAL_LIGHT)
 //=>:(Permute, POINT_LIGHT)
+//=>:(Permute, INSTANCED)
 
 // Input structs for vertex and pixel shader
 struct VS_INPUT
 {
 	float3 mModelPos : POSITION;
+	INSTANCE_INPUT
 };
 
 //--------------------------------------------------------------------------------------
@@ -16,8 +18,8 @@ struct VS_INPUT
 float4 VS(VS_INPUT input) : SV_POSITION
 {
 #ifdef DIRECTIONAL_LIGHT
-	return mul(mul(float4(input.mModelPos, 1.0f), g_objectToWorldMatrix), g_directionalLight.m_viewProjectionMatrix);
+	return mul(mul(float4(input.mModelPos, 1.0f), OBJECT_TO_WORLD(input)), g_directionalLight.m_viewProjectionMatrix);
 #else
-	return mul(mul(float4(input.mModelPos, 1.0f), g_objectToWorldMatrix), g_pointLight.m_viewProjectionMatrix);
+	return mul(mul(float4(input.mModelPos, 1.0f), OBJECT_TO_WORLD(input)), g_pointLight.m_viewProjectionMatrix);
 #endif
 }
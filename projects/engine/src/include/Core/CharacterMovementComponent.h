@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Core/CharacterMover.h"
+#include "Core/Component.h"
+
+namespace MAD
+{
+	/*
+		Walks its entity around with a UCharacterMover, once per fixed tick before physics. Gameplay only asks for a move velocity
+		and jumps, and the component moves the entity's root.
+
+		The player owning the character moves it right away and sends each tick's input to the server, which replays it and
+		replicates the resulting state back. When that state arrives, the owner rewinds to it and replays the inputs the server
+		hasn't seen yet, so its prediction only drifts when the server saw something different. Everyone else just follows the
+		replicated state.
+
+		The owner also checks the server's state against the one it predicted for the same input, and logs the ticks they
+		differ on. With nothing but static geometry around the character, that only happens when the two builds don't step the
+		movement to the same bits.
+
+		The character isn't a body of the physics world, so dynamic bodies only get out of its way because it pushes them. Give
+		the entity a kinematic capsule physics component as well for bodies falling or thrown at it to be stopped by it.
+	*/
+	class CCharacterMovementComponent : public UComponent
+	{
+		MAD_DECLARE_COMPONENT(CCharacterMovementComponent, UComponent)
+	public:
+		explicit CCharacterMovementComponent(OGameWorld* inOwningWorld);
+
+		virtual void OnBeginPlay() override;
+		virtual void Load(const UGameWorldLoader& inLoader, const class UObjectValue& inPropertyObj) override;
+		virtual void UpdateComponent(float inDeltaTime) override;
+		virtual void OnEvent(EEventTypes inEventType, void* inEventData) override;
+		virtual void GetReplicatedProperties(eastl::vector<SObjectReplInfo>& inOutReplInfo) const override;
+
+		// Horizontal velocity to move at this tick. Adds up until the next update
+		void AddMoveInput(const Vector3& inMoveVelocity) { m_pendingInput.m_moveVelocity += inMoveVelocity; }
+		void Jump() { m_pendingInput.m_isJumping = true; }
+
+		const SCharacterMovementSettings& GetSettings() const { return m_settings; }
+		void SetSettings(const SCharacterMovementSettings& inSettings) { m_settings = inSettings; }
+
+		const Vector3& GetVelocity() const { return m_state.m_velocity; }
+		bool IsGrounded() const { return m_state.m_isGrounded; }
+	private:
+		// The state the server replicates, and the last input of the owner that went into it
+		struct SAuthorityState
+		{
+			SAuthorityState() : m_lastInputTick(0) {}
+
+			bool operator==(const SAuthorityState& inOther) const { return m_state == inOther.m_state && m_lastInputTick == inOther.m_lastInputTick; }
+
+			SCharacterMovementState m_state;
+			uint32_t m_lastInputTick;
+		};
+
+		// An input the owner sent to the server, and the state it predicted the input would lead to
+		struct SPredictedMove
+		{
+			SCharacterMovementInput m_input;
+			uint64_t m_stateChecksum;
+		};
+
+		bool IsLocallyControlled() const;
+
+		void SimulateInput(const SCharacterMovementInput& inInput);
+
+		// Server only, the input becomes part of the authority state
+		void ApplyInput(const SCharacterMovementInput& inInput);
+
+		void OnRep_AuthorityState();
+
+		SCharacterMovementSettings m_settings;
+		SCharacterMovementState m_state;
+		SCharacterMovementInput m_pendingInput;
+		UCharacterMover m_mover;
+
+		// Owner only, the moves sent to the server that its state doesn't include yet
+		eastl::vector<SPredictedMove> m_unacknowledgedMoves;
+
+		SAuthorityState m_authorityState;
+	};
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/fixed_vector.h>
+#include <EASTL/vector.h>
+#include <EASTL/weak_ptr.h>
+
+#include "Core/PhysicsQueries.h"
+#include "Core/PhysicsShape.h"
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	class CPhysicsComponent;
+	class UPhysicsWorld;
+
+	struct SCharacterMovementSettings
+	{
+		SCharacterMovementSettings();
+
+		// The capsule stands upright, centered on the character's position
+		float m_radius;
+		float m_halfHeight;
+
+		float m_maxSlopeAngle; // Radians. Anything steeper is a wall
+		float m_stepHeight; // Ledges up to this high are walked up instead of blocking
+		float m_maxMoveSpeed; // Requested move velocities are clamped to this, so that remote inputs can't speed the character up
+		float m_jumpSpeed;
+		float m_airControl; // How quickly the horizontal velocity follows the requested one in the air, per second
+		float m_pushMass; // How hard the character pushes the dynamic bodies it walks into
+	};
+
+	// Everything a tick of movement depends on besides the state and the physics world. Sent as is from clients to the server
+	struct SCharacterMovementInput
+	{
+		SCharacterMovementInput() : m_tick(0), m_isJumping(false) {}
+
+		Vector3 m_moveVelocity; // Horizontal
+		uint32_t m_tick; // Game tick of the client that produced the input, to match the server's state back to it
+		bool m_isJumping;
+	};
+
+	struct SCharacterMovementState
+	{
+		SCharacterMovementState() : m_groundNormal(Vector3::Up), m_isGrounded(false) {}
+
+		bool operator==(const SCharacterMovementState& inOther) const
+		{
+			return m_position == inOther.m_position && m_velocity == inOther.m_velocity && m_groundNormal == inOther.m_groundNormal && m_isGrounded == inOther.m_isGrounded;
+		}
+
+		// See USimulationChecksum
+		uint64_t ComputeChecksum() const;
+
+		Vector3 m_position;
+		Vector3 m_velocity;
+		Vector3 m_groundNormal;
+		bool m_isGrounded;
+	};
+
+	// A body the character ran into during its last move
+	struct SCharacterContact
+	{
+		eastl::weak_ptr<CPhysicsComponent> m_body;
+		Vector3 m_normal; // Out of the body
+		float m_approachSpeed; // Of the character into the body, before it was stopped
+	};
+
+	/*
+		Kinematic capsule movement: collide-and-slide against every body of the physics world, walking up steps and snapping down
+		onto the ground it walks off of, with slopes steeper than the limit treated as walls. Nothing pushes the character but its
+		own input, gravity and the geometry it's moved out of.
+
+		A move only depends on its input, the previous state and the bodies it touches, and always runs the same fixed number of
+		queries in the same order. The client predicting its own character and the server replaying the client's inputs get the
+		same result as long as they have the same bodies around the character.
+	*/
+	class UCharacterMover
+	{
+	public:
+		static const uint32_t MaxContacts = 4;
+
+		using ContactContainer_t = eastl::fixed_vector<SCharacterContact, MaxContacts, false>;
+
+		// Moves inOutState by one tick of inInput. Reads the physics world only, so different characters can move in parallel
+		void Move(const UPhysicsWorld& inPhysicsWorld, const SCharacterMovementSettings& inSettings, const SQueryFilter& inFilter, const SCharacterMovementInput& inInput, float inDeltaTime, SCharacterMovementState& inOutState);
+
+		// The bodies the last move ran into, up to MaxContacts of them
+		const ContactContainer_t& GetContacts() const { return m_contacts; }
+	private:
+		void Depenetrate(Vector3& inOutPosition);
+
+		// Returns true when something too steep to walk on stopped part of the move
+		bool SlideMove(const Vector3& inDisplacement, bool inIsGrounded, Vector3& inOutPosition, Vector3& inOutVelocity);
+
+		bool TryStepUp(const Vector3& inDisplacement, const Vector3& inSlidePosition, Vector3& inOutPosition, Vector3& inOutVelocity);
+
+		void UpdateGround(bool inWasGrounded, SCharacterMovementState& inOutState);
+
+		void AddContact(const SQueryHit& inHit, const Vector3& inVelocity);
+
+		float GetSweepDistance(const Vector3& inStart, const Vector3& inDirection, float inMaxDistance, SQueryHit& outHit) const;
+
+		bool IsWalkable(const Vector3& inNormal) const { return inNormal.y >= m_minGroundNormalY; }
+	private:
+		// Only valid during a move
+		const UPhysicsWorld* m_physicsWorld;
+		const SQueryFilter* m_filter;
+		SPhysicsShape m_shape;
+		float m_minGroundNormalY;
+		float m_stepHeight;
+
+		ContactContainer_t m_contacts;
+
+		// Kept between moves so that overlaps don't allocate every tick
+		eastl::vector<SQueryHit> m_overlapHits;
+	};
+}
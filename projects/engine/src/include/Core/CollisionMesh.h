@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/fixed_vector.h>
+#include <EASTL/shared_ptr.h>
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+#include "Core/DynamicAABBTree.h"
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	struct SSubMesh;
+
+	// Two nodes to a cache line. Inner nodes always have their two children next to each other
+	struct SCollisionMeshNode
+	{
+		Vector3 m_boundsMin;
+		uint32_t m_firstIndex; // Inner nodes: the left child, the right one follows it. Leaves: the first triangle
+		Vector3 m_boundsMax;
+		uint32_t m_triangleCount; // 0 for inner nodes
+
+		bool IsLeaf() const { return m_triangleCount > 0; }
+		SAABB GetBounds() const { return SAABB(m_boundsMin, m_boundsMax); }
+	};
+
+	static_assert(sizeof(SCollisionMeshNode) == 32, "Collision mesh nodes should stay 32 bytes");
+
+	/*
+		Static triangle soup for level geometry that bodies collide with, built from the full detail LOD of a mesh asset. The
+		triangles are held in a bounding volume hierarchy built with the surface area heuristic, and are reordered so that
+		every leaf refers to a contiguous range of them. Everything is in the mesh's object space.
+
+		Building the hierarchy for a large mesh takes a while, so it's cooked next to the source mesh the first time the
+		mesh is loaded as a collision mesh, with a ".madcol" extension. The cooked file records the source's size and write
+		time like cooked meshes do, so an edited source is rebuilt.
+	*/
+	class UCollisionMesh
+	{
+	public:
+		// Bump whenever the cooked layout or the build settings change, to invalidate existing cooked files
+		static const uint32_t CookedCollisionMeshVersion;
+
+		/*
+		* Loads the collision mesh of the mesh at the given path, relative to the assets root directory. Meshes are only
+		* loaded once, and the hierarchy is only built when there's no up to date cooked file. Main thread only, since the
+		* build runs on the job system. Returns null if the mesh cannot be loaded.
+		*/
+		static eastl::shared_ptr<UCollisionMesh> Load(const eastl::string& inRelativePath);
+
+		static eastl::string GetCookedCollisionMeshPath(const eastl::string& inSourcePath);
+
+		// Reads the cooked file of the source mesh at the given full path. Fails if it's missing or stale
+		bool LoadCooked(const eastl::string& inSourcePath);
+
+		bool WriteCooked(const eastl::string& inSourcePath) const;
+
+		// Builds the hierarchy over the full detail LOD of every sub-mesh. Sub-mesh indices are relative to their vertex start
+		void Build(const Vector3* inPositions, uint32_t inVertexCount, const SSubMesh* inSubMeshes, uint32_t inSubMeshCount, const uint8_t* inIndexData);
+
+		// Two-sided, the normal faces back along the ray
+		bool Raycast(const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance, Vector3& outNormal) const;
+
+		// Calls inCallback(triangleIndex) for every triangle in a leaf that overlaps inBounds. Return false to stop the query
+		template <typename CallbackType>
+		void Query(const SAABB& inBounds, CallbackType&& inCallback) const;
+
+		void GetTriangle(uint32_t inTriangleIndex, Vector3 outVertices[3]) const
+		{
+			const uint32_t* triangleIndices = &m_indices[inTriangleIndex * 3];
+
+			outVertices[0] = m_positions[triangleIndices[0]];
+			outVertices[1] = m_positions[triangleIndices[1]];
+			outVertices[2] = m_positions[triangleIndices[2]];
+		}
+
+		uint32_t GetTriangleCount() const { return static_cast<uint32_t>(m_indices.size() / 3); }
+
+		// Bounds of every triangle, in object space
+		SAABB GetBounds() const { return m_nodes.empty() ? SAABB(Vector3::Zero, Vector3::Zero) : m_nodes[0].GetBounds(); }
+
+		size_t GetMemorySize() const;
+	private:
+		eastl::vector<SCollisionMeshNode> m_nodes;
+		eastl::vector<Vector3> m_positions;
+
+		// Three per triangle, in the order the leaves refer to them
+		eastl::vector<uint32_t> m_indices;
+	};
+
+	template <typename CallbackType>
+	void UCollisionMesh::Query(const SAABB& inBounds, CallbackType&& inCallback) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		// Surface area heuristic trees aren't balanced, but stay far shallower than this for any real mesh
+		eastl::fixed_vector<uint32_t, 64> nodeStack;
+		nodeStack.push_back(0);
+
+		while (!nodeStack.empty())
+		{
+			const SCollisionMeshNode& currentNode = m_nodes[nodeStack.back()];
+			nodeStack.pop_back();
+
+			if (!currentNode.GetBounds().Overlaps(inBounds))
+			{
+				continue;
+			}
+
+			if (!currentNode.IsLeaf())
+			{
+				nodeStack.push_back(currentNode.m_firstIndex);
+				nodeStack.push_back(currentNode.m_firstIndex + 1);
+				continue;
+			}
+
+			for (uint32_t i = 0; i < currentNode.m_triangleCount; ++i)
+			{
+				if (!inCallback(currentNode.m_firstIndex + i))
+				{
+					return;
+				}
+			}
+		}
+	}
+}
@@ -60,6 +60,14 @@ namespace MAD
 
 		virtual void Load(const class UGameWorldLoader& inLoader, const class UObjectValue& inPropertyObj) { UNREFERENCED_PARAMETER(inLoader); UNREFERENCED_PARAMETER(inPropertyObj); }
 
+		// Components whose Load only touches their own state (and thread safe systems such as the asset cache) can be loaded on
+		// the job system's worker threads while a world is instantiated. Everything else is loaded on the main thread
+		virtual bool IsLoadThreadSafe() const { return false; }
+
+		// Components that can take a new transform and have Load called again while alive, when their world file is hot
+		// reloaded. Entities with any other changed component are respawned instead
+		virtual bool IsHotReloadable() const { return false; }
+
 		void PrintTranslationHierarchy(uint8_t inDepth) const;
 		void PopulateTransformQueue(eastl::queue<ULinearTransform>& inOutTransformQueue) const;
 	private:
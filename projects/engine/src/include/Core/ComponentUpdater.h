@@ -19,12 +19,19 @@ namespace MAD
 	{
 		using ComponentContainer_t = eastl::vector<eastl::shared_ptr<UComponent>>;
 
-		explicit SComponentPriorityBlock(TypeID_t inComponentTypeID = eastl::numeric_limits<TypeID_t>::max()) : m_blockComponentTypeID(inComponentTypeID) {}
+		explicit SComponentPriorityBlock(TypeID_t inComponentTypeID = eastl::numeric_limits<TypeID_t>::max()) : m_blockComponentTypeID(inComponentTypeID), m_isOrderDirty(false) {}
 
 		TypeID_t m_blockComponentTypeID;
 		ComponentContainer_t m_blockComponents;
+		bool m_isOrderDirty; // Components were registered since the block was last put in update order
 	};
 
+	/*
+		Components of the same block update in an order that's the same on every machine, since the server and its clients have
+		to step the simulation identically. Entities loaded from world files are registered in the same order everywhere, but
+		network spawned ones are registered in whatever order their spawns arrive in, so they update after the loaded ones in
+		net ID order instead.
+	*/
 	class UComponentUpdater
 	{
 	public:
@@ -41,6 +48,9 @@ namespace MAD
 		void UpdatePostPhysicsComponents(float inDeltaTime);
 	private:
 		void RegisterComponent(eastl::shared_ptr<UComponent> inNewComponentPtr);
+
+		// Net IDs are only assigned once the entity finishes spawning, so blocks are sorted right before they update
+		void UpdateBlock(SComponentPriorityBlock& inOutBlock, float inDeltaTime);
 	private:
 		bool m_isUpdating;
 		ComponentContainer m_componentPriorityBlocks;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/vector.h>
+
+#include "Core/PhysicsNarrowphase.h"
+#include "Core/RigidBodyState.h"
+
+namespace MAD
+{
+	/*
+		Sequential impulse solver for contacts. Every iteration applies one impulse per contact and friction direction, clamped
+		so that contacts only push and friction stays inside its cone. The impulses of the previous tick are applied up front
+		(warm starting) so that stacks converge in a handful of iterations. Penetration is resolved with a velocity bias.
+
+		Only writes the velocities of dynamic bodies, so manifolds that don't share a dynamic body can be solved at the same time.
+	*/
+	class UContactSolver
+	{
+	public:
+		static const uint32_t VelocityIterations = 10;
+
+		// Solves inOutManifolds[inManifoldIndices[i]] for i in [0, inManifoldCount) and stores the accumulated impulses back into them for the next tick
+		void Solve(SRigidBodyState& inOutBodies, eastl::vector<SContactManifold>& inOutManifolds, const uint32_t* inManifoldIndices, uint32_t inManifoldCount, float inDeltaTime);
+	private:
+		struct SConstraintPoint
+		{
+			Vector3 m_relativeA;
+			Vector3 m_relativeB;
+			float m_normalMass;
+			float m_tangentMass[2];
+			float m_velocityBias;
+			float m_normalImpulse;
+			float m_tangentImpulse[2];
+		};
+
+		struct SConstraint
+		{
+			uint32_t m_manifoldIndex;
+			uint32_t m_bodyA;
+			uint32_t m_bodyB;
+			Vector3 m_normal;
+			Vector3 m_tangents[2];
+			float m_friction;
+			SConstraintPoint m_points[SContactManifold::MaxPoints];
+			uint32_t m_pointCount;
+		};
+
+		void InitializeConstraints(const SRigidBodyState& inBodies, const eastl::vector<SContactManifold>& inManifolds, const uint32_t* inManifoldIndices, uint32_t inManifoldCount, float inDeltaTime);
+		void WarmStart(SRigidBodyState& inOutBodies) const;
+		void SolveVelocities(SRigidBodyState& inOutBodies);
+		void StoreImpulses(eastl::vector<SContactManifold>& inOutManifolds) const;
+	private:
+		// Kept between ticks so that solving doesn't allocate
+		eastl::vector<SConstraint> m_constraints;
+	};
+}
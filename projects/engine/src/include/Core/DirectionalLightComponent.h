@@ -12,6 +12,7 @@ namespace MAD
 		explicit CDirectionalLightComponent(OGameWorld* inOwningWorld);
 
 		virtual void Load(const class UGameWorldLoader& inLoader, const class UObjectValue& inPropertyObj) override;
+		virtual bool IsHotReloadable() const override { return true; }
 		virtual void UpdateComponent(float inDeltaTime) override;
 
 	private:
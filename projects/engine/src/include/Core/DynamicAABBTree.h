@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cfloat>
+#include <cstdint>
+
+#include <DirectXMath.h>
+
+#include <EASTL/fixed_vector.h>
+#include <EASTL/vector.h>
+
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	struct SAABB
+	{
+		SAABB() {}
+		SAABB(const Vector3& inMin, const Vector3& inMax) : m_min(inMin), m_max(inMax) {}
+
+		Vector3 m_min;
+		Vector3 m_max;
+
+		bool Overlaps(const SAABB& inOther) const
+		{
+			return m_min.x <= inOther.m_max.x && m_max.x >= inOther.m_min.x
+				&& m_min.y <= inOther.m_max.y && m_max.y >= inOther.m_min.y
+				&& m_min.z <= inOther.m_max.z && m_max.z >= inOther.m_min.z;
+		}
+
+		bool Contains(const SAABB& inOther) const
+		{
+			return m_min.x <= inOther.m_min.x && m_max.x >= inOther.m_max.x
+				&& m_min.y <= inOther.m_min.y && m_max.y >= inOther.m_max.y
+				&& m_min.z <= inOther.m_min.z && m_max.z >= inOther.m_max.z;
+		}
+
+		// Half the surface area, the cost the tree minimizes when it picks where a new leaf goes
+		float GetPerimeter() const
+		{
+			const Vector3 extents = m_max - m_min;
+			return extents.x * extents.y + extents.y * extents.z + extents.z * extents.x;
+		}
+
+		static SAABB Combine(const SAABB& inLeft, const SAABB& inRight)
+		{
+			return SAABB(Vector3::Min(inLeft.m_min, inRight.m_min), Vector3::Max(inLeft.m_max, inRight.m_max));
+		}
+
+		// Slab test. inInverseDirection comes from ComputeInverseDirection, so that rays parallel to an axis don't produce NaNs
+		bool IntersectsRay(const Vector3& inOrigin, const Vector3& inInverseDirection, float inMaxDistance) const
+		{
+			const Vector3 nearPlanes = (m_min - inOrigin) * inInverseDirection;
+			const Vector3 farPlanes = (m_max - inOrigin) * inInverseDirection;
+			const Vector3 entries = Vector3::Min(nearPlanes, farPlanes);
+			const Vector3 exits = Vector3::Max(nearPlanes, farPlanes);
+
+			const float entry = fmaxf(fmaxf(entries.x, entries.y), fmaxf(entries.z, 0.0f));
+			const float exit = fminf(fminf(exits.x, exits.y), fminf(exits.z, inMaxDistance));
+
+			return entry <= exit;
+		}
+
+		static Vector3 ComputeInverseDirection(const Vector3& inDirection)
+		{
+			// A huge finite value keeps (plane - origin) * inverse well defined when the origin lies on the plane
+			const auto inverseComponent = [](float inComponent) { return inComponent != 0.0f ? 1.0f / inComponent : FLT_MAX; };
+			return Vector3(inverseComponent(inDirection.x), inverseComponent(inDirection.y), inverseComponent(inDirection.z));
+		}
+	};
+
+	/*
+		Bounding volume hierarchy over boxes that move every frame, used as the physics broadphase. Every proxy is stored with
+		a fattened box, so a body that moves a little stays inside it and its leaf doesn't have to be reinserted. Leaves are
+		inserted next to the sibling that grows the tree's surface area the least, and the tree is kept balanced with rotations.
+
+		Nodes live in one pool and refer to each other by index, so creating proxies doesn't allocate once the pool is grown.
+	*/
+	class UDynamicAABBTree
+	{
+	public:
+		static const int32_t NullNode = -1;
+
+		UDynamicAABBTree();
+
+		// Returns the proxy ID. The stored box is inBounds grown by inMargin on every side
+		int32_t CreateProxy(const SAABB& inBounds, float inMargin, uint32_t inUserData);
+		void DestroyProxy(int32_t inProxyID);
+
+		// Returns true if the proxy had to be reinserted because inBounds left its fat box. inDisplacement stretches the new
+		// fat box in the direction the body moves, so that it's reinserted less often
+		bool MoveProxy(int32_t inProxyID, const SAABB& inBounds, float inMargin, const Vector3& inDisplacement);
+
+		bool IsProxy(int32_t inProxyID) const { return inProxyID >= 0 && inProxyID < static_cast<int32_t>(m_nodes.size()) && m_nodes[inProxyID].m_height == 0; }
+
+		const SAABB& GetFatBounds(int32_t inProxyID) const { return m_nodes[inProxyID].m_bounds; }
+		uint32_t GetUserData(int32_t inProxyID) const { return m_nodes[inProxyID].m_userData; }
+		void SetUserData(int32_t inProxyID, uint32_t inUserData) { m_nodes[inProxyID].m_userData = inUserData; }
+
+		// Calls inCallback(proxyID) for every proxy whose fat box overlaps inBounds. The callback returns false to stop the query.
+		// Queries only read the tree, so any number of them can run at once as long as nothing moves the proxies
+		template <typename CallbackType>
+		void Query(const SAABB& inBounds, CallbackType&& inCallback) const;
+
+		// Calls inCallback(proxyID, maxDistance) for every proxy whose fat box the ray enters before maxDistance. The callback
+		// returns the distance the ray is clipped to: maxDistance to carry on, the distance of a hit to only look for closer
+		// ones, or 0 to stop. inDirection must be normalized
+		template <typename CallbackType>
+		void RayCast(const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, CallbackType&& inCallback) const;
+
+		// Same as RayCast for RayPacketSize rays at once, with callbacks taking the index of the ray in the packet first. Every
+		// node is tested against the whole packet with SIMD, so coherent rays (e.g. a spread of bullets) share most of the
+		// traversal. Rays with a negative max distance are ignored, to pad the last packet of a batch
+		static const uint32_t RayPacketSize = 4;
+
+		template <typename CallbackType>
+		void RayCastPacket(const Vector3* inOrigins, const Vector3* inDirections, const float* inMaxDistances, CallbackType&& inCallback) const;
+
+		int32_t GetHeight() const { return m_rootNode == NullNode ? 0 : m_nodes[m_rootNode].m_height; }
+		size_t GetProxyCount() const { return m_proxyCount; }
+	private:
+		struct SNode
+		{
+			bool IsLeaf() const { return m_children[0] == NullNode; }
+
+			SAABB m_bounds;
+			uint32_t m_userData;
+
+			// The parent of nodes in the tree, the next free node of nodes in the free list
+			int32_t m_parentOrNext;
+			int32_t m_children[2];
+
+			// Leaves are 0, free nodes are -1
+			int32_t m_height;
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t inNodeIndex);
+
+		void InsertLeaf(int32_t inLeafIndex);
+		void RemoveLeaf(int32_t inLeafIndex);
+
+		// Walks from inNodeIndex to the root, refitting the boxes and rebalancing every node on the way
+		void RefitAncestors(int32_t inNodeIndex);
+
+		// Returns the index of the node that took inNodeIndex's place
+		int32_t Balance(int32_t inNodeIndex);
+	private:
+		eastl::vector<SNode> m_nodes;
+		int32_t m_rootNode;
+		int32_t m_freeList;
+		size_t m_proxyCount;
+	};
+
+	template <typename CallbackType>
+	void UDynamicAABBTree::Query(const SAABB& inBounds, CallbackType&& inCallback) const
+	{
+		if (m_rootNode == NullNode)
+		{
+			return;
+		}
+
+		// The tree is balanced, so the stack only goes to the heap for absurdly large trees
+		eastl::fixed_vector<int32_t, 256> nodeStack;
+		nodeStack.push_back(m_rootNode);
+
+		while (!nodeStack.empty())
+		{
+			const int32_t currentIndex = nodeStack.back();
+			nodeStack.pop_back();
+
+			const SNode& currentNode = m_nodes[currentIndex];
+			if (!currentNode.m_bounds.Overlaps(inBounds))
+			{
+				continue;
+			}
+
+			if (currentNode.IsLeaf())
+			{
+				if (!inCallback(currentIndex))
+				{
+					return;
+				}
+			}
+			else
+			{
+				nodeStack.push_back(currentNode.m_children[0]);
+				nodeStack.push_back(currentNode.m_children[1]);
+			}
+		}
+	}
+
+	template <typename CallbackType>
+	void UDynamicAABBTree::RayCast(const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, CallbackType&& inCallback) const
+	{
+		if (m_rootNode == NullNode)
+		{
+			return;
+		}
+
+		const Vector3 inverseDirection = SAABB::ComputeInverseDirection(inDirection);
+		float maxDistance = inMaxDistance;
+
+		eastl::fixed_vector<int32_t, 256> nodeStack;
+		nodeStack.push_back(m_rootNode);
+
+		while (!nodeStack.empty())
+		{
+			const int32_t currentIndex = nodeStack.back();
+			nodeStack.pop_back();
+
+			const SNode& currentNode = m_nodes[currentIndex];
+			if (!currentNode.m_bounds.IntersectsRay(inOrigin, inverseDirection, maxDistance))
+			{
+				continue;
+			}
+
+			if (currentNode.IsLeaf())
+			{
+				maxDistance = inCallback(currentIndex, maxDistance);
+
+				if (maxDistance <= 0.0f)
+				{
+					return;
+				}
+			}
+			else
+			{
+				nodeStack.push_back(currentNode.m_children[0]);
+				nodeStack.push_back(currentNode.m_children[1]);
+			}
+		}
+	}
+
+	template <typename CallbackType>
+	void UDynamicAABBTree::RayCastPacket(const Vector3* inOrigins, const Vector3* inDirections, const float* inMaxDistances, CallbackType&& inCallback) const
+	{
+		using namespace DirectX;
+
+		if (m_rootNode == NullNode)
+		{
+			return;
+		}
+
+		// One register per component, each lane holding one ray
+		Vector3 inverseDirections[RayPacketSize];
+		for (uint32_t i = 0; i < RayPacketSize; ++i)
+		{
+			inverseDirections[i] = SAABB::ComputeInverseDirection(inDirections[i]);
+		}
+
+		const XMVECTOR originX = XMVectorSet(inOrigins[0].x, inOrigins[1].x, inOrigins[2].x, inOrigins[3].x);
+		const XMVECTOR originY = XMVectorSet(inOrigins[0].y, inOrigins[1].y, inOrigins[2].y, inOrigins[3].y);
+		const XMVECTOR originZ = XMVectorSet(inOrigins[0].z, inOrigins[1].z, inOrigins[2].z, inOrigins[3].z);
+		const XMVECTOR inverseDirectionX = XMVectorSet(inverseDirections[0].x, inverseDirections[1].x, inverseDirections[2].x, inverseDirections[3].x);
+		const XMVECTOR inverseDirectionY = XMVectorSet(inverseDirections[0].y, inverseDirections[1].y, inverseDirections[2].y, inverseDirections[3].y);
+		const XMVECTOR inverseDirectionZ = XMVectorSet(inverseDirections[0].z, inverseDirections[1].z, inverseDirections[2].z, inverseDirections[3].z);
+		XMVECTOR maxDistances = XMVectorSet(inMaxDistances[0], inMaxDistances[1], inMaxDistances[2], inMaxDistances[3]);
+
+		eastl::fixed_vector<int32_t, 256> nodeStack;
+		nodeStack.push_back(m_rootNode);
+
+		while (!nodeStack.empty())
+		{
+			const int32_t currentIndex = nodeStack.back();
+			nodeStack.pop_back();
+
+			const SNode& currentNode = m_nodes[currentIndex];
+			const SAABB& nodeBounds = currentNode.m_bounds;
+
+			const XMVECTOR nearX = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(nodeBounds.m_min.x), originX), inverseDirectionX);
+			const XMVECTOR farX = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(nodeBounds.m_max.x), originX), inverseDirectionX);
+			const XMVECTOR nearY = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(nodeBounds.m_min.y), originY), inverseDirectionY);
+			const XMVECTOR farY = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(nodeBounds.m_max.y), originY), inverseDirectionY);
+			const XMVECTOR nearZ = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(nodeBounds.m_min.z), originZ), inverseDirectionZ);
+			const XMVECTOR farZ = XMVectorMultiply(XMVectorSubtract(XMVectorReplicate(nodeBounds.m_max.z), originZ), inverseDirectionZ);
+
+			const XMVECTOR entries = XMVectorMax(XMVectorMax(XMVectorMin(nearX, farX), XMVectorMin(nearY, farY)), XMVectorMax(XMVectorMin(nearZ, farZ), XMVectorZero()));
+			const XMVECTOR exits = XMVectorMin(XMVectorMin(XMVectorMax(nearX, farX), XMVectorMax(nearY, farY)), XMVectorMin(XMVectorMax(nearZ, farZ), maxDistances));
+
+			uint32_t comparison;
+			const XMVECTOR hitLanes = XMVectorGreaterOrEqualR(&comparison, exits, entries);
+
+			if (XMComparisonAllFalse(comparison))
+			{
+				continue;
+			}
+
+			if (!currentNode.IsLeaf())
+			{
+				nodeStack.push_back(currentNode.m_children[0]);
+				nodeStack.push_back(currentNode.m_children[1]);
+				continue;
+			}
+
+			for (uint32_t i = 0; i < RayPacketSize; ++i)
+			{
+				if (XMVectorGetIntByIndex(hitLanes, i) == 0)
+				{
+					continue;
+				}
+
+				const float newMaxDistance = inCallback(i, currentIndex, XMVectorGetByIndex(maxDistances, i));
+				maxDistances = XMVectorSetByIndex(maxDistances, newMaxDistance > 0.0f ? newMaxDistance : -1.0f, i);
+			}
+
+			// Every ray was stopped by its callback
+			uint32_t stoppedComparison;
+			XMVectorGreaterR(&stoppedComparison, XMVectorZero(), maxDistances);
+
+			if (XMComparisonAllTrue(stoppedComparison))
+			{
+				return;
+			}
+		}
+	}
+}
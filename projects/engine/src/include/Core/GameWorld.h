@@ -11,6 +11,7 @@
 #include <EASTL/hash_map.h>
 #include <EASTL/string.h>
 #include <EASTL/type_traits.h>
+#include <EASTL/vector.h>
 
 namespace MAD
 {
@@ -42,6 +43,11 @@ namespace MAD
 		eastl::shared_ptr<CommonAncestorEntityType> SpawnEntityDeferred(const TTypeInfo& inTypeInfo, const eastl::string& inWorldLayerName);
 
 		void FinalizeSpawnEntity(eastl::shared_ptr<AEntity> inEntity);
+
+		// Finalizes a batch of deferred entities in order. All of them are added to their layers and initialized before any of them begin play
+		void FinalizeSpawnEntities(const eastl::vector<eastl::shared_ptr<AEntity>>& inEntities);
+
+		OGameWorldLayer& FindOrAddWorldLayer(const eastl::string& inWorldLayerName);
 		
 		WorldLayerContainer_t GetWorldLayers() const { return m_worldLayers; }
 		const eastl::string& GetWorldName() const { return m_worldName; }
@@ -49,6 +55,9 @@ namespace MAD
 		const eastl::string& GetDefaultLayerName() const { return m_defaultLayerName; }
 		size_t GetEntityCount() const;
 
+		// Transforms of every entity, order independent. See USimulationChecksum
+		uint64_t ComputeSimulationChecksum() const;
+
 		void SetWorldName(const eastl::string& inWorldName) { if (!inWorldName.empty()) m_worldName = inWorldName; }
 		void SetWorldRelativePath(const eastl::string& inWorldRelativePath) { if (!inWorldRelativePath.empty()) m_worldRelativePath = inWorldRelativePath; }
 		void SetDefaultLayerName(const eastl::string& inDefaultLayerName) { m_defaultLayerName = inDefaultLayerName; }
@@ -90,23 +99,16 @@ namespace MAD
 	{
 		static_assert(eastl::is_base_of<AEntity, CommonAncestorEntityType>::value, "Error: You may only create entities that are of type AEntity or more derived"); // Make sure the user is only specifying children classes of AEntity
 
-		auto targetWorldLayerIter = m_worldLayers.find(inWorldLayerName);
-		
-		if (targetWorldLayerIter == m_worldLayers.end())
-		{
-			// Create new world layer and assign its owning world
-			targetWorldLayerIter = m_worldLayers.emplace(inWorldLayerName, OGameWorldLayer(this)).first;
-			targetWorldLayerIter->second.SetWorldLayerName(inWorldLayerName);
-		}
+		OGameWorldLayer& targetWorldLayer = FindOrAddWorldLayer(inWorldLayerName);
 
-		LOG(LogDefault, Log, "Spawning Entity of type %s at Layer: %s\n", inTypeInfo.GetTypeName(), targetWorldLayerIter->first.c_str());
+		LOG(LogDefault, Log, "Spawning Entity of type %s at Layer: %s\n", inTypeInfo.GetTypeName(), inWorldLayerName.c_str());
 
 		// Create default EntityType object through common creation API and assign the entity's owning world layer
 		eastl::shared_ptr<CommonAncestorEntityType> defaultEntityObject = CreateDefaultObject<CommonAncestorEntityType>(inTypeInfo, this);
 		
-		targetWorldLayerIter->second.AddEntityToLayer(defaultEntityObject);
+		targetWorldLayer.AddEntityToLayer(defaultEntityObject);
 
-		defaultEntityObject->SetOwningWorldLayer(targetWorldLayerIter->second);
+		defaultEntityObject->SetOwningWorldLayer(targetWorldLayer);
 
 		defaultEntityObject->PostInitialize();
 	
@@ -120,21 +122,14 @@ namespace MAD
 	{
 		static_assert(eastl::is_base_of<AEntity, CommonAncestorEntityType>::value, "Error: You may only create entities that are of type AEntity or more derived"); // Make sure the user is only specifying children classes of AEntity
 
-		auto targetWorldLayerIter = m_worldLayers.find(inWorldLayerName);
-
-		if (targetWorldLayerIter == m_worldLayers.end())
-		{
-			// Create new world layer and assign its owning world
-			targetWorldLayerIter = m_worldLayers.emplace(inWorldLayerName, OGameWorldLayer(this)).first;
-			targetWorldLayerIter->second.SetWorldLayerName(inWorldLayerName);
-		}
+		OGameWorldLayer& targetWorldLayer = FindOrAddWorldLayer(inWorldLayerName);
 
-		LOG(LogDefault, Log, "Spawning deferred Entity of type %s at Layer: %s\n", inTypeInfo.GetTypeName(), targetWorldLayerIter->first.c_str());
+		LOG(LogDefault, Log, "Spawning deferred Entity of type %s at Layer: %s\n", inTypeInfo.GetTypeName(), inWorldLayerName.c_str());
 
 		// Create default EntityType object through common creation API and assign the entity's owning world layer
-		eastl::shared_ptr<CommonAncestorEntityType> defaultEntityObject = CreateDefaultObject<CommonAncestorEntityType>(inTypeInfo, this);;
+		eastl::shared_ptr<CommonAncestorEntityType> defaultEntityObject = CreateDefaultObject<CommonAncestorEntityType>(inTypeInfo, this);
 
-		defaultEntityObject->SetOwningWorldLayer(targetWorldLayerIter->second);
+		defaultEntityObject->SetOwningWorldLayer(targetWorldLayer);
 
 		return defaultEntityObject;
 	}
@@ -27,6 +27,9 @@ namespace MAD
 		eastl::vector<eastl::shared_ptr<AEntity>> GetLayerEntities() const { return m_layerEntities; }
 		inline const eastl::string& GetLayerName() const { return m_layerName; }
 		inline size_t GetEntityCount() const { return m_layerEntities.size(); }
+
+		// Order independent, see USimulationChecksum
+		uint64_t ComputeSimulationChecksum() const;
 	private:
 		eastl::string m_layerName;
 		eastl::vector<eastl::shared_ptr<AEntity>> m_layerEntities;
@@ -15,6 +15,7 @@ namespace MAD
 		
 		virtual void PostInitializeComponents() override;
 		virtual void Load(const UGameWorldLoader& inLoader, const class UObjectValue& inPropertyObj) override;
+		virtual bool IsLoadThreadSafe() const override { return true; } // Meshes are requested through the asset cache
 		virtual void UpdateComponent(float inDeltaTime) override;
 
 		bool LoadFrom(const eastl::string& inAssetName);
@@ -26,8 +27,11 @@ namespace MAD
 	
 	private:
 		void ConstructDrawItem() const;
+		void QueueStaticDrawItems() const;
+		void OnPendingMeshLoaded();
 	private:
 		SMeshInstance m_meshInstance;
+		TAssetHandle<UMesh> m_pendingMesh;
 		bool m_bIsDynamic;
 	};
 }
@@ -2,15 +2,69 @@
 
 #include "Core/Component.h"
 #include "Core/Entity.h"
+#include "Core/RigidBodyState.h"
 
 namespace MAD
 {
+	/*
+		Rigid body simulated by the physics world. Bodies with a mass are dynamic: the physics world owns their transform and
+		writes it back into the component every fixed step, so it should be the root component of its entity. Bodies without
+		a mass are kinematic: they follow whatever moves the component and push dynamic bodies out of the way. Triangle mesh
+		bodies ("shape": "mesh", with the mesh's path in "collisionMesh") are always kinematic.
+	*/
 	class CPhysicsComponent : public UComponent
 	{
 		MAD_DECLARE_COMPONENT(CPhysicsComponent, UComponent)
 	public:
 		explicit CPhysicsComponent(OGameWorld* inOwningWorld);
 
+		virtual void OnBeginPlay() override;
+		virtual void Load(const UGameWorldLoader& inLoader, const class UObjectValue& inPropertyObj) override;
 		virtual void UpdateComponent(float inDeltaTime) override;
+
+		// The shape before the component's world scale is applied
+		const SPhysicsShape& GetShape() const { return m_shape; }
+		void SetShape(const SPhysicsShape& inShape) { m_shape = inShape; }
+
+		bool IsDynamic() const { return m_mass > 0.0f; }
+
+		Vector3 GetLinearVelocity() const;
+		void SetLinearVelocity(const Vector3& inLinearVelocity);
+		void AddImpulse(const Vector3& inImpulse);
+
+		// Bodies fall asleep once they and everything they touch have been at rest for a while. Changing their velocity wakes them
+		bool IsAwake() const;
+		void WakeUp();
+
+		// Continuous bodies are swept against static and kinematic bodies, so that they can't pass through them no matter how fast
+		// they go. Only worth it for small fast bodies like projectiles, and only dynamic bodies can be continuous
+		bool IsContinuous() const { return m_isContinuous; }
+		void SetContinuous(bool inIsContinuous);
+
+		// Scene queries only hit the bodies whose query layer is in their filter's layer mask
+		uint32_t GetQueryLayer() const { return m_queryLayer; }
+		void SetQueryLayer(uint32_t inQueryLayer);
+
+		// Description of the body as it is right now, used when it's added to the physics world
+		SRigidBodyDescription GetBodyDescription() const;
+
+		// World space box that contains the body's rotated and scaled shape
+		SAABB GetWorldBounds() const;
+	private:
+		friend class UPhysicsWorld;
+
+		SPhysicsShape m_shape;
+		float m_mass;
+		float m_friction;
+		float m_restitution;
+		float m_gravityScale;
+		bool m_isContinuous;
+		uint32_t m_queryLayer;
+
+		// Until the body is registered, its velocity is kept here
+		Vector3 m_linearVelocity;
+
+		// Kept up to date by the physics world
+		uint32_t m_bodyIndex;
 	};
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/vector.h>
+
+#include "Core/PhysicsNarrowphase.h"
+#include "Core/RigidBodyState.h"
+
+namespace MAD
+{
+	// Ranges into the island builder's body and manifold lists
+	struct SPhysicsIsland
+	{
+		uint32_t m_firstBody;
+		uint32_t m_bodyCount;
+		uint32_t m_firstManifold;
+		uint32_t m_manifoldCount;
+		bool m_isAwake;
+	};
+
+	/*
+		Groups the dynamic bodies into islands: bodies that touch each other, directly or through other dynamic bodies.
+		Bodies that aren't dynamic don't join islands because contacts can't push them, so a floor doesn't merge everything
+		resting on it into one island. Islands share no dynamic body, so they can be solved in parallel and sleep as a whole.
+	*/
+	class UPhysicsIslandBuilder
+	{
+	public:
+		// An island is awake if any of its bodies is awake, or if one of its contacts is with a moving kinematic body
+		void Build(const SRigidBodyState& inBodies, const eastl::vector<SContactManifold>& inManifolds);
+
+		const eastl::vector<SPhysicsIsland>& GetIslands() const { return m_islands; }
+
+		const uint32_t* GetIslandBodies(const SPhysicsIsland& inIsland) const { return m_islandBodies.data() + inIsland.m_firstBody; }
+		const uint32_t* GetIslandManifolds(const SPhysicsIsland& inIsland) const { return m_islandManifolds.data() + inIsland.m_firstManifold; }
+	private:
+		uint32_t FindRoot(uint32_t inBodyIndex);
+		void MergeIslands(uint32_t inBodyA, uint32_t inBodyB);
+	private:
+		// Union-find forest over the body indices
+		eastl::vector<uint32_t> m_parents;
+		eastl::vector<uint32_t> m_bodyIslands;
+
+		eastl::vector<SPhysicsIsland> m_islands;
+		eastl::vector<uint32_t> m_islandBodies;
+		eastl::vector<uint32_t> m_islandManifolds;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Core/PhysicsShape.h"
+
+namespace MAD
+{
+	struct SContactPoint
+	{
+		Vector3 m_position; // World space, halfway between the two surfaces
+		float m_penetration;
+
+		// Where the contact sits on each body, used to match contacts between ticks
+		Vector3 m_localAnchorA;
+		Vector3 m_localAnchorB;
+
+		// Accumulated by the solver and carried over to the next tick to warm start it
+		float m_normalImpulse;
+		float m_tangentImpulse[2];
+	};
+
+	// Up to 4 contacts that share a normal, enough to hold a box resting on a face still
+	struct SContactManifold
+	{
+		static const uint32_t MaxPoints = 4;
+
+		// Broadphase pair the manifold was generated for
+		int32_t m_proxyA;
+		int32_t m_proxyB;
+
+		uint32_t m_bodyA;
+		uint32_t m_bodyB;
+
+		Vector3 m_normal; // From A to B
+		SContactPoint m_points[MaxPoints];
+		uint32_t m_pointCount;
+
+		float m_friction;
+		float m_restitution;
+	};
+
+	struct SCollisionBody
+	{
+		const SPhysicsShape* m_shape;
+		Vector3 m_position;
+		Quaternion m_rotation;
+	};
+
+	/*
+		Generates the contacts between two shapes. Fills in the normal, the positions and penetrations of outManifold, and leaves
+		the rest of it alone. Box against box uses the separating axis test and clips the incident face against the reference
+		face, everything involving spheres and capsules reduces to finding the closest points between points and segments.
+		Shapes against triangle meshes collide with each triangle the same way, and merge the contacts into one manifold.
+	*/
+	class UPhysicsNarrowphase
+	{
+	public:
+		UPhysicsNarrowphase() = delete;
+
+		static bool Collide(const SCollisionBody& inBodyA, const SCollisionBody& inBodyB, SContactManifold& outManifold);
+	};
+}
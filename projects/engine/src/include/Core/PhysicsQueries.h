@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/weak_ptr.h>
+
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	class AEntity;
+	class CPhysicsComponent;
+	class TTypeInfo;
+
+	struct SRay
+	{
+		SRay() : m_maxDistance(0.0f) {}
+		SRay(const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance) : m_origin(inOrigin), m_direction(inDirection), m_maxDistance(inMaxDistance) {}
+
+		Vector3 m_origin;
+		Vector3 m_direction; // Normalized
+		float m_maxDistance;
+	};
+
+	// Which bodies a scene query can hit. The default filter lets everything through
+	struct SQueryFilter
+	{
+		static const uint32_t AllLayers = 0xFFFFFFFF;
+
+		SQueryFilter() : m_layerMask(AllLayers), m_requiredComponentType(nullptr), m_ignoredEntity(nullptr) {}
+
+		uint32_t m_layerMask; // Bit N lets through the bodies on query layer N
+		const TTypeInfo* m_requiredComponentType; // When set, only bodies whose entity has a component of this type
+		const AEntity* m_ignoredEntity; // Usually the entity doing the query, so that it doesn't hit itself
+	};
+
+	struct SQueryHit
+	{
+		SQueryHit() : m_hasHit(false), m_distance(0.0f), m_penetration(0.0f) {}
+
+		bool m_hasHit;
+		eastl::weak_ptr<CPhysicsComponent> m_body;
+		Vector3 m_position;
+		Vector3 m_normal; // Points out of the body that was hit
+		float m_distance; // Along the ray or sweep, 0 when it started inside the body
+		float m_penetration; // How far the shape has to move along the normal to leave the body. Only set by overlaps
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/shared_ptr.h>
+#include <EASTL/string.h>
+
+#include "Core/DynamicAABBTree.h"
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	class UCollisionMesh;
+
+	enum class EPhysicsShapeType : uint8_t
+	{
+		Sphere,
+		Box,
+		Capsule, // Along the local up axis
+		TriangleMesh // Static bodies only, it has no volume
+	};
+
+	// Collision shape of a body, centered on the body. Dimensions are in world units, already scaled
+	struct SPhysicsShape
+	{
+		SPhysicsShape() : m_type(EPhysicsShapeType::Box), m_halfExtents(50.0f, 50.0f, 50.0f), m_radius(50.0f), m_halfHeight(50.0f), m_meshScale(1.0f) {}
+
+		EPhysicsShapeType m_type;
+		Vector3 m_halfExtents; // Box
+		float m_radius; // Sphere and capsule
+		float m_halfHeight; // Capsule, from the center to the center of either cap
+
+		// Triangle mesh, in the mesh's object space and scaled by m_meshScale
+		eastl::shared_ptr<const UCollisionMesh> m_collisionMesh;
+		float m_meshScale;
+
+		SPhysicsShape Scaled(float inScale) const;
+
+		SAABB ComputeBounds(const Vector3& inPosition, const Quaternion& inRotation) const;
+
+		// Diagonal of the inverse inertia tensor in the shape's local space, for a solid body of uniform density
+		Vector3 ComputeLocalInverseInertia(float inMass) const;
+
+		// Distance along the normalized ray to where it enters the shape, and the world space surface normal there.
+		// Rays that start inside the shape hit at distance 0, with the normal facing back along the ray. Triangle meshes have
+		// no inside, they're hit wherever the ray first crosses one of their triangles
+		bool Raycast(const Vector3& inPosition, const Quaternion& inRotation, const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance, Vector3& outNormal) const;
+
+		// Radius of the largest sphere around the center that fits inside the shape
+		float GetInnerRadius() const;
+
+		// The shape grown by inRadius in every direction. Boxes keep their sharp corners, so they grow a bit more than that there.
+		// Triangle meshes can't be grown and are returned as they are
+		SPhysicsShape Inflated(float inRadius) const;
+
+		// Distance the center of a sphere of inRadius travels along the normalized ray before it touches the shape, 0 if it
+		// touches it to begin with. Triangle meshes stop the sphere inRadius away from the plane of the triangle the ray
+		// crosses, so a sphere whose center passes just beside a triangle's edge isn't stopped by it
+		bool SweepSphere(const Vector3& inPosition, const Quaternion& inRotation, const Vector3& inOrigin, const Vector3& inDirection, float inRadius, float inMaxDistance, float& outDistance, Vector3& outNormal) const;
+
+		static bool ParseShapeType(const eastl::string& inShapeName, EPhysicsShapeType& outShapeType);
+	};
+}
@@ -1,7 +1,14 @@
 #pragma once
 
 #include "Core/Object.h"
+#include "Core/ContactSolver.h"
+#include "Core/DynamicAABBTree.h"
+#include "Core/PhysicsIslands.h"
+#include "Core/PhysicsNarrowphase.h"
+#include "Core/PhysicsQueries.h"
+#include "Core/RigidBodyState.h"
 
+#include <EASTL/shared_ptr.h>
 #include <EASTL/vector.h>
 #include <EASTL/weak_ptr.h>
 
@@ -9,19 +16,162 @@ namespace MAD
 {
 	class CPhysicsComponent;
 
-	// The PhysicsWorld is responsible for performing collision detection and collision resolution (where the PhysicsComponent is responsible for simulating the rigid bodies)
+	// A pair of bodies whose fat boxes overlap. m_proxyA is always the one with the lower order key of the two
+	struct SBroadphasePair
+	{
+		int32_t m_proxyA;
+		int32_t m_proxyB;
+
+		bool operator==(const SBroadphasePair& inOther) const { return m_proxyA == inOther.m_proxyA && m_proxyB == inOther.m_proxyB; }
+	};
+
+	/*
+		The PhysicsWorld is responsible for performing collision detection and collision resolution (where the PhysicsComponent is responsible for simulating the rigid bodies)
+
+		Contacts are solved in the order of their pairs, which would follow the broadphase's proxy IDs and so depend on the order
+		the bodies were registered in. Pairs are sorted by an order key per body instead, that's the same on the server and its
+		clients: network spawned bodies are keyed by their entity's net ID, loaded ones by the order they were loaded in.
+	*/
 	class UPhysicsWorld : public UObject
 	{
 		MAD_DECLARE_CLASS(UPhysicsWorld, UObject)
 	public:
 		using PhysicsBody_t = CPhysicsComponent;
 		using PhysicsBodyWeakPtr_t = eastl::weak_ptr<PhysicsBody_t>;
-		using PhysicsComponentContainer_t = eastl::vector<PhysicsBodyWeakPtr_t>;
+		using BroadphasePairContainer_t = eastl::vector<SBroadphasePair>;
+		using ContactManifoldContainer_t = eastl::vector<SContactManifold>;
+
+		static const uint32_t InvalidBodyIndex = 0xFFFFFFFF;
 	public:
 		explicit UPhysicsWorld(OGameWorld* inOwningWorld);
 
-		void SimulatePhysics();
+		// Bodies are unregistered automatically once their component is destroyed
+		void RegisterPhysicsComponent(PhysicsBodyWeakPtr_t inPhysicsComponent);
+
+		// Runs one fixed step: integrates the bodies, finds and solves their contacts, and moves the awake dynamic bodies' components
+		void SimulatePhysics(float inDeltaTime);
+
+		const Vector3& GetGravity() const { return m_gravity; }
+		void SetGravity(const Vector3& inGravity) { m_gravity = inGravity; }
+
+		Vector3 GetLinearVelocity(uint32_t inBodyIndex) const { return m_bodies.GetLinearVelocity(inBodyIndex); }
+		void SetLinearVelocity(uint32_t inBodyIndex, const Vector3& inLinearVelocity);
+		void AddImpulse(uint32_t inBodyIndex, const Vector3& inImpulse);
+
+		bool IsAwake(uint32_t inBodyIndex) const { return m_bodies.IsAwake(inBodyIndex); }
+		void WakeUp(uint32_t inBodyIndex);
+
+		void SetContinuous(uint32_t inBodyIndex, bool inIsContinuous) { m_bodies.m_isContinuous[inBodyIndex] = m_bodies.IsDynamic(inBodyIndex) && inIsContinuous; }
+
+		// Query layers only affect scene queries, bodies on any layers still collide with each other
+		void SetQueryLayer(uint32_t inBodyIndex, uint32_t inQueryLayer) { m_physicsComponents[inBodyIndex].m_queryLayer = inQueryLayer; }
+
+		/*
+			Scene queries test against the bodies as of the last SimulatePhysics. They only read the physics world, so any number
+			of them can run at the same time from any thread (e.g. parallel component updates), as long as SimulatePhysics
+			isn't running and no body is being registered or having its velocity or query layer changed.
+		*/
+		bool Raycast(const SRay& inRay, SQueryHit& outHit, const SQueryFilter& inFilter = SQueryFilter()) const;
+
+		// Closest hit of every ray. The rays go through the broadphase in packets, which is much cheaper than a Raycast per ray
+		void RaycastBatch(const SRay* inRays, uint32_t inRayCount, SQueryHit* outHits, const SQueryFilter& inFilter = SQueryFilter()) const;
+
+		// First body the shape touches when moved from inStart to inEnd without rotating. The hit distance is the last one at
+		// which the shape was still free. The shape advances in steps of its inner radius, so it can slip past the very
+		// corner of a body thinner than that
+		bool Sweep(const SPhysicsShape& inShape, const Quaternion& inRotation, const Vector3& inStart, const Vector3& inEnd, SQueryHit& outHit, const SQueryFilter& inFilter = SQueryFilter()) const;
+
+		// Appends every body the shape overlaps to outHits and returns how many there were
+		uint32_t Overlap(const SPhysicsShape& inShape, const Vector3& inPosition, const Quaternion& inRotation, eastl::vector<SQueryHit>& outHits, const SQueryFilter& inFilter = SQueryFilter()) const;
+
+		// Sorted by the bodies' order keys and free of duplicates. Valid until the next SimulatePhysics
+		const BroadphasePairContainer_t& GetOverlapPairs() const { return m_overlapPairs; }
+
+		// Contacts of the pairs that touched during the last SimulatePhysics, in the same order as the overlap pairs
+		const ContactManifoldContainer_t& GetContactManifolds() const { return m_manifolds; }
+
+		// Null if the body was destroyed since the last SimulatePhysics
+		eastl::shared_ptr<PhysicsBody_t> GetProxyBody(int32_t inProxyID) const;
+
+		const UDynamicAABBTree& GetBroadphase() const { return m_broadphase; }
+
+		// State of every body, order independent. See USimulationChecksum
+		uint64_t ComputeSimulationChecksum() const;
+	private:
+		struct SPhysicsBodyProxy
+		{
+			PhysicsBodyWeakPtr_t m_body;
+			int32_t m_proxyID;
+
+			// Transform of the component when it was last read or written, to tell when gameplay moved it
+			Vector3 m_lastTranslation;
+			Quaternion m_lastRotation;
+
+			uint32_t m_queryLayer;
+		};
+
+		using PhysicsComponentContainer_t = eastl::vector<SPhysicsBodyProxy>;
+
+		void SyncBodies(float inDeltaTime);
+		void UpdateBroadphase(float inDeltaTime);
+		void UpdateOverlapPairs();
+		void UpdateContacts();
+		void UpdateIslands();
+		void SolveIslands(float inDeltaTime);
+		void UpdateIslandSleep(const SPhysicsIsland& inIsland);
+		void GatherContinuousBodies(float inDeltaTime);
+		void SolveTimesOfImpact();
+		void WriteBackTransforms();
+
+		uint64_t GetOrderKey(const PhysicsBody_t& inPhysicsComponent);
+		bool IsPairBefore(const SBroadphasePair& inLeft, const SBroadphasePair& inRight) const;
+
+		void MarkProxyDirty(int32_t inProxyID);
+		void RemoveBody(uint32_t inBodyIndex);
+
+		bool PassesFilter(uint32_t inBodyIndex, const SQueryFilter& inFilter) const;
+
+		// Returns the distance the ray is clipped to, for the broadphase ray casts
+		float RaycastBody(uint32_t inBodyIndex, const SRay& inRay, float inMaxDistance, const SQueryFilter& inFilter, SQueryHit& inOutHit, uint32_t& inOutHitBody) const;
 	private:
+		// The body state, the components and the broadphase user data all use the same body index
 		PhysicsComponentContainer_t m_physicsComponents;
+		SRigidBodyState m_bodies;
+		Vector3 m_gravity;
+
+		UDynamicAABBTree m_broadphase;
+
+		// Indexed by proxy ID
+		eastl::vector<uint64_t> m_proxyOrderKeys;
+		uint64_t m_nextLoadedOrderKey;
+
+		// Proxies that were created, reinserted or destroyed this tick. Their pairs are the only ones that can change
+		eastl::vector<int32_t> m_dirtyProxies;
+		eastl::vector<uint8_t> m_isProxyDirty;
+
+		// One pair list per job system thread, so that the dirty proxies can be queried in parallel
+		eastl::vector<BroadphasePairContainer_t> m_threadPairs;
+
+		BroadphasePairContainer_t m_overlapPairs;
+
+		// The manifolds of the previous tick hold the impulses the solver is warm started with
+		ContactManifoldContainer_t m_manifolds;
+		ContactManifoldContainer_t m_previousManifolds;
+		ContactManifoldContainer_t m_candidateManifolds;
+
+		UPhysicsIslandBuilder m_islandBuilder;
+		eastl::vector<uint32_t> m_awakeIslands;
+
+		// One solver per job system thread, since a solver keeps its constraints between calls
+		eastl::vector<UContactSolver> m_contactSolvers;
+
+		// Continuous bodies fast enough to need a sweep this tick, and where they were before their positions were integrated
+		struct SContinuousBody
+		{
+			uint32_t m_bodyIndex;
+			Vector3 m_startPosition;
+		};
+
+		eastl::vector<SContinuousBody> m_continuousBodies;
 	};
 }
@@ -12,6 +12,8 @@ namespace MAD
 		explicit CPointLightComponent(OGameWorld* inOwningWorld);
 
 		virtual void Load(const UGameWorldLoader& inLoader, const class UObjectValue& inPropertyObj) override;
+		virtual bool IsLoadThreadSafe() const override { return true; }
+		virtual bool IsHotReloadable() const override { return true; }
 		virtual void UpdateComponent(float inDeltaTime) override;
 
 		inline void SetEnabled(bool inEnabled) { m_pointLight.m_isLightEnabled = inEnabled; }
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/vector.h>
+
+#include "Core/PhysicsShape.h"
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	struct SRigidBodyDescription
+	{
+		SPhysicsShape m_shape;
+		Vector3 m_position;
+		Quaternion m_rotation;
+		Vector3 m_linearVelocity;
+		float m_mass; // 0 for bodies that are moved by their component instead of the simulation
+		float m_friction;
+		float m_restitution;
+		float m_gravityScale;
+		bool m_isContinuous; // Swept against static and kinematic bodies every step, so that it can't pass through them
+	};
+
+	/*
+		State of every rigid body in the physics world, one array per scalar so that the integration loops run over plain
+		float arrays the compiler can vectorize. Bodies are referred to by index, removing one moves the last body into its slot.
+	*/
+	struct SRigidBodyState
+	{
+		size_t GetBodyCount() const { return m_inverseMass.size(); }
+
+		// Returns the index of the new body
+		uint32_t AddBody(const SRigidBodyDescription& inDescription);
+		void RemoveBody(uint32_t inBodyIndex);
+
+		bool IsDynamic(uint32_t inBodyIndex) const { return m_inverseMass[inBodyIndex] > 0.0f; }
+
+		// Sleeping dynamic bodies are skipped by integration. Bodies that aren't dynamic are awake while their component moves them
+		bool IsAwake(uint32_t inBodyIndex) const { return m_isAwake[inBodyIndex] != 0; }
+		void WakeUp(uint32_t inBodyIndex);
+		void PutToSleep(uint32_t inBodyIndex);
+
+		// Kinetic energy divided by mass, so that the same sleep threshold works for light and heavy bodies
+		float GetNormalizedKineticEnergy(uint32_t inBodyIndex) const;
+
+		Vector3 GetPosition(uint32_t inBodyIndex) const { return Vector3(m_positionX[inBodyIndex], m_positionY[inBodyIndex], m_positionZ[inBodyIndex]); }
+		Quaternion GetRotation(uint32_t inBodyIndex) const { return Quaternion(m_rotationX[inBodyIndex], m_rotationY[inBodyIndex], m_rotationZ[inBodyIndex], m_rotationW[inBodyIndex]); }
+		Vector3 GetLinearVelocity(uint32_t inBodyIndex) const { return Vector3(m_linearVelocityX[inBodyIndex], m_linearVelocityY[inBodyIndex], m_linearVelocityZ[inBodyIndex]); }
+		Vector3 GetAngularVelocity(uint32_t inBodyIndex) const { return Vector3(m_angularVelocityX[inBodyIndex], m_angularVelocityY[inBodyIndex], m_angularVelocityZ[inBodyIndex]); }
+
+		void SetPosition(uint32_t inBodyIndex, const Vector3& inPosition);
+		void SetRotation(uint32_t inBodyIndex, const Quaternion& inRotation);
+		void SetLinearVelocity(uint32_t inBodyIndex, const Vector3& inLinearVelocity);
+		void SetAngularVelocity(uint32_t inBodyIndex, const Vector3& inAngularVelocity);
+
+		// Applies gravity and damping to the velocities of the awake dynamic bodies
+		void IntegrateVelocities(const Vector3& inGravity, float inDeltaTime);
+
+		// Moves every body along its velocity
+		void IntegratePositions(float inDeltaTime);
+
+		// World space inverse inertia tensors for the solver, from the current rotations of the awake bodies
+		void UpdateWorldInverseInertia();
+
+		eastl::vector<float> m_positionX, m_positionY, m_positionZ;
+		eastl::vector<float> m_rotationX, m_rotationY, m_rotationZ, m_rotationW;
+		eastl::vector<float> m_linearVelocityX, m_linearVelocityY, m_linearVelocityZ;
+		eastl::vector<float> m_angularVelocityX, m_angularVelocityY, m_angularVelocityZ;
+
+		eastl::vector<float> m_inverseMass;
+		eastl::vector<float> m_gravityScale; // 0 for bodies that aren't dynamic, so that integration doesn't need to branch
+		eastl::vector<float> m_localInverseInertiaX, m_localInverseInertiaY, m_localInverseInertiaZ;
+		eastl::vector<Matrix> m_worldInverseInertia;
+
+		eastl::vector<uint8_t> m_isContinuous;
+		eastl::vector<uint8_t> m_isAwake;
+		eastl::vector<uint32_t> m_sleepTicks; // Consecutive ticks the body has been slow enough to sleep
+
+		eastl::vector<SPhysicsShape> m_shapes;
+		eastl::vector<float> m_friction;
+		eastl::vector<float> m_restitution;
+	};
+}
@@ -52,6 +52,19 @@ namespace MAD
 		return inA + (inB - inA) * Saturate(inT);
 	}
 
+	/*
+		The C runtime's sinf and cosf are implemented differently on every platform, so they can't be part of a simulation that
+		has to step to the same bits on the server and its clients. These only use float adds and multiplies in a fixed order,
+		which gives the same result anywhere the floating point is strict (see the deterministic premake option). Accurate to
+		a couple of ulps for angles within +-8192 radians.
+
+		Square roots don't need a replacement: IEEE 754 requires sqrtf to be correctly rounded. Estimates like the reciprocal
+		square root instructions do differ between CPUs, and are kept out of the simulation.
+	*/
+	void DeterministicSinCos(float inRadians, float& outSin, float& outCos);
+	float DeterministicSin(float inRadians);
+	float DeterministicCos(float inRadians);
+
 	float ClampAxis(float inAngle);
 	float NormalizeAxis(float inAngle);
 	Quaternion FromEulerAngles(float inPitch, float inYaw, float inRoll);
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	/*
+		Hash of simulation state, to tell whether two machines stepped the simulation to the same bits. Floats are hashed by
+		their bits, so 0 and -0 count as different even though they compare equal.
+
+		The order things are added in matters. Sets without an order that's the same everywhere (the entities of a layer, the
+		bodies of the physics world) are combined by adding up the checksums of their elements instead.
+	*/
+	class USimulationChecksum
+	{
+	public:
+		USimulationChecksum();
+
+		void Add(const void* inData, size_t inSize);
+		void Add(uint64_t inValue) { Add(&inValue, sizeof(inValue)); }
+		void Add(uint32_t inValue) { Add(&inValue, sizeof(inValue)); }
+		void Add(float inValue) { Add(&inValue, sizeof(inValue)); }
+		void Add(bool inValue) { Add(static_cast<uint32_t>(inValue)); }
+		void Add(const Vector3& inValue);
+		void Add(const Quaternion& inValue);
+
+		uint64_t GetValue() const { return m_value; }
+	private:
+		uint64_t m_value;
+	};
+}
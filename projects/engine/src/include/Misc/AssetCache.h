@@ -1,8 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include <EASTL/hash_map.h>
 #include <EASTL/shared_ptr.h>
+#include <EASTL/sort.h>
 #include <EASTL/string.h>
+#include <EASTL/vector.h>
 
 #include "Misc/Assert.h"
 #include "Misc/Logging.h"
@@ -11,7 +16,58 @@ namespace MAD
 {
 	DECLARE_LOG_CATEGORY(LogAssetCache);
 
-	// Defines a simple interface for loading and caching resources of type T
+	enum class EAssetLoadState : uint8_t
+	{
+		Loading,
+		Loaded,
+		Failed
+	};
+
+	// State of one in-flight load, shared by every handle to it
+	template <class T>
+	struct SAssetLoadRequest
+	{
+		explicit SAssetLoadRequest(const eastl::string& inResourcePath) : m_resourcePath(inResourcePath), m_state(EAssetLoadState::Loading) {}
+
+		const eastl::string m_resourcePath;
+		eastl::shared_ptr<T> m_resource; // Only written before m_state leaves Loading
+		std::atomic<EAssetLoadState> m_state;
+	};
+
+	/*
+	 * Handle to a resource that may still be loading, see UAssetCache::FindOrBeginLoad. Cheap to copy, and safe to poll
+	 * from any thread.
+	 */
+	template <class T>
+	class TAssetHandle
+	{
+	public:
+		TAssetHandle() {}
+		explicit TAssetHandle(eastl::shared_ptr<SAssetLoadRequest<T>> inRequest) : m_request(eastl::move(inRequest)) {}
+
+		bool IsValid() const { return m_request != nullptr; }
+		bool IsLoading() const { return m_request && m_request->m_state.load(std::memory_order_acquire) == EAssetLoadState::Loading; }
+		bool IsLoaded() const { return m_request && m_request->m_state.load(std::memory_order_acquire) == EAssetLoadState::Loaded; }
+		bool HasFailed() const { return m_request && m_request->m_state.load(std::memory_order_acquire) == EAssetLoadState::Failed; }
+
+		// Null until the load has finished successfully
+		eastl::shared_ptr<T> Get() const { return IsLoaded() ? m_request->m_resource : nullptr; }
+
+		const eastl::string& GetPath() const { return m_request->m_resourcePath; }
+
+	private:
+		friend class UAssetCache;
+
+		eastl::shared_ptr<SAssetLoadRequest<T>> m_request;
+	};
+
+	/*
+	 * Defines a simple interface for loading and caching resources of type T. All operations are thread safe.
+	 *
+	 * Cached types must implement `size_t GetMemorySize() const`, which is used to account each type's memory against its
+	 * budget. Once a type goes over budget, the least recently used resources that are only referenced by the cache are
+	 * evicted on the next Tick.
+	 */
 	class UAssetCache
 	{
 	public:
@@ -42,47 +98,292 @@ namespace MAD
 		template <class T>
 		static eastl::shared_ptr<T> GetCachedResource(const eastl::string& inResourcePath);
 
+		/*
+		 * Starts tracking an asynchronous load of the resource at the given path. If the resource is already cached the
+		 * returned handle is loaded, and if it's already being loaded the handle shares that load. Otherwise outIsNewLoad
+		 * is set and the caller must eventually finish the load with CompleteLoad.
+		 */
+		template <class T>
+		static TAssetHandle<T> FindOrBeginLoad(const eastl::string& inResourcePath, bool& outIsNewLoad);
+
+		// Finishes a load started by FindOrBeginLoad and caches the resource. A null resource marks the load as failed
+		template <class T>
+		static void CompleteLoad(const TAssetHandle<T>& inHandle, eastl::shared_ptr<T> inResource);
+
+		// Re-reads the size of the resource cached at the given path, for resources that grow or shrink after they're cached
+		template <class T>
+		static void UpdateMemorySize(const eastl::string& inResourcePath);
+
+		// Names resources of type T in logs and dumps, and sets how many bytes of them may stay cached. 0 means unlimited
+		template <class T>
+		static void SetMemoryBudget(const char* inTypeName, size_t inBudgetBytes);
+
+		// Advances the clock used for least-recently-used eviction and trims every type that's over budget. Main thread only
+		static void Tick();
+
+		// Evicts every resource that's only referenced by the cache, regardless of budgets
+		static void EvictUnreferenced();
+
+		// Logs every cached resource with its size, reference count and the frame it was last used on
+		static void DumpContents();
+
 	private:
 		static eastl::string s_assetRootPath;
+		static std::atomic<uint64_t> s_currentFrame;
+
+		// Type-erased view of a per-type cache, for the operations that visit all of them
+		struct SCacheStorageBase
+		{
+			virtual ~SCacheStorageBase() {}
+
+			virtual void Evict(bool inEvictAllUnreferenced) = 0;
+			virtual void Dump() = 0;
+		};
+
+		template <class T>
+		struct SCacheEntry
+		{
+			eastl::shared_ptr<T> m_resource;
+			size_t m_memorySize;
+			uint64_t m_lastUseFrame;
+		};
+
+		template <class T>
+		struct SCacheStorage : public SCacheStorageBase
+		{
+			using CacheMap_t = eastl::hash_map<eastl::string, SCacheEntry<T>>;
+
+			SCacheStorage() { RegisterStorage(this); }
+
+			virtual void Evict(bool inEvictAllUnreferenced) override;
+			virtual void Dump() override;
+
+			// Stores inResource unless something is cached under the path already, and returns the cached resource
+			eastl::shared_ptr<T> InsertIfMissing(const eastl::string& inResourcePath, const eastl::shared_ptr<T>& inResource);
+
+			std::mutex m_mutex;
+			CacheMap_t m_cache;
+			eastl::hash_map<eastl::string, eastl::shared_ptr<SAssetLoadRequest<T>>> m_pendingLoads;
+
+			const char* m_typeName = "Asset";
+			size_t m_memoryBudget = 0;
+			size_t m_memoryUsage = 0;
+			bool m_wasOverBudgetReported = false;
+		};
 
 		template <class T>
-		static eastl::shared_ptr<T> CacheOp(const eastl::string& inResourcePath, eastl::shared_ptr<T> inResource);
+		static SCacheStorage<T>& GetStorage()
+		{
+			static SCacheStorage<T> s_storage;
+			return s_storage;
+		}
+
+		// Storages register themselves the first time their type is used, which may be from a loader thread
+		static void RegisterStorage(SCacheStorageBase* inStorage);
+
+		static std::mutex s_storageRegistryMutex;
+		static eastl::vector<SCacheStorageBase*> s_storageRegistry;
 	};
 
 	template <class T>
 	bool UAssetCache::InsertResource(const eastl::string& inResourcePath, eastl::shared_ptr<T> inResource)
 	{
 		MAD_ASSERT_DESC(inResource != nullptr, "Cannot insert NULL resource into AssetCache");
-		return CacheOp<T>(inResourcePath, inResource) != nullptr;
+
+		SCacheStorage<T>& storage = GetStorage<T>();
+		std::lock_guard<std::mutex> lock(storage.m_mutex);
+
+		auto cachedIter = storage.m_cache.find(inResourcePath);
+		const bool overwritten = cachedIter != storage.m_cache.end();
+		if (overwritten)
+		{
+			storage.m_memoryUsage -= cachedIter->second.m_memorySize;
+			storage.m_cache.erase(cachedIter);
+		}
+
+		storage.InsertIfMissing(inResourcePath, inResource);
+		return overwritten;
 	}
 
 	template <class T>
 	eastl::shared_ptr<T> UAssetCache::GetCachedResource(const eastl::string& inResourcePath)
 	{
 		MAD_ASSERT_DESC(!s_assetRootPath.empty(), "Must set the asset root path before attempting to load an asset");
-		return CacheOp<T>(inResourcePath, nullptr);
+
+		SCacheStorage<T>& storage = GetStorage<T>();
+		std::lock_guard<std::mutex> lock(storage.m_mutex);
+
+		auto cachedIter = storage.m_cache.find(inResourcePath);
+		if (cachedIter == storage.m_cache.end())
+		{
+			return nullptr;
+		}
+
+		cachedIter->second.m_lastUseFrame = s_currentFrame.load(std::memory_order_relaxed);
+		return cachedIter->second.m_resource;
 	}
 
 	template <class T>
-	eastl::shared_ptr<T> UAssetCache::CacheOp(const eastl::string& inResourcePath, eastl::shared_ptr<T> inResource)
+	TAssetHandle<T> UAssetCache::FindOrBeginLoad(const eastl::string& inResourcePath, bool& outIsNewLoad)
 	{
-		static eastl::hash_map<eastl::string, eastl::shared_ptr<T>> s_cache;
+		MAD_ASSERT_DESC(!s_assetRootPath.empty(), "Must set the asset root path before attempting to load an asset");
 
-		eastl::shared_ptr<T> ret = nullptr;
+		outIsNewLoad = false;
 
-		auto iter = s_cache.find(inResourcePath);
-		if (iter != s_cache.end())
+		SCacheStorage<T>& storage = GetStorage<T>();
+		std::lock_guard<std::mutex> lock(storage.m_mutex);
+
+		auto cachedIter = storage.m_cache.find(inResourcePath);
+		if (cachedIter != storage.m_cache.end())
+		{
+			cachedIter->second.m_lastUseFrame = s_currentFrame.load(std::memory_order_relaxed);
+
+			auto completedRequest = eastl::make_shared<SAssetLoadRequest<T>>(inResourcePath);
+			completedRequest->m_resource = cachedIter->second.m_resource;
+			completedRequest->m_state.store(EAssetLoadState::Loaded, std::memory_order_release);
+			return TAssetHandle<T>(completedRequest);
+		}
+
+		auto& pendingRequest = storage.m_pendingLoads[inResourcePath];
+		if (!pendingRequest)
 		{
-			ret = iter->second;
+			pendingRequest = eastl::make_shared<SAssetLoadRequest<T>>(inResourcePath);
+			outIsNewLoad = true;
 		}
 
+		return TAssetHandle<T>(pendingRequest);
+	}
+
+	template <class T>
+	void UAssetCache::CompleteLoad(const TAssetHandle<T>& inHandle, eastl::shared_ptr<T> inResource)
+	{
+		SAssetLoadRequest<T>& request = *inHandle.m_request;
+		MAD_ASSERT_DESC(request.m_state.load(std::memory_order_relaxed) == EAssetLoadState::Loading, "Asset load was completed twice");
+
+		SCacheStorage<T>& storage = GetStorage<T>();
+		std::lock_guard<std::mutex> lock(storage.m_mutex);
+
 		if (inResource)
 		{
-			// We're caching a new resource
-			s_cache[inResourcePath] = inResource;
-			LOG(LogAssetCache, Log, "Cached the resource: %s\n", inResourcePath.c_str());
+			// A synchronous load of the same path may have won the race, keep the resource that's already handed out
+			request.m_resource = storage.InsertIfMissing(request.m_resourcePath, inResource);
 		}
 
-		return ret;
+		storage.m_pendingLoads.erase(request.m_resourcePath);
+		request.m_state.store(inResource ? EAssetLoadState::Loaded : EAssetLoadState::Failed, std::memory_order_release);
+	}
+
+	template <class T>
+	void UAssetCache::UpdateMemorySize(const eastl::string& inResourcePath)
+	{
+		SCacheStorage<T>& storage = GetStorage<T>();
+		std::lock_guard<std::mutex> lock(storage.m_mutex);
+
+		auto cachedIter = storage.m_cache.find(inResourcePath);
+		if (cachedIter == storage.m_cache.end())
+		{
+			return;
+		}
+
+		SCacheEntry<T>& cacheEntry = cachedIter->second;
+		storage.m_memoryUsage -= cacheEntry.m_memorySize;
+		cacheEntry.m_memorySize = cacheEntry.m_resource->GetMemorySize();
+		storage.m_memoryUsage += cacheEntry.m_memorySize;
+	}
+
+	template <class T>
+	void UAssetCache::SetMemoryBudget(const char* inTypeName, size_t inBudgetBytes)
+	{
+		SCacheStorage<T>& storage = GetStorage<T>();
+		std::lock_guard<std::mutex> lock(storage.m_mutex);
+
+		storage.m_typeName = inTypeName;
+		storage.m_memoryBudget = inBudgetBytes;
+		storage.m_wasOverBudgetReported = false;
+	}
+
+	template <class T>
+	eastl::shared_ptr<T> UAssetCache::SCacheStorage<T>::InsertIfMissing(const eastl::string& inResourcePath, const eastl::shared_ptr<T>& inResource)
+	{
+		auto insertResult = m_cache.insert(inResourcePath);
+		SCacheEntry<T>& cacheEntry = insertResult.first->second;
+
+		if (insertResult.second)
+		{
+			cacheEntry.m_resource = inResource;
+			cacheEntry.m_memorySize = inResource->GetMemorySize();
+			m_memoryUsage += cacheEntry.m_memorySize;
+
+			LOG(LogAssetCache, Log, "Cached the %s: %s (%u KB)\n", m_typeName, inResourcePath.c_str(), static_cast<uint32_t>(cacheEntry.m_memorySize / 1024));
+		}
+
+		cacheEntry.m_lastUseFrame = s_currentFrame.load(std::memory_order_relaxed);
+		return cacheEntry.m_resource;
+	}
+
+	template <class T>
+	void UAssetCache::SCacheStorage<T>::Evict(bool inEvictAllUnreferenced)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const bool isOverBudget = m_memoryBudget > 0 && m_memoryUsage > m_memoryBudget;
+		if (!isOverBudget && !inEvictAllUnreferenced)
+		{
+			m_wasOverBudgetReported = false;
+			return;
+		}
+
+		// Resources referenced from outside the cache (including by load handles) can't be freed by evicting them
+		eastl::vector<typename CacheMap_t::iterator> evictionCandidates;
+		for (auto cacheIter = m_cache.begin(); cacheIter != m_cache.end(); ++cacheIter)
+		{
+			if (cacheIter->second.m_resource.use_count() == 1)
+			{
+				evictionCandidates.push_back(cacheIter);
+			}
+		}
+
+		eastl::sort(evictionCandidates.begin(), evictionCandidates.end(), [](const typename CacheMap_t::iterator& inFirst, const typename CacheMap_t::iterator& inSecond)
+		{
+			return inFirst->second.m_lastUseFrame < inSecond->second.m_lastUseFrame;
+		});
+
+		for (auto& currentCandidate : evictionCandidates)
+		{
+			if (!inEvictAllUnreferenced && m_memoryUsage <= m_memoryBudget)
+			{
+				break;
+			}
+
+			LOG(LogAssetCache, Log, "Evicting the %s: %s (%u KB, last used on frame %llu)\n", m_typeName, currentCandidate->first.c_str(),
+				static_cast<uint32_t>(currentCandidate->second.m_memorySize / 1024), currentCandidate->second.m_lastUseFrame);
+
+			m_memoryUsage -= currentCandidate->second.m_memorySize;
+			m_cache.erase(currentCandidate);
+		}
+
+		if (m_memoryBudget > 0 && m_memoryUsage > m_memoryBudget && !m_wasOverBudgetReported)
+		{
+			LOG(LogAssetCache, Warning, "%s cache is over budget (%u KB / %u KB) and everything left is still referenced\n", m_typeName,
+				static_cast<uint32_t>(m_memoryUsage / 1024), static_cast<uint32_t>(m_memoryBudget / 1024));
+			m_wasOverBudgetReported = true;
+		}
+	}
+
+	template <class T>
+	void UAssetCache::SCacheStorage<T>::Dump()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		LOG(LogAssetCache, Log, "%s cache: %u resources, %u KB used, %u KB budget\n", m_typeName, static_cast<uint32_t>(m_cache.size()),
+			static_cast<uint32_t>(m_memoryUsage / 1024), static_cast<uint32_t>(m_memoryBudget / 1024));
+
+		for (const auto& currentEntry : m_cache)
+		{
+			// Don't count the cache's own reference
+			LOG(LogAssetCache, Log, "\t%s: %u KB, %u references, last used on frame %llu\n", currentEntry.first.c_str(),
+				static_cast<uint32_t>(currentEntry.second.m_memorySize / 1024), static_cast<uint32_t>(currentEntry.second.m_resource.use_count() - 1),
+				currentEntry.second.m_lastUseFrame);
+		}
 	}
 }
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/functional.h>
+
+namespace MAD
+{
+	/*
+	 * Background threads for asset loading. A load is split in two steps:
+	 *  - the worker step runs on a loader thread and does the file I/O and decoding
+	 *  - the finalize step runs on the main thread inside ProcessFinalizeQueue and does the work that needs the immediate
+	 *    context or other main thread only state (e.g. GPU uploads)
+	 * Finalize steps are drained under a per-frame time budget so that a burst of loads can't stall a frame. A finalize step
+	 * that returns false is still waiting on something (e.g. a mesh on its textures) and is retried next time.
+	 *
+	 * Deduplication and completion of the loads themselves is tracked by UAssetCache, see UAssetCache::FindOrBeginLoad.
+	 */
+	class UAsyncAssetLoader
+	{
+	public:
+		using WorkerStep_t = eastl::function<void()>;
+		using FinalizeStep_t = eastl::function<bool()>;
+
+		UAsyncAssetLoader() = delete;
+		UAsyncAssetLoader(const UAsyncAssetLoader&) = delete;
+		UAsyncAssetLoader& operator=(const UAsyncAssetLoader&) = delete;
+
+		// Loading is mostly waiting on the disk, so a couple of threads is enough
+		static void Init(uint32_t inNumThreads = 2);
+
+		// Waits for the loader threads to finish their current step. Anything still queued is dropped
+		static void Shutdown();
+
+		// Queues a worker step. Runs it inline if the loader threads aren't running
+		static void QueueLoad(WorkerStep_t inWorkerStep);
+
+		// Queues a finalize step, can be called from any thread
+		static void QueueFinalize(FinalizeStep_t inFinalizeStep);
+
+		// Runs queued finalize steps until they've all been visited once or inBudgetSeconds has passed. Main thread only
+		static void ProcessFinalizeQueue(double inBudgetSeconds);
+
+		// Blocks until every queued load has been finalized. Main thread only
+		static void Flush();
+
+		// Number of loads that are either queued, running on a loader thread or waiting to be finalized
+		static uint32_t GetPendingLoadCount();
+	};
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+namespace MAD
+{
+	/*
+	 * Helpers shared by the cooked asset formats. A cooked file is a header followed by flat sections, each padded to
+	 * SectionAlignment, and records the size and write time of the source it was cooked from so that edits are detected.
+	 */
+	class UCookedFile
+	{
+	public:
+		UCookedFile() = delete;
+
+		static const size_t SectionAlignment = 4;
+
+		static bool GetSourceFileStamp(const eastl::string& inSourcePath, uint64_t& outFileSize, uint64_t& outWriteTime);
+
+		static size_t AlignSectionSize(size_t inSize)
+		{
+			return (inSize + SectionAlignment - 1) & ~(SectionAlignment - 1);
+		}
+
+		template <typename T>
+		static void WriteSection(std::ofstream& inOutStream, const T* inData, size_t inCount);
+
+		// Copies a section out of a mapped file and moves the cursor past it. Fails if the file ends first
+		template <typename T>
+		static bool ReadSection(const uint8_t*& inOutCursor, const uint8_t* inEnd, size_t inCount, eastl::vector<T>& outData);
+	};
+
+	template <typename T>
+	void UCookedFile::WriteSection(std::ofstream& inOutStream, const T* inData, size_t inCount)
+	{
+		const size_t dataSize = inCount * sizeof(T);
+		const char padding[SectionAlignment] = {};
+
+		if (dataSize > 0)
+		{
+			inOutStream.write(reinterpret_cast<const char*>(inData), dataSize);
+		}
+
+		inOutStream.write(padding, AlignSectionSize(dataSize) - dataSize);
+	}
+
+	template <typename T>
+	bool UCookedFile::ReadSection(const uint8_t*& inOutCursor, const uint8_t* inEnd, size_t inCount, eastl::vector<T>& outData)
+	{
+		const size_t dataSize = inCount * sizeof(T);
+		if (static_cast<size_t>(inEnd - inOutCursor) < AlignSectionSize(dataSize))
+		{
+			return false;
+		}
+
+		outData.resize(inCount);
+		if (dataSize > 0)
+		{
+			memcpy(outData.data(), inOutCursor, dataSize);
+		}
+
+		inOutCursor += AlignSectionSize(dataSize);
+		return true;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+namespace MAD
+{
+	/*
+	 * Polls a set of files for changes to their size or last write time. Polling is throttled to the interval given
+	 * on construction, which is plenty for picking up files saved from an editor without a directory change notification
+	 */
+	class UFileWatcher
+	{
+	public:
+		explicit UFileWatcher(double inPollIntervalSeconds);
+
+		void WatchFile(const eastl::string& inFilePath);
+		void UnwatchFile(const eastl::string& inFilePath);
+
+		// Appends every watched file that changed since the last poll. Does nothing until the poll interval has passed
+		void Poll(double inCurrentTime, eastl::vector<eastl::string>& outChangedFiles);
+	private:
+		struct SWatchedFile
+		{
+			eastl::string m_filePath;
+			uint64_t m_fileSize;
+			uint64_t m_writeTime;
+		};
+
+		double m_pollInterval;
+		double m_lastPollTime;
+
+		eastl::vector<SWatchedFile> m_watchedFiles;
+	};
+}
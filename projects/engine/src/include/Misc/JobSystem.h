@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/functional.h>
+
+namespace MAD
+{
+	/*
+	 * Small pool of worker threads for fork/join style work (e.g. recording render passes in parallel).
+	 * The thread that kicks a batch always helps execute it, so with zero workers every job simply runs inline.
+	 */
+	class UJobSystem
+	{
+	public:
+		using ParallelJob_t = eastl::function<void(uint32_t)>;
+
+		UJobSystem() = delete;
+		UJobSystem(const UJobSystem&) = delete;
+		UJobSystem& operator=(const UJobSystem&) = delete;
+
+		/*
+		 * Spawns the worker threads. Passing 0 uses one worker per hardware thread, minus the calling thread.
+		 */
+		static void Init(uint32_t inNumWorkers = 0);
+		static void Shutdown();
+
+		/*
+		 * Executes inJob(i) for every i in [0, inJobCount) across the workers and the calling thread,
+		 * and blocks until all of them have finished. Must be called from the thread that called Init and cannot be nested,
+		 * other calls log an error and run every job inline on the calling thread.
+		 */
+		static void ParallelFor(uint32_t inJobCount, const ParallelJob_t& inJob);
+
+		// Number of threads that can execute jobs, including the main thread
+		static uint32_t GetThreadCount();
+
+		// Index in [0, GetThreadCount()) of the calling thread. The main thread is always index 0, and so is any thread
+		// that isn't a worker, so per thread state indexed by it is only safe in jobs kicked from the main thread
+		static uint32_t GetCurrentThreadIndex();
+	};
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/string.h>
+
+namespace MAD
+{
+	/*
+	 * Read-only view of an entire file mapped into memory. The mapping is released when the object is closed or destroyed,
+	 * so nothing pointing into GetData() may outlive it.
+	 */
+	class UMappedFile
+	{
+	public:
+		UMappedFile();
+		~UMappedFile();
+
+		UMappedFile(const UMappedFile&) = delete;
+		UMappedFile& operator=(const UMappedFile&) = delete;
+
+		bool Open(const eastl::string& inFilePath);
+		void Close();
+
+		bool IsOpen() const { return m_data != nullptr; }
+		const uint8_t* GetData() const { return m_data; }
+		size_t GetSize() const { return m_size; }
+
+	private:
+		void* m_fileHandle;
+		void* m_mappingHandle;
+
+		const uint8_t* m_data;
+		size_t m_size;
+	};
+}
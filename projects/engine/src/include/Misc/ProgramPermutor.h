@@ -2,16 +2,31 @@
 
 #include <EASTL/vector.h>
 #include <EASTL/hash_map.h>
+#include <EASTL/shared_ptr.h>
 
 #include "Misc/ProgramPermutorInfoTypes.h"
 
 namespace MAD
 {
+	/*
+		Compiled shaders are kept in an on-disk permutation cache (the "shadercache" directory of the assets root), keyed by a
+		hash of the program source and everything it includes, the permutation's macros, the entry point, the shader model and
+		the compile flags. Unchanged permutations load their bytecode from it instead of being compiled again.
+
+		Pixel shaders of permutations with material features (s_deferredPermuteMask) aren't compiled until a draw asks for
+		them, since most material combinations are never used. Their vertex shaders are still created up front because the
+		input layouts are reflected from them.
+	*/
 	class UProgramPermutor
 	{
 	public:
+		static const ProgramId_t s_deferredPermuteMask;
+
 		// Generates all the permutations of a shader based on the permutation flags that are specified within the shader file
-		static void PermuteProgram(const eastl::string& inProgramFilePath, ProgramPermutations_t& outProgramPermutations, bool inShouldGenPermutationFiles = false);
+		static void PermuteProgram(const eastl::string& inProgramFilePath, SProgramSourceDescription& outProgramSource, ProgramPermutations_t& outProgramPermutations, bool inShouldGenPermutationFiles = false);
+
+		// Compiles the deferred shaders of a permutation on the asset loader threads, the permutation becomes ready once the load is finalized. Thread safe
+		static void CompilePermutationAsync(const eastl::shared_ptr<const SProgramSourceDescription>& inProgramSource, ProgramId_t inProgramId, const eastl::shared_ptr<UPassProgram>& inPassProgram);
 	private:
 		static const eastl::string s_shaderMetaFlagString;
 		static const eastl::hash_map<eastl::string, EMetaFlagType> s_metaFlagStringToTypeMap;
@@ -19,7 +34,17 @@ namespace MAD
 	private:
 		// Parsing and generation functions
 		static void ParseProgramMetaFlags(const eastl::string& inShaderBufferString, eastl::vector<SShaderMetaFlagInstance>& outMetaFlagInstances);
-		static void GeneratePermutations(const eastl::string& inShaderFilePath, const eastl::vector<SShaderUsageDescription>& inUsageDescriptions, const eastl::vector<SShaderPermuteDescription>& inPermuteOptions, ProgramPermutations_t& outPermutations, bool inShouldGenPermutationFiles);
+		static void GeneratePermutations(const SProgramSourceDescription& inProgramSource, ProgramPermutations_t& outPermutations, bool inShouldGenPermutationFiles);
+		static bool IsDeferredUsage(ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription);
+
+		// Loads the bytecode from the permutation cache, or compiles it and adds it to the cache. Thread safe
+		static bool GetPermutationByteCode(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription, eastl::vector<char>& outByteCode, bool& outIsCached);
+		static bool CompilePermutationByteCode(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription, eastl::vector<char>& outByteCode);
+		static void DiscardCachedByteCode(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription);
+		static eastl::string GetPermutationCachePath(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription);
+
+		// Returns false if the device rejected the bytecode
+		static bool SetPermutationShader(class UGraphicsDriver& inGraphicsDriver, EProgramShaderType inShaderType, const eastl::vector<char>& inByteCode, UPassProgram& inOutPassProgram);
 		static void GenerateProgramPermutationFile(const eastl::string& inOutputFilePath, const eastl::string& inProgramFileName, const eastl::vector<char>& inCompiledByteCode, const SShaderUsageDescription& inTargetUsage, ProgramId_t inTargetProgramID, const eastl::string& inTargetProgramStringDesc);
 		
 		// Utility functions
@@ -18,6 +18,8 @@ namespace MAD
 		Lighting_PointLight = 1 << 5,
 		Lighting_DirectionalLight = 1 << 6,
 
+		Geometry_Instanced = 1 << 7,
+
 		INVALID = eastl::numeric_limits<ProgramId_t>::max()
 	};
 
@@ -48,4 +50,13 @@ namespace MAD
 
 		// ...potentially more later
 	};
+
+	// Everything the permutations of a program are compiled from, kept with the program so that permutations can be compiled on demand
+	struct SProgramSourceDescription
+	{
+		eastl::string ProgramFilePath;
+		eastl::vector<SShaderUsageDescription> UsageDescriptions;
+		eastl::vector<SShaderPermuteDescription> PermuteDescriptions;
+		uint64_t SourceHash; // Program file and everything it includes
+	};
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+#include <emmintrin.h>
+
+namespace MAD
+{
+	/*
+	 * Four xorshift128 generators running side by side in the lanes of an SSE register, so that four random numbers cost
+	 * about as much as one. Meant for effects and the like, where speed matters more than statistical quality.
+	 * All of the state is in the stream, so each thread or system can own one instead of sharing rand()'s.
+	 */
+	class URandomStream
+	{
+	public:
+		explicit URandomStream(uint32_t inSeed = 1);
+
+		void Seed(uint32_t inSeed);
+
+		// Writes inCount uniform floats in [0, 1) to outValues. Counts that are a multiple of four don't waste any numbers
+		void GenerateFloats(float* outValues, uint32_t inCount);
+	private:
+		__m128i GenerateBits();
+	private:
+		__m128i m_state[4];
+	};
+}
@@ -44,6 +44,7 @@ namespace MAD
 	{
 		SHOOT_BULLET,
 		MOVE_ENTITY,
+		MOVE_CHARACTER,
 		NUM_EVENT_TYPES
 	};
 
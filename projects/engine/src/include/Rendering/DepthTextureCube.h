@@ -27,6 +27,7 @@ namespace MAD
 
 		// Binds a cube side as the depth stencil view
 		void BindCubeSideAsTarget(uint8_t inCubeSide) const;
+		void BindCubeSideAsTarget(class UGraphicsDriver& inGraphicsDriver, uint8_t inCubeSide) const;
 	private:
 		eastl::array<DepthStencilPtr_t, AsIntegral(ETextureCubeFace::MAX)> m_depthCubeDSVs;
 		ShaderResourcePtr_t m_depthCubeSRV;
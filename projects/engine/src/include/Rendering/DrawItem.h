@@ -9,14 +9,31 @@
 #include "Rendering/VertexArray.h"
 #include "Rendering/InputLayoutCache.h"
 #include "Rendering/Mesh.h"
+#include "Rendering/Texture.h"
 
 namespace MAD
 {
+	/*
+		Constants that were uploaded ahead of time for a draw item (e.g. batched into the constant ring, or cached materials).
+		Invalid ranges are uploaded on demand when the item is drawn.
+	*/
+	struct SDrawItemConstants
+	{
+		SConstantBufferRange m_perDrawConstants;
+		SConstantBufferRange m_perMaterialConstants;
+	};
+
 	struct SDrawItem
 	{
 		SDrawItem();
 
-		void Draw(class UGraphicsDriver& inGraphicsDriver, float inFramePercent, const SPerFrameConstants& inPerFrameConstants, bool inBindMaterialProperties, InputLayoutFlags_t inInputLayoutOverride = eastl::numeric_limits<InputLayoutFlags_t>::max(), RasterizerStatePtr_t inRasterStateOverride = nullptr);
+		void Draw(class UGraphicsDriver& inGraphicsDriver, const SPerFrameConstants& inPerFrameConstants, bool inBindMaterialProperties, InputLayoutFlags_t inInputLayoutOverride = eastl::numeric_limits<InputLayoutFlags_t>::max(), RasterizerStatePtr_t inRasterStateOverride = nullptr, const SDrawItemConstants* inUploadedConstants = nullptr, UINT inLOD = 0) const;
+		void DrawInstanced(class UGraphicsDriver& inGraphicsDriver, const SInstanceBufferRange& inInstances, bool inBindMaterialProperties, InputLayoutFlags_t inInputLayoutOverride = eastl::numeric_limits<InputLayoutFlags_t>::max(), RasterizerStatePtr_t inRasterStateOverride = nullptr, const SDrawItemConstants* inUploadedConstants = nullptr, UINT inLOD = 0) const;
+
+		// Index range drawn for a level of detail. LODs past the last one the item has clamp to it
+		SMeshLOD GetLODIndexRange(UINT inLOD) const;
+
+		static void CalculatePerDrawConstants(const Matrix& inObjectToWorldMatrix, const SPerFrameConstants& inPerFrameConstants, SPerDrawConstants& outPerDrawConstants);
 
 		// Input Assembly
 		InputLayoutPtr_t m_inputLayout;
@@ -27,17 +44,34 @@ namespace MAD
 		BufferPtr_t m_indexBuffer;
 		UINT m_indexOffset;
 		UINT m_indexCount;
+		UINT m_indexSize; // 2 or 4 bytes
+
+		// Coarser index ranges into the same index buffer, LOD 0 matches m_indexOffset/m_indexCount. Items without any
+		// LODs always draw m_indexOffset/m_indexCount
+		SMeshLOD m_lods[MaxMeshLODs];
+		UINT m_lodCount;
+
+		// Object space bounding sphere. A negative radius means the item has no bounds and is never culled
+		Vector3 m_boundsCenter;
+		float m_boundsRadius;
 
 		// Rasterizer State
 		EPrimitiveTopology m_primitiveTopology;
 		RasterizerStatePtr_t m_rasterizerState;
 
 		// Shader Resources
-		// Used for renderer state ping-ponging for interpolating state
+		// Used by the renderer to find the item's interpolation state from the previous frame
 		size_t m_uniqueID;
-		ULinearTransform* m_previousDrawTransform;
 		ULinearTransform m_transform;
 		eastl::vector<eastl::pair<EConstantBufferSlot, eastl::pair<const void*, UINT>>> m_constantBufferData;
-		eastl::vector<eastl::pair<ETextureSlot, ShaderResourcePtr_t>> m_shaderResources;
+		uint32_t m_materialID; // Keys the cached PerMaterial constants, 0 if they aren't cached
+		eastl::vector<eastl::pair<ETextureSlot, eastl::shared_ptr<UTexture>>> m_shaderResources; // Resource is read when the item is drawn
+
+	private:
+		// Constant buffer updates a draw needs when nothing was uploaded ahead of time, one for the per draw constants plus the material's
+		UINT GetUnbatchedUpdateCount(bool inBindMaterialProperties) const;
+		void BindInputAssembly(class UGraphicsDriver& inGraphicsDriver, InputLayoutFlags_t inInputLayoutOverride, InputLayoutFlags_t inExtraInputLayoutFlags, UINT inIndexOffset) const;
+		// Returns how many constant buffers were updated, the others were bound from ranges uploaded ahead of time
+		UINT BindMaterialAndRasterState(class UGraphicsDriver& inGraphicsDriver, bool inBindMaterialProperties, RasterizerStatePtr_t inRasterStateOverride, const SDrawItemConstants* inUploadedConstants) const;
 	};
 }
@@ -43,6 +43,9 @@ namespace MAD
 		uint32_t GetFontBitmapDimension() const { return m_fontBitmapTexture->GetWidth(); }
 
 		ShaderResourcePtr_t GetFontTextureResource() const { return m_fontBitmapTexture->GetTexureResource(); }
+
+		// The bitmap texture is cached on its own, so only the character info is counted
+		size_t GetMemorySize() const { return sizeof(UFontFamily) + m_fontCharInfo.size() * sizeof(SFontChar); }
 	private:
 		bool LoadFontFamilyJSON(const eastl::string& inRelativePath);
 		bool LoadFontFamilyTexture(const eastl::string& inFullPath);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <EASTL/hash_map.h>
 #include <EASTL/string.h>
 #include <EASTL/vector.h>
 #include <vector>
@@ -36,10 +37,16 @@ namespace MAD
 		(graphics)->EndEventGroup();				\
 		rmt_EndD3D11Sample();						\
 	} while (0)
+
+// Remotery can only time the immediate context, so passes recorded on deferred contexts only emit debug markers
+#define GPU_MARKER_START(graphics, str) (graphics)->StartEventGroup(str)
+#define GPU_MARKER_END(graphics) (graphics)->EndEventGroup()
 #else
 #define GPU_EVENT_START(...) (void)0
 #define GPU_EVENT_START_STR(...) (void)0
 #define GPU_EVENT_END(...) (void)0
+#define GPU_MARKER_START(...) (void)0
+#define GPU_MARKER_END(...) (void)0
 #endif
 
 	class UGraphicsDriver
@@ -50,6 +57,19 @@ namespace MAD
 		bool Init(class UGameWindow& inWindow);
 		void Shutdown();
 
+		/*
+		 * Initializes this driver as a deferred context of an already initialized (immediate) driver. Deferred drivers
+		 * own their own constant buffers so that each recording thread stages its constants independently.
+		 * Commands issued on a deferred driver are only recorded, use FinishCommandList() to retrieve them.
+		 */
+		bool InitDeferred(const UGraphicsDriver& inImmediateDriver);
+		bool IsDeferred() const { return m_isDeferred; }
+
+		// Deferred contexts start each command list with default pipeline state, so this rebinds our constant buffers and samplers
+		void BeginCommandList();
+		CommandListPtr_t FinishCommandList() const;
+		void ExecuteCommandList(CommandListPtr_t inCommandList) const;
+
 		void OnScreenSizeChanged();
 
 		RenderTargetPtr_t GetBackBufferRenderTarget() const { return m_backBuffer; }
@@ -57,9 +77,23 @@ namespace MAD
 		// Don't use this directly, use the AssetCache interface, e.g.
 		//     AssetCache.Load<UTexture>(...);
 		ShaderResourcePtr_t CreateTextureFromFile(const eastl::string& inPath, uint64_t& outWidth, uint64_t& outHeight, bool inForceSRGB, bool inGenerateMips, int32_t inMiscFlags = 0) const;
+
+		// Same as CreateTextureFromFile for a file that has already been read into memory. inExtension selects the decoder.
+		// Without inGenerateMips this only touches the device, so it's safe to call from the asset loader threads.
+		// inMaxSize skips the DDS mips that are larger than it in either dimension, 0 loads all of them
+		ShaderResourcePtr_t CreateTextureFromMemory(const void* inData, size_t inDataSize, const eastl::string& inExtension, uint64_t& outWidth, uint64_t& outHeight, bool inForceSRGB, bool inGenerateMips, int32_t inMiscFlags = 0, size_t inMaxSize = 0) const;
 		
-		bool CompileShaderFromFile(const eastl::string& inFileName, const eastl::string& inShaderEntryPoint, const eastl::string& inShaderModel, eastl::vector<char>& inOutCompileByteCode, const D3D_SHADER_MACRO* inShaderMacroDefines = nullptr);
+		// Vertex shaders register their input layout, unless inRegisterInputLayout is false. Without it this doesn't touch any
+		// main thread state, so it's safe to call from other threads
+		bool CompileShaderFromFile(const eastl::string& inFileName, const eastl::string& inShaderEntryPoint, const eastl::string& inShaderModel, eastl::vector<char>& inOutCompileByteCode, const D3D_SHADER_MACRO* inShaderMacroDefines = nullptr, bool inRegisterInputLayout = true);
+
+		// D3DCOMPILE flags every shader is compiled with, they differ between debug and release builds
+		static uint32_t GetShaderCompileFlags();
 
+		// Registers the input layout reflected from a vertex shader's input signature. Main thread only
+		void RegisterInputLayout(const eastl::vector<char>& inCompiledVSByteCode);
+
+		// Return null if the device rejects the bytecode, e.g. when it comes from a stale cache that the caller can recompile
 		VertexShaderPtr_t CreateVertexShader(const eastl::vector<char>& inCompiledVSByteCode);
 		PixelShaderPtr_t CreatePixelShader(const eastl::vector<char>& inCompiledPSByteCode);
 		GeometryShaderPtr_t CreateGeometryShader(const eastl::vector<char>& inCompiledGSByteCode);
@@ -74,14 +108,65 @@ namespace MAD
 		Texture2DPtr_t CreateTexture2D(const STexture2DDesc& inTextureDesc, const void* inInitialData = nullptr);
 		ShaderResourcePtr_t CreateShaderResource(ResourcePtr_t inResource, DXGI_FORMAT inFormat, D3D11_SRV_DIMENSION inSRVDimension, uint32_t inMostDetailedMip, uint32_t inMipLevels) const;
 		RasterizerStatePtr_t CreateRasterizerState(EFillMode inFillMode, ECullMode inCullMode) const;
-		RasterizerStatePtr_t CreateDepthRasterizerState() const;
+		RasterizerStatePtr_t CreateDepthRasterizerState(bool inEnableDepthClip = true) const;
 		BlendStatePtr_t CreateBlendState(bool inEnableBlend, EBlendFactor inSrcBlend = EBlendFactor::One, EBlendFactor inDestBlend = EBlendFactor::One, EBlendOp inBlendOp = EBlendOp::Add,
 										 EBlendFactor inSrcAlphaBlend = EBlendFactor::One, EBlendFactor inDestAlphaBlend = EBlendFactor::Zero, EBlendOp inAlphaBlendOp = EBlendOp::Add) const;
 
 		BufferPtr_t CreateVertexBuffer(const void* inData, UINT inDataSize, EResourceUsage inUsageFlags = EResourceUsage::Immutable, ECPUAccess inCPUAccessFlags = ECPUAccess::None) const;
 		BufferPtr_t CreateIndexBuffer(const void* inData, UINT inDataSize) const;
 
-		void UpdateBuffer(EConstantBufferSlot inSlot, const void* inData, size_t inDataSize) const;
+		// PerMaterial and PerDraw constants are sub-allocated from the constant ring, the other slots have dedicated buffers
+		void UpdateBuffer(EConstantBufferSlot inSlot, const void* inData, size_t inDataSize);
+
+		/*
+		 * Per-frame constant ring. Allocations are linearly sub-allocated from one large dynamic buffer and bound with offsets,
+		 * and stay valid until the next ResetConstantRing() (immediate driver) or BeginCommandList() (deferred drivers).
+		 * To write many allocations with a single map, wrap the PushConstants() calls in Begin/EndConstantBatch(). Pushing more
+		 * than a batch reserved carries on in another map of the ring.
+		 *
+		 * The ring never wraps between resets, since earlier allocations may still be bound by command lists that haven't
+		 * executed yet. When it runs out it moves to a new buffer at least twice as large, and the old one is kept alive until
+		 * the next reset. ReserveConstantRing() grows it up front, for callers that know how much they're about to allocate.
+		 */
+		static UINT GetConstantAllocationSize(UINT inDataSize);
+
+		void ResetConstantRing();
+		void ReserveConstantRing(UINT inDataSize);
+		void BeginConstantBatch(UINT inMaxDataSize);
+		SConstantBufferRange PushConstants(const void* inData, UINT inDataSize);
+		void EndConstantBatch();
+		SConstantBufferRange AllocateConstants(const void* inData, UINT inDataSize);
+		void BindConstants(EConstantBufferSlot inSlot, const SConstantBufferRange& inRange) const;
+
+		/*
+		 * Persistent constants (e.g. materials) that are uploaded once and reused across frames. inKey identifies the data, it's only
+		 * re-uploaded when the contents behind the key change. Immediate driver only, FlushCachedConstants() must be called before
+		 * any returned range is used by the GPU.
+		 *
+		 * Keys must not be reused for different data. Once the owner of a key is gone, ReleaseCachedConstants() hands its range
+		 * back to be reused by later keys.
+		 */
+		SConstantBufferRange CacheConstants(uint32_t inKey, const void* inData, UINT inDataSize);
+		void ReleaseCachedConstants(uint32_t inKey);
+		void FlushCachedConstants();
+
+		/*
+		 * Per-frame ring for the per-instance vertex stream. Instance data can only be uploaded through the immediate driver,
+		 * but the returned ranges can be bound on any driver until the next ResetInstanceRing().
+		 */
+		void ResetInstanceRing();
+		SInstanceBufferRange UploadInstanceData(const SPerInstanceData* inInstanceData, UINT inInstanceCount);
+		void SetInstanceBuffer(const SInstanceBufferRange& inInstances) const;
+
+		/*
+		 * Number of buffer maps issued through this driver since the last reset. The unbatched count is how many there would
+		 * have been if every draw had updated its own constant buffers, instead of binding ranges of the constant and instance
+		 * rings. Draws report what they skipped through AddSkippedDrawMaps().
+		 */
+		uint32_t GetMapCount() const { return m_mapCount; }
+		uint32_t GetUnbatchedMapCount() const { return m_mapCount - m_ringMapCount + m_skippedDrawMapCount; }
+		void AddSkippedDrawMaps(uint32_t inMapCount) const { m_skippedDrawMapCount += inMapCount; }
+		void ResetMapCount() { m_mapCount = 0; m_ringMapCount = 0; m_skippedDrawMapCount = 0; }
 
 		void SetRenderTargets(const RenderTargetPtr_t* inRenderTargets, int inNumRenderTargets, const DepthStencilPtr_t inOptionalDepthStencil) const;
 		void SetDepthStencilState(DepthStencilStatePtr_t inDepthStencilState, UINT inStencilRef) const;
@@ -90,7 +175,8 @@ namespace MAD
 		void SetInputLayout(InputLayoutPtr_t inInputLayout) const;
 		void SetPrimitiveTopology(EPrimitiveTopology inPrimitiveTopology) const;
 		void SetVertexBuffer(BufferPtr_t inVertexBuffer, VertexBufferSlotType_t inVertexSlot, UINT inVertexSize, UINT inVertexIndexOffset) const;
-		void SetIndexBuffer(BufferPtr_t inIndexBuffer, UINT inIndexOffset) const;
+		// The offset is in indices, which are either 16 or 32-bit
+		void SetIndexBuffer(BufferPtr_t inIndexBuffer, UINT inIndexOffset, UINT inIndexSize = sizeof(uint16_t)) const;
 		void SetVertexShader(VertexShaderPtr_t inVertexShader) const;
 		void SetGeometryShader(GeometryShaderPtr_t inGeometryShader) const;
 		void SetPixelShader(PixelShaderPtr_t inPixelShader) const;
@@ -109,6 +195,8 @@ namespace MAD
 		void ClearDepthStencil(DepthStencilPtr_t inDepthStencil, bool inClearDepth, float inDepth, bool inClearStencil = false, UINT8 inStencil = 0) const;
 		void Draw(int inVertexCount, int inStartVertex) const;
 		void DrawIndexed(int inIndexCount, int inStartIndex, int inBaseVertex) const;
+		void DrawInstanced(int inVertexCount, int inInstanceCount, int inStartVertex, int inStartInstance) const;
+		void DrawIndexedInstanced(int inIndexCount, int inInstanceCount, int inStartIndex, int inBaseVertex, int inStartInstance) const;
 		void Present() const;
 
 #ifdef _DEBUG
@@ -130,7 +218,6 @@ namespace MAD
 		//==========================================================
 	private:
 		void CreateBackBufferRenderTargetView();
-		void RegisterInputLayout(ID3DBlob* inTargetBlob);
 
 		SamplerStatePtr_t CreateSamplerState(D3D11_FILTER inFilterMode, UINT inMaxAnisotropy = 0, D3D11_TEXTURE_ADDRESS_MODE inAddressMode = D3D11_TEXTURE_ADDRESS_WRAP, Color inBorderColor = Color()) const;
 		void SetPixelSamplerState(SamplerStatePtr_t inSamplerState, UINT inSlot) const;
@@ -138,7 +225,7 @@ namespace MAD
 		BufferPtr_t CreateBuffer(const void* inData, UINT inDataSize, EResourceUsage inUsage, EBindFlag inBindFlags, ECPUAccess inCpuAccessFlags) const;
 		BufferPtr_t CreateConstantBuffer(const void* inData, UINT inDataSize) const;
 
-		void* MapBuffer(BufferPtr_t inBuffer) const;
+		void* MapBuffer(BufferPtr_t inBuffer, EResourceMap inMapType = EResourceMap::WriteDiscard) const;
 		void UnmapBuffer(BufferPtr_t inBuffer) const;
 
 		void SetVertexConstantBuffer(BufferPtr_t inBuffer, UINT inSlot) const;
@@ -149,9 +236,55 @@ namespace MAD
 		void SetGeometryConstantBuffer(BufferPtr_t inBuffer, UINT inSlot, UINT inOffset, UINT inLength) const;
 		void SetPixelShaderResource(ShaderResourcePtr_t inShaderResource, UINT inSlot) const;
 
+		void CreateConstantBuffers();
+		void BindConstantBuffersAndSamplers() const;
+
+		// Moves the constant ring to a new buffer of at least inMinSize bytes, retiring the current one
+		void GrowConstantRing(UINT inMinSize);
+
+		struct SConstantCachePage
+		{
+			BufferPtr_t m_buffer;
+			eastl::vector<uint8_t> m_shadowData;
+			UINT m_usedSize = 0;
+			bool m_isDirty = false;
+		};
+
+		struct SCachedConstants
+		{
+			uint32_t m_pageIndex;
+			SConstantBufferRange m_range;
+		};
+
+		ComPtr<ID3D11DeviceContext2> m_deviceContext;
+		ComPtr<ID3DUserDefinedAnnotation> m_eventAnnotation;
+		bool m_isDeferred;
+
 		RenderTargetPtr_t m_backBuffer;
 
 		eastl::vector<BufferPtr_t> m_constantBuffers;
 		eastl::vector<SamplerStatePtr_t> m_samplers;
+
+		BufferPtr_t m_constantRing;
+		UINT m_constantRingSize;
+		UINT m_constantRingOffset;
+		bool m_constantRingNeedsDiscard;
+		eastl::vector<BufferPtr_t> m_retiredConstantRings; // Outgrown this frame, still referenced by its allocations
+		uint8_t* m_constantBatchData;
+		UINT m_constantBatchSize;
+		UINT m_constantBatchEnd;
+
+		BufferPtr_t m_instanceRing;
+		UINT m_instanceRingSize;
+		UINT m_instanceRingOffset;
+		bool m_instanceRingNeedsDiscard;
+
+		eastl::vector<SConstantCachePage> m_constantCachePages;
+		eastl::hash_map<uint32_t, SCachedConstants> m_cachedConstants;
+		eastl::vector<SCachedConstants> m_freeCachedConstants;
+
+		mutable uint32_t m_mapCount;
+		uint32_t m_ringMapCount;
+		mutable uint32_t m_skippedDrawMapCount;
 	};
 }
@@ -100,4 +100,28 @@ namespace MAD
 	using BufferPtr_t = UGraphicsObject<ID3D11Buffer>;
 	using Texture2DPtr_t = UGraphicsObject<ID3D11Texture2D>;
 	using ResourcePtr_t = UGraphicsObject<ID3D11Resource>;
+	using CommandListPtr_t = UGraphicsObject<ID3D11CommandList>;
+
+	/*
+		SConstantBufferRange - A sub-range of a (larger) constant buffer, bound with VS/PS/GSSetConstantBuffers1. Offset and size are in bytes
+		and always multiples of 256 (16 shader constants), which is the granularity the runtime requires for constant buffer offsets.
+	*/
+	struct SConstantBufferRange
+	{
+		BufferPtr_t m_buffer;
+		UINT m_offset = 0;
+		UINT m_size = 0;
+
+		bool IsValid() const { return m_size > 0; }
+	};
+
+	/*
+		SInstanceBufferRange - A run of SPerInstanceData elements inside of the per-instance vertex stream.
+	*/
+	struct SInstanceBufferRange
+	{
+		BufferPtr_t m_buffer;
+		UINT m_offset = 0;
+		UINT m_instanceCount = 0;
+	};
 }
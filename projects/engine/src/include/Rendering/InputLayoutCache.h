@@ -18,14 +18,28 @@ namespace MAD
 			Normal		= 1 << 1,
 			Tangent		= 1 << 2,
 			UV			= 1 << 3,
+			Instance	= 1 << 4,
 
 			INVALID		= 0
 		};
 	}
 
+	// Packed vertex formats that some semantics can use instead of full floats. Combined with the semantic flags to look up a layout
+	namespace EInputLayoutFormat
+	{
+		enum Type : InputLayoutFlags_t
+		{
+			PackedNormals	= 1 << 5, // Normals and tangents in R8G8B8A8_SNORM
+			HalfTexCoords	= 1 << 6, // Texture coordinates in R16G16_FLOAT
+
+			None			= 0
+		};
+	}
+
 	class UInputLayoutCache
 	{
 	public:
+		// Also registers the layout with every packed format its semantics can use
 		static bool RegisterInputLayout(class UGraphicsDriver& inGraphicsDriver, InputLayoutFlags_t inFlags, const eastl::vector<char>& inCompiledVertexShader);
 		static bool RegisterInputLayout(class UGraphicsDriver& inGraphicsDriver, InputLayoutFlags_t inFlags, const void* inCompiledVSByteCode, size_t inByteCodeSize);
 
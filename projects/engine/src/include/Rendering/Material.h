@@ -1,5 +1,7 @@
 #pragma once
 
+#include <EASTL/vector.h>
+
 #include "Rendering/RenderingCommon.h"
 #include "Rendering/ColorTextureCube.h"
 #include "Rendering/Texture.h"
@@ -11,13 +13,24 @@ namespace MAD
 	public:
 		UMaterial();
 
+		/*
+		 * Materials whose cached GPU constants can be freed. Owners queue their materials as they're destroyed, which may be on
+		 * any thread, and the renderer takes them once per frame.
+		 */
+		static void QueueCachedConstantsRelease(uint32_t inMaterialID);
+		static void TakeCachedConstantsReleases(eastl::vector<uint32_t>& outMaterialIDs);
+
+		// Never reused, unlike the material's address, so it keys the material's cached constants. 0 is never a valid ID
+		uint32_t m_materialID;
+
 		SGPUMaterial m_mat;
 
-		UTexture m_diffuseTex;
-		UTexture m_specularTex;
-		UTexture m_emissiveTex;
-		UTexture m_normalMap;
-		UTexture m_opacityMask;
+		// Shared with the asset cache and the draw items, null if the material doesn't use the texture
+		eastl::shared_ptr<UTexture> m_diffuseTex;
+		eastl::shared_ptr<UTexture> m_specularTex;
+		eastl::shared_ptr<UTexture> m_emissiveTex;
+		eastl::shared_ptr<UTexture> m_normalMap;
+		eastl::shared_ptr<UTexture> m_opacityMask;
 
 		bool m_isTwoSided = false;
 	};
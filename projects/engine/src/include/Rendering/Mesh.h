@@ -5,16 +5,16 @@
 #include <EASTL/vector.h>
 
 #include "Core/SimpleMath.h"
+#include "Misc/AssetCache.h"
 #include "Rendering/RenderingCommon.h"
 #include "Rendering/GraphicsDriverTypes.h"
 #include "Rendering/Material.h"
+#include "Rendering/MeshCooker.h"
 #include "Rendering/SubMesh.h"
 #include "Rendering/VertexArray.h"
 
 namespace MAD
 {
-	using Index_t = uint16_t;
-
 	struct SMeshInstance
 	{
 		SMeshInstance() : m_bVisible(false) {}
@@ -34,19 +34,34 @@ namespace MAD
 		*/
 		static eastl::shared_ptr<UMesh> Load(const eastl::string& inRelativePath);
 
+		/*
+		* Asynchronous version of Load. The mesh data and its textures are read on the asset loader threads, the GPU buffers
+		* are created on the main thread once all of them are in.
+		*/
+		static TAssetHandle<UMesh> LoadAsync(const eastl::string& inRelativePath);
+
+		// Frees the GPU constants cached for the mesh's materials
+		~UMesh();
+
 		void BuildDrawItems(eastl::vector<struct SDrawItem>& inOutTargetDrawItems, const ULinearTransform& inMeshTransform) const;
 
+		// Vertex and index streams, counted for both the CPU copy and the GPU buffers. Textures are cached separately
+		size_t GetMemorySize() const;
+
 	//private:
 		static eastl::shared_ptr<UMesh> Load_Internal(const eastl::string& inRelativePath);
 
+		// Creates the materials and GPU buffers of a mesh. The vertex and index streams are moved out of inOutMeshData
+		static eastl::shared_ptr<UMesh> CreateFromMeshData(const eastl::string& inRelativeDirectory, SMeshData& inOutMeshData);
+
 		eastl::vector<SSubMesh> m_subMeshes;
 		eastl::vector<UMaterial> m_materials;
 
 		InputLayoutPtr_t m_inputLayout;
 
 		eastl::vector<Vector3> m_positions;
-		eastl::vector<Vector3> m_normals;
-		eastl::vector<Vector4> m_tangents;
+		eastl::vector<PackedNormal_t> m_normals;
+		eastl::vector<PackedNormal_t> m_tangents;
 		eastl::vector<Vector2> m_texCoords;
 
 		UVertexArray m_gpuPositions;
@@ -54,7 +69,8 @@ namespace MAD
 		UVertexArray m_gpuTangents;
 		UVertexArray m_gpuTexCoords;
 
-		eastl::vector<Index_t> m_indexBuffer;
+		// Read with GetSubMeshIndex, sub-meshes may use different index sizes
+		eastl::vector<uint8_t> m_indexData;
 		BufferPtr_t m_gpuIndexBuffer;
 	};
 }
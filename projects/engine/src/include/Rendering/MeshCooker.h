@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+#include "Core/SimpleMath.h"
+#include "Rendering/MeshOptimizer.h"
+#include "Rendering/RenderingCommon.h"
+#include "Rendering/SubMesh.h"
+
+namespace MAD
+{
+	// Material as referenced by a mesh asset. Texture paths are relative to the mesh's directory and empty when unused
+	struct SMeshMaterialDesc
+	{
+		SGPUMaterial m_mat;
+
+		eastl::string m_diffuseTex;
+		eastl::string m_specularTex;
+		eastl::string m_emissiveTex;
+		eastl::string m_normalMap;
+		eastl::string m_opacityMask;
+
+		bool m_isTwoSided = false;
+	};
+
+	// CPU side contents of a mesh asset, either imported from its source file or read back from its cooked file
+	struct SMeshData
+	{
+		eastl::vector<SSubMesh> m_subMeshes;
+		eastl::vector<SMeshMaterialDesc> m_materials;
+
+		eastl::vector<Vector3> m_positions;
+		eastl::vector<PackedNormal_t> m_normals;
+		eastl::vector<PackedNormal_t> m_tangents;
+		eastl::vector<Vector2> m_texCoords;
+
+		// Each sub-mesh's indices are either 16 or 32-bit, see SSubMesh::m_indexSize
+		eastl::vector<uint8_t> m_indexData;
+	};
+
+	// Vertex cache efficiency of an imported mesh, before and after UMeshOptimizer has been run on it
+	struct SMeshOptimizationStats
+	{
+		uint32_t m_triangleCount = 0;
+		float m_sourceACMR = 0.0f;
+		float m_optimizedACMR = 0.0f;
+
+		// Summed over every sub-mesh that has the LOD
+		uint32_t m_lodTriangleCounts[MaxMeshLODs] = {};
+	};
+
+	/*
+		Converts source meshes (anything Assimp can read) into the engine's cooked binary format. Cooked files sit next to
+		their source with a ".madmesh" extension and record the source's size and write time, so an edited source is
+		detected as stale. Doesn't touch the graphics driver, so it can be used from the offline MeshCooker tool.
+
+		All paths are full paths to the source mesh.
+	*/
+	class UMeshCooker
+	{
+	public:
+		UMeshCooker() = delete;
+
+		// Bump whenever the cooked layout or the import settings change, to invalidate existing cooked files
+		static const uint32_t CookedMeshVersion;
+
+		// Object space bounding sphere of a sub-mesh's vertices
+		static void CalculateSubMeshBounds(const Vector3* inPositions, UINT inVertexCount, SSubMesh& inOutSubMesh);
+
+		static eastl::string GetCookedMeshPath(const eastl::string& inSourcePath);
+
+		// Runs the full Assimp import and post-processing on the source mesh, then optimizes each sub-mesh for the GPU
+		static bool ImportSourceMesh(const eastl::string& inSourcePath, SMeshData& outMeshData, SMeshOptimizationStats* outStats = nullptr);
+
+		// Imports the source mesh and writes its cooked file
+		static bool CookMesh(const eastl::string& inSourcePath, SMeshOptimizationStats* outStats = nullptr);
+
+		// True if the cooked file exists, was written with the current CookedMeshVersion and matches the source file on disk
+		static bool IsCookedMeshUpToDate(const eastl::string& inSourcePath);
+
+		// Reads the cooked file through a memory mapping, each section is copied straight into outMeshData. Fails if the cooked file is stale
+		static bool LoadCookedMesh(const eastl::string& inSourcePath, SMeshData& outMeshData);
+	};
+}
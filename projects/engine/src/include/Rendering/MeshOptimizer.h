@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/vector.h>
+
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	// Normal or tangent in R8G8B8A8_SNORM. The w component holds the tangent's handedness, and is 0 for normals
+	using PackedNormal_t = uint32_t;
+
+	// Texture coordinate in R16G16_FLOAT
+	using PackedTexCoord_t = uint32_t;
+
+	/*
+		Index and vertex stream optimizations run when meshes are imported. Works on the triangle list of a single sub-mesh,
+		with 32-bit indices local to that sub-mesh. Doesn't touch the graphics driver, so the offline MeshCooker tool can use it.
+	*/
+	class UMeshOptimizer
+	{
+	public:
+		UMeshOptimizer() = delete;
+
+		// Size of the FIFO post-transform cache that ACMR is measured against
+		static const uint32_t DefaultCacheSize = 16;
+
+		// Average number of vertex shader invocations per triangle for a simulated FIFO cache. 0.5 is ideal, 3 is the worst case
+		static float CalculateACMR(const uint32_t* inIndices, uint32_t inIndexCount, uint32_t inVertexCount, uint32_t inCacheSize = DefaultCacheSize);
+
+		// Reorders triangles to make best use of the post-transform vertex cache (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+		static void OptimizeVertexCache(uint32_t* inOutIndices, uint32_t inIndexCount, uint32_t inVertexCount);
+
+		/*
+			Reorders the triangles of a cache optimized index list so that outward facing parts of the mesh are drawn first, to cut
+			down on overdraw. The list is split into clusters where the cache would have to be refilled anyway, so cache
+			efficiency is mostly kept (Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+		*/
+		static void OptimizeOverdraw(uint32_t* inOutIndices, uint32_t inIndexCount, const Vector3* inPositions, uint32_t inVertexCount);
+
+		/*
+			Builds a remap table that lays vertices out in the order the index list first uses them, and rewrites the indices to
+			match. outRemap[oldVertex] is the vertex's new position. Unused vertices are moved to the end. Returns the number of
+			vertices that are used.
+		*/
+		static uint32_t OptimizeVertexFetch(uint32_t* inOutIndices, uint32_t inIndexCount, uint32_t inVertexCount, eastl::vector<uint32_t>& outRemap);
+
+		/*
+			Builds a coarser index list over the same vertices by collapsing edges in order of their quadric error (Garland and
+			Heckbert, "Surface Simplification Using Quadric Error Metrics"). Vertices only ever collapse onto other existing
+			vertices, and vertices on open edges (including UV and normal seams, where vertices are split) are never moved, so
+			the vertex streams don't need to change. Stops once the list is down to inTargetIndexCount or nothing else can be
+			collapsed without flipping a triangle. Returns the largest error of any collapse that was made.
+		*/
+		static float SimplifyMesh(const uint32_t* inIndices, uint32_t inIndexCount, const Vector3* inPositions, uint32_t inVertexCount,
+								  uint32_t inTargetIndexCount, eastl::vector<uint32_t>& outIndices);
+
+		// Reorders a vertex stream with a table made by OptimizeVertexFetch
+		template <typename T>
+		static void RemapVertexStream(T* inOutVertices, const eastl::vector<uint32_t>& inRemap);
+
+		static PackedNormal_t PackNormal(const Vector3& inNormal);
+		static PackedNormal_t PackTangent(const Vector4& inTangent);
+		static Vector4 UnpackNormal(PackedNormal_t inPackedNormal);
+
+		// Half floats lose too much precision far from the origin, so only coordinates within [-1, 1] are packed
+		static bool CanPackTexCoords(const Vector2* inTexCoords, uint32_t inCount);
+		static PackedTexCoord_t PackTexCoord(const Vector2& inTexCoord);
+	};
+
+	template <typename T>
+	void UMeshOptimizer::RemapVertexStream(T* inOutVertices, const eastl::vector<uint32_t>& inRemap)
+	{
+		const eastl::vector<T> originalVertices(inOutVertices, inOutVertices + inRemap.size());
+
+		for (size_t i = 0; i < inRemap.size(); ++i)
+		{
+			inOutVertices[inRemap[i]] = originalVertices[i];
+		}
+	}
+}
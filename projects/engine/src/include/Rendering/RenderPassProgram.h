@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include <EASTL/shared_ptr.h>
 #include <EASTL/string.h>
 #include <EASTL/hash_map.h>
@@ -30,11 +32,21 @@ namespace MAD
 		void SetGS(const GeometryShaderPtr_t& inGS) { m_gs = inGS; }
 		void SetPS(const PixelShaderPtr_t& inPS) { m_ps = inPS; }
 
-		void BindToPipeline(class UGraphicsDriver& inGraphicsDriver);
+		// False until every shader of the permutation has been created. Only changes on the main thread, outside of rendering
+		bool IsReady() const { return m_isReady; }
+		void SetReady() { m_isReady = true; }
+
+		// True for the first caller only, so that a permutation is only queued for compilation once. Thread safe
+		bool TryBeginCompile() { return !m_isCompileQueued.exchange(true); }
+
+		void BindToPipeline(class UGraphicsDriver& inGraphicsDriver) const;
 	private:
 		VertexShaderPtr_t m_vs;
 		GeometryShaderPtr_t m_gs;
 		PixelShaderPtr_t m_ps;
+
+		bool m_isReady;
+		std::atomic<bool> m_isCompileQueued;
 	};
 
 	using ProgramId_t = uint64_t;
@@ -52,10 +64,21 @@ namespace MAD
 		static const eastl::string& ConvertShaderTypeToString(EProgramShaderType inShaderType);
 		static EProgramShaderType ConvertStringToShaderType(const eastl::string& inShaderTypeString);
 	public:
+		/*
+		* Binds the shaders of a permutation. Permutations that are still compiling (see UProgramPermutor) are queued for
+		* compilation the first time they're asked for, and the closest permutation that is ready and only lacks some of the
+		* material features is bound in their place until then. Safe to call from the render pass recording threads
+		*/
 		bool SetProgramActive(class UGraphicsDriver& inGraphicsDriver, ProgramId_t inTargetProgramId) const;
+
+		// The compiled bytecode isn't kept around, so this only counts the permutation bookkeeping
+		size_t GetMemorySize() const;
 	private:
 		static const eastl::hash_map<eastl::string, EProgramShaderType> s_entryPointToShaderTypeMap;
 	private:
+		const UPassProgram* FindReadyFallback(ProgramId_t inTargetProgramId) const;
+
 		ProgramPermutations_t m_programPermutations;
+		eastl::shared_ptr<const struct SProgramSourceDescription> m_programSource;
 	};
 }
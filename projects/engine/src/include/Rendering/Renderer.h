@@ -5,11 +5,13 @@
 #include <EASTL/array.h>
 #include <EASTL/unique_ptr.h>
 
+#include "Rendering/GraphicsDriver.h"
 #include "Rendering/GraphicsDriverTypes.h"
 #include "Rendering/RenderingCommon.h"
 #include "Rendering/RenderPassDescriptor.h"
 #include "Rendering/RenderPassProgram.h"
 #include "Rendering/DrawItem.h"
+#include "Rendering/ShadowCascades.h"
 #include "Rendering/CameraInstance.h"
 #include "Rendering/DepthTextureCube.h"
 #include "Rendering/ColorTextureCube.h"
@@ -39,6 +41,45 @@ namespace MAD
 		SDrawItem m_debugDrawItem;
 	};
 
+	/*
+		Snapshot of a queued draw item taken on the main thread before any pass is recorded. The draw item containers
+		aren't modified again until every recording job has finished, so the workers can read through these freely
+	*/
+	struct SDrawItemSnapshot
+	{
+		const SDrawItem* m_drawItem;
+		ProgramId_t m_programId;
+		uint32_t m_objectToWorldIndex; // Into the renderer's object to world matrices for the frame
+		SDrawItemConstants m_uploadedConstants; // Main camera per-draw constants and cached material constants
+		uint8_t m_lod; // Picked from the item's size on screen
+		uint8_t m_shadowLOD; // Coarser LOD for the shadow and reflection probe passes
+	};
+
+	// Draw items that share a mesh, sub-mesh and material, drawn with one instanced draw call
+	struct SInstancedDrawSnapshot
+	{
+		SDrawItemSnapshot m_snapshot; // First draw item of the group, supplies the input assembly and material for every instance
+		SInstanceBufferRange m_instances;
+		Vector4 m_worldBounds; // Bounding sphere of every instance (xyz center, w radius)
+	};
+
+	// Passes that only walk draw items and can therefore be recorded on a deferred context by any job thread
+	enum class ERecordedPass : uint8_t
+	{
+		ReflectionProbeFace,
+		GBuffer,
+		DirectionalShadow,
+		PointShadowFace,
+		DebugPrimitives
+	};
+
+	struct SPassRecordJob
+	{
+		ERecordedPass m_pass;
+		uint32_t m_lightIndex;
+		uint8_t m_faceIndex; // Cube face or shadow cascade, depending on the pass
+	};
+
 	class URenderer
 	{
 	public:
@@ -85,6 +126,11 @@ namespace MAD
 		void ToggleTextBatching();
 
 		POINT GetScreenSize() const;
+
+		// Number of buffer maps issued by all of the graphics drivers during the last completed frame, and how many there would
+		// have been with a constant buffer update per draw (see UGraphicsDriver::GetUnbatchedMapCount)
+		uint32_t GetLastFrameMapCount() const { return m_lastFrameMapCount; }
+		uint32_t GetLastFrameUnbatchedMapCount() const { return m_lastFrameUnbatchedMapCount; }
 	private:
 		// TODO: Eventually be able to initiliaze/load them from file
 		void InitializeRenderPasses();
@@ -122,9 +168,32 @@ namespace MAD
 		void DrawPointLighting(float inFramePercent);
 		void DrawDebugPrimitives(float inFramePerecent);
 
-		void ProcessReflectionProbes(float inFramePercent);
+		void ProcessReflectionProbes();
 		void DoVisualizeGBuffer();
 
+		// Snapshots this frame's draw items and lights, then records every draw item pass in parallel on the job threads
+		void RecordPasses(float inFramePercent);
+		uint32_t AddPassRecordJob(ERecordedPass inPass, uint32_t inLightIndex = 0, uint8_t inFaceIndex = 0);
+		void RecordPass(const SPassRecordJob& inJob, CommandListPtr_t& outCommandList) const;
+
+		void RecordReflectionProbeFace(UGraphicsDriver& inRecordingDriver, uint8_t inCubeFace) const;
+		void RecordGBuffer(UGraphicsDriver& inRecordingDriver) const;
+		void RecordDirectionalShadowCascade(UGraphicsDriver& inRecordingDriver, uint32_t inLightIndex, uint8_t inCascadeIndex) const;
+		void RecordPointShadowFace(UGraphicsDriver& inRecordingDriver, uint32_t inLightIndex, uint8_t inCubeFace) const;
+		void RecordDebugPrimitives(UGraphicsDriver& inRecordingDriver) const;
+		void DrawShadowCasters(UGraphicsDriver& inRecordingDriver, const SRenderPassDescriptor& inShadowPass, ProgramId_t inShadowProgramId, const SShadowCascade* inCascade = nullptr) const;
+		void FitDirectionalShadowCascades(const Vector3& inWSLightDirection, SPerDirectionalLightConstants& inOutLightConstants);
+
+		uint32_t AcquireDynamicDrawSlot(size_t inUniqueID);
+		void ReleaseStaleDynamicDrawSlots();
+
+		void AddDrawItemSnapshot(eastl::vector<SDrawItemSnapshot>& inOutSnapshot, const SDrawItem& inDrawItem, const Matrix& inObjectToWorldMatrix, bool inAllowInstancing = false, bool inSelectLOD = false);
+		uint8_t SelectDrawItemLOD(const SDrawItem& inDrawItem, const Vector4& inWorldBounds, uint8_t inPreviousLOD) const;
+		void BuildInstancedDraws();
+		void UploadPerDrawConstants(UGraphicsDriver& inGraphicsDriver, const SPerFrameConstants& inPerFrameConstants, const eastl::vector<SDrawItemSnapshot>& inSnapshot, eastl::vector<SConstantBufferRange>& outPerDrawConstants) const;
+		void UploadMainViewPerDrawConstants(eastl::vector<SDrawItemSnapshot>& inOutSnapshot);
+		void GatherFrameMapCount();
+
 		ProgramId_t DetermineProgramId(const SDrawItem& inTargetDrawItem) const;
 	private:
 		uint32_t m_frame;
@@ -139,6 +208,7 @@ namespace MAD
 
 		// Double-buffer draw items for current and past frame for state interpolation
 		int m_currentStateIndex;
+		uint32_t m_queueFrame; // Incremented every time the queued render items are cleared
 		SCameraInstance m_camera[2];
 
 		eastl::vector<SDebugHandle> m_debugDrawItems;
@@ -148,6 +218,16 @@ namespace MAD
 		eastl::hash_map<size_t, SDrawItem> m_reflectionProbeDrawItems;
 		eastl::hash_map<size_t, SDrawItem> m_dynamicDrawItems[2]; // Dynamic draw items
 
+		// Dynamic draw items keep the same transform slot for as long as they're queued every frame, the transforms are
+		// double-buffered per slot so interpolating them doesn't need to look anything up in the previous frame's draw items
+		eastl::hash_map<size_t, uint32_t> m_dynamicDrawSlots;
+		eastl::vector<ULinearTransform> m_dynamicSlotTransforms[2];
+		eastl::vector<uint32_t> m_dynamicSlotQueueFrames[2];
+		eastl::vector<uint32_t> m_freeDynamicDrawSlots;
+
+		// LOD each draw item was drawn with, for the current and previous frame. Changing LODs is biased towards the
+		// previous one so that items sitting on a threshold don't flicker between them
+		eastl::hash_map<size_t, uint8_t> m_drawItemLODs[2];
 
 		eastl::hash_map<size_t, SGPUDirectionalLight> m_queuedDirLights[2];
 		eastl::hash_map<size_t, SGPUPointLight> m_queuedPointLights[2];
@@ -167,6 +247,44 @@ namespace MAD
 		eastl::vector<ShaderResourcePtr_t> m_gBufferShaderResources;
 		eastl::unique_ptr<UDepthTextureCube> m_depthTextureCube;
 
+		// One deferred driver per job thread, each with its own constant buffers for staging
+		eastl::vector<eastl::unique_ptr<UGraphicsDriver>> m_recordingDrivers;
+
+		// Per-draw constants of the reflection probe faces, one reused list per job thread so the snapshots stay read-only
+		mutable eastl::vector<eastl::vector<SConstantBufferRange>> m_recordingPerDrawConstants;
+
+		// Per-frame recording state, rebuilt at the start of every Draw()
+		eastl::vector<SDrawItemSnapshot> m_staticSnapshot;
+		eastl::vector<SDrawItemSnapshot> m_dynamicSnapshot;
+		eastl::vector<SDrawItemSnapshot> m_reflectionProbeSnapshot;
+		eastl::vector<SConstantBufferRange> m_mainViewPerDrawConstants; // Scratch for UploadMainViewPerDrawConstants
+		eastl::vector<Matrix> m_frameObjectToWorldMatrices; // Interpolated once per frame and shared by every pass
+		eastl::vector<Vector4> m_frameWorldBounds; // World space bounding spheres, same indices as the matrices
+		eastl::vector<SInstancedDrawSnapshot> m_instancedSnapshot;
+		eastl::vector<eastl::pair<SDrawItemSnapshot, eastl::vector<SDrawItemSnapshot>*>> m_instancingCandidates; // Candidate and the snapshot it goes to if it ends up alone
+		eastl::vector<SPerInstanceData> m_frameInstanceData;
+		eastl::vector<uint32_t> m_releasedMaterialIDs;
+		eastl::vector<SPerDirectionalLightConstants> m_frameDirLights;
+		eastl::vector<SShadowCascade> m_frameDirCascades; // SPerDirectionalLightConstants::CascadeCount per directional light
+		eastl::vector<SPerPointLightConstants> m_framePointLights;
+		CubeTransformArray_t m_probeViewMatrices;
+		Matrix m_probeProjectionMatrix;
+
+		// Recorded command lists are stored in the same (submission) order as their jobs
+		eastl::vector<SPassRecordJob> m_passRecordJobs;
+		eastl::vector<CommandListPtr_t> m_recordedCommandLists;
+		uint32_t m_firstReflectionProbeList;
+		uint32_t m_gBufferList;
+		uint32_t m_firstDirShadowList;
+		uint32_t m_firstPointShadowList;
+		uint32_t m_debugList;
+
+		uint32_t m_lastFrameMapCount;
+		uint32_t m_lastFrameUnbatchedMapCount;
+		uint64_t m_totalMapCount; // Over every frame so far, logged on shutdown
+		uint64_t m_totalUnbatchedMapCount;
+		uint32_t m_mapCountFrames;
+
 		UTextBatchRenderer m_textBatchRenderer;
 		UParticleSystemManager m_particleSystemManager;
 		UColorTextureCube m_globalEnvironmentMap;
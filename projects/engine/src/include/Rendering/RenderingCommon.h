@@ -306,6 +306,7 @@ namespace MAD
 		Normal,
 		Tangent,
 		UV,
+		Instance,
 
 		MAX
 	};
@@ -431,6 +432,13 @@ namespace MAD
 		Matrix m_objectToProjectionMatrix;
 	};
 
+	// Layout of one element of the per-instance vertex stream (EVertexBufferSlot::Instance) used by instanced draws
+	struct SPerInstanceData
+	{
+		Matrix m_objectToWorldMatrix;
+	};
+	static_assert(sizeof(SPerInstanceData) == 64, "");
+
 	struct SPerPointLightConstants
 	{
 		SGPUPointLight m_pointLight;
@@ -440,6 +448,18 @@ namespace MAD
 
 	struct SPerDirectionalLightConstants
 	{
+		static constexpr uint32_t CascadeCount = 4; // Must match SHADOW_CASCADE_COUNT in Common.hlsl
+
 		SGPUDirectionalLight m_directionalLight;
+
+		Matrix m_cascadeViewProjectionMatrices[CascadeCount];
+		float m_cascadeSplitDepths[CascadeCount]; // View space depth where each cascade ends
+		float m_shadowAtlasTexelSize;
+
+	private:
+		float __pad1 = 0.0f;
+		float __pad2 = 0.0f;
+		float __pad3 = 0.0f;
 	};
+	static_assert(sizeof(SPerDirectionalLightConstants) == 384, "");
 }
\ No newline at end of file
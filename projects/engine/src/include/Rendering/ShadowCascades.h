@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Core/SimpleMath.h"
+
+namespace MAD
+{
+	/*
+		Light space fit of one slice of the camera frustum. The orthographic window keeps the same size however the camera
+		is oriented (it's derived from the slice's bounding sphere) and only moves in whole shadow map texels, which keeps
+		the shadow edges from shimmering as the camera moves
+	*/
+	struct SShadowCascade
+	{
+		Matrix m_lightViewMatrix;
+		Matrix m_viewProjectionMatrix;
+
+		// Light view space bounds covered by the cascade. Depth is measured along the light direction, away from the light
+		Vector2 m_lightSpaceMin;
+		Vector2 m_lightSpaceMax;
+		float m_lightSpaceNear;
+		float m_lightSpaceFar;
+
+		float m_splitNear;
+		float m_splitFar;
+	};
+
+	/*
+		CPU side cascaded shadow map math. Doesn't touch the graphics driver, so it can be used (and verified) in isolation
+	*/
+	class UShadowCascades
+	{
+	public:
+		UShadowCascades() = delete;
+
+		/*
+			Splits [inNear, inFar] into inCascadeCount slices, blending between a logarithmic (inSplitLambda = 1)
+			and a uniform (inSplitLambda = 0) distribution. outSplitDistances[i] receives the far distance of cascade i
+		*/
+		static void CalculateSplitDistances(float inNear, float inFar, float inSplitLambda, uint32_t inCascadeCount, float* outSplitDistances);
+
+		/*
+			Fits an orthographic projection for inLightDirection around the slice [inSliceNear, inSliceFar] of a perspective camera.
+			inCasterDepthExtension pulls the near plane towards the light so that casters outside of the slice still cast into it
+		*/
+		static SShadowCascade FitCascade(const Vector3& inLightDirection,
+										 const Matrix& inCameraInverseViewMatrix,
+										 const Matrix& inCameraProjectionMatrix,
+										 float inSliceNear,
+										 float inSliceFar,
+										 uint32_t inShadowMapResolution,
+										 float inCasterDepthExtension);
+
+		/*
+			Splits [inNear, inShadowDistance] with CalculateSplitDistances() and fits one cascade to each slice with FitCascade().
+			Each slice starts where the previous one ends, outCascades receives inCascadeCount cascades
+		*/
+		static void FitCascades(const Vector3& inLightDirection,
+								const Matrix& inCameraInverseViewMatrix,
+								const Matrix& inCameraProjectionMatrix,
+								float inNear,
+								float inShadowDistance,
+								float inSplitLambda,
+								uint32_t inCascadeCount,
+								uint32_t inShadowMapResolution,
+								float inCasterDepthExtension,
+								SShadowCascade* outCascades);
+
+		// Conservative test of a world space sphere against the volume that can cast into the cascade. Negative radii are unbounded
+		static bool CanCastIntoCascade(const SShadowCascade& inCascade, const Vector3& inWSCenter, float inRadius);
+	};
+}
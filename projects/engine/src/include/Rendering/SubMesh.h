@@ -1,15 +1,54 @@
 #pragma once
 
+#include <cstring>
+
+#include "Core/SimpleMath.h"
+
 namespace MAD
 {
+	// Full detail plus up to three simplified index lists
+	const UINT MaxMeshLODs = 4;
+
+	// Index range of one level of detail. The start is in units of the sub-mesh's index size from the beginning of the
+	// mesh's index data
+	struct SMeshLOD
+	{
+		UINT m_indexStart;
+		UINT m_indexCount;
+	};
+
 	struct SSubMesh
 	{
 		UINT m_vertexStart;
 		UINT m_vertexCount;
 
-		UINT m_indexStart;
-		UINT m_indexCount;
+		// Indices are local to the sub-mesh, so each sub-mesh uses 16-bit indices unless it has more vertices than that can
+		// address. Every LOD indexes the same vertices, LOD 0 is the full detail mesh
+		SMeshLOD m_lods[MaxMeshLODs];
+		UINT m_lodCount;
+		UINT m_indexSize;
 
 		UINT m_materialIndex;
+
+		// Object space bounding sphere of the sub-mesh's vertices
+		Vector3 m_boundsCenter;
+		float m_boundsRadius;
 	};
+
+	// Reads one of a sub-mesh's indices out of its mesh's index data, whichever size they are
+	inline UINT GetSubMeshIndex(const uint8_t* inIndexData, const SSubMesh& inSubMesh, UINT inIndex, UINT inLOD = 0)
+	{
+		const uint8_t* indexAddress = inIndexData + (inSubMesh.m_lods[inLOD].m_indexStart + inIndex) * inSubMesh.m_indexSize;
+
+		if (inSubMesh.m_indexSize == sizeof(uint32_t))
+		{
+			uint32_t index;
+			memcpy(&index, indexAddress, sizeof(index));
+			return index;
+		}
+
+		uint16_t index;
+		memcpy(&index, indexAddress, sizeof(index));
+		return index;
+	}
 }
@@ -3,6 +3,7 @@
 #include <EASTL/string.h>
 #include <EASTL/shared_ptr.h>
 
+#include "Misc/AssetCache.h"
 #include "Rendering/GraphicsDriverTypes.h"
 
 namespace MAD
@@ -14,22 +15,53 @@ namespace MAD
 		 * Loads a texture at the given path. The path should be relative to the assets root directory. Internally uses a cache
 		 * to ensure textures are only loaded once. Will load a default (checker pattern) texture if the texture at the given
 		 * path could not be loaded.
+		 *
+		 * Textures that have an up to date cooked file (see UTextureCooker) are loaded from it with only their smallest mips
+		 * resident, and UTextureStreamer brings in the rest as they're needed. Their mips are never generated at runtime.
 		 */
 		static eastl::shared_ptr<UTexture> Load(const eastl::string& inRelativePath, bool inLoadAsSRGB, bool inGenerateMips, int32_t inMiscFlags = 0);
 
+		/*
+		 * Asynchronous version of Load. The file is read on the asset loader threads, and so is the texture creation when no
+		 * mips need to be generated. Mip generation needs the immediate context, so those textures are created on the main
+		 * thread when the load is finalized. A texture that fails to load resolves to (and is cached as) the default texture.
+		 */
+		static TAssetHandle<UTexture> LoadAsync(const eastl::string& inRelativePath, bool inLoadAsSRGB, bool inGenerateMips, int32_t inMiscFlags = 0);
+
 		// Load textures using UTexture::Load(...)
 		UTexture();
 		
 		ShaderResourcePtr_t GetTexureResource() const { return m_textureSRV; }
 
+		// Full size of the texture, streamed textures may not have their largest mips resident
 		uint64_t GetWidth() const { return m_width; }
 		uint64_t GetHeight() const { return m_height; }
+
+		bool IsStreamed() const { return !m_cookedPath.empty(); }
+
+		// Estimated from the texture's format, dimensions and resident mip chain
+		size_t GetMemorySize() const;
 	private:
+		friend class UTextureStreamer;
+
 		uint64_t m_width;
 		uint64_t m_height;
 
 		ShaderResourcePtr_t m_textureSRV;
 
+		// Streaming state, see UTextureStreamer. Main thread only
+		eastl::string m_cookedPath; // Empty if the texture isn't streamed
+		eastl::string m_relativePath; // Asset cache path, its cached size is updated as mips stream in and out
+		bool m_isSRGB;
+		bool m_isStreamingInFlight;
+		uint32_t m_residentSize; // Largest dimension of the most detailed resident mip
+		uint32_t m_requestedSize; // Largest size on screen the renderer asked for, in pixels
+		uint32_t m_requestFrame; // Streamer frame m_requestedSize was last reported in
+
 		static eastl::shared_ptr<UTexture> GetDefaultTexture();
+		static eastl::shared_ptr<UTexture> CreateFromMemory(const eastl::string& inRelativePath, const void* inData, size_t inDataSize, bool inLoadAsSRGB, bool inGenerateMips, int32_t inMiscFlags);
+
+		// Null if the texture has no up to date cooked file. Only touches the device, so it's safe on the asset loader threads
+		static eastl::shared_ptr<UTexture> CreateFromCookedFile(const eastl::string& inRelativePath, bool inLoadAsSRGB);
 	};
 }
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/string.h>
+
+namespace MAD
+{
+	// How a texture is sampled, picks the block compressed format and how its mips are filtered
+	enum class ETextureUsage : uint8_t
+	{
+		Color, // sRGB color, BC1 or BC3 if it has alpha
+		NormalMap, // Mips are renormalized, BC1 so that the shaders can keep reading xyz
+		Mask // Single channel, BC4
+	};
+
+	// What the streamer needs to know about a cooked texture without creating it
+	struct SCookedTextureInfo
+	{
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_mipCount;
+	};
+
+	/*
+		Converts source images (anything WIC can decode) into block compressed DDS files with their whole mip chain. Cooked
+		files sit next to their source with a ".dds" extension. They're regular DDS files, the size and write time of the
+		source is kept in the header's reserved words so that an edited source is detected as stale, like cooked meshes.
+		Doesn't touch the graphics driver, so it can be used from the offline MeshCooker tool.
+
+		Sources whose dimensions aren't a multiple of 4 can't be block compressed and are cooked as R8G8B8A8 instead.
+
+		All paths are full paths to the source texture.
+	*/
+	class UTextureCooker
+	{
+	public:
+		UTextureCooker() = delete;
+
+		// Bump whenever the cooked layout or the encoders change, to invalidate existing cooked files
+		static const uint32_t CookedTextureVersion;
+
+		static eastl::string GetCookedTexturePath(const eastl::string& inSourcePath);
+
+		// Decodes the source, generates its mips and writes its cooked file
+		static bool CookTexture(const eastl::string& inSourcePath, ETextureUsage inUsage);
+
+		static bool IsCookedTextureUpToDate(const eastl::string& inSourcePath);
+
+		// Validates a cooked file that has already been read or mapped into memory. Fails if it's stale or isn't one of ours
+		static bool ReadCookedTextureInfo(const void* inCookedData, size_t inCookedDataSize, const eastl::string& inSourcePath, SCookedTextureInfo& outInfo);
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include <EASTL/shared_ptr.h>
+#include <EASTL/vector.h>
+#include <EASTL/weak_ptr.h>
+
+namespace MAD
+{
+	class UTexture;
+
+	/*
+	 * Keeps the resident mips of cooked textures in line with how large they're drawn. The renderer reports the size each
+	 * texture covers on screen, and every Tick the streamer works out how large each texture's most detailed resident mip
+	 * should be. Textures that are no longer drawn fall back to their smallest mips after a while, and when the wanted mips
+	 * don't fit in the memory budget the textures drawn the smallest give up detail first.
+	 *
+	 * D3D11 textures can't change their mip chain without tiled resources, so a texture that needs different mips is
+	 * recreated from its cooked file on the asset loader threads and swapped in when the load is finalized.
+	 */
+	class UTextureStreamer
+	{
+	public:
+		UTextureStreamer() = delete;
+
+		// Mips up to this size are always resident, so that a texture can be drawn as soon as it's loaded
+		static const uint32_t MinResidentSize = 64;
+
+		// Bytes the streamed textures may take up together. 0 means unlimited
+		static void SetMemoryBudget(size_t inBudgetBytes) { s_memoryBudget = inBudgetBytes; }
+
+		// Main thread only
+		static void Register(const eastl::shared_ptr<UTexture>& inTexture);
+
+		// Reports that inTexture is drawn inScreenSize pixels wide this frame. Main thread only
+		static void RequestSize(UTexture& inTexture, float inScreenSize);
+
+		// Picks the wanted mips of every streamed texture and queues the reloads. Main thread only
+		static void Tick();
+
+		static size_t GetResidentMemory() { return s_residentMemory; }
+	private:
+		struct SStreamingCandidate
+		{
+			eastl::shared_ptr<UTexture> m_texture;
+			uint32_t m_wantedSize;
+			size_t m_wantedMemory;
+		};
+
+		static void QueueReload(const eastl::shared_ptr<UTexture>& inTexture, uint32_t inWantedSize);
+
+		static eastl::vector<eastl::weak_ptr<UTexture>> s_textures;
+		static size_t s_memoryBudget;
+		static size_t s_residentMemory;
+		static uint32_t s_currentFrame;
+		static uint32_t s_reloadsInFlight;
+	};
+}
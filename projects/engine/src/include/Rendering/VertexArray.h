@@ -12,12 +12,14 @@ namespace MAD
 		UVertexArray();
 		UVertexArray(class UGraphicsDriver& inGraphicsDriver, VertexBufferSlotType_t inSlot, EInputLayoutSemantic::Type inSemantic, 
 					 const void* inVertexData, uint32_t inVertexSize, uint32_t inVertexCount,
-					 EResourceUsage inUsage = EResourceUsage::Immutable, ECPUAccess inCPUAccessFlag = ECPUAccess::None);
+					 EResourceUsage inUsage = EResourceUsage::Immutable, ECPUAccess inCPUAccessFlag = ECPUAccess::None,
+					 InputLayoutFlags_t inFormatFlags = EInputLayoutFormat::None);
 
 		void Bind(class UGraphicsDriver& inGraphicsDriver, uint32_t inOffset) const;
 		void Update(class UGraphicsDriver& inGraphicsDriver, const void* inData, size_t inDataSize);
 		bool Empty() const { return m_bufferSize == 0; }
 		EInputLayoutSemantic::Type GetSemantic() const { return m_arraySemantic; }
+		InputLayoutFlags_t GetFormatFlags() const { return m_formatFlags; }
 		uint32_t GetVertexCount() const { return m_vertexCount; }
 		uint32_t GetVertexSize() const { return m_vertexSize; }
 
@@ -28,5 +30,6 @@ namespace MAD
 		uint32_t m_bufferSize;
 		VertexBufferSlotType_t m_arrayUsage;
 		EInputLayoutSemantic::Type m_arraySemantic;
+		InputLayoutFlags_t m_formatFlags;
 	};
 }
@@ -5,6 +5,7 @@
 #include "Core/PointLightComponent.h"
 #include "Core/MeshComponent.h"
 #include "Core/CameraComponent.h"
+#include "Core/CharacterMovementComponent.h"
 #include "Core/MoveComponent.h"
 
 #include "Networking/Network.h"
@@ -217,6 +218,16 @@ namespace MAD
 				auto controller = AddComponent<CDemoCharacterController>();
 				characterMesh->AttachComponent(controller);
 
+				// Walks the cube around, the move component only replicates where it looks
+				SCharacterMovementSettings movementSettings;
+				movementSettings.m_radius = 25.0f;
+				movementSettings.m_halfHeight = 5.0f;
+				movementSettings.m_stepHeight = 15.0f;
+
+				auto characterMovement = AddComponent<CCharacterMovementComponent>();
+				characterMovement->SetSettings(movementSettings);
+				characterMesh->AttachComponent(characterMovement);
+
 				auto moveComponent = AddComponent<CMoveComponent>();
 				moveComponent->SetTargetComponent(characterMesh.get());
 				characterMesh->AttachComponent(moveComponent);
@@ -2,9 +2,11 @@
 
 #include "Core/Component.h"
 #include "Core/Entity.h"
+#include "Core/CharacterMovementComponent.h"
 #include "Core/ComponentPriorityInfo.h"
 #include "Core/PointLightComponent.h"
 #include "Core/MoveComponent.h"
+#include "Core/PhysicsWorld.h"
 #include "Core/Pipeline/GameWorldLoader.h"
 #include "Rendering/Renderer.h"
 
@@ -105,21 +107,20 @@ namespace MAD
 		private:
 			ULinearTransform m_transform;
 
-			void Move(const Vector3& inDelta)
+			// The character movement component collides the character with the world, so only ask it for a velocity
+			void Move(const Vector3& inVelocity)
 			{
-				if (inDelta == Vector3::Zero)
+				if (inVelocity == Vector3::Zero)
 				{
 					return;
 				}
 
 				if (UGameInput::Get().GetMouseMode() == EMouseMode::MM_Game)
 				{
-					m_transform.SetTranslation(m_transform.GetTranslation() + inDelta);
-
-					auto owningMoveComp = GetOwningEntity().GetFirstComponentByType<CMoveComponent>();
-					if (!owningMoveComp.expired())
+					auto characterMovement = GetOwningEntity().GetFirstComponentByType<CCharacterMovementComponent>().lock();
+					if (characterMovement)
 					{
-						owningMoveComp.lock()->AddDeltaPosition(inDelta);
+						characterMovement->AddMoveInput(inVelocity);
 					}
 				}
 			}
@@ -143,21 +144,36 @@ namespace MAD
 				}
 			}
 
+			// Walking stays level no matter how far the character looks up or down
+			Vector3 GetLevelDirection(const Vector3& inDirection) const
+			{
+				Vector3 levelDirection(inDirection.x, 0.0f, inDirection.z);
+				levelDirection.Normalize();
+				return levelDirection;
+			}
+
 			void MoveRight(float inVal)
 			{
-				Vector3 right = m_transform.GetRight();
-				Move(right * inVal * gEngine->GetDeltaTime() * m_moveSpeed);
+				Move(GetLevelDirection(m_transform.GetRight()) * inVal * m_moveSpeed);
 			}
 
 			void MoveForward(float inVal)
 			{
-				Vector3 forward = m_transform.GetForward();
-				Move(forward * inVal * gEngine->GetDeltaTime() * m_moveSpeed);
+				Move(GetLevelDirection(m_transform.GetForward()) * inVal * m_moveSpeed);
 			}
 
 			void MoveUp(float inVal)
 			{
-				Move(Vector3::Up * inVal * gEngine->GetDeltaTime() * m_moveSpeed);
+				if (inVal <= 0.0f || UGameInput::Get().GetMouseMode() != EMouseMode::MM_Game)
+				{
+					return;
+				}
+
+				auto characterMovement = GetOwningEntity().GetFirstComponentByType<CCharacterMovementComponent>().lock();
+				if (characterMovement)
+				{
+					characterMovement->Jump();
+				}
 			}
 
 			void LookRight(float inVal)
@@ -180,9 +196,18 @@ namespace MAD
 			void OnLineShoot()
 			{
 				const Vector3 lineStart = GetOwningEntity().GetWorldTranslation() + GetOwningEntity().GetForward() * 50.0f;
-				const Vector3 lineEnd = lineStart + GetOwningEntity().GetForward() * 350.0f;
+				Vector3 lineDirection = GetOwningEntity().GetForward();
+				lineDirection.Normalize();
+
+				// The line stops at the first body in its way
+				SQueryFilter lineFilter;
+				lineFilter.m_ignoredEntity = &GetOwningEntity();
 
-				gEngine->GetRenderer().DrawDebugLine(lineStart, lineEnd, 10.0f, Color(0.0f, 1.0f, 1.0f, 1.0f));
+				SQueryHit lineHit;
+				const bool isHit = gEngine->GetPhysicsWorld().Raycast(SRay(lineStart, lineDirection, 350.0f), lineHit, lineFilter);
+				const Vector3 lineEnd = isHit ? lineHit.m_position : lineStart + lineDirection * 350.0f;
+
+				gEngine->GetRenderer().DrawDebugLine(lineStart, lineEnd, 10.0f, isHit ? Color(1.0f, 0.0f, 0.0f, 1.0f) : Color(0.0f, 1.0f, 1.0f, 1.0f));
 			}
 
 			void ToggleMouseLock() const
@@ -351,7 +376,7 @@ namespace MAD
 				auto root = GetOwningEntity().GetRootComponent();
 				
 				float gameTime = gEngine->GetGameTime();
-				Vector3 offset = Vector3::Up * sinf(gameTime * m_moveSpeed) * m_distance;
+				Vector3 offset = Vector3::Up * DeterministicSin(gameTime * m_moveSpeed) * m_distance;
 
 				root->SetWorldTranslation(root->GetWorldTranslation() + offset);
 			}
@@ -398,7 +423,11 @@ namespace MAD
 					m_currentRotationAngle -= 360.0f;
 				}
 
-				resultPosition = m_initialPosition + (m_radius * (entityRight * cos(ConvertToRadians(m_currentRotationAngle)) + entityUp * sin(ConvertToRadians(m_currentRotationAngle))));
+				float rotationSin;
+				float rotationCos;
+				DeterministicSinCos(ConvertToRadians(m_currentRotationAngle), rotationSin, rotationCos);
+
+				resultPosition = m_initialPosition + (m_radius * (entityRight * rotationCos + entityUp * rotationSin));
 
 				GetOwningEntity().SetWorldTranslation(resultPosition);
 			}
@@ -0,0 +1,170 @@
+#include "Core/CharacterMovementComponent.h"
+#include "Core/GameEngine.h"
+#include "Core/PhysicsComponent.h"
+#include "Core/PhysicsWorld.h"
+#include "Core/Pipeline/GameWorldLoader.h"
+#include "Misc/Logging.h"
+#include "Networking/NetworkPlayer.h"
+
+#include <EASTL/algorithm.h>
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogCharacterMovement);
+
+	namespace
+	{
+		// Two seconds of ticks. Past that the server isn't answering, and there's no point keeping older inputs around
+		const size_t g_maxUnacknowledgedMoves = 120;
+	}
+
+	CCharacterMovementComponent::CCharacterMovementComponent(OGameWorld* inOwningWorld)
+		: Super_t(inOwningWorld) {}
+
+	void CCharacterMovementComponent::OnBeginPlay()
+	{
+		m_state.m_position = GetOwningEntity().GetWorldTranslation();
+		m_authorityState.m_state = m_state;
+	}
+
+	void CCharacterMovementComponent::Load(const UGameWorldLoader& inLoader, const UObjectValue& inPropertyObj)
+	{
+		UNREFERENCED_PARAMETER(inLoader);
+
+		float maxSlopeAngle;
+		if (inPropertyObj.GetProperty("maxSlopeAngle", maxSlopeAngle))
+		{
+			m_settings.m_maxSlopeAngle = ConvertToRadians(maxSlopeAngle);
+		}
+
+		inPropertyObj.GetProperty("radius", m_settings.m_radius);
+		inPropertyObj.GetProperty("halfHeight", m_settings.m_halfHeight);
+		inPropertyObj.GetProperty("stepHeight", m_settings.m_stepHeight);
+		inPropertyObj.GetProperty("maxMoveSpeed", m_settings.m_maxMoveSpeed);
+		inPropertyObj.GetProperty("jumpSpeed", m_settings.m_jumpSpeed);
+		inPropertyObj.GetProperty("airControl", m_settings.m_airControl);
+		inPropertyObj.GetProperty("pushMass", m_settings.m_pushMass);
+	}
+
+	void CCharacterMovementComponent::UpdateComponent(float)
+	{
+		if (!IsLocallyControlled())
+		{
+			return;
+		}
+
+		SCharacterMovementInput currentInput = m_pendingInput;
+		currentInput.m_tick = gEngine->GetGameTick();
+		m_pendingInput = SCharacterMovementInput();
+
+		if (GetNetMode() != ENetMode::Client)
+		{
+			ApplyInput(currentInput);
+			return;
+		}
+
+		// Predict the move, and keep the input around until the server's state includes it
+		SimulateInput(currentInput);
+
+		if (m_unacknowledgedMoves.size() >= g_maxUnacknowledgedMoves)
+		{
+			m_unacknowledgedMoves.erase(m_unacknowledgedMoves.begin());
+		}
+
+		m_unacknowledgedMoves.push_back({ currentInput, m_state.ComputeChecksum() });
+
+		gEngine->GetNetworkManager().SendNetworkEvent(EEventTarget::Server, MOVE_CHARACTER, GetOwningEntity(), &currentInput, sizeof(currentInput));
+	}
+
+	void CCharacterMovementComponent::OnEvent(EEventTypes inEventType, void* inEventData)
+	{
+		if (inEventType == MOVE_CHARACTER && GetNetMode() != ENetMode::Client)
+		{
+			// [-----------------------Server Only-----------------------------]
+
+			const SCharacterMovementInput* clientInput = reinterpret_cast<const SCharacterMovementInput*>(inEventData);
+
+			// Inputs that arrive late or twice were already replayed
+			if (clientInput->m_tick > m_authorityState.m_lastInputTick)
+			{
+				ApplyInput(*clientInput);
+			}
+		}
+	}
+
+	void CCharacterMovementComponent::GetReplicatedProperties(eastl::vector<SObjectReplInfo>& inOutReplInfo) const
+	{
+		Super_t::GetReplicatedProperties(inOutReplInfo);
+
+		MAD_ADD_REPLICATION_PROPERTY_CALLBACK(inOutReplInfo, EReplicationType::Always, CCharacterMovementComponent, m_authorityState, OnRep_AuthorityState);
+	}
+
+	bool CCharacterMovementComponent::IsLocallyControlled() const
+	{
+		// Characters without an owning player are driven by the server
+		if (const ONetworkPlayer* netOwner = GetNetOwner())
+		{
+			return netOwner->IsLocalPlayer();
+		}
+
+		return GetNetMode() != ENetMode::Client;
+	}
+
+	void CCharacterMovementComponent::SimulateInput(const SCharacterMovementInput& inInput)
+	{
+		SQueryFilter movementFilter;
+		movementFilter.m_ignoredEntity = &GetOwningEntity();
+
+		m_mover.Move(gEngine->GetPhysicsWorld(), m_settings, movementFilter, inInput, gEngine->GetDeltaTime(), m_state);
+		GetOwningEntity().SetWorldTranslation(m_state.m_position);
+	}
+
+	void CCharacterMovementComponent::ApplyInput(const SCharacterMovementInput& inInput)
+	{
+		SimulateInput(inInput);
+
+		// Changing the authority state replicates it
+		m_authorityState.m_state = m_state;
+		m_authorityState.m_lastInputTick = inInput.m_tick;
+
+		// Only the server pushes bodies around, since it's the one simulating them
+		for (const SCharacterContact& currentContact : m_mover.GetContacts())
+		{
+			auto contactBody = currentContact.m_body.lock();
+			if (contactBody && contactBody->IsDynamic() && currentContact.m_approachSpeed > 0.0f)
+			{
+				contactBody->AddImpulse(-currentContact.m_normal * (currentContact.m_approachSpeed * m_settings.m_pushMass));
+			}
+		}
+	}
+
+	void CCharacterMovementComponent::OnRep_AuthorityState()
+	{
+		m_state = m_authorityState.m_state;
+
+		if (IsLocallyControlled())
+		{
+			const uint32_t lastInputTick = m_authorityState.m_lastInputTick;
+			const uint64_t serverChecksum = m_state.ComputeChecksum();
+
+			for (const SPredictedMove& currentMove : m_unacknowledgedMoves)
+			{
+				if (currentMove.m_input.m_tick == lastInputTick && currentMove.m_stateChecksum != serverChecksum)
+				{
+					LOG(LogCharacterMovement, Warning, "Mispredicted the move of tick %u, server state %016llx, predicted state %016llx\n", lastInputTick, static_cast<unsigned long long>(serverChecksum), static_cast<unsigned long long>(currentMove.m_stateChecksum));
+				}
+			}
+
+			// Rewind to the server's state and replay what it hasn't seen yet on top of it
+			m_unacknowledgedMoves.erase(eastl::remove_if(m_unacknowledgedMoves.begin(), m_unacknowledgedMoves.end(), [lastInputTick](const SPredictedMove& inMove) { return inMove.m_input.m_tick <= lastInputTick; }), m_unacknowledgedMoves.end());
+
+			for (SPredictedMove& currentMove : m_unacknowledgedMoves)
+			{
+				SimulateInput(currentMove.m_input);
+				currentMove.m_stateChecksum = m_state.ComputeChecksum();
+			}
+		}
+
+		GetOwningEntity().SetWorldTranslation(m_state.m_position);
+	}
+}
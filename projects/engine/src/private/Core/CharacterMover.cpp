@@ -0,0 +1,295 @@
+#include "Core/CharacterMover.h"
+#include "Core/PhysicsWorld.h"
+#include "Core/SimulationChecksum.h"
+#include "Misc/Remotery.h"
+
+#include <EASTL/algorithm.h>
+
+namespace MAD
+{
+	namespace
+	{
+		// Gap kept between the capsule and everything around it, so that moving along a surface doesn't start out touching it
+		const float g_skinWidth = 0.5f;
+
+		// Surfaces hit at a grazing angle are backed off from as if the angle was this steep, so that the back off stays finite
+		const float g_minSkinAlignment = 0.1f;
+
+		// Planes a single move can slide along before it gives up on the rest of it
+		const uint32_t g_maxSlideIterations = 4;
+
+		// Bodies the capsule can be pushed out of at the start of a move, deepest first
+		const uint32_t g_maxDepenetrationIterations = 4;
+
+		// Moves shorter than this are dropped, they'd only jitter against whatever stopped them
+		const float g_minMoveDistance = 0.01f;
+	}
+
+	SCharacterMovementSettings::SCharacterMovementSettings()
+		: m_radius(40.0f)
+		, m_halfHeight(50.0f)
+		, m_maxSlopeAngle(ConvertToRadians(45.0f))
+		, m_stepHeight(35.0f)
+		, m_maxMoveSpeed(600.0f)
+		, m_jumpSpeed(450.0f)
+		, m_airControl(2.0f)
+		, m_pushMass(10.0f) {}
+
+	uint64_t SCharacterMovementState::ComputeChecksum() const
+	{
+		USimulationChecksum stateChecksum;
+		stateChecksum.Add(m_position);
+		stateChecksum.Add(m_velocity);
+		stateChecksum.Add(m_groundNormal);
+		stateChecksum.Add(m_isGrounded);
+
+		return stateChecksum.GetValue();
+	}
+
+	void UCharacterMover::Move(const UPhysicsWorld& inPhysicsWorld, const SCharacterMovementSettings& inSettings, const SQueryFilter& inFilter, const SCharacterMovementInput& inInput, float inDeltaTime, SCharacterMovementState& inOutState)
+	{
+		rmt_ScopedCPUSample(CharacterMover_Move, 0);
+
+		m_physicsWorld = &inPhysicsWorld;
+		m_filter = &inFilter;
+		m_shape.m_type = EPhysicsShapeType::Capsule;
+		m_shape.m_radius = inSettings.m_radius;
+		m_shape.m_halfHeight = inSettings.m_halfHeight;
+		m_minGroundNormalY = DeterministicCos(inSettings.m_maxSlopeAngle);
+		m_stepHeight = inSettings.m_stepHeight;
+		m_contacts.clear();
+
+		Depenetrate(inOutState.m_position);
+
+		// Remote inputs can't be trusted to stay under the speed limit
+		Vector3 moveVelocity(inInput.m_moveVelocity.x, 0.0f, inInput.m_moveVelocity.z);
+		const float moveSpeed = moveVelocity.Length();
+
+		if (moveSpeed > inSettings.m_maxMoveSpeed)
+		{
+			moveVelocity *= inSettings.m_maxMoveSpeed / moveSpeed;
+		}
+
+		Vector3& velocity = inOutState.m_velocity;
+		const bool wasGrounded = inOutState.m_isGrounded;
+
+		if (wasGrounded)
+		{
+			velocity = moveVelocity;
+
+			if (inInput.m_isJumping)
+			{
+				velocity.y = inSettings.m_jumpSpeed;
+				inOutState.m_isGrounded = false;
+			}
+		}
+		else
+		{
+			const float airBlend = eastl::min(inSettings.m_airControl * inDeltaTime, 1.0f);
+			velocity.x += (moveVelocity.x - velocity.x) * airBlend;
+			velocity.z += (moveVelocity.z - velocity.z) * airBlend;
+			velocity += inPhysicsWorld.GetGravity() * inDeltaTime;
+		}
+
+		Vector3 displacement = velocity * inDeltaTime;
+
+		// Walking follows the slope of the ground, instead of flying off of it going down or digging into it going up
+		if (inOutState.m_isGrounded)
+		{
+			displacement -= inOutState.m_groundNormal * displacement.Dot(inOutState.m_groundNormal);
+		}
+
+		Vector3 slidePosition = inOutState.m_position;
+		Vector3 slideVelocity = velocity;
+		const bool isBlocked = SlideMove(displacement, inOutState.m_isGrounded, slidePosition, slideVelocity);
+
+		if (!isBlocked || !inOutState.m_isGrounded || !TryStepUp(displacement, slidePosition, inOutState.m_position, velocity))
+		{
+			inOutState.m_position = slidePosition;
+			velocity = slideVelocity;
+		}
+
+		UpdateGround(wasGrounded && inOutState.m_isGrounded, inOutState);
+	}
+
+	void UCharacterMover::Depenetrate(Vector3& inOutPosition)
+	{
+		for (uint32_t i = 0; i < g_maxDepenetrationIterations; ++i)
+		{
+			m_overlapHits.clear();
+			if (m_physicsWorld->Overlap(m_shape, inOutPosition, Quaternion::Identity, m_overlapHits, *m_filter) == 0)
+			{
+				return;
+			}
+
+			// Deepest first, and the hits are ordered by how the broadphase happens to be laid out, so ties are broken by the
+			// normal. Client and server would push out of two equally deep bodies in different orders otherwise
+			const SQueryHit* deepestHit = &m_overlapHits[0];
+			for (const SQueryHit& currentHit : m_overlapHits)
+			{
+				const bool isDeeper = currentHit.m_penetration > deepestHit->m_penetration;
+				const bool isTied = currentHit.m_penetration == deepestHit->m_penetration;
+
+				if (isDeeper || (isTied && (currentHit.m_normal.x < deepestHit->m_normal.x || (currentHit.m_normal.x == deepestHit->m_normal.x && currentHit.m_normal.z < deepestHit->m_normal.z))))
+				{
+					deepestHit = &currentHit;
+				}
+			}
+
+			inOutPosition += deepestHit->m_normal * (deepestHit->m_penetration + g_skinWidth);
+		}
+	}
+
+	bool UCharacterMover::SlideMove(const Vector3& inDisplacement, bool inIsGrounded, Vector3& inOutPosition, Vector3& inOutVelocity)
+	{
+		Vector3 remaining = inDisplacement;
+		Vector3 previousNormal;
+		bool hasPreviousNormal = false;
+		bool isBlocked = false;
+
+		for (uint32_t i = 0; i < g_maxSlideIterations; ++i)
+		{
+			const float remainingLength = remaining.Length();
+			if (remainingLength < g_minMoveDistance)
+			{
+				break;
+			}
+
+			const Vector3 direction = remaining / remainingLength;
+			SQueryHit hit;
+			const float travel = GetSweepDistance(inOutPosition, direction, remainingLength, hit);
+
+			inOutPosition += direction * travel;
+
+			if (!hit.m_hasHit)
+			{
+				break;
+			}
+
+			AddContact(hit, inOutVelocity);
+
+			Vector3 normal = hit.m_normal;
+			const bool isWalkable = IsWalkable(normal);
+
+			if (!isWalkable)
+			{
+				isBlocked = true;
+
+				// Slopes too steep to walk on block like walls, instead of letting the character slide up them
+				if (inIsGrounded && normal.y > 0.0f)
+				{
+					normal.y = 0.0f;
+					normal.Normalize();
+				}
+			}
+
+			remaining = direction * (remainingLength - travel);
+			remaining -= normal * remaining.Dot(normal);
+
+			// Walking onto a slope turns the rest of the move up it, but the velocity stays level. Clipping it against the slope
+			// would send the character flying off the top like a jump
+			if (!inIsGrounded || !isWalkable)
+			{
+				inOutVelocity -= normal * eastl::min(inOutVelocity.Dot(normal), 0.0f);
+			}
+
+			// Sliding along the second plane ran back into the first, so follow the crease between them
+			if (hasPreviousNormal && remaining.Dot(previousNormal) < 0.0f)
+			{
+				Vector3 crease = previousNormal.Cross(normal);
+				crease.Normalize();
+
+				remaining = crease * crease.Dot(remaining);
+				inOutVelocity = crease * crease.Dot(inOutVelocity);
+			}
+
+			previousNormal = normal;
+			hasPreviousNormal = true;
+		}
+
+		return isBlocked;
+	}
+
+	bool UCharacterMover::TryStepUp(const Vector3& inDisplacement, const Vector3& inSlidePosition, Vector3& inOutPosition, Vector3& inOutVelocity)
+	{
+		// Up as far as the ceiling allows, across, then back down onto whatever the character stepped on
+		SQueryHit stepHit;
+		const float upDistance = GetSweepDistance(inOutPosition, Vector3::Up, m_stepHeight, stepHit);
+
+		Vector3 stepPosition = inOutPosition + Vector3::Up * upDistance;
+		Vector3 stepVelocity = inOutVelocity;
+		SlideMove(Vector3(inDisplacement.x, 0.0f, inDisplacement.z), false, stepPosition, stepVelocity);
+
+		const float downDistance = GetSweepDistance(stepPosition, -Vector3::Up, upDistance, stepHit);
+
+		// Didn't land on anything, or landed on something too steep to stand on
+		if (!stepHit.m_hasHit || !IsWalkable(stepHit.m_normal))
+		{
+			return false;
+		}
+
+		stepPosition -= Vector3::Up * downDistance;
+
+		// Only worth it if it got further than sliding did
+		const Vector3 stepTravel = stepPosition - inOutPosition;
+		const Vector3 slideTravel = inSlidePosition - inOutPosition;
+
+		if (stepTravel.x * stepTravel.x + stepTravel.z * stepTravel.z <= slideTravel.x * slideTravel.x + slideTravel.z * slideTravel.z)
+		{
+			return false;
+		}
+
+		inOutPosition = stepPosition;
+		inOutVelocity = stepVelocity;
+		inOutVelocity.y = 0.0f;
+		return true;
+	}
+
+	void UCharacterMover::UpdateGround(bool inWasGrounded, SCharacterMovementState& inOutState)
+	{
+		// Rising characters just jumped or were thrown, they can't land yet
+		if (inOutState.m_velocity.y > 0.0f)
+		{
+			inOutState.m_isGrounded = false;
+			return;
+		}
+
+		// Walking characters stick to the ground going down slopes and stairs, falling ones only land once they touch it
+		const float probeDistance = inWasGrounded ? m_stepHeight + g_skinWidth : 2.0f * g_skinWidth;
+
+		SQueryHit groundHit;
+		const float groundDistance = GetSweepDistance(inOutState.m_position, -Vector3::Up, probeDistance, groundHit);
+
+		if (!groundHit.m_hasHit || !IsWalkable(groundHit.m_normal))
+		{
+			inOutState.m_isGrounded = false;
+			inOutState.m_groundNormal = Vector3::Up;
+			return;
+		}
+
+		inOutState.m_position -= Vector3::Up * groundDistance;
+		inOutState.m_velocity.y = 0.0f;
+		inOutState.m_groundNormal = groundHit.m_normal;
+		inOutState.m_isGrounded = true;
+	}
+
+	void UCharacterMover::AddContact(const SQueryHit& inHit, const Vector3& inVelocity)
+	{
+		if (m_contacts.size() < MaxContacts)
+		{
+			m_contacts.push_back({ inHit.m_body, inHit.m_normal, eastl::max(-inVelocity.Dot(inHit.m_normal), 0.0f) });
+		}
+	}
+
+	float UCharacterMover::GetSweepDistance(const Vector3& inStart, const Vector3& inDirection, float inMaxDistance, SQueryHit& outHit) const
+	{
+		if (!m_physicsWorld->Sweep(m_shape, Quaternion::Identity, inStart, inStart + inDirection * inMaxDistance, outHit, *m_filter))
+		{
+			return inMaxDistance;
+		}
+
+		// Stop a skin short of the surface, measured along its normal
+		const float alignment = eastl::max(-inDirection.Dot(outHit.m_normal), g_minSkinAlignment);
+		return eastl::max(outHit.m_distance - g_skinWidth / alignment, 0.0f);
+	}
+}
@@ -0,0 +1,606 @@
+#include "Core/CollisionMesh.h"
+
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+
+#include <EASTL/algorithm.h>
+
+#include "Misc/AssetCache.h"
+#include "Misc/CookedFile.h"
+#include "Misc/JobSystem.h"
+#include "Misc/Logging.h"
+#include "Misc/MappedFile.h"
+#include "Misc/Remotery.h"
+#include "Rendering/MeshCooker.h"
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogCollisionMesh);
+
+	const uint32_t UCollisionMesh::CookedCollisionMeshVersion = 1;
+
+	namespace
+	{
+		const uint32_t g_cookedCollisionMeshMagic = 0x4344414D; // "MADC"
+
+		// Candidate split planes per axis. Binning keeps every level of the build linear in the triangle count
+		const uint32_t g_splitBinCount = 16;
+
+		// Cost of visiting a node relative to testing a triangle. Leaves with more triangles than this are always split
+		const float g_nodeTraversalCost = 1.0f;
+		const uint32_t g_maxLeafTriangles = 8;
+
+		// Subtrees below this many triangles are built by a single job, the levels above them are split on the main thread
+		const uint32_t g_trianglesPerBuildJob = 4096;
+
+		// Triangles per job when computing the triangle bounds
+		const uint32_t g_trianglesPerBoundsJob = 16384;
+
+		struct SCookedCollisionMeshHeader
+		{
+			uint32_t m_magic;
+			uint32_t m_version;
+
+			uint64_t m_sourceFileSize;
+			uint64_t m_sourceWriteTime;
+
+			uint32_t m_positionCount;
+			uint32_t m_indexCount;
+			uint32_t m_nodeCount;
+		};
+
+		// A range of the triangle order still to be split, and the node that covers it
+		struct SPendingNode
+		{
+			uint32_t m_nodeIndex;
+			uint32_t m_firstTriangle;
+			uint32_t m_triangleCount;
+		};
+
+		struct SSplitBin
+		{
+			Vector3 m_boundsMin;
+			Vector3 m_boundsMax;
+			uint32_t m_triangleCount;
+		};
+
+		bool IsHeaderUpToDate(const SCookedCollisionMeshHeader& inHeader, const eastl::string& inSourcePath)
+		{
+			if (inHeader.m_magic != g_cookedCollisionMeshMagic || inHeader.m_version != UCollisionMesh::CookedCollisionMeshVersion)
+			{
+				return false;
+			}
+
+			uint64_t sourceFileSize = 0;
+			uint64_t sourceWriteTime = 0;
+			if (!UCookedFile::GetSourceFileStamp(inSourcePath, sourceFileSize, sourceWriteTime))
+			{
+				// Cooked files can ship without their source
+				return true;
+			}
+
+			return inHeader.m_sourceFileSize == sourceFileSize && inHeader.m_sourceWriteTime == sourceWriteTime;
+		}
+
+		float GetComponent(const Vector3& inVector, uint32_t inAxis)
+		{
+			return inAxis == 0 ? inVector.x : (inAxis == 1 ? inVector.y : inVector.z);
+		}
+
+		float GetHalfArea(const Vector3& inBoundsMin, const Vector3& inBoundsMax)
+		{
+			return SAABB(inBoundsMin, inBoundsMax).GetPerimeter();
+		}
+
+		// Splits triangles in the order buffer, shared by every job of a build. Jobs only touch their own range of it
+		struct SHierarchyBuilder
+		{
+			const SAABB* m_triangleBounds;
+			const Vector3* m_triangleCentroids;
+			uint32_t* m_triangleOrder;
+
+			SAABB ComputeBounds(uint32_t inFirstTriangle, uint32_t inTriangleCount) const
+			{
+				SAABB rangeBounds(Vector3(FLT_MAX, FLT_MAX, FLT_MAX), Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+
+				for (uint32_t i = inFirstTriangle; i < inFirstTriangle + inTriangleCount; ++i)
+				{
+					rangeBounds = SAABB::Combine(rangeBounds, m_triangleBounds[m_triangleOrder[i]]);
+				}
+
+				return rangeBounds;
+			}
+
+			// Partitions the range at the cheapest of the binned split planes and returns the size of its left half, or 0 if
+			// the range is cheaper to keep as a leaf
+			uint32_t SplitRange(uint32_t inFirstTriangle, uint32_t inTriangleCount, const SAABB& inBounds) const
+			{
+				if (inTriangleCount <= 1)
+				{
+					return 0;
+				}
+
+				Vector3 centroidMin(FLT_MAX, FLT_MAX, FLT_MAX);
+				Vector3 centroidMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+				for (uint32_t i = inFirstTriangle; i < inFirstTriangle + inTriangleCount; ++i)
+				{
+					centroidMin = Vector3::Min(centroidMin, m_triangleCentroids[m_triangleOrder[i]]);
+					centroidMax = Vector3::Max(centroidMax, m_triangleCentroids[m_triangleOrder[i]]);
+				}
+
+				float bestCost = FLT_MAX;
+				uint32_t bestAxis = 0;
+				uint32_t bestSplit = 0;
+
+				for (uint32_t axis = 0; axis < 3; ++axis)
+				{
+					const float axisMin = GetComponent(centroidMin, axis);
+					const float axisExtent = GetComponent(centroidMax, axis) - axisMin;
+
+					if (axisExtent <= 1e-6f)
+					{
+						continue;
+					}
+
+					SSplitBin bins[g_splitBinCount];
+					for (SSplitBin& currentBin : bins)
+					{
+						currentBin = { Vector3(FLT_MAX, FLT_MAX, FLT_MAX), Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX), 0 };
+					}
+
+					const float binScale = g_splitBinCount / axisExtent;
+
+					for (uint32_t i = inFirstTriangle; i < inFirstTriangle + inTriangleCount; ++i)
+					{
+						const uint32_t triangleIndex = m_triangleOrder[i];
+						const uint32_t binIndex = eastl::min(static_cast<uint32_t>((GetComponent(m_triangleCentroids[triangleIndex], axis) - axisMin) * binScale), g_splitBinCount - 1);
+
+						SSplitBin& currentBin = bins[binIndex];
+						currentBin.m_boundsMin = Vector3::Min(currentBin.m_boundsMin, m_triangleBounds[triangleIndex].m_min);
+						currentBin.m_boundsMax = Vector3::Max(currentBin.m_boundsMax, m_triangleBounds[triangleIndex].m_max);
+						++currentBin.m_triangleCount;
+					}
+
+					// Right to left first, so that the left to right sweep can price every split plane in one go
+					float rightCosts[g_splitBinCount];
+					Vector3 rightMin(FLT_MAX, FLT_MAX, FLT_MAX);
+					Vector3 rightMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+					uint32_t rightCount = 0;
+
+					for (uint32_t i = g_splitBinCount - 1; i > 0; --i)
+					{
+						rightMin = Vector3::Min(rightMin, bins[i].m_boundsMin);
+						rightMax = Vector3::Max(rightMax, bins[i].m_boundsMax);
+						rightCount += bins[i].m_triangleCount;
+						rightCosts[i] = rightCount > 0 ? rightCount * GetHalfArea(rightMin, rightMax) : 0.0f;
+					}
+
+					Vector3 leftMin(FLT_MAX, FLT_MAX, FLT_MAX);
+					Vector3 leftMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+					uint32_t leftCount = 0;
+
+					for (uint32_t i = 1; i < g_splitBinCount; ++i)
+					{
+						leftMin = Vector3::Min(leftMin, bins[i - 1].m_boundsMin);
+						leftMax = Vector3::Max(leftMax, bins[i - 1].m_boundsMax);
+						leftCount += bins[i - 1].m_triangleCount;
+
+						if (leftCount == 0 || leftCount == inTriangleCount)
+						{
+							continue;
+						}
+
+						const float splitCost = leftCount * GetHalfArea(leftMin, leftMax) + rightCosts[i];
+						if (splitCost < bestCost)
+						{
+							bestCost = splitCost;
+							bestAxis = axis;
+							bestSplit = i;
+						}
+					}
+				}
+
+				if (bestSplit == 0)
+				{
+					// Every centroid is in the same spot, only split if the leaf would be too big
+					return inTriangleCount > g_maxLeafTriangles ? inTriangleCount / 2 : 0;
+				}
+
+				const float nodeHalfArea = eastl::max(inBounds.GetPerimeter(), 1e-12f);
+				if (g_nodeTraversalCost + bestCost / nodeHalfArea >= static_cast<float>(inTriangleCount) && inTriangleCount <= g_maxLeafTriangles)
+				{
+					return 0;
+				}
+
+				const float axisMin = GetComponent(centroidMin, bestAxis);
+				const float binScale = g_splitBinCount / (GetComponent(centroidMax, bestAxis) - axisMin);
+
+				// Triangles left of the split plane to the front of the range
+				uint32_t leftEnd = inFirstTriangle;
+				for (uint32_t i = inFirstTriangle; i < inFirstTriangle + inTriangleCount; ++i)
+				{
+					const uint32_t binIndex = eastl::min(static_cast<uint32_t>((GetComponent(m_triangleCentroids[m_triangleOrder[i]], bestAxis) - axisMin) * binScale), g_splitBinCount - 1);
+
+					if (binIndex < bestSplit)
+					{
+						eastl::swap(m_triangleOrder[i], m_triangleOrder[leftEnd++]);
+					}
+				}
+
+				return leftEnd - inFirstTriangle;
+			}
+
+			// Splits the node's range, turning it into an inner node whose two children are appended to inOutNodes. Returns false if it stays a leaf
+			bool SplitNode(const SPendingNode& inNode, eastl::vector<SCollisionMeshNode>& inOutNodes, SPendingNode outChildren[2]) const
+			{
+				const uint32_t leftCount = SplitRange(inNode.m_firstTriangle, inNode.m_triangleCount, inOutNodes[inNode.m_nodeIndex].GetBounds());
+				if (leftCount == 0)
+				{
+					return false;
+				}
+
+				const uint32_t firstChild = static_cast<uint32_t>(inOutNodes.size());
+				outChildren[0] = { firstChild, inNode.m_firstTriangle, leftCount };
+				outChildren[1] = { firstChild + 1, inNode.m_firstTriangle + leftCount, inNode.m_triangleCount - leftCount };
+
+				for (uint32_t i = 0; i < 2; ++i)
+				{
+					const SAABB childBounds = ComputeBounds(outChildren[i].m_firstTriangle, outChildren[i].m_triangleCount);
+					inOutNodes.push_back({ childBounds.m_min, outChildren[i].m_firstTriangle, childBounds.m_max, outChildren[i].m_triangleCount });
+				}
+
+				SCollisionMeshNode& splitNode = inOutNodes[inNode.m_nodeIndex];
+				splitNode.m_firstIndex = firstChild;
+				splitNode.m_triangleCount = 0;
+
+				return true;
+			}
+
+			// Builds the whole subtree under the range. Its root is node 0 of outNodes, with the given bounds
+			void BuildSubtree(uint32_t inFirstTriangle, uint32_t inTriangleCount, const SAABB& inBounds, eastl::vector<SCollisionMeshNode>& outNodes) const
+			{
+				outNodes.clear();
+				outNodes.push_back({ inBounds.m_min, inFirstTriangle, inBounds.m_max, inTriangleCount });
+
+				eastl::fixed_vector<SPendingNode, 64> nodeStack;
+				nodeStack.push_back({ 0, inFirstTriangle, inTriangleCount });
+
+				while (!nodeStack.empty())
+				{
+					const SPendingNode currentNode = nodeStack.back();
+					nodeStack.pop_back();
+
+					SPendingNode childNodes[2];
+					if (SplitNode(currentNode, outNodes, childNodes))
+					{
+						nodeStack.push_back(childNodes[0]);
+						nodeStack.push_back(childNodes[1]);
+					}
+				}
+			}
+		};
+
+		// Möller-Trumbore, hits either side of the triangle
+		bool RaycastTriangle(const Vector3& inVertexA, const Vector3& inVertexB, const Vector3& inVertexC, const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance)
+		{
+			const Vector3 edgeAB = inVertexB - inVertexA;
+			const Vector3 edgeAC = inVertexC - inVertexA;
+			const Vector3 directionCrossAC = inDirection.Cross(edgeAC);
+			const float determinant = edgeAB.Dot(directionCrossAC);
+
+			if (fabsf(determinant) < 1e-12f)
+			{
+				return false;
+			}
+
+			const float inverseDeterminant = 1.0f / determinant;
+			const Vector3 originOffset = inOrigin - inVertexA;
+
+			// A little slack so that rays through a shared edge can't slip between its two triangles
+			const float barycentricU = originOffset.Dot(directionCrossAC) * inverseDeterminant;
+			if (barycentricU < -1e-6f || barycentricU > 1.0f + 1e-6f)
+			{
+				return false;
+			}
+
+			const Vector3 offsetCrossAB = originOffset.Cross(edgeAB);
+			const float barycentricV = inDirection.Dot(offsetCrossAB) * inverseDeterminant;
+			if (barycentricV < -1e-6f || barycentricU + barycentricV > 1.0f + 1e-6f)
+			{
+				return false;
+			}
+
+			outDistance = edgeAC.Dot(offsetCrossAB) * inverseDeterminant;
+			return outDistance >= 0.0f && outDistance <= inMaxDistance;
+		}
+	}
+
+	eastl::shared_ptr<UCollisionMesh> UCollisionMesh::Load(const eastl::string& inRelativePath)
+	{
+		if (auto cachedCollisionMesh = UAssetCache::GetCachedResource<UCollisionMesh>(inRelativePath))
+		{
+			return cachedCollisionMesh;
+		}
+
+		const eastl::string fullPath = UAssetCache::GetAssetRoot() + inRelativePath;
+		auto collisionMesh = eastl::make_shared<UCollisionMesh>();
+
+		if (!collisionMesh->LoadCooked(fullPath))
+		{
+			SMeshData meshData;
+			if (!UMeshCooker::LoadCookedMesh(fullPath, meshData) && !UMeshCooker::ImportSourceMesh(fullPath, meshData))
+			{
+				LOG(LogCollisionMesh, Warning, "Failed to load collision mesh: `%s`\n", inRelativePath.c_str());
+				return nullptr;
+			}
+
+			collisionMesh->Build(meshData.m_positions.data(), static_cast<uint32_t>(meshData.m_positions.size()), meshData.m_subMeshes.data(), static_cast<uint32_t>(meshData.m_subMeshes.size()), meshData.m_indexData.data());
+
+			if (!collisionMesh->WriteCooked(fullPath))
+			{
+				LOG(LogCollisionMesh, Warning, "Failed to cache the collision mesh of `%s`, it will be rebuilt on the next load\n", inRelativePath.c_str());
+			}
+		}
+
+		LOG(LogCollisionMesh, Log, "Loaded collision mesh `%s` (%u triangles)\n", inRelativePath.c_str(), collisionMesh->GetTriangleCount());
+		UAssetCache::InsertResource<UCollisionMesh>(inRelativePath, collisionMesh);
+		return collisionMesh;
+	}
+
+	eastl::string UCollisionMesh::GetCookedCollisionMeshPath(const eastl::string& inSourcePath)
+	{
+		return inSourcePath + ".madcol";
+	}
+
+	bool UCollisionMesh::LoadCooked(const eastl::string& inSourcePath)
+	{
+		UMappedFile cookedFile;
+		if (!cookedFile.Open(GetCookedCollisionMeshPath(inSourcePath)) || cookedFile.GetSize() < sizeof(SCookedCollisionMeshHeader))
+		{
+			return false;
+		}
+
+		const uint8_t* cursor = cookedFile.GetData();
+		const uint8_t* fileEnd = cursor + cookedFile.GetSize();
+
+		SCookedCollisionMeshHeader cookedHeader;
+		memcpy(&cookedHeader, cursor, sizeof(cookedHeader));
+		cursor += UCookedFile::AlignSectionSize(sizeof(cookedHeader));
+
+		if (!IsHeaderUpToDate(cookedHeader, inSourcePath))
+		{
+			return false;
+		}
+
+		const bool readAllSections = UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_positionCount, m_positions)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_indexCount, m_indices)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_nodeCount, m_nodes);
+
+		if (!readAllSections)
+		{
+			LOG(LogCollisionMesh, Warning, "Cooked collision mesh for '%s' is truncated\n", inSourcePath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool UCollisionMesh::WriteCooked(const eastl::string& inSourcePath) const
+	{
+		SCookedCollisionMeshHeader cookedHeader = {};
+		cookedHeader.m_magic = g_cookedCollisionMeshMagic;
+		cookedHeader.m_version = CookedCollisionMeshVersion;
+
+		if (!UCookedFile::GetSourceFileStamp(inSourcePath, cookedHeader.m_sourceFileSize, cookedHeader.m_sourceWriteTime))
+		{
+			return false;
+		}
+
+		cookedHeader.m_positionCount = static_cast<uint32_t>(m_positions.size());
+		cookedHeader.m_indexCount = static_cast<uint32_t>(m_indices.size());
+		cookedHeader.m_nodeCount = static_cast<uint32_t>(m_nodes.size());
+
+		std::ofstream cookedStream(GetCookedCollisionMeshPath(inSourcePath).c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!cookedStream.is_open())
+		{
+			return false;
+		}
+
+		// Sections are written in the order LoadCooked reads them
+		UCookedFile::WriteSection(cookedStream, &cookedHeader, 1);
+		UCookedFile::WriteSection(cookedStream, m_positions.data(), m_positions.size());
+		UCookedFile::WriteSection(cookedStream, m_indices.data(), m_indices.size());
+		UCookedFile::WriteSection(cookedStream, m_nodes.data(), m_nodes.size());
+
+		return cookedStream.good();
+	}
+
+	void UCollisionMesh::Build(const Vector3* inPositions, uint32_t inVertexCount, const SSubMesh* inSubMeshes, uint32_t inSubMeshCount, const uint8_t* inIndexData)
+	{
+		rmt_ScopedCPUSample(CollisionMesh_Build, 0);
+
+		m_positions.assign(inPositions, inPositions + inVertexCount);
+		m_nodes.clear();
+
+		eastl::vector<uint32_t> sourceIndices;
+		for (uint32_t i = 0; i < inSubMeshCount; ++i)
+		{
+			const SSubMesh& currentSubMesh = inSubMeshes[i];
+
+			for (UINT j = 0; j < currentSubMesh.m_lods[0].m_indexCount; ++j)
+			{
+				sourceIndices.push_back(currentSubMesh.m_vertexStart + GetSubMeshIndex(inIndexData, currentSubMesh, j));
+			}
+		}
+
+		const uint32_t triangleCount = static_cast<uint32_t>(sourceIndices.size() / 3);
+		if (triangleCount == 0)
+		{
+			m_indices.clear();
+			return;
+		}
+
+		eastl::vector<SAABB> triangleBounds(triangleCount);
+		eastl::vector<Vector3> triangleCentroids(triangleCount);
+		eastl::vector<uint32_t> triangleOrder(triangleCount);
+
+		const uint32_t boundsJobCount = (triangleCount + g_trianglesPerBoundsJob - 1) / g_trianglesPerBoundsJob;
+
+		UJobSystem::ParallelFor(boundsJobCount, [this, triangleCount, &sourceIndices, &triangleBounds, &triangleCentroids, &triangleOrder](uint32_t inJobIndex)
+		{
+			const uint32_t lastTriangle = eastl::min((inJobIndex + 1) * g_trianglesPerBoundsJob, triangleCount);
+
+			for (uint32_t i = inJobIndex * g_trianglesPerBoundsJob; i < lastTriangle; ++i)
+			{
+				const Vector3& vertexA = m_positions[sourceIndices[i * 3]];
+				const Vector3& vertexB = m_positions[sourceIndices[i * 3 + 1]];
+				const Vector3& vertexC = m_positions[sourceIndices[i * 3 + 2]];
+
+				triangleBounds[i] = SAABB(Vector3::Min(vertexA, Vector3::Min(vertexB, vertexC)), Vector3::Max(vertexA, Vector3::Max(vertexB, vertexC)));
+				triangleCentroids[i] = (triangleBounds[i].m_min + triangleBounds[i].m_max) * 0.5f;
+				triangleOrder[i] = i;
+			}
+		});
+
+		const SHierarchyBuilder hierarchyBuilder = { triangleBounds.data(), triangleCentroids.data(), triangleOrder.data() };
+
+		// The top of the tree is split breadth first until every range is small enough to be handed to a job as a whole
+		const SAABB rootBounds = hierarchyBuilder.ComputeBounds(0, triangleCount);
+		m_nodes.push_back({ rootBounds.m_min, 0, rootBounds.m_max, triangleCount });
+
+		eastl::vector<SPendingNode> pendingNodes;
+		eastl::vector<SPendingNode> subtreeJobs;
+		pendingNodes.push_back({ 0, 0, triangleCount });
+
+		for (size_t i = 0; i < pendingNodes.size(); ++i)
+		{
+			const SPendingNode currentNode = pendingNodes[i];
+
+			if (currentNode.m_triangleCount <= g_trianglesPerBuildJob)
+			{
+				subtreeJobs.push_back(currentNode);
+				continue;
+			}
+
+			SPendingNode childNodes[2];
+			if (hierarchyBuilder.SplitNode(currentNode, m_nodes, childNodes))
+			{
+				pendingNodes.push_back(childNodes[0]);
+				pendingNodes.push_back(childNodes[1]);
+			}
+		}
+
+		// Each subtree only reorders its own range of triangles, so they can all be built at the same time
+		eastl::vector<eastl::vector<SCollisionMeshNode>> subtreeNodes(subtreeJobs.size());
+
+		UJobSystem::ParallelFor(static_cast<uint32_t>(subtreeJobs.size()), [this, &hierarchyBuilder, &subtreeJobs, &subtreeNodes](uint32_t inJobIndex)
+		{
+			const SPendingNode& currentJob = subtreeJobs[inJobIndex];
+			hierarchyBuilder.BuildSubtree(currentJob.m_firstTriangle, currentJob.m_triangleCount, m_nodes[currentJob.m_nodeIndex].GetBounds(), subtreeNodes[inJobIndex]);
+		});
+
+		// Each subtree's root replaces the node it was built for, and the rest of it is appended to the node list
+		for (size_t i = 0; i < subtreeJobs.size(); ++i)
+		{
+			const eastl::vector<SCollisionMeshNode>& currentSubtree = subtreeNodes[i];
+			const uint32_t subtreeStart = static_cast<uint32_t>(m_nodes.size()) - 1;
+
+			for (size_t j = 0; j < currentSubtree.size(); ++j)
+			{
+				SCollisionMeshNode subtreeNode = currentSubtree[j];
+				if (!subtreeNode.IsLeaf())
+				{
+					subtreeNode.m_firstIndex += subtreeStart;
+				}
+
+				if (j == 0)
+				{
+					m_nodes[subtreeJobs[i].m_nodeIndex] = subtreeNode;
+				}
+				else
+				{
+					m_nodes.push_back(subtreeNode);
+				}
+			}
+		}
+
+		m_indices.resize(triangleCount * 3);
+		for (uint32_t i = 0; i < triangleCount; ++i)
+		{
+			memcpy(&m_indices[i * 3], &sourceIndices[triangleOrder[i] * 3], 3 * sizeof(uint32_t));
+		}
+	}
+
+	bool UCollisionMesh::Raycast(const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance, Vector3& outNormal) const
+	{
+		if (m_nodes.empty())
+		{
+			return false;
+		}
+
+		const Vector3 inverseDirection = SAABB::ComputeInverseDirection(inDirection);
+		float closestDistance = inMaxDistance;
+		bool isHit = false;
+
+		eastl::fixed_vector<uint32_t, 64> nodeStack;
+		nodeStack.push_back(0);
+
+		while (!nodeStack.empty())
+		{
+			const SCollisionMeshNode& currentNode = m_nodes[nodeStack.back()];
+			nodeStack.pop_back();
+
+			if (!currentNode.GetBounds().IntersectsRay(inOrigin, inverseDirection, closestDistance))
+			{
+				continue;
+			}
+
+			if (!currentNode.IsLeaf())
+			{
+				// Nearer child on top, so that its hits cull the other child before it's visited
+				const SCollisionMeshNode& leftChild = m_nodes[currentNode.m_firstIndex];
+				const SCollisionMeshNode& rightChild = m_nodes[currentNode.m_firstIndex + 1];
+				const bool isLeftNearer = (leftChild.m_boundsMin + leftChild.m_boundsMax - rightChild.m_boundsMin - rightChild.m_boundsMax).Dot(inDirection) <= 0.0f;
+
+				nodeStack.push_back(currentNode.m_firstIndex + (isLeftNearer ? 1 : 0));
+				nodeStack.push_back(currentNode.m_firstIndex + (isLeftNearer ? 0 : 1));
+				continue;
+			}
+
+			for (uint32_t i = currentNode.m_firstIndex; i < currentNode.m_firstIndex + currentNode.m_triangleCount; ++i)
+			{
+				Vector3 triangleVertices[3];
+				GetTriangle(i, triangleVertices);
+
+				float triangleDistance;
+				if (RaycastTriangle(triangleVertices[0], triangleVertices[1], triangleVertices[2], inOrigin, inDirection, closestDistance, triangleDistance))
+				{
+					closestDistance = triangleDistance;
+					outNormal = (triangleVertices[1] - triangleVertices[0]).Cross(triangleVertices[2] - triangleVertices[0]);
+					isHit = true;
+				}
+			}
+		}
+
+		if (!isHit)
+		{
+			return false;
+		}
+
+		outNormal.Normalize();
+		if (outNormal.Dot(inDirection) > 0.0f)
+		{
+			outNormal = -outNormal;
+		}
+
+		outDistance = closestDistance;
+		return true;
+	}
+
+	size_t UCollisionMesh::GetMemorySize() const
+	{
+		return sizeof(UCollisionMesh) + m_nodes.size() * sizeof(SCollisionMeshNode) + m_positions.size() * sizeof(Vector3) + m_indices.size() * sizeof(uint32_t);
+	}
+}
@@ -4,11 +4,21 @@
 #include "Misc/Logging.h"
 
 #include <EASTl/algorithm.h>
+#include <EASTL/sort.h>
 
 namespace MAD
 {
 	DECLARE_LOG_CATEGORY(LogComponentUpdater);
 
+	namespace
+	{
+		// Loaded components all share the lowest key, the sort is stable so they keep their registration order
+		uint32_t GetUpdateOrderKey(const UComponent& inComponent)
+		{
+			return inComponent.IsNetworkSpawned() ? 1u + inComponent.GetNetID().GetUnderlyingHandle() : 0u;
+		}
+	}
+
 	UComponentUpdater::UComponentUpdater() : m_isUpdating(false) {}
 
 	UComponentUpdater::~UComponentUpdater()
@@ -54,15 +64,7 @@ namespace MAD
 		{
 			//LOG(LogComponentUpdater, Log, "Updating priority %d\n", currentPriorityLevelIter->first);
 			// Iterate over the entries of the component containers while the priority level is lower than the physics priority level
-			
-			for (auto& currentComponent : currentPriorityLevelIter->second.m_blockComponents)
-			{
-				// Only update the component if it's owner hasn't been marked for kill
-				if (currentComponent->IsActive() && !currentComponent->GetOwningEntity().IsPendingForKill())
-				{
-					currentComponent->UpdateComponent(inDeltaTime);
-				}
-			}
+			UpdateBlock(currentPriorityLevelIter->second, inDeltaTime);
 
 			++currentPriorityLevelIter;
 		}
@@ -79,13 +81,7 @@ namespace MAD
 			//LOG(LogComponentUpdater, Log, "Updating priority %d\n", currentPriorityLevelIter->first);
 
 			// Iterate over the rest of the components
-			for (auto& currentComponent : currentPriorityLevelIter->second.m_blockComponents)
-			{
-				if (currentComponent->IsActive() && !currentComponent->GetOwningEntity().IsPendingForKill())
-				{
-					currentComponent->UpdateComponent(inDeltaTime);
-				}
-			}
+			UpdateBlock(currentPriorityLevelIter->second, inDeltaTime);
 
 			++currentPriorityLevelIter;
 		}
@@ -108,6 +104,7 @@ namespace MAD
 			if (priorityBlockFindIter.first->second.m_blockComponentTypeID == componentTypeID)
 			{
 				priorityBlockFindIter.first->second.m_blockComponents.emplace_back(inNewComponentPtr);
+				priorityBlockFindIter.first->second.m_isOrderDirty = true;
 				return;
 			}
 
@@ -119,5 +116,31 @@ namespace MAD
 
 		priorityBlockInsertIter->second.m_blockComponentTypeID = componentTypeID;
 		priorityBlockInsertIter->second.m_blockComponents.emplace_back(inNewComponentPtr);
+		priorityBlockInsertIter->second.m_isOrderDirty = true;
+	}
+
+	void UComponentUpdater::UpdateBlock(SComponentPriorityBlock& inOutBlock, float inDeltaTime)
+	{
+		SComponentPriorityBlock::ComponentContainer_t& blockComponents = inOutBlock.m_blockComponents;
+
+		if (inOutBlock.m_isOrderDirty)
+		{
+			// New components are at the back of an already sorted block, which is the best case of an insertion sort
+			eastl::insertion_sort(blockComponents.begin(), blockComponents.end(), [](const eastl::shared_ptr<UComponent>& inLeft, const eastl::shared_ptr<UComponent>& inRight)
+			{
+				return GetUpdateOrderKey(*inLeft) < GetUpdateOrderKey(*inRight);
+			});
+
+			inOutBlock.m_isOrderDirty = false;
+		}
+
+		for (auto& currentComponent : blockComponents)
+		{
+			// Only update the component if it's owner hasn't been marked for kill
+			if (currentComponent->IsActive() && !currentComponent->GetOwningEntity().IsPendingForKill())
+			{
+				currentComponent->UpdateComponent(inDeltaTime);
+			}
+		}
 	}
 }
@@ -0,0 +1,236 @@
+#include "Core/ContactSolver.h"
+
+#include <EASTL/algorithm.h>
+
+#include "Misc/Remotery.h"
+
+namespace MAD
+{
+	namespace
+	{
+		// Fraction of the penetration resolved every tick
+		const float g_baumgarteFactor = 0.2f;
+
+		// Penetration that is allowed to stay, so that resting contacts don't lose and regain contact every tick
+		const float g_penetrationSlop = 0.5f;
+
+		// Contacts approaching slower than this don't bounce, or resting bodies would never settle
+		const float g_restitutionVelocityThreshold = 100.0f;
+
+		void ComputeTangents(const Vector3& inNormal, Vector3 outTangents[2])
+		{
+			if (fabs(inNormal.x) >= 0.57735f)
+			{
+				outTangents[0] = Vector3(inNormal.y, -inNormal.x, 0.0f);
+			}
+			else
+			{
+				outTangents[0] = Vector3(0.0f, inNormal.z, -inNormal.y);
+			}
+
+			outTangents[0].Normalize();
+			outTangents[1] = inNormal.Cross(outTangents[0]);
+		}
+
+		float ComputeEffectiveMass(float inInverseMassA, const Matrix& inInverseInertiaA, const Vector3& inRelativeA, float inInverseMassB, const Matrix& inInverseInertiaB, const Vector3& inRelativeB, const Vector3& inDirection)
+		{
+			const Vector3 angularA = inRelativeA.Cross(inDirection);
+			const Vector3 angularB = inRelativeB.Cross(inDirection);
+
+			const float inverseEffectiveMass = inInverseMassA + inInverseMassB
+				+ angularA.Dot(Vector3::TransformNormal(angularA, inInverseInertiaA))
+				+ angularB.Dot(Vector3::TransformNormal(angularB, inInverseInertiaB));
+
+			return inverseEffectiveMass > 0.0f ? 1.0f / inverseEffectiveMass : 0.0f;
+		}
+
+		// Velocities of the two bodies of a constraint, loaded once and written back after all of its points are solved
+		struct SBodyPairVelocities
+		{
+			Vector3 m_linearA;
+			Vector3 m_angularA;
+			Vector3 m_linearB;
+			Vector3 m_angularB;
+		};
+
+		SBodyPairVelocities LoadVelocities(const SRigidBodyState& inBodies, uint32_t inBodyA, uint32_t inBodyB)
+		{
+			return { inBodies.GetLinearVelocity(inBodyA), inBodies.GetAngularVelocity(inBodyA), inBodies.GetLinearVelocity(inBodyB), inBodies.GetAngularVelocity(inBodyB) };
+		}
+
+		void StoreVelocities(SRigidBodyState& inOutBodies, uint32_t inBodyA, uint32_t inBodyB, const SBodyPairVelocities& inVelocities)
+		{
+			// Bodies that aren't dynamic can be shared between manifolds solved at the same time, so they're never written
+			if (inOutBodies.IsDynamic(inBodyA))
+			{
+				inOutBodies.SetLinearVelocity(inBodyA, inVelocities.m_linearA);
+				inOutBodies.SetAngularVelocity(inBodyA, inVelocities.m_angularA);
+			}
+
+			if (inOutBodies.IsDynamic(inBodyB))
+			{
+				inOutBodies.SetLinearVelocity(inBodyB, inVelocities.m_linearB);
+				inOutBodies.SetAngularVelocity(inBodyB, inVelocities.m_angularB);
+			}
+		}
+
+		void ApplyImpulse(const SRigidBodyState& inBodies, uint32_t inBodyA, uint32_t inBodyB, const Vector3& inRelativeA, const Vector3& inRelativeB, const Vector3& inImpulse, SBodyPairVelocities& inOutVelocities)
+		{
+			inOutVelocities.m_linearA -= inImpulse * inBodies.m_inverseMass[inBodyA];
+			inOutVelocities.m_angularA -= Vector3::TransformNormal(inRelativeA.Cross(inImpulse), inBodies.m_worldInverseInertia[inBodyA]);
+			inOutVelocities.m_linearB += inImpulse * inBodies.m_inverseMass[inBodyB];
+			inOutVelocities.m_angularB += Vector3::TransformNormal(inRelativeB.Cross(inImpulse), inBodies.m_worldInverseInertia[inBodyB]);
+		}
+
+		Vector3 GetRelativeVelocity(const SBodyPairVelocities& inVelocities, const Vector3& inRelativeA, const Vector3& inRelativeB)
+		{
+			return inVelocities.m_linearB + inVelocities.m_angularB.Cross(inRelativeB) - inVelocities.m_linearA - inVelocities.m_angularA.Cross(inRelativeA);
+		}
+	}
+
+	void UContactSolver::Solve(SRigidBodyState& inOutBodies, eastl::vector<SContactManifold>& inOutManifolds, const uint32_t* inManifoldIndices, uint32_t inManifoldCount, float inDeltaTime)
+	{
+		rmt_ScopedCPUSample(ContactSolver_Solve, 0);
+
+		InitializeConstraints(inOutBodies, inOutManifolds, inManifoldIndices, inManifoldCount, inDeltaTime);
+		WarmStart(inOutBodies);
+
+		for (uint32_t i = 0; i < VelocityIterations; ++i)
+		{
+			SolveVelocities(inOutBodies);
+		}
+
+		StoreImpulses(inOutManifolds);
+	}
+
+	void UContactSolver::InitializeConstraints(const SRigidBodyState& inBodies, const eastl::vector<SContactManifold>& inManifolds, const uint32_t* inManifoldIndices, uint32_t inManifoldCount, float inDeltaTime)
+	{
+		m_constraints.resize(inManifoldCount);
+
+		const float inverseDeltaTime = inDeltaTime > 0.0f ? 1.0f / inDeltaTime : 0.0f;
+
+		for (uint32_t i = 0; i < inManifoldCount; ++i)
+		{
+			const SContactManifold& currentManifold = inManifolds[inManifoldIndices[i]];
+			SConstraint& currentConstraint = m_constraints[i];
+
+			currentConstraint.m_manifoldIndex = inManifoldIndices[i];
+			currentConstraint.m_bodyA = currentManifold.m_bodyA;
+			currentConstraint.m_bodyB = currentManifold.m_bodyB;
+			currentConstraint.m_normal = currentManifold.m_normal;
+			currentConstraint.m_friction = currentManifold.m_friction;
+			currentConstraint.m_pointCount = currentManifold.m_pointCount;
+			ComputeTangents(currentManifold.m_normal, currentConstraint.m_tangents);
+
+			const uint32_t bodyA = currentManifold.m_bodyA;
+			const uint32_t bodyB = currentManifold.m_bodyB;
+			const float inverseMassA = inBodies.m_inverseMass[bodyA];
+			const float inverseMassB = inBodies.m_inverseMass[bodyB];
+			const Matrix& inverseInertiaA = inBodies.m_worldInverseInertia[bodyA];
+			const Matrix& inverseInertiaB = inBodies.m_worldInverseInertia[bodyB];
+			const Vector3 positionA = inBodies.GetPosition(bodyA);
+			const Vector3 positionB = inBodies.GetPosition(bodyB);
+			const SBodyPairVelocities velocities = LoadVelocities(inBodies, bodyA, bodyB);
+
+			for (uint32_t j = 0; j < currentManifold.m_pointCount; ++j)
+			{
+				const SContactPoint& contactPoint = currentManifold.m_points[j];
+				SConstraintPoint& constraintPoint = currentConstraint.m_points[j];
+
+				constraintPoint.m_relativeA = contactPoint.m_position - positionA;
+				constraintPoint.m_relativeB = contactPoint.m_position - positionB;
+				constraintPoint.m_normalImpulse = contactPoint.m_normalImpulse;
+				constraintPoint.m_tangentImpulse[0] = contactPoint.m_tangentImpulse[0];
+				constraintPoint.m_tangentImpulse[1] = contactPoint.m_tangentImpulse[1];
+
+				constraintPoint.m_normalMass = ComputeEffectiveMass(inverseMassA, inverseInertiaA, constraintPoint.m_relativeA, inverseMassB, inverseInertiaB, constraintPoint.m_relativeB, currentConstraint.m_normal);
+				constraintPoint.m_tangentMass[0] = ComputeEffectiveMass(inverseMassA, inverseInertiaA, constraintPoint.m_relativeA, inverseMassB, inverseInertiaB, constraintPoint.m_relativeB, currentConstraint.m_tangents[0]);
+				constraintPoint.m_tangentMass[1] = ComputeEffectiveMass(inverseMassA, inverseInertiaA, constraintPoint.m_relativeA, inverseMassB, inverseInertiaB, constraintPoint.m_relativeB, currentConstraint.m_tangents[1]);
+
+				constraintPoint.m_velocityBias = g_baumgarteFactor * inverseDeltaTime * eastl::max(contactPoint.m_penetration - g_penetrationSlop, 0.0f);
+
+				const float approachVelocity = GetRelativeVelocity(velocities, constraintPoint.m_relativeA, constraintPoint.m_relativeB).Dot(currentConstraint.m_normal);
+				if (approachVelocity < -g_restitutionVelocityThreshold)
+				{
+					constraintPoint.m_velocityBias = eastl::max(constraintPoint.m_velocityBias, -currentManifold.m_restitution * approachVelocity);
+				}
+			}
+		}
+	}
+
+	void UContactSolver::WarmStart(SRigidBodyState& inOutBodies) const
+	{
+		for (const SConstraint& currentConstraint : m_constraints)
+		{
+			SBodyPairVelocities velocities = LoadVelocities(inOutBodies, currentConstraint.m_bodyA, currentConstraint.m_bodyB);
+
+			for (uint32_t j = 0; j < currentConstraint.m_pointCount; ++j)
+			{
+				const SConstraintPoint& constraintPoint = currentConstraint.m_points[j];
+				const Vector3 impulse = currentConstraint.m_normal * constraintPoint.m_normalImpulse
+					+ currentConstraint.m_tangents[0] * constraintPoint.m_tangentImpulse[0]
+					+ currentConstraint.m_tangents[1] * constraintPoint.m_tangentImpulse[1];
+
+				ApplyImpulse(inOutBodies, currentConstraint.m_bodyA, currentConstraint.m_bodyB, constraintPoint.m_relativeA, constraintPoint.m_relativeB, impulse, velocities);
+			}
+
+			StoreVelocities(inOutBodies, currentConstraint.m_bodyA, currentConstraint.m_bodyB, velocities);
+		}
+	}
+
+	void UContactSolver::SolveVelocities(SRigidBodyState& inOutBodies)
+	{
+		for (SConstraint& currentConstraint : m_constraints)
+		{
+			const uint32_t bodyA = currentConstraint.m_bodyA;
+			const uint32_t bodyB = currentConstraint.m_bodyB;
+			SBodyPairVelocities velocities = LoadVelocities(inOutBodies, bodyA, bodyB);
+
+			// Friction first, it's less important than not penetrating so the normal impulses get the last word
+			for (uint32_t j = 0; j < currentConstraint.m_pointCount; ++j)
+			{
+				SConstraintPoint& constraintPoint = currentConstraint.m_points[j];
+				const float maxFriction = currentConstraint.m_friction * constraintPoint.m_normalImpulse;
+
+				for (uint32_t k = 0; k < 2; ++k)
+				{
+					const Vector3& tangent = currentConstraint.m_tangents[k];
+					const float tangentVelocity = GetRelativeVelocity(velocities, constraintPoint.m_relativeA, constraintPoint.m_relativeB).Dot(tangent);
+
+					const float oldImpulse = constraintPoint.m_tangentImpulse[k];
+					constraintPoint.m_tangentImpulse[k] = Clamp(oldImpulse - constraintPoint.m_tangentMass[k] * tangentVelocity, -maxFriction, maxFriction);
+
+					ApplyImpulse(inOutBodies, bodyA, bodyB, constraintPoint.m_relativeA, constraintPoint.m_relativeB, tangent * (constraintPoint.m_tangentImpulse[k] - oldImpulse), velocities);
+				}
+			}
+
+			for (uint32_t j = 0; j < currentConstraint.m_pointCount; ++j)
+			{
+				SConstraintPoint& constraintPoint = currentConstraint.m_points[j];
+				const float normalVelocity = GetRelativeVelocity(velocities, constraintPoint.m_relativeA, constraintPoint.m_relativeB).Dot(currentConstraint.m_normal);
+
+				const float oldImpulse = constraintPoint.m_normalImpulse;
+				constraintPoint.m_normalImpulse = eastl::max(oldImpulse + constraintPoint.m_normalMass * (constraintPoint.m_velocityBias - normalVelocity), 0.0f);
+
+				ApplyImpulse(inOutBodies, bodyA, bodyB, constraintPoint.m_relativeA, constraintPoint.m_relativeB, currentConstraint.m_normal * (constraintPoint.m_normalImpulse - oldImpulse), velocities);
+			}
+
+			StoreVelocities(inOutBodies, bodyA, bodyB, velocities);
+		}
+	}
+
+	void UContactSolver::StoreImpulses(eastl::vector<SContactManifold>& inOutManifolds) const
+	{
+		for (const SConstraint& currentConstraint : m_constraints)
+		{
+			SContactManifold& currentManifold = inOutManifolds[currentConstraint.m_manifoldIndex];
+
+			for (uint32_t j = 0; j < currentConstraint.m_pointCount; ++j)
+			{
+				currentManifold.m_points[j].m_normalImpulse = currentConstraint.m_points[j].m_normalImpulse;
+				currentManifold.m_points[j].m_tangentImpulse[0] = currentConstraint.m_points[j].m_tangentImpulse[0];
+				currentManifold.m_points[j].m_tangentImpulse[1] = currentConstraint.m_points[j].m_tangentImpulse[1];
+			}
+		}
+	}
+}
@@ -0,0 +1,287 @@
+#include "Core/DynamicAABBTree.h"
+
+#include <EASTL/algorithm.h>
+
+#include "Misc/Assert.h"
+
+namespace MAD
+{
+	namespace
+	{
+		// How much further than it moved this tick a moving body's fat box reaches
+		const float g_displacementMultiplier = 2.0f;
+	}
+
+	UDynamicAABBTree::UDynamicAABBTree()
+		: m_rootNode(NullNode)
+		, m_freeList(NullNode)
+		, m_proxyCount(0) {}
+
+	int32_t UDynamicAABBTree::CreateProxy(const SAABB& inBounds, float inMargin, uint32_t inUserData)
+	{
+		const int32_t proxyID = AllocateNode();
+		const Vector3 margin(inMargin, inMargin, inMargin);
+
+		SNode& proxyNode = m_nodes[proxyID];
+		proxyNode.m_bounds = SAABB(inBounds.m_min - margin, inBounds.m_max + margin);
+		proxyNode.m_userData = inUserData;
+		proxyNode.m_height = 0;
+
+		InsertLeaf(proxyID);
+		++m_proxyCount;
+
+		return proxyID;
+	}
+
+	void UDynamicAABBTree::DestroyProxy(int32_t inProxyID)
+	{
+		MAD_ASSERT_DESC(IsProxy(inProxyID), "Error: Destroying a proxy that doesn't exist");
+
+		RemoveLeaf(inProxyID);
+		FreeNode(inProxyID);
+		--m_proxyCount;
+	}
+
+	bool UDynamicAABBTree::MoveProxy(int32_t inProxyID, const SAABB& inBounds, float inMargin, const Vector3& inDisplacement)
+	{
+		MAD_ASSERT_DESC(IsProxy(inProxyID), "Error: Moving a proxy that doesn't exist");
+
+		if (m_nodes[inProxyID].m_bounds.Contains(inBounds))
+		{
+			return false;
+		}
+
+		const Vector3 margin(inMargin, inMargin, inMargin);
+		const Vector3 predictedDisplacement = inDisplacement * g_displacementMultiplier;
+
+		SAABB fatBounds(inBounds.m_min - margin, inBounds.m_max + margin);
+		fatBounds.m_min += Vector3::Min(predictedDisplacement, Vector3::Zero);
+		fatBounds.m_max += Vector3::Max(predictedDisplacement, Vector3::Zero);
+
+		RemoveLeaf(inProxyID);
+		m_nodes[inProxyID].m_bounds = fatBounds;
+		InsertLeaf(inProxyID);
+
+		return true;
+	}
+
+	int32_t UDynamicAABBTree::AllocateNode()
+	{
+		if (m_freeList == NullNode)
+		{
+			// Grow the pool and thread the new nodes onto the free list
+			const int32_t oldCount = static_cast<int32_t>(m_nodes.size());
+			const int32_t newCount = eastl::max(oldCount * 2, 16);
+
+			m_nodes.resize(newCount);
+
+			for (int32_t i = oldCount; i < newCount; ++i)
+			{
+				m_nodes[i].m_parentOrNext = i + 1;
+				m_nodes[i].m_height = -1;
+			}
+
+			m_nodes[newCount - 1].m_parentOrNext = NullNode;
+			m_freeList = oldCount;
+		}
+
+		const int32_t nodeIndex = m_freeList;
+		SNode& newNode = m_nodes[nodeIndex];
+
+		m_freeList = newNode.m_parentOrNext;
+
+		newNode.m_parentOrNext = NullNode;
+		newNode.m_children[0] = NullNode;
+		newNode.m_children[1] = NullNode;
+		newNode.m_height = 0;
+		newNode.m_userData = 0;
+
+		return nodeIndex;
+	}
+
+	void UDynamicAABBTree::FreeNode(int32_t inNodeIndex)
+	{
+		m_nodes[inNodeIndex].m_parentOrNext = m_freeList;
+		m_nodes[inNodeIndex].m_height = -1;
+		m_freeList = inNodeIndex;
+	}
+
+	void UDynamicAABBTree::InsertLeaf(int32_t inLeafIndex)
+	{
+		if (m_rootNode == NullNode)
+		{
+			m_rootNode = inLeafIndex;
+			m_nodes[inLeafIndex].m_parentOrNext = NullNode;
+			return;
+		}
+
+		// Walk down to the sibling that makes the tree's surface area grow the least. Every node on the way grows to hold the
+		// leaf no matter which child we pick, that growth is the inherited cost of going further down
+		const SAABB leafBounds = m_nodes[inLeafIndex].m_bounds;
+		int32_t siblingIndex = m_rootNode;
+
+		while (!m_nodes[siblingIndex].IsLeaf())
+		{
+			const SNode& currentNode = m_nodes[siblingIndex];
+
+			const float currentArea = currentNode.m_bounds.GetPerimeter();
+			const float combinedArea = SAABB::Combine(currentNode.m_bounds, leafBounds).GetPerimeter();
+
+			// Cost of making a new parent for this node and the leaf
+			const float siblingCost = 2.0f * combinedArea;
+			const float inheritedCost = 2.0f * (combinedArea - currentArea);
+
+			float childCosts[2];
+			for (int32_t i = 0; i < 2; ++i)
+			{
+				const SNode& childNode = m_nodes[currentNode.m_children[i]];
+				const float childCombinedArea = SAABB::Combine(childNode.m_bounds, leafBounds).GetPerimeter();
+
+				childCosts[i] = childNode.IsLeaf() ? childCombinedArea + inheritedCost : (childCombinedArea - childNode.m_bounds.GetPerimeter()) + inheritedCost;
+			}
+
+			if (siblingCost < childCosts[0] && siblingCost < childCosts[1])
+			{
+				break;
+			}
+
+			siblingIndex = childCosts[0] < childCosts[1] ? currentNode.m_children[0] : currentNode.m_children[1];
+		}
+
+		// Make a new parent for the sibling and the leaf
+		const int32_t oldParentIndex = m_nodes[siblingIndex].m_parentOrNext;
+		const int32_t newParentIndex = AllocateNode();
+
+		SNode& newParent = m_nodes[newParentIndex];
+		newParent.m_parentOrNext = oldParentIndex;
+		newParent.m_bounds = SAABB::Combine(leafBounds, m_nodes[siblingIndex].m_bounds);
+		newParent.m_height = m_nodes[siblingIndex].m_height + 1;
+		newParent.m_children[0] = siblingIndex;
+		newParent.m_children[1] = inLeafIndex;
+
+		m_nodes[siblingIndex].m_parentOrNext = newParentIndex;
+		m_nodes[inLeafIndex].m_parentOrNext = newParentIndex;
+
+		if (oldParentIndex == NullNode)
+		{
+			m_rootNode = newParentIndex;
+		}
+		else
+		{
+			SNode& oldParent = m_nodes[oldParentIndex];
+			oldParent.m_children[oldParent.m_children[0] == siblingIndex ? 0 : 1] = newParentIndex;
+		}
+
+		RefitAncestors(m_nodes[inLeafIndex].m_parentOrNext);
+	}
+
+	void UDynamicAABBTree::RemoveLeaf(int32_t inLeafIndex)
+	{
+		if (inLeafIndex == m_rootNode)
+		{
+			m_rootNode = NullNode;
+			return;
+		}
+
+		// The leaf's sibling takes the place of their parent
+		const int32_t parentIndex = m_nodes[inLeafIndex].m_parentOrNext;
+		const int32_t grandParentIndex = m_nodes[parentIndex].m_parentOrNext;
+		const int32_t siblingIndex = m_nodes[parentIndex].m_children[0] == inLeafIndex ? m_nodes[parentIndex].m_children[1] : m_nodes[parentIndex].m_children[0];
+
+		FreeNode(parentIndex);
+
+		if (grandParentIndex == NullNode)
+		{
+			m_rootNode = siblingIndex;
+			m_nodes[siblingIndex].m_parentOrNext = NullNode;
+			return;
+		}
+
+		SNode& grandParent = m_nodes[grandParentIndex];
+		grandParent.m_children[grandParent.m_children[0] == parentIndex ? 0 : 1] = siblingIndex;
+		m_nodes[siblingIndex].m_parentOrNext = grandParentIndex;
+
+		RefitAncestors(grandParentIndex);
+	}
+
+	void UDynamicAABBTree::RefitAncestors(int32_t inNodeIndex)
+	{
+		int32_t currentIndex = inNodeIndex;
+
+		while (currentIndex != NullNode)
+		{
+			currentIndex = Balance(currentIndex);
+
+			SNode& currentNode = m_nodes[currentIndex];
+			const SNode& leftChild = m_nodes[currentNode.m_children[0]];
+			const SNode& rightChild = m_nodes[currentNode.m_children[1]];
+
+			currentNode.m_height = 1 + eastl::max(leftChild.m_height, rightChild.m_height);
+			currentNode.m_bounds = SAABB::Combine(leftChild.m_bounds, rightChild.m_bounds);
+
+			currentIndex = currentNode.m_parentOrNext;
+		}
+	}
+
+	int32_t UDynamicAABBTree::Balance(int32_t inNodeIndex)
+	{
+		// Rotates the taller child up when the children's heights differ by more than one
+		const int32_t indexA = inNodeIndex;
+		SNode& nodeA = m_nodes[indexA];
+
+		if (nodeA.IsLeaf() || nodeA.m_height < 2)
+		{
+			return indexA;
+		}
+
+		const int32_t indexB = nodeA.m_children[0];
+		const int32_t indexC = nodeA.m_children[1];
+
+		const int32_t heightDifference = m_nodes[indexC].m_height - m_nodes[indexB].m_height;
+		if (heightDifference >= -1 && heightDifference <= 1)
+		{
+			return indexA;
+		}
+
+		// The taller child goes up and A goes down in its place
+		const int32_t tallIndex = heightDifference > 1 ? indexC : indexB;
+		const int32_t shortIndex = heightDifference > 1 ? indexB : indexC;
+		const int32_t tallSlot = heightDifference > 1 ? 1 : 0;
+
+		SNode& tallNode = m_nodes[tallIndex];
+		const int32_t indexF = tallNode.m_children[0];
+		const int32_t indexG = tallNode.m_children[1];
+
+		tallNode.m_children[0] = indexA;
+		tallNode.m_parentOrNext = nodeA.m_parentOrNext;
+		nodeA.m_parentOrNext = tallIndex;
+
+		if (tallNode.m_parentOrNext == NullNode)
+		{
+			m_rootNode = tallIndex;
+		}
+		else
+		{
+			SNode& oldParent = m_nodes[tallNode.m_parentOrNext];
+			oldParent.m_children[oldParent.m_children[0] == indexA ? 0 : 1] = tallIndex;
+		}
+
+		// The taller of the tall node's children stays with it, the other one moves down to A
+		const bool isFTaller = m_nodes[indexF].m_height > m_nodes[indexG].m_height;
+		const int32_t keptIndex = isFTaller ? indexF : indexG;
+		const int32_t movedIndex = isFTaller ? indexG : indexF;
+
+		tallNode.m_children[1] = keptIndex;
+		nodeA.m_children[tallSlot] = movedIndex;
+		nodeA.m_children[1 - tallSlot] = shortIndex;
+		m_nodes[movedIndex].m_parentOrNext = indexA;
+
+		nodeA.m_bounds = SAABB::Combine(m_nodes[shortIndex].m_bounds, m_nodes[movedIndex].m_bounds);
+		nodeA.m_height = 1 + eastl::max(m_nodes[shortIndex].m_height, m_nodes[movedIndex].m_height);
+
+		tallNode.m_bounds = SAABB::Combine(nodeA.m_bounds, m_nodes[keptIndex].m_bounds);
+		tallNode.m_height = 1 + eastl::max(nodeA.m_height, m_nodes[keptIndex].m_height);
+
+		return tallIndex;
+	}
+}
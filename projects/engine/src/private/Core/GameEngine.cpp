@@ -10,6 +10,7 @@
 #include "Core/Pipeline/GameWorldLoader.h"
 #include "Core/PhysicsWorld.h"
 #include "Misc/AssetCache.h"
+#include "Misc/AsyncAssetLoader.h"
 #include "Rendering/Renderer.h"
 
 #include "Core/Character.h"
@@ -77,10 +78,18 @@ namespace MAD
 		{
 			gEngine->GetRenderer().ToggleTextBatching();
 		}
+
+		void OnDumpAssetCache()
+		{
+			UAssetCache::DumpContents();
+		}
 	}
 
 	UGameEngine::~UGameEngine()
 	{
+		// The loader threads may still be creating GPU resources
+		UAsyncAssetLoader::Shutdown();
+
 		m_networkManager.Shutdown();
 
 		m_worlds.clear();
@@ -174,6 +183,7 @@ namespace MAD
 
 		SControlScheme& debugScheme = SControlScheme("Debug")
 			.RegisterEvent("ReloadWorld", 'T')
+			.RegisterEvent("DumpAssetCache", 'Y')
 			.Finalize(true);
 
 		renderScheme.BindEvent<&OnDisableGBufferVisualization>("NormalView", EInputEvent::IE_KeyDown);
@@ -186,12 +196,15 @@ namespace MAD
 		renderScheme.BindEvent<&OnToggleHUD>("ToggleHUD", EInputEvent::IE_KeyDown);
 
 		debugScheme.BindEvent<UBaseEngine, &UBaseEngine::ReloadAllWorlds>("ReloadWorld", EInputEvent::IE_KeyDown, this);
+		debugScheme.BindEvent<&OnDumpAssetCache>("DumpAssetCache", EInputEvent::IE_KeyDown);
 	}
 
 	void UGameEngine::DrawOnScreeDebugText(float inFrameTime)
 	{
 		m_renderer->DrawOnScreenText(eastl::string("FPS: ").append(eastl::to_string(1.0f / inFrameTime)), 25, 25);
 		m_renderer->DrawOnScreenText(eastl::string("Num Worlds: ").append(eastl::to_string(m_worlds.size())), 25, 50);
+		m_renderer->DrawOnScreenText(eastl::string("Buffer Maps: ").append(eastl::to_string(m_renderer->GetLastFrameMapCount()))
+			.append(" (").append(eastl::to_string(m_renderer->GetLastFrameUnbatchedMapCount())).append(" unbatched)"), 25, 100);
 
 		for (const auto& currentWorld : m_worlds)
 		{
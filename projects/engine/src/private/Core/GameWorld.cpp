@@ -34,6 +34,43 @@ namespace MAD
 		inEntity->BeginPlay();
 	}
 
+	void OGameWorld::FinalizeSpawnEntities(const eastl::vector<eastl::shared_ptr<AEntity>>& inEntities)
+	{
+		rmt_ScopedCPUSample(World_FinalizeSpawnEntities, 0);
+
+		LOG(LogDefault, Log, "Finalizing spawning %u entities\n", static_cast<uint32_t>(inEntities.size()));
+
+		for (const auto& currentEntity : inEntities)
+		{
+			MAD_ASSERT_DESC(currentEntity.get() != nullptr, "Cannot finalize spawning a null entity");
+			currentEntity->GetOwningWorldLayer().AddEntityToLayer(currentEntity);
+		}
+
+		for (const auto& currentEntity : inEntities)
+		{
+			currentEntity->PostInitialize();
+		}
+
+		for (const auto& currentEntity : inEntities)
+		{
+			currentEntity->BeginPlay();
+		}
+	}
+
+	OGameWorldLayer& OGameWorld::FindOrAddWorldLayer(const eastl::string& inWorldLayerName)
+	{
+		auto targetWorldLayerIter = m_worldLayers.find(inWorldLayerName);
+
+		if (targetWorldLayerIter == m_worldLayers.end())
+		{
+			// Create new world layer and assign its owning world
+			targetWorldLayerIter = m_worldLayers.emplace(inWorldLayerName, OGameWorldLayer(this)).first;
+			targetWorldLayerIter->second.SetWorldLayerName(inWorldLayerName);
+		}
+
+		return targetWorldLayerIter->second;
+	}
+
 	size_t OGameWorld::GetEntityCount() const
 	{
 		size_t resultEntityCount = 0;
@@ -46,6 +83,18 @@ namespace MAD
 		return resultEntityCount;
 	}
 
+	uint64_t OGameWorld::ComputeSimulationChecksum() const
+	{
+		uint64_t worldChecksum = 0;
+
+		for (const auto& currentWorldLayer : m_worldLayers)
+		{
+			worldChecksum += currentWorldLayer.second.ComputeSimulationChecksum();
+		}
+
+		return worldChecksum;
+	}
+
 	void OGameWorld::CleanupEntities()
 	{
 		rmt_ScopedCPUSample(World_CleanupEntities, 0);
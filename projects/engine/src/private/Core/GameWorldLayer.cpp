@@ -1,5 +1,6 @@
 #include "Core/GameWorldLayer.h"
 #include "Core/Entity.h"
+#include "Core/SimulationChecksum.h"
 
 #include "Misc/Logging.h"
 
@@ -42,4 +43,29 @@ namespace MAD
 
 		//LOG(LogDefault, Log, "Num Entities After Cleanup: %d\n", m_layerEntities.size());
 	}
+
+	uint64_t OGameWorldLayer::ComputeSimulationChecksum() const
+	{
+		uint64_t layerChecksum = 0;
+
+		for (const auto& currentEntity : m_layerEntities)
+		{
+			if (currentEntity->IsPendingForKill())
+			{
+				continue;
+			}
+
+			// Object IDs are handed out locally, net IDs and type IDs are the same everywhere
+			USimulationChecksum entityChecksum;
+			entityChecksum.Add(static_cast<uint32_t>(currentEntity->GetNetID().GetUnderlyingHandle()));
+			entityChecksum.Add(static_cast<uint32_t>(currentEntity->GetTypeInfo()->GetTypeID()));
+			entityChecksum.Add(currentEntity->GetWorldScale());
+			entityChecksum.Add(currentEntity->GetWorldRotation());
+			entityChecksum.Add(currentEntity->GetWorldTranslation());
+
+			layerChecksum += entityChecksum.GetValue();
+		}
+
+		return layerChecksum;
+	}
 }
@@ -31,6 +31,11 @@ namespace MAD
 		}
 
 		// If static object, queue up static draw item right now
+		QueueStaticDrawItems();
+	}
+
+	void CMeshComponent::QueueStaticDrawItems() const
+	{
 		eastl::vector<SDrawItem> constructedDrawItems;
 
 		m_meshInstance.m_mesh->BuildDrawItems(constructedDrawItems, GetWorldTransform());
@@ -48,6 +53,11 @@ namespace MAD
 
 	void CMeshComponent::UpdateComponent(float)
 	{
+		if (m_pendingMesh.IsValid() && !m_pendingMesh.IsLoading())
+		{
+			OnPendingMeshLoaded();
+		}
+
 		// Only create the draw item if our mesh instance is initialized properly with a mesh and direct transform and the mesh is dynamic (moving around)
 		if (!m_meshInstance.m_mesh || !m_meshInstance.m_bVisible)
 		{
@@ -59,10 +69,23 @@ namespace MAD
 
 	bool CMeshComponent::LoadFrom(const eastl::string& inAssetName)
 	{
+		m_pendingMesh = TAssetHandle<UMesh>();
 		m_meshInstance.m_mesh = UMesh::Load(inAssetName);
 		return m_meshInstance.m_mesh != nullptr;
 	}
 
+	void CMeshComponent::OnPendingMeshLoaded()
+	{
+		m_meshInstance.m_mesh = m_pendingMesh.Get();
+		m_pendingMesh = TAssetHandle<UMesh>();
+
+		// Static draw items are normally queued in PostInitializeComponents, which ran before the mesh was in
+		if (m_meshInstance.m_mesh && m_meshInstance.m_bVisible && !m_bIsDynamic)
+		{
+			QueueStaticDrawItems();
+		}
+	}
+
 	void CMeshComponent::ConstructDrawItem() const
 	{
 		URenderer& targetRenderer = gEngine->GetRenderer();
@@ -103,7 +126,8 @@ namespace MAD
 		eastl::string meshName;
 		if (inPropertyObj.GetProperty("mesh", meshName))
 		{
-			m_meshInstance.m_mesh = UMesh::Load(meshName);
+			// Loaded in the background so that world loads don't block on it, the mesh shows up once it's in
+			m_pendingMesh = UMesh::LoadAsync(meshName);
 		}
 
 #ifdef MAD_EDITOR
@@ -1,15 +1,197 @@
 #include "Core/PhysicsComponent.h"
+#include "Core/CollisionMesh.h"
+#include "Core/GameEngine.h"
 #include "Core/GameWorld.h"
+#include "Core/PhysicsWorld.h"
+#include "Core/Pipeline/GameWorldLoader.h"
+#include "Misc/Logging.h"
 
 namespace MAD
 {
+	DECLARE_LOG_CATEGORY(LogPhysicsComponent);
 
 	CPhysicsComponent::CPhysicsComponent(OGameWorld* inOwningWorld)
-		: Super_t(inOwningWorld) {}
+		: Super_t(inOwningWorld)
+		, m_mass(0.0f)
+		, m_friction(0.5f)
+		, m_restitution(0.0f)
+		, m_gravityScale(1.0f)
+		, m_isContinuous(false)
+		, m_queryLayer(0)
+		, m_bodyIndex(UPhysicsWorld::InvalidBodyIndex) {}
+
+	void CPhysicsComponent::OnBeginPlay()
+	{
+		if (m_shape.m_type == EPhysicsShapeType::TriangleMesh && !m_shape.m_collisionMesh)
+		{
+			LOG(LogPhysicsComponent, Warning, "Physics component has a mesh shape but no collision mesh, it won't collide with anything\n");
+			return;
+		}
+
+		// The physics world only holds on to its bodies weakly, so that they unregister themselves by being destroyed
+		for (const auto& currentPhysicsComponent : GetOwningEntity().GetComponentsByType<CPhysicsComponent>())
+		{
+			if (currentPhysicsComponent.lock().get() == this)
+			{
+				gEngine->GetPhysicsWorld().RegisterPhysicsComponent(currentPhysicsComponent);
+				break;
+			}
+		}
+	}
+
+	void CPhysicsComponent::Load(const UGameWorldLoader& inLoader, const UObjectValue& inPropertyObj)
+	{
+		UNREFERENCED_PARAMETER(inLoader);
+
+		eastl::string shapeName;
+		if (inPropertyObj.GetProperty("shape", shapeName) && !SPhysicsShape::ParseShapeType(shapeName, m_shape.m_type))
+		{
+			LOG(LogPhysicsComponent, Warning, "Unknown physics shape `%s`, expected sphere, box, capsule or mesh\n", shapeName.c_str());
+		}
+
+		inPropertyObj.GetProperty("halfExtents", m_shape.m_halfExtents);
+		inPropertyObj.GetProperty("radius", m_shape.m_radius);
+		inPropertyObj.GetProperty("halfHeight", m_shape.m_halfHeight);
+		inPropertyObj.GetProperty("mass", m_mass);
+		inPropertyObj.GetProperty("friction", m_friction);
+		inPropertyObj.GetProperty("restitution", m_restitution);
+		inPropertyObj.GetProperty("gravityScale", m_gravityScale);
+		inPropertyObj.GetProperty("continuousCollision", m_isContinuous);
+		inPropertyObj.GetProperty("linearVelocity", m_linearVelocity);
+
+		uint32_t queryLayer;
+		if (inPropertyObj.GetProperty("queryLayer", queryLayer))
+		{
+			SetQueryLayer(queryLayer);
+		}
+
+		if (m_shape.m_type == EPhysicsShapeType::TriangleMesh)
+		{
+			eastl::string collisionMeshPath;
+			if (inPropertyObj.GetProperty("collisionMesh", collisionMeshPath))
+			{
+				m_shape.m_collisionMesh = UCollisionMesh::Load(collisionMeshPath);
+			}
+
+			if (!m_shape.m_collisionMesh)
+			{
+				LOG(LogPhysicsComponent, Warning, "Couldn't load the collision mesh `%s`\n", collisionMeshPath.c_str());
+			}
+
+			// Triangle meshes have no volume to give them a mass or an inertia
+			if (m_mass > 0.0f)
+			{
+				LOG(LogPhysicsComponent, Warning, "Triangle mesh bodies can't be dynamic, ignoring their mass\n");
+				m_mass = 0.0f;
+			}
+		}
+	}
 
 	void CPhysicsComponent::UpdateComponent(float inDeltaTime)
 	{
 		(void)inDeltaTime;
 	}
 
+	Vector3 CPhysicsComponent::GetLinearVelocity() const
+	{
+		if (m_bodyIndex == UPhysicsWorld::InvalidBodyIndex)
+		{
+			return m_linearVelocity;
+		}
+
+		return gEngine->GetPhysicsWorld().GetLinearVelocity(m_bodyIndex);
+	}
+
+	void CPhysicsComponent::SetLinearVelocity(const Vector3& inLinearVelocity)
+	{
+		if (m_bodyIndex == UPhysicsWorld::InvalidBodyIndex)
+		{
+			m_linearVelocity = inLinearVelocity;
+			return;
+		}
+
+		gEngine->GetPhysicsWorld().SetLinearVelocity(m_bodyIndex, inLinearVelocity);
+	}
+
+	void CPhysicsComponent::AddImpulse(const Vector3& inImpulse)
+	{
+		if (!IsDynamic())
+		{
+			return;
+		}
+
+		if (m_bodyIndex == UPhysicsWorld::InvalidBodyIndex)
+		{
+			m_linearVelocity += inImpulse / m_mass;
+			return;
+		}
+
+		gEngine->GetPhysicsWorld().AddImpulse(m_bodyIndex, inImpulse);
+	}
+
+	bool CPhysicsComponent::IsAwake() const
+	{
+		if (m_bodyIndex == UPhysicsWorld::InvalidBodyIndex)
+		{
+			return true;
+		}
+
+		return gEngine->GetPhysicsWorld().IsAwake(m_bodyIndex);
+	}
+
+	void CPhysicsComponent::WakeUp()
+	{
+		if (m_bodyIndex != UPhysicsWorld::InvalidBodyIndex)
+		{
+			gEngine->GetPhysicsWorld().WakeUp(m_bodyIndex);
+		}
+	}
+
+	void CPhysicsComponent::SetContinuous(bool inIsContinuous)
+	{
+		m_isContinuous = inIsContinuous;
+
+		if (m_bodyIndex != UPhysicsWorld::InvalidBodyIndex)
+		{
+			gEngine->GetPhysicsWorld().SetContinuous(m_bodyIndex, inIsContinuous);
+		}
+	}
+
+	void CPhysicsComponent::SetQueryLayer(uint32_t inQueryLayer)
+	{
+		if (inQueryLayer >= 32)
+		{
+			LOG(LogPhysicsComponent, Warning, "Query layer %u is out of range, layers go from 0 to 31\n", inQueryLayer);
+			return;
+		}
+
+		m_queryLayer = inQueryLayer;
+
+		if (m_bodyIndex != UPhysicsWorld::InvalidBodyIndex)
+		{
+			gEngine->GetPhysicsWorld().SetQueryLayer(m_bodyIndex, inQueryLayer);
+		}
+	}
+
+	SRigidBodyDescription CPhysicsComponent::GetBodyDescription() const
+	{
+		SRigidBodyDescription bodyDescription;
+		bodyDescription.m_shape = m_shape.Scaled(GetWorldScale());
+		bodyDescription.m_position = GetWorldTranslation();
+		bodyDescription.m_rotation = GetWorldRotation();
+		bodyDescription.m_linearVelocity = m_linearVelocity;
+		bodyDescription.m_mass = m_mass;
+		bodyDescription.m_friction = m_friction;
+		bodyDescription.m_restitution = m_restitution;
+		bodyDescription.m_gravityScale = m_gravityScale;
+		bodyDescription.m_isContinuous = m_isContinuous;
+
+		return bodyDescription;
+	}
+
+	SAABB CPhysicsComponent::GetWorldBounds() const
+	{
+		return m_shape.Scaled(GetWorldScale()).ComputeBounds(GetWorldTranslation(), GetWorldRotation());
+	}
+
 }
@@ -0,0 +1,134 @@
+#include "Core/PhysicsIslands.h"
+
+#include "Misc/Remotery.h"
+
+namespace MAD
+{
+	namespace
+	{
+		const uint32_t g_invalidIsland = 0xFFFFFFFF;
+	}
+
+	void UPhysicsIslandBuilder::Build(const SRigidBodyState& inBodies, const eastl::vector<SContactManifold>& inManifolds)
+	{
+		rmt_ScopedCPUSample(PhysicsIslandBuilder_Build, 0);
+
+		const uint32_t bodyCount = static_cast<uint32_t>(inBodies.GetBodyCount());
+
+		m_parents.resize(bodyCount);
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			m_parents[i] = i;
+		}
+
+		for (const SContactManifold& currentManifold : inManifolds)
+		{
+			if (inBodies.IsDynamic(currentManifold.m_bodyA) && inBodies.IsDynamic(currentManifold.m_bodyB))
+			{
+				MergeIslands(currentManifold.m_bodyA, currentManifold.m_bodyB);
+			}
+		}
+
+		// Count the bodies and contacts of every island first, so that each island's lists can be laid out contiguously
+		m_bodyIslands.assign(bodyCount, g_invalidIsland);
+		m_islands.clear();
+
+		uint32_t dynamicBodyCount = 0;
+
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			if (!inBodies.IsDynamic(i))
+			{
+				continue;
+			}
+
+			const uint32_t rootIndex = FindRoot(i);
+
+			if (m_bodyIslands[rootIndex] == g_invalidIsland)
+			{
+				m_bodyIslands[rootIndex] = static_cast<uint32_t>(m_islands.size());
+				m_islands.push_back({ 0, 0, 0, 0, false });
+			}
+
+			const uint32_t islandIndex = m_bodyIslands[rootIndex];
+			m_bodyIslands[i] = islandIndex;
+
+			SPhysicsIsland& currentIsland = m_islands[islandIndex];
+			++currentIsland.m_bodyCount;
+			currentIsland.m_isAwake |= inBodies.IsAwake(i);
+			++dynamicBodyCount;
+		}
+
+		for (const SContactManifold& currentManifold : inManifolds)
+		{
+			const uint32_t dynamicBody = inBodies.IsDynamic(currentManifold.m_bodyA) ? currentManifold.m_bodyA : currentManifold.m_bodyB;
+
+			SPhysicsIsland& currentIsland = m_islands[m_bodyIslands[dynamicBody]];
+			++currentIsland.m_manifoldCount;
+			currentIsland.m_isAwake |= inBodies.IsAwake(currentManifold.m_bodyA) || inBodies.IsAwake(currentManifold.m_bodyB);
+		}
+
+		uint32_t nextBody = 0;
+		uint32_t nextManifold = 0;
+
+		for (SPhysicsIsland& currentIsland : m_islands)
+		{
+			currentIsland.m_firstBody = nextBody;
+			currentIsland.m_firstManifold = nextManifold;
+			nextBody += currentIsland.m_bodyCount;
+			nextManifold += currentIsland.m_manifoldCount;
+
+			// Used as the fill cursors below
+			currentIsland.m_bodyCount = 0;
+			currentIsland.m_manifoldCount = 0;
+		}
+
+		m_islandBodies.resize(dynamicBodyCount);
+		m_islandManifolds.resize(inManifolds.size());
+
+		for (uint32_t i = 0; i < bodyCount; ++i)
+		{
+			if (m_bodyIslands[i] != g_invalidIsland)
+			{
+				SPhysicsIsland& currentIsland = m_islands[m_bodyIslands[i]];
+				m_islandBodies[currentIsland.m_firstBody + currentIsland.m_bodyCount++] = i;
+			}
+		}
+
+		for (uint32_t i = 0; i < inManifolds.size(); ++i)
+		{
+			const SContactManifold& currentManifold = inManifolds[i];
+			const uint32_t dynamicBody = inBodies.IsDynamic(currentManifold.m_bodyA) ? currentManifold.m_bodyA : currentManifold.m_bodyB;
+
+			SPhysicsIsland& currentIsland = m_islands[m_bodyIslands[dynamicBody]];
+			m_islandManifolds[currentIsland.m_firstManifold + currentIsland.m_manifoldCount++] = i;
+		}
+	}
+
+	uint32_t UPhysicsIslandBuilder::FindRoot(uint32_t inBodyIndex)
+	{
+		// Path halving keeps the trees flat without recursion
+		while (m_parents[inBodyIndex] != inBodyIndex)
+		{
+			m_parents[inBodyIndex] = m_parents[m_parents[inBodyIndex]];
+			inBodyIndex = m_parents[inBodyIndex];
+		}
+
+		return inBodyIndex;
+	}
+
+	void UPhysicsIslandBuilder::MergeIslands(uint32_t inBodyA, uint32_t inBodyB)
+	{
+		const uint32_t rootA = FindRoot(inBodyA);
+		const uint32_t rootB = FindRoot(inBodyB);
+
+		if (rootA < rootB)
+		{
+			m_parents[rootB] = rootA;
+		}
+		else if (rootB < rootA)
+		{
+			m_parents[rootA] = rootB;
+		}
+	}
+}
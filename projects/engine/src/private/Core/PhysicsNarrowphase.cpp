@@ -0,0 +1,1156 @@
+#include "Core/PhysicsNarrowphase.h"
+
+#include <cfloat>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/fixed_vector.h>
+
+#include "Core/CollisionMesh.h"
+
+namespace MAD
+{
+	namespace
+	{
+		// The most a box face clipped against 4 planes can turn into
+		const uint32_t g_maxClipVertices = 8;
+
+		// Edge contacts have to be this much better than face contacts to be picked, so that resting boxes don't flip between the two
+		const float g_edgeRelativeTolerance = 0.95f;
+		const float g_edgeAbsoluteTolerance = 0.1f;
+
+		// Capsule contacts whose normals diverge more than this from the deepest one are dropped, a manifold only has one normal
+		const float g_minCapsuleNormalAlignment = 0.9f;
+
+		// Same for the contacts of the different triangles a body touches in a triangle mesh
+		const float g_minMeshNormalAlignment = 0.9f;
+
+		// A contact of one triangle of a mesh, before they're all merged into the mesh's manifold
+		struct STriangleContact
+		{
+			Vector3 m_normal; // From the triangle to the other shape
+			Vector3 m_position;
+			float m_penetration;
+		};
+
+		Vector3 RotateVector(const Vector3& inVector, const Quaternion& inRotation)
+		{
+			return Vector3::Transform(inVector, inRotation);
+		}
+
+		Vector3 InverseRotateVector(const Vector3& inVector, const Quaternion& inRotation)
+		{
+			return Vector3::Transform(inVector, Quaternion(-inRotation.x, -inRotation.y, -inRotation.z, inRotation.w));
+		}
+
+		void GetAxes(const Quaternion& inRotation, Vector3 outAxes[3])
+		{
+			const Matrix rotation = Matrix::CreateFromQuaternion(inRotation);
+
+			outAxes[0] = Vector3(rotation._11, rotation._12, rotation._13);
+			outAxes[1] = Vector3(rotation._21, rotation._22, rotation._23);
+			outAxes[2] = Vector3(rotation._31, rotation._32, rotation._33);
+		}
+
+		float GetComponent(const Vector3& inVector, int32_t inAxis)
+		{
+			return inAxis == 0 ? inVector.x : (inAxis == 1 ? inVector.y : inVector.z);
+		}
+
+		void SetComponent(Vector3& inOutVector, int32_t inAxis, float inValue)
+		{
+			(inAxis == 0 ? inOutVector.x : (inAxis == 1 ? inOutVector.y : inOutVector.z)) = inValue;
+		}
+
+		void GetCapsuleSegment(const SCollisionBody& inCapsule, Vector3& outStart, Vector3& outEnd)
+		{
+			const Vector3 halfAxis = RotateVector(Vector3::Up, inCapsule.m_rotation) * inCapsule.m_shape->m_halfHeight;
+
+			outStart = inCapsule.m_position - halfAxis;
+			outEnd = inCapsule.m_position + halfAxis;
+		}
+
+		Vector3 ClosestPointOnSegment(const Vector3& inPoint, const Vector3& inStart, const Vector3& inEnd)
+		{
+			const Vector3 segment = inEnd - inStart;
+			const float lengthSquared = segment.LengthSquared();
+
+			if (lengthSquared <= 1e-8f)
+			{
+				return inStart;
+			}
+
+			return inStart + segment * Saturate((inPoint - inStart).Dot(segment) / lengthSquared);
+		}
+
+		// Closest points between segments [inStartA, inEndA] and [inStartB, inEndB], from Real-Time Collision Detection 5.1.9
+		void ClosestPointsBetweenSegments(const Vector3& inStartA, const Vector3& inEndA, const Vector3& inStartB, const Vector3& inEndB, Vector3& outPointA, Vector3& outPointB)
+		{
+			const Vector3 directionA = inEndA - inStartA;
+			const Vector3 directionB = inEndB - inStartB;
+			const Vector3 startOffset = inStartA - inStartB;
+
+			const float lengthSquaredA = directionA.LengthSquared();
+			const float lengthSquaredB = directionB.LengthSquared();
+			const float projectionB = directionB.Dot(startOffset);
+
+			float s = 0.0f;
+			float t = 0.0f;
+
+			if (lengthSquaredA <= 1e-8f && lengthSquaredB <= 1e-8f)
+			{
+				outPointA = inStartA;
+				outPointB = inStartB;
+				return;
+			}
+
+			if (lengthSquaredA <= 1e-8f)
+			{
+				t = Saturate(projectionB / lengthSquaredB);
+			}
+			else
+			{
+				const float projectionA = directionA.Dot(startOffset);
+
+				if (lengthSquaredB <= 1e-8f)
+				{
+					s = Saturate(-projectionA / lengthSquaredA);
+				}
+				else
+				{
+					const float directionDot = directionA.Dot(directionB);
+					const float denominator = lengthSquaredA * lengthSquaredB - directionDot * directionDot;
+
+					// Parallel segments have no unique answer, any s works so start from the beginning of A
+					s = denominator > 1e-8f ? Saturate((directionDot * projectionB - projectionA * lengthSquaredB) / denominator) : 0.0f;
+					t = (directionDot * s + projectionB) / lengthSquaredB;
+
+					if (t < 0.0f)
+					{
+						t = 0.0f;
+						s = Saturate(-projectionA / lengthSquaredA);
+					}
+					else if (t > 1.0f)
+					{
+						t = 1.0f;
+						s = Saturate((directionDot - projectionA) / lengthSquaredA);
+					}
+				}
+			}
+
+			outPointA = inStartA + directionA * s;
+			outPointB = inStartB + directionB * t;
+		}
+
+		void AddContact(SContactManifold& inOutManifold, const Vector3& inPosition, float inPenetration)
+		{
+			if (inOutManifold.m_pointCount < SContactManifold::MaxPoints)
+			{
+				SContactPoint& newPoint = inOutManifold.m_points[inOutManifold.m_pointCount++];
+				newPoint.m_position = inPosition;
+				newPoint.m_penetration = inPenetration;
+			}
+		}
+
+		// Sphere of inRadiusA at inCenterA against sphere of inRadiusB at inCenterB. The first contact decides the normal
+		bool AddSphereContact(const Vector3& inCenterA, float inRadiusA, const Vector3& inCenterB, float inRadiusB, SContactManifold& inOutManifold)
+		{
+			const Vector3 offset = inCenterB - inCenterA;
+			const float distanceSquared = offset.LengthSquared();
+			const float radiusSum = inRadiusA + inRadiusB;
+
+			if (distanceSquared > radiusSum * radiusSum)
+			{
+				return false;
+			}
+
+			const float distance = sqrtf(distanceSquared);
+			const Vector3 normal = distance > 1e-4f ? offset / distance : Vector3::Up;
+
+			if (inOutManifold.m_pointCount == 0)
+			{
+				inOutManifold.m_normal = normal;
+			}
+
+			const Vector3 surfaceA = inCenterA + normal * inRadiusA;
+			const Vector3 surfaceB = inCenterB - normal * inRadiusB;
+			AddContact(inOutManifold, (surfaceA + surfaceB) * 0.5f, radiusSum - distance);
+
+			return true;
+		}
+
+		// Normal from the box to the sphere
+		bool CollideBoxSphere(const SCollisionBody& inBox, const Vector3& inSphereCenter, float inSphereRadius, SContactManifold& inOutManifold)
+		{
+			const Vector3& halfExtents = inBox.m_shape->m_halfExtents;
+			const Vector3 localCenter = InverseRotateVector(inSphereCenter - inBox.m_position, inBox.m_rotation);
+			const Vector3 clampedCenter = Vector3::Min(Vector3::Max(localCenter, -halfExtents), halfExtents);
+
+			Vector3 localNormal;
+			Vector3 localSurfacePoint = clampedCenter;
+			float penetration;
+
+			const Vector3 offset = localCenter - clampedCenter;
+			const float distanceSquared = offset.LengthSquared();
+
+			if (distanceSquared > 1e-8f)
+			{
+				if (distanceSquared > inSphereRadius * inSphereRadius)
+				{
+					return false;
+				}
+
+				const float distance = sqrtf(distanceSquared);
+				localNormal = offset / distance;
+				penetration = inSphereRadius - distance;
+			}
+			else
+			{
+				// The center is inside the box, push it out through the closest face
+				int32_t closestAxis = 0;
+				float closestFaceDistance = FLT_MAX;
+
+				for (int32_t i = 0; i < 3; ++i)
+				{
+					const float faceDistance = GetComponent(halfExtents, i) - fabs(GetComponent(localCenter, i));
+					if (faceDistance < closestFaceDistance)
+					{
+						closestFaceDistance = faceDistance;
+						closestAxis = i;
+					}
+				}
+
+				const float faceSign = GetComponent(localCenter, closestAxis) >= 0.0f ? 1.0f : -1.0f;
+
+				localNormal = Vector3::Zero;
+				SetComponent(localNormal, closestAxis, faceSign);
+				SetComponent(localSurfacePoint, closestAxis, faceSign * GetComponent(halfExtents, closestAxis));
+				penetration = inSphereRadius + closestFaceDistance;
+			}
+
+			const Vector3 normal = RotateVector(localNormal, inBox.m_rotation);
+			const Vector3 boxSurface = inBox.m_position + RotateVector(localSurfacePoint, inBox.m_rotation);
+			const Vector3 sphereSurface = inSphereCenter - normal * inSphereRadius;
+
+			if (inOutManifold.m_pointCount == 0)
+			{
+				inOutManifold.m_normal = normal;
+			}
+
+			AddContact(inOutManifold, (boxSurface + sphereSurface) * 0.5f, penetration);
+			return true;
+		}
+
+		bool CollideSphereSphere(const SCollisionBody& inBodyA, const SCollisionBody& inBodyB, SContactManifold& outManifold)
+		{
+			return AddSphereContact(inBodyA.m_position, inBodyA.m_shape->m_radius, inBodyB.m_position, inBodyB.m_shape->m_radius, outManifold);
+		}
+
+		bool CollideSphereBox(const SCollisionBody& inSphere, const SCollisionBody& inBox, SContactManifold& outManifold)
+		{
+			if (!CollideBoxSphere(inBox, inSphere.m_position, inSphere.m_shape->m_radius, outManifold))
+			{
+				return false;
+			}
+
+			outManifold.m_normal = -outManifold.m_normal;
+			return true;
+		}
+
+		bool CollideSphereCapsule(const SCollisionBody& inSphere, const SCollisionBody& inCapsule, SContactManifold& outManifold)
+		{
+			Vector3 segmentStart, segmentEnd;
+			GetCapsuleSegment(inCapsule, segmentStart, segmentEnd);
+
+			const Vector3 closestPoint = ClosestPointOnSegment(inSphere.m_position, segmentStart, segmentEnd);
+			return AddSphereContact(inSphere.m_position, inSphere.m_shape->m_radius, closestPoint, inCapsule.m_shape->m_radius, outManifold);
+		}
+
+		bool CollideCapsuleCapsule(const SCollisionBody& inCapsuleA, const SCollisionBody& inCapsuleB, SContactManifold& outManifold)
+		{
+			Vector3 startA, endA, startB, endB;
+			GetCapsuleSegment(inCapsuleA, startA, endA);
+			GetCapsuleSegment(inCapsuleB, startB, endB);
+
+			const float radiusA = inCapsuleA.m_shape->m_radius;
+			const float radiusB = inCapsuleB.m_shape->m_radius;
+
+			Vector3 closestA, closestB;
+			ClosestPointsBetweenSegments(startA, endA, startB, endB, closestA, closestB);
+
+			if (!AddSphereContact(closestA, radiusA, closestB, radiusB, outManifold))
+			{
+				return false;
+			}
+
+			// Capsules lying side by side need a contact at both ends of their overlap, or they roll around the single one
+			const Vector3 directionA = endA - startA;
+			const Vector3 directionB = endB - startB;
+			const float lengthSquaredA = directionA.LengthSquared();
+
+			if (lengthSquaredA > 1e-8f && directionA.Cross(directionB).LengthSquared() < 1e-4f * lengthSquaredA * directionB.LengthSquared())
+			{
+				const float projectedStart = Saturate((startB - startA).Dot(directionA) / lengthSquaredA);
+				const float projectedEnd = Saturate((endB - startA).Dot(directionA) / lengthSquaredA);
+				const float overlapEnds[2] = { eastl::min(projectedStart, projectedEnd), eastl::max(projectedStart, projectedEnd) };
+
+				if (overlapEnds[1] - overlapEnds[0] > 1e-3f)
+				{
+					outManifold.m_pointCount = 0;
+
+					for (float currentOverlapEnd : overlapEnds)
+					{
+						const Vector3 pointA = startA + directionA * currentOverlapEnd;
+						AddSphereContact(pointA, radiusA, ClosestPointOnSegment(pointA, startB, endB), radiusB, outManifold);
+					}
+				}
+			}
+
+			return outManifold.m_pointCount > 0;
+		}
+
+		// Contacts of a capsule's two end spheres, at least one of which touches. Both are kept if their normals agree
+		void AddCapsuleEndContacts(const SContactManifold inEndContacts[2], SContactManifold& outManifold)
+		{
+			const bool hasStartContact = inEndContacts[0].m_pointCount > 0;
+			const bool hasEndContact = inEndContacts[1].m_pointCount > 0;
+
+			const int32_t deepestIndex = !hasEndContact || (hasStartContact && inEndContacts[0].m_points[0].m_penetration >= inEndContacts[1].m_points[0].m_penetration) ? 0 : 1;
+			const SContactManifold& deepestContact = inEndContacts[deepestIndex];
+			const SContactManifold& otherContact = inEndContacts[1 - deepestIndex];
+
+			outManifold.m_normal = deepestContact.m_normal;
+			AddContact(outManifold, deepestContact.m_points[0].m_position, deepestContact.m_points[0].m_penetration);
+
+			if (otherContact.m_pointCount > 0 && otherContact.m_normal.Dot(deepestContact.m_normal) > g_minCapsuleNormalAlignment)
+			{
+				AddContact(outManifold, otherContact.m_points[0].m_position, otherContact.m_points[0].m_penetration);
+			}
+		}
+
+		bool CollideBoxCapsule(const SCollisionBody& inBox, const SCollisionBody& inCapsule, SContactManifold& outManifold)
+		{
+			Vector3 segmentStart, segmentEnd;
+			GetCapsuleSegment(inCapsule, segmentStart, segmentEnd);
+
+			const float radius = inCapsule.m_shape->m_radius;
+
+			// A capsule lying on a face touches it with both caps
+			SContactManifold endContacts[2];
+			endContacts[0].m_pointCount = 0;
+			endContacts[1].m_pointCount = 0;
+
+			const bool hasStartContact = CollideBoxSphere(inBox, segmentStart, radius, endContacts[0]);
+			const bool hasEndContact = CollideBoxSphere(inBox, segmentEnd, radius, endContacts[1]);
+
+			if (!hasStartContact && !hasEndContact)
+			{
+				// Otherwise find the point of the segment closest to the box by bouncing between the two
+				Vector3 segmentPoint = ClosestPointOnSegment(inBox.m_position, segmentStart, segmentEnd);
+				const Vector3& halfExtents = inBox.m_shape->m_halfExtents;
+
+				for (int32_t i = 0; i < 4; ++i)
+				{
+					const Vector3 localPoint = InverseRotateVector(segmentPoint - inBox.m_position, inBox.m_rotation);
+					const Vector3 boxPoint = inBox.m_position + RotateVector(Vector3::Min(Vector3::Max(localPoint, -halfExtents), halfExtents), inBox.m_rotation);
+
+					segmentPoint = ClosestPointOnSegment(boxPoint, segmentStart, segmentEnd);
+				}
+
+				return CollideBoxSphere(inBox, segmentPoint, radius, outManifold);
+			}
+
+			AddCapsuleEndContacts(endContacts, outManifold);
+			return true;
+		}
+
+		// Keeps the points on the inner side of the plane inNormal . x <= inOffset. Returns the new vertex count
+		uint32_t ClipPolygon(const Vector3* inVertices, uint32_t inVertexCount, const Vector3& inNormal, float inOffset, Vector3* outVertices)
+		{
+			uint32_t outVertexCount = 0;
+
+			for (uint32_t i = 0; i < inVertexCount; ++i)
+			{
+				const Vector3& currentVertex = inVertices[i];
+				const Vector3& nextVertex = inVertices[(i + 1) % inVertexCount];
+
+				const float currentDistance = inNormal.Dot(currentVertex) - inOffset;
+				const float nextDistance = inNormal.Dot(nextVertex) - inOffset;
+
+				if (currentDistance <= 0.0f && outVertexCount < g_maxClipVertices)
+				{
+					outVertices[outVertexCount++] = currentVertex;
+				}
+
+				if ((currentDistance < 0.0f) != (nextDistance < 0.0f) && outVertexCount < g_maxClipVertices)
+				{
+					const float intersection = currentDistance / (currentDistance - nextDistance);
+					outVertices[outVertexCount++] = currentVertex + (nextVertex - currentVertex) * intersection;
+				}
+			}
+
+			return outVertexCount;
+		}
+
+		// Picks the 4 points that keep the most of the contact area: the deepest, the one furthest from it, and then the two that
+		// stick out the furthest on either side of the line between them
+		void ReduceContacts(const Vector3* inPoints, const float* inPenetrations, uint32_t inPointCount, const Vector3& inNormal, SContactManifold& inOutManifold)
+		{
+			if (inPointCount <= SContactManifold::MaxPoints)
+			{
+				for (uint32_t i = 0; i < inPointCount; ++i)
+				{
+					AddContact(inOutManifold, inPoints[i], inPenetrations[i]);
+				}
+
+				return;
+			}
+
+			uint32_t chosenIndices[SContactManifold::MaxPoints] = { 0, 0, 0, 0 };
+
+			for (uint32_t i = 1; i < inPointCount; ++i)
+			{
+				if (inPenetrations[i] > inPenetrations[chosenIndices[0]])
+				{
+					chosenIndices[0] = i;
+				}
+			}
+
+			float furthestDistance = -1.0f;
+			for (uint32_t i = 0; i < inPointCount; ++i)
+			{
+				const float distance = (inPoints[i] - inPoints[chosenIndices[0]]).LengthSquared();
+				if (distance > furthestDistance)
+				{
+					furthestDistance = distance;
+					chosenIndices[1] = i;
+				}
+			}
+
+			const Vector3 lineDirection = inPoints[chosenIndices[1]] - inPoints[chosenIndices[0]];
+			float largestArea = -FLT_MAX;
+			float smallestArea = FLT_MAX;
+
+			for (uint32_t i = 0; i < inPointCount; ++i)
+			{
+				const float signedArea = lineDirection.Cross(inPoints[i] - inPoints[chosenIndices[0]]).Dot(inNormal);
+				if (signedArea > largestArea)
+				{
+					largestArea = signedArea;
+					chosenIndices[2] = i;
+				}
+
+				if (signedArea < smallestArea)
+				{
+					smallestArea = signedArea;
+					chosenIndices[3] = i;
+				}
+			}
+
+			for (uint32_t i = 0; i < SContactManifold::MaxPoints; ++i)
+			{
+				AddContact(inOutManifold, inPoints[chosenIndices[i]], inPenetrations[chosenIndices[i]]);
+			}
+		}
+
+		// The face of inBox that faces back against inFaceNormal the most
+		void GetIncidentFace(const SCollisionBody& inBox, const Vector3 inAxes[3], const Vector3& inFaceNormal, Vector3 outVertices[4])
+		{
+			const Vector3& extents = inBox.m_shape->m_halfExtents;
+
+			int32_t incidentAxis = 0;
+			float mostAntiParallel = -1.0f;
+
+			for (int32_t j = 0; j < 3; ++j)
+			{
+				const float alignment = fabs(inAxes[j].Dot(inFaceNormal));
+				if (alignment > mostAntiParallel)
+				{
+					mostAntiParallel = alignment;
+					incidentAxis = j;
+				}
+			}
+
+			const float incidentSign = inAxes[incidentAxis].Dot(inFaceNormal) > 0.0f ? -1.0f : 1.0f;
+			const Vector3 incidentCenter = inBox.m_position + inAxes[incidentAxis] * (GetComponent(extents, incidentAxis) * incidentSign);
+
+			const int32_t incidentSideU = (incidentAxis + 1) % 3;
+			const int32_t incidentSideV = (incidentAxis + 2) % 3;
+			const Vector3 incidentU = inAxes[incidentSideU] * GetComponent(extents, incidentSideU);
+			const Vector3 incidentV = inAxes[incidentSideV] * GetComponent(extents, incidentSideV);
+
+			outVertices[0] = incidentCenter + incidentU + incidentV;
+			outVertices[1] = incidentCenter - incidentU + incidentV;
+			outVertices[2] = incidentCenter - incidentU - incidentV;
+			outVertices[3] = incidentCenter + incidentU - incidentV;
+		}
+
+		// Clips the polygon in inOutClipBuffers[inOutCurrentBuffer] against the four sides of inBox's faces along inFaceAxis. The
+		// clipped polygon ends up in inOutClipBuffers[inOutCurrentBuffer], and its vertex count is returned
+		uint32_t ClipToBoxFaceSides(const SCollisionBody& inBox, const Vector3 inAxes[3], int32_t inFaceAxis, uint32_t inVertexCount, Vector3 inOutClipBuffers[2][g_maxClipVertices], uint32_t& inOutCurrentBuffer)
+		{
+			uint32_t vertexCount = inVertexCount;
+
+			for (int32_t sideAxisOffset = 1; sideAxisOffset <= 2 && vertexCount > 0; ++sideAxisOffset)
+			{
+				const int32_t sideAxis = (inFaceAxis + sideAxisOffset) % 3;
+				const Vector3& sideNormal = inAxes[sideAxis];
+				const float sideCenter = sideNormal.Dot(inBox.m_position);
+				const float sideExtent = GetComponent(inBox.m_shape->m_halfExtents, sideAxis);
+
+				vertexCount = ClipPolygon(inOutClipBuffers[inOutCurrentBuffer], vertexCount, sideNormal, sideCenter + sideExtent, inOutClipBuffers[1 - inOutCurrentBuffer]);
+				inOutCurrentBuffer = 1 - inOutCurrentBuffer;
+
+				vertexCount = ClipPolygon(inOutClipBuffers[inOutCurrentBuffer], vertexCount, -sideNormal, -sideCenter + sideExtent, inOutClipBuffers[1 - inOutCurrentBuffer]);
+				inOutCurrentBuffer = 1 - inOutCurrentBuffer;
+			}
+
+			return vertexCount;
+		}
+
+		// Keeps the clipped vertices that are below the reference face inFaceNormal . x = inFaceOffset, moved halfway up to it.
+		// Returns how many there were
+		uint32_t GatherFaceContacts(const Vector3* inClippedVertices, uint32_t inVertexCount, const Vector3& inFaceNormal, float inFaceOffset, Vector3* outPoints, float* outPenetrations)
+		{
+			uint32_t contactCount = 0;
+
+			for (uint32_t i = 0; i < inVertexCount; ++i)
+			{
+				const Vector3& clippedVertex = inClippedVertices[i];
+				const float penetration = inFaceOffset - inFaceNormal.Dot(clippedVertex);
+
+				if (penetration >= 0.0f)
+				{
+					outPoints[contactCount] = clippedVertex + inFaceNormal * (penetration * 0.5f);
+					outPenetrations[contactCount] = penetration;
+					++contactCount;
+				}
+			}
+
+			return contactCount;
+		}
+
+		bool CollideBoxBox(const SCollisionBody& inBoxA, const SCollisionBody& inBoxB, SContactManifold& outManifold)
+		{
+			Vector3 axesA[3], axesB[3];
+			GetAxes(inBoxA.m_rotation, axesA);
+			GetAxes(inBoxB.m_rotation, axesB);
+
+			const Vector3& extentsA = inBoxA.m_shape->m_halfExtents;
+			const Vector3& extentsB = inBoxB.m_shape->m_halfExtents;
+			const Vector3 offset = inBoxB.m_position - inBoxA.m_position;
+
+			float absoluteDots[3][3];
+			for (int32_t i = 0; i < 3; ++i)
+			{
+				for (int32_t j = 0; j < 3; ++j)
+				{
+					// Nudged up so that the edge axes of nearly parallel edges don't report a separation that isn't there
+					absoluteDots[i][j] = fabs(axesA[i].Dot(axesB[j])) + 1e-5f;
+				}
+			}
+
+			// Face axes of A
+			float faceSeparationA = -FLT_MAX;
+			int32_t faceAxisA = 0;
+
+			for (int32_t i = 0; i < 3; ++i)
+			{
+				const float projectedB = extentsB.x * absoluteDots[i][0] + extentsB.y * absoluteDots[i][1] + extentsB.z * absoluteDots[i][2];
+				const float separation = fabs(offset.Dot(axesA[i])) - (GetComponent(extentsA, i) + projectedB);
+
+				if (separation > 0.0f)
+				{
+					return false;
+				}
+
+				if (separation > faceSeparationA)
+				{
+					faceSeparationA = separation;
+					faceAxisA = i;
+				}
+			}
+
+			// Face axes of B
+			float faceSeparationB = -FLT_MAX;
+			int32_t faceAxisB = 0;
+
+			for (int32_t j = 0; j < 3; ++j)
+			{
+				const float projectedA = extentsA.x * absoluteDots[0][j] + extentsA.y * absoluteDots[1][j] + extentsA.z * absoluteDots[2][j];
+				const float separation = fabs(offset.Dot(axesB[j])) - (projectedA + GetComponent(extentsB, j));
+
+				if (separation > 0.0f)
+				{
+					return false;
+				}
+
+				if (separation > faceSeparationB)
+				{
+					faceSeparationB = separation;
+					faceAxisB = j;
+				}
+			}
+
+			// Edge axes
+			float edgeSeparation = -FLT_MAX;
+			int32_t edgeAxisA = 0;
+			int32_t edgeAxisB = 0;
+			Vector3 edgeNormal;
+
+			for (int32_t i = 0; i < 3; ++i)
+			{
+				for (int32_t j = 0; j < 3; ++j)
+				{
+					Vector3 axis = axesA[i].Cross(axesB[j]);
+					const float axisLength = axis.Length();
+
+					if (axisLength < 1e-4f)
+					{
+						continue;
+					}
+
+					axis /= axisLength;
+
+					const float projectedA = extentsA.x * fabs(axesA[0].Dot(axis)) + extentsA.y * fabs(axesA[1].Dot(axis)) + extentsA.z * fabs(axesA[2].Dot(axis));
+					const float projectedB = extentsB.x * fabs(axesB[0].Dot(axis)) + extentsB.y * fabs(axesB[1].Dot(axis)) + extentsB.z * fabs(axesB[2].Dot(axis));
+					const float separation = fabs(offset.Dot(axis)) - (projectedA + projectedB);
+
+					if (separation > 0.0f)
+					{
+						return false;
+					}
+
+					if (separation > edgeSeparation)
+					{
+						edgeSeparation = separation;
+						edgeAxisA = i;
+						edgeAxisB = j;
+						edgeNormal = offset.Dot(axis) >= 0.0f ? axis : -axis;
+					}
+				}
+			}
+
+			const bool isReferenceA = faceSeparationB <= g_edgeRelativeTolerance * faceSeparationA + g_edgeAbsoluteTolerance;
+			const float faceSeparation = isReferenceA ? faceSeparationA : faceSeparationB;
+
+			if (edgeSeparation > g_edgeRelativeTolerance * faceSeparation + g_edgeAbsoluteTolerance)
+			{
+				// Edge against edge, a single contact between the closest points of the two edges
+				Vector3 edgeCenterA = inBoxA.m_position;
+				Vector3 edgeCenterB = inBoxB.m_position;
+
+				for (int32_t k = 0; k < 3; ++k)
+				{
+					if (k != edgeAxisA)
+					{
+						edgeCenterA += axesA[k] * (GetComponent(extentsA, k) * (axesA[k].Dot(edgeNormal) >= 0.0f ? 1.0f : -1.0f));
+					}
+
+					if (k != edgeAxisB)
+					{
+						edgeCenterB += axesB[k] * (GetComponent(extentsB, k) * (axesB[k].Dot(edgeNormal) >= 0.0f ? -1.0f : 1.0f));
+					}
+				}
+
+				const Vector3 edgeHalfA = axesA[edgeAxisA] * GetComponent(extentsA, edgeAxisA);
+				const Vector3 edgeHalfB = axesB[edgeAxisB] * GetComponent(extentsB, edgeAxisB);
+
+				Vector3 closestA, closestB;
+				ClosestPointsBetweenSegments(edgeCenterA - edgeHalfA, edgeCenterA + edgeHalfA, edgeCenterB - edgeHalfB, edgeCenterB + edgeHalfB, closestA, closestB);
+
+				outManifold.m_normal = edgeNormal;
+				AddContact(outManifold, (closestA + closestB) * 0.5f, -edgeSeparation);
+				return true;
+			}
+
+			// Face contact, clip the incident face against the sides of the reference face
+			const SCollisionBody& referenceBox = isReferenceA ? inBoxA : inBoxB;
+			const SCollisionBody& incidentBox = isReferenceA ? inBoxB : inBoxA;
+			const Vector3* referenceAxes = isReferenceA ? axesA : axesB;
+			const Vector3* incidentAxes = isReferenceA ? axesB : axesA;
+			const Vector3& referenceExtents = referenceBox.m_shape->m_halfExtents;
+			const int32_t referenceAxis = isReferenceA ? faceAxisA : faceAxisB;
+
+			// From the reference box toward the incident box
+			const Vector3 referenceToIncident = incidentBox.m_position - referenceBox.m_position;
+			const Vector3 faceNormal = referenceToIncident.Dot(referenceAxes[referenceAxis]) >= 0.0f ? referenceAxes[referenceAxis] : -referenceAxes[referenceAxis];
+
+			Vector3 clipBuffers[2][g_maxClipVertices];
+			GetIncidentFace(incidentBox, incidentAxes, faceNormal, clipBuffers[0]);
+
+			uint32_t currentBuffer = 0;
+			const uint32_t vertexCount = ClipToBoxFaceSides(referenceBox, referenceAxes, referenceAxis, 4, clipBuffers, currentBuffer);
+
+			// Only the clipped points below the reference face are touching
+			const float faceOffset = faceNormal.Dot(referenceBox.m_position) + GetComponent(referenceExtents, referenceAxis);
+
+			Vector3 contactPoints[g_maxClipVertices];
+			float contactPenetrations[g_maxClipVertices];
+			const uint32_t contactCount = GatherFaceContacts(clipBuffers[currentBuffer], vertexCount, faceNormal, faceOffset, contactPoints, contactPenetrations);
+
+			if (contactCount == 0)
+			{
+				return false;
+			}
+
+			outManifold.m_normal = isReferenceA ? faceNormal : -faceNormal;
+			ReduceContacts(contactPoints, contactPenetrations, contactCount, faceNormal, outManifold);
+			return true;
+		}
+
+		// Closest point of the triangle to inPoint, from Real-Time Collision Detection 5.1.5
+		Vector3 ClosestPointOnTriangle(const Vector3& inPoint, const Vector3 inTriangle[3])
+		{
+			const Vector3 edgeAB = inTriangle[1] - inTriangle[0];
+			const Vector3 edgeAC = inTriangle[2] - inTriangle[0];
+
+			const Vector3 offsetA = inPoint - inTriangle[0];
+			const float projectionAB_A = edgeAB.Dot(offsetA);
+			const float projectionAC_A = edgeAC.Dot(offsetA);
+			if (projectionAB_A <= 0.0f && projectionAC_A <= 0.0f)
+			{
+				return inTriangle[0];
+			}
+
+			const Vector3 offsetB = inPoint - inTriangle[1];
+			const float projectionAB_B = edgeAB.Dot(offsetB);
+			const float projectionAC_B = edgeAC.Dot(offsetB);
+			if (projectionAB_B >= 0.0f && projectionAC_B <= projectionAB_B)
+			{
+				return inTriangle[1];
+			}
+
+			const float areaC = projectionAB_A * projectionAC_B - projectionAB_B * projectionAC_A;
+			if (areaC <= 0.0f && projectionAB_A >= 0.0f && projectionAB_B <= 0.0f)
+			{
+				return inTriangle[0] + edgeAB * (projectionAB_A / (projectionAB_A - projectionAB_B));
+			}
+
+			const Vector3 offsetC = inPoint - inTriangle[2];
+			const float projectionAB_C = edgeAB.Dot(offsetC);
+			const float projectionAC_C = edgeAC.Dot(offsetC);
+			if (projectionAC_C >= 0.0f && projectionAB_C <= projectionAC_C)
+			{
+				return inTriangle[2];
+			}
+
+			const float areaB = projectionAB_C * projectionAC_A - projectionAB_A * projectionAC_C;
+			if (areaB <= 0.0f && projectionAC_A >= 0.0f && projectionAC_C <= 0.0f)
+			{
+				return inTriangle[0] + edgeAC * (projectionAC_A / (projectionAC_A - projectionAC_C));
+			}
+
+			const float areaA = projectionAB_B * projectionAC_C - projectionAB_C * projectionAC_B;
+			if (areaA <= 0.0f && projectionAC_B - projectionAB_B >= 0.0f && projectionAB_C - projectionAC_C >= 0.0f)
+			{
+				const float edgeFraction = (projectionAC_B - projectionAB_B) / ((projectionAC_B - projectionAB_B) + (projectionAB_C - projectionAC_C));
+				return inTriangle[1] + (inTriangle[2] - inTriangle[1]) * edgeFraction;
+			}
+
+			const float inverseArea = 1.0f / (areaA + areaB + areaC);
+			return inTriangle[0] + edgeAB * (areaB * inverseArea) + edgeAC * (areaC * inverseArea);
+		}
+
+		// Normal from the triangle to the sphere
+		bool CollideTriangleSphere(const Vector3 inTriangle[3], const Vector3& inSphereCenter, float inSphereRadius, SContactManifold& inOutManifold)
+		{
+			const Vector3 trianglePoint = ClosestPointOnTriangle(inSphereCenter, inTriangle);
+			const Vector3 offset = inSphereCenter - trianglePoint;
+			const float distanceSquared = offset.LengthSquared();
+
+			if (distanceSquared > inSphereRadius * inSphereRadius)
+			{
+				return false;
+			}
+
+			const float distance = sqrtf(distanceSquared);
+			Vector3 normal;
+
+			if (distance > 1e-4f)
+			{
+				normal = offset / distance;
+			}
+			else
+			{
+				// The center is on the triangle, push it out along the face
+				normal = (inTriangle[1] - inTriangle[0]).Cross(inTriangle[2] - inTriangle[0]);
+				normal.Normalize();
+			}
+
+			if (inOutManifold.m_pointCount == 0)
+			{
+				inOutManifold.m_normal = normal;
+			}
+
+			AddContact(inOutManifold, (trianglePoint + inSphereCenter - normal * inSphereRadius) * 0.5f, inSphereRadius - distance);
+			return true;
+		}
+
+		// Normal from the triangle to the capsule
+		bool CollideTriangleCapsule(const Vector3 inTriangle[3], const SCollisionBody& inCapsule, SContactManifold& outManifold)
+		{
+			Vector3 segmentStart, segmentEnd;
+			GetCapsuleSegment(inCapsule, segmentStart, segmentEnd);
+
+			const float radius = inCapsule.m_shape->m_radius;
+
+			// A capsule lying on a triangle touches it with both caps
+			SContactManifold endContacts[2];
+			endContacts[0].m_pointCount = 0;
+			endContacts[1].m_pointCount = 0;
+
+			const bool hasStartContact = CollideTriangleSphere(inTriangle, segmentStart, radius, endContacts[0]);
+			const bool hasEndContact = CollideTriangleSphere(inTriangle, segmentEnd, radius, endContacts[1]);
+
+			if (!hasStartContact && !hasEndContact)
+			{
+				// Otherwise find the point of the segment closest to the triangle by bouncing between the two
+				Vector3 segmentPoint = ClosestPointOnSegment((inTriangle[0] + inTriangle[1] + inTriangle[2]) / 3.0f, segmentStart, segmentEnd);
+
+				for (int32_t i = 0; i < 4; ++i)
+				{
+					segmentPoint = ClosestPointOnSegment(ClosestPointOnTriangle(segmentPoint, inTriangle), segmentStart, segmentEnd);
+				}
+
+				return CollideTriangleSphere(inTriangle, segmentPoint, radius, outManifold);
+			}
+
+			AddCapsuleEndContacts(endContacts, outManifold);
+			return true;
+		}
+
+		// Separation of the triangle and the box along inAxis, negative when they overlap. outNormal is inAxis or its
+		// opposite, whichever pushes the box away from the triangle the least far
+		float GetTriangleBoxSeparation(const Vector3 inTriangle[3], const SCollisionBody& inBox, const Vector3 inBoxAxes[3], const Vector3& inAxis, Vector3& outNormal)
+		{
+			const Vector3& extents = inBox.m_shape->m_halfExtents;
+			const float boxRadius = extents.x * fabs(inBoxAxes[0].Dot(inAxis)) + extents.y * fabs(inBoxAxes[1].Dot(inAxis)) + extents.z * fabs(inBoxAxes[2].Dot(inAxis));
+
+			float triangleMin = FLT_MAX;
+			float triangleMax = -FLT_MAX;
+
+			for (int32_t i = 0; i < 3; ++i)
+			{
+				const float projection = inAxis.Dot(inTriangle[i] - inBox.m_position);
+				triangleMin = fminf(triangleMin, projection);
+				triangleMax = fmaxf(triangleMax, projection);
+			}
+
+			const float separationAlongAxis = triangleMin - boxRadius;
+			const float separationAgainstAxis = -boxRadius - triangleMax;
+
+			if (separationAlongAxis > separationAgainstAxis)
+			{
+				outNormal = -inAxis;
+				return separationAlongAxis;
+			}
+
+			outNormal = inAxis;
+			return separationAgainstAxis;
+		}
+
+		// Same separating axis test as box against box, with the triangle's face and edges standing in for the other box's.
+		// Normal from the triangle to the box
+		bool CollideTriangleBox(const Vector3 inTriangle[3], const SCollisionBody& inBox, SContactManifold& outManifold)
+		{
+			Vector3 boxAxes[3];
+			GetAxes(inBox.m_rotation, boxAxes);
+
+			const Vector3 triangleEdges[3] = { inTriangle[1] - inTriangle[0], inTriangle[2] - inTriangle[1], inTriangle[0] - inTriangle[2] };
+
+			Vector3 triangleNormal = triangleEdges[0].Cross(-triangleEdges[2]);
+			const float triangleNormalLength = triangleNormal.Length();
+
+			if (triangleNormalLength < 1e-8f)
+			{
+				return false;
+			}
+
+			triangleNormal /= triangleNormalLength;
+
+			// Face axis of the triangle
+			Vector3 triangleFaceNormal;
+			const float triangleFaceSeparation = GetTriangleBoxSeparation(inTriangle, inBox, boxAxes, triangleNormal, triangleFaceNormal);
+
+			if (triangleFaceSeparation > 0.0f)
+			{
+				return false;
+			}
+
+			// Face axes of the box
+			float boxFaceSeparation = -FLT_MAX;
+			int32_t boxFaceAxis = 0;
+			Vector3 boxFaceNormal;
+
+			for (int32_t i = 0; i < 3; ++i)
+			{
+				Vector3 axisNormal;
+				const float separation = GetTriangleBoxSeparation(inTriangle, inBox, boxAxes, boxAxes[i], axisNormal);
+
+				if (separation > 0.0f)
+				{
+					return false;
+				}
+
+				if (separation > boxFaceSeparation)
+				{
+					boxFaceSeparation = separation;
+					boxFaceAxis = i;
+					boxFaceNormal = axisNormal;
+				}
+			}
+
+			// Edge axes
+			float edgeSeparation = -FLT_MAX;
+			int32_t edgeAxisBox = 0;
+			int32_t edgeIndexTriangle = 0;
+			Vector3 edgeNormal;
+
+			for (int32_t i = 0; i < 3; ++i)
+			{
+				for (int32_t j = 0; j < 3; ++j)
+				{
+					Vector3 axis = boxAxes[i].Cross(triangleEdges[j]);
+					const float axisLength = axis.Length();
+
+					if (axisLength < 1e-4f * triangleEdges[j].Length())
+					{
+						continue;
+					}
+
+					axis /= axisLength;
+
+					Vector3 axisNormal;
+					const float separation = GetTriangleBoxSeparation(inTriangle, inBox, boxAxes, axis, axisNormal);
+
+					if (separation > 0.0f)
+					{
+						return false;
+					}
+
+					if (separation > edgeSeparation)
+					{
+						edgeSeparation = separation;
+						edgeAxisBox = i;
+						edgeIndexTriangle = j;
+						edgeNormal = axisNormal;
+					}
+				}
+			}
+
+			// Triangle faces win ties, so that boxes sliding over a flat mesh don't catch on the edges between its triangles
+			const bool isReferenceTriangle = boxFaceSeparation <= g_edgeRelativeTolerance * triangleFaceSeparation + g_edgeAbsoluteTolerance;
+			const float faceSeparation = isReferenceTriangle ? triangleFaceSeparation : boxFaceSeparation;
+
+			if (edgeSeparation > g_edgeRelativeTolerance * faceSeparation + g_edgeAbsoluteTolerance)
+			{
+				// Edge against edge, with the box's edge on the side facing the triangle
+				Vector3 boxEdgeCenter = inBox.m_position;
+
+				for (int32_t k = 0; k < 3; ++k)
+				{
+					if (k != edgeAxisBox)
+					{
+						boxEdgeCenter += boxAxes[k] * (GetComponent(inBox.m_shape->m_halfExtents, k) * (boxAxes[k].Dot(edgeNormal) >= 0.0f ? -1.0f : 1.0f));
+					}
+				}
+
+				const Vector3 boxEdgeHalf = boxAxes[edgeAxisBox] * GetComponent(inBox.m_shape->m_halfExtents, edgeAxisBox);
+
+				Vector3 closestTriangle, closestBox;
+				ClosestPointsBetweenSegments(inTriangle[edgeIndexTriangle], inTriangle[(edgeIndexTriangle + 1) % 3], boxEdgeCenter - boxEdgeHalf, boxEdgeCenter + boxEdgeHalf, closestTriangle, closestBox);
+
+				outManifold.m_normal = edgeNormal;
+				AddContact(outManifold, (closestTriangle + closestBox) * 0.5f, -edgeSeparation);
+				return true;
+			}
+
+			Vector3 clipBuffers[2][g_maxClipVertices];
+			uint32_t currentBuffer = 0;
+			uint32_t vertexCount;
+			Vector3 faceNormal;
+			float faceOffset;
+
+			if (isReferenceTriangle)
+			{
+				// Clip the box's incident face against the triangle's sides
+				faceNormal = triangleFaceNormal;
+				faceOffset = faceNormal.Dot(inTriangle[0]);
+
+				GetIncidentFace(inBox, boxAxes, faceNormal, clipBuffers[0]);
+				vertexCount = 4;
+
+				for (int32_t j = 0; j < 3 && vertexCount > 0; ++j)
+				{
+					Vector3 sideNormal = triangleEdges[j].Cross(triangleNormal);
+					sideNormal.Normalize();
+
+					vertexCount = ClipPolygon(clipBuffers[currentBuffer], vertexCount, sideNormal, sideNormal.Dot(inTriangle[j]), clipBuffers[1 - currentBuffer]);
+					currentBuffer = 1 - currentBuffer;
+				}
+			}
+			else
+			{
+				// Clip the triangle against the sides of the box's face, which faces the triangle
+				faceNormal = -boxFaceNormal;
+				faceOffset = faceNormal.Dot(inBox.m_position) + GetComponent(inBox.m_shape->m_halfExtents, boxFaceAxis);
+
+				clipBuffers[0][0] = inTriangle[0];
+				clipBuffers[0][1] = inTriangle[1];
+				clipBuffers[0][2] = inTriangle[2];
+
+				vertexCount = ClipToBoxFaceSides(inBox, boxAxes, boxFaceAxis, 3, clipBuffers, currentBuffer);
+			}
+
+			Vector3 contactPoints[g_maxClipVertices];
+			float contactPenetrations[g_maxClipVertices];
+			const uint32_t contactCount = GatherFaceContacts(clipBuffers[currentBuffer], vertexCount, faceNormal, faceOffset, contactPoints, contactPenetrations);
+
+			if (contactCount == 0)
+			{
+				return false;
+			}
+
+			outManifold.m_normal = isReferenceTriangle ? faceNormal : -faceNormal;
+			ReduceContacts(contactPoints, contactPenetrations, contactCount, faceNormal, outManifold);
+			return true;
+		}
+
+		/*
+			Collides the shape with every triangle of the mesh near it. A manifold only has one normal, so only the contacts
+			that roughly agree with the deepest one are kept, and the rest wait until the deepest is resolved. A body wedged
+			between a floor and a wall only sees one of them per tick.
+		*/
+		bool CollideShapeMesh(const SCollisionBody& inShape, const SCollisionBody& inMesh, SContactManifold& outManifold)
+		{
+			const SPhysicsShape& meshShape = *inMesh.m_shape;
+			const UCollisionMesh& collisionMesh = *meshShape.m_collisionMesh;
+			const float meshScale = meshShape.m_meshScale;
+			const Quaternion inverseMeshRotation(-inMesh.m_rotation.x, -inMesh.m_rotation.y, -inMesh.m_rotation.z, inMesh.m_rotation.w);
+
+			// The shape's world bounds taken into the mesh's object space, as the bounds of a box
+			const SAABB shapeBounds = inShape.m_shape->ComputeBounds(inShape.m_position, inShape.m_rotation);
+
+			SPhysicsShape localBoundsBox;
+			localBoundsBox.m_type = EPhysicsShapeType::Box;
+			localBoundsBox.m_halfExtents = (shapeBounds.m_max - shapeBounds.m_min) * (0.5f / meshScale);
+
+			const Vector3 localCenter = InverseRotateVector((shapeBounds.m_min + shapeBounds.m_max) * 0.5f - inMesh.m_position, inMesh.m_rotation) / meshScale;
+			const SAABB localBounds = localBoundsBox.ComputeBounds(localCenter, inverseMeshRotation);
+
+			eastl::fixed_vector<STriangleContact, 32> triangleContacts;
+
+			collisionMesh.Query(localBounds, [&](uint32_t inTriangleIndex)
+			{
+				Vector3 triangle[3];
+				collisionMesh.GetTriangle(inTriangleIndex, triangle);
+
+				for (Vector3& currentVertex : triangle)
+				{
+					currentVertex = inMesh.m_position + RotateVector(currentVertex * meshScale, inMesh.m_rotation);
+				}
+
+				SContactManifold triangleManifold;
+				triangleManifold.m_pointCount = 0;
+
+				bool isTouching = false;
+				switch (inShape.m_shape->m_type)
+				{
+				case EPhysicsShapeType::Sphere: isTouching = CollideTriangleSphere(triangle, inShape.m_position, inShape.m_shape->m_radius, triangleManifold); break;
+				case EPhysicsShapeType::Box: isTouching = CollideTriangleBox(triangle, inShape, triangleManifold); break;
+				case EPhysicsShapeType::Capsule: isTouching = CollideTriangleCapsule(triangle, inShape, triangleManifold); break;
+				default: break;
+				}
+
+				for (uint32_t i = 0; isTouching && i < triangleManifold.m_pointCount; ++i)
+				{
+					triangleContacts.push_back({ triangleManifold.m_normal, triangleManifold.m_points[i].m_position, triangleManifold.m_points[i].m_penetration });
+				}
+
+				return true;
+			});
+
+			if (triangleContacts.empty())
+			{
+				return false;
+			}
+
+			const STriangleContact* deepestContact = triangleContacts.data();
+			for (const STriangleContact& currentContact : triangleContacts)
+			{
+				if (currentContact.m_penetration > deepestContact->m_penetration)
+				{
+					deepestContact = &currentContact;
+				}
+			}
+
+			const Vector3 meshNormal = deepestContact->m_normal;
+			eastl::fixed_vector<Vector3, 32> contactPoints;
+			eastl::fixed_vector<float, 32> contactPenetrations;
+
+			for (const STriangleContact& currentContact : triangleContacts)
+			{
+				if (currentContact.m_normal.Dot(meshNormal) > g_minMeshNormalAlignment)
+				{
+					contactPoints.push_back(currentContact.m_position);
+					contactPenetrations.push_back(currentContact.m_penetration);
+				}
+			}
+
+			// The shape is A, so the normal points into the mesh
+			outManifold.m_normal = -meshNormal;
+			ReduceContacts(contactPoints.data(), contactPenetrations.data(), static_cast<uint32_t>(contactPoints.size()), meshNormal, outManifold);
+			return true;
+		}
+	}
+
+	bool UPhysicsNarrowphase::Collide(const SCollisionBody& inBodyA, const SCollisionBody& inBodyB, SContactManifold& outManifold)
+	{
+		outManifold.m_pointCount = 0;
+
+		// Every pair is handled with its lower shape type first, flipping the normal when that swaps the bodies
+		if (inBodyA.m_shape->m_type > inBodyB.m_shape->m_type)
+		{
+			if (!Collide(inBodyB, inBodyA, outManifold))
+			{
+				return false;
+			}
+
+			outManifold.m_normal = -outManifold.m_normal;
+			return true;
+		}
+
+		// Triangle meshes are last, so they're always B. Two meshes never collide, neither of them can move
+		if (inBodyB.m_shape->m_type == EPhysicsShapeType::TriangleMesh)
+		{
+			return inBodyA.m_shape->m_type != EPhysicsShapeType::TriangleMesh && CollideShapeMesh(inBodyA, inBodyB, outManifold);
+		}
+
+		switch (inBodyA.m_shape->m_type)
+		{
+		case EPhysicsShapeType::Sphere:
+			switch (inBodyB.m_shape->m_type)
+			{
+			case EPhysicsShapeType::Sphere: return CollideSphereSphere(inBodyA, inBodyB, outManifold);
+			case EPhysicsShapeType::Box: return CollideSphereBox(inBodyA, inBodyB, outManifold);
+			case EPhysicsShapeType::Capsule: return CollideSphereCapsule(inBodyA, inBodyB, outManifold);
+			default: break;
+			}
+			break;
+		case EPhysicsShapeType::Box:
+			switch (inBodyB.m_shape->m_type)
+			{
+			case EPhysicsShapeType::Box: return CollideBoxBox(inBodyA, inBodyB, outManifold);
+			case EPhysicsShapeType::Capsule: return CollideBoxCapsule(inBodyA, inBodyB, outManifold);
+			default: break;
+			}
+			break;
+		case EPhysicsShapeType::Capsule:
+			return CollideCapsuleCapsule(inBodyA, inBodyB, outManifold);
+		default:
+			break;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,361 @@
+#include "Core/PhysicsShape.h"
+
+#include <cfloat>
+
+#include "Core/CollisionMesh.h"
+
+namespace MAD
+{
+	namespace
+	{
+		// Spheres swept at a grazing angle against a triangle mesh back off from the crossing as if the angle was this steep,
+		// so that the back off stays finite
+		const float g_minMeshSweepAlignment = 0.1f;
+
+		// Each world axis sees the absolute projection of every rotated local axis
+		Vector3 RotateExtents(const Vector3& inHalfExtents, const Quaternion& inRotation)
+		{
+			const Matrix rotation = Matrix::CreateFromQuaternion(inRotation);
+
+			return Vector3(fabs(rotation._11) * inHalfExtents.x + fabs(rotation._21) * inHalfExtents.y + fabs(rotation._31) * inHalfExtents.z,
+						   fabs(rotation._12) * inHalfExtents.x + fabs(rotation._22) * inHalfExtents.y + fabs(rotation._32) * inHalfExtents.z,
+						   fabs(rotation._13) * inHalfExtents.x + fabs(rotation._23) * inHalfExtents.y + fabs(rotation._33) * inHalfExtents.z);
+		}
+
+		// Entry distance of a ray into a sphere. Rays that start inside enter at 0
+		bool RaycastSphere(const Vector3& inCenter, float inRadius, const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance)
+		{
+			const Vector3 centerToOrigin = inOrigin - inCenter;
+			const float originDistanceSquared = centerToOrigin.LengthSquared() - inRadius * inRadius;
+
+			if (originDistanceSquared <= 0.0f)
+			{
+				outDistance = 0.0f;
+				return true;
+			}
+
+			const float projection = centerToOrigin.Dot(inDirection);
+			const float discriminant = projection * projection - originDistanceSquared;
+
+			// Pointing away from the sphere, or passing it by
+			if (projection > 0.0f || discriminant < 0.0f)
+			{
+				return false;
+			}
+
+			outDistance = -projection - sqrtf(discriminant);
+			return outDistance <= inMaxDistance;
+		}
+
+		bool RaycastLocalBox(const Vector3& inHalfExtents, const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance, Vector3& outNormal)
+		{
+			const float halfExtents[3] = { inHalfExtents.x, inHalfExtents.y, inHalfExtents.z };
+			const float origin[3] = { inOrigin.x, inOrigin.y, inOrigin.z };
+			const float direction[3] = { inDirection.x, inDirection.y, inDirection.z };
+
+			float entryDistance = 0.0f;
+			float exitDistance = inMaxDistance;
+			int32_t entryAxis = -1;
+			float entrySign = 0.0f;
+
+			for (int32_t axis = 0; axis < 3; ++axis)
+			{
+				if (fabsf(direction[axis]) < 1e-8f)
+				{
+					// Parallel to this slab, so it has to start inside it
+					if (fabsf(origin[axis]) > halfExtents[axis])
+					{
+						return false;
+					}
+
+					continue;
+				}
+
+				const float inverseDirection = 1.0f / direction[axis];
+				const float nearDistance = (-halfExtents[axis] * (direction[axis] > 0.0f ? 1.0f : -1.0f) - origin[axis]) * inverseDirection;
+				const float farDistance = (halfExtents[axis] * (direction[axis] > 0.0f ? 1.0f : -1.0f) - origin[axis]) * inverseDirection;
+
+				if (nearDistance > entryDistance)
+				{
+					entryDistance = nearDistance;
+					entryAxis = axis;
+					entrySign = direction[axis] > 0.0f ? -1.0f : 1.0f;
+				}
+
+				exitDistance = fminf(exitDistance, farDistance);
+
+				if (entryDistance > exitDistance)
+				{
+					return false;
+				}
+			}
+
+			outDistance = entryDistance;
+
+			if (entryAxis < 0)
+			{
+				outNormal = -inDirection;
+			}
+			else
+			{
+				float normal[3] = { 0.0f, 0.0f, 0.0f };
+				normal[entryAxis] = entrySign;
+				outNormal = Vector3(normal[0], normal[1], normal[2]);
+			}
+
+			return true;
+		}
+
+		bool RaycastLocalCapsule(float inRadius, float inHalfHeight, const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance, Vector3& outNormal)
+		{
+			const Vector3 originOnAxis(0.0f, Clamp(inOrigin.y, -inHalfHeight, inHalfHeight), 0.0f);
+			if ((inOrigin - originOnAxis).LengthSquared() <= inRadius * inRadius)
+			{
+				outDistance = 0.0f;
+				outNormal = -inDirection;
+				return true;
+			}
+
+			float closestDistance = FLT_MAX;
+
+			// The cylinder around the axis, only between the caps
+			const float radialDirectionSquared = inDirection.x * inDirection.x + inDirection.z * inDirection.z;
+			if (radialDirectionSquared > 1e-8f)
+			{
+				const float radialProjection = inOrigin.x * inDirection.x + inOrigin.z * inDirection.z;
+				const float radialOriginDistance = inOrigin.x * inOrigin.x + inOrigin.z * inOrigin.z - inRadius * inRadius;
+				const float discriminant = radialProjection * radialProjection - radialDirectionSquared * radialOriginDistance;
+
+				if (discriminant >= 0.0f)
+				{
+					const float cylinderDistance = (-radialProjection - sqrtf(discriminant)) / radialDirectionSquared;
+					const Vector3 cylinderPoint = inOrigin + inDirection * cylinderDistance;
+
+					if (cylinderDistance >= 0.0f && cylinderDistance <= inMaxDistance && fabsf(cylinderPoint.y) <= inHalfHeight)
+					{
+						closestDistance = cylinderDistance;
+						outNormal = Vector3(cylinderPoint.x, 0.0f, cylinderPoint.z) / inRadius;
+					}
+				}
+			}
+
+			const float capOffsets[2] = { -inHalfHeight, inHalfHeight };
+
+			for (const float capOffset : capOffsets)
+			{
+				const Vector3 capCenter(0.0f, capOffset, 0.0f);
+				float capDistance;
+
+				if (RaycastSphere(capCenter, inRadius, inOrigin, inDirection, inMaxDistance, capDistance) && capDistance < closestDistance)
+				{
+					closestDistance = capDistance;
+					outNormal = (inOrigin + inDirection * capDistance - capCenter) / inRadius;
+				}
+			}
+
+			outDistance = closestDistance;
+			return closestDistance <= inMaxDistance;
+		}
+	}
+
+	SPhysicsShape SPhysicsShape::Scaled(float inScale) const
+	{
+		SPhysicsShape scaledShape = *this;
+		scaledShape.m_halfExtents *= inScale;
+		scaledShape.m_radius *= inScale;
+		scaledShape.m_halfHeight *= inScale;
+		scaledShape.m_meshScale *= inScale;
+
+		return scaledShape;
+	}
+
+	SAABB SPhysicsShape::ComputeBounds(const Vector3& inPosition, const Quaternion& inRotation) const
+	{
+		Vector3 worldCenter = inPosition;
+		Vector3 worldExtents;
+
+		switch (m_type)
+		{
+		case EPhysicsShapeType::Sphere:
+			worldExtents = Vector3(m_radius, m_radius, m_radius);
+			break;
+		case EPhysicsShapeType::Box:
+			worldExtents = RotateExtents(m_halfExtents, inRotation);
+			break;
+		case EPhysicsShapeType::Capsule:
+		{
+			const Vector3 axis = Vector3::Transform(Vector3::Up, inRotation) * m_halfHeight;
+			worldExtents = Vector3(fabs(axis.x) + m_radius, fabs(axis.y) + m_radius, fabs(axis.z) + m_radius);
+			break;
+		}
+		case EPhysicsShapeType::TriangleMesh:
+		{
+			// The mesh's own bounds need not be centered on the body
+			const SAABB meshBounds = m_collisionMesh->GetBounds();
+			worldCenter += Vector3::Transform((meshBounds.m_min + meshBounds.m_max) * (0.5f * m_meshScale), inRotation);
+			worldExtents = RotateExtents((meshBounds.m_max - meshBounds.m_min) * (0.5f * m_meshScale), inRotation);
+			break;
+		}
+		}
+
+		return SAABB(worldCenter - worldExtents, worldCenter + worldExtents);
+	}
+
+	Vector3 SPhysicsShape::ComputeLocalInverseInertia(float inMass) const
+	{
+		if (inMass <= 0.0f || m_type == EPhysicsShapeType::TriangleMesh)
+		{
+			return Vector3::Zero;
+		}
+
+		Vector3 inertia;
+
+		switch (m_type)
+		{
+		case EPhysicsShapeType::Sphere:
+		{
+			const float sphereInertia = 0.4f * inMass * m_radius * m_radius;
+			inertia = Vector3(sphereInertia, sphereInertia, sphereInertia);
+			break;
+		}
+		case EPhysicsShapeType::Box:
+		{
+			const Vector3 size = m_halfExtents * 2.0f;
+			const float boxFactor = inMass / 12.0f;
+			inertia = Vector3(boxFactor * (size.y * size.y + size.z * size.z), boxFactor * (size.x * size.x + size.z * size.z), boxFactor * (size.x * size.x + size.y * size.y));
+			break;
+		}
+		case EPhysicsShapeType::Capsule:
+		{
+			// Treated as a cylinder of the full length, close enough for the solver and much simpler than the exact tensor
+			const float length = 2.0f * (m_halfHeight + m_radius);
+			const float radiusSquared = m_radius * m_radius;
+			const float sideInertia = inMass * (3.0f * radiusSquared + length * length) / 12.0f;
+			inertia = Vector3(sideInertia, 0.5f * inMass * radiusSquared, sideInertia);
+			break;
+		}
+		}
+
+		return Vector3(1.0f / inertia.x, 1.0f / inertia.y, 1.0f / inertia.z);
+	}
+
+	bool SPhysicsShape::ParseShapeType(const eastl::string& inShapeName, EPhysicsShapeType& outShapeType)
+	{
+		if (inShapeName == "sphere")
+		{
+			outShapeType = EPhysicsShapeType::Sphere;
+		}
+		else if (inShapeName == "box")
+		{
+			outShapeType = EPhysicsShapeType::Box;
+		}
+		else if (inShapeName == "capsule")
+		{
+			outShapeType = EPhysicsShapeType::Capsule;
+		}
+		else if (inShapeName == "mesh")
+		{
+			outShapeType = EPhysicsShapeType::TriangleMesh;
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool SPhysicsShape::Raycast(const Vector3& inPosition, const Quaternion& inRotation, const Vector3& inOrigin, const Vector3& inDirection, float inMaxDistance, float& outDistance, Vector3& outNormal) const
+	{
+		if (m_type == EPhysicsShapeType::Sphere)
+		{
+			if (!RaycastSphere(inPosition, m_radius, inOrigin, inDirection, inMaxDistance, outDistance))
+			{
+				return false;
+			}
+
+			outNormal = outDistance > 0.0f ? (inOrigin + inDirection * outDistance - inPosition) / m_radius : -inDirection;
+			return true;
+		}
+
+		// Everything else is hit in its local space, where boxes and capsules are axis aligned
+		const Quaternion inverseRotation(-inRotation.x, -inRotation.y, -inRotation.z, inRotation.w);
+		const Vector3 localOrigin = Vector3::Transform(inOrigin - inPosition, inverseRotation);
+		const Vector3 localDirection = Vector3::Transform(inDirection, inverseRotation);
+
+		Vector3 localNormal;
+		bool isHit;
+
+		if (m_type == EPhysicsShapeType::TriangleMesh)
+		{
+			// The mesh's vertices are unscaled, so the ray is scaled down into its object space instead
+			isHit = m_collisionMesh->Raycast(localOrigin / m_meshScale, localDirection, inMaxDistance / m_meshScale, outDistance, localNormal);
+			outDistance *= m_meshScale;
+		}
+		else if (m_type == EPhysicsShapeType::Box)
+		{
+			isHit = RaycastLocalBox(m_halfExtents, localOrigin, localDirection, inMaxDistance, outDistance, localNormal);
+		}
+		else
+		{
+			isHit = RaycastLocalCapsule(m_radius, m_halfHeight, localOrigin, localDirection, inMaxDistance, outDistance, localNormal);
+		}
+
+		if (isHit)
+		{
+			outNormal = Vector3::Transform(localNormal, inRotation);
+		}
+
+		return isHit;
+	}
+
+	float SPhysicsShape::GetInnerRadius() const
+	{
+		switch (m_type)
+		{
+		case EPhysicsShapeType::Box:
+			return fminf(m_halfExtents.x, fminf(m_halfExtents.y, m_halfExtents.z));
+		case EPhysicsShapeType::TriangleMesh:
+			return 0.0f;
+		case EPhysicsShapeType::Sphere:
+		case EPhysicsShapeType::Capsule:
+		default:
+			return m_radius;
+		}
+	}
+
+	SPhysicsShape SPhysicsShape::Inflated(float inRadius) const
+	{
+		if (m_type == EPhysicsShapeType::TriangleMesh)
+		{
+			return *this;
+		}
+
+		SPhysicsShape inflatedShape = *this;
+		inflatedShape.m_halfExtents += Vector3(inRadius, inRadius, inRadius);
+		inflatedShape.m_radius += inRadius;
+
+		return inflatedShape;
+	}
+
+	bool SPhysicsShape::SweepSphere(const Vector3& inPosition, const Quaternion& inRotation, const Vector3& inOrigin, const Vector3& inDirection, float inRadius, float inMaxDistance, float& outDistance, Vector3& outNormal) const
+	{
+		if (m_type != EPhysicsShapeType::TriangleMesh)
+		{
+			return Inflated(inRadius).Raycast(inPosition, inRotation, inOrigin, inDirection, inMaxDistance, outDistance, outNormal);
+		}
+
+		// The sphere touches the triangle's plane before its center crosses it, further back along the ray the more the ray
+		// grazes the plane. The ray goes further than the sweep to find the triangles the sphere touches before it ends
+		float crossingDistance;
+		if (!Raycast(inPosition, inRotation, inOrigin, inDirection, inMaxDistance + inRadius / g_minMeshSweepAlignment, crossingDistance, outNormal))
+		{
+			return false;
+		}
+
+		const float backOffDistance = inRadius / fmaxf(-outNormal.Dot(inDirection), g_minMeshSweepAlignment);
+		outDistance = fmaxf(crossingDistance - backOffDistance, 0.0f);
+
+		return outDistance <= inMaxDistance;
+	}
+}
@@ -1,19 +1,1003 @@
 #include "Core/PhysicsWorld.h"
 #include "Core/PhysicsComponent.h"
+#include "Core/SimulationChecksum.h"
+#include "Misc/JobSystem.h"
 #include "Misc/Logging.h"
+#include "Misc/Remotery.h"
 
 #include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
 
 namespace MAD
 {
 	DECLARE_LOG_CATEGORY(LogPhysicsWorld);
 
+	namespace
+	{
+		// How far a body can move before its broadphase proxy has to be reinserted
+		const float g_broadphaseMargin = 10.0f;
+
+		// Below this many dirty proxies, handing the queries to the job system costs more than it saves
+		const uint32_t g_dirtyProxiesPerJob = 128;
+
+		// Same for the pairs handed to the narrowphase
+		const uint32_t g_pairsPerJob = 256;
+
+		// Contacts this close to a contact of the previous tick are treated as the same contact and inherit its impulses
+		const float g_contactMatchDistance = 2.0f;
+
+		// Below this many contacts in awake islands, solving them all on the main thread is cheaper than waking the workers
+		const uint32_t g_manifoldsPerParallelSolve = 64;
+
+		// Kinetic energy per unit mass (cm^2/s^2) under which a body counts as resting. About 4.5 cm/s for a body that only translates
+		const float g_sleepEnergyThreshold = 10.0f;
+
+		// Ticks every body of an island has to stay under the threshold before the island falls asleep
+		const uint32_t g_ticksUntilSleep = 30;
+
+		// World units are centimeters
+		const Vector3 g_defaultGravity(0.0f, -981.0f, 0.0f);
+
+		// Smallest step a sweep takes, so that shapes without an inner radius still make progress
+		const float g_minSweepStep = 1.0f;
+
+		// Sweeps bisect the step they first overlap in this many times, which puts them within 1/4096 of a step of the contact
+		const uint32_t g_sweepBisections = 12;
+
+		// Finds the fraction of inSweep at which the shape first touches inTarget, by stepping until it overlaps and then
+		// bisecting between the last free and the first overlapping fraction. outFraction is the last free fraction
+		bool SweepAgainstBody(const SCollisionBody& inTarget, const SPhysicsShape& inShape, const Quaternion& inRotation, const Vector3& inStart, const Vector3& inSweep, float inStepFraction, float inMaxFraction, float& outFraction, SContactManifold& outManifold)
+		{
+			SContactManifold currentManifold;
+			const auto overlapsAt = [&](float inFraction)
+			{
+				// The target is A, so that the manifold normal points out of it
+				const SCollisionBody movingBody = { &inShape, inStart + inSweep * inFraction, inRotation };
+				return UPhysicsNarrowphase::Collide(inTarget, movingBody, currentManifold);
+			};
+
+			if (overlapsAt(0.0f))
+			{
+				outFraction = 0.0f;
+				outManifold = currentManifold;
+				return true;
+			}
+
+			float freeFraction = 0.0f;
+
+			while (freeFraction < inMaxFraction)
+			{
+				float overlapFraction = eastl::min(freeFraction + inStepFraction, inMaxFraction);
+
+				if (!overlapsAt(overlapFraction))
+				{
+					freeFraction = overlapFraction;
+					continue;
+				}
+
+				outManifold = currentManifold;
+
+				for (uint32_t i = 0; i < g_sweepBisections; ++i)
+				{
+					const float middleFraction = 0.5f * (freeFraction + overlapFraction);
+
+					if (overlapsAt(middleFraction))
+					{
+						overlapFraction = middleFraction;
+						outManifold = currentManifold;
+					}
+					else
+					{
+						freeFraction = middleFraction;
+					}
+				}
+
+				outFraction = freeFraction;
+				return true;
+			}
+
+			return false;
+		}
+
+		Vector3 InverseRotateVector(const Vector3& inVector, const Quaternion& inRotation)
+		{
+			return Vector3::Transform(inVector, Quaternion(-inRotation.x, -inRotation.y, -inRotation.z, inRotation.w));
+		}
+
+		// Spreads inJobCount strided jobs over the job system, or runs the only one inline
+		template <typename JobType>
+		void RunJobs(uint32_t inJobCount, const JobType& inJob)
+		{
+			if (inJobCount > 1)
+			{
+				UJobSystem::ParallelFor(inJobCount, inJob);
+			}
+			else if (inJobCount == 1)
+			{
+				inJob(0);
+			}
+		}
+	}
+
 	UPhysicsWorld::UPhysicsWorld(OGameWorld* inOwningWorld)
-		: Super_t(inOwningWorld) {}
+		: Super_t(inOwningWorld)
+		, m_gravity(g_defaultGravity)
+		, m_nextLoadedOrderKey(0) {}
+
+	void UPhysicsWorld::RegisterPhysicsComponent(PhysicsBodyWeakPtr_t inPhysicsComponent)
+	{
+		eastl::shared_ptr<PhysicsBody_t> physicsComponent = inPhysicsComponent.lock();
+		if (!physicsComponent)
+		{
+			return;
+		}
+
+		MAD_ASSERT_DESC(physicsComponent->m_bodyIndex == InvalidBodyIndex, "Error: Registering a physics component that is already registered");
+
+		const SRigidBodyDescription bodyDescription = physicsComponent->GetBodyDescription();
+		const uint32_t bodyIndex = m_bodies.AddBody(bodyDescription);
+
+		SPhysicsBodyProxy newProxy;
+		newProxy.m_body = inPhysicsComponent;
+		newProxy.m_proxyID = m_broadphase.CreateProxy(bodyDescription.m_shape.ComputeBounds(bodyDescription.m_position, bodyDescription.m_rotation), g_broadphaseMargin, bodyIndex);
+		newProxy.m_lastTranslation = bodyDescription.m_position;
+		newProxy.m_lastRotation = bodyDescription.m_rotation;
+		newProxy.m_queryLayer = physicsComponent->GetQueryLayer();
+
+		if (static_cast<uint32_t>(newProxy.m_proxyID) >= m_proxyOrderKeys.size())
+		{
+			m_proxyOrderKeys.resize(newProxy.m_proxyID + 1);
+		}
+
+		m_proxyOrderKeys[newProxy.m_proxyID] = GetOrderKey(*physicsComponent);
+
+		m_physicsComponents.push_back(newProxy);
+		physicsComponent->m_bodyIndex = bodyIndex;
+
+		MarkProxyDirty(newProxy.m_proxyID);
+	}
+
+	void UPhysicsWorld::SimulatePhysics(float inDeltaTime)
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_Simulate, 0);
+
+		SyncBodies(inDeltaTime);
+
+		m_bodies.IntegrateVelocities(m_gravity, inDeltaTime);
+
+		UpdateBroadphase(inDeltaTime);
+		UpdateOverlapPairs();
+		UpdateContacts();
+		UpdateIslands();
+
+		m_bodies.UpdateWorldInverseInertia();
+
+		SolveIslands(inDeltaTime);
+
+		GatherContinuousBodies(inDeltaTime);
+		m_bodies.IntegratePositions(inDeltaTime);
+		SolveTimesOfImpact();
+
+		WriteBackTransforms();
+	}
+
+	void UPhysicsWorld::SetLinearVelocity(uint32_t inBodyIndex, const Vector3& inLinearVelocity)
+	{
+		if (m_bodies.IsDynamic(inBodyIndex))
+		{
+			m_bodies.WakeUp(inBodyIndex);
+			m_bodies.SetLinearVelocity(inBodyIndex, inLinearVelocity);
+		}
+	}
+
+	void UPhysicsWorld::AddImpulse(uint32_t inBodyIndex, const Vector3& inImpulse)
+	{
+		if (m_bodies.IsDynamic(inBodyIndex))
+		{
+			m_bodies.WakeUp(inBodyIndex);
+			m_bodies.SetLinearVelocity(inBodyIndex, m_bodies.GetLinearVelocity(inBodyIndex) + inImpulse * m_bodies.m_inverseMass[inBodyIndex]);
+		}
+	}
+
+	void UPhysicsWorld::WakeUp(uint32_t inBodyIndex)
+	{
+		if (m_bodies.IsDynamic(inBodyIndex))
+		{
+			m_bodies.WakeUp(inBodyIndex);
+		}
+	}
+
+	bool UPhysicsWorld::Raycast(const SRay& inRay, SQueryHit& outHit, const SQueryFilter& inFilter) const
+	{
+		outHit = SQueryHit();
+		uint32_t hitBody = InvalidBodyIndex;
+
+		m_broadphase.RayCast(inRay.m_origin, inRay.m_direction, inRay.m_maxDistance, [this, &inRay, &inFilter, &outHit, &hitBody](int32_t inProxyID, float inMaxDistance)
+		{
+			return RaycastBody(m_broadphase.GetUserData(inProxyID), inRay, inMaxDistance, inFilter, outHit, hitBody);
+		});
+
+		if (hitBody != InvalidBodyIndex)
+		{
+			outHit.m_body = m_physicsComponents[hitBody].m_body;
+		}
+
+		return outHit.m_hasHit;
+	}
+
+	void UPhysicsWorld::RaycastBatch(const SRay* inRays, uint32_t inRayCount, SQueryHit* outHits, const SQueryFilter& inFilter) const
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_RaycastBatch, 0);
+
+		const uint32_t packetSize = UDynamicAABBTree::RayPacketSize;
+
+		for (uint32_t firstRay = 0; firstRay < inRayCount; firstRay += packetSize)
+		{
+			Vector3 packetOrigins[packetSize];
+			Vector3 packetDirections[packetSize];
+			float packetMaxDistances[packetSize];
+			uint32_t packetHitBodies[packetSize];
+
+			for (uint32_t i = 0; i < packetSize; ++i)
+			{
+				const uint32_t rayIndex = firstRay + i;
+				const bool isPadding = rayIndex >= inRayCount;
+				const SRay& currentRay = inRays[isPadding ? firstRay : rayIndex];
+
+				packetOrigins[i] = currentRay.m_origin;
+				packetDirections[i] = currentRay.m_direction;
+				packetMaxDistances[i] = isPadding ? -1.0f : currentRay.m_maxDistance;
+				packetHitBodies[i] = InvalidBodyIndex;
+
+				if (!isPadding)
+				{
+					outHits[rayIndex] = SQueryHit();
+				}
+			}
+
+			m_broadphase.RayCastPacket(packetOrigins, packetDirections, packetMaxDistances, [this, inRays, outHits, firstRay, &inFilter, &packetHitBodies](uint32_t inPacketRayIndex, int32_t inProxyID, float inMaxDistance)
+			{
+				const uint32_t rayIndex = firstRay + inPacketRayIndex;
+				return RaycastBody(m_broadphase.GetUserData(inProxyID), inRays[rayIndex], inMaxDistance, inFilter, outHits[rayIndex], packetHitBodies[inPacketRayIndex]);
+			});
+
+			for (uint32_t i = 0; i < packetSize && firstRay + i < inRayCount; ++i)
+			{
+				if (packetHitBodies[i] != InvalidBodyIndex)
+				{
+					outHits[firstRay + i].m_body = m_physicsComponents[packetHitBodies[i]].m_body;
+				}
+			}
+		}
+	}
+
+	bool UPhysicsWorld::Sweep(const SPhysicsShape& inShape, const Quaternion& inRotation, const Vector3& inStart, const Vector3& inEnd, SQueryHit& outHit, const SQueryFilter& inFilter) const
+	{
+		outHit = SQueryHit();
+
+		const Vector3 sweep = inEnd - inStart;
+		const float sweepLength = sweep.Length();
+		const float stepFraction = sweepLength > 0.0f ? eastl::max(inShape.GetInnerRadius(), g_minSweepStep) / sweepLength : 1.0f;
+		const SAABB sweptBounds = SAABB::Combine(inShape.ComputeBounds(inStart, inRotation), inShape.ComputeBounds(inEnd, inRotation));
+
+		float closestFraction = 1.0f;
+		uint32_t hitBody = InvalidBodyIndex;
+		SContactManifold hitManifold;
+
+		m_broadphase.Query(sweptBounds, [&](int32_t inProxyID)
+		{
+			const uint32_t bodyIndex = m_broadphase.GetUserData(inProxyID);
+			if (!PassesFilter(bodyIndex, inFilter))
+			{
+				return true;
+			}
+
+			const SCollisionBody targetBody = { &m_bodies.m_shapes[bodyIndex], m_bodies.GetPosition(bodyIndex), m_bodies.GetRotation(bodyIndex) };
+			SContactManifold bodyManifold;
+			float bodyFraction;
+
+			// Only as far as the closest hit so far, anything beyond it can't be closer
+			if (SweepAgainstBody(targetBody, inShape, inRotation, inStart, sweep, stepFraction, closestFraction, bodyFraction, bodyManifold) && (hitBody == InvalidBodyIndex || bodyFraction < closestFraction))
+			{
+				closestFraction = bodyFraction;
+				hitBody = bodyIndex;
+				hitManifold = bodyManifold;
+			}
+
+			return true;
+		});
+
+		if (hitBody == InvalidBodyIndex)
+		{
+			return false;
+		}
+
+		outHit.m_hasHit = true;
+		outHit.m_body = m_physicsComponents[hitBody].m_body;
+		outHit.m_position = hitManifold.m_points[0].m_position;
+		outHit.m_normal = hitManifold.m_normal;
+		outHit.m_distance = closestFraction * sweepLength;
+
+		return true;
+	}
+
+	uint32_t UPhysicsWorld::Overlap(const SPhysicsShape& inShape, const Vector3& inPosition, const Quaternion& inRotation, eastl::vector<SQueryHit>& outHits, const SQueryFilter& inFilter) const
+	{
+		const SCollisionBody queryBody = { &inShape, inPosition, inRotation };
+		uint32_t hitCount = 0;
+
+		m_broadphase.Query(inShape.ComputeBounds(inPosition, inRotation), [&](int32_t inProxyID)
+		{
+			const uint32_t bodyIndex = m_broadphase.GetUserData(inProxyID);
+			if (!PassesFilter(bodyIndex, inFilter))
+			{
+				return true;
+			}
+
+			const SCollisionBody targetBody = { &m_bodies.m_shapes[bodyIndex], m_bodies.GetPosition(bodyIndex), m_bodies.GetRotation(bodyIndex) };
+			SContactManifold overlapManifold;
+
+			if (UPhysicsNarrowphase::Collide(targetBody, queryBody, overlapManifold))
+			{
+				SQueryHit newHit;
+				newHit.m_hasHit = true;
+				newHit.m_body = m_physicsComponents[bodyIndex].m_body;
+				newHit.m_position = overlapManifold.m_points[0].m_position;
+				newHit.m_normal = overlapManifold.m_normal;
+
+				for (uint32_t i = 0; i < overlapManifold.m_pointCount; ++i)
+				{
+					newHit.m_penetration = eastl::max(newHit.m_penetration, overlapManifold.m_points[i].m_penetration);
+				}
+
+				outHits.push_back(newHit);
+				++hitCount;
+			}
+
+			return true;
+		});
+
+		return hitCount;
+	}
+
+	eastl::shared_ptr<UPhysicsWorld::PhysicsBody_t> UPhysicsWorld::GetProxyBody(int32_t inProxyID) const
+	{
+		if (!m_broadphase.IsProxy(inProxyID))
+		{
+			return nullptr;
+		}
+
+		return m_physicsComponents[m_broadphase.GetUserData(inProxyID)].m_body.lock();
+	}
+
+	uint64_t UPhysicsWorld::ComputeSimulationChecksum() const
+	{
+		uint64_t physicsChecksum = 0;
+
+		for (uint32_t i = 0; i < m_bodies.GetBodyCount(); ++i)
+		{
+			USimulationChecksum bodyChecksum;
+			bodyChecksum.Add(m_proxyOrderKeys[m_physicsComponents[i].m_proxyID]);
+			bodyChecksum.Add(m_bodies.GetPosition(i));
+			bodyChecksum.Add(m_bodies.GetRotation(i));
+			bodyChecksum.Add(m_bodies.GetLinearVelocity(i));
+			bodyChecksum.Add(m_bodies.GetAngularVelocity(i));
+			bodyChecksum.Add(m_bodies.IsAwake(i));
+
+			physicsChecksum += bodyChecksum.GetValue();
+		}
+
+		return physicsChecksum;
+	}
+
+	void UPhysicsWorld::SyncBodies(float inDeltaTime)
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_SyncBodies, 0);
+
+		const float inverseDeltaTime = inDeltaTime > 0.0f ? 1.0f / inDeltaTime : 0.0f;
+
+		for (uint32_t i = 0; i < m_physicsComponents.size();)
+		{
+			SPhysicsBodyProxy& currentProxy = m_physicsComponents[i];
+			eastl::shared_ptr<PhysicsBody_t> physicsComponent = currentProxy.m_body.lock();
+
+			if (!physicsComponent || !physicsComponent->IsValid() || !physicsComponent->IsOwnerValid())
+			{
+				// The last body is swapped into this slot, so don't advance
+				RemoveBody(i);
+				continue;
+			}
+
+			const Vector3& componentTranslation = physicsComponent->GetWorldTranslation();
+			const Quaternion& componentRotation = physicsComponent->GetWorldRotation();
+
+			const bool wasMoved = componentTranslation != currentProxy.m_lastTranslation || componentRotation != currentProxy.m_lastRotation;
+
+			if (!m_bodies.IsDynamic(i))
+			{
+				// Kinematic bodies follow their component, and move at the speed it moved so that they push what they hit.
+				// They're awake while they move, so that they wake up the sleeping bodies they run into
+				m_bodies.SetLinearVelocity(i, (componentTranslation - currentProxy.m_lastTranslation) * inverseDeltaTime);
+				m_bodies.SetPosition(i, componentTranslation);
+				m_bodies.SetRotation(i, componentRotation);
+				m_bodies.m_isAwake[i] = wasMoved;
+			}
+			else if (wasMoved)
+			{
+				// Gameplay teleported a dynamic body, it keeps its velocity
+				m_bodies.SetPosition(i, componentTranslation);
+				m_bodies.SetRotation(i, componentRotation);
+				m_bodies.WakeUp(i);
+			}
+
+			currentProxy.m_lastTranslation = componentTranslation;
+			currentProxy.m_lastRotation = componentRotation;
+			++i;
+		}
+	}
+
+	void UPhysicsWorld::UpdateBroadphase(float inDeltaTime)
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_UpdateBroadphase, 0);
+
+		for (uint32_t i = 0; i < m_physicsComponents.size(); ++i)
+		{
+			// Sleeping and resting bodies haven't moved since their proxy was last fitted
+			if (!m_bodies.IsAwake(i))
+			{
+				continue;
+			}
+
+			const SAABB bodyBounds = m_bodies.m_shapes[i].ComputeBounds(m_bodies.GetPosition(i), m_bodies.GetRotation(i));
+			const int32_t proxyID = m_physicsComponents[i].m_proxyID;
+
+			if (m_broadphase.MoveProxy(proxyID, bodyBounds, g_broadphaseMargin, m_bodies.GetLinearVelocity(i) * inDeltaTime))
+			{
+				MarkProxyDirty(proxyID);
+			}
+		}
+	}
+
+	void UPhysicsWorld::UpdateOverlapPairs()
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_UpdateOverlapPairs, 0);
+
+		if (m_dirtyProxies.empty())
+		{
+			return;
+		}
+
+		// Pairs between proxies that didn't move still overlap, their fat boxes haven't changed
+		m_overlapPairs.erase(eastl::remove_if(m_overlapPairs.begin(), m_overlapPairs.end(), [this](const SBroadphasePair& inPair)
+		{
+			return m_isProxyDirty[inPair.m_proxyA] || m_isProxyDirty[inPair.m_proxyB];
+		}), m_overlapPairs.end());
+
+		const uint32_t dirtyProxyCount = static_cast<uint32_t>(m_dirtyProxies.size());
+		const uint32_t jobCount = eastl::min((dirtyProxyCount + g_dirtyProxiesPerJob - 1) / g_dirtyProxiesPerJob, UJobSystem::GetThreadCount());
+
+		m_threadPairs.resize(UJobSystem::GetThreadCount());
+
+		// The tree isn't touched until the next tick, so the queries can run on any thread
+		RunJobs(jobCount, [this, dirtyProxyCount, jobCount](uint32_t inJobIndex)
+		{
+			BroadphasePairContainer_t& outPairs = m_threadPairs[UJobSystem::GetCurrentThreadIndex()];
+
+			for (uint32_t i = inJobIndex; i < dirtyProxyCount; i += jobCount)
+			{
+				const int32_t dirtyProxyID = m_dirtyProxies[i];
 
-	void UPhysicsWorld::SimulatePhysics()
+				// Destroyed proxies only needed their old pairs removed
+				if (!m_broadphase.IsProxy(dirtyProxyID))
+				{
+					continue;
+				}
+
+				m_broadphase.Query(m_broadphase.GetFatBounds(dirtyProxyID), [this, dirtyProxyID, &outPairs](int32_t inOtherProxyID)
+				{
+					// When both proxies are dirty, only the lower one adds the pair
+					if (inOtherProxyID != dirtyProxyID && (!m_isProxyDirty[inOtherProxyID] || dirtyProxyID < inOtherProxyID))
+					{
+						const bool isDirtyFirst = m_proxyOrderKeys[dirtyProxyID] < m_proxyOrderKeys[inOtherProxyID];
+						outPairs.push_back({ isDirtyFirst ? dirtyProxyID : inOtherProxyID, isDirtyFirst ? inOtherProxyID : dirtyProxyID });
+					}
+
+					return true;
+				});
+			}
+		});
+
+		for (auto& currentThreadPairs : m_threadPairs)
+		{
+			m_overlapPairs.insert(m_overlapPairs.end(), currentThreadPairs.begin(), currentThreadPairs.end());
+			currentThreadPairs.clear();
+		}
+
+		eastl::sort(m_overlapPairs.begin(), m_overlapPairs.end(), [this](const SBroadphasePair& inLeft, const SBroadphasePair& inRight)
+		{
+			return IsPairBefore(inLeft, inRight);
+		});
+
+		for (int32_t currentProxyID : m_dirtyProxies)
+		{
+			m_isProxyDirty[currentProxyID] = false;
+		}
+
+		m_dirtyProxies.clear();
+	}
+
+	void UPhysicsWorld::UpdateContacts()
 	{
-		//LOG(LogPhysicsWorld, Log, "================SIMULATING PHYSICS================\n");
+		rmt_ScopedCPUSample(PhysicsWorld_UpdateContacts, 0);
+
+		const uint32_t pairCount = static_cast<uint32_t>(m_overlapPairs.size());
+		const uint32_t jobCount = eastl::min((pairCount + g_pairsPerJob - 1) / g_pairsPerJob, UJobSystem::GetThreadCount());
+
+		m_candidateManifolds.resize(pairCount);
+
+		// Every pair writes its own candidate, so the narrowphase can run on any thread
+		RunJobs(jobCount, [this, pairCount, jobCount](uint32_t inJobIndex)
+		{
+			for (uint32_t i = inJobIndex; i < pairCount; i += jobCount)
+			{
+				const SBroadphasePair& currentPair = m_overlapPairs[i];
+				SContactManifold& candidateManifold = m_candidateManifolds[i];
+
+				candidateManifold.m_pointCount = 0;
+
+				const uint32_t bodyA = m_broadphase.GetUserData(currentPair.m_proxyA);
+				const uint32_t bodyB = m_broadphase.GetUserData(currentPair.m_proxyB);
+
+				// Bodies that aren't dynamic don't respond to contacts, so contacts between them would go unused.
+				// When neither body moved, the contacts of the previous tick are still exact and are reused below
+				if ((!m_bodies.IsDynamic(bodyA) && !m_bodies.IsDynamic(bodyB)) || (!m_bodies.IsAwake(bodyA) && !m_bodies.IsAwake(bodyB)))
+				{
+					continue;
+				}
+
+				const SCollisionBody collisionBodyA = { &m_bodies.m_shapes[bodyA], m_bodies.GetPosition(bodyA), m_bodies.GetRotation(bodyA) };
+				const SCollisionBody collisionBodyB = { &m_bodies.m_shapes[bodyB], m_bodies.GetPosition(bodyB), m_bodies.GetRotation(bodyB) };
+
+				if (!UPhysicsNarrowphase::Collide(collisionBodyA, collisionBodyB, candidateManifold))
+				{
+					continue;
+				}
+
+				candidateManifold.m_proxyA = currentPair.m_proxyA;
+				candidateManifold.m_proxyB = currentPair.m_proxyB;
+				candidateManifold.m_bodyA = bodyA;
+				candidateManifold.m_bodyB = bodyB;
+				candidateManifold.m_friction = sqrtf(m_bodies.m_friction[bodyA] * m_bodies.m_friction[bodyB]);
+				candidateManifold.m_restitution = eastl::max(m_bodies.m_restitution[bodyA], m_bodies.m_restitution[bodyB]);
+
+				for (uint32_t j = 0; j < candidateManifold.m_pointCount; ++j)
+				{
+					SContactPoint& contactPoint = candidateManifold.m_points[j];
+
+					contactPoint.m_localAnchorA = InverseRotateVector(contactPoint.m_position - collisionBodyA.m_position, collisionBodyA.m_rotation);
+					contactPoint.m_localAnchorB = InverseRotateVector(contactPoint.m_position - collisionBodyB.m_position, collisionBodyB.m_rotation);
+					contactPoint.m_normalImpulse = 0.0f;
+					contactPoint.m_tangentImpulse[0] = 0.0f;
+					contactPoint.m_tangentImpulse[1] = 0.0f;
+				}
+			}
+		});
+
+		// Both the candidates and the previous manifolds are in pair order, so matching them up is a single merge
+		m_previousManifolds.swap(m_manifolds);
+		m_manifolds.clear();
+
+		auto previousIter = m_previousManifolds.cbegin();
+
+		for (uint32_t i = 0; i < pairCount; ++i)
+		{
+			const SBroadphasePair& currentPair = m_overlapPairs[i];
+			const SContactManifold& candidateManifold = m_candidateManifolds[i];
+
+			while (previousIter != m_previousManifolds.cend() && IsPairBefore(SBroadphasePair{ previousIter->m_proxyA, previousIter->m_proxyB }, currentPair))
+			{
+				++previousIter;
+			}
+
+			const bool hasPreviousManifold = previousIter != m_previousManifolds.cend() && previousIter->m_proxyA == currentPair.m_proxyA && previousIter->m_proxyB == currentPair.m_proxyB;
+
+			if (candidateManifold.m_pointCount == 0)
+			{
+				const uint32_t bodyA = m_broadphase.GetUserData(currentPair.m_proxyA);
+				const uint32_t bodyB = m_broadphase.GetUserData(currentPair.m_proxyB);
+
+				if (hasPreviousManifold && !m_bodies.IsAwake(bodyA) && !m_bodies.IsAwake(bodyB))
+				{
+					// Body indices can change when other bodies are removed, proxy IDs don't
+					m_manifolds.push_back(*previousIter);
+					m_manifolds.back().m_bodyA = bodyA;
+					m_manifolds.back().m_bodyB = bodyB;
+				}
+
+				continue;
+			}
+
+			m_manifolds.push_back(candidateManifold);
+
+			if (!hasPreviousManifold)
+			{
+				continue;
+			}
+
+			SContactManifold& newManifold = m_manifolds.back();
+
+			for (uint32_t j = 0; j < newManifold.m_pointCount; ++j)
+			{
+				SContactPoint& newPoint = newManifold.m_points[j];
+
+				for (uint32_t k = 0; k < previousIter->m_pointCount; ++k)
+				{
+					const SContactPoint& previousPoint = previousIter->m_points[k];
+
+					if ((previousPoint.m_localAnchorA - newPoint.m_localAnchorA).LengthSquared() < g_contactMatchDistance * g_contactMatchDistance)
+					{
+						newPoint.m_normalImpulse = previousPoint.m_normalImpulse;
+						newPoint.m_tangentImpulse[0] = previousPoint.m_tangentImpulse[0];
+						newPoint.m_tangentImpulse[1] = previousPoint.m_tangentImpulse[1];
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	void UPhysicsWorld::UpdateIslands()
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_UpdateIslands, 0);
+
+		m_islandBuilder.Build(m_bodies, m_manifolds);
+
+		// A sleeping body that was touched by an awake one wakes up together with everything it rests on
+		for (const SPhysicsIsland& currentIsland : m_islandBuilder.GetIslands())
+		{
+			if (!currentIsland.m_isAwake)
+			{
+				continue;
+			}
+
+			const uint32_t* islandBodies = m_islandBuilder.GetIslandBodies(currentIsland);
+
+			for (uint32_t i = 0; i < currentIsland.m_bodyCount; ++i)
+			{
+				if (!m_bodies.IsAwake(islandBodies[i]))
+				{
+					m_bodies.WakeUp(islandBodies[i]);
+				}
+			}
+		}
 	}
 
+	void UPhysicsWorld::SolveIslands(float inDeltaTime)
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_SolveIslands, 0);
+
+		const eastl::vector<SPhysicsIsland>& islands = m_islandBuilder.GetIslands();
+		uint32_t awakeManifoldCount = 0;
+
+		m_awakeIslands.clear();
+
+		for (uint32_t i = 0; i < islands.size(); ++i)
+		{
+			if (islands[i].m_isAwake)
+			{
+				m_awakeIslands.push_back(i);
+				awakeManifoldCount += islands[i].m_manifoldCount;
+			}
+		}
+
+		// Jobs are handed out in order, so starting with the largest islands keeps one big pile from finishing last
+		eastl::sort(m_awakeIslands.begin(), m_awakeIslands.end(), [&islands](uint32_t inLeft, uint32_t inRight)
+		{
+			return islands[inLeft].m_manifoldCount > islands[inRight].m_manifoldCount;
+		});
+
+		m_contactSolvers.resize(UJobSystem::GetThreadCount());
+
+		// Islands share no dynamic body, and the solver only writes the velocities of dynamic bodies
+		auto solveIsland = [this, &islands, inDeltaTime](uint32_t inAwakeIslandIndex)
+		{
+			const SPhysicsIsland& currentIsland = islands[m_awakeIslands[inAwakeIslandIndex]];
+
+			if (currentIsland.m_manifoldCount > 0)
+			{
+				UContactSolver& threadSolver = m_contactSolvers[UJobSystem::GetCurrentThreadIndex()];
+				threadSolver.Solve(m_bodies, m_manifolds, m_islandBuilder.GetIslandManifolds(currentIsland), currentIsland.m_manifoldCount, inDeltaTime);
+			}
+
+			UpdateIslandSleep(currentIsland);
+		};
+
+		const uint32_t awakeIslandCount = static_cast<uint32_t>(m_awakeIslands.size());
+
+		if (awakeIslandCount > 1 && awakeManifoldCount >= g_manifoldsPerParallelSolve)
+		{
+			UJobSystem::ParallelFor(awakeIslandCount, solveIsland);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < awakeIslandCount; ++i)
+			{
+				solveIsland(i);
+			}
+		}
+	}
+
+	void UPhysicsWorld::UpdateIslandSleep(const SPhysicsIsland& inIsland)
+	{
+		const uint32_t* islandBodies = m_islandBuilder.GetIslandBodies(inIsland);
+		uint32_t islandSleepTicks = g_ticksUntilSleep;
+
+		for (uint32_t i = 0; i < inIsland.m_bodyCount; ++i)
+		{
+			const uint32_t bodyIndex = islandBodies[i];
+			uint32_t& bodySleepTicks = m_bodies.m_sleepTicks[bodyIndex];
+
+			bodySleepTicks = m_bodies.GetNormalizedKineticEnergy(bodyIndex) < g_sleepEnergyThreshold ? bodySleepTicks + 1 : 0;
+			islandSleepTicks = eastl::min(islandSleepTicks, bodySleepTicks);
+		}
+
+		// One body still moving keeps its whole island awake, otherwise it would come to rest on a body that can't react to it
+		if (islandSleepTicks < g_ticksUntilSleep)
+		{
+			return;
+		}
+
+		for (uint32_t i = 0; i < inIsland.m_bodyCount; ++i)
+		{
+			m_bodies.PutToSleep(islandBodies[i]);
+		}
+	}
+
+	void UPhysicsWorld::GatherContinuousBodies(float inDeltaTime)
+	{
+		m_continuousBodies.clear();
+
+		for (uint32_t i = 0; i < m_bodies.GetBodyCount(); ++i)
+		{
+			if (!m_bodies.m_isContinuous[i] || !m_bodies.IsAwake(i))
+			{
+				continue;
+			}
+
+			// A body that moves less than its inner radius per tick can't skip over anything the discrete contacts would miss
+			const float sweepRadius = m_bodies.m_shapes[i].GetInnerRadius();
+			if (m_bodies.GetLinearVelocity(i).LengthSquared() * inDeltaTime * inDeltaTime > sweepRadius * sweepRadius)
+			{
+				m_continuousBodies.push_back({ i, m_bodies.GetPosition(i) });
+			}
+		}
+	}
+
+	void UPhysicsWorld::SolveTimesOfImpact()
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_SolveTimesOfImpact, 0);
+
+		for (const SContinuousBody& currentBody : m_continuousBodies)
+		{
+			const uint32_t bodyIndex = currentBody.m_bodyIndex;
+			const Vector3& startPosition = currentBody.m_startPosition;
+			const Vector3 motion = m_bodies.GetPosition(bodyIndex) - startPosition;
+			const float motionLength = motion.Length();
+			const Vector3 motionDirection = motion / motionLength;
+
+			// Sweeping the sphere that fits inside the body is the same as casting a ray against the other shapes grown by its
+			// radius. The sphere stops at the first static or kinematic body and the contacts push the rest of the body out
+			const float sweepRadius = m_bodies.m_shapes[bodyIndex].GetInnerRadius();
+			const Vector3 sweepExtents(sweepRadius, sweepRadius, sweepRadius);
+			const SAABB sweptBounds(Vector3::Min(startPosition, m_bodies.GetPosition(bodyIndex)) - sweepExtents, Vector3::Max(startPosition, m_bodies.GetPosition(bodyIndex)) + sweepExtents);
+
+			float impactDistance = motionLength;
+			Vector3 impactNormal;
+			uint32_t impactBody = InvalidBodyIndex;
+
+			m_broadphase.Query(sweptBounds, [&](int32_t inProxyID)
+			{
+				const uint32_t otherIndex = m_broadphase.GetUserData(inProxyID);
+				if (m_bodies.IsDynamic(otherIndex))
+				{
+					return true;
+				}
+
+				float hitDistance;
+				Vector3 hitNormal;
+
+				// Starting inside means the body already touches it, which is the discrete contacts' job
+				if (m_bodies.m_shapes[otherIndex].SweepSphere(m_bodies.GetPosition(otherIndex), m_bodies.GetRotation(otherIndex), startPosition, motionDirection, sweepRadius, impactDistance, hitDistance, hitNormal)
+					&& hitDistance > 0.0f && hitDistance < impactDistance)
+				{
+					impactDistance = hitDistance;
+					impactNormal = hitNormal;
+					impactBody = otherIndex;
+				}
+
+				return true;
+			});
+
+			if (impactBody == InvalidBodyIndex)
+			{
+				continue;
+			}
+
+			// Stop at the impact and bounce off the surface like a contact would have
+			Vector3 linearVelocity = m_bodies.GetLinearVelocity(bodyIndex);
+			const float normalVelocity = linearVelocity.Dot(impactNormal);
+
+			if (normalVelocity < 0.0f)
+			{
+				const float restitution = eastl::max(m_bodies.m_restitution[bodyIndex], m_bodies.m_restitution[impactBody]);
+				linearVelocity -= impactNormal * (normalVelocity * (1.0f + restitution));
+			}
+
+			m_bodies.SetPosition(bodyIndex, startPosition + motionDirection * impactDistance);
+			m_bodies.SetLinearVelocity(bodyIndex, linearVelocity);
+		}
+	}
+
+	void UPhysicsWorld::WriteBackTransforms()
+	{
+		rmt_ScopedCPUSample(PhysicsWorld_WriteBackTransforms, 0);
+
+		for (uint32_t i = 0; i < m_physicsComponents.size(); ++i)
+		{
+			// Sleeping bodies didn't move, so their components are left alone
+			if (!m_bodies.IsDynamic(i) || !m_bodies.IsAwake(i))
+			{
+				continue;
+			}
+
+			SPhysicsBodyProxy& currentProxy = m_physicsComponents[i];
+			eastl::shared_ptr<PhysicsBody_t> physicsComponent = currentProxy.m_body.lock();
+
+			if (!physicsComponent)
+			{
+				continue;
+			}
+
+			physicsComponent->SetWorldRotation(m_bodies.GetRotation(i));
+			physicsComponent->SetWorldTranslation(m_bodies.GetPosition(i));
+
+			// Read back rather than remembering what was written, so that the next SyncBodies compares exactly what it will read
+			currentProxy.m_lastTranslation = physicsComponent->GetWorldTranslation();
+			currentProxy.m_lastRotation = physicsComponent->GetWorldRotation();
+		}
+	}
+
+	uint64_t UPhysicsWorld::GetOrderKey(const PhysicsBody_t& inPhysicsComponent)
+	{
+		// Network spawned bodies come after every loaded one, there aren't 2^63 of those
+		if (inPhysicsComponent.IsNetworkSpawned())
+		{
+			const uint64_t netID = inPhysicsComponent.GetNetID().GetUnderlyingHandle();
+			const uint64_t componentIndex = static_cast<uint32_t>(DetermineComponentIndex(&inPhysicsComponent));
+
+			return (1ull << 63) | (netID << 32) | componentIndex;
+		}
+
+		return m_nextLoadedOrderKey++;
+	}
+
+	bool UPhysicsWorld::IsPairBefore(const SBroadphasePair& inLeft, const SBroadphasePair& inRight) const
+	{
+		const uint64_t leftKeyA = m_proxyOrderKeys[inLeft.m_proxyA];
+		const uint64_t rightKeyA = m_proxyOrderKeys[inRight.m_proxyA];
+
+		return leftKeyA < rightKeyA || (leftKeyA == rightKeyA && m_proxyOrderKeys[inLeft.m_proxyB] < m_proxyOrderKeys[inRight.m_proxyB]);
+	}
+
+	void UPhysicsWorld::MarkProxyDirty(int32_t inProxyID)
+	{
+		if (static_cast<size_t>(inProxyID) >= m_isProxyDirty.size())
+		{
+			m_isProxyDirty.resize(inProxyID + 1, false);
+		}
+
+		if (!m_isProxyDirty[inProxyID])
+		{
+			m_isProxyDirty[inProxyID] = true;
+			m_dirtyProxies.push_back(inProxyID);
+		}
+	}
+
+	void UPhysicsWorld::RemoveBody(uint32_t inBodyIndex)
+	{
+		const int32_t removedProxyID = m_physicsComponents[inBodyIndex].m_proxyID;
+
+		if (eastl::shared_ptr<PhysicsBody_t> removedComponent = m_physicsComponents[inBodyIndex].m_body.lock())
+		{
+			removedComponent->m_bodyIndex = InvalidBodyIndex;
+		}
+
+		// Whatever was resting on the removed body has to start falling
+		for (const SContactManifold& currentManifold : m_manifolds)
+		{
+			if (currentManifold.m_proxyA != removedProxyID && currentManifold.m_proxyB != removedProxyID)
+			{
+				continue;
+			}
+
+			const int32_t otherProxyID = currentManifold.m_proxyA == removedProxyID ? currentManifold.m_proxyB : currentManifold.m_proxyA;
+			if (m_broadphase.IsProxy(otherProxyID))
+			{
+				WakeUp(m_broadphase.GetUserData(otherProxyID));
+			}
+		}
+
+		m_broadphase.DestroyProxy(removedProxyID);
+		MarkProxyDirty(removedProxyID);
+
+		m_bodies.RemoveBody(inBodyIndex);
+		m_physicsComponents[inBodyIndex] = m_physicsComponents.back();
+		m_physicsComponents.pop_back();
+
+		if (inBodyIndex < m_physicsComponents.size())
+		{
+			SPhysicsBodyProxy& movedProxy = m_physicsComponents[inBodyIndex];
+			m_broadphase.SetUserData(movedProxy.m_proxyID, inBodyIndex);
+
+			if (eastl::shared_ptr<PhysicsBody_t> movedComponent = movedProxy.m_body.lock())
+			{
+				movedComponent->m_bodyIndex = inBodyIndex;
+			}
+		}
+	}
+
+	bool UPhysicsWorld::PassesFilter(uint32_t inBodyIndex, const SQueryFilter& inFilter) const
+	{
+		const SPhysicsBodyProxy& bodyProxy = m_physicsComponents[inBodyIndex];
+
+		if ((inFilter.m_layerMask & (1u << bodyProxy.m_queryLayer)) == 0)
+		{
+			return false;
+		}
+
+		// Everything below needs the component, which is worth avoiding for the common unfiltered query
+		if (!inFilter.m_ignoredEntity && !inFilter.m_requiredComponentType)
+		{
+			return true;
+		}
+
+		eastl::shared_ptr<PhysicsBody_t> physicsComponent = bodyProxy.m_body.lock();
+		if (!physicsComponent)
+		{
+			return false;
+		}
+
+		const AEntity& owningEntity = physicsComponent->GetOwningEntity();
+
+		if (&owningEntity == inFilter.m_ignoredEntity)
+		{
+			return false;
+		}
+
+		return !inFilter.m_requiredComponentType || !owningEntity.GetFirstComponentByType<UComponent>(*inFilter.m_requiredComponentType).expired();
+	}
+
+	float UPhysicsWorld::RaycastBody(uint32_t inBodyIndex, const SRay& inRay, float inMaxDistance, const SQueryFilter& inFilter, SQueryHit& inOutHit, uint32_t& inOutHitBody) const
+	{
+		if (!PassesFilter(inBodyIndex, inFilter))
+		{
+			return inMaxDistance;
+		}
+
+		float hitDistance;
+		Vector3 hitNormal;
+
+		if (!m_bodies.m_shapes[inBodyIndex].Raycast(m_bodies.GetPosition(inBodyIndex), m_bodies.GetRotation(inBodyIndex), inRay.m_origin, inRay.m_direction, inMaxDistance, hitDistance, hitNormal))
+		{
+			return inMaxDistance;
+		}
+
+		inOutHit.m_hasHit = true;
+		inOutHit.m_position = inRay.m_origin + inRay.m_direction * hitDistance;
+		inOutHit.m_normal = hitNormal;
+		inOutHit.m_distance = hitDistance;
+		inOutHitBody = inBodyIndex;
+
+		return hitDistance;
+	}
 }
@@ -0,0 +1,260 @@
+#include "Core/RigidBodyState.h"
+
+namespace MAD
+{
+	namespace
+	{
+		// Fraction of their velocity bodies lose every second, keeps stacks from jittering forever
+		const float g_linearDamping = 0.05f;
+		const float g_angularDamping = 0.1f;
+
+		template <typename ValueType>
+		void RemoveSwap(eastl::vector<ValueType>& inOutArray, uint32_t inIndex)
+		{
+			inOutArray[inIndex] = inOutArray.back();
+			inOutArray.pop_back();
+		}
+	}
+
+	uint32_t SRigidBodyState::AddBody(const SRigidBodyDescription& inDescription)
+	{
+		const uint32_t bodyIndex = static_cast<uint32_t>(GetBodyCount());
+		const bool isDynamic = inDescription.m_mass > 0.0f;
+		const Vector3 localInverseInertia = inDescription.m_shape.ComputeLocalInverseInertia(inDescription.m_mass);
+
+		Quaternion rotation = inDescription.m_rotation;
+		rotation.Normalize();
+
+		m_positionX.push_back(inDescription.m_position.x);
+		m_positionY.push_back(inDescription.m_position.y);
+		m_positionZ.push_back(inDescription.m_position.z);
+		m_rotationX.push_back(rotation.x);
+		m_rotationY.push_back(rotation.y);
+		m_rotationZ.push_back(rotation.z);
+		m_rotationW.push_back(rotation.w);
+		m_linearVelocityX.push_back(inDescription.m_linearVelocity.x);
+		m_linearVelocityY.push_back(inDescription.m_linearVelocity.y);
+		m_linearVelocityZ.push_back(inDescription.m_linearVelocity.z);
+		m_angularVelocityX.push_back(0.0f);
+		m_angularVelocityY.push_back(0.0f);
+		m_angularVelocityZ.push_back(0.0f);
+
+		m_inverseMass.push_back(isDynamic ? 1.0f / inDescription.m_mass : 0.0f);
+		m_gravityScale.push_back(isDynamic ? inDescription.m_gravityScale : 0.0f);
+		m_localInverseInertiaX.push_back(localInverseInertia.x);
+		m_localInverseInertiaY.push_back(localInverseInertia.y);
+		m_localInverseInertiaZ.push_back(localInverseInertia.z);
+		m_worldInverseInertia.push_back(Matrix::CreateScale(0.0f));
+
+		m_isContinuous.push_back(isDynamic && inDescription.m_isContinuous);
+		m_isAwake.push_back(true);
+		m_sleepTicks.push_back(0);
+
+		m_shapes.push_back(inDescription.m_shape);
+		m_friction.push_back(inDescription.m_friction);
+		m_restitution.push_back(inDescription.m_restitution);
+
+		return bodyIndex;
+	}
+
+	void SRigidBodyState::RemoveBody(uint32_t inBodyIndex)
+	{
+		RemoveSwap(m_positionX, inBodyIndex);
+		RemoveSwap(m_positionY, inBodyIndex);
+		RemoveSwap(m_positionZ, inBodyIndex);
+		RemoveSwap(m_rotationX, inBodyIndex);
+		RemoveSwap(m_rotationY, inBodyIndex);
+		RemoveSwap(m_rotationZ, inBodyIndex);
+		RemoveSwap(m_rotationW, inBodyIndex);
+		RemoveSwap(m_linearVelocityX, inBodyIndex);
+		RemoveSwap(m_linearVelocityY, inBodyIndex);
+		RemoveSwap(m_linearVelocityZ, inBodyIndex);
+		RemoveSwap(m_angularVelocityX, inBodyIndex);
+		RemoveSwap(m_angularVelocityY, inBodyIndex);
+		RemoveSwap(m_angularVelocityZ, inBodyIndex);
+
+		RemoveSwap(m_inverseMass, inBodyIndex);
+		RemoveSwap(m_gravityScale, inBodyIndex);
+		RemoveSwap(m_localInverseInertiaX, inBodyIndex);
+		RemoveSwap(m_localInverseInertiaY, inBodyIndex);
+		RemoveSwap(m_localInverseInertiaZ, inBodyIndex);
+		RemoveSwap(m_worldInverseInertia, inBodyIndex);
+
+		RemoveSwap(m_isContinuous, inBodyIndex);
+		RemoveSwap(m_isAwake, inBodyIndex);
+		RemoveSwap(m_sleepTicks, inBodyIndex);
+
+		RemoveSwap(m_shapes, inBodyIndex);
+		RemoveSwap(m_friction, inBodyIndex);
+		RemoveSwap(m_restitution, inBodyIndex);
+	}
+
+	void SRigidBodyState::WakeUp(uint32_t inBodyIndex)
+	{
+		m_isAwake[inBodyIndex] = true;
+		m_sleepTicks[inBodyIndex] = 0;
+	}
+
+	void SRigidBodyState::PutToSleep(uint32_t inBodyIndex)
+	{
+		// Whatever velocity is left is below the sleep threshold, dropping it keeps the body from creeping once it wakes
+		m_isAwake[inBodyIndex] = false;
+		SetLinearVelocity(inBodyIndex, Vector3::Zero);
+		SetAngularVelocity(inBodyIndex, Vector3::Zero);
+	}
+
+	float SRigidBodyState::GetNormalizedKineticEnergy(uint32_t inBodyIndex) const
+	{
+		const float inverseMass = m_inverseMass[inBodyIndex];
+		const Vector3 linearVelocity = GetLinearVelocity(inBodyIndex);
+
+		// (w^T * I * w) / m, with w in the body's local frame where I is diagonal
+		const Quaternion rotation = GetRotation(inBodyIndex);
+		const Vector3 localAngularVelocity = Vector3::Transform(GetAngularVelocity(inBodyIndex), Quaternion(-rotation.x, -rotation.y, -rotation.z, rotation.w));
+		const float localInverseInertia[3] = { m_localInverseInertiaX[inBodyIndex], m_localInverseInertiaY[inBodyIndex], m_localInverseInertiaZ[inBodyIndex] };
+		const float localAngularComponents[3] = { localAngularVelocity.x, localAngularVelocity.y, localAngularVelocity.z };
+
+		float angularEnergy = 0.0f;
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			if (localInverseInertia[i] > 0.0f)
+			{
+				angularEnergy += localAngularComponents[i] * localAngularComponents[i] * inverseMass / localInverseInertia[i];
+			}
+		}
+
+		return 0.5f * (linearVelocity.LengthSquared() + angularEnergy);
+	}
+
+	void SRigidBodyState::SetPosition(uint32_t inBodyIndex, const Vector3& inPosition)
+	{
+		m_positionX[inBodyIndex] = inPosition.x;
+		m_positionY[inBodyIndex] = inPosition.y;
+		m_positionZ[inBodyIndex] = inPosition.z;
+	}
+
+	void SRigidBodyState::SetRotation(uint32_t inBodyIndex, const Quaternion& inRotation)
+	{
+		m_rotationX[inBodyIndex] = inRotation.x;
+		m_rotationY[inBodyIndex] = inRotation.y;
+		m_rotationZ[inBodyIndex] = inRotation.z;
+		m_rotationW[inBodyIndex] = inRotation.w;
+	}
+
+	void SRigidBodyState::SetLinearVelocity(uint32_t inBodyIndex, const Vector3& inLinearVelocity)
+	{
+		m_linearVelocityX[inBodyIndex] = inLinearVelocity.x;
+		m_linearVelocityY[inBodyIndex] = inLinearVelocity.y;
+		m_linearVelocityZ[inBodyIndex] = inLinearVelocity.z;
+	}
+
+	void SRigidBodyState::SetAngularVelocity(uint32_t inBodyIndex, const Vector3& inAngularVelocity)
+	{
+		m_angularVelocityX[inBodyIndex] = inAngularVelocity.x;
+		m_angularVelocityY[inBodyIndex] = inAngularVelocity.y;
+		m_angularVelocityZ[inBodyIndex] = inAngularVelocity.z;
+	}
+
+	void SRigidBodyState::IntegrateVelocities(const Vector3& inGravity, float inDeltaTime)
+	{
+		const size_t bodyCount = GetBodyCount();
+		const float linearDampingFactor = 1.0f / (1.0f + inDeltaTime * g_linearDamping);
+		const float angularDampingFactor = 1.0f / (1.0f + inDeltaTime * g_angularDamping);
+		const Vector3 gravityDelta = inGravity * inDeltaTime;
+
+		float* const linearVelocityX = m_linearVelocityX.data();
+		float* const linearVelocityY = m_linearVelocityY.data();
+		float* const linearVelocityZ = m_linearVelocityZ.data();
+		float* const angularVelocityX = m_angularVelocityX.data();
+		float* const angularVelocityY = m_angularVelocityY.data();
+		float* const angularVelocityZ = m_angularVelocityZ.data();
+		const float* const gravityScale = m_gravityScale.data();
+		const float* const inverseMass = m_inverseMass.data();
+		const uint8_t* const isAwake = m_isAwake.data();
+
+		for (size_t i = 0; i < bodyCount; ++i)
+		{
+			// Bodies that aren't dynamic have a gravity scale of 0 and keep the velocity their component gave them.
+			// Sleeping bodies have no velocity to damp, they only must not pick up gravity
+			const float dampingBlend = inverseMass[i] > 0.0f ? 1.0f : 0.0f;
+			const float linearDamping = 1.0f + (linearDampingFactor - 1.0f) * dampingBlend;
+			const float angularDamping = 1.0f + (angularDampingFactor - 1.0f) * dampingBlend;
+			const float gravityBlend = gravityScale[i] * static_cast<float>(isAwake[i]);
+
+			linearVelocityX[i] = (linearVelocityX[i] + gravityDelta.x * gravityBlend) * linearDamping;
+			linearVelocityY[i] = (linearVelocityY[i] + gravityDelta.y * gravityBlend) * linearDamping;
+			linearVelocityZ[i] = (linearVelocityZ[i] + gravityDelta.z * gravityBlend) * linearDamping;
+
+			angularVelocityX[i] *= angularDamping;
+			angularVelocityY[i] *= angularDamping;
+			angularVelocityZ[i] *= angularDamping;
+		}
+	}
+
+	void SRigidBodyState::IntegratePositions(float inDeltaTime)
+	{
+		const size_t bodyCount = GetBodyCount();
+		const float halfDeltaTime = 0.5f * inDeltaTime;
+
+		float* const positionX = m_positionX.data();
+		float* const positionY = m_positionY.data();
+		float* const positionZ = m_positionZ.data();
+		float* const rotationX = m_rotationX.data();
+		float* const rotationY = m_rotationY.data();
+		float* const rotationZ = m_rotationZ.data();
+		float* const rotationW = m_rotationW.data();
+		const float* const linearVelocityX = m_linearVelocityX.data();
+		const float* const linearVelocityY = m_linearVelocityY.data();
+		const float* const linearVelocityZ = m_linearVelocityZ.data();
+		const float* const angularVelocityX = m_angularVelocityX.data();
+		const float* const angularVelocityY = m_angularVelocityY.data();
+		const float* const angularVelocityZ = m_angularVelocityZ.data();
+
+		for (size_t i = 0; i < bodyCount; ++i)
+		{
+			positionX[i] += linearVelocityX[i] * inDeltaTime;
+			positionY[i] += linearVelocityY[i] * inDeltaTime;
+			positionZ[i] += linearVelocityZ[i] * inDeltaTime;
+
+			// q += 0.5 * dt * (w, 0) * q, then renormalize
+			const float x = rotationX[i];
+			const float y = rotationY[i];
+			const float z = rotationZ[i];
+			const float w = rotationW[i];
+			const float wx = angularVelocityX[i];
+			const float wy = angularVelocityY[i];
+			const float wz = angularVelocityZ[i];
+
+			const float newX = x + halfDeltaTime * (wx * w + wy * z - wz * y);
+			const float newY = y + halfDeltaTime * (wy * w + wz * x - wx * z);
+			const float newZ = z + halfDeltaTime * (wz * w + wx * y - wy * x);
+			const float newW = w - halfDeltaTime * (wx * x + wy * y + wz * z);
+
+			const float inverseLength = 1.0f / sqrtf(newX * newX + newY * newY + newZ * newZ + newW * newW);
+
+			rotationX[i] = newX * inverseLength;
+			rotationY[i] = newY * inverseLength;
+			rotationZ[i] = newZ * inverseLength;
+			rotationW[i] = newW * inverseLength;
+		}
+	}
+
+	void SRigidBodyState::UpdateWorldInverseInertia()
+	{
+		const size_t bodyCount = GetBodyCount();
+
+		for (size_t i = 0; i < bodyCount; ++i)
+		{
+			if (m_inverseMass[i] == 0.0f || !m_isAwake[i])
+			{
+				continue;
+			}
+
+			// Rows of the rotation matrix are the local axes in world space, so R^T * D * R takes world vectors through local space
+			const Matrix rotation = Matrix::CreateFromQuaternion(GetRotation(static_cast<uint32_t>(i)));
+			const Matrix localInverseInertia = Matrix::CreateScale(m_localInverseInertiaX[i], m_localInverseInertiaY[i], m_localInverseInertiaZ[i]);
+
+			m_worldInverseInertia[i] = rotation.Transpose() * localInverseInertia * rotation;
+		}
+	}
+}
@@ -2,6 +2,15 @@
 
 namespace MAD
 {
+	namespace
+	{
+		// pi / 4 split over three floats, so that subtracting multiples of it from an angle loses next to no precision
+		const float g_quarterPiHigh = 0.78515625f;
+		const float g_quarterPiMid = 2.4187564849853515625e-4f;
+		const float g_quarterPiLow = 3.77489497744594108e-8f;
+		const float g_inverseQuarterPi = 1.27323954473516f;
+	}
+
 	ULinearTransform::ULinearTransform() : m_scale(1.0f) {}
 
 	ULinearTransform::ULinearTransform(float inScale, const Quaternion& inRotation, const Vector3& inTranslation)
@@ -106,6 +115,59 @@ namespace MAD
 		return outputScaleTransform;
 	}
 
+	void DeterministicSinCos(float inRadians, float& outSin, float& outCos)
+	{
+		// Same reduction and polynomials as Cephes' sinf and cosf. The angle is reduced to [-pi/4, pi/4] around the closest
+		// multiple of pi/2, and the octant picks which of the two polynomials is the sine and which is the cosine
+		const float absRadians = fabsf(inRadians);
+
+		uint32_t octant = static_cast<uint32_t>(absRadians * g_inverseQuarterPi);
+		float octantAngle = static_cast<float>(octant);
+
+		if (octant & 1)
+		{
+			++octant;
+			octantAngle += 1.0f;
+		}
+
+		octant &= 7;
+
+		const float x = ((absRadians - octantAngle * g_quarterPiHigh) - octantAngle * g_quarterPiMid) - octantAngle * g_quarterPiLow;
+		const float xSquared = x * x;
+
+		const float sinX = ((-1.9515295891e-4f * xSquared + 8.3321608736e-3f) * xSquared - 1.6666654611e-1f) * xSquared * x + x;
+		const float cosX = ((2.443315711809948e-5f * xSquared - 1.388731625493765e-3f) * xSquared + 4.166664568298827e-2f) * xSquared * xSquared - 0.5f * xSquared + 1.0f;
+
+		switch (octant)
+		{
+		case 0: outSin = sinX; outCos = cosX; break;
+		case 2: outSin = cosX; outCos = -sinX; break;
+		case 4: outSin = -sinX; outCos = -cosX; break;
+		default: outSin = -cosX; outCos = sinX; break;
+		}
+
+		if (inRadians < 0.0f)
+		{
+			outSin = -outSin;
+		}
+	}
+
+	float DeterministicSin(float inRadians)
+	{
+		float sinResult;
+		float cosResult;
+		DeterministicSinCos(inRadians, sinResult, cosResult);
+		return sinResult;
+	}
+
+	float DeterministicCos(float inRadians)
+	{
+		float sinResult;
+		float cosResult;
+		DeterministicSinCos(inRadians, sinResult, cosResult);
+		return cosResult;
+	}
+
 	float ClampAxis(float inAngle)
 	{
 		// returns Angle in the range (-360,360)
@@ -144,12 +206,11 @@ namespace MAD
 
 		Quaternion outputQuat;
 
-		float c1 = cos(inYaw / 2.0f);
-		float s1 = sin(inYaw / 2.0f);
-		float c2 = cos(inRoll / 2.0f);
-		float s2 = sin(inRoll / 2.0f);
-		float c3 = cos(inPitch / 2.0f);
-		float s3 = sin(inPitch / 2.0f);
+		// Loaded rotations feed the simulation, so they have to come out the same on every machine
+		float c1, s1, c2, s2, c3, s3;
+		DeterministicSinCos(inYaw / 2.0f, s1, c1);
+		DeterministicSinCos(inRoll / 2.0f, s2, c2);
+		DeterministicSinCos(inPitch / 2.0f, s3, c3);
 		float c1c2 = c1*c2;
 		float s1s2 = s1*s2;
 
@@ -0,0 +1,38 @@
+#include "Core/SimulationChecksum.h"
+
+namespace MAD
+{
+	namespace
+	{
+		// 64 bit FNV-1a
+		const uint64_t g_fnvOffsetBasis = 14695981039346656037ull;
+		const uint64_t g_fnvPrime = 1099511628211ull;
+	}
+
+	USimulationChecksum::USimulationChecksum() : m_value(g_fnvOffsetBasis) {}
+
+	void USimulationChecksum::Add(const void* inData, size_t inSize)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(inData);
+
+		for (size_t i = 0; i < inSize; ++i)
+		{
+			m_value = (m_value ^ bytes[i]) * g_fnvPrime;
+		}
+	}
+
+	void USimulationChecksum::Add(const Vector3& inValue)
+	{
+		Add(inValue.x);
+		Add(inValue.y);
+		Add(inValue.z);
+	}
+
+	void USimulationChecksum::Add(const Quaternion& inValue)
+	{
+		Add(inValue.x);
+		Add(inValue.y);
+		Add(inValue.z);
+		Add(inValue.w);
+	}
+}
@@ -1,6 +1,50 @@
 #include "Misc/AssetCache.h"
 
+#include "Misc/Remotery.h"
+
 namespace MAD
 {
 	eastl::string UAssetCache::s_assetRootPath;
+	std::atomic<uint64_t> UAssetCache::s_currentFrame(0);
+	std::mutex UAssetCache::s_storageRegistryMutex;
+	eastl::vector<UAssetCache::SCacheStorageBase*> UAssetCache::s_storageRegistry;
+
+	void UAssetCache::Tick()
+	{
+		rmt_ScopedCPUSample(AssetCache_Tick, 0);
+
+		++s_currentFrame;
+
+		std::lock_guard<std::mutex> lock(s_storageRegistryMutex);
+		for (SCacheStorageBase* currentStorage : s_storageRegistry)
+		{
+			currentStorage->Evict(false);
+		}
+	}
+
+	void UAssetCache::EvictUnreferenced()
+	{
+		std::lock_guard<std::mutex> lock(s_storageRegistryMutex);
+		for (SCacheStorageBase* currentStorage : s_storageRegistry)
+		{
+			currentStorage->Evict(true);
+		}
+	}
+
+	void UAssetCache::DumpContents()
+	{
+		LOG(LogAssetCache, Log, "Asset cache contents as of frame %llu:\n", s_currentFrame.load());
+
+		std::lock_guard<std::mutex> lock(s_storageRegistryMutex);
+		for (SCacheStorageBase* currentStorage : s_storageRegistry)
+		{
+			currentStorage->Dump();
+		}
+	}
+
+	void UAssetCache::RegisterStorage(SCacheStorageBase* inStorage)
+	{
+		std::lock_guard<std::mutex> lock(s_storageRegistryMutex);
+		s_storageRegistry.push_back(inStorage);
+	}
 }
@@ -0,0 +1,188 @@
+#include "Misc/AsyncAssetLoader.h"
+
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <EASTL/deque.h>
+#include <EASTL/vector.h>
+
+#include "Misc/Assert.h"
+#include "Misc/Logging.h"
+#include "Misc/Remotery.h"
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogAsyncAssetLoader);
+
+	namespace
+	{
+		eastl::vector<std::thread> g_loaderThreads;
+
+		std::mutex g_workerQueueMutex;
+		std::condition_variable g_workerQueueCondition;
+		eastl::deque<UAsyncAssetLoader::WorkerStep_t> g_workerQueue;
+		bool g_isShuttingDown = false;
+
+		std::mutex g_finalizeQueueMutex;
+		eastl::deque<UAsyncAssetLoader::FinalizeStep_t> g_finalizeQueue;
+
+		// Worker steps that are queued or running. Finalize steps are counted through the size of their queue
+		std::atomic<uint32_t> g_pendingWorkerSteps(0);
+
+		void LoaderMain()
+		{
+			// The WIC texture decoder goes through COM
+			const HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+			for (;;)
+			{
+				UAsyncAssetLoader::WorkerStep_t workerStep;
+
+				{
+					std::unique_lock<std::mutex> lock(g_workerQueueMutex);
+					g_workerQueueCondition.wait(lock, [] { return g_isShuttingDown || !g_workerQueue.empty(); });
+
+					if (g_isShuttingDown)
+					{
+						break;
+					}
+
+					workerStep = eastl::move(g_workerQueue.front());
+					g_workerQueue.pop_front();
+				}
+
+				workerStep();
+				--g_pendingWorkerSteps;
+			}
+
+			if (SUCCEEDED(comResult))
+			{
+				CoUninitialize();
+			}
+		}
+	}
+
+	void UAsyncAssetLoader::Init(uint32_t inNumThreads)
+	{
+		MAD_ASSERT_DESC(g_loaderThreads.empty(), "Async asset loader was already initialized");
+
+		LOG(LogAsyncAssetLoader, Log, "Starting %u asset loader threads\n", inNumThreads);
+
+		g_isShuttingDown = false;
+		g_loaderThreads.reserve(inNumThreads);
+
+		for (uint32_t i = 0; i < inNumThreads; ++i)
+		{
+			g_loaderThreads.emplace_back(LoaderMain);
+		}
+	}
+
+	void UAsyncAssetLoader::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_workerQueueMutex);
+			g_isShuttingDown = true;
+		}
+
+		g_workerQueueCondition.notify_all();
+
+		for (auto& currentThread : g_loaderThreads)
+		{
+			currentThread.join();
+		}
+
+		g_loaderThreads.clear();
+
+		g_workerQueue.clear();
+		g_pendingWorkerSteps = 0;
+
+		std::lock_guard<std::mutex> lock(g_finalizeQueueMutex);
+		g_finalizeQueue.clear();
+	}
+
+	void UAsyncAssetLoader::QueueLoad(WorkerStep_t inWorkerStep)
+	{
+		if (g_loaderThreads.empty())
+		{
+			inWorkerStep();
+			return;
+		}
+
+		++g_pendingWorkerSteps;
+
+		{
+			std::lock_guard<std::mutex> lock(g_workerQueueMutex);
+			g_workerQueue.push_back(eastl::move(inWorkerStep));
+		}
+
+		g_workerQueueCondition.notify_one();
+	}
+
+	void UAsyncAssetLoader::QueueFinalize(FinalizeStep_t inFinalizeStep)
+	{
+		std::lock_guard<std::mutex> lock(g_finalizeQueueMutex);
+		g_finalizeQueue.push_back(eastl::move(inFinalizeStep));
+	}
+
+	void UAsyncAssetLoader::ProcessFinalizeQueue(double inBudgetSeconds)
+	{
+		rmt_ScopedCPUSample(AsyncAssetLoader_Finalize, 0);
+
+		using Clock_t = std::chrono::steady_clock;
+		const Clock_t::time_point startTime = Clock_t::now();
+
+		size_t stepsToVisit;
+		{
+			std::lock_guard<std::mutex> lock(g_finalizeQueueMutex);
+			stepsToVisit = g_finalizeQueue.size();
+		}
+
+		eastl::vector<FinalizeStep_t> waitingSteps;
+
+		for (; stepsToVisit > 0; --stepsToVisit)
+		{
+			FinalizeStep_t finalizeStep;
+			{
+				std::lock_guard<std::mutex> lock(g_finalizeQueueMutex);
+				finalizeStep = eastl::move(g_finalizeQueue.front());
+				g_finalizeQueue.pop_front();
+			}
+
+			if (!finalizeStep())
+			{
+				waitingSteps.push_back(eastl::move(finalizeStep));
+			}
+
+			// Always make progress on at least one step, however large it is
+			if (std::chrono::duration<double>(Clock_t::now() - startTime).count() >= inBudgetSeconds)
+			{
+				break;
+			}
+		}
+
+		if (!waitingSteps.empty())
+		{
+			std::lock_guard<std::mutex> lock(g_finalizeQueueMutex);
+			g_finalizeQueue.insert(g_finalizeQueue.end(), waitingSteps.begin(), waitingSteps.end());
+		}
+	}
+
+	void UAsyncAssetLoader::Flush()
+	{
+		while (GetPendingLoadCount() > 0)
+		{
+			ProcessFinalizeQueue(DBL_MAX);
+			std::this_thread::yield();
+		}
+	}
+
+	uint32_t UAsyncAssetLoader::GetPendingLoadCount()
+	{
+		std::lock_guard<std::mutex> lock(g_finalizeQueueMutex);
+		return g_pendingWorkerSteps + static_cast<uint32_t>(g_finalizeQueue.size());
+	}
+}
@@ -0,0 +1,17 @@
+#include "Misc/CookedFile.h"
+
+namespace MAD
+{
+	bool UCookedFile::GetSourceFileStamp(const eastl::string& inSourcePath, uint64_t& outFileSize, uint64_t& outWriteTime)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA sourceAttributes;
+		if (!GetFileAttributesExA(inSourcePath.c_str(), GetFileExInfoStandard, &sourceAttributes))
+		{
+			return false;
+		}
+
+		outFileSize = (static_cast<uint64_t>(sourceAttributes.nFileSizeHigh) << 32) | sourceAttributes.nFileSizeLow;
+		outWriteTime = (static_cast<uint64_t>(sourceAttributes.ftLastWriteTime.dwHighDateTime) << 32) | sourceAttributes.ftLastWriteTime.dwLowDateTime;
+		return true;
+	}
+}
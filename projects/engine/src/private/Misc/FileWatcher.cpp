@@ -0,0 +1,73 @@
+#include "Misc/FileWatcher.h"
+
+#include "Misc/CookedFile.h"
+
+namespace MAD
+{
+	UFileWatcher::UFileWatcher(double inPollIntervalSeconds)
+		: m_pollInterval(inPollIntervalSeconds)
+		, m_lastPollTime(0.0) { }
+
+	void UFileWatcher::WatchFile(const eastl::string& inFilePath)
+	{
+		for (const auto& currentFile : m_watchedFiles)
+		{
+			if (currentFile.m_filePath == inFilePath)
+			{
+				return;
+			}
+		}
+
+		// A file that doesn't exist yet is reported as changed once it shows up
+		SWatchedFile watchedFile;
+		watchedFile.m_filePath = inFilePath;
+		watchedFile.m_fileSize = 0;
+		watchedFile.m_writeTime = 0;
+
+		UCookedFile::GetSourceFileStamp(inFilePath, watchedFile.m_fileSize, watchedFile.m_writeTime);
+
+		m_watchedFiles.push_back(watchedFile);
+	}
+
+	void UFileWatcher::UnwatchFile(const eastl::string& inFilePath)
+	{
+		for (auto iter = m_watchedFiles.begin(); iter != m_watchedFiles.end(); ++iter)
+		{
+			if (iter->m_filePath == inFilePath)
+			{
+				m_watchedFiles.erase_unsorted(iter);
+				return;
+			}
+		}
+	}
+
+	void UFileWatcher::Poll(double inCurrentTime, eastl::vector<eastl::string>& outChangedFiles)
+	{
+		if (inCurrentTime - m_lastPollTime < m_pollInterval)
+		{
+			return;
+		}
+
+		m_lastPollTime = inCurrentTime;
+
+		for (auto& currentFile : m_watchedFiles)
+		{
+			uint64_t fileSize;
+			uint64_t writeTime;
+
+			// Files that are briefly missing while an editor saves over them are picked up on a later poll
+			if (!UCookedFile::GetSourceFileStamp(currentFile.m_filePath, fileSize, writeTime))
+			{
+				continue;
+			}
+
+			if (fileSize != currentFile.m_fileSize || writeTime != currentFile.m_writeTime)
+			{
+				currentFile.m_fileSize = fileSize;
+				currentFile.m_writeTime = writeTime;
+
+				outChangedFiles.push_back(currentFile.m_filePath);
+			}
+		}
+	}
+}
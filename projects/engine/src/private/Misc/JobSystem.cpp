@@ -0,0 +1,202 @@
+#include "Misc/JobSystem.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <EASTL/vector.h>
+
+#include "Misc/Assert.h"
+#include "Misc/Logging.h"
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogJobSystem);
+
+	namespace
+	{
+		eastl::vector<std::thread> g_workerThreads;
+
+		std::mutex g_batchMutex;
+		std::condition_variable g_batchStartedCondition;
+		std::condition_variable g_batchFinishedCondition;
+
+		// State of the batch currently being executed. Only modified under g_batchMutex
+		const UJobSystem::ParallelJob_t* g_batchJob = nullptr;
+		uint32_t g_batchJobCount = 0;
+		uint64_t g_batchGeneration = 0;
+		uint32_t g_activeWorkers = 0;
+		bool g_isBatchOpen = false;
+		bool g_isShuttingDown = false;
+
+		std::atomic<uint32_t> g_nextJobIndex(0);
+		std::atomic<uint32_t> g_finishedJobCount(0);
+
+		thread_local uint32_t t_threadIndex = 0;
+
+		// The thread that called Init, the only one that can kick batches
+		std::thread::id g_mainThreadID;
+
+		void ExecuteBatchJobs(const UJobSystem::ParallelJob_t& inJob, uint32_t inJobCount)
+		{
+			uint32_t jobIndex;
+			while ((jobIndex = g_nextJobIndex.fetch_add(1)) < inJobCount)
+			{
+				inJob(jobIndex);
+
+				if (g_finishedJobCount.fetch_add(1) + 1 == inJobCount)
+				{
+					std::lock_guard<std::mutex> lock(g_batchMutex);
+					g_batchFinishedCondition.notify_all();
+				}
+			}
+		}
+
+		void WorkerMain(uint32_t inThreadIndex)
+		{
+			t_threadIndex = inThreadIndex;
+
+			uint64_t lastSeenGeneration = 0;
+
+			for (;;)
+			{
+				const UJobSystem::ParallelJob_t* batchJob = nullptr;
+				uint32_t batchJobCount = 0;
+
+				{
+					std::unique_lock<std::mutex> lock(g_batchMutex);
+					g_batchStartedCondition.wait(lock, [lastSeenGeneration] { return g_isShuttingDown || g_batchGeneration != lastSeenGeneration; });
+
+					if (g_isShuttingDown)
+					{
+						return;
+					}
+
+					lastSeenGeneration = g_batchGeneration;
+
+					// We may wake up after the batch was already completed by the other threads
+					if (!g_isBatchOpen)
+					{
+						continue;
+					}
+
+					batchJob = g_batchJob;
+					batchJobCount = g_batchJobCount;
+					++g_activeWorkers;
+				}
+
+				ExecuteBatchJobs(*batchJob, batchJobCount);
+
+				{
+					std::lock_guard<std::mutex> lock(g_batchMutex);
+					--g_activeWorkers;
+					g_batchFinishedCondition.notify_all();
+				}
+			}
+		}
+	}
+
+	void UJobSystem::Init(uint32_t inNumWorkers)
+	{
+		MAD_ASSERT_DESC(g_workerThreads.empty(), "Job system was already initialized");
+
+		if (inNumWorkers == 0)
+		{
+			const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			inNumWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		LOG(LogJobSystem, Log, "Starting %u job worker threads\n", inNumWorkers);
+
+		g_mainThreadID = std::this_thread::get_id();
+		g_isShuttingDown = false;
+		g_workerThreads.reserve(inNumWorkers);
+
+		for (uint32_t i = 0; i < inNumWorkers; ++i)
+		{
+			g_workerThreads.emplace_back(WorkerMain, i + 1);
+		}
+	}
+
+	void UJobSystem::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_batchMutex);
+			g_isShuttingDown = true;
+		}
+
+		g_batchStartedCondition.notify_all();
+
+		for (auto& currentWorker : g_workerThreads)
+		{
+			currentWorker.join();
+		}
+
+		g_workerThreads.clear();
+	}
+
+	void UJobSystem::ParallelFor(uint32_t inJobCount, const ParallelJob_t& inJob)
+	{
+		if (inJobCount == 0)
+		{
+			return;
+		}
+
+		// Checked in every build. Another thread (e.g. an asset loader thread) or a job of the running batch would take over
+		// the batch state from under the main thread's batch, so their jobs run inline instead. g_isBatchOpen is only
+		// written by the main thread, so it can read it without the lock
+		const bool canKickBatch = std::this_thread::get_id() == g_mainThreadID && !g_isBatchOpen;
+
+		if (!canKickBatch && !g_workerThreads.empty())
+		{
+			LOG(LogJobSystem, Error, "ParallelFor can only be kicked from the main thread outside of other jobs, running %u jobs inline\n", inJobCount);
+			MAD_ASSERT_DESC(false, "ParallelFor can only be kicked from the main thread outside of other jobs");
+		}
+
+		if (!canKickBatch || g_workerThreads.empty() || inJobCount == 1)
+		{
+			for (uint32_t i = 0; i < inJobCount; ++i)
+			{
+				inJob(i);
+			}
+
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(g_batchMutex);
+
+			g_batchJob = &inJob;
+			g_batchJobCount = inJobCount;
+			g_nextJobIndex = 0;
+			g_finishedJobCount = 0;
+			g_isBatchOpen = true;
+			++g_batchGeneration;
+		}
+
+		g_batchStartedCondition.notify_all();
+
+		// Help out instead of idling while the workers chew through the batch
+		ExecuteBatchJobs(inJob, inJobCount);
+
+		{
+			std::unique_lock<std::mutex> lock(g_batchMutex);
+			g_batchFinishedCondition.wait(lock, [inJobCount] { return g_finishedJobCount == inJobCount && g_activeWorkers == 0; });
+
+			g_isBatchOpen = false;
+			g_batchJob = nullptr;
+			g_batchJobCount = 0;
+		}
+	}
+
+	uint32_t UJobSystem::GetThreadCount()
+	{
+		return static_cast<uint32_t>(g_workerThreads.size()) + 1;
+	}
+
+	uint32_t UJobSystem::GetCurrentThreadIndex()
+	{
+		return t_threadIndex;
+	}
+}
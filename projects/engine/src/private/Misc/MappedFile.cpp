@@ -0,0 +1,80 @@
+#include "Misc/MappedFile.h"
+
+#include "Misc/Logging.h"
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogMappedFile);
+
+	UMappedFile::UMappedFile()
+		: m_fileHandle(INVALID_HANDLE_VALUE)
+		, m_mappingHandle(nullptr)
+		, m_data(nullptr)
+		, m_size(0) {}
+
+	UMappedFile::~UMappedFile()
+	{
+		Close();
+	}
+
+	bool UMappedFile::Open(const eastl::string& inFilePath)
+	{
+		Close();
+
+		m_fileHandle = CreateFileA(inFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			// Empty files can't be mapped
+			Close();
+			return false;
+		}
+
+		m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mappingHandle)
+		{
+			LOG(LogMappedFile, Warning, "Failed to create file mapping for '%s' (error %u)\n", inFilePath.c_str(), GetLastError());
+			Close();
+			return false;
+		}
+
+		m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (!m_data)
+		{
+			LOG(LogMappedFile, Warning, "Failed to map view of '%s' (error %u)\n", inFilePath.c_str(), GetLastError());
+			Close();
+			return false;
+		}
+
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		return true;
+	}
+
+	void UMappedFile::Close()
+	{
+		if (m_data)
+		{
+			UnmapViewOfFile(m_data);
+			m_data = nullptr;
+		}
+
+		if (m_mappingHandle)
+		{
+			CloseHandle(m_mappingHandle);
+			m_mappingHandle = nullptr;
+		}
+
+		if (m_fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_fileHandle);
+			m_fileHandle = INVALID_HANDLE_VALUE;
+		}
+
+		m_size = 0;
+	}
+}
@@ -1,5 +1,7 @@
 #include "Misc/ProgramPermutor.h"
 
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iterator>
 #include <string>
@@ -13,14 +15,88 @@
 #include "Rendering/GraphicsDriver.h"
 #include "Rendering/GraphicsDriverTypes.h"
 
+#include "Misc/AssetCache.h"
+#include "Misc/AsyncAssetLoader.h"
+#include "Misc/JobSystem.h"
 #include "Misc/Logging.h"
 
 namespace MAD
 {
 	DECLARE_LOG_CATEGORY(LogProgramPermutor);
 
+	namespace
+	{
+		// Relative to the assets root
+		const char* g_permutationCacheDirectory = "shadercache\\";
+
+		// Bump to throw away every cached permutation, e.g. when the way they're compiled changes
+		const uint32_t g_permutationCacheVersion = 1;
+
+		// Compiled shader containers start with this
+		const char g_shaderByteCodeMagic[4] = { 'D', 'X', 'B', 'C' };
+
+		const uint64_t g_fnvOffsetBasis = 14695981039346656037ULL;
+		const uint64_t g_fnvPrime = 1099511628211ULL;
+
+		uint64_t HashBytes(uint64_t inHash, const void* inData, size_t inSize)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(inData);
+
+			for (size_t i = 0; i < inSize; ++i)
+			{
+				inHash = (inHash ^ bytes[i]) * g_fnvPrime;
+			}
+
+			return inHash;
+		}
+
+		// Hashes a program file and every file it includes (once each), includes are resolved relative to the including file like the compiler does
+		void HashProgramSource(const eastl::string& inFilePath, eastl::vector<eastl::string>& inOutHashedFilePaths, uint64_t& inOutHash)
+		{
+			if (eastl::find(inOutHashedFilePaths.begin(), inOutHashedFilePaths.end(), inFilePath) != inOutHashedFilePaths.end())
+			{
+				return;
+			}
+
+			inOutHashedFilePaths.push_back(inFilePath);
+
+			std::ifstream sourceInputStream(inFilePath.c_str(), std::ios::in | std::ios::binary);
+			if (!sourceInputStream.is_open())
+			{
+				// Still changes the hash, so a missing include can't be mistaken for an unchanged one
+				inOutHash = HashBytes(inOutHash, inFilePath.c_str(), inFilePath.size());
+				return;
+			}
+
+			const std::string stdSourceBuffer((std::istreambuf_iterator<char>(sourceInputStream)), std::istreambuf_iterator<char>());
+			inOutHash = HashBytes(inOutHash, stdSourceBuffer.data(), stdSourceBuffer.size());
+
+			const eastl::string sourceDirectory = inFilePath.substr(0, inFilePath.find_last_of("\\/") + 1);
+			static const std::string s_includeDirective = "#include";
+
+			size_t includeIndex = stdSourceBuffer.find(s_includeDirective);
+			while (includeIndex != std::string::npos)
+			{
+				const size_t nameBeginIndex = stdSourceBuffer.find_first_of("\"<", includeIndex + s_includeDirective.length());
+				const size_t nameEndIndex = nameBeginIndex != std::string::npos ? stdSourceBuffer.find_first_of("\">\n", nameBeginIndex + 1) : std::string::npos;
+
+				if (nameEndIndex == std::string::npos)
+				{
+					break;
+				}
+
+				HashProgramSource(sourceDirectory + stdSourceBuffer.substr(nameBeginIndex + 1, nameEndIndex - nameBeginIndex - 1).c_str(), inOutHashedFilePaths, inOutHash);
+
+				includeIndex = stdSourceBuffer.find(s_includeDirective, nameEndIndex);
+			}
+		}
+	}
+
 	/** Program Permutation Constants -------------------------- */
 	const eastl::string UProgramPermutor::s_shaderMetaFlagString = "//=>:(";
+
+	const ProgramId_t UProgramPermutor::s_deferredPermuteMask = static_cast<ProgramId_t>(EProgramIdMask::GBuffer_Diffuse) | static_cast<ProgramId_t>(EProgramIdMask::GBuffer_Specular) |
+		static_cast<ProgramId_t>(EProgramIdMask::GBuffer_Emissive) | static_cast<ProgramId_t>(EProgramIdMask::GBuffer_OpacityMask) | static_cast<ProgramId_t>(EProgramIdMask::GBuffer_NormalMap);
 	
 	const eastl::hash_map<eastl::string, EProgramIdMask> UProgramPermutor::s_programIdMaskToStringMap =
 	{
@@ -31,7 +107,9 @@ namespace MAD
 		{ "NORMAL_MAP", EProgramIdMask::GBuffer_NormalMap },
 
 		{ "POINT_LIGHT", EProgramIdMask::Lighting_PointLight },
-		{ "DIRECTIONAL_LIGHT", EProgramIdMask::Lighting_DirectionalLight }
+		{ "DIRECTIONAL_LIGHT", EProgramIdMask::Lighting_DirectionalLight },
+
+		{ "INSTANCED", EProgramIdMask::Geometry_Instanced }
 	};
 
 	const eastl::hash_map<eastl::string, EMetaFlagType> UProgramPermutor::s_metaFlagStringToTypeMap =
@@ -40,17 +118,20 @@ namespace MAD
 		{ "Permute", EMetaFlagType::EMetaFlagType_Permute },
 	};
 
-	void UProgramPermutor::PermuteProgram(const eastl::string& inProgramFilePath, ProgramPermutations_t& outProgramPermutations, bool inShouldGenPermutationFiles)
+	void UProgramPermutor::PermuteProgram(const eastl::string& inProgramFilePath, SProgramSourceDescription& outProgramSource, ProgramPermutations_t& outProgramPermutations, bool inShouldGenPermutationFiles)
 	{
 		std::ifstream programInputStream(inProgramFilePath.c_str(), std::ios::in | std::ios::ate);
 
+		outProgramSource.ProgramFilePath = inProgramFilePath;
+		outProgramSource.UsageDescriptions.clear();
+		outProgramSource.PermuteDescriptions.clear();
+		outProgramSource.SourceHash = g_fnvOffsetBasis;
+
 		if (programInputStream.is_open())
 		{
 			std::string stdProgramStringBuffer;
 
 			eastl::vector<SShaderMetaFlagInstance>						programMetaFlagInstances;
-			eastl::vector<SShaderUsageDescription>						programUsageDescriptions;
-			eastl::vector<SShaderPermuteDescription>						programPermutationDescriptions;
 
 			stdProgramStringBuffer.resize(programInputStream.tellg());
 
@@ -72,7 +153,7 @@ namespace MAD
 					{
 						//LOG(LogProgramPermutor, Log, "Adding meta usage flag with values: %s - %s\n", currentMetaFlagInst.MetaFlagValues[0].c_str(), currentMetaFlagInst.MetaFlagValues[1].c_str());
 
-						programUsageDescriptions.push_back({ currentMetaFlagInst.MetaFlagValues[0], currentMetaFlagInst.MetaFlagValues[1] });
+						outProgramSource.UsageDescriptions.push_back({ currentMetaFlagInst.MetaFlagValues[0], currentMetaFlagInst.MetaFlagValues[1] });
 						break;
 					}
 					case EMetaFlagType::EMetaFlagType_Permute:
@@ -82,7 +163,7 @@ namespace MAD
 						if (permuteIdMask != EProgramIdMask::INVALID)
 						{
 							//LOG(LogProgramPermutor, Log, "Adding meta permute flag with define: %s\n", currentMetaFlagInst.MetaFlagValues[0].c_str());
-							programPermutationDescriptions.push_back({ permuteIdMask });
+							outProgramSource.PermuteDescriptions.push_back({ permuteIdMask });
 						}
 						else
 						{
@@ -94,122 +175,377 @@ namespace MAD
 				}
 			}
 
+			// The permutation cache keys on the exact bytes of the program and its includes, not on the whitespace stripped buffer above
+			eastl::vector<eastl::string> hashedFilePaths;
+			HashProgramSource(inProgramFilePath, hashedFilePaths, outProgramSource.SourceHash);
+
+			CreateDirectoryA((UAssetCache::GetAssetRoot() + g_permutationCacheDirectory).c_str(), nullptr);
+
 			// The usage descriptions tell us which parts of the program to include in the shader permutation sets
-			GeneratePermutations(inProgramFilePath, programUsageDescriptions, programPermutationDescriptions, outProgramPermutations, inShouldGenPermutationFiles);
+			GeneratePermutations(outProgramSource, outProgramPermutations, inShouldGenPermutationFiles);
 		}
 	}
 
-	void UProgramPermutor::GeneratePermutations(const eastl::string& inShaderFilePath, const eastl::vector<SShaderUsageDescription>& inUsageDescriptions, const eastl::vector<SShaderPermuteDescription>& inPermuteOptions, ProgramPermutations_t& outPermutations, bool inShouldGenPermutationFiles)
+	void UProgramPermutor::CompilePermutationAsync(const eastl::shared_ptr<const SProgramSourceDescription>& inProgramSource, ProgramId_t inProgramId, const eastl::shared_ptr<UPassProgram>& inPassProgram)
 	{
-		UGraphicsDriver& graphicsDriver = gEngine->GetRenderer().GetGraphicsDriver();
-		
-		const size_t numPermuteOptions = inPermuteOptions.size();
-		
-		if (numPermuteOptions >= 0)
+		struct SDeferredShader
 		{
-			const size_t totalNumPermutations = 0x1ULL << numPermuteOptions;
-			
-			for (size_t i = 0; i < totalNumPermutations; ++i)
+			const SShaderUsageDescription* UsageDescription;
+			EProgramShaderType ShaderType;
+			eastl::vector<char> ByteCode;
+			bool IsCached;
+		};
+
+		UAsyncAssetLoader::QueueLoad([inProgramSource, inProgramId, inPassProgram]()
+		{
+			auto deferredShaders = eastl::make_shared<eastl::vector<SDeferredShader>>();
+
+			for (const auto& currentUsageDescription : inProgramSource->UsageDescriptions)
 			{
-				ProgramId_t currentProgramId = 0;
-				eastl::vector<D3D_SHADER_MACRO> programMacroDefines;
-				eastl::vector<char> compiledProgramByteCode;
-				eastl::string currentProgramIdString;
-
-				programMacroDefines.reserve(inPermuteOptions.size());
-				
-				// Find the bits that are set and mask the associated bit mask with the program ID
-				if (numPermuteOptions > 0)
+				if (!IsDeferredUsage(inProgramId, currentUsageDescription))
 				{
-					for (size_t j = 0; j < numPermuteOptions; ++j)
-					{
-						const eastl::string& permuteIdString = UProgramPermutor::ConvertPIDMaskToString(inPermuteOptions[j].PermuteIdMask);
+					continue;
+				}
 
-						currentProgramIdString += '[';
+				SDeferredShader deferredShader = { &currentUsageDescription, URenderPassProgram::ConvertStringToShaderType(currentUsageDescription.ShaderEntryName), eastl::vector<char>(), false };
+				if (!GetPermutationByteCode(*inProgramSource, inProgramId, currentUsageDescription, deferredShader.ByteCode, deferredShader.IsCached))
+				{
+					// The permutation is never marked ready, so its draws keep using the fallback
+					LOG(LogProgramPermutor, Error, "Error: Couldn't compile shader for usage of (%s-%s) and program ID of %llu\n", currentUsageDescription.ShaderEntryName.c_str(), currentUsageDescription.ShaderModelName.c_str(), inProgramId);
+					return;
+				}
 
-						if ((i & (0x1ULL << j)) != 0)
-						{
-							currentProgramId |= static_cast<ProgramId_t>(inPermuteOptions[j].PermuteIdMask);
+				deferredShaders->push_back(eastl::move(deferredShader));
+			}
 
-							currentProgramIdString += '+';
+			// Passes only look at permutations on the main thread, so that's where the new shaders are swapped in
+			UAsyncAssetLoader::QueueFinalize([inProgramSource, inProgramId, inPassProgram, deferredShaders]()
+			{
+				UGraphicsDriver& graphicsDriver = gEngine->GetRenderer().GetGraphicsDriver();
 
-							programMacroDefines.push_back({ permuteIdString.c_str(), "1" });
-						}
-						else
-						{
-							currentProgramIdString += "-";
-						}
+				for (const auto& currentShader : *deferredShaders)
+				{
+					if (SetPermutationShader(graphicsDriver, currentShader.ShaderType, currentShader.ByteCode, *inPassProgram))
+					{
+						continue;
+					}
 
-						currentProgramIdString += permuteIdString;
-						currentProgramIdString += ']';
+					if (currentShader.IsCached)
+					{
+						// The retry misses the cache, so it only comes back here if freshly compiled bytecode is rejected too
+						DiscardCachedByteCode(*inProgramSource, inProgramId, *currentShader.UsageDescription);
+						CompilePermutationAsync(inProgramSource, inProgramId, inPassProgram);
 					}
+					else
+					{
+						LOG(LogProgramPermutor, Error, "Error: Couldn't create shader for usage of (%s-%s) and program ID of %llu\n", currentShader.UsageDescription->ShaderEntryName.c_str(), currentShader.UsageDescription->ShaderModelName.c_str(), inProgramId);
+					}
+
+					return true;
 				}
-				else
-				{
-					currentProgramIdString += "[NO PERMUTE OPTIONS]";
-				}
-				 
-				programMacroDefines.push_back({ nullptr, nullptr }); // Sentinel value necessary to determine when we are at end of macro define list
-				
-				// For each set of usage descriptions, we need to create a new entry within the output shader permutations
-				outPermutations[currentProgramId] = eastl::make_shared<UPassProgram>();
 
-				for (const auto& currentUsageDescription : inUsageDescriptions)
+				inPassProgram->SetReady();
+				return true;
+			});
+		});
+	}
+
+	void UProgramPermutor::GeneratePermutations(const SProgramSourceDescription& inProgramSource, ProgramPermutations_t& outPermutations, bool inShouldGenPermutationFiles)
+	{
+		UGraphicsDriver& graphicsDriver = gEngine->GetRenderer().GetGraphicsDriver();
+		
+		const size_t numPermuteOptions = inProgramSource.PermuteDescriptions.size();
+		const size_t totalNumPermutations = 0x1ULL << numPermuteOptions;
+
+		// Shaders that are created now. The bytecode is compiled (or read from the cache) in parallel, the shaders and input layouts are created on this thread afterwards
+		struct SPermutationShaderJob
+		{
+			ProgramId_t ProgramId;
+			eastl::string ProgramIdString;
+			const SShaderUsageDescription* UsageDescription;
+			EProgramShaderType ShaderType;
+			eastl::vector<char> ByteCode;
+			bool IsCompiled;
+			bool IsCached;
+		};
+
+		eastl::vector<SPermutationShaderJob> shaderJobs;
+			
+		for (size_t i = 0; i < totalNumPermutations; ++i)
+		{
+			ProgramId_t currentProgramId = 0;
+			eastl::string currentProgramIdString;
+			
+			// Find the bits that are set and mask the associated bit mask with the program ID
+			if (numPermuteOptions > 0)
+			{
+				for (size_t j = 0; j < numPermuteOptions; ++j)
 				{
-					compiledProgramByteCode.clear();
-					
-					// To limit EProgramShaderType to string conversions, we convert at the very last moment
-					// Draw back, we potentially do more than we should to find out its invalid at the end, but that's okay since this will be a pre-build step eventually
-					//auto shaderTypeFindIter = URenderPassProgram::s_entryPointToShaderTypeMap.find(currentUsageDescription.ShaderEntryName);
-					EProgramShaderType usageShaderType = URenderPassProgram::ConvertStringToShaderType(currentUsageDescription.ShaderEntryName);
-
-					if (usageShaderType != EProgramShaderType::EProgramShaderType_Invalid)
+					const eastl::string& permuteIdString = UProgramPermutor::ConvertPIDMaskToString(inProgramSource.PermuteDescriptions[j].PermuteIdMask);
+
+					currentProgramIdString += '[';
+
+					if ((i & (0x1ULL << j)) != 0)
 					{
-						if (graphicsDriver.CompileShaderFromFile(inShaderFilePath, currentUsageDescription.ShaderEntryName, currentUsageDescription.ShaderModelName, compiledProgramByteCode, (programMacroDefines.size() > 1) ? programMacroDefines.data() : nullptr))
-						{
-							eastl::shared_ptr<UPassProgram> currentPassProgram = outPermutations[currentProgramId];
-
-							// Compilation successful (check what type of shader it is so we can set it properly in the program ID entry)
-							switch (usageShaderType)
-							{
-							case EProgramShaderType::EProgramShaderType_VS:
-								currentPassProgram->SetVS(graphicsDriver.CreateVertexShader(compiledProgramByteCode));
-								break;
-							case EProgramShaderType::EProgramShaderType_GS:
-								currentPassProgram->SetGS(graphicsDriver.CreateGeometryShader(compiledProgramByteCode));
-								break;
-							case EProgramShaderType::EProgramShaderType_PS:
-								currentPassProgram->SetPS(graphicsDriver.CreatePixelShader(compiledProgramByteCode));
-								break;
-							}
-
-							//LOG(LogProgramPermutor, Log, "Log: Size of compiled byte code: %d\n", compiledProgramByteCode.size());
-							
-							if (inShouldGenPermutationFiles)
-							{
-								// Stores the generated shader permutation file in the same directory as the shader file that it is permuting
-								eastl::string shaderFilePath = inShaderFilePath;
-								size_t shaderFileNameBeginIndex = shaderFilePath.find_last_of('\\') + 1;
-								size_t shaderFileNameEndIndex = shaderFilePath.find_last_of('.');
-								eastl::string shaderFileName(shaderFilePath.substr(shaderFileNameBeginIndex, shaderFileNameEndIndex - shaderFileNameBeginIndex));
-
-								shaderFilePath.erase(shaderFilePath.find_last_of('\\'), eastl::string::npos);
-
-								GenerateProgramPermutationFile(shaderFilePath, shaderFileName, compiledProgramByteCode, currentUsageDescription, currentProgramId, currentProgramIdString);
-							}
-						}
-						else
-						{
-							LOG(LogProgramPermutor, Error, "Error: Couldn't compile shader for usage of (%s-%s) and program ID of %d\n", currentUsageDescription.ShaderEntryName.c_str(), currentUsageDescription.ShaderModelName.c_str(), currentProgramId);
-						}
+						currentProgramId |= static_cast<ProgramId_t>(inProgramSource.PermuteDescriptions[j].PermuteIdMask);
+
+						currentProgramIdString += '+';
 					}
 					else
 					{
-						LOG(LogProgramPermutor, Error, "Error: Invalid or unsupported shader usage meta flag (%s, %s)\n", currentUsageDescription.ShaderEntryName.c_str(), currentUsageDescription.ShaderModelName.c_str());
+						currentProgramIdString += "-";
 					}
+
+					currentProgramIdString += permuteIdString;
+					currentProgramIdString += ']';
+				}
+			}
+			else
+			{
+				currentProgramIdString += "[NO PERMUTE OPTIONS]";
+			}
+			
+			// For each set of usage descriptions, we need to create a new entry within the output shader permutations
+			outPermutations[currentProgramId] = eastl::make_shared<UPassProgram>();
+
+			bool hasDeferredUsage = false;
+
+			for (const auto& currentUsageDescription : inProgramSource.UsageDescriptions)
+			{
+				// To limit EProgramShaderType to string conversions, we convert at the very last moment
+				EProgramShaderType usageShaderType = URenderPassProgram::ConvertStringToShaderType(currentUsageDescription.ShaderEntryName);
+
+				if (usageShaderType == EProgramShaderType::EProgramShaderType_Invalid)
+				{
+					LOG(LogProgramPermutor, Error, "Error: Invalid or unsupported shader usage meta flag (%s, %s)\n", currentUsageDescription.ShaderEntryName.c_str(), currentUsageDescription.ShaderModelName.c_str());
+					continue;
 				}
+
+				// Permutation files are meant to cover every permutation, so nothing is deferred when they're generated
+				if (!inShouldGenPermutationFiles && IsDeferredUsage(currentProgramId, currentUsageDescription))
+				{
+					hasDeferredUsage = true;
+					continue;
+				}
+
+				shaderJobs.push_back({ currentProgramId, currentProgramIdString, &currentUsageDescription, usageShaderType, eastl::vector<char>(), false, false });
+			}
+
+			if (!hasDeferredUsage)
+			{
+				outPermutations[currentProgramId]->SetReady();
 			}
 		}
+
+		UJobSystem::ParallelFor(static_cast<uint32_t>(shaderJobs.size()), [&inProgramSource, &shaderJobs](uint32_t inJobIndex)
+		{
+			SPermutationShaderJob& currentJob = shaderJobs[inJobIndex];
+			currentJob.IsCompiled = GetPermutationByteCode(inProgramSource, currentJob.ProgramId, *currentJob.UsageDescription, currentJob.ByteCode, currentJob.IsCached);
+		});
+
+		for (auto& currentJob : shaderJobs)
+		{
+			if (!currentJob.IsCompiled)
+			{
+				LOG(LogProgramPermutor, Error, "Error: Couldn't compile shader for usage of (%s-%s) and program ID of %llu\n", currentJob.UsageDescription->ShaderEntryName.c_str(), currentJob.UsageDescription->ShaderModelName.c_str(), currentJob.ProgramId);
+				continue;
+			}
+
+			bool isShaderSet = SetPermutationShader(graphicsDriver, currentJob.ShaderType, currentJob.ByteCode, *outPermutations[currentJob.ProgramId]);
+
+			if (!isShaderSet && currentJob.IsCached)
+			{
+				DiscardCachedByteCode(inProgramSource, currentJob.ProgramId, *currentJob.UsageDescription);
+
+				isShaderSet = CompilePermutationByteCode(inProgramSource, currentJob.ProgramId, *currentJob.UsageDescription, currentJob.ByteCode)
+					&& SetPermutationShader(graphicsDriver, currentJob.ShaderType, currentJob.ByteCode, *outPermutations[currentJob.ProgramId]);
+			}
+
+			if (!isShaderSet)
+			{
+				LOG(LogProgramPermutor, Error, "Error: Couldn't create shader for usage of (%s-%s) and program ID of %llu\n", currentJob.UsageDescription->ShaderEntryName.c_str(), currentJob.UsageDescription->ShaderModelName.c_str(), currentJob.ProgramId);
+				continue;
+			}
+
+			//LOG(LogProgramPermutor, Log, "Log: Size of compiled byte code: %d\n", currentJob.ByteCode.size());
+			
+			if (inShouldGenPermutationFiles)
+			{
+				// Stores the generated shader permutation file in the same directory as the shader file that it is permuting
+				eastl::string shaderFilePath = inProgramSource.ProgramFilePath;
+				size_t shaderFileNameBeginIndex = shaderFilePath.find_last_of('\\') + 1;
+				size_t shaderFileNameEndIndex = shaderFilePath.find_last_of('.');
+				eastl::string shaderFileName(shaderFilePath.substr(shaderFileNameBeginIndex, shaderFileNameEndIndex - shaderFileNameBeginIndex));
+
+				shaderFilePath.erase(shaderFilePath.find_last_of('\\'), eastl::string::npos);
+
+				GenerateProgramPermutationFile(shaderFilePath, shaderFileName, currentJob.ByteCode, *currentJob.UsageDescription, currentJob.ProgramId, currentJob.ProgramIdString);
+			}
+		}
+	}
+
+	bool UProgramPermutor::IsDeferredUsage(ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription)
+	{
+		return (inProgramId & s_deferredPermuteMask) != 0 && URenderPassProgram::ConvertStringToShaderType(inUsageDescription.ShaderEntryName) == EProgramShaderType::EProgramShaderType_PS;
+	}
+
+	bool UProgramPermutor::GetPermutationByteCode(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription, eastl::vector<char>& outByteCode, bool& outIsCached)
+	{
+		const eastl::string cacheFilePath = GetPermutationCachePath(inProgramSource, inProgramId, inUsageDescription);
+
+		std::ifstream cacheInputStream(cacheFilePath.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+
+		outIsCached = false;
+
+		if (cacheInputStream.is_open())
+		{
+			const std::streamoff cachedByteCodeSize = cacheInputStream.tellg();
+
+			if (cachedByteCodeSize > static_cast<std::streamoff>(sizeof(g_shaderByteCodeMagic)))
+			{
+				outByteCode.resize(static_cast<size_t>(cachedByteCodeSize));
+
+				cacheInputStream.seekg(std::ios::beg);
+				cacheInputStream.read(outByteCode.data(), cachedByteCodeSize);
+
+				// Catches the obvious cases early, anything else the device rejects is recompiled when its shader is created
+				if (cacheInputStream && memcmp(outByteCode.data(), g_shaderByteCodeMagic, sizeof(g_shaderByteCodeMagic)) == 0)
+				{
+					outIsCached = true;
+					return true;
+				}
+			}
+
+			cacheInputStream.close();
+		}
+
+		return CompilePermutationByteCode(inProgramSource, inProgramId, inUsageDescription, outByteCode);
+	}
+
+	bool UProgramPermutor::CompilePermutationByteCode(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription, eastl::vector<char>& outByteCode)
+	{
+		eastl::vector<D3D_SHADER_MACRO> programMacroDefines;
+		programMacroDefines.reserve(inProgramSource.PermuteDescriptions.size() + 1);
+
+		for (const auto& currentPermuteOption : inProgramSource.PermuteDescriptions)
+		{
+			if ((inProgramId & static_cast<ProgramId_t>(currentPermuteOption.PermuteIdMask)) != 0)
+			{
+				programMacroDefines.push_back({ UProgramPermutor::ConvertPIDMaskToString(currentPermuteOption.PermuteIdMask).c_str(), "1" });
+			}
+		}
+
+		programMacroDefines.push_back({ nullptr, nullptr }); // Sentinel value necessary to determine when we are at end of macro define list
+
+		// Input layouts are registered when the shader is created on the main thread
+		UGraphicsDriver& graphicsDriver = gEngine->GetRenderer().GetGraphicsDriver();
+		if (!graphicsDriver.CompileShaderFromFile(inProgramSource.ProgramFilePath, inUsageDescription.ShaderEntryName, inUsageDescription.ShaderModelName, outByteCode, (programMacroDefines.size() > 1) ? programMacroDefines.data() : nullptr, false))
+		{
+			return false;
+		}
+
+		// Written next to the entry and then moved over it, so that a crash or another thread mid-write never leaves a torn entry behind
+		const eastl::string cacheFilePath = GetPermutationCachePath(inProgramSource, inProgramId, inUsageDescription);
+		const eastl::string tempFilePath = cacheFilePath + "." + std::to_string(GetCurrentThreadId()).c_str() + ".tmp";
+
+		bool isWritten = false;
+
+		std::ofstream cacheOutputStream(tempFilePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (cacheOutputStream.is_open())
+		{
+			cacheOutputStream.write(outByteCode.data(), outByteCode.size());
+			cacheOutputStream.close();
+
+			isWritten = !cacheOutputStream.fail() && MoveFileExA(tempFilePath.c_str(), cacheFilePath.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+		}
+
+		if (!isWritten)
+		{
+			remove(tempFilePath.c_str());
+
+			LOG(LogProgramPermutor, Warning, "Warning: Couldn't write shader permutation cache file %s\n", cacheFilePath.c_str());
+		}
+
+		return true;
+	}
+
+	void UProgramPermutor::DiscardCachedByteCode(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription)
+	{
+		const eastl::string cacheFilePath = GetPermutationCachePath(inProgramSource, inProgramId, inUsageDescription);
+
+		LOG(LogProgramPermutor, Warning, "Warning: Shader permutation cache file %s was rejected by the device, recompiling it\n", cacheFilePath.c_str());
+
+		remove(cacheFilePath.c_str());
+	}
+
+	eastl::string UProgramPermutor::GetPermutationCachePath(const SProgramSourceDescription& inProgramSource, ProgramId_t inProgramId, const SShaderUsageDescription& inUsageDescription)
+	{
+		uint64_t permutationHash = HashBytes(g_fnvOffsetBasis, &g_permutationCacheVersion, sizeof(g_permutationCacheVersion));
+		permutationHash = HashBytes(permutationHash, &inProgramSource.SourceHash, sizeof(inProgramSource.SourceHash));
+		permutationHash = HashBytes(permutationHash, inUsageDescription.ShaderEntryName.c_str(), inUsageDescription.ShaderEntryName.size() + 1);
+		permutationHash = HashBytes(permutationHash, inUsageDescription.ShaderModelName.c_str(), inUsageDescription.ShaderModelName.size() + 1);
+
+		for (const auto& currentPermuteOption : inProgramSource.PermuteDescriptions)
+		{
+			if ((inProgramId & static_cast<ProgramId_t>(currentPermuteOption.PermuteIdMask)) != 0)
+			{
+				const eastl::string& permuteIdString = UProgramPermutor::ConvertPIDMaskToString(currentPermuteOption.PermuteIdMask);
+				permutationHash = HashBytes(permutationHash, permuteIdString.c_str(), permuteIdString.size() + 1);
+			}
+		}
+
+		const uint32_t compileFlags = UGraphicsDriver::GetShaderCompileFlags();
+		permutationHash = HashBytes(permutationHash, &compileFlags, sizeof(compileFlags));
+
+		char cacheFileName[32];
+		snprintf(cacheFileName, sizeof(cacheFileName), "%016llx.cso", static_cast<unsigned long long>(permutationHash));
+
+		return UAssetCache::GetAssetRoot() + g_permutationCacheDirectory + cacheFileName;
+	}
+
+	bool UProgramPermutor::SetPermutationShader(UGraphicsDriver& inGraphicsDriver, EProgramShaderType inShaderType, const eastl::vector<char>& inByteCode, UPassProgram& inOutPassProgram)
+	{
+		switch (inShaderType)
+		{
+		case EProgramShaderType::EProgramShaderType_VS:
+		{
+			// The input layout is only registered once the device has accepted the bytecode
+			VertexShaderPtr_t vertexShader = inGraphicsDriver.CreateVertexShader(inByteCode);
+			if (!vertexShader)
+			{
+				return false;
+			}
+
+			inGraphicsDriver.RegisterInputLayout(inByteCode);
+			inOutPassProgram.SetVS(vertexShader);
+			return true;
+		}
+		case EProgramShaderType::EProgramShaderType_GS:
+		{
+			GeometryShaderPtr_t geometryShader = inGraphicsDriver.CreateGeometryShader(inByteCode);
+			if (!geometryShader)
+			{
+				return false;
+			}
+
+			inOutPassProgram.SetGS(geometryShader);
+			return true;
+		}
+		case EProgramShaderType::EProgramShaderType_PS:
+		{
+			PixelShaderPtr_t pixelShader = inGraphicsDriver.CreatePixelShader(inByteCode);
+			if (!pixelShader)
+			{
+				return false;
+			}
+
+			inOutPassProgram.SetPS(pixelShader);
+			return true;
+		}
+		}
+
+		return false;
 	}
 
 	void UProgramPermutor::GenerateProgramPermutationFile(const eastl::string& inOutputFilePath, const eastl::string& inProgramFileName, const eastl::vector<char>& inCompiledByteCode, const SShaderUsageDescription& inTargetUsage, ProgramId_t inTargetProgramID, const eastl::string& inTargetProgramStringDesc)
@@ -0,0 +1,83 @@
+#include "Misc/RandomStream.h"
+
+namespace MAD
+{
+	namespace
+	{
+		// Spreads nearby seeds over the whole state, so that seeds 1, 2, 3... don't start out as almost the same streams
+		uint32_t SplitMix(uint32_t& inOutSeed)
+		{
+			uint32_t mixed = (inOutSeed += 0x9e3779b9u);
+			mixed = (mixed ^ (mixed >> 16)) * 0x85ebca6bu;
+			mixed = (mixed ^ (mixed >> 13)) * 0xc2b2ae35u;
+			return mixed ^ (mixed >> 16);
+		}
+	}
+
+	URandomStream::URandomStream(uint32_t inSeed)
+	{
+		Seed(inSeed);
+	}
+
+	void URandomStream::Seed(uint32_t inSeed)
+	{
+		for (__m128i& currentState : m_state)
+		{
+			uint32_t laneStates[4];
+
+			for (uint32_t& currentLaneState : laneStates)
+			{
+				// xorshift never leaves an all zero state
+				do
+				{
+					currentLaneState = SplitMix(inSeed);
+				} while (currentLaneState == 0);
+			}
+
+			currentState = _mm_loadu_si128(reinterpret_cast<const __m128i*>(laneStates));
+		}
+	}
+
+	void URandomStream::GenerateFloats(float* outValues, uint32_t inCount)
+	{
+		const __m128i exponentBits = _mm_set1_epi32(0x3f800000);
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		uint32_t i = 0;
+		for (; i < inCount; i += 4)
+		{
+			// The top 23 bits as the mantissa of a float in [1, 2)
+			const __m128i mantissaBits = _mm_srli_epi32(GenerateBits(), 9);
+			const __m128 values = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(mantissaBits, exponentBits)), one);
+
+			if (inCount - i >= 4)
+			{
+				_mm_storeu_ps(outValues + i, values);
+			}
+			else
+			{
+				float lastValues[4];
+				_mm_storeu_ps(lastValues, values);
+
+				for (uint32_t j = i; j < inCount; ++j)
+				{
+					outValues[j] = lastValues[j - i];
+				}
+			}
+		}
+	}
+
+	__m128i URandomStream::GenerateBits()
+	{
+		const __m128i x = m_state[0];
+		const __m128i w = m_state[3];
+		const __m128i t = _mm_xor_si128(x, _mm_slli_epi32(x, 11));
+
+		m_state[0] = m_state[1];
+		m_state[1] = m_state[2];
+		m_state[2] = w;
+		m_state[3] = _mm_xor_si128(_mm_xor_si128(w, _mm_srli_epi32(w, 19)), _mm_xor_si128(t, _mm_srli_epi32(t, 8)));
+
+		return m_state[3];
+	}
+}
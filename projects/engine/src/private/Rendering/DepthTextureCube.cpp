@@ -69,17 +69,20 @@ namespace MAD
 	}
 
 	void UDepthTextureCube::BindCubeSideAsTarget(uint8_t inCubeSide) const
+	{
+		BindCubeSideAsTarget(URenderContext::Get().GetGraphicsDriver(), inCubeSide);
+	}
+
+	void UDepthTextureCube::BindCubeSideAsTarget(UGraphicsDriver& inGraphicsDriver, uint8_t inCubeSide) const
 	{
 		if (inCubeSide >= m_depthCubeDSVs.size())
 		{
 			return;
 		}
 
-		auto& graphicsDriver = URenderContext::Get().GetGraphicsDriver();
-
-		graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::CubeMap); // If we're binding a cube side as a depth stencil view, we must unbind it as a shader resource
-		graphicsDriver.ClearDepthStencil(m_depthCubeDSVs[inCubeSide], true, 1.0); // Clear the target depth stencil view
-		graphicsDriver.SetRenderTargets(nullptr, 0, m_depthCubeDSVs[inCubeSide]); // Bind the depth stencil view that corresponds with the target cube side
-		graphicsDriver.SetViewport(m_viewPort); // Change the viewport to match texture cube resolution
+		inGraphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::CubeMap); // If we're binding a cube side as a depth stencil view, we must unbind it as a shader resource
+		inGraphicsDriver.ClearDepthStencil(m_depthCubeDSVs[inCubeSide], true, 1.0); // Clear the target depth stencil view
+		inGraphicsDriver.SetRenderTargets(nullptr, 0, m_depthCubeDSVs[inCubeSide]); // Bind the depth stencil view that corresponds with the target cube side
+		inGraphicsDriver.SetViewport(m_viewPort); // Change the viewport to match texture cube resolution
 	}
 }
\ No newline at end of file
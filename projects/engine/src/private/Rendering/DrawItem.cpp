@@ -8,22 +8,103 @@ namespace MAD
 {
 	SDrawItem::SDrawItem()
 		: m_uniqueID(0)
-		, m_previousDrawTransform(nullptr)
+		, m_materialID(0)
 		, m_vertexBufferOffset(0)
 		, m_vertexCount(0)
 		, m_indexOffset(0)
 		, m_indexCount(0)
+		, m_indexSize(sizeof(uint16_t))
+		, m_lodCount(0)
+		, m_boundsRadius(-1.0f)
 		, m_primitiveTopology(EPrimitiveTopology::Undefined) {}
 
-	void SDrawItem::Draw(UGraphicsDriver& inGraphicsDriver, float inFramePercent, const SPerFrameConstants& inPerFrameConstants, bool inBindMaterialProperties, InputLayoutFlags_t inInputLayoutOverride, RasterizerStatePtr_t inRasterStateOverride)
+	void SDrawItem::Draw(UGraphicsDriver& inGraphicsDriver, const SPerFrameConstants& inPerFrameConstants, bool inBindMaterialProperties, InputLayoutFlags_t inInputLayoutOverride, RasterizerStatePtr_t inRasterStateOverride, const SDrawItemConstants* inUploadedConstants, UINT inLOD) const
 	{
-		InputLayoutFlags_t inputLayout = 0;
+		const SMeshLOD lodIndexRange = GetLODIndexRange(inLOD);
+
+		BindInputAssembly(inGraphicsDriver, inInputLayoutOverride, 0, lodIndexRange.m_indexStart);
+
+		UINT updatedBufferCount = 0;
+
+		if (inUploadedConstants && inUploadedConstants->m_perDrawConstants.IsValid())
+		{
+			inGraphicsDriver.BindConstants(EConstantBufferSlot::PerDraw, inUploadedConstants->m_perDrawConstants);
+		}
+		else
+		{
+			// Items drawn outside of the renderer's snapshots aren't interpolated
+			SPerDrawConstants perDrawConstants;
+			CalculatePerDrawConstants(m_transform.GetMatrix(), inPerFrameConstants, perDrawConstants);
+			inGraphicsDriver.UpdateBuffer(EConstantBufferSlot::PerDraw, &perDrawConstants, sizeof(perDrawConstants));
+			++updatedBufferCount;
+		}
+
+		updatedBufferCount += BindMaterialAndRasterState(inGraphicsDriver, inBindMaterialProperties, inRasterStateOverride, inUploadedConstants);
+
+		// Without uploading ahead of time, the per draw constants and every material buffer would've been updated here
+		inGraphicsDriver.AddSkippedDrawMaps(GetUnbatchedUpdateCount(inBindMaterialProperties) - updatedBufferCount);
+
+		if (lodIndexRange.m_indexCount > 0)
+		{
+			inGraphicsDriver.DrawIndexed(lodIndexRange.m_indexCount, 0, 0);
+		}
+		else
+		{
+			inGraphicsDriver.Draw(m_vertexCount, 0);
+		}
+	}
+
+	void SDrawItem::DrawInstanced(UGraphicsDriver& inGraphicsDriver, const SInstanceBufferRange& inInstances, bool inBindMaterialProperties, InputLayoutFlags_t inInputLayoutOverride, RasterizerStatePtr_t inRasterStateOverride, const SDrawItemConstants* inUploadedConstants, UINT inLOD) const
+	{
+		const SMeshLOD lodIndexRange = GetLODIndexRange(inLOD);
+
+		// The object transforms come from the instance stream, so there are no per draw constants to bind
+		BindInputAssembly(inGraphicsDriver, inInputLayoutOverride, EInputLayoutSemantic::Instance, lodIndexRange.m_indexStart);
+		inGraphicsDriver.SetInstanceBuffer(inInstances);
+
+		const UINT updatedBufferCount = BindMaterialAndRasterState(inGraphicsDriver, inBindMaterialProperties, inRasterStateOverride, inUploadedConstants);
+
+		// Each instance would've been a draw of its own
+		inGraphicsDriver.AddSkippedDrawMaps(inInstances.m_instanceCount * GetUnbatchedUpdateCount(inBindMaterialProperties) - updatedBufferCount);
+
+		const int instanceCount = static_cast<int>(inInstances.m_instanceCount);
+
+		if (lodIndexRange.m_indexCount > 0)
+		{
+			inGraphicsDriver.DrawIndexedInstanced(lodIndexRange.m_indexCount, instanceCount, 0, 0, 0);
+		}
+		else
+		{
+			inGraphicsDriver.DrawInstanced(m_vertexCount, instanceCount, 0, 0);
+		}
+	}
+
+	SMeshLOD SDrawItem::GetLODIndexRange(UINT inLOD) const
+	{
+		if (m_lodCount == 0)
+		{
+			return { m_indexOffset, m_indexCount };
+		}
+
+		return m_lods[eastl::min(inLOD, m_lodCount - 1)];
+	}
+
+	void SDrawItem::CalculatePerDrawConstants(const Matrix& inObjectToWorldMatrix, const SPerFrameConstants& inPerFrameConstants, SPerDrawConstants& outPerDrawConstants)
+	{
+		outPerDrawConstants.m_objectToWorldMatrix = inObjectToWorldMatrix;
+		outPerDrawConstants.m_objectToViewMatrix = outPerDrawConstants.m_objectToWorldMatrix * inPerFrameConstants.m_cameraViewMatrix;
+		outPerDrawConstants.m_objectToProjectionMatrix = outPerDrawConstants.m_objectToWorldMatrix * inPerFrameConstants.m_cameraViewProjectionMatrix;
+	}
+
+	void SDrawItem::BindInputAssembly(UGraphicsDriver& inGraphicsDriver, InputLayoutFlags_t inInputLayoutOverride, InputLayoutFlags_t inExtraInputLayoutFlags, UINT inIndexOffset) const
+	{
+		InputLayoutFlags_t inputLayout = inExtraInputLayoutFlags;
 
 		for (const auto& vertexBuffer : m_vertexBuffers)
 		{
 			if (vertexBuffer.GetSemantic() & inInputLayoutOverride)
 			{
-				inputLayout |= vertexBuffer.GetSemantic();
+				inputLayout |= vertexBuffer.GetSemantic() | vertexBuffer.GetFormatFlags();
 				vertexBuffer.Bind(inGraphicsDriver, m_vertexBufferOffset);
 			}
 		}
@@ -32,37 +113,39 @@ namespace MAD
 
 		if (m_indexBuffer)
 		{
-			inGraphicsDriver.SetIndexBuffer(m_indexBuffer, m_indexOffset);
+			inGraphicsDriver.SetIndexBuffer(m_indexBuffer, inIndexOffset, m_indexSize);
 		}
+	}
 
-		SPerDrawConstants perDrawConstants;
-
-		if (m_previousDrawTransform)
-		{
-			// Do interpolation
-			ULinearTransform interpedTransform = ULinearTransform::Lerp(*m_previousDrawTransform, m_transform, inFramePercent);
-			perDrawConstants.m_objectToWorldMatrix = interpedTransform.GetMatrix();
-		}
-		else
-		{
-			perDrawConstants.m_objectToWorldMatrix = m_transform.GetMatrix();
-		}
+	UINT SDrawItem::GetUnbatchedUpdateCount(bool inBindMaterialProperties) const
+	{
+		return 1 + (inBindMaterialProperties ? static_cast<UINT>(m_constantBufferData.size()) : 0);
+	}
 
-		perDrawConstants.m_objectToViewMatrix = perDrawConstants.m_objectToWorldMatrix * inPerFrameConstants.m_cameraViewMatrix;
-		perDrawConstants.m_objectToProjectionMatrix = perDrawConstants.m_objectToWorldMatrix * inPerFrameConstants.m_cameraViewProjectionMatrix;
-		inGraphicsDriver.UpdateBuffer(EConstantBufferSlot::PerDraw, &perDrawConstants, sizeof(perDrawConstants));
+	UINT SDrawItem::BindMaterialAndRasterState(UGraphicsDriver& inGraphicsDriver, bool inBindMaterialProperties, RasterizerStatePtr_t inRasterStateOverride, const SDrawItemConstants* inUploadedConstants) const
+	{
+		UINT updatedBufferCount = 0;
 
 		if (inBindMaterialProperties)
 		{
 			for (const auto& cBufferData : m_constantBufferData)
 			{
 				MAD_ASSERT_DESC(cBufferData.first != EConstantBufferSlot::PerDraw, "PerDraw constants are always updated and shouldn't be here");
-				inGraphicsDriver.UpdateBuffer(cBufferData.first, cBufferData.second.first, cBufferData.second.second);
+
+				if (cBufferData.first == EConstantBufferSlot::PerMaterial && inUploadedConstants && inUploadedConstants->m_perMaterialConstants.IsValid())
+				{
+					inGraphicsDriver.BindConstants(EConstantBufferSlot::PerMaterial, inUploadedConstants->m_perMaterialConstants);
+				}
+				else
+				{
+					inGraphicsDriver.UpdateBuffer(cBufferData.first, cBufferData.second.first, cBufferData.second.second);
+					++updatedBufferCount;
+				}
 			}
 
 			for (const auto& textureData : m_shaderResources)
 			{
-				inGraphicsDriver.SetPixelShaderResource(textureData.second, textureData.first);
+				inGraphicsDriver.SetPixelShaderResource(textureData.second->GetTexureResource(), textureData.first);
 			}
 		}
 
@@ -77,13 +160,6 @@ namespace MAD
 
 		inGraphicsDriver.SetPrimitiveTopology(m_primitiveTopology);
 
-		if (m_indexCount > 0)
-		{
-			inGraphicsDriver.DrawIndexed(m_indexCount, 0, 0);
-		}
-		else
-		{
-			inGraphicsDriver.Draw(m_vertexCount, 0);
-		}
+		return updatedBufferCount;
 	}
 }
@@ -40,9 +40,24 @@ namespace MAD
 
 		// Constant configuration
 		const UINT g_swapChainBufferCount = 3;
+
+		// Deferred drivers start a fresh ring for every command list, so they need a lot less space than the immediate driver
+		const UINT g_immediateConstantRingSize = 4 * 1024 * 1024;
+		const UINT g_deferredConstantRingSize = 1024 * 1024;
+
+		// Initial size of the per-instance vertex stream (in instances), it grows if a frame needs more than this
+		const UINT g_initialInstanceRingCapacity = 16 * 1024;
+
+		// A single constant buffer binding can address at most 4096 constants, so cache pages never need to be larger than that
+		const UINT g_constantCachePageSize = 4096 * 16;
+
+		// Constant buffer offsets have to be multiples of 16 constants
+		const UINT g_constantAllocationAlignment = 256;
+
 		void CreateDevice()
 		{
-			UINT createDeviceFlags = D3D11_CREATE_DEVICE_SINGLETHREADED;
+			// Not single threaded anymore, since render passes are recorded on deferred contexts from the job worker threads
+			UINT createDeviceFlags = 0;
 #ifdef _DEBUG
 			createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
 #endif
@@ -73,6 +88,12 @@ namespace MAD
 			g_d3dEvent.Reset();
 			HR_CHECK(g_d3dDeviceContext.As(&g_d3dEvent), "Failed to get debug event interface");
 #endif
+
+			// The constant ring binds sub-ranges of one big buffer and appends to it with NO_OVERWRITE maps (on deferred contexts as well)
+			D3D11_FEATURE_DATA_D3D11_OPTIONS featureOptions;
+			MEM_ZERO(featureOptions);
+			HR_CHECK(g_d3dDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &featureOptions, sizeof(featureOptions)), "Failed to query D3D 11.1 feature options");
+			MAD_CHECK_DESC(featureOptions.ConstantBufferOffsetting && featureOptions.MapNoOverwriteOnDynamicConstantBuffer, "Device doesn't support constant buffer offsetting");
 		}
 
 		void CreateSwapChain(HWND inWindow)
@@ -114,9 +135,53 @@ namespace MAD
 			g_dxgiSwapChain.Reset();
 			HR_CHECK(swapChain.As(&g_dxgiSwapChain), "Failed to get SwapChain1 as SwapChain2");
 		}
+
+		ShaderResourcePtr_t FinishTextureCreation(HRESULT inResult, const ComPtr<ID3D11Resource>& inTexture, const ShaderResourcePtr_t& inSRV, uint64_t& outWidth, uint64_t& outHeight)
+		{
+			if (FAILED(inResult))
+			{
+				wchar_t* err = nullptr;
+				if (!FormatMessageW(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_MAX_WIDTH_MASK,
+									nullptr,
+									inResult,
+									MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+									reinterpret_cast<LPTSTR>(&err),
+									0,
+									nullptr))
+				{
+					LOG(LogTextureImport, Error, "Unknown error creating texture: [0x%08x]\n", inResult);
+					return nullptr;
+				}
+
+				LOG(LogTextureImport, Error, "Error creating texture: [0x%08x] %ls\n", inResult, err);
+				LocalFree(err);
+				return nullptr;
+			}
+
+			CD3D11_TEXTURE2D_DESC textureDesc;
+			MEM_ZERO(textureDesc);
+			static_cast<ID3D11Texture2D*>(inTexture.Get())->GetDesc(&textureDesc);
+			outWidth = textureDesc.Width;
+			outHeight = textureDesc.Height;
+
+			return inSRV;
+		}
 	}
 
-	UGraphicsDriver::UGraphicsDriver() { }
+	UGraphicsDriver::UGraphicsDriver()
+		: m_isDeferred(false)
+		, m_constantRingSize(0)
+		, m_constantRingOffset(0)
+		, m_constantRingNeedsDiscard(true)
+		, m_constantBatchData(nullptr)
+		, m_constantBatchSize(0)
+		, m_constantBatchEnd(0)
+		, m_instanceRingSize(0)
+		, m_instanceRingOffset(0)
+		, m_instanceRingNeedsDiscard(true)
+		, m_mapCount(0)
+		, m_ringMapCount(0)
+		, m_skippedDrawMapCount(0) { }
 
 	void UGraphicsDriver::CreateBackBufferRenderTargetView()
 	{
@@ -142,11 +207,11 @@ namespace MAD
 		HR_CHECK(g_d3dDevice->CreateRenderTargetView(backBuffer.Get(), &renderTargetDesc, m_backBuffer.GetAddressOf()), "Failed to create render target view from back buffer");
 	}
 
-	void UGraphicsDriver::RegisterInputLayout(ID3DBlob* inTargetBlob)
+	void UGraphicsDriver::RegisterInputLayout(const eastl::vector<char>& inCompiledVSByteCode)
 	{
 		// Reflect shader info
 		ID3D11ShaderReflection* pVertexShaderReflection = nullptr;
-		HR_CHECK(D3DReflect(inTargetBlob->GetBufferPointer(), inTargetBlob->GetBufferSize(), IID_ID3D11ShaderReflection, (void**)&pVertexShaderReflection), "Failed to reflect on the shader");
+		HR_CHECK(D3DReflect(inCompiledVSByteCode.data(), inCompiledVSByteCode.size(), IID_ID3D11ShaderReflection, (void**)&pVertexShaderReflection), "Failed to reflect on the shader");
 		
 		// Get shader info
 		D3D11_SHADER_DESC shaderDesc;
@@ -167,7 +232,7 @@ namespace MAD
 		// Register new Input Layout
 		if (inputLayoutFlags != 0)
 		{
-			HR_CHECK(UInputLayoutCache::RegisterInputLayout(*this, inputLayoutFlags, inTargetBlob->GetBufferPointer(), inTargetBlob->GetBufferSize()),
+			HR_CHECK(UInputLayoutCache::RegisterInputLayout(*this, inputLayoutFlags, inCompiledVSByteCode),
 				"Failed to register input layout reflected from VS shader");
 		}
 	}
@@ -182,50 +247,149 @@ namespace MAD
 		CreateSwapChain(g_nativeWindowHandle);
 		CreateBackBufferRenderTargetView();
 
+		m_deviceContext = g_d3dDeviceContext;
+		m_eventAnnotation = g_d3dEvent;
+		m_isDeferred = false;
+
 		// Initialize our constant buffers
+		CreateConstantBuffers();
+
+		// Only the immediate driver uploads instance data
+		m_instanceRingSize = g_initialInstanceRingCapacity * sizeof(SPerInstanceData);
+		m_instanceRing = CreateVertexBuffer(nullptr, m_instanceRingSize, EResourceUsage::Dynamic, ECPUAccess::Write);
+		ResetInstanceRing();
+
+		// Initialize our samplers
+		m_samplers.resize(AsIntegral(ESamplerSlot::MAX));
+		m_samplers[AsIntegral(ESamplerSlot::Point)] = CreateSamplerState(D3D11_FILTER_MIN_MAG_MIP_POINT);
+		m_samplers[AsIntegral(ESamplerSlot::Linear)] = CreateSamplerState(D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT);
+		m_samplers[AsIntegral(ESamplerSlot::Trilinear)] = CreateSamplerState(D3D11_FILTER_MIN_MAG_MIP_LINEAR);
+		m_samplers[AsIntegral(ESamplerSlot::Anisotropic)] = CreateSamplerState(D3D11_FILTER_ANISOTROPIC, 16);
+		m_samplers[AsIntegral(ESamplerSlot::ShadowMap)] = CreateSamplerState(D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT, 0, D3D11_TEXTURE_ADDRESS_BORDER, Color(1, 1, 1, 1));
+
+		BindConstantBuffersAndSamplers();
+
+		rmt_BindD3D11(g_d3dDevice.Get(), g_d3dDeviceContext.Get());
+
+		LOG(LogGraphicsDevice, Log, "Graphics driver initialization successful\n");
+		return true;
+	}
+
+	bool UGraphicsDriver::InitDeferred(const UGraphicsDriver& inImmediateDriver)
+	{
+		MAD_ASSERT_DESC(!inImmediateDriver.m_isDeferred && inImmediateDriver.m_deviceContext, "Deferred drivers must be created from an initialized immediate driver");
+
+		ComPtr<ID3D11DeviceContext2> deferredContext;
+		if (FAILED(g_d3dDevice->CreateDeferredContext2(0, deferredContext.GetAddressOf())))
+		{
+			LOG(LogGraphicsDevice, Error, "Failed to create deferred device context\n");
+			return false;
+		}
+
+		m_deviceContext = deferredContext;
+		m_isDeferred = true;
+
+#ifdef _DEBUG
+		m_eventAnnotation.Reset();
+		m_deviceContext.As(&m_eventAnnotation);
+#endif
+
+		// Each deferred context gets its own constant buffers, the samplers are immutable so they can be shared
+		CreateConstantBuffers();
+		m_samplers = inImmediateDriver.m_samplers;
+
+		return true;
+	}
+
+	void UGraphicsDriver::CreateConstantBuffers()
+	{
 		m_constantBuffers.resize(AsIntegral(EConstantBufferSlot::MAX));
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerScene)] = CreateConstantBuffer(nullptr, sizeof(SPerSceneConstants));
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerFrame)] = CreateConstantBuffer(nullptr, sizeof(SPerFrameConstants));
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerPointLight)] = CreateConstantBuffer(nullptr, sizeof(SPerPointLightConstants));
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerDirectionalLight)] = CreateConstantBuffer(nullptr, sizeof(SPerDirectionalLightConstants));
-		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerMaterial)] = CreateConstantBuffer(nullptr, sizeof(SPerMaterialConstants));
-		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerDraw)] = CreateConstantBuffer(nullptr, sizeof(SPerDrawConstants));
-		for (unsigned i = 0; i < m_constantBuffers.size(); ++i)
-		{
-			SetVertexConstantBuffer(m_constantBuffers[i], i);
-			SetPixelConstantBuffer(m_constantBuffers[i], i);
-			SetGeometryConstantBuffer(m_constantBuffers[i], i);
-		}
+
+		// PerMaterial and PerDraw constants change every draw, they're always sub-allocated from the constant ring instead
+		m_constantRingSize = m_isDeferred ? g_deferredConstantRingSize : g_immediateConstantRingSize;
+		m_constantRing = CreateConstantBuffer(nullptr, m_constantRingSize);
+		ResetConstantRing();
 
 #ifdef _DEBUG
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerScene)]->SetPrivateData(WKPDID_D3DDebugObjectName, 8, "PerScene");
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerFrame)]->SetPrivateData(WKPDID_D3DDebugObjectName, 8, "PerFrame");
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerPointLight)]->SetPrivateData(WKPDID_D3DDebugObjectName, 13, "PerPointLight");
 		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerDirectionalLight)]->SetPrivateData(WKPDID_D3DDebugObjectName, 19, "PerDirectionalLight");
-		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerMaterial)]->SetPrivateData(WKPDID_D3DDebugObjectName, 11, "PerMaterial");
-		m_constantBuffers[AsIntegral(EConstantBufferSlot::PerDraw)]->SetPrivateData(WKPDID_D3DDebugObjectName, 7, "PerDraw");
+		m_constantRing->SetPrivateData(WKPDID_D3DDebugObjectName, 12, "ConstantRing");
 #endif
+	}
+
+	void UGraphicsDriver::BindConstantBuffersAndSamplers() const
+	{
+		for (unsigned i = 0; i < m_constantBuffers.size(); ++i)
+		{
+			if (!m_constantBuffers[i])
+			{
+				continue;
+			}
+
+			SetVertexConstantBuffer(m_constantBuffers[i], i);
+			SetPixelConstantBuffer(m_constantBuffers[i], i);
+			SetGeometryConstantBuffer(m_constantBuffers[i], i);
+		}
 
-		// Initialize our samplers
-		m_samplers.resize(AsIntegral(ESamplerSlot::MAX));
-		m_samplers[AsIntegral(ESamplerSlot::Point)] = CreateSamplerState(D3D11_FILTER_MIN_MAG_MIP_POINT);
-		m_samplers[AsIntegral(ESamplerSlot::Linear)] = CreateSamplerState(D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT);
-		m_samplers[AsIntegral(ESamplerSlot::Trilinear)] = CreateSamplerState(D3D11_FILTER_MIN_MAG_MIP_LINEAR);
-		m_samplers[AsIntegral(ESamplerSlot::Anisotropic)] = CreateSamplerState(D3D11_FILTER_ANISOTROPIC, 16);
-		m_samplers[AsIntegral(ESamplerSlot::ShadowMap)] = CreateSamplerState(D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT, 0, D3D11_TEXTURE_ADDRESS_BORDER, Color(1, 1, 1, 1));
 		for (unsigned i = 0; i < m_samplers.size(); ++i)
 		{
 			SetPixelSamplerState(m_samplers[i], i);
 		}
+	}
 
-		rmt_BindD3D11(g_d3dDevice.Get(), g_d3dDeviceContext.Get());
+	void UGraphicsDriver::BeginCommandList()
+	{
+		MAD_ASSERT_DESC(m_isDeferred, "Only deferred drivers record command lists");
+		BindConstantBuffersAndSamplers();
 
-		LOG(LogGraphicsDevice, Log, "Graphics driver initialization successful\n");
-		return true;
+		// Deferred contexts have to discard a dynamic buffer before the first NO_OVERWRITE map of each command list
+		ResetConstantRing();
+	}
+
+	CommandListPtr_t UGraphicsDriver::FinishCommandList() const
+	{
+		MAD_ASSERT_DESC(m_isDeferred, "Only deferred drivers record command lists");
+
+		CommandListPtr_t commandList;
+		HR_CHECK(m_deviceContext->FinishCommandList(FALSE, commandList.GetAddressOf()), "Failed to finish recording command list");
+
+		return commandList;
+	}
+
+	void UGraphicsDriver::ExecuteCommandList(CommandListPtr_t inCommandList) const
+	{
+		MAD_ASSERT_DESC(!m_isDeferred, "Command lists can only be executed on the immediate context");
+
+		if (inCommandList)
+		{
+			// Restore our state afterwards since the rest of the frame still relies on what's bound on the immediate context
+			m_deviceContext->ExecuteCommandList(inCommandList.Get(), TRUE);
+		}
 	}
 
 	void UGraphicsDriver::Shutdown()
 	{
+		m_constantRing.Reset();
+		m_instanceRing.Reset();
+		m_constantCachePages.clear();
+		m_cachedConstants.clear();
+		m_freeCachedConstants.clear();
+
+		if (m_isDeferred)
+		{
+			m_constantBuffers.clear();
+			m_samplers.clear();
+			m_eventAnnotation.Reset();
+			m_deviceContext.Reset();
+			return;
+		}
+
 		rmt_UnbindD3D11();
 
 		if (g_d3dDeviceContext)
@@ -234,6 +398,9 @@ namespace MAD
 			g_d3dDeviceContext->Flush();
 		}
 
+		m_eventAnnotation.Reset();
+		m_deviceContext.Reset();
+
 		g_dxgiSwapChain.Reset();
 		g_d3dDeviceContext.Reset();
 		g_d3dDevice.Reset();
@@ -293,36 +460,53 @@ namespace MAD
 			return nullptr;
 		}
 
-		if (FAILED(hr))
+		return FinishTextureCreation(hr, texture, srv, outWidth, outHeight);
+	}
+
+	ShaderResourcePtr_t UGraphicsDriver::CreateTextureFromMemory(const void* inData, size_t inDataSize, const eastl::string& inExtension, uint64_t& outWidth, uint64_t& outHeight, bool inForceSRGB, bool inGenerateMips, int32_t inMiscFlags, size_t inMaxSize) const
+	{
+		auto extension = inExtension;
+		extension.make_lower();
+
+		const uint8_t* data = static_cast<const uint8_t*>(inData);
+
+		ShaderResourcePtr_t srv;
+		ComPtr<ID3D11Resource> texture;
+
+		HRESULT hr;
+		if (extension == ".dds")
+		{
+			if (inGenerateMips)
+			{
+				hr = DirectX::CreateDDSTextureFromMemoryEx(g_d3dDevice.Get(), g_d3dDeviceContext.Get(), data, inDataSize, inMaxSize, static_cast<D3D11_USAGE>(EResourceUsage::Default), AsIntegral(EBindFlag::ShaderResource), 0, inMiscFlags, inForceSRGB, texture.GetAddressOf(), srv.GetAddressOf());
+			}
+			else
+			{
+				hr = DirectX::CreateDDSTextureFromMemoryEx(g_d3dDevice.Get(), data, inDataSize, inMaxSize, static_cast<D3D11_USAGE>(EResourceUsage::Immutable), AsIntegral(EBindFlag::ShaderResource), 0, inMiscFlags, inForceSRGB, texture.GetAddressOf(), srv.GetAddressOf());
+			}
+		}
+		else if (extension == ".png" || extension == ".bmp" || extension == ".jpeg" || extension == ".jpg" || extension == ".tif" || extension == ".tiff")
 		{
-			wchar_t* err = nullptr;
-			if (!FormatMessageW(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_MAX_WIDTH_MASK,
-								nullptr,
-								hr,
-								MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-								reinterpret_cast<LPTSTR>(&err),
-								0,
-								nullptr))
+			DirectX::WIC_LOADER_FLAGS flags = inForceSRGB ? DirectX::WIC_LOADER_FORCE_SRGB : DirectX::WIC_LOADER_DEFAULT;
+			if (inGenerateMips)
 			{
-				LOG(LogTextureImport, Error, "Unknown error creating texture from file: [0x%08x]\n", hr);
-				return nullptr;
+				hr = DirectX::CreateWICTextureFromMemoryEx(g_d3dDevice.Get(), g_d3dDeviceContext.Get(), data, inDataSize, 0, static_cast<D3D11_USAGE>(EResourceUsage::Default), AsIntegral(EBindFlag::ShaderResource), 0, inMiscFlags, flags, texture.GetAddressOf(), srv.GetAddressOf());
 			}
-
-			LOG(LogTextureImport, Error, "Error creating texture from file: [0x%08x] %ls\n", hr, err);
-			LocalFree(err);
+			else
+			{
+				hr = DirectX::CreateWICTextureFromMemoryEx(g_d3dDevice.Get(), data, inDataSize, 0, static_cast<D3D11_USAGE>(EResourceUsage::Immutable), AsIntegral(EBindFlag::ShaderResource), 0, inMiscFlags, flags, texture.GetAddressOf(), srv.GetAddressOf());
+			}
+		}
+		else
+		{
+			LOG(LogTextureImport, Error, "Can only load textures of type DDS, PNG, JPG (JPEG), or BMP\n");
 			return nullptr;
 		}
 
-		CD3D11_TEXTURE2D_DESC textureDesc;
-		MEM_ZERO(textureDesc);
-		static_cast<ID3D11Texture2D*>(texture.Get())->GetDesc(&textureDesc);
-		outWidth = textureDesc.Width;
-		outHeight = textureDesc.Height;
-
-		return srv;
+		return FinishTextureCreation(hr, texture, srv, outWidth, outHeight);
 	}
 
-	bool UGraphicsDriver::CompileShaderFromFile(const eastl::string& inFileName, const eastl::string& inShaderEntryPoint, const eastl::string& inShaderModel, eastl::vector<char>& inOutCompileByteCode, const D3D_SHADER_MACRO* inShaderMacroDefines)
+	uint32_t UGraphicsDriver::GetShaderCompileFlags()
 	{
 		DWORD dwShaderFlags = D3DCOMPILE_ENABLE_STRICTNESS;
 #ifdef _DEBUG
@@ -339,12 +523,17 @@ namespace MAD
 		dwShaderFlags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
 #endif
 
+		return dwShaderFlags;
+	}
+
+	bool UGraphicsDriver::CompileShaderFromFile(const eastl::string& inFileName, const eastl::string& inShaderEntryPoint, const eastl::string& inShaderModel, eastl::vector<char>& inOutCompileByteCode, const D3D_SHADER_MACRO* inShaderMacroDefines, bool inRegisterInputLayout)
+	{
 		eastl::wstring wideName = utf8util::UTF16FromUTF8(inFileName);
 
 		ID3DBlob* pErrorBlob = nullptr;
 		ID3DBlob* pBlobOut = nullptr;
 		HRESULT hr = D3DCompileFromFile(wideName.c_str(), inShaderMacroDefines, D3D_COMPILE_STANDARD_FILE_INCLUDE, inShaderEntryPoint.c_str(), inShaderModel.c_str(),
-			dwShaderFlags, 0, &pBlobOut, &pErrorBlob);
+			GetShaderCompileFlags(), 0, &pBlobOut, &pErrorBlob);
 
 		if (FAILED(hr))
 		{
@@ -368,17 +557,17 @@ namespace MAD
 
 		if (pBlobOut)
 		{
-			// Before releasing the blob, reflect the input layout from the shader (if vertex shader)
-			if (inShaderModel.substr(0, 2) == "vs")
-			{
-				RegisterInputLayout(pBlobOut);
-			}
-
 			size_t compiledCodeSize = pBlobOut->GetBufferSize();
 			inOutCompileByteCode.resize(compiledCodeSize);
 			std::memcpy(inOutCompileByteCode.data(), pBlobOut->GetBufferPointer(), compiledCodeSize);
 
 			pBlobOut->Release();
+
+			// Reflect the input layout from the shader (if vertex shader)
+			if (inRegisterInputLayout && inShaderModel.substr(0, 2) == "vs")
+			{
+				RegisterInputLayout(inOutCompileByteCode);
+			}
 		}
 
 		return hr == S_OK;
@@ -389,7 +578,10 @@ namespace MAD
 	{
 		VertexShaderPtr_t vertexShaderPtr;
 
-		DX_HRESULT(g_d3dDevice->CreateVertexShader(inCompiledVSByteCode.data(), inCompiledVSByteCode.size(), nullptr, vertexShaderPtr.GetAddressOf()), "Failure Creating Vertex Shader From Compiled Shader Code");
+		if (FAILED(g_d3dDevice->CreateVertexShader(inCompiledVSByteCode.data(), inCompiledVSByteCode.size(), nullptr, vertexShaderPtr.GetAddressOf())))
+		{
+			LOG(LogGraphicsDevice, Warning, "Failed to create a vertex shader from compiled shader code\n");
+		}
 
 		return vertexShaderPtr;
 	}
@@ -398,7 +590,10 @@ namespace MAD
 	{
 		PixelShaderPtr_t pixelShaderPtr;
 
-		DX_HRESULT(g_d3dDevice->CreatePixelShader(inCompiledPSByteCode.data(), inCompiledPSByteCode.size(), nullptr, pixelShaderPtr.GetAddressOf()), "Failure Creating Pixel Shader from Compiled Shader Code");
+		if (FAILED(g_d3dDevice->CreatePixelShader(inCompiledPSByteCode.data(), inCompiledPSByteCode.size(), nullptr, pixelShaderPtr.GetAddressOf())))
+		{
+			LOG(LogGraphicsDevice, Warning, "Failed to create a pixel shader from compiled shader code\n");
+		}
 
 		return pixelShaderPtr;
 	}
@@ -407,7 +602,10 @@ namespace MAD
 	{
 		GeometryShaderPtr_t geometryShaderPtr;
 
-		DX_HRESULT(g_d3dDevice->CreateGeometryShader(inCompiledGSByteCode.data(), inCompiledGSByteCode.size(), nullptr, geometryShaderPtr.GetAddressOf()), "Failure Creating Geometry Shader from Compiled Shader Code");
+		if (FAILED(g_d3dDevice->CreateGeometryShader(inCompiledGSByteCode.data(), inCompiledGSByteCode.size(), nullptr, geometryShaderPtr.GetAddressOf())))
+		{
+			LOG(LogGraphicsDevice, Warning, "Failed to create a geometry shader from compiled shader code\n");
+		}
 
 		return geometryShaderPtr;
 	}
@@ -659,14 +857,14 @@ namespace MAD
 		return rasterizerStatePtr;
 	}
 
-	RasterizerStatePtr_t UGraphicsDriver::CreateDepthRasterizerState() const
+	RasterizerStatePtr_t UGraphicsDriver::CreateDepthRasterizerState(bool inEnableDepthClip) const
 	{
 		D3D11_RASTERIZER_DESC1 rasterDesc;
 		MEM_ZERO(rasterDesc);
 		rasterDesc.FillMode = static_cast<D3D11_FILL_MODE>(EFillMode::Solid);
 		rasterDesc.CullMode = static_cast<D3D11_CULL_MODE>(ECullMode::Back);
 		rasterDesc.FrontCounterClockwise = true;
-		rasterDesc.DepthClipEnable = true;
+		rasterDesc.DepthClipEnable = inEnableDepthClip;
 		rasterDesc.DepthBias = 10000;
 		rasterDesc.DepthBiasClamp = 0.0f;
 		rasterDesc.SlopeScaledDepthBias = 1.5f;
@@ -742,19 +940,21 @@ namespace MAD
 		return CreateBuffer(inData, inDataSize, EResourceUsage::Dynamic, EBindFlag::ConstantBuffer, ECPUAccess::Write);
 	}
 
-	void* UGraphicsDriver::MapBuffer(BufferPtr_t inBuffer) const
+	void* UGraphicsDriver::MapBuffer(BufferPtr_t inBuffer, EResourceMap inMapType) const
 	{
 		MAD_ASSERT_DESC(inBuffer, "Invalid buffer");
 
+		++m_mapCount;
+
 		D3D11_MAPPED_SUBRESOURCE subResource;
-		g_d3dDeviceContext->Map(inBuffer.Get(), 0, static_cast<D3D11_MAP>(EResourceMap::WriteDiscard), 0, &subResource);
+		m_deviceContext->Map(inBuffer.Get(), 0, static_cast<D3D11_MAP>(inMapType), 0, &subResource);
 		return subResource.pData;
 	}
 
 	void UGraphicsDriver::UnmapBuffer(BufferPtr_t inBuffer) const
 	{
 		MAD_ASSERT_DESC(inBuffer, "Invalid buffer");
-		g_d3dDeviceContext->Unmap(inBuffer.Get(), 0);
+		m_deviceContext->Unmap(inBuffer.Get(), 0);
 	}
 
 	void UGraphicsDriver::UpdateBuffer(BufferPtr_t inBuffer, const void* inData, size_t inDataSize) const
@@ -764,12 +964,306 @@ namespace MAD
 		UnmapBuffer(inBuffer);
 	}
 
-	void UGraphicsDriver::UpdateBuffer(EConstantBufferSlot inSlot, const void* inData, size_t inDataSize) const
+	void UGraphicsDriver::UpdateBuffer(EConstantBufferSlot inSlot, const void* inData, size_t inDataSize)
 	{
 		MAD_ASSERT_DESC(AsIntegral(inSlot) < AsIntegral(EConstantBufferSlot::MAX), "Invalid EConstantBufferSlot");
+
+		if (!m_constantBuffers[AsIntegral(inSlot)])
+		{
+			BindConstants(inSlot, AllocateConstants(inData, static_cast<UINT>(inDataSize)));
+			return;
+		}
+
 		UpdateBuffer(m_constantBuffers[AsIntegral(inSlot)], inData, inDataSize);
 	}
 
+	UINT UGraphicsDriver::GetConstantAllocationSize(UINT inDataSize)
+	{
+		return (inDataSize + g_constantAllocationAlignment - 1) & ~(g_constantAllocationAlignment - 1);
+	}
+
+	void UGraphicsDriver::ResetConstantRing()
+	{
+		MAD_ASSERT_DESC(!m_constantBatchData, "Can't reset the constant ring while a constant batch is open");
+
+		m_constantRingOffset = 0;
+		m_constantRingNeedsDiscard = true;
+
+		// Whatever was bound from the outgrown rings has executed by now
+		m_retiredConstantRings.clear();
+	}
+
+	void UGraphicsDriver::ReserveConstantRing(UINT inDataSize)
+	{
+		MAD_ASSERT_DESC(!m_constantBatchData, "Can't grow the constant ring while a constant batch is open");
+
+		if (m_constantRingOffset + inDataSize > m_constantRingSize)
+		{
+			GrowConstantRing(inDataSize);
+		}
+	}
+
+	void UGraphicsDriver::GrowConstantRing(UINT inMinSize)
+	{
+		m_retiredConstantRings.push_back(m_constantRing);
+
+		m_constantRingSize = eastl::max(inMinSize, 2 * m_constantRingSize);
+		m_constantRing = CreateConstantBuffer(nullptr, m_constantRingSize);
+		m_constantRingOffset = 0;
+		m_constantRingNeedsDiscard = true;
+
+#ifdef _DEBUG
+		m_constantRing->SetPrivateData(WKPDID_D3DDebugObjectName, 12, "ConstantRing");
+#endif
+
+		LOG(LogGraphicsDevice, Log, "Growing constant ring to %u bytes\n", m_constantRingSize);
+	}
+
+	void UGraphicsDriver::BeginConstantBatch(UINT inMaxDataSize)
+	{
+		MAD_ASSERT_DESC(!m_constantBatchData, "A constant batch is already open");
+
+		const UINT batchSize = GetConstantAllocationSize(inMaxDataSize);
+
+		// Wrapping around would discard allocations that command lists recorded this frame may still read
+		if (m_constantRingOffset + batchSize > m_constantRingSize)
+		{
+			GrowConstantRing(batchSize);
+		}
+
+		EResourceMap mapType = EResourceMap::WriteNoOverwrite;
+
+		if (m_constantRingNeedsDiscard)
+		{
+			mapType = EResourceMap::WriteDiscard;
+			m_constantRingOffset = 0;
+			m_constantRingNeedsDiscard = false;
+		}
+
+		m_constantBatchData = static_cast<uint8_t*>(MapBuffer(m_constantRing, mapType));
+		++m_ringMapCount;
+		m_constantBatchSize = batchSize;
+		m_constantBatchEnd = m_constantRingOffset + batchSize;
+	}
+
+	SConstantBufferRange UGraphicsDriver::PushConstants(const void* inData, UINT inDataSize)
+	{
+		MAD_ASSERT_DESC(m_constantBatchData, "Constants can only be pushed inside of a constant batch");
+
+		const UINT allocationSize = GetConstantAllocationSize(inDataSize);
+
+		if (m_constantRingOffset + allocationSize > m_constantBatchEnd)
+		{
+			// The batch reserved too little, carry on in a new one instead of writing past the end of the mapped range
+			const UINT batchSize = eastl::max(m_constantBatchSize, allocationSize);
+
+			EndConstantBatch();
+			BeginConstantBatch(batchSize);
+		}
+
+		SConstantBufferRange allocatedRange;
+		allocatedRange.m_buffer = m_constantRing;
+		allocatedRange.m_offset = m_constantRingOffset;
+		allocatedRange.m_size = allocationSize;
+
+		memcpy(m_constantBatchData + allocatedRange.m_offset, inData, inDataSize);
+		m_constantRingOffset += allocatedRange.m_size;
+
+		return allocatedRange;
+	}
+
+	void UGraphicsDriver::EndConstantBatch()
+	{
+		MAD_ASSERT_DESC(m_constantBatchData, "No constant batch is open");
+
+		UnmapBuffer(m_constantRing);
+		m_constantBatchData = nullptr;
+		m_constantBatchSize = 0;
+		m_constantBatchEnd = 0;
+	}
+
+	SConstantBufferRange UGraphicsDriver::AllocateConstants(const void* inData, UINT inDataSize)
+	{
+		// Piggyback on the open batch if there's still room in it
+		if (m_constantBatchData && m_constantRingOffset + GetConstantAllocationSize(inDataSize) <= m_constantBatchEnd)
+		{
+			return PushConstants(inData, inDataSize);
+		}
+
+		BeginConstantBatch(inDataSize);
+		SConstantBufferRange allocatedRange = PushConstants(inData, inDataSize);
+		EndConstantBatch();
+
+		return allocatedRange;
+	}
+
+	void UGraphicsDriver::BindConstants(EConstantBufferSlot inSlot, const SConstantBufferRange& inRange) const
+	{
+		MAD_ASSERT_DESC(inRange.IsValid(), "Invalid constant buffer range");
+
+		const UINT slot = AsIntegral(inSlot);
+
+		SetVertexConstantBuffer(inRange.m_buffer, slot, inRange.m_offset, inRange.m_size);
+		SetPixelConstantBuffer(inRange.m_buffer, slot, inRange.m_offset, inRange.m_size);
+		SetGeometryConstantBuffer(inRange.m_buffer, slot, inRange.m_offset, inRange.m_size);
+	}
+
+	void UGraphicsDriver::ResetInstanceRing()
+	{
+		m_instanceRingOffset = 0;
+		m_instanceRingNeedsDiscard = true;
+	}
+
+	SInstanceBufferRange UGraphicsDriver::UploadInstanceData(const SPerInstanceData* inInstanceData, UINT inInstanceCount)
+	{
+		MAD_ASSERT_DESC(!m_isDeferred, "Instance data can only be uploaded on the immediate driver");
+
+		const UINT dataSize = inInstanceCount * sizeof(SPerInstanceData);
+
+		EResourceMap mapType = EResourceMap::WriteNoOverwrite;
+
+		if (m_instanceRingNeedsDiscard || m_instanceRingOffset + dataSize > m_instanceRingSize)
+		{
+			if (!m_instanceRingNeedsDiscard)
+			{
+				LOG(LogGraphicsDevice, Warning, "Instance ring overflowed (%u bytes), wrapping around\n", m_instanceRingSize);
+			}
+
+			if (dataSize > m_instanceRingSize)
+			{
+				// Grow to fit, the old buffer stays alive for as long as anything still references it
+				m_instanceRingSize = eastl::max(dataSize, 2 * m_instanceRingSize);
+				m_instanceRing = CreateVertexBuffer(nullptr, m_instanceRingSize, EResourceUsage::Dynamic, ECPUAccess::Write);
+
+				LOG(LogGraphicsDevice, Log, "Growing instance ring to %u bytes\n", m_instanceRingSize);
+			}
+
+			mapType = EResourceMap::WriteDiscard;
+			m_instanceRingOffset = 0;
+			m_instanceRingNeedsDiscard = false;
+		}
+
+		SInstanceBufferRange uploadedRange;
+		uploadedRange.m_buffer = m_instanceRing;
+		uploadedRange.m_offset = m_instanceRingOffset;
+		uploadedRange.m_instanceCount = inInstanceCount;
+
+		uint8_t* ringData = static_cast<uint8_t*>(MapBuffer(m_instanceRing, mapType));
+		++m_ringMapCount;
+		memcpy(ringData + m_instanceRingOffset, inInstanceData, dataSize);
+		UnmapBuffer(m_instanceRing);
+
+		m_instanceRingOffset += dataSize;
+
+		return uploadedRange;
+	}
+
+	void UGraphicsDriver::SetInstanceBuffer(const SInstanceBufferRange& inInstances) const
+	{
+		const UINT instanceStride = sizeof(SPerInstanceData);
+		m_deviceContext->IASetVertexBuffers(AsIntegral(EVertexBufferSlot::Instance), 1, inInstances.m_buffer.p.GetAddressOf(), &instanceStride, &inInstances.m_offset);
+	}
+
+	SConstantBufferRange UGraphicsDriver::CacheConstants(uint32_t inKey, const void* inData, UINT inDataSize)
+	{
+		MAD_ASSERT_DESC(!m_isDeferred, "Cached constants can only be created on the immediate driver");
+
+		const UINT allocationSize = GetConstantAllocationSize(inDataSize);
+
+		auto cachedIter = m_cachedConstants.find(inKey);
+		if (cachedIter != m_cachedConstants.end())
+		{
+			if (cachedIter->second.m_range.m_size == allocationSize)
+			{
+				SConstantCachePage& cachedPage = m_constantCachePages[cachedIter->second.m_pageIndex];
+				uint8_t* cachedData = cachedPage.m_shadowData.data() + cachedIter->second.m_range.m_offset;
+
+				// Only re-upload if the contents actually changed
+				if (memcmp(cachedData, inData, inDataSize) != 0)
+				{
+					memcpy(cachedData, inData, inDataSize);
+					cachedPage.m_isDirty = true;
+				}
+
+				return cachedIter->second.m_range;
+			}
+
+			// The data changed size, its old range can go to someone else
+			m_freeCachedConstants.push_back(cachedIter->second);
+			m_cachedConstants.erase(cachedIter);
+		}
+
+		MAD_ASSERT_DESC(allocationSize <= g_constantCachePageSize, "Cached constants are larger than a constant cache page");
+
+		SCachedConstants newCachedConstants;
+
+		// Almost everything cached is a material, so freed ranges nearly always fit the next one exactly
+		auto freeIter = eastl::find_if(m_freeCachedConstants.begin(), m_freeCachedConstants.end(), [allocationSize](const SCachedConstants& inFreeConstants)
+		{
+			return inFreeConstants.m_range.m_size == allocationSize;
+		});
+
+		if (freeIter != m_freeCachedConstants.end())
+		{
+			newCachedConstants = *freeIter;
+
+			*freeIter = m_freeCachedConstants.back();
+			m_freeCachedConstants.pop_back();
+		}
+		else
+		{
+			if (m_constantCachePages.empty() || m_constantCachePages.back().m_usedSize + allocationSize > g_constantCachePageSize)
+			{
+				SConstantCachePage newPage;
+				newPage.m_buffer = CreateBuffer(nullptr, g_constantCachePageSize, EResourceUsage::Default, EBindFlag::ConstantBuffer, ECPUAccess::None);
+				newPage.m_shadowData.resize(g_constantCachePageSize, 0);
+
+				m_constantCachePages.push_back(newPage);
+			}
+
+			const uint32_t pageIndex = static_cast<uint32_t>(m_constantCachePages.size() - 1);
+			SConstantCachePage& targetPage = m_constantCachePages[pageIndex];
+
+			newCachedConstants.m_pageIndex = pageIndex;
+			newCachedConstants.m_range.m_buffer = targetPage.m_buffer;
+			newCachedConstants.m_range.m_offset = targetPage.m_usedSize;
+			newCachedConstants.m_range.m_size = allocationSize;
+
+			targetPage.m_usedSize += allocationSize;
+		}
+
+		SConstantCachePage& targetPage = m_constantCachePages[newCachedConstants.m_pageIndex];
+		memcpy(targetPage.m_shadowData.data() + newCachedConstants.m_range.m_offset, inData, inDataSize);
+		targetPage.m_isDirty = true;
+
+		m_cachedConstants[inKey] = newCachedConstants;
+		return newCachedConstants.m_range;
+	}
+
+	void UGraphicsDriver::ReleaseCachedConstants(uint32_t inKey)
+	{
+		auto cachedIter = m_cachedConstants.find(inKey);
+		if (cachedIter == m_cachedConstants.end())
+		{
+			return;
+		}
+
+		m_freeCachedConstants.push_back(cachedIter->second);
+		m_cachedConstants.erase(cachedIter);
+	}
+
+	void UGraphicsDriver::FlushCachedConstants()
+	{
+		for (auto& currentPage : m_constantCachePages)
+		{
+			if (currentPage.m_isDirty)
+			{
+				m_deviceContext->UpdateSubresource(currentPage.m_buffer.Get(), 0, nullptr, currentPage.m_shadowData.data(), 0, 0);
+				currentPage.m_isDirty = false;
+			}
+		}
+	}
+
 	void UGraphicsDriver::SetViewport(float inX, float inY, float inWidth, float inHeight) const
 	{
 		D3D11_VIEWPORT vp;
@@ -780,12 +1274,12 @@ namespace MAD
 		vp.MinDepth = 0.0f;
 		vp.MaxDepth = 1.0f;
 
-		g_d3dDeviceContext->RSSetViewports(1, &vp);
+		m_deviceContext->RSSetViewports(1, &vp);
 	}
 
 	void UGraphicsDriver::SetViewport(const SGraphicsViewport& inViewPort) const
 	{
-		g_d3dDeviceContext->RSSetViewports(1, &inViewPort);
+		m_deviceContext->RSSetViewports(1, &inViewPort);
 	}
 
 	void UGraphicsDriver::SetRenderTargets(const RenderTargetPtr_t* inRenderTargets, int inNumRenderTargets, const DepthStencilPtr_t inOptionalDepthStencil) const
@@ -815,59 +1309,60 @@ namespace MAD
 			depthStencil = inOptionalDepthStencil.p.Get(); // can't call Get() directly because of const issues (can't assign a const pointer to a non-const pointer)
 		}
 
-		g_d3dDeviceContext->OMSetRenderTargets(inNumRenderTargets, renderTargets, depthStencil);
+		m_deviceContext->OMSetRenderTargets(inNumRenderTargets, renderTargets, depthStencil);
 	}
 
 	void UGraphicsDriver::SetDepthStencilState(DepthStencilStatePtr_t inDepthStencilState, UINT inStencilRef) const
 	{
 		// Doesn't require any null checks because setting a null depth stencil state will force the use of the default depth stencil state
-		g_d3dDeviceContext->OMSetDepthStencilState(inDepthStencilState.Get(), inStencilRef);
+		m_deviceContext->OMSetDepthStencilState(inDepthStencilState.Get(), inStencilRef);
 	}
 
 	void UGraphicsDriver::SetInputLayout(InputLayoutPtr_t inInputLayout) const
 	{
 		MAD_ASSERT_DESC(inInputLayout != nullptr, "Invalid input layout");
-		g_d3dDeviceContext->IASetInputLayout(inInputLayout.Get());
+		m_deviceContext->IASetInputLayout(inInputLayout.Get());
 	}
 
 	void UGraphicsDriver::SetPrimitiveTopology(EPrimitiveTopology inPrimitiveTopology) const
 	{
-		g_d3dDeviceContext->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(inPrimitiveTopology));
+		m_deviceContext->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(inPrimitiveTopology));
 	}
 
 	void UGraphicsDriver::SetVertexBuffer(BufferPtr_t inVertexBuffer, VertexBufferSlotType_t inVertexSlot, UINT inVertexSize, UINT inVertexOffset) const
 	{
 		UINT byteOffset = inVertexOffset * inVertexSize;
-		g_d3dDeviceContext->IASetVertexBuffers(inVertexSlot, 1, inVertexBuffer.GetAddressOf(), &inVertexSize, &byteOffset);
+		m_deviceContext->IASetVertexBuffers(inVertexSlot, 1, inVertexBuffer.GetAddressOf(), &inVertexSize, &byteOffset);
 	}
 
-	void UGraphicsDriver::SetIndexBuffer(BufferPtr_t inIndexBuffer, UINT inIndexOffset) const
+	void UGraphicsDriver::SetIndexBuffer(BufferPtr_t inIndexBuffer, UINT inIndexOffset, UINT inIndexSize) const
 	{
-		g_d3dDeviceContext->IASetIndexBuffer(inIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 2 * inIndexOffset);
+		const DXGI_FORMAT indexFormat = inIndexSize == sizeof(uint32_t) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+		m_deviceContext->IASetIndexBuffer(inIndexBuffer.Get(), indexFormat, inIndexSize * inIndexOffset);
 	}
 
 	void UGraphicsDriver::SetVertexShader(VertexShaderPtr_t inVertexShader) const
 	{
 		MAD_ASSERT_DESC(inVertexShader, "Invalid vertex shader");
 
-		g_d3dDeviceContext->VSSetShader(inVertexShader.Get(), nullptr, 0);
+		m_deviceContext->VSSetShader(inVertexShader.Get(), nullptr, 0);
 	}
 
 	void UGraphicsDriver::SetGeometryShader(GeometryShaderPtr_t inGeometryShader) const
 	{
 		// No need for nullptr check becuase you can safely set the geometry shader to null
-		g_d3dDeviceContext->GSSetShader(inGeometryShader.Get(), nullptr, 0);
+		m_deviceContext->GSSetShader(inGeometryShader.Get(), nullptr, 0);
 	}
 
 	void UGraphicsDriver::SetPixelShader(PixelShaderPtr_t inPixelShader) const
 	{
 		// No need for nullptr check because you can safely set the pixel shader to null
-		g_d3dDeviceContext->PSSetShader(inPixelShader.Get(), nullptr, 0);
+		m_deviceContext->PSSetShader(inPixelShader.Get(), nullptr, 0);
 	}
 
 	void UGraphicsDriver::SetVertexConstantBuffer(BufferPtr_t inBuffer, UINT inSlot) const
 	{
-		g_d3dDeviceContext->VSSetConstantBuffers(inSlot, 1, inBuffer.GetAddressOf());
+		m_deviceContext->VSSetConstantBuffers(inSlot, 1, inBuffer.GetAddressOf());
 	}
 
 	void UGraphicsDriver::SetVertexConstantBuffer(BufferPtr_t inBuffer, UINT inSlot, UINT inOffset, UINT inLength) const
@@ -878,12 +1373,12 @@ namespace MAD
 		inOffset /= 16;
 		inLength /= 16;
 
-		g_d3dDeviceContext->VSSetConstantBuffers1(inSlot, 1, inBuffer.GetAddressOf(), &inOffset, &inLength);
+		m_deviceContext->VSSetConstantBuffers1(inSlot, 1, inBuffer.GetAddressOf(), &inOffset, &inLength);
 	}
 
 	void UGraphicsDriver::SetGeometryConstantBuffer(BufferPtr_t inBuffer, UINT inSlot) const
 	{
-		g_d3dDeviceContext->GSSetConstantBuffers(inSlot, 1, inBuffer.GetAddressOf());
+		m_deviceContext->GSSetConstantBuffers(inSlot, 1, inBuffer.GetAddressOf());
 	}
 
 	void UGraphicsDriver::SetGeometryConstantBuffer(BufferPtr_t inBuffer, UINT inSlot, UINT inOffset, UINT inLength) const
@@ -894,12 +1389,12 @@ namespace MAD
 		inOffset /= 16;
 		inLength /= 16;
 
-		g_d3dDeviceContext->GSSetConstantBuffers1(inSlot, 1, inBuffer.GetAddressOf(), &inOffset, &inLength);
+		m_deviceContext->GSSetConstantBuffers1(inSlot, 1, inBuffer.GetAddressOf(), &inOffset, &inLength);
 	}
 
 	void UGraphicsDriver::SetPixelConstantBuffer(BufferPtr_t inBuffer, UINT inSlot) const
 	{
-		g_d3dDeviceContext->PSSetConstantBuffers(inSlot, 1, inBuffer.GetAddressOf());
+		m_deviceContext->PSSetConstantBuffers(inSlot, 1, inBuffer.GetAddressOf());
 	}
 
 	void UGraphicsDriver::SetPixelConstantBuffer(BufferPtr_t inBuffer, UINT inSlot, UINT inOffset, UINT inLength) const
@@ -910,19 +1405,19 @@ namespace MAD
 		inOffset /= 16;
 		inLength /= 16;
 
-		g_d3dDeviceContext->PSSetConstantBuffers1(inSlot, 1, inBuffer.GetAddressOf(), &inOffset, &inLength);
+		m_deviceContext->PSSetConstantBuffers1(inSlot, 1, inBuffer.GetAddressOf(), &inOffset, &inLength);
 	}
 
 	void UGraphicsDriver::SetPixelSamplerState(SamplerStatePtr_t inSamplerState, UINT inSlot) const
 	{
 		// No need for nullptr check because setting a null sampler state will force the use of the default sampler state
-		g_d3dDeviceContext->PSSetSamplers(inSlot, 1, inSamplerState.GetAddressOf());
+		m_deviceContext->PSSetSamplers(inSlot, 1, inSamplerState.GetAddressOf());
 	}
 
 	void UGraphicsDriver::SetPixelShaderResource(ShaderResourcePtr_t inShaderResource, UINT inSlot) const
 	{
 		// No need for nullptr check because setting a null shader resource at a certain slot just unbinds the slot
-		g_d3dDeviceContext->PSSetShaderResources(inSlot, 1, inShaderResource.GetAddressOf());
+		m_deviceContext->PSSetShaderResources(inSlot, 1, inShaderResource.GetAddressOf());
 	}
 
 	void UGraphicsDriver::SetPixelShaderResource(ShaderResourcePtr_t inShaderResource, ETextureSlot inSlot) const
@@ -933,14 +1428,14 @@ namespace MAD
 
 	void UGraphicsDriver::SetRasterizerState(RasterizerStatePtr_t inRasterizerState) const
 	{
-		g_d3dDeviceContext->RSSetState(inRasterizerState.Get());
+		m_deviceContext->RSSetState(inRasterizerState.Get());
 	}
 
 	void UGraphicsDriver::SetBlendState(BlendStatePtr_t inBlendstate) const
 	{
 		// No need for nullptr check because setting a null blend state will force the use of the default blend state
 		static FLOAT blendFactor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-		g_d3dDeviceContext->OMSetBlendState(inBlendstate.Get(), blendFactor, 0xffffffff);
+		m_deviceContext->OMSetBlendState(inBlendstate.Get(), blendFactor, 0xffffffff);
 	}
 
 	void UGraphicsDriver::DestroyDepthStencil(DepthStencilPtr_t& inOutDepthStencil) const
@@ -970,16 +1465,16 @@ namespace MAD
 
 	void UGraphicsDriver::ClearRenderTarget(RenderTargetPtr_t inRenderTarget, const Color& inColor) const
 	{
-		static float s_localClearColor[4];
+		float localClearColor[4];
 
 		if (!inRenderTarget)
 		{
 			return;
 		}
 
-		memcpy(s_localClearColor, &inColor, sizeof(inColor));
+		memcpy(localClearColor, &inColor, sizeof(inColor));
 
-		g_d3dDeviceContext->ClearRenderTargetView(inRenderTarget.Get(), s_localClearColor);
+		m_deviceContext->ClearRenderTargetView(inRenderTarget.Get(), localClearColor);
 	}
 
 	void UGraphicsDriver::ClearDepthStencil(DepthStencilPtr_t inDepthStencil, bool inClearDepth, float inDepth, bool inClearStencil, UINT8 inStencil) const
@@ -993,17 +1488,27 @@ namespace MAD
 		if (inClearDepth) clearFlags |= AsIntegral(EClearFlag::Depth);
 		if (inClearStencil) clearFlags |= AsIntegral(EClearFlag::Stencil);
 
-		g_d3dDeviceContext->ClearDepthStencilView(inDepthStencil.Get(), clearFlags, inDepth, inStencil);
+		m_deviceContext->ClearDepthStencilView(inDepthStencil.Get(), clearFlags, inDepth, inStencil);
 	}
 
 	void UGraphicsDriver::Draw(int inVertexCount, int inStartVertex) const
 	{
-		g_d3dDeviceContext->Draw(inVertexCount, inStartVertex);
+		m_deviceContext->Draw(inVertexCount, inStartVertex);
 	}
 
 	void UGraphicsDriver::DrawIndexed(int inIndexCount, int inStartIndex, int inBaseVertex) const
 	{
-		g_d3dDeviceContext->DrawIndexed(inIndexCount, inStartIndex, inBaseVertex);
+		m_deviceContext->DrawIndexed(inIndexCount, inStartIndex, inBaseVertex);
+	}
+
+	void UGraphicsDriver::DrawInstanced(int inVertexCount, int inInstanceCount, int inStartVertex, int inStartInstance) const
+	{
+		m_deviceContext->DrawInstanced(inVertexCount, inInstanceCount, inStartVertex, inStartInstance);
+	}
+
+	void UGraphicsDriver::DrawIndexedInstanced(int inIndexCount, int inInstanceCount, int inStartIndex, int inBaseVertex, int inStartInstance) const
+	{
+		m_deviceContext->DrawIndexedInstanced(inIndexCount, inInstanceCount, inStartIndex, inBaseVertex, inStartInstance);
 	}
 
 	void UGraphicsDriver::Present() const
@@ -1079,17 +1584,17 @@ namespace MAD
 #ifdef _DEBUG
 	void UGraphicsDriver::StartEventGroup(const eastl::wstring& inName)
 	{
-		if (g_d3dEvent)
+		if (m_eventAnnotation)
 		{
-			g_d3dEvent->BeginEvent(inName.c_str());
+			m_eventAnnotation->BeginEvent(inName.c_str());
 		}
 	}
 
 	void UGraphicsDriver::EndEventGroup()
 	{
-		if (g_d3dEvent)
+		if (m_eventAnnotation)
 		{
-			g_d3dEvent->EndEvent();
+			m_eventAnnotation->EndEvent();
 		}
 	}
 #endif
@@ -12,6 +12,7 @@ namespace MAD
 		{ "NORMAL",   EInputLayoutSemantic::Normal   },
 		{ "TANGENT",  EInputLayoutSemantic::Tangent  },
 		{ "TEXCOORD", EInputLayoutSemantic::UV       },
+		{ "INSTANCE_TRANSFORM", EInputLayoutSemantic::Instance },
 	};
 
 	eastl::hash_map<InputLayoutFlags_t, InputLayoutPtr_t> UInputLayoutCache::s_inputLayoutCache;
@@ -26,17 +27,41 @@ namespace MAD
 		MAD_ASSERT_DESC(inCompiledVSByteCode != nullptr && inByteCodeSize > 0, "Invalid parameters to RegisterInputLayout");
 		MAD_ASSERT_DESC(inFlags != EInputLayoutSemantic::INVALID, "Invalid flags passed to RegisterInputLayout");
 
-		auto layoutPtr = TryGetInputLayout(inFlags);
-		if (layoutPtr)
+		InputLayoutFlags_t packableFormats = EInputLayoutFormat::None;
+
+		if (inFlags & (EInputLayoutSemantic::Normal | EInputLayoutSemantic::Tangent))
+		{
+			packableFormats |= EInputLayoutFormat::PackedNormals;
+		}
+
+		if (inFlags & EInputLayoutSemantic::UV)
 		{
-			return true;
+			packableFormats |= EInputLayoutFormat::HalfTexCoords;
 		}
 
-		layoutPtr = CreateInputLayout(inGraphicsDriver, inFlags, inCompiledVSByteCode, inByteCodeSize);
-		MAD_ASSERT_DESC(layoutPtr, "Failed to create input layout from given flags");
+		bool registeredAllLayouts = true;
 
-		s_inputLayoutCache[inFlags] = layoutPtr;
-		return layoutPtr;
+		// Visit every subset of the packable formats, ending with the plain layout
+		for (InputLayoutFlags_t formatFlags = packableFormats; ; formatFlags = (formatFlags - 1) & packableFormats)
+		{
+			const InputLayoutFlags_t layoutFlags = inFlags | formatFlags;
+
+			if (TryGetInputLayout(layoutFlags) == nullptr)
+			{
+				auto layoutPtr = CreateInputLayout(inGraphicsDriver, layoutFlags, inCompiledVSByteCode, inByteCodeSize);
+				MAD_ASSERT_DESC(layoutPtr != nullptr, "Failed to create input layout from given flags");
+
+				s_inputLayoutCache[layoutFlags] = layoutPtr;
+				registeredAllLayouts = registeredAllLayouts && layoutPtr != nullptr;
+			}
+
+			if (formatFlags == EInputLayoutFormat::None)
+			{
+				break;
+			}
+		}
+
+		return registeredAllLayouts;
 	}
 
 	InputLayoutPtr_t UInputLayoutCache::CreateInputLayout(UGraphicsDriver& inGraphicsDriver, InputLayoutFlags_t inFlags, const void* inCompiledVSByteCode, size_t inByteCodeSize)
@@ -46,6 +71,20 @@ namespace MAD
 		static const D3D11_INPUT_ELEMENT_DESC tangent  = { "TANGENT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, AsIntegral(EVertexBufferSlot::Tangent),  0, D3D11_INPUT_PER_VERTEX_DATA, 0 };
 		static const D3D11_INPUT_ELEMENT_DESC texcoord = { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    AsIntegral(EVertexBufferSlot::UV),       0, D3D11_INPUT_PER_VERTEX_DATA, 0 };
 
+		// The input assembler unpacks these, so shaders see the same floats either way
+		static const D3D11_INPUT_ELEMENT_DESC packedNormal   = { "NORMAL",   0, DXGI_FORMAT_R8G8B8A8_SNORM, AsIntegral(EVertexBufferSlot::Normal),  0, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+		static const D3D11_INPUT_ELEMENT_DESC packedTangent  = { "TANGENT",  0, DXGI_FORMAT_R8G8B8A8_SNORM, AsIntegral(EVertexBufferSlot::Tangent), 0, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+		static const D3D11_INPUT_ELEMENT_DESC halfTexcoord   = { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT,   AsIntegral(EVertexBufferSlot::UV),      0, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+
+		// The instance transform is a float4x4, which takes up one element per row
+		static const D3D11_INPUT_ELEMENT_DESC instanceTransform[] =
+		{
+			{ "INSTANCE_TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, AsIntegral(EVertexBufferSlot::Instance), 0,  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "INSTANCE_TRANSFORM", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, AsIntegral(EVertexBufferSlot::Instance), 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "INSTANCE_TRANSFORM", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, AsIntegral(EVertexBufferSlot::Instance), 32, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+			{ "INSTANCE_TRANSFORM", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, AsIntegral(EVertexBufferSlot::Instance), 48, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		};
+
 		eastl::vector<D3D11_INPUT_ELEMENT_DESC> inputLayout;
 
 		if (inFlags & EInputLayoutSemantic::Position)
@@ -53,19 +92,26 @@ namespace MAD
 			inputLayout.push_back(position);
 		}
 
+		const bool hasPackedNormals = (inFlags & EInputLayoutFormat::PackedNormals) != 0;
+
 		if (inFlags & EInputLayoutSemantic::Normal)
 		{
-			inputLayout.push_back(normal);
+			inputLayout.push_back(hasPackedNormals ? packedNormal : normal);
 		}
 
 		if (inFlags & EInputLayoutSemantic::Tangent)
 		{
-			inputLayout.push_back(tangent);
+			inputLayout.push_back(hasPackedNormals ? packedTangent : tangent);
 		}
 
 		if (inFlags & EInputLayoutSemantic::UV)
 		{
-			inputLayout.push_back(texcoord);
+			inputLayout.push_back((inFlags & EInputLayoutFormat::HalfTexCoords) ? halfTexcoord : texcoord);
+		}
+
+		if (inFlags & EInputLayoutSemantic::Instance)
+		{
+			inputLayout.insert(inputLayout.end(), eastl::begin(instanceTransform), eastl::end(instanceTransform));
 		}
 
 		return inGraphicsDriver.CreateInputLayout(inputLayout.data(), static_cast<UINT>(inputLayout.size()), inCompiledVSByteCode, inByteCodeSize);
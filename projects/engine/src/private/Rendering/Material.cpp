@@ -1,9 +1,34 @@
 #include "Rendering/Material.h"
 
+#include <atomic>
+#include <mutex>
+
 namespace MAD
 {
+	namespace
+	{
+		std::atomic<uint32_t> g_nextMaterialID(1);
+
+		std::mutex g_releasedMaterialsMutex;
+		eastl::vector<uint32_t> g_releasedMaterialIDs;
+	}
+
 	UMaterial::UMaterial()
+		: m_materialID(g_nextMaterialID.fetch_add(1, std::memory_order_relaxed))
 	{
 		
 	}
+
+	void UMaterial::QueueCachedConstantsRelease(uint32_t inMaterialID)
+	{
+		std::lock_guard<std::mutex> lock(g_releasedMaterialsMutex);
+		g_releasedMaterialIDs.push_back(inMaterialID);
+	}
+
+	void UMaterial::TakeCachedConstantsReleases(eastl::vector<uint32_t>& outMaterialIDs)
+	{
+		std::lock_guard<std::mutex> lock(g_releasedMaterialsMutex);
+		outMaterialIDs.insert(outMaterialIDs.end(), g_releasedMaterialIDs.begin(), g_releasedMaterialIDs.end());
+		g_releasedMaterialIDs.clear();
+	}
 }
@@ -0,0 +1,678 @@
+#include "Rendering/MeshCooker.h"
+
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/numeric_limits.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include "Misc/Assert.h"
+#include "Misc/CookedFile.h"
+#include "Misc/Logging.h"
+#include "Misc/MappedFile.h"
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogMeshImport);
+
+#define DO_LOG 0
+
+#if defined(DO_LOG) && DO_LOG > 0
+#define LOG_ENABLED
+#define LOG_IMPORT(Verbosity, Format, ...) LOG(LogMeshImport, Verbosity, Format, __VA_ARGS__)
+#else
+#define LOG_IMPORT(Verbosity, Format, ...) (void)0
+#endif
+
+	const uint32_t UMeshCooker::CookedMeshVersion = 3;
+
+	namespace
+	{
+		const uint32_t g_cookedMeshMagic = 0x4D44414D; // "MADM"
+		const uint32_t g_noTextureName = 0xFFFFFFFF;
+
+		// Each LOD aims for half the triangles of the one before it. Sub-meshes that are already small, or that stop
+		// simplifying well (e.g. mostly seams), end their chain early
+		const float g_lodTriangleRatio = 0.5f;
+		const float g_maxLODIndexFraction = 0.9f;
+		const size_t g_minLODTriangleCount = 64;
+
+		enum ECookedMaterialTexture
+		{
+			Diffuse,
+			Specular,
+			Emissive,
+			NormalMap,
+			OpacityMask,
+			Count
+		};
+
+		struct SCookedMeshHeader
+		{
+			uint32_t m_magic;
+			uint32_t m_version;
+
+			uint64_t m_sourceFileSize;
+			uint64_t m_sourceWriteTime;
+
+			uint32_t m_positionCount;
+			uint32_t m_normalCount;
+			uint32_t m_tangentCount;
+			uint32_t m_texCoordCount;
+			uint32_t m_indexDataSize;
+			uint32_t m_subMeshCount;
+			uint32_t m_materialCount;
+			uint32_t m_stringTableSize;
+		};
+
+		struct SCookedMaterial
+		{
+			SGPUMaterial m_mat;
+			uint32_t m_textureNameOffsets[ECookedMaterialTexture::Count]; // Into the string table, g_noTextureName if unused
+			uint32_t m_isTwoSided;
+		};
+
+		bool IsHeaderUpToDate(const SCookedMeshHeader& inHeader, const eastl::string& inSourcePath)
+		{
+			if (inHeader.m_magic != g_cookedMeshMagic || inHeader.m_version != UMeshCooker::CookedMeshVersion)
+			{
+				return false;
+			}
+
+			uint64_t sourceFileSize = 0;
+			uint64_t sourceWriteTime = 0;
+			if (!UCookedFile::GetSourceFileStamp(inSourcePath, sourceFileSize, sourceWriteTime))
+			{
+				// Cooked files can ship without their source
+				return true;
+			}
+
+			return inHeader.m_sourceFileSize == sourceFileSize && inHeader.m_sourceWriteTime == sourceWriteTime;
+		}
+
+		uint32_t AddTextureName(const eastl::string& inTextureName, eastl::vector<char>& inOutStringTable)
+		{
+			if (inTextureName.empty())
+			{
+				return g_noTextureName;
+			}
+
+			const uint32_t nameOffset = static_cast<uint32_t>(inOutStringTable.size());
+			inOutStringTable.insert(inOutStringTable.end(), inTextureName.c_str(), inTextureName.c_str() + inTextureName.size() + 1);
+			return nameOffset;
+		}
+
+		// Runs the vertex cache, overdraw and vertex fetch optimizations over one sub-mesh. The sub-mesh's slice of each vertex
+		// stream is reordered to match the indices
+		void OptimizeSubMesh(const SSubMesh& inSubMesh, eastl::vector<uint32_t>& inOutIndices, SMeshData& inOutMeshData,
+							 eastl::vector<Vector3>& inOutNormals, eastl::vector<Vector4>& inOutTangents, SMeshOptimizationStats* inOutStats)
+		{
+			const uint32_t indexCount = static_cast<uint32_t>(inOutIndices.size());
+			const uint32_t vertexCount = inSubMesh.m_vertexCount;
+			Vector3* positions = &inOutMeshData.m_positions[inSubMesh.m_vertexStart];
+
+			if (inOutStats)
+			{
+				inOutStats->m_sourceACMR += UMeshOptimizer::CalculateACMR(inOutIndices.data(), indexCount, vertexCount) * (indexCount / 3);
+			}
+
+			UMeshOptimizer::OptimizeVertexCache(inOutIndices.data(), indexCount, vertexCount);
+			UMeshOptimizer::OptimizeOverdraw(inOutIndices.data(), indexCount, positions, vertexCount);
+
+			if (inOutStats)
+			{
+				inOutStats->m_optimizedACMR += UMeshOptimizer::CalculateACMR(inOutIndices.data(), indexCount, vertexCount) * (indexCount / 3);
+				inOutStats->m_triangleCount += indexCount / 3;
+			}
+
+			eastl::vector<uint32_t> vertexRemap;
+			UMeshOptimizer::OptimizeVertexFetch(inOutIndices.data(), indexCount, vertexCount, vertexRemap);
+
+			UMeshOptimizer::RemapVertexStream(positions, vertexRemap);
+
+			if (inOutNormals.size() >= inSubMesh.m_vertexStart + vertexCount)
+			{
+				UMeshOptimizer::RemapVertexStream(&inOutNormals[inSubMesh.m_vertexStart], vertexRemap);
+			}
+
+			if (inOutTangents.size() >= inSubMesh.m_vertexStart + vertexCount)
+			{
+				UMeshOptimizer::RemapVertexStream(&inOutTangents[inSubMesh.m_vertexStart], vertexRemap);
+			}
+
+			if (inOutMeshData.m_texCoords.size() >= inSubMesh.m_vertexStart + vertexCount)
+			{
+				UMeshOptimizer::RemapVertexStream(&inOutMeshData.m_texCoords[inSubMesh.m_vertexStart], vertexRemap);
+			}
+		}
+
+		// Appends one LOD of a sub-mesh's indices to the mesh's index data at the sub-mesh's index size, and fills in where it starts
+		template <typename T>
+		void AppendSubMeshIndices(const eastl::vector<uint32_t>& inIndices, SSubMesh& inOutSubMesh, eastl::vector<uint8_t>& inOutIndexData)
+		{
+			MAD_ASSERT_DESC(inOutSubMesh.m_lodCount < MaxMeshLODs, "Sub-mesh has too many LODs");
+
+			// Index buffer offsets must be aligned to the size of the index
+			const size_t indexDataStart = (inOutIndexData.size() + sizeof(T) - 1) & ~(sizeof(T) - 1);
+			inOutIndexData.resize(indexDataStart + inIndices.size() * sizeof(T));
+
+			T* subMeshIndices = reinterpret_cast<T*>(&inOutIndexData[indexDataStart]);
+			for (size_t i = 0; i < inIndices.size(); ++i)
+			{
+				subMeshIndices[i] = static_cast<T>(inIndices[i]);
+			}
+
+			SMeshLOD& newLOD = inOutSubMesh.m_lods[inOutSubMesh.m_lodCount++];
+			newLOD.m_indexStart = static_cast<UINT>(indexDataStart / sizeof(T));
+			newLOD.m_indexCount = static_cast<UINT>(inIndices.size());
+			inOutSubMesh.m_indexSize = sizeof(T);
+		}
+
+		void AppendSubMeshLOD(const eastl::vector<uint32_t>& inIndices, SSubMesh& inOutSubMesh, eastl::vector<uint8_t>& inOutIndexData)
+		{
+			if (inOutSubMesh.m_vertexCount > eastl::numeric_limits<uint16_t>::max() + 1u)
+			{
+				AppendSubMeshIndices<uint32_t>(inIndices, inOutSubMesh, inOutIndexData);
+			}
+			else
+			{
+				AppendSubMeshIndices<uint16_t>(inIndices, inOutSubMesh, inOutIndexData);
+			}
+		}
+
+		eastl::string GetTextureName(uint32_t inNameOffset, const eastl::vector<char>& inStringTable)
+		{
+			if (inNameOffset == g_noTextureName || inNameOffset >= inStringTable.size())
+			{
+				return eastl::string();
+			}
+
+			return eastl::string(&inStringTable[inNameOffset]);
+		}
+	}
+
+	void UMeshCooker::CalculateSubMeshBounds(const Vector3* inPositions, UINT inVertexCount, SSubMesh& inOutSubMesh)
+	{
+		Vector3 boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+		Vector3 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+		for (UINT i = 0; i < inVertexCount; ++i)
+		{
+			boundsMin = Vector3::Min(boundsMin, inPositions[i]);
+			boundsMax = Vector3::Max(boundsMax, inPositions[i]);
+		}
+
+		inOutSubMesh.m_boundsCenter = (boundsMin + boundsMax) * 0.5f;
+		inOutSubMesh.m_boundsRadius = 0.0f;
+
+		for (UINT i = 0; i < inVertexCount; ++i)
+		{
+			inOutSubMesh.m_boundsRadius = eastl::max(inOutSubMesh.m_boundsRadius, Vector3::Distance(inPositions[i], inOutSubMesh.m_boundsCenter));
+		}
+	}
+
+	eastl::string UMeshCooker::GetCookedMeshPath(const eastl::string& inSourcePath)
+	{
+		return inSourcePath + ".madmesh";
+	}
+
+	bool UMeshCooker::ImportSourceMesh(const eastl::string& inSourcePath, SMeshData& outMeshData, SMeshOptimizationStats* outStats)
+	{
+		Assimp::Importer importer;
+		importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_LINE | aiPrimitiveType_POINT);
+		importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, aiComponent_LIGHTS | aiComponent_CAMERAS);
+		importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f);
+		importer.SetPropertyFloat(AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE, 80.0f);
+
+		unsigned int flags = 0;
+		flags |= aiProcess_ValidateDataStructure;
+		flags |= aiProcess_RemoveRedundantMaterials;
+		flags |= aiProcess_FindInstances;
+		flags |= aiProcess_FindDegenerates;
+		flags |= aiProcess_GenUVCoords;
+		flags |= aiProcess_TransformUVCoords;
+		flags |= aiProcess_Triangulate;
+		flags |= aiProcess_SortByPType;
+		flags |= aiProcess_FindInvalidData;
+		flags |= aiProcess_OptimizeMeshes;
+		//flags |= aiProcess_FixInfacingNormals;
+		//flags |= aiProcess_GenNormals;
+		flags |= aiProcess_GenSmoothNormals;
+		flags |= aiProcess_CalcTangentSpace;
+		flags |= aiProcess_JoinIdenticalVertices;
+		flags |= aiProcess_LimitBoneWeights;
+		flags |= aiProcess_FlipUVs;
+		//flags |= aiProcess_FlipWindingOrder;
+		//flags |= aiProcess_MakeLeftHanded;
+
+		const aiScene* scene = importer.ReadFile(inSourcePath.c_str(), flags);
+
+		if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
+		{
+			LOG(LogMeshImport, Error, "Failed to load mesh '%s': %s\n", inSourcePath.c_str(), importer.GetErrorString());
+			return false;
+		}
+
+		outMeshData = SMeshData();
+		outMeshData.m_materials.resize(scene->mNumMaterials);
+		outMeshData.m_subMeshes.resize(scene->mNumMeshes);
+
+		bool hasNormalMap = false;
+
+		// Process materials
+		for (unsigned i = 0; i < scene->mNumMaterials; ++i)
+		{
+			auto aiMaterial = scene->mMaterials[i];
+			auto& madMaterial = outMeshData.m_materials[i];
+			LOG_IMPORT(Log, "Material [%d]\n", i);
+
+			{
+				aiString name;
+				aiMaterial->Get(AI_MATKEY_NAME, name);
+				LOG_IMPORT(Log, "\tName = %s\n", name.C_Str());
+			}
+			{
+				int shading_model;
+				aiMaterial->Get(AI_MATKEY_SHADING_MODEL, shading_model);
+				LOG_IMPORT(Log, "\tShading Model = %d\n", shading_model);
+			}
+			{
+				aiColor3D diffuse_color;
+				aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse_color);
+				LOG_IMPORT(Log, "\tDiffuse = { %.2f, %.2f, %.2f }\n", diffuse_color.r, diffuse_color.g, diffuse_color.b);
+				madMaterial.m_mat.m_diffuseColor = Vector3(diffuse_color.r, diffuse_color.g, diffuse_color.b);
+
+				aiString diffuse_tex;
+				if (AI_SUCCESS == aiMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &diffuse_tex))
+				{
+					madMaterial.m_diffuseTex = diffuse_tex.C_Str();
+				}
+				LOG_IMPORT(Log, "\tDiffuse tex = %s\n", diffuse_tex.C_Str());
+			}
+			{
+				aiColor3D specular_color;
+				aiMaterial->Get(AI_MATKEY_COLOR_SPECULAR, specular_color);
+				LOG_IMPORT(Log, "\tSpecular = { %.2f, %.2f, %.2f }\n", specular_color.r, specular_color.g, specular_color.b);
+				madMaterial.m_mat.m_specularColor = Vector3(specular_color.r, specular_color.g, specular_color.b);
+
+				float specular_strength = 1.0f;
+				aiMaterial->Get(AI_MATKEY_SHININESS_STRENGTH, specular_strength);
+				LOG_IMPORT(Log, "\tSpecular strength = %f\n", specular_strength);
+				madMaterial.m_mat.m_specularColor *= specular_strength;
+
+				float specular_power = 1.0f;
+				aiMaterial->Get(AI_MATKEY_SHININESS, specular_power);
+				LOG_IMPORT(Log, "\tSpecular power = %f\n", specular_power);
+				madMaterial.m_mat.m_specularPower = specular_power;
+
+				// Assimp doesn't allow you import a reflectivity constant....using the refraction index for now
+				float reflectivity = 0.0f;
+				aiMaterial->Get(AI_MATKEY_REFRACTI, reflectivity);
+				madMaterial.m_mat.m_reflectivity = reflectivity;
+
+				aiString specular_tex;
+				if (specular_strength > 0.0f && specular_power >= 1.0f && AI_SUCCESS == aiMaterial->GetTexture(aiTextureType_SPECULAR, 0, &specular_tex))
+				{
+					madMaterial.m_specularTex = specular_tex.C_Str();
+				}
+				LOG_IMPORT(Log, "\tSpecular tex = %s\n", specular_tex.C_Str());
+			}
+			{
+				aiColor3D emissive_color;
+				aiMaterial->Get(AI_MATKEY_COLOR_EMISSIVE, emissive_color);
+				LOG_IMPORT(Log, "\tEmissive = { %.2f, %.2f, %.2f }\n", emissive_color.r, emissive_color.g, emissive_color.b);
+				madMaterial.m_mat.m_emissiveColor = Vector3(emissive_color.r, emissive_color.g, emissive_color.b);
+
+				aiString emissive_tex;
+				if (AI_SUCCESS == aiMaterial->GetTexture(aiTextureType_EMISSIVE, 0, &emissive_tex))
+				{
+					madMaterial.m_emissiveTex = emissive_tex.C_Str();
+				}
+				LOG_IMPORT(Log, "\tEmissive tex = %s\n", emissive_tex.C_Str());
+			}
+			{
+				aiString normal_map;
+				if (AI_SUCCESS == aiMaterial->GetTexture(aiTextureType_HEIGHT, 0, &normal_map))
+				{
+					madMaterial.m_normalMap = normal_map.C_Str();
+					hasNormalMap = true;
+				}
+				LOG_IMPORT(Log, "\tNormal map = %s\n", normal_map.C_Str());
+			}
+			{
+				float opacity = 1.0f;
+				aiMaterial->Get(AI_MATKEY_OPACITY, opacity);
+				LOG_IMPORT(Log, "\tOpacity = %f\n", opacity);
+				madMaterial.m_mat.m_opacity = opacity;
+
+				aiString opacity_tex;
+				if (AI_SUCCESS == aiMaterial->GetTexture(aiTextureType_OPACITY, 0, &opacity_tex))
+				{
+					madMaterial.m_opacityMask = opacity_tex.C_Str();
+				}
+				LOG_IMPORT(Log, "\tOpacity tex = %s\n", opacity_tex.C_Str());
+
+				int two_sided = 0;
+				aiMaterial->Get(AI_MATKEY_TWOSIDED, two_sided);
+				if (opacity < 1.0f || two_sided != 0 || !madMaterial.m_opacityMask.empty())
+				{
+					madMaterial.m_isTwoSided = true;
+				}
+				LOG_IMPORT(Log, "\tTwo-sided = %s\n", madMaterial.m_isTwoSided ? "true" : "false");
+			}
+		}
+
+		// Process sub-meshes
+		UINT numVerts = 0;
+		UINT numIndices = 0;
+		for (unsigned i = 0; i < scene->mNumMeshes; ++i)
+		{
+			auto aiMesh = scene->mMeshes[i];
+
+			numVerts += aiMesh->mNumVertices;
+			numIndices += aiMesh->mNumFaces * 3;
+		}
+
+		outMeshData.m_positions.reserve(numVerts);
+		outMeshData.m_indexData.reserve(numIndices * sizeof(uint16_t));
+
+		// Normals and tangents are optimized at full precision, and only packed once the whole mesh is done
+		eastl::vector<Vector3> normals;
+		eastl::vector<Vector4> tangents;
+		eastl::vector<uint32_t> subMeshIndices;
+		eastl::vector<uint32_t> lodIndices;
+
+		if (outStats)
+		{
+			*outStats = SMeshOptimizationStats();
+		}
+
+		UINT currentVert = 0;
+		for (unsigned i = 0 ; i < scene->mNumMeshes; ++i)
+		{
+			auto aiMesh = scene->mMeshes[i];
+			auto& madSubMesh = outMeshData.m_subMeshes[i];
+			LOG_IMPORT(Log, "Sub Mesh [%d]\n", i);
+
+			LOG_IMPORT(Log, "\tName = %s\n", aiMesh->mName.C_Str());
+
+			madSubMesh.m_materialIndex = aiMesh->mMaterialIndex;
+			LOG_IMPORT(Log, "\tMaterial Index = %i\n", madSubMesh.m_materialIndex);
+
+			for (unsigned v = 0; v < aiMesh->mNumVertices; ++v)
+			{
+				auto pos = aiMesh->mVertices[v];
+				outMeshData.m_positions.emplace_back(pos.x, pos.y, pos.z);
+
+				if (aiMesh->HasNormals())
+				{
+					auto nor = aiMesh->mNormals[v];
+					nor.Normalize();
+					normals.emplace_back(nor.x, nor.y, nor.z);
+				}
+
+				if (aiMesh->HasTextureCoords(0) && aiMesh->HasNormals() && hasNormalMap && aiMesh->HasTangentsAndBitangents())
+				{
+					auto tangent = aiMesh->mTangents[v];
+					tangent.Normalize();
+					tangents.emplace_back(tangent.x, tangent.y, tangent.z, 1.0f);
+
+					auto bitangent = aiMesh->mBitangents[v];
+					bitangent.Normalize();
+
+					Vector4& T = tangents.back();
+					Vector3  B = Vector3(bitangent.x, bitangent.y, bitangent.z);
+					Vector3& N = normals.back();
+
+					if (Vector3(T).Cross(N).Dot(B) < 0.0f)
+					{
+						// Mirrored UVs
+						T.w = -1.0f;
+					}
+				}
+
+				if (aiMesh->HasTextureCoords(0))
+				{
+					auto uvs = aiMesh->mTextureCoords[0][v];
+					outMeshData.m_texCoords.emplace_back(uvs.x, uvs.y);
+				}
+			}
+
+			subMeshIndices.clear();
+			subMeshIndices.reserve(aiMesh->mNumFaces * 3);
+
+			for (unsigned f = 0; f < aiMesh->mNumFaces; ++f)
+			{
+				auto& face = aiMesh->mFaces[f];
+				MAD_ASSERT_DESC(face.mNumIndices == 3, "Number of indices per face must be 3");
+
+				subMeshIndices.push_back(face.mIndices[0]);
+				subMeshIndices.push_back(face.mIndices[1]);
+				subMeshIndices.push_back(face.mIndices[2]);
+			}
+
+			madSubMesh.m_vertexStart = currentVert;
+			madSubMesh.m_vertexCount = aiMesh->mNumVertices;
+			LOG_IMPORT(Log, "\tVertex Start = %i\n", madSubMesh.m_vertexStart);
+			LOG_IMPORT(Log, "\tVertex Count = %i\n", madSubMesh.m_vertexCount);
+
+			OptimizeSubMesh(madSubMesh, subMeshIndices, outMeshData, normals, tangents, outStats);
+			CalculateSubMeshBounds(&outMeshData.m_positions[currentVert], madSubMesh.m_vertexCount, madSubMesh);
+
+			madSubMesh.m_lodCount = 0;
+			AppendSubMeshLOD(subMeshIndices, madSubMesh, outMeshData.m_indexData);
+
+			if (outStats)
+			{
+				outStats->m_lodTriangleCounts[0] += static_cast<uint32_t>(subMeshIndices.size() / 3);
+			}
+
+			// Each coarser LOD is simplified from the one before it, over the same (already optimized) vertices
+			while (madSubMesh.m_lodCount < MaxMeshLODs && subMeshIndices.size() / 3 >= g_minLODTriangleCount)
+			{
+				const uint32_t sourceIndexCount = static_cast<uint32_t>(subMeshIndices.size());
+				const uint32_t targetIndexCount = static_cast<uint32_t>(sourceIndexCount / 3 * g_lodTriangleRatio) * 3;
+
+				const float lodError = UMeshOptimizer::SimplifyMesh(subMeshIndices.data(), sourceIndexCount, &outMeshData.m_positions[currentVert], madSubMesh.m_vertexCount, targetIndexCount, lodIndices);
+				(void)lodError;
+
+				if (lodIndices.size() > sourceIndexCount * g_maxLODIndexFraction)
+				{
+					break;
+				}
+
+				UMeshOptimizer::OptimizeVertexCache(lodIndices.data(), static_cast<uint32_t>(lodIndices.size()), madSubMesh.m_vertexCount);
+				AppendSubMeshLOD(lodIndices, madSubMesh, outMeshData.m_indexData);
+				LOG_IMPORT(Log, "\tLOD %i = %i indices, error %f\n", madSubMesh.m_lodCount - 1, static_cast<int>(lodIndices.size()), lodError);
+
+				if (outStats)
+				{
+					outStats->m_lodTriangleCounts[madSubMesh.m_lodCount - 1] += static_cast<uint32_t>(lodIndices.size() / 3);
+				}
+
+				subMeshIndices.swap(lodIndices);
+			}
+
+			LOG_IMPORT(Log, "\tIndex Start = %i\n", madSubMesh.m_lods[0].m_indexStart);
+			LOG_IMPORT(Log, "\tIndex Count = %i\n", madSubMesh.m_lods[0].m_indexCount);
+			LOG_IMPORT(Log, "\tIndex Size = %i\n", madSubMesh.m_indexSize);
+			LOG_IMPORT(Log, "\tLOD Count = %i\n", madSubMesh.m_lodCount);
+
+			currentVert += madSubMesh.m_vertexCount;
+		}
+
+		outMeshData.m_normals.reserve(normals.size());
+		for (const auto& currentNormal : normals)
+		{
+			outMeshData.m_normals.push_back(UMeshOptimizer::PackNormal(currentNormal));
+		}
+
+		outMeshData.m_tangents.reserve(tangents.size());
+		for (const auto& currentTangent : tangents)
+		{
+			outMeshData.m_tangents.push_back(UMeshOptimizer::PackTangent(currentTangent));
+		}
+
+		if (outStats && outStats->m_triangleCount > 0)
+		{
+			outStats->m_sourceACMR /= outStats->m_triangleCount;
+			outStats->m_optimizedACMR /= outStats->m_triangleCount;
+		}
+
+		return true;
+	}
+
+	bool UMeshCooker::CookMesh(const eastl::string& inSourcePath, SMeshOptimizationStats* outStats)
+	{
+		SCookedMeshHeader cookedHeader = {};
+		cookedHeader.m_magic = g_cookedMeshMagic;
+		cookedHeader.m_version = CookedMeshVersion;
+
+		if (!UCookedFile::GetSourceFileStamp(inSourcePath, cookedHeader.m_sourceFileSize, cookedHeader.m_sourceWriteTime))
+		{
+			LOG(LogMeshImport, Error, "Cannot cook mesh '%s', the source file doesn't exist\n", inSourcePath.c_str());
+			return false;
+		}
+
+		SMeshData meshData;
+		if (!ImportSourceMesh(inSourcePath, meshData, outStats))
+		{
+			return false;
+		}
+
+		eastl::vector<SCookedMaterial> cookedMaterials;
+		eastl::vector<char> stringTable;
+		cookedMaterials.reserve(meshData.m_materials.size());
+
+		for (const auto& currentMaterial : meshData.m_materials)
+		{
+			SCookedMaterial cookedMaterial;
+			cookedMaterial.m_mat = currentMaterial.m_mat;
+			cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::Diffuse] = AddTextureName(currentMaterial.m_diffuseTex, stringTable);
+			cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::Specular] = AddTextureName(currentMaterial.m_specularTex, stringTable);
+			cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::Emissive] = AddTextureName(currentMaterial.m_emissiveTex, stringTable);
+			cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::NormalMap] = AddTextureName(currentMaterial.m_normalMap, stringTable);
+			cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::OpacityMask] = AddTextureName(currentMaterial.m_opacityMask, stringTable);
+			cookedMaterial.m_isTwoSided = currentMaterial.m_isTwoSided ? 1 : 0;
+
+			cookedMaterials.push_back(cookedMaterial);
+		}
+
+		cookedHeader.m_positionCount = static_cast<uint32_t>(meshData.m_positions.size());
+		cookedHeader.m_normalCount = static_cast<uint32_t>(meshData.m_normals.size());
+		cookedHeader.m_tangentCount = static_cast<uint32_t>(meshData.m_tangents.size());
+		cookedHeader.m_texCoordCount = static_cast<uint32_t>(meshData.m_texCoords.size());
+		cookedHeader.m_indexDataSize = static_cast<uint32_t>(meshData.m_indexData.size());
+		cookedHeader.m_subMeshCount = static_cast<uint32_t>(meshData.m_subMeshes.size());
+		cookedHeader.m_materialCount = static_cast<uint32_t>(cookedMaterials.size());
+		cookedHeader.m_stringTableSize = static_cast<uint32_t>(stringTable.size());
+
+		const eastl::string cookedPath = GetCookedMeshPath(inSourcePath);
+		std::ofstream cookedStream(cookedPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!cookedStream.is_open())
+		{
+			LOG(LogMeshImport, Error, "Failed to open '%s' for writing\n", cookedPath.c_str());
+			return false;
+		}
+
+		// Sections are written in the order LoadCookedMesh reads them
+		UCookedFile::WriteSection(cookedStream, &cookedHeader, 1);
+		UCookedFile::WriteSection(cookedStream, meshData.m_positions.data(), meshData.m_positions.size());
+		UCookedFile::WriteSection(cookedStream, meshData.m_normals.data(), meshData.m_normals.size());
+		UCookedFile::WriteSection(cookedStream, meshData.m_tangents.data(), meshData.m_tangents.size());
+		UCookedFile::WriteSection(cookedStream, meshData.m_texCoords.data(), meshData.m_texCoords.size());
+		UCookedFile::WriteSection(cookedStream, meshData.m_indexData.data(), meshData.m_indexData.size());
+		UCookedFile::WriteSection(cookedStream, meshData.m_subMeshes.data(), meshData.m_subMeshes.size());
+		UCookedFile::WriteSection(cookedStream, cookedMaterials.data(), cookedMaterials.size());
+		UCookedFile::WriteSection(cookedStream, stringTable.data(), stringTable.size());
+
+		if (!cookedStream.good())
+		{
+			LOG(LogMeshImport, Error, "Failed to write cooked mesh '%s'\n", cookedPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool UMeshCooker::IsCookedMeshUpToDate(const eastl::string& inSourcePath)
+	{
+		std::ifstream cookedStream(GetCookedMeshPath(inSourcePath).c_str(), std::ios::in | std::ios::binary);
+		if (!cookedStream.is_open())
+		{
+			return false;
+		}
+
+		SCookedMeshHeader cookedHeader;
+		if (!cookedStream.read(reinterpret_cast<char*>(&cookedHeader), sizeof(cookedHeader)))
+		{
+			return false;
+		}
+
+		return IsHeaderUpToDate(cookedHeader, inSourcePath);
+	}
+
+	bool UMeshCooker::LoadCookedMesh(const eastl::string& inSourcePath, SMeshData& outMeshData)
+	{
+		UMappedFile cookedFile;
+		if (!cookedFile.Open(GetCookedMeshPath(inSourcePath)) || cookedFile.GetSize() < sizeof(SCookedMeshHeader))
+		{
+			return false;
+		}
+
+		const uint8_t* cursor = cookedFile.GetData();
+		const uint8_t* fileEnd = cursor + cookedFile.GetSize();
+
+		SCookedMeshHeader cookedHeader;
+		memcpy(&cookedHeader, cursor, sizeof(cookedHeader));
+		cursor += UCookedFile::AlignSectionSize(sizeof(cookedHeader));
+
+		if (!IsHeaderUpToDate(cookedHeader, inSourcePath))
+		{
+			return false;
+		}
+
+		eastl::vector<SCookedMaterial> cookedMaterials;
+		eastl::vector<char> stringTable;
+
+		outMeshData = SMeshData();
+
+		const bool readAllSections = UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_positionCount, outMeshData.m_positions)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_normalCount, outMeshData.m_normals)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_tangentCount, outMeshData.m_tangents)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_texCoordCount, outMeshData.m_texCoords)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_indexDataSize, outMeshData.m_indexData)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_subMeshCount, outMeshData.m_subMeshes)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_materialCount, cookedMaterials)
+								  && UCookedFile::ReadSection(cursor, fileEnd, cookedHeader.m_stringTableSize, stringTable)
+								  && (stringTable.empty() || stringTable.back() == '\0');
+
+		if (!readAllSections)
+		{
+			LOG(LogMeshImport, Warning, "Cooked mesh for '%s' is truncated\n", inSourcePath.c_str());
+			return false;
+		}
+
+		outMeshData.m_materials.resize(cookedMaterials.size());
+		for (size_t i = 0; i < cookedMaterials.size(); ++i)
+		{
+			const SCookedMaterial& cookedMaterial = cookedMaterials[i];
+			SMeshMaterialDesc& currentMaterial = outMeshData.m_materials[i];
+
+			currentMaterial.m_mat = cookedMaterial.m_mat;
+			currentMaterial.m_diffuseTex = GetTextureName(cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::Diffuse], stringTable);
+			currentMaterial.m_specularTex = GetTextureName(cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::Specular], stringTable);
+			currentMaterial.m_emissiveTex = GetTextureName(cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::Emissive], stringTable);
+			currentMaterial.m_normalMap = GetTextureName(cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::NormalMap], stringTable);
+			currentMaterial.m_opacityMask = GetTextureName(cookedMaterial.m_textureNameOffsets[ECookedMaterialTexture::OpacityMask], stringTable);
+			currentMaterial.m_isTwoSided = cookedMaterial.m_isTwoSided != 0;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,697 @@
+#include "Rendering/MeshOptimizer.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include <DirectXPackedVector.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/hash_map.h>
+#include <EASTL/sort.h>
+
+#include "Misc/Assert.h"
+
+namespace MAD
+{
+	namespace
+	{
+		const uint32_t g_invalidIndex = 0xFFFFFFFF;
+
+		// Tuning from Forsyth's paper
+		const uint32_t g_forsythCacheSize = 32;
+		const float g_cacheDecayPower = 1.5f;
+		const float g_lastTriangleScore = 0.75f;
+		const float g_valenceBoostScale = 2.0f;
+		const float g_valenceBoostPower = 0.5f;
+
+		float CalculateVertexScore(int32_t inCachePosition, uint32_t inRemainingTriangles)
+		{
+			if (inRemainingTriangles == 0)
+			{
+				return -1.0f;
+			}
+
+			float score = 0.0f;
+
+			if (inCachePosition >= 0)
+			{
+				if (inCachePosition < 3)
+				{
+					// The last triangle's vertices are scored the same, so it's not favored to reuse them in any particular order
+					score = g_lastTriangleScore;
+				}
+				else
+				{
+					const float cacheScale = 1.0f / (g_forsythCacheSize - 3);
+					score = powf(1.0f - (inCachePosition - 3) * cacheScale, g_cacheDecayPower);
+				}
+			}
+
+			// Vertices with few triangles left are boosted, so that lone triangles don't get left behind
+			score += g_valenceBoostScale * powf(static_cast<float>(inRemainingTriangles), -g_valenceBoostPower);
+			return score;
+		}
+
+		struct STriangleCluster
+		{
+			uint32_t m_firstTriangle;
+			uint32_t m_triangleCount;
+			float m_sortKey;
+		};
+
+		// Collapses that would turn a triangle further than this away from its original facing are rejected
+		const float g_minCollapsedNormalDot = 0.25f;
+
+		// Symmetric 4x4 matrix summing the squared distance to a set of planes, stored as its upper triangle
+		struct SQuadric
+		{
+			double m_a2, m_ab, m_ac, m_ad;
+			double m_b2, m_bc, m_bd;
+			double m_c2, m_cd;
+			double m_d2;
+
+			void AddPlane(const Vector3& inNormal, float inDistance, float inWeight)
+			{
+				const double a = inNormal.x, b = inNormal.y, c = inNormal.z, d = inDistance;
+
+				m_a2 += a * a * inWeight; m_ab += a * b * inWeight; m_ac += a * c * inWeight; m_ad += a * d * inWeight;
+				m_b2 += b * b * inWeight; m_bc += b * c * inWeight; m_bd += b * d * inWeight;
+				m_c2 += c * c * inWeight; m_cd += c * d * inWeight;
+				m_d2 += d * d * inWeight;
+			}
+
+			void Add(const SQuadric& inOther)
+			{
+				m_a2 += inOther.m_a2; m_ab += inOther.m_ab; m_ac += inOther.m_ac; m_ad += inOther.m_ad;
+				m_b2 += inOther.m_b2; m_bc += inOther.m_bc; m_bd += inOther.m_bd;
+				m_c2 += inOther.m_c2; m_cd += inOther.m_cd;
+				m_d2 += inOther.m_d2;
+			}
+
+			double Evaluate(const Vector3& inPoint) const
+			{
+				const double x = inPoint.x, y = inPoint.y, z = inPoint.z;
+
+				return x * x * m_a2 + 2.0 * x * y * m_ab + 2.0 * x * z * m_ac + 2.0 * x * m_ad
+					 + y * y * m_b2 + 2.0 * y * z * m_bc + 2.0 * y * m_bd
+					 + z * z * m_c2 + 2.0 * z * m_cd
+					 + m_d2;
+			}
+		};
+
+		struct SEdgeCollapse
+		{
+			uint32_t m_from;
+			uint32_t m_to;
+			float m_error;
+		};
+
+		uint64_t MakeEdgeKey(uint32_t inFirst, uint32_t inSecond)
+		{
+			return inFirst < inSecond ? (static_cast<uint64_t>(inFirst) << 32) | inSecond : (static_cast<uint64_t>(inSecond) << 32) | inFirst;
+		}
+
+		// Checks that none of the triangles around inFrom (other than the ones that disappear) turn over when it moves to inTo
+		bool DoesCollapseFlipTriangles(const SEdgeCollapse& inCollapse, const eastl::vector<uint32_t>& inIndices, const Vector3* inPositions,
+									   const uint32_t* inVertexTriangles, uint32_t inVertexTriangleCount)
+		{
+			for (uint32_t i = 0; i < inVertexTriangleCount; ++i)
+			{
+				const uint32_t* currentTriangle = &inIndices[inVertexTriangles[i] * 3];
+
+				if (currentTriangle[0] == inCollapse.m_to || currentTriangle[1] == inCollapse.m_to || currentTriangle[2] == inCollapse.m_to)
+				{
+					continue;
+				}
+
+				Vector3 corners[3] = { inPositions[currentTriangle[0]], inPositions[currentTriangle[1]], inPositions[currentTriangle[2]] };
+				Vector3 originalNormal = (corners[1] - corners[0]).Cross(corners[2] - corners[0]);
+
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					if (currentTriangle[k] == inCollapse.m_from)
+					{
+						corners[k] = inPositions[inCollapse.m_to];
+					}
+				}
+
+				Vector3 collapsedNormal = (corners[1] - corners[0]).Cross(corners[2] - corners[0]);
+
+				originalNormal.Normalize();
+				collapsedNormal.Normalize();
+
+				if (originalNormal.Dot(collapsedNormal) < g_minCollapsedNormalDot)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	}
+
+	float UMeshOptimizer::CalculateACMR(const uint32_t* inIndices, uint32_t inIndexCount, uint32_t inVertexCount, uint32_t inCacheSize)
+	{
+		const uint32_t triangleCount = inIndexCount / 3;
+		if (triangleCount == 0)
+		{
+			return 0.0f;
+		}
+
+		// A vertex is cached if it went in within the last inCacheSize misses
+		eastl::vector<uint32_t> cacheTimestamps(inVertexCount, 0);
+		uint32_t currentTime = inCacheSize + 1;
+		uint32_t cacheMisses = 0;
+
+		for (uint32_t i = 0; i < inIndexCount; ++i)
+		{
+			const uint32_t currentVertex = inIndices[i];
+
+			if (currentTime - cacheTimestamps[currentVertex] > inCacheSize)
+			{
+				cacheTimestamps[currentVertex] = currentTime++;
+				++cacheMisses;
+			}
+		}
+
+		return static_cast<float>(cacheMisses) / triangleCount;
+	}
+
+	void UMeshOptimizer::OptimizeVertexCache(uint32_t* inOutIndices, uint32_t inIndexCount, uint32_t inVertexCount)
+	{
+		const uint32_t triangleCount = inIndexCount / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		// The triangles that use each vertex, as ranges into one shared array. Emitted triangles are swapped out past the end
+		// of their vertex's range
+		eastl::vector<uint32_t> adjacencyOffsets(inVertexCount + 1, 0);
+		eastl::vector<uint32_t> remainingTriangles(inVertexCount, 0);
+		eastl::vector<uint32_t> adjacentTriangles(triangleCount * 3);
+
+		for (uint32_t i = 0; i < triangleCount * 3; ++i)
+		{
+			++adjacencyOffsets[inOutIndices[i] + 1];
+		}
+
+		for (uint32_t i = 0; i < inVertexCount; ++i)
+		{
+			adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+		}
+
+		for (uint32_t i = 0; i < triangleCount * 3; ++i)
+		{
+			const uint32_t currentVertex = inOutIndices[i];
+			adjacentTriangles[adjacencyOffsets[currentVertex] + remainingTriangles[currentVertex]++] = i / 3;
+		}
+
+		eastl::vector<int32_t> cachePositions(inVertexCount, -1);
+		eastl::vector<float> vertexScores(inVertexCount);
+
+		for (uint32_t i = 0; i < inVertexCount; ++i)
+		{
+			vertexScores[i] = CalculateVertexScore(-1, remainingTriangles[i]);
+		}
+
+		eastl::vector<uint8_t> isTriangleEmitted(triangleCount, 0);
+		uint32_t bestTriangle = 0;
+		float bestScore = -1.0f;
+
+		for (uint32_t i = 0; i < triangleCount; ++i)
+		{
+			const float triangleScore = vertexScores[inOutIndices[i * 3]] + vertexScores[inOutIndices[i * 3 + 1]] + vertexScores[inOutIndices[i * 3 + 2]];
+			if (triangleScore > bestScore)
+			{
+				bestScore = triangleScore;
+				bestTriangle = i;
+			}
+		}
+
+		eastl::vector<uint32_t> optimizedIndices;
+		optimizedIndices.reserve(triangleCount * 3);
+
+		uint32_t cache[g_forsythCacheSize + 3];
+		uint32_t cacheCount = 0;
+		uint32_t nextUnemittedTriangle = 0;
+
+		while (optimizedIndices.size() < triangleCount * 3)
+		{
+			if (bestTriangle == g_invalidIndex)
+			{
+				// Nothing in the cache leads anywhere, carry on with the next triangle in the original order
+				while (isTriangleEmitted[nextUnemittedTriangle])
+				{
+					++nextUnemittedTriangle;
+				}
+
+				bestTriangle = nextUnemittedTriangle;
+			}
+
+			const uint32_t* triangleVertices = &inOutIndices[bestTriangle * 3];
+			isTriangleEmitted[bestTriangle] = 1;
+			optimizedIndices.insert(optimizedIndices.end(), triangleVertices, triangleVertices + 3);
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				const uint32_t currentVertex = triangleVertices[k];
+				uint32_t* vertexTriangles = &adjacentTriangles[adjacencyOffsets[currentVertex]];
+				uint32_t& vertexTriangleCount = remainingTriangles[currentVertex];
+
+				uint32_t* emittedEntry = eastl::find(vertexTriangles, vertexTriangles + vertexTriangleCount, bestTriangle);
+				MAD_ASSERT_DESC(emittedEntry != vertexTriangles + vertexTriangleCount, "Vertex adjacency is out of date");
+
+				eastl::swap(*emittedEntry, vertexTriangles[vertexTriangleCount - 1]);
+				--vertexTriangleCount;
+			}
+
+			// The emitted triangle's vertices move to the front of the LRU cache, pushing the rest back
+			uint32_t newCache[g_forsythCacheSize + 3];
+			uint32_t newCacheCount = 0;
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				if (eastl::find(newCache, newCache + newCacheCount, triangleVertices[k]) == newCache + newCacheCount)
+				{
+					newCache[newCacheCount++] = triangleVertices[k];
+				}
+			}
+
+			for (uint32_t i = 0; i < cacheCount; ++i)
+			{
+				if (eastl::find(triangleVertices, triangleVertices + 3, cache[i]) == triangleVertices + 3)
+				{
+					newCache[newCacheCount++] = cache[i];
+				}
+			}
+
+			for (uint32_t i = 0; i < newCacheCount; ++i)
+			{
+				const uint32_t currentVertex = newCache[i];
+				cachePositions[currentVertex] = i < g_forsythCacheSize ? static_cast<int32_t>(i) : -1;
+				vertexScores[currentVertex] = CalculateVertexScore(cachePositions[currentVertex], remainingTriangles[currentVertex]);
+			}
+
+			cacheCount = eastl::min(newCacheCount, g_forsythCacheSize);
+			eastl::copy(newCache, newCache + cacheCount, cache);
+
+			// Only the triangles around vertices whose score changed need to be rescored
+			bestTriangle = g_invalidIndex;
+			bestScore = -1.0f;
+
+			for (uint32_t i = 0; i < newCacheCount; ++i)
+			{
+				const uint32_t currentVertex = newCache[i];
+				const uint32_t* vertexTriangles = &adjacentTriangles[adjacencyOffsets[currentVertex]];
+
+				for (uint32_t j = 0; j < remainingTriangles[currentVertex]; ++j)
+				{
+					const uint32_t* currentTriangle = &inOutIndices[vertexTriangles[j] * 3];
+					const float triangleScore = vertexScores[currentTriangle[0]] + vertexScores[currentTriangle[1]] + vertexScores[currentTriangle[2]];
+
+					if (triangleScore > bestScore)
+					{
+						bestScore = triangleScore;
+						bestTriangle = vertexTriangles[j];
+					}
+				}
+			}
+		}
+
+		eastl::copy(optimizedIndices.begin(), optimizedIndices.end(), inOutIndices);
+	}
+
+	void UMeshOptimizer::OptimizeOverdraw(uint32_t* inOutIndices, uint32_t inIndexCount, const Vector3* inPositions, uint32_t inVertexCount)
+	{
+		const uint32_t triangleCount = inIndexCount / 3;
+		if (triangleCount < 2)
+		{
+			return;
+		}
+
+		// Start a new cluster wherever the cache would be refilled anyway, i.e. none of the triangle's vertices are cached.
+		// Moving clusters around then barely changes the number of cache misses
+		eastl::vector<STriangleCluster> clusters;
+		eastl::vector<uint32_t> cacheTimestamps(inVertexCount, 0);
+		uint32_t currentTime = DefaultCacheSize + 1;
+
+		for (uint32_t i = 0; i < triangleCount; ++i)
+		{
+			uint32_t cacheMisses = 0;
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				const uint32_t currentVertex = inOutIndices[i * 3 + k];
+
+				if (currentTime - cacheTimestamps[currentVertex] > DefaultCacheSize)
+				{
+					cacheTimestamps[currentVertex] = currentTime++;
+					++cacheMisses;
+				}
+			}
+
+			if (clusters.empty() || cacheMisses == 3)
+			{
+				clusters.push_back({ i, 0, 0.0f });
+			}
+
+			++clusters.back().m_triangleCount;
+		}
+
+		if (clusters.size() < 2)
+		{
+			return;
+		}
+
+		// Each cluster is scored by how much it faces away from the middle of the mesh. Outward facing clusters are likely
+		// to occlude the rest of the mesh, so they go first
+		Vector3 meshCenter = Vector3::Zero;
+		float meshArea = 0.0f;
+
+		eastl::vector<Vector3> clusterCenters(clusters.size(), Vector3::Zero);
+		eastl::vector<Vector3> clusterNormals(clusters.size(), Vector3::Zero);
+
+		for (size_t i = 0; i < clusters.size(); ++i)
+		{
+			float clusterArea = 0.0f;
+
+			for (uint32_t j = 0; j < clusters[i].m_triangleCount; ++j)
+			{
+				const uint32_t* currentTriangle = &inOutIndices[(clusters[i].m_firstTriangle + j) * 3];
+				const Vector3& p0 = inPositions[currentTriangle[0]];
+				const Vector3& p1 = inPositions[currentTriangle[1]];
+				const Vector3& p2 = inPositions[currentTriangle[2]];
+
+				// Front faces are wound counter-clockwise, so this points out of the surface. Its length is twice the area
+				const Vector3 areaNormal = (p1 - p0).Cross(p2 - p0);
+				const float triangleArea = areaNormal.Length();
+				const Vector3 triangleCenter = (p0 + p1 + p2) / 3.0f;
+
+				clusterCenters[i] += triangleCenter * triangleArea;
+				clusterNormals[i] += areaNormal;
+				clusterArea += triangleArea;
+			}
+
+			meshCenter += clusterCenters[i];
+			meshArea += clusterArea;
+
+			if (clusterArea > 0.0f)
+			{
+				clusterCenters[i] /= clusterArea;
+			}
+
+			clusterNormals[i].Normalize();
+		}
+
+		if (meshArea > 0.0f)
+		{
+			meshCenter /= meshArea;
+		}
+
+		for (size_t i = 0; i < clusters.size(); ++i)
+		{
+			clusters[i].m_sortKey = (clusterCenters[i] - meshCenter).Dot(clusterNormals[i]);
+		}
+
+		eastl::stable_sort(clusters.begin(), clusters.end(), [](const STriangleCluster& inFirst, const STriangleCluster& inSecond)
+		{
+			return inFirst.m_sortKey > inSecond.m_sortKey;
+		});
+
+		eastl::vector<uint32_t> sortedIndices;
+		sortedIndices.reserve(triangleCount * 3);
+
+		for (const auto& currentCluster : clusters)
+		{
+			const uint32_t* clusterIndices = &inOutIndices[currentCluster.m_firstTriangle * 3];
+			sortedIndices.insert(sortedIndices.end(), clusterIndices, clusterIndices + currentCluster.m_triangleCount * 3);
+		}
+
+		eastl::copy(sortedIndices.begin(), sortedIndices.end(), inOutIndices);
+	}
+
+	uint32_t UMeshOptimizer::OptimizeVertexFetch(uint32_t* inOutIndices, uint32_t inIndexCount, uint32_t inVertexCount, eastl::vector<uint32_t>& outRemap)
+	{
+		outRemap.assign(inVertexCount, g_invalidIndex);
+		uint32_t nextVertex = 0;
+
+		for (uint32_t i = 0; i < inIndexCount; ++i)
+		{
+			uint32_t& currentIndex = inOutIndices[i];
+
+			if (outRemap[currentIndex] == g_invalidIndex)
+			{
+				outRemap[currentIndex] = nextVertex++;
+			}
+
+			currentIndex = outRemap[currentIndex];
+		}
+
+		const uint32_t usedVertexCount = nextVertex;
+
+		for (auto& currentRemap : outRemap)
+		{
+			if (currentRemap == g_invalidIndex)
+			{
+				currentRemap = nextVertex++;
+			}
+		}
+
+		return usedVertexCount;
+	}
+
+	float UMeshOptimizer::SimplifyMesh(const uint32_t* inIndices, uint32_t inIndexCount, const Vector3* inPositions, uint32_t inVertexCount,
+									   uint32_t inTargetIndexCount, eastl::vector<uint32_t>& outIndices)
+	{
+		outIndices.assign(inIndices, inIndices + inIndexCount);
+
+		// Every vertex starts out with the planes of the triangles around it, weighted by their area
+		eastl::vector<SQuadric> vertexQuadrics(inVertexCount, SQuadric());
+
+		for (uint32_t i = 0; i + 2 < inIndexCount; i += 3)
+		{
+			const Vector3& p0 = inPositions[inIndices[i]];
+			const Vector3& p1 = inPositions[inIndices[i + 1]];
+			const Vector3& p2 = inPositions[inIndices[i + 2]];
+
+			Vector3 planeNormal = (p1 - p0).Cross(p2 - p0);
+			const float triangleArea = planeNormal.Length() * 0.5f;
+			if (triangleArea <= 0.0f)
+			{
+				continue;
+			}
+
+			planeNormal.Normalize();
+			const float planeDistance = -planeNormal.Dot(p0);
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				vertexQuadrics[inIndices[i + k]].AddPlane(planeNormal, planeDistance, triangleArea);
+			}
+		}
+
+		// Edges used by a single triangle are open, their vertices stay put so that the silhouette and seams don't tear
+		eastl::hash_map<uint64_t, uint32_t> edgeUseCounts;
+		for (uint32_t i = 0; i + 2 < inIndexCount; i += 3)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				++edgeUseCounts[MakeEdgeKey(inIndices[i + k], inIndices[i + (k + 1) % 3])];
+			}
+		}
+
+		eastl::vector<uint8_t> isVertexLocked(inVertexCount, 0);
+		for (const auto& currentEdge : edgeUseCounts)
+		{
+			if (currentEdge.second == 1)
+			{
+				isVertexLocked[static_cast<uint32_t>(currentEdge.first >> 32)] = 1;
+				isVertexLocked[static_cast<uint32_t>(currentEdge.first & 0xFFFFFFFF)] = 1;
+			}
+		}
+
+		eastl::vector<SEdgeCollapse> collapses;
+		eastl::vector<uint32_t> adjacencyOffsets;
+		eastl::vector<uint32_t> adjacencyCounts;
+		eastl::vector<uint32_t> adjacentTriangles;
+		eastl::vector<uint32_t> vertexRemap(inVertexCount);
+		eastl::vector<uint8_t> isVertexTouched(inVertexCount);
+		float maxError = 0.0f;
+
+		// Each pass collapses as many independent edges as it can, cheapest first
+		while (outIndices.size() > inTargetIndexCount)
+		{
+			const uint32_t triangleCount = static_cast<uint32_t>(outIndices.size() / 3);
+
+			collapses.clear();
+			for (uint32_t i = 0; i < triangleCount * 3; ++i)
+			{
+				const uint32_t first = outIndices[i];
+				const uint32_t second = outIndices[i - i % 3 + (i + 1) % 3];
+
+				// Collapse whichever way is cheaper, as long as the vertex that moves isn't locked
+				const float firstToSecondError = isVertexLocked[first] ? FLT_MAX : static_cast<float>(vertexQuadrics[first].Evaluate(inPositions[second]) + vertexQuadrics[second].Evaluate(inPositions[second]));
+				const float secondToFirstError = isVertexLocked[second] ? FLT_MAX : static_cast<float>(vertexQuadrics[first].Evaluate(inPositions[first]) + vertexQuadrics[second].Evaluate(inPositions[first]));
+
+				if (firstToSecondError == FLT_MAX && secondToFirstError == FLT_MAX)
+				{
+					continue;
+				}
+
+				if (firstToSecondError <= secondToFirstError)
+				{
+					collapses.push_back({ first, second, firstToSecondError });
+				}
+				else
+				{
+					collapses.push_back({ second, first, secondToFirstError });
+				}
+			}
+
+			if (collapses.empty())
+			{
+				break;
+			}
+
+			eastl::sort(collapses.begin(), collapses.end(), [](const SEdgeCollapse& inFirst, const SEdgeCollapse& inSecond)
+			{
+				return inFirst.m_error < inSecond.m_error;
+			});
+
+			adjacencyOffsets.assign(inVertexCount + 1, 0);
+			adjacencyCounts.assign(inVertexCount, 0);
+			adjacentTriangles.resize(triangleCount * 3);
+
+			for (uint32_t i = 0; i < triangleCount * 3; ++i)
+			{
+				++adjacencyOffsets[outIndices[i] + 1];
+			}
+
+			for (uint32_t i = 0; i < inVertexCount; ++i)
+			{
+				adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+			}
+
+			for (uint32_t i = 0; i < triangleCount * 3; ++i)
+			{
+				const uint32_t currentVertex = outIndices[i];
+				adjacentTriangles[adjacencyOffsets[currentVertex] + adjacencyCounts[currentVertex]++] = i / 3;
+			}
+
+			for (uint32_t i = 0; i < inVertexCount; ++i)
+			{
+				vertexRemap[i] = i;
+			}
+
+			eastl::fill(isVertexTouched.begin(), isVertexTouched.end(), static_cast<uint8_t>(0));
+
+			uint32_t remainingIndexCount = triangleCount * 3;
+			uint32_t collapseCount = 0;
+
+			for (const auto& currentCollapse : collapses)
+			{
+				if (remainingIndexCount <= inTargetIndexCount)
+				{
+					break;
+				}
+
+				if (isVertexTouched[currentCollapse.m_from] || isVertexTouched[currentCollapse.m_to])
+				{
+					continue;
+				}
+
+				const uint32_t* fromTriangles = &adjacentTriangles[adjacencyOffsets[currentCollapse.m_from]];
+				const uint32_t fromTriangleCount = adjacencyCounts[currentCollapse.m_from];
+
+				if (DoesCollapseFlipTriangles(currentCollapse, outIndices, inPositions, fromTriangles, fromTriangleCount))
+				{
+					continue;
+				}
+
+				vertexRemap[currentCollapse.m_from] = currentCollapse.m_to;
+				vertexQuadrics[currentCollapse.m_to].Add(vertexQuadrics[currentCollapse.m_from]);
+				maxError = eastl::max(maxError, currentCollapse.m_error);
+				++collapseCount;
+
+				// Nothing else around the collapsed vertex can move this pass, its triangles' positions are already out of date
+				for (uint32_t i = 0; i < fromTriangleCount; ++i)
+				{
+					const uint32_t* currentTriangle = &outIndices[fromTriangles[i] * 3];
+					const bool isTriangleRemoved = currentTriangle[0] == currentCollapse.m_to || currentTriangle[1] == currentCollapse.m_to || currentTriangle[2] == currentCollapse.m_to;
+
+					for (uint32_t k = 0; k < 3; ++k)
+					{
+						isVertexTouched[currentTriangle[k]] = 1;
+					}
+
+					if (isTriangleRemoved)
+					{
+						remainingIndexCount -= 3;
+					}
+				}
+			}
+
+			if (collapseCount == 0)
+			{
+				break;
+			}
+
+			// Move the collapsed vertices and drop the triangles that lost their area
+			uint32_t writeIndex = 0;
+			for (uint32_t i = 0; i < triangleCount; ++i)
+			{
+				const uint32_t v0 = vertexRemap[outIndices[i * 3]];
+				const uint32_t v1 = vertexRemap[outIndices[i * 3 + 1]];
+				const uint32_t v2 = vertexRemap[outIndices[i * 3 + 2]];
+
+				if (v0 == v1 || v1 == v2 || v2 == v0)
+				{
+					continue;
+				}
+
+				outIndices[writeIndex++] = v0;
+				outIndices[writeIndex++] = v1;
+				outIndices[writeIndex++] = v2;
+			}
+
+			outIndices.resize(writeIndex);
+		}
+
+		return maxError;
+	}
+
+	PackedNormal_t UMeshOptimizer::PackNormal(const Vector3& inNormal)
+	{
+		return DirectX::PackedVector::XMBYTEN4(inNormal.x, inNormal.y, inNormal.z, 0.0f).v;
+	}
+
+	PackedNormal_t UMeshOptimizer::PackTangent(const Vector4& inTangent)
+	{
+		return DirectX::PackedVector::XMBYTEN4(inTangent.x, inTangent.y, inTangent.z, inTangent.w < 0.0f ? -1.0f : 1.0f).v;
+	}
+
+	Vector4 UMeshOptimizer::UnpackNormal(PackedNormal_t inPackedNormal)
+	{
+		const DirectX::PackedVector::XMBYTEN4 packedNormal(inPackedNormal);
+		return Vector4(DirectX::PackedVector::XMLoadByteN4(&packedNormal));
+	}
+
+	bool UMeshOptimizer::CanPackTexCoords(const Vector2* inTexCoords, uint32_t inCount)
+	{
+		for (uint32_t i = 0; i < inCount; ++i)
+		{
+			if (fabsf(inTexCoords[i].x) > 1.0f || fabsf(inTexCoords[i].y) > 1.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	PackedTexCoord_t UMeshOptimizer::PackTexCoord(const Vector2& inTexCoord)
+	{
+		return DirectX::PackedVector::XMHALF2(inTexCoord.x, inTexCoord.y).v;
+	}
+}
@@ -18,9 +18,9 @@ namespace MAD
 		{ "PS", EProgramShaderType::EProgramShaderType_PS }
 	};
 
-	UPassProgram::UPassProgram() : m_vs(nullptr), m_gs(nullptr), m_ps(nullptr) {}
+	UPassProgram::UPassProgram() : m_vs(nullptr), m_gs(nullptr), m_ps(nullptr), m_isReady(false), m_isCompileQueued(false) {}
 
-	void UPassProgram::BindToPipeline(UGraphicsDriver& inGraphicsDriver)
+	void UPassProgram::BindToPipeline(UGraphicsDriver& inGraphicsDriver) const
 	{
 		// Bind the appropriate shaders, and unbind the ones that aren't valid for the target program
 		inGraphicsDriver.SetVertexShader(m_vs);
@@ -40,7 +40,19 @@ namespace MAD
 			// Reason why permutation doesn't produce the shader IDs is because that is an engine level construct. If we ever move towards
 			// making shader permutation generation a pre-build operation, the transition will be much smoother if the output of on-the-fly generation
 			// and pre-build generation produces the same result
-			if (eastl::shared_ptr<UPassProgram> selectedPassProgram = programSetFindIter->second)
+			const UPassProgram* selectedPassProgram = programSetFindIter->second.get();
+
+			if (selectedPassProgram && !selectedPassProgram->IsReady())
+			{
+				if (programSetFindIter->second->TryBeginCompile())
+				{
+					UProgramPermutor::CompilePermutationAsync(m_programSource, inTargetProgramId, programSetFindIter->second);
+				}
+
+				selectedPassProgram = FindReadyFallback(inTargetProgramId);
+			}
+
+			if (selectedPassProgram)
 			{
 				selectedPassProgram->BindToPipeline(inGraphicsDriver);
 			}
@@ -55,6 +67,34 @@ namespace MAD
 		return false;
 	}
 
+	const UPassProgram* URenderPassProgram::FindReadyFallback(ProgramId_t inTargetProgramId) const
+	{
+		// Visit every subset of the requested material features, the one without any of them is always created up front
+		const ProgramId_t requestedFeatures = inTargetProgramId & UProgramPermutor::s_deferredPermuteMask;
+
+		for (ProgramId_t fallbackFeatures = requestedFeatures; ; fallbackFeatures = (fallbackFeatures - 1) & requestedFeatures)
+		{
+			auto programSetFindIter = m_programPermutations.find((inTargetProgramId & ~UProgramPermutor::s_deferredPermuteMask) | fallbackFeatures);
+
+			if (programSetFindIter != m_programPermutations.cend() && programSetFindIter->second && programSetFindIter->second->IsReady())
+			{
+				return programSetFindIter->second.get();
+			}
+
+			if (fallbackFeatures == 0)
+			{
+				break;
+			}
+		}
+
+		return nullptr;
+	}
+
+	size_t URenderPassProgram::GetMemorySize() const
+	{
+		return sizeof(URenderPassProgram) + m_programPermutations.size() * (sizeof(ProgramPermutations_t::value_type) + sizeof(UPassProgram));
+	}
+
 	eastl::shared_ptr<URenderPassProgram> URenderPassProgram::Load(const eastl::string& inRelativePath)
 	{
 		if (auto cachedProgram = UAssetCache::GetCachedResource<URenderPassProgram>(inRelativePath))
@@ -63,7 +103,9 @@ namespace MAD
 		}
 
 		eastl::shared_ptr<URenderPassProgram> newRenderPassProgram = eastl::make_shared<URenderPassProgram>();
-		UProgramPermutor::PermuteProgram(UAssetCache::GetAssetRoot() + inRelativePath, newRenderPassProgram->m_programPermutations);
+		auto programSource = eastl::make_shared<SProgramSourceDescription>();
+		UProgramPermutor::PermuteProgram(UAssetCache::GetAssetRoot() + inRelativePath, *programSource, newRenderPassProgram->m_programPermutations);
+		newRenderPassProgram->m_programSource = programSource;
 
 		LOG(LogDefault, Log, "Loaded program `%s`\n", inRelativePath.c_str());
 		UAssetCache::InsertResource<URenderPassProgram>(inRelativePath, newRenderPassProgram);
@@ -3,6 +3,7 @@
 #include "Rendering/CameraInstance.h"
 
 #include "Core/GameWindow.h"
+#include "Misc/JobSystem.h"
 #include "Misc/ProgramPermutor.h"
 #include "Misc/Logging.h"
 #include "Misc/Remotery.h"
@@ -10,6 +11,10 @@
 #include "Rendering/InputLayoutCache.h"
 #include "Rendering/ParticleSystem/ParticleSystem.h"
 #include "Rendering/RenderingConstants.h"
+#include "Rendering/TextureStreamer.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
 
 namespace MAD
 {
@@ -18,11 +23,109 @@ namespace MAD
 	namespace
 	{
 		UGraphicsDriver g_graphicsDriver;
+
+		// Groups smaller than this are cheaper to draw individually than to go through the instance stream
+		const size_t g_minInstancedGroupSize = 2;
+
+		// Draw items that compare equal here can be drawn as instances of one another
+		bool CanShareInstancedDraw(const SDrawItemSnapshot& inFirst, const SDrawItemSnapshot& inSecond)
+		{
+			const SDrawItem& first = *inFirst.m_drawItem;
+			const SDrawItem& second = *inSecond.m_drawItem;
+
+			return first.m_indexBuffer == second.m_indexBuffer
+				&& first.m_indexOffset == second.m_indexOffset
+				&& first.m_indexCount == second.m_indexCount
+				&& first.m_vertexBufferOffset == second.m_vertexBufferOffset
+				&& first.m_rasterizerState == second.m_rasterizerState
+				&& inFirst.m_lod == inSecond.m_lod
+				&& inFirst.m_programId == inSecond.m_programId
+				&& inFirst.m_uploadedConstants.m_perMaterialConstants.m_buffer == inSecond.m_uploadedConstants.m_perMaterialConstants.m_buffer
+				&& inFirst.m_uploadedConstants.m_perMaterialConstants.m_offset == inSecond.m_uploadedConstants.m_perMaterialConstants.m_offset;
+		}
+
+		// Bounding spheres are stored as (xyz center, w radius), a negative radius is unbounded
+		Vector4 CalculateWorldBounds(const SDrawItem& inDrawItem, const Matrix& inObjectToWorldMatrix)
+		{
+			if (inDrawItem.m_boundsRadius < 0.0f)
+			{
+				return Vector4(0.0f, 0.0f, 0.0f, -1.0f);
+			}
+
+			const Vector3 wsCenter = Vector3::Transform(inDrawItem.m_boundsCenter, inObjectToWorldMatrix);
+			const float maxScale = eastl::max(eastl::max(inObjectToWorldMatrix.Right().Length(), inObjectToWorldMatrix.Up().Length()), inObjectToWorldMatrix.Backward().Length());
+
+			return Vector4(wsCenter.x, wsCenter.y, wsCenter.z, inDrawItem.m_boundsRadius * maxScale);
+		}
+
+		// Projected diameter of a bounding sphere as a fraction of the screen's height, _22 of the projection is cot(fovY / 2)
+		float CalculateScreenSize(const Vector4& inWorldBounds, const SPerFrameConstants& inPerFrameConstants)
+		{
+			const Vector3 wsCameraPosition = inPerFrameConstants.m_cameraInverseViewMatrix.Translation();
+			const float boundsDistance = eastl::max(Vector3::Distance(Vector3(inWorldBounds.x, inWorldBounds.y, inWorldBounds.z), wsCameraPosition), inPerFrameConstants.m_cameraNearPlane);
+
+			return inWorldBounds.w * inPerFrameConstants.m_cameraProjectionMatrix._22 / boundsDistance;
+		}
+
+		Vector4 MergeWorldBounds(const Vector4& inFirst, const Vector4& inSecond)
+		{
+			if (inFirst.w < 0.0f || inSecond.w < 0.0f)
+			{
+				return Vector4(0.0f, 0.0f, 0.0f, -1.0f);
+			}
+
+			const Vector3 firstCenter(inFirst.x, inFirst.y, inFirst.z);
+			const Vector3 secondCenter(inSecond.x, inSecond.y, inSecond.z);
+			const float centerDistance = Vector3::Distance(firstCenter, secondCenter);
+
+			if (centerDistance + inSecond.w <= inFirst.w)
+			{
+				return inFirst;
+			}
+
+			if (centerDistance + inFirst.w <= inSecond.w)
+			{
+				return inSecond;
+			}
+
+			const float mergedRadius = (centerDistance + inFirst.w + inSecond.w) * 0.5f;
+			const Vector3 mergedCenter = firstCenter + (secondCenter - firstCenter) * ((mergedRadius - inFirst.w) / centerDistance);
+
+			return Vector4(mergedCenter.x, mergedCenter.y, mergedCenter.z, mergedRadius);
+		}
+
+		// Orders draw items so that the ones that can share an instanced draw end up next to each other
+		bool InstancingSortPredicate(const SDrawItemSnapshot& inFirst, const SDrawItemSnapshot& inSecond)
+		{
+			const SDrawItem& first = *inFirst.m_drawItem;
+			const SDrawItem& second = *inSecond.m_drawItem;
+
+			if (first.m_indexBuffer != second.m_indexBuffer) return first.m_indexBuffer < second.m_indexBuffer;
+			if (first.m_indexOffset != second.m_indexOffset) return first.m_indexOffset < second.m_indexOffset;
+			if (first.m_indexCount != second.m_indexCount) return first.m_indexCount < second.m_indexCount;
+			if (first.m_vertexBufferOffset != second.m_vertexBufferOffset) return first.m_vertexBufferOffset < second.m_vertexBufferOffset;
+			if (first.m_rasterizerState != second.m_rasterizerState) return first.m_rasterizerState < second.m_rasterizerState;
+			if (inFirst.m_lod != inSecond.m_lod) return inFirst.m_lod < inSecond.m_lod;
+			if (inFirst.m_programId != inSecond.m_programId) return inFirst.m_programId < inSecond.m_programId;
+			if (inFirst.m_uploadedConstants.m_perMaterialConstants.m_buffer != inSecond.m_uploadedConstants.m_perMaterialConstants.m_buffer) return inFirst.m_uploadedConstants.m_perMaterialConstants.m_buffer < inSecond.m_uploadedConstants.m_perMaterialConstants.m_buffer;
+			return inFirst.m_uploadedConstants.m_perMaterialConstants.m_offset < inSecond.m_uploadedConstants.m_perMaterialConstants.m_offset;
+		}
 	}
 
 	URenderer::URenderer(): m_frame(static_cast<decltype(m_frame)>(-1))
 	                      , m_window(nullptr)
 	                      , m_currentStateIndex(0)
+	                      , m_queueFrame(0)
+	                      , m_firstReflectionProbeList(0)
+	                      , m_gBufferList(0)
+	                      , m_firstDirShadowList(0)
+	                      , m_firstPointShadowList(0)
+	                      , m_debugList(0)
+	                      , m_lastFrameMapCount(0)
+	                      , m_lastFrameUnbatchedMapCount(0)
+	                      , m_totalMapCount(0)
+	                      , m_totalUnbatchedMapCount(0)
+	                      , m_mapCountFrames(0)
 	                      , m_visualizeOption(EVisualizeOptions::None)
 						  , m_isDebugLayerEnabled(true)
 	{
@@ -45,6 +148,18 @@ namespace MAD
 
 		m_backBuffer = g_graphicsDriver.GetBackBufferRenderTarget();
 
+		// One deferred driver per job thread so passes can be recorded without any synchronization between threads
+		m_recordingDrivers.resize(UJobSystem::GetThreadCount());
+		m_recordingPerDrawConstants.resize(UJobSystem::GetThreadCount());
+		for (auto& currentRecordingDriver : m_recordingDrivers)
+		{
+			currentRecordingDriver = eastl::make_unique<UGraphicsDriver>();
+			if (!currentRecordingDriver->InitDeferred(g_graphicsDriver))
+			{
+				return false;
+			}
+		}
+
 		auto clientSize = inWindow.GetClientSize();
 
 		m_screenViewport.Width = clientSize.x;
@@ -130,6 +245,22 @@ namespace MAD
 
 	void URenderer::Shutdown()
 	{
+		if (m_mapCountFrames > 0)
+		{
+			LOG(LogRenderer, Log, "Averaged %llu buffer maps per frame over %u frames, %llu with a constant buffer update per draw\n",
+				m_totalMapCount / m_mapCountFrames, m_mapCountFrames, m_totalUnbatchedMapCount / m_mapCountFrames);
+		}
+
+		m_recordedCommandLists.clear();
+
+		for (auto& currentRecordingDriver : m_recordingDrivers)
+		{
+			currentRecordingDriver->Shutdown();
+		}
+
+		m_recordingDrivers.clear();
+		m_recordingPerDrawConstants.clear();
+
 		g_graphicsDriver.Shutdown();
 	}
 
@@ -138,13 +269,11 @@ namespace MAD
 		// Queue up this draw item
 		auto result = m_dynamicDrawItems[m_currentStateIndex].insert({ inDrawItem.m_uniqueID, inDrawItem });
 		MAD_ASSERT_DESC(result.second, "Duplicate draw item detected. Either it was submitted twice, or there was a collision in generating its unique ID");
+		(void)result;
 
-		// Check if this draw item was submitted previously
-		auto iter = m_dynamicDrawItems[1 - m_currentStateIndex].find(inDrawItem.m_uniqueID);
-		if (iter != m_dynamicDrawItems[1 - m_currentStateIndex].end())
-		{
-			result.first->second.m_previousDrawTransform = &iter->second.m_transform;
-		}
+		const uint32_t drawSlot = AcquireDynamicDrawSlot(inDrawItem.m_uniqueID);
+		m_dynamicSlotTransforms[m_currentStateIndex][drawSlot] = inDrawItem.m_transform;
+		m_dynamicSlotQueueFrames[m_currentStateIndex][drawSlot] = m_queueFrame;
 	}
 
 	void URenderer::QueueStaticItem(const SDrawItem& inDrawItem)
@@ -174,16 +303,10 @@ namespace MAD
 
 	void URenderer::QueueDirectionalLight(size_t inID, const SGPUDirectionalLight& inDirectionalLight)
 	{
+		// The shadow cascades are fit to the camera every frame, see FitDirectionalShadowCascades
 		auto result = m_queuedDirLights[m_currentStateIndex].insert({ inID, inDirectionalLight });
 		MAD_ASSERT_DESC(result.second, "Duplicate directional light detected. Either it was submitted twice, or there was a collision in generating its unique ID");
-
-		SGPUDirectionalLight& newLight = result.first->second;
-
-		const float sceneRadius = 2000.0f;
-		const Matrix view = Matrix::CreateLookAt(-newLight.m_lightDirection, Vector3::Zero, Vector3::Up);
-		const Matrix proj = Matrix::CreateOrthographic(2 * sceneRadius, 2 * sceneRadius, -1750.0f, 500.0f);
-
-		newLight.m_viewProjectionMatrix = view * proj;
+		(void)result;
 	}
 
 	void URenderer::QueuePointLight(size_t inID, const SGPUPointLight& inPointLight)
@@ -234,6 +357,9 @@ namespace MAD
 	void URenderer::ClearRenderItems()
 	{
 		m_currentStateIndex = 1 - m_currentStateIndex;
+		++m_queueFrame;
+
+		ReleaseStaleDynamicDrawSlots();
 
 		// Clear out the expired debug draw items
 		ClearExpiredDebugDrawItems();
@@ -391,14 +517,17 @@ namespace MAD
 	void URenderer::InitializeDirectionalShadowMappingPass(const eastl::string& inProgramPath)
 	{
 		g_graphicsDriver.DestroyDepthStencil(m_dirShadowMappingPassDescriptor.m_depthStencilView);
-		m_dirShadowMappingPassDescriptor.m_depthStencilView = g_graphicsDriver.CreateDepthStencil(RenderConstants::ShadowMapRes, RenderConstants::ShadowMapRes, &m_shadowMapSRV);
+		// All of the cascades share one atlas, each one renders into its own tile of a 2x2 grid
+		const int shadowAtlasRes = static_cast<int>(RenderConstants::ShadowCascadeRes * 2);
+		m_dirShadowMappingPassDescriptor.m_depthStencilView = g_graphicsDriver.CreateDepthStencil(shadowAtlasRes, shadowAtlasRes, &m_shadowMapSRV);
 		m_dirShadowMappingPassDescriptor.m_depthStencilState = g_graphicsDriver.CreateDepthStencilState(true, EComparisonFunc::Less);
 
 		m_dirShadowMappingPassDescriptor.m_blendState = g_graphicsDriver.CreateBlendState(false);
 
 		if (!m_dirShadowMappingPassDescriptor.m_rasterizerState)
 		{
-			m_dirShadowMappingPassDescriptor.m_rasterizerState = g_graphicsDriver.CreateDepthRasterizerState();
+			// Casters between the light and a cascade get clamped onto its near plane instead of being clipped
+			m_dirShadowMappingPassDescriptor.m_rasterizerState = g_graphicsDriver.CreateDepthRasterizerState(false);
 		}
 
 		m_dirShadowMappingPassDescriptor.m_renderPassProgram = URenderPassProgram::Load(inProgramPath);
@@ -560,6 +689,12 @@ namespace MAD
 	{
 		rmt_ScopedCPUSample(Renderer_BeginFrame, 0);
 
+		GatherFrameMapCount();
+
+		// Nothing from the previous frame references the constant or instance rings anymore
+		g_graphicsDriver.ResetConstantRing();
+		g_graphicsDriver.ResetInstanceRing();
+
 		GPU_EVENT_START(&g_graphicsDriver, Begin_Frame);
 
 		g_graphicsDriver.ClearDepthStencil(m_gBufferPassDescriptor.m_depthStencilView, true, 1.0f);
@@ -587,8 +722,11 @@ namespace MAD
 		m_perFrameConstants.m_frameTime = inFrameTime;
 		BindPerFrameConstants();
 
+		// Record all of the draw item passes up front, they're submitted in a fixed order as we go through the frame
+		RecordPasses(inFramePercent);
+
 		m_globalEnvironmentMap.BindAsShaderResource(ETextureSlot::CubeMap);
-		ProcessReflectionProbes(inFramePercent);
+		ProcessReflectionProbes();
 		m_dynamicEnvironmentMap.BindAsShaderResource(ETextureSlot::CubeMap);
 
 		DrawGBuffer(inFramePercent);
@@ -665,7 +803,9 @@ namespace MAD
 		m_globalEnvironmentMap.BindAsShaderResource(ETextureSlot::CubeMap);
 		m_skySpherePassDescriptor.ApplyPassState(g_graphicsDriver);
 		m_skySpherePassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, 0);
-		m_skySphereDrawItem.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, true, EInputLayoutSemantic::Position);
+		(void)inFramePercent;
+
+		m_skySphereDrawItem.Draw(g_graphicsDriver, m_perFrameConstants, true, EInputLayoutSemantic::Position);
 
 		GPU_EVENT_END(&g_graphicsDriver);
 	}
@@ -674,6 +814,8 @@ namespace MAD
 	{
 		rmt_ScopedCPUSample(Renderer_DrawGBuffer, 0);
 
+		(void)inFramePercent;
+
 		g_graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::LightingBuffer);
 		g_graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::DiffuseBuffer);
 		g_graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::NormalBuffer);
@@ -682,41 +824,8 @@ namespace MAD
 
 		m_gBufferPassDescriptor.ApplyPassState(g_graphicsDriver);
 
-		// Go through both static and dynamic draw items and bind input assembly data
 		GPU_EVENT_START(&g_graphicsDriver, GBuffer);
-
-		GPU_EVENT_START(&g_graphicsDriver, Static);
-		for (auto& currentStaticDrawItem : m_staticDrawItems)
-		{
-			// Before processing the draw item, we need to determine which program it should use and bind that
-			m_gBufferPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, DetermineProgramId(currentStaticDrawItem.second));
-
-			currentStaticDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, true);
-		}
-		GPU_EVENT_END(&g_graphicsDriver);
-
-		GPU_EVENT_START(&g_graphicsDriver, Dynamic);
-		for (auto& currentDynamicDrawItem : m_dynamicDrawItems[m_currentStateIndex])
-		{
-			// Before processing the draw item, we need to determine which program it should use and bind that
-			m_gBufferPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, DetermineProgramId(currentDynamicDrawItem.second));
-
-			// Each individual DrawItem should issue its own draw call
-			currentDynamicDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, true);
-		}
-		GPU_EVENT_END(&g_graphicsDriver);
-
-		GPU_EVENT_START(&g_graphicsDriver, Reflection_Probes);
-		for (auto& currentProbeDrawItem : m_reflectionProbeDrawItems)
-		{
-			// Before processing the draw item, we need to determine which program it should use and bind that
-			m_gBufferPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, DetermineProgramId(currentProbeDrawItem.second));
-
-			// Each individual DrawItem should issue its own draw call
-			currentProbeDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, true);
-		}
-		GPU_EVENT_END(&g_graphicsDriver);
-
+		g_graphicsDriver.ExecuteCommandList(m_recordedCommandLists[m_gBufferList]);
 		GPU_EVENT_END(&g_graphicsDriver);
 
 		if (m_visualizeOption != EVisualizeOptions::None)
@@ -733,6 +842,8 @@ namespace MAD
 	{
 		rmt_ScopedCPUSample(Renderer_DrawDirectionalLighting, 0);
 
+		(void)inFramePercent;
+
 		GPU_EVENT_START(&g_graphicsDriver, Deferred_Directional_Lighting);
 
 		g_graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::DiffuseMap);
@@ -743,61 +854,27 @@ namespace MAD
 		g_graphicsDriver.SetPixelShaderResource(m_gBufferShaderResources[AsIntegral(ETextureSlot::SpecularBuffer) - AsIntegral(ETextureSlot::LightingBuffer)], ETextureSlot::SpecularBuffer);
 		g_graphicsDriver.SetPixelShaderResource(m_gBufferShaderResources[AsIntegral(ETextureSlot::DepthBuffer) - AsIntegral(ETextureSlot::LightingBuffer)], ETextureSlot::DepthBuffer);
 
-		SGPUDirectionalLight directionalLightConstants;
-		for (const auto& currentDirLight : m_queuedDirLights[m_currentStateIndex])
+		const uint32_t numDirLights = static_cast<uint32_t>(m_frameDirLights.size());
+		for (uint32_t i = 0; i < numDirLights; ++i)
 		{
 			GPU_EVENT_START(&g_graphicsDriver, Directional_Light);
 
-			// Interpolate the light's properties
-			const auto previousDirLight = m_queuedDirLights[1 - m_currentStateIndex].find(currentDirLight.first);
-			if (previousDirLight != m_queuedDirLights[1 - m_currentStateIndex].end())
-			{
-				directionalLightConstants = SGPUDirectionalLight::Lerp(previousDirLight->second, currentDirLight.second, inFramePercent);
-			}
-			else
-			{
-				directionalLightConstants = currentDirLight.second;
-			}
-
-			// Transform the light's direction into view space
-			directionalLightConstants.m_lightDirection = Vector3::TransformNormal(directionalLightConstants.m_lightDirection, m_perFrameConstants.m_cameraViewMatrix);
-			g_graphicsDriver.UpdateBuffer(EConstantBufferSlot::PerDirectionalLight, &directionalLightConstants, sizeof(SGPUDirectionalLight));
-
-			// Render shadow map
+			// Render shadow map (the shadow map was bound as a shader resource by the previous light)
 			GPU_EVENT_START(&g_graphicsDriver, Draw_to_Shadowmap);
 			g_graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::DiffuseMap);
-			m_dirShadowMappingPassDescriptor.ApplyPassState(g_graphicsDriver);
-			m_dirShadowMappingPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, static_cast<ProgramId_t>(EProgramIdMask::Lighting_DirectionalLight));
-
-			g_graphicsDriver.ClearDepthStencil(m_dirShadowMappingPassDescriptor.m_depthStencilView, true, 1.0);
-			g_graphicsDriver.SetViewport(0, 0, 4096, 4096);
-
-			GPU_EVENT_START(&g_graphicsDriver, Static);
-			for (auto& currentStaticDrawItem : m_staticDrawItems)
+			for (uint32_t j = 0; j < SPerDirectionalLightConstants::CascadeCount; ++j)
 			{
-				currentStaticDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, false, EInputLayoutSemantic::Position, m_dirShadowMappingPassDescriptor.m_rasterizerState);
-			}
-			GPU_EVENT_END(&g_graphicsDriver);
-
-			GPU_EVENT_START(&g_graphicsDriver, Dynamic);
-			for (auto& currentDynamicDrawItem : m_dynamicDrawItems[m_currentStateIndex])
-			{
-				currentDynamicDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, false, EInputLayoutSemantic::Position, m_dirShadowMappingPassDescriptor.m_rasterizerState);
-			}
-			GPU_EVENT_END(&g_graphicsDriver);
-
-			GPU_EVENT_START(&g_graphicsDriver, Reflection_Probes);
-			for (auto& currentProbeDrawItem : m_reflectionProbeDrawItems)
-			{
-				currentProbeDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, false, EInputLayoutSemantic::Position, m_dirShadowMappingPassDescriptor.m_rasterizerState);
+				GPU_EVENT_START_STR(&g_graphicsDriver, Shadow_Cascade, eastl::wstring(eastl::wstring::CtorSprintf(), L"Shadow Cascade #%d", j));
+				g_graphicsDriver.ExecuteCommandList(m_recordedCommandLists[m_firstDirShadowList + i * SPerDirectionalLightConstants::CascadeCount + j]);
+				GPU_EVENT_END(&g_graphicsDriver);
 			}
 			GPU_EVENT_END(&g_graphicsDriver);
 
-			GPU_EVENT_END(&g_graphicsDriver);
-
 			// Shading + lighting
 			GPU_EVENT_START(&g_graphicsDriver, Lighting);
 
+			g_graphicsDriver.UpdateBuffer(EConstantBufferSlot::PerDirectionalLight, &m_frameDirLights[i], sizeof(SPerDirectionalLightConstants));
+
 			m_dirLightingPassDescriptor.ApplyPassState(g_graphicsDriver);
 			g_graphicsDriver.SetPixelShaderResource(m_shadowMapSRV, ETextureSlot::DiffuseMap);
 			m_dirLightingPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, static_cast<ProgramId_t>(EProgramIdMask::Lighting_DirectionalLight));
@@ -815,73 +892,29 @@ namespace MAD
 	{
 		rmt_ScopedCPUSample(Renderer_DrawPointLighting, 0);
 
+		(void)inFramePercent;
+
 		SPerPointLightConstants pointLightConstants;
-		CubeTransformArray_t shadowMapVPMatrices;
 
 		GPU_EVENT_START(&g_graphicsDriver, Deferred_Point_Lighting);
 
 		m_pointLightingPassDescriptor.ApplyPassState(g_graphicsDriver);
 		m_pointLightingPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, static_cast<ProgramId_t>(EProgramIdMask::Lighting_PointLight));
 
-		for (const auto& currentPointLight : m_queuedPointLights[m_currentStateIndex])
+		const uint32_t numPointLights = static_cast<uint32_t>(m_framePointLights.size());
+		for (uint32_t lightIndex = 0; lightIndex < numPointLights; ++lightIndex)
 		{
 			GPU_EVENT_START(&g_graphicsDriver, Point_Light);
 
-			// Interpolate the light's properties
-			const auto previousPointLight = m_queuedPointLights[1 - m_currentStateIndex].find(currentPointLight.first);
-			if (previousPointLight != m_queuedPointLights[1 - m_currentStateIndex].end())
-			{
-				pointLightConstants.m_pointLight = SGPUPointLight::Lerp(previousPointLight->second, currentPointLight.second, inFramePercent);
-			}
-			else
-			{
-				pointLightConstants.m_pointLight = currentPointLight.second;
-			}
-
-			// TODO Inefficient, we should just calculate once for each point light once as long as it doesn't change position
-			GenerateViewProjectionMatrices(pointLightConstants.m_pointLight.m_lightPosition, shadowMapVPMatrices);
-
-			memcpy(pointLightConstants.m_pointLightVPMatrices, shadowMapVPMatrices.data(), shadowMapVPMatrices.size() * sizeof(Matrix));
+			pointLightConstants = m_framePointLights[lightIndex];
 
 			// Clear the resource slot for the texture cube
 			g_graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::CubeMap);
 
-			m_pointShadowMappingPassDescriptor.ApplyPassState(g_graphicsDriver);
-			m_pointShadowMappingPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, static_cast<ProgramId_t>(EProgramIdMask::Lighting_PointLight));
-
 			for (int i = 0; i < AsIntegral(ETextureCubeFace::MAX); ++i)
 			{
 				GPU_EVENT_START_STR(&g_graphicsDriver, Shadow_Cube_Side, eastl::wstring(eastl::wstring::CtorSprintf(), L"Shadow Cube Side #%d", i));
-
-				// Bind the current side of the shadow texture cube
-				m_depthTextureCube->BindCubeSideAsTarget(i);
-
-				// Update the view-projection matrix of the current cube side in the per point light constant buffer
-				pointLightConstants.m_pointLight.m_viewProjectionMatrix = shadowMapVPMatrices[i];
-				g_graphicsDriver.UpdateBuffer(EConstantBufferSlot::PerPointLight, &pointLightConstants, sizeof(pointLightConstants));
-
-				// Process all of the draw items (static and dynamic) again
-				GPU_EVENT_START(&g_graphicsDriver, Static);
-				for (auto& currentStaticDrawItem : m_staticDrawItems)
-				{
-					currentStaticDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, false, EInputLayoutSemantic::Position, m_pointShadowMappingPassDescriptor.m_rasterizerState);
-				}
-				GPU_EVENT_END(&g_graphicsDriver);
-
-				GPU_EVENT_START(&g_graphicsDriver, Dynamic);
-				for (auto& currentDynamicDrawItem : m_dynamicDrawItems[m_currentStateIndex])
-				{
-					currentDynamicDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, false, EInputLayoutSemantic::Position, m_pointShadowMappingPassDescriptor.m_rasterizerState);
-				}
-				GPU_EVENT_END(&g_graphicsDriver);
-
-				GPU_EVENT_START(&g_graphicsDriver, Reflection_Probes);
-				for (auto& currentProbeDrawItem : m_reflectionProbeDrawItems)
-				{
-					currentProbeDrawItem.second.Draw(g_graphicsDriver, inFramePercent, m_perFrameConstants, false, EInputLayoutSemantic::Position, m_pointShadowMappingPassDescriptor.m_rasterizerState);
-				}
-				GPU_EVENT_END(&g_graphicsDriver);
-
+				g_graphicsDriver.ExecuteCommandList(m_recordedCommandLists[m_firstPointShadowList + lightIndex * AsIntegral(ETextureCubeFace::MAX) + i]);
 				GPU_EVENT_END(&g_graphicsDriver);
 			}
 
@@ -953,27 +986,483 @@ namespace MAD
 
 		rmt_ScopedCPUSample(Renderer_DrawDebugPrimitives, 0);
 
+		(void)inFramePerecent;
+
 		GPU_EVENT_START(&g_graphicsDriver, Debug_Layer);
 
 		// Make sure the g buffer depth stencil shader resource view is not bound because we're using it as our depth stencil view here
 		g_graphicsDriver.SetPixelShaderResource(nullptr, ETextureSlot::DepthBuffer);
 
-		m_debugPassDescriptor.ApplyPassState(g_graphicsDriver);
-		m_debugPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, 0);
+		g_graphicsDriver.ExecuteCommandList(m_recordedCommandLists[m_debugList]);
 
-		// Process the debug draw items
-		for (auto& currentDebugDrawItem : m_debugDrawItems)
+		GPU_EVENT_END(&g_graphicsDriver);
+	}
+
+	void URenderer::ProcessReflectionProbes()
+	{
+		rmt_ScopedCPUSample(Renderer_ProcessReflectionProbes, 0);
+
+		GPU_EVENT_START(&g_graphicsDriver, Process_Reflection_Probes);
+
+		// Generate the environment maps for the probes (for now, assume we only have one)
+		for (uint8_t i = 0; i < AsIntegral(ETextureCubeFace::MAX); ++i)
 		{
-			currentDebugDrawItem.m_debugDrawItem.Draw(g_graphicsDriver, inFramePerecent, m_perFrameConstants, false);
+			g_graphicsDriver.ExecuteCommandList(m_recordedCommandLists[m_firstReflectionProbeList + i]);
 		}
 
 		GPU_EVENT_END(&g_graphicsDriver);
 	}
 
-	void URenderer::ProcessReflectionProbes(float inFramePercent)
+	void URenderer::RecordPasses(float inFramePercent)
 	{
-		rmt_ScopedCPUSample(Renderer_ProcessReflectionProbes, 0);
+		rmt_ScopedCPUSample(Renderer_RecordPasses, 0);
+
+		// Snapshot the draw items, each pass walks these instead of the containers
+		m_staticSnapshot.clear();
+		m_dynamicSnapshot.clear();
+		m_reflectionProbeSnapshot.clear();
+		m_instancingCandidates.clear();
+		m_frameObjectToWorldMatrices.clear();
+		m_frameWorldBounds.clear();
+		m_drawItemLODs[m_frame % 2].clear();
+
+		// Materials of meshes destroyed since the last frame hand their cached constants back before anything new is cached
+		m_releasedMaterialIDs.clear();
+		UMaterial::TakeCachedConstantsReleases(m_releasedMaterialIDs);
+
+		for (uint32_t currentMaterialID : m_releasedMaterialIDs)
+		{
+			g_graphicsDriver.ReleaseCachedConstants(currentMaterialID);
+		}
+
+		// Every object to world matrix is built exactly once here, all of the passes (and all of the cube faces) reuse them
+		for (const auto& currentStaticDrawItem : m_staticDrawItems)
+		{
+			AddDrawItemSnapshot(m_staticSnapshot, currentStaticDrawItem.second, currentStaticDrawItem.second.m_transform.GetMatrix(), true, true);
+		}
+
+		for (const auto& currentDynamicDrawItem : m_dynamicDrawItems[m_currentStateIndex])
+		{
+			const uint32_t drawSlot = m_dynamicDrawSlots.find(currentDynamicDrawItem.first)->second;
+			const ULinearTransform& currentTransform = m_dynamicSlotTransforms[m_currentStateIndex][drawSlot];
+
+			// Only interpolate if the item was also queued the frame before, otherwise the previous transform belongs to nothing
+			if (m_dynamicSlotQueueFrames[1 - m_currentStateIndex][drawSlot] + 1 == m_queueFrame)
+			{
+				const ULinearTransform interpolatedTransform = ULinearTransform::Lerp(m_dynamicSlotTransforms[1 - m_currentStateIndex][drawSlot], currentTransform, inFramePercent);
+				AddDrawItemSnapshot(m_dynamicSnapshot, currentDynamicDrawItem.second, interpolatedTransform.GetMatrix(), true, true);
+			}
+			else
+			{
+				AddDrawItemSnapshot(m_dynamicSnapshot, currentDynamicDrawItem.second, currentTransform.GetMatrix(), true, true);
+			}
+		}
+
+		for (const auto& currentProbeDrawItem : m_reflectionProbeDrawItems)
+		{
+			AddDrawItemSnapshot(m_reflectionProbeSnapshot, currentProbeDrawItem.second, currentProbeDrawItem.second.m_transform.GetMatrix());
+		}
+
+		// Materials that changed (or were seen for the first time) get uploaded here, everything else was uploaded in a previous frame
+		g_graphicsDriver.FlushCachedConstants();
+
+		BuildInstancedDraws();
+
+		// The G-buffer and shadow passes all see the scene through the main camera's per frame constants, so their per draw
+		// constants only need to be written once. The command lists just bind sub-ranges of the immediate driver's constant ring
+		const size_t perDrawUploadCount = m_staticSnapshot.size() + m_dynamicSnapshot.size() + m_reflectionProbeSnapshot.size();
+		g_graphicsDriver.ReserveConstantRing(static_cast<UINT>(perDrawUploadCount) * UGraphicsDriver::GetConstantAllocationSize(sizeof(SPerDrawConstants)));
+
+		UploadMainViewPerDrawConstants(m_staticSnapshot);
+		UploadMainViewPerDrawConstants(m_dynamicSnapshot);
+		UploadMainViewPerDrawConstants(m_reflectionProbeSnapshot);
+
+		// Interpolate the lights on the main thread so the shadow jobs and the lighting pass see the same values
+		m_frameDirLights.clear();
+		m_frameDirCascades.clear();
+		for (const auto& currentDirLight : m_queuedDirLights[m_currentStateIndex])
+		{
+			SPerDirectionalLightConstants directionalLightConstants;
+
+			const auto previousDirLight = m_queuedDirLights[1 - m_currentStateIndex].find(currentDirLight.first);
+			if (previousDirLight != m_queuedDirLights[1 - m_currentStateIndex].end())
+			{
+				directionalLightConstants.m_directionalLight = SGPUDirectionalLight::Lerp(previousDirLight->second, currentDirLight.second, inFramePercent);
+			}
+			else
+			{
+				directionalLightConstants.m_directionalLight = currentDirLight.second;
+			}
+
+			FitDirectionalShadowCascades(directionalLightConstants.m_directionalLight.m_lightDirection, directionalLightConstants);
+
+			// Transform the light's direction into view space
+			directionalLightConstants.m_directionalLight.m_lightDirection = Vector3::TransformNormal(directionalLightConstants.m_directionalLight.m_lightDirection, m_perFrameConstants.m_cameraViewMatrix);
+			m_frameDirLights.push_back(directionalLightConstants);
+		}
+
+		m_framePointLights.clear();
+		for (const auto& currentPointLight : m_queuedPointLights[m_currentStateIndex])
+		{
+			SPerPointLightConstants pointLightConstants;
+
+			const auto previousPointLight = m_queuedPointLights[1 - m_currentStateIndex].find(currentPointLight.first);
+			if (previousPointLight != m_queuedPointLights[1 - m_currentStateIndex].end())
+			{
+				pointLightConstants.m_pointLight = SGPUPointLight::Lerp(previousPointLight->second, currentPointLight.second, inFramePercent);
+			}
+			else
+			{
+				pointLightConstants.m_pointLight = currentPointLight.second;
+			}
+
+			// TODO Inefficient, we should just calculate once for each point light once as long as it doesn't change position
+			CubeTransformArray_t shadowMapVPMatrices;
+			GenerateViewProjectionMatrices(pointLightConstants.m_pointLight.m_lightPosition, shadowMapVPMatrices);
+
+			memcpy(pointLightConstants.m_pointLightVPMatrices, shadowMapVPMatrices.data(), shadowMapVPMatrices.size() * sizeof(Matrix));
+
+			// The lighting pass has always seen the last cube side's matrix here
+			pointLightConstants.m_pointLight.m_viewProjectionMatrix = shadowMapVPMatrices[AsIntegral(ETextureCubeFace::MAX) - 1];
+
+			m_framePointLights.push_back(pointLightConstants);
+		}
+
+		MAD_ASSERT_DESC(m_reflectionProbeSnapshot.size() == 1, "TODO: Only supports 1 reflection probe currently");
+		GenerateViewMatrices(m_reflectionProbeSnapshot[0].m_drawItem->m_transform.GetTranslation(), m_probeViewMatrices, m_probeProjectionMatrix);
+
+		// Build the job list in submission order
+		m_passRecordJobs.clear();
+
+		m_firstReflectionProbeList = AddPassRecordJob(ERecordedPass::ReflectionProbeFace, 0, 0);
+		for (uint8_t i = 1; i < AsIntegral(ETextureCubeFace::MAX); ++i)
+		{
+			AddPassRecordJob(ERecordedPass::ReflectionProbeFace, 0, i);
+		}
+
+		m_gBufferList = AddPassRecordJob(ERecordedPass::GBuffer);
+
+		m_firstDirShadowList = static_cast<uint32_t>(m_passRecordJobs.size());
+		for (uint32_t i = 0; i < m_frameDirLights.size(); ++i)
+		{
+			for (uint8_t j = 0; j < SPerDirectionalLightConstants::CascadeCount; ++j)
+			{
+				AddPassRecordJob(ERecordedPass::DirectionalShadow, i, j);
+			}
+		}
+
+		m_firstPointShadowList = static_cast<uint32_t>(m_passRecordJobs.size());
+		for (uint32_t i = 0; i < m_framePointLights.size(); ++i)
+		{
+			for (uint8_t j = 0; j < AsIntegral(ETextureCubeFace::MAX); ++j)
+			{
+				AddPassRecordJob(ERecordedPass::PointShadowFace, i, j);
+			}
+		}
+
+		m_debugList = AddPassRecordJob(ERecordedPass::DebugPrimitives);
+
+		m_recordedCommandLists.clear();
+		m_recordedCommandLists.resize(m_passRecordJobs.size());
+
+		UJobSystem::ParallelFor(static_cast<uint32_t>(m_passRecordJobs.size()), [this](uint32_t inJobIndex)
+		{
+			RecordPass(m_passRecordJobs[inJobIndex], m_recordedCommandLists[inJobIndex]);
+		});
+	}
+
+	uint32_t URenderer::AcquireDynamicDrawSlot(size_t inUniqueID)
+	{
+		const auto existingSlot = m_dynamicDrawSlots.find(inUniqueID);
+		if (existingSlot != m_dynamicDrawSlots.end())
+		{
+			return existingSlot->second;
+		}
+
+		uint32_t newSlot;
+		if (!m_freeDynamicDrawSlots.empty())
+		{
+			newSlot = m_freeDynamicDrawSlots.back();
+			m_freeDynamicDrawSlots.pop_back();
+		}
+		else
+		{
+			newSlot = static_cast<uint32_t>(m_dynamicSlotTransforms[0].size());
+
+			for (int i = 0; i < 2; ++i)
+			{
+				m_dynamicSlotTransforms[i].emplace_back();
+				m_dynamicSlotQueueFrames[i].push_back(0);
+			}
+		}
+
+		// Make sure whatever used the slot before can't be mistaken for this item's previous state
+		m_dynamicSlotQueueFrames[1 - m_currentStateIndex][newSlot] = m_queueFrame;
+
+		m_dynamicDrawSlots.insert({ inUniqueID, newSlot });
+		return newSlot;
+	}
+
+	void URenderer::ReleaseStaleDynamicDrawSlots()
+	{
+		// Slots of items that weren't queued last frame won't be interpolated anymore, so they can be handed out again
+		for (auto iter = m_dynamicDrawSlots.begin(); iter != m_dynamicDrawSlots.end();)
+		{
+			if (m_dynamicSlotQueueFrames[1 - m_currentStateIndex][iter->second] + 1 < m_queueFrame)
+			{
+				m_freeDynamicDrawSlots.push_back(iter->second);
+				iter = m_dynamicDrawSlots.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+	}
+
+	void URenderer::AddDrawItemSnapshot(eastl::vector<SDrawItemSnapshot>& inOutSnapshot, const SDrawItem& inDrawItem, const Matrix& inObjectToWorldMatrix, bool inAllowInstancing, bool inSelectLOD)
+	{
+		SDrawItemSnapshot newSnapshot;
+		newSnapshot.m_drawItem = &inDrawItem;
+		newSnapshot.m_programId = DetermineProgramId(inDrawItem);
+		newSnapshot.m_objectToWorldIndex = static_cast<uint32_t>(m_frameObjectToWorldMatrices.size());
+		newSnapshot.m_lod = 0;
+		newSnapshot.m_shadowLOD = 0;
+
+		m_frameObjectToWorldMatrices.push_back(inObjectToWorldMatrix);
+		m_frameWorldBounds.push_back(CalculateWorldBounds(inDrawItem, inObjectToWorldMatrix));
+
+		if (inSelectLOD && inDrawItem.m_lodCount > 1)
+		{
+			const auto& previousLODs = m_drawItemLODs[1 - m_frame % 2];
+			const auto previousLOD = previousLODs.find(inDrawItem.m_uniqueID);
+
+			newSnapshot.m_lod = SelectDrawItemLOD(inDrawItem, m_frameWorldBounds.back(), previousLOD != previousLODs.end() ? previousLOD->second : 0);
+			newSnapshot.m_shadowLOD = static_cast<uint8_t>(eastl::min(newSnapshot.m_lod + RenderConstants::ShadowLODBias, inDrawItem.m_lodCount - 1));
+
+			m_drawItemLODs[m_frame % 2][inDrawItem.m_uniqueID] = newSnapshot.m_lod;
+		}
+
+		// Only the main view selects LODs, so it's also the one that decides how much of each streamed texture is needed.
+		// Textures are assumed to span their item once, unbounded items get as many pixels as the screen is high
+		if (inSelectLOD && !inDrawItem.m_shaderResources.empty())
+		{
+			const Vector4& worldBounds = m_frameWorldBounds.back();
+			const float screenFraction = worldBounds.w < 0.0f ? 1.0f : CalculateScreenSize(worldBounds, m_perFrameConstants);
+
+			for (const auto& currentTexture : inDrawItem.m_shaderResources)
+			{
+				if (currentTexture.second->IsStreamed())
+				{
+					UTextureStreamer::RequestSize(*currentTexture.second, screenFraction * m_screenViewport.Height);
+				}
+			}
+		}
+
+		for (const auto& cBufferData : inDrawItem.m_constantBufferData)
+		{
+			if (cBufferData.first == EConstantBufferSlot::PerMaterial && inDrawItem.m_materialID != 0)
+			{
+				newSnapshot.m_uploadedConstants.m_perMaterialConstants = g_graphicsDriver.CacheConstants(inDrawItem.m_materialID, cBufferData.second.first, cBufferData.second.second);
+			}
+		}
+
+		// Only indexed meshes with a material can be grouped, we need something that identifies the mesh and material they share
+		if (inAllowInstancing && inDrawItem.m_indexCount > 0 && newSnapshot.m_uploadedConstants.m_perMaterialConstants.IsValid())
+		{
+			m_instancingCandidates.push_back({ newSnapshot, &inOutSnapshot });
+		}
+		else
+		{
+			inOutSnapshot.push_back(newSnapshot);
+		}
+	}
+
+	uint8_t URenderer::SelectDrawItemLOD(const SDrawItem& inDrawItem, const Vector4& inWorldBounds, uint8_t inPreviousLOD) const
+	{
+		if (inWorldBounds.w < 0.0f)
+		{
+			return 0;
+		}
+
+		const float screenSize = CalculateScreenSize(inWorldBounds, m_perFrameConstants);
+
+		uint8_t selectedLOD = 0;
+		while (selectedLOD + 1u < inDrawItem.m_lodCount)
+		{
+			// Thresholds on the far side of the previous LOD are moved away from it
+			float lodScreenSize = RenderConstants::MeshLODScreenSizes[selectedLOD];
+			lodScreenSize *= selectedLOD < inPreviousLOD ? 1.0f + RenderConstants::MeshLODHysteresis : 1.0f - RenderConstants::MeshLODHysteresis;
+
+			if (screenSize >= lodScreenSize)
+			{
+				break;
+			}
+
+			++selectedLOD;
+		}
+
+		return selectedLOD;
+	}
+
+	void URenderer::BuildInstancedDraws()
+	{
+		rmt_ScopedCPUSample(Renderer_BuildInstancedDraws, 0);
+
+		m_instancedSnapshot.clear();
+		m_frameInstanceData.clear();
+
+		eastl::sort(m_instancingCandidates.begin(), m_instancingCandidates.end(), [](const eastl::pair<SDrawItemSnapshot, eastl::vector<SDrawItemSnapshot>*>& inFirst, const eastl::pair<SDrawItemSnapshot, eastl::vector<SDrawItemSnapshot>*>& inSecond)
+		{
+			return InstancingSortPredicate(inFirst.first, inSecond.first);
+		});
+
+		size_t groupBegin = 0;
+		while (groupBegin < m_instancingCandidates.size())
+		{
+			size_t groupEnd = groupBegin + 1;
+			while (groupEnd < m_instancingCandidates.size() && CanShareInstancedDraw(m_instancingCandidates[groupBegin].first, m_instancingCandidates[groupEnd].first))
+			{
+				++groupEnd;
+			}
+
+			if (groupEnd - groupBegin < g_minInstancedGroupSize)
+			{
+				for (size_t i = groupBegin; i < groupEnd; ++i)
+				{
+					m_instancingCandidates[i].second->push_back(m_instancingCandidates[i].first);
+				}
+			}
+			else
+			{
+				SInstancedDrawSnapshot newGroup;
+				newGroup.m_snapshot = m_instancingCandidates[groupBegin].first;
+				newGroup.m_instances.m_offset = static_cast<UINT>(m_frameInstanceData.size()); // Patched into a byte offset once the data is uploaded
+				newGroup.m_instances.m_instanceCount = static_cast<UINT>(groupEnd - groupBegin);
+				newGroup.m_worldBounds = m_frameWorldBounds[newGroup.m_snapshot.m_objectToWorldIndex];
+
+				for (size_t i = groupBegin; i < groupEnd; ++i)
+				{
+					SPerInstanceData instanceData;
+					instanceData.m_objectToWorldMatrix = m_frameObjectToWorldMatrices[m_instancingCandidates[i].first.m_objectToWorldIndex];
+					m_frameInstanceData.push_back(instanceData);
+
+					newGroup.m_worldBounds = MergeWorldBounds(newGroup.m_worldBounds, m_frameWorldBounds[m_instancingCandidates[i].first.m_objectToWorldIndex]);
+				}
+
+				m_instancedSnapshot.push_back(newGroup);
+			}
+
+			groupBegin = groupEnd;
+		}
+
+		if (m_frameInstanceData.empty())
+		{
+			return;
+		}
+
+		// Every group's transforms go up in a single upload, each group just binds its own part of it
+		const SInstanceBufferRange uploadedInstances = g_graphicsDriver.UploadInstanceData(m_frameInstanceData.data(), static_cast<UINT>(m_frameInstanceData.size()));
+
+		for (auto& currentGroup : m_instancedSnapshot)
+		{
+			currentGroup.m_instances.m_buffer = uploadedInstances.m_buffer;
+			currentGroup.m_instances.m_offset = uploadedInstances.m_offset + currentGroup.m_instances.m_offset * sizeof(SPerInstanceData);
+		}
+	}
+
+	void URenderer::UploadPerDrawConstants(UGraphicsDriver& inGraphicsDriver, const SPerFrameConstants& inPerFrameConstants, const eastl::vector<SDrawItemSnapshot>& inSnapshot, eastl::vector<SConstantBufferRange>& outPerDrawConstants) const
+	{
+		if (inSnapshot.empty())
+		{
+			return;
+		}
+
+		SPerDrawConstants perDrawConstants;
+
+		// Appended, so that several snapshots can share one list
+		outPerDrawConstants.reserve(outPerDrawConstants.size() + inSnapshot.size());
+		inGraphicsDriver.BeginConstantBatch(static_cast<UINT>(inSnapshot.size()) * UGraphicsDriver::GetConstantAllocationSize(sizeof(SPerDrawConstants)));
+
+		for (const auto& currentSnapshot : inSnapshot)
+		{
+			SDrawItem::CalculatePerDrawConstants(m_frameObjectToWorldMatrices[currentSnapshot.m_objectToWorldIndex], inPerFrameConstants, perDrawConstants);
+			outPerDrawConstants.push_back(inGraphicsDriver.PushConstants(&perDrawConstants, sizeof(perDrawConstants)));
+		}
+
+		inGraphicsDriver.EndConstantBatch();
+	}
+
+	void URenderer::UploadMainViewPerDrawConstants(eastl::vector<SDrawItemSnapshot>& inOutSnapshot)
+	{
+		m_mainViewPerDrawConstants.clear();
+		UploadPerDrawConstants(g_graphicsDriver, m_perFrameConstants, inOutSnapshot, m_mainViewPerDrawConstants);
+
+		for (size_t i = 0; i < m_mainViewPerDrawConstants.size(); ++i)
+		{
+			inOutSnapshot[i].m_uploadedConstants.m_perDrawConstants = eastl::move(m_mainViewPerDrawConstants[i]);
+		}
+	}
+
+	void URenderer::GatherFrameMapCount()
+	{
+		m_lastFrameMapCount = g_graphicsDriver.GetMapCount();
+		m_lastFrameUnbatchedMapCount = g_graphicsDriver.GetUnbatchedMapCount();
+		g_graphicsDriver.ResetMapCount();
+
+		for (auto& currentRecordingDriver : m_recordingDrivers)
+		{
+			m_lastFrameMapCount += currentRecordingDriver->GetMapCount();
+			m_lastFrameUnbatchedMapCount += currentRecordingDriver->GetUnbatchedMapCount();
+			currentRecordingDriver->ResetMapCount();
+		}
 
+		m_totalMapCount += m_lastFrameMapCount;
+		m_totalUnbatchedMapCount += m_lastFrameUnbatchedMapCount;
+		++m_mapCountFrames;
+	}
+
+	uint32_t URenderer::AddPassRecordJob(ERecordedPass inPass, uint32_t inLightIndex, uint8_t inFaceIndex)
+	{
+		m_passRecordJobs.push_back({ inPass, inLightIndex, inFaceIndex });
+		return static_cast<uint32_t>(m_passRecordJobs.size() - 1);
+	}
+
+	void URenderer::RecordPass(const SPassRecordJob& inJob, CommandListPtr_t& outCommandList) const
+	{
+		UGraphicsDriver& recordingDriver = *m_recordingDrivers[UJobSystem::GetCurrentThreadIndex()];
+
+		recordingDriver.BeginCommandList();
+
+		// The recording driver has its own constant buffers, so the shared constants need to be staged again for each list
+		recordingDriver.UpdateBuffer(EConstantBufferSlot::PerScene, &m_perSceneConstants, sizeof(m_perSceneConstants));
+		recordingDriver.UpdateBuffer(EConstantBufferSlot::PerFrame, &m_perFrameConstants, sizeof(m_perFrameConstants));
+		recordingDriver.SetViewport(m_screenViewport);
+
+		switch (inJob.m_pass)
+		{
+		case ERecordedPass::ReflectionProbeFace:
+			RecordReflectionProbeFace(recordingDriver, inJob.m_faceIndex);
+			break;
+		case ERecordedPass::GBuffer:
+			RecordGBuffer(recordingDriver);
+			break;
+		case ERecordedPass::DirectionalShadow:
+			RecordDirectionalShadowCascade(recordingDriver, inJob.m_lightIndex, inJob.m_faceIndex);
+			break;
+		case ERecordedPass::PointShadowFace:
+			RecordPointShadowFace(recordingDriver, inJob.m_lightIndex, inJob.m_faceIndex);
+			break;
+		case ERecordedPass::DebugPrimitives:
+			RecordDebugPrimitives(recordingDriver);
+			break;
+		}
+
+		outCommandList = recordingDriver.FinishCommandList();
+	}
+
+	void URenderer::RecordReflectionProbeFace(UGraphicsDriver& inRecordingDriver, uint8_t inCubeFace) const
+	{
 		static const wchar_t* CubeSideNames[] =
 		{
 			L"Positive X",
@@ -984,9 +1473,6 @@ namespace MAD
 			L"Negative Z"
 		};
 
-		MAD_ASSERT_DESC(m_reflectionProbeDrawItems.size() == 1, "TODO: Only supports 1 reflection probe currently");
-		CubeTransformArray_t probeViewMatrices;
-		Matrix probeProjectionMatrix;
 		InputLayoutFlags_t reflectionInputLayoutOverride = 0;
 		ProgramId_t programIdOverride = 0;
 
@@ -997,62 +1483,257 @@ namespace MAD
 		programIdOverride |= static_cast<ProgramId_t>(EProgramIdMask::GBuffer_Diffuse);
 		programIdOverride |= static_cast<ProgramId_t>(EProgramIdMask::GBuffer_OpacityMask);
 
-		const SDrawItem& currentProbeItem = m_reflectionProbeDrawItems.begin()->second;
+		SPerFrameConstants perFrameConstants = m_perFrameConstants;
 
-		GPU_EVENT_START(&g_graphicsDriver, Process_Reflection_Probes);
+		GPU_MARKER_START(&inRecordingDriver, eastl::wstring(eastl::wstring::CtorSprintf(), L"Reflection Probe Cube Side: %s", CubeSideNames[inCubeFace]));
 
-		// Generate the environment maps for the probes (for now, assume we only have one)
-		GenerateViewMatrices(currentProbeItem.m_transform.GetTranslation(), probeViewMatrices, probeProjectionMatrix);
+		// Update the view-projection matrix of the current cube side in the per frame constant buffer
+		perFrameConstants.m_cameraViewMatrix = m_probeViewMatrices[inCubeFace];
+		perFrameConstants.m_cameraInverseViewMatrix = m_probeViewMatrices[inCubeFace].Invert();
+		perFrameConstants.m_cameraViewProjectionMatrix = m_probeViewMatrices[inCubeFace] * m_probeProjectionMatrix;
+		inRecordingDriver.UpdateBuffer(EConstantBufferSlot::PerFrame, &perFrameConstants, sizeof(perFrameConstants));
 
-		m_reflectionPassDescriptor.ApplyPassState(g_graphicsDriver);
+		m_reflectionPassDescriptor.ApplyPassState(inRecordingDriver);
+		m_dynamicEnvironmentMap.BindCubeSideAsTarget(inRecordingDriver, inCubeFace);
 
-		for (uint8_t i = 0; i < AsIntegral(ETextureCubeFace::MAX); ++i)
+		GPU_MARKER_START(&inRecordingDriver, L"Sky_Sphere");
+		inRecordingDriver.SetPixelShaderResource(m_globalEnvironmentMap.GetShaderResource(), ETextureSlot::CubeMap);
+		m_reflectionPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, DetermineProgramId(m_skySphereDrawItem));
+		m_skySphereDrawItem.Draw(inRecordingDriver, perFrameConstants, true);
+		GPU_MARKER_END(&inRecordingDriver);
+
+		// The probe looks at the scene from a different point of view, so the per draw constants need to be written again for
+		// this face. They go in this thread's own list (static items first, then dynamic), the snapshots are shared by every job
+		eastl::vector<SConstantBufferRange>& facePerDrawConstants = m_recordingPerDrawConstants[UJobSystem::GetCurrentThreadIndex()];
+		facePerDrawConstants.clear();
+		UploadPerDrawConstants(inRecordingDriver, perFrameConstants, m_staticSnapshot, facePerDrawConstants);
+		UploadPerDrawConstants(inRecordingDriver, perFrameConstants, m_dynamicSnapshot, facePerDrawConstants);
+
+		const auto drawFaceItem = [this, &inRecordingDriver, &perFrameConstants, &facePerDrawConstants, programIdOverride, reflectionInputLayoutOverride](const SDrawItemSnapshot& inSnapshot, size_t inPerDrawIndex)
 		{
-			SPerFrameConstants perFrameConstants = m_perFrameConstants;
+			SDrawItemConstants faceConstants;
+			faceConstants.m_perDrawConstants = facePerDrawConstants[inPerDrawIndex];
+			faceConstants.m_perMaterialConstants = inSnapshot.m_uploadedConstants.m_perMaterialConstants;
 
-			GPU_EVENT_START_STR(&g_graphicsDriver, Reflection_Probe_Side, eastl::wstring(eastl::wstring::CtorSprintf(), L"Reflection Probe Cube Side: %s", CubeSideNames[i]));
+			m_reflectionPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, programIdOverride & inSnapshot.m_programId);
 
-			// Update the view-projection matrix of the current cube side in the per point light constant buffer
-			perFrameConstants.m_cameraViewMatrix = probeViewMatrices[i];
-			perFrameConstants.m_cameraInverseViewMatrix = probeViewMatrices[i].Invert();
-			perFrameConstants.m_cameraViewProjectionMatrix = probeViewMatrices[i] * probeProjectionMatrix;
-			g_graphicsDriver.UpdateBuffer(EConstantBufferSlot::PerFrame, &perFrameConstants, sizeof(perFrameConstants));
+			inSnapshot.m_drawItem->Draw(inRecordingDriver, perFrameConstants, true, reflectionInputLayoutOverride, nullptr, &faceConstants, inSnapshot.m_shadowLOD);
+		};
 
-			m_dynamicEnvironmentMap.BindCubeSideAsTarget(i);
+		// Process all of the draw items (static and dynamic) again
+		GPU_MARKER_START(&inRecordingDriver, L"Static");
+		for (size_t i = 0; i < m_staticSnapshot.size(); ++i)
+		{
+			drawFaceItem(m_staticSnapshot[i], i);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
 
-			GPU_EVENT_START(&g_graphicsDriver, Sky_Sphere);
-			g_graphicsDriver.SetPixelShaderResource(m_globalEnvironmentMap.GetShaderResource(), ETextureSlot::CubeMap);
-			m_reflectionPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, DetermineProgramId(m_skySphereDrawItem));
-			m_skySphereDrawItem.Draw(g_graphicsDriver, inFramePercent, perFrameConstants, true);
-			GPU_EVENT_END(&g_graphicsDriver);
+		GPU_MARKER_START(&inRecordingDriver, L"Dynamic");
+		for (size_t i = 0; i < m_dynamicSnapshot.size(); ++i)
+		{
+			drawFaceItem(m_dynamicSnapshot[i], m_staticSnapshot.size() + i);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
 
-			// Process all of the draw items (static and dynamic) again
-			GPU_EVENT_START(&g_graphicsDriver, Static);
-			for (auto& currentStaticDrawItem : m_staticDrawItems)
-			{
-				m_reflectionPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, programIdOverride & DetermineProgramId(currentStaticDrawItem.second));
+		// Instance transforms are world space only, so the same instance data works from the probe's point of view too
+		GPU_MARKER_START(&inRecordingDriver, L"Instanced");
+		for (const auto& currentInstancedItem : m_instancedSnapshot)
+		{
+			m_reflectionPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, (programIdOverride & currentInstancedItem.m_snapshot.m_programId) | static_cast<ProgramId_t>(EProgramIdMask::Geometry_Instanced));
 
-				currentStaticDrawItem.second.Draw(g_graphicsDriver, inFramePercent, perFrameConstants, true, reflectionInputLayoutOverride);
-			}
+			currentInstancedItem.m_snapshot.m_drawItem->DrawInstanced(inRecordingDriver, currentInstancedItem.m_instances, true, reflectionInputLayoutOverride, nullptr, &currentInstancedItem.m_snapshot.m_uploadedConstants, currentInstancedItem.m_snapshot.m_shadowLOD);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
 
-			GPU_EVENT_END(&g_graphicsDriver);
+		GPU_MARKER_END(&inRecordingDriver);
+	}
+
+	void URenderer::RecordGBuffer(UGraphicsDriver& inRecordingDriver) const
+	{
+		// Command lists start out with nothing bound, so bind the dynamic environment map ourselves
+		inRecordingDriver.SetPixelShaderResource(m_dynamicEnvironmentMap.GetShaderResource(), ETextureSlot::CubeMap);
+
+		m_gBufferPassDescriptor.ApplyPassState(inRecordingDriver);
+
+		// Go through both static and dynamic draw items and bind input assembly data
+		GPU_MARKER_START(&inRecordingDriver, L"Static");
+		for (const auto& currentStaticItem : m_staticSnapshot)
+		{
+			// Before processing the draw item, we need to determine which program it should use and bind that
+			m_gBufferPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, currentStaticItem.m_programId);
+
+			currentStaticItem.m_drawItem->Draw(inRecordingDriver, m_perFrameConstants, true, eastl::numeric_limits<InputLayoutFlags_t>::max(), nullptr, &currentStaticItem.m_uploadedConstants, currentStaticItem.m_lod);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
+
+		GPU_MARKER_START(&inRecordingDriver, L"Dynamic");
+		for (const auto& currentDynamicItem : m_dynamicSnapshot)
+		{
+			// Before processing the draw item, we need to determine which program it should use and bind that
+			m_gBufferPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, currentDynamicItem.m_programId);
+
+			// Each individual DrawItem should issue its own draw call
+			currentDynamicItem.m_drawItem->Draw(inRecordingDriver, m_perFrameConstants, true, eastl::numeric_limits<InputLayoutFlags_t>::max(), nullptr, &currentDynamicItem.m_uploadedConstants, currentDynamicItem.m_lod);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
+
+		GPU_MARKER_START(&inRecordingDriver, L"Instanced");
+		for (const auto& currentInstancedItem : m_instancedSnapshot)
+		{
+			m_gBufferPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, currentInstancedItem.m_snapshot.m_programId | static_cast<ProgramId_t>(EProgramIdMask::Geometry_Instanced));
+
+			// One draw call for every draw item in the group
+			currentInstancedItem.m_snapshot.m_drawItem->DrawInstanced(inRecordingDriver, currentInstancedItem.m_instances, true, eastl::numeric_limits<InputLayoutFlags_t>::max(), nullptr, &currentInstancedItem.m_snapshot.m_uploadedConstants, currentInstancedItem.m_snapshot.m_lod);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
+
+		GPU_MARKER_START(&inRecordingDriver, L"Reflection_Probes");
+		for (const auto& currentProbeItem : m_reflectionProbeSnapshot)
+		{
+			// Before processing the draw item, we need to determine which program it should use and bind that
+			m_gBufferPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, currentProbeItem.m_programId);
 
-			GPU_EVENT_START(&g_graphicsDriver, Dynamic);
-			for (auto& currentDynamicDrawItem : m_dynamicDrawItems[m_currentStateIndex])
+			// Each individual DrawItem should issue its own draw call
+			currentProbeItem.m_drawItem->Draw(inRecordingDriver, m_perFrameConstants, true, eastl::numeric_limits<InputLayoutFlags_t>::max(), nullptr, &currentProbeItem.m_uploadedConstants);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
+	}
+
+	void URenderer::RecordDirectionalShadowCascade(UGraphicsDriver& inRecordingDriver, uint32_t inLightIndex, uint8_t inCascadeIndex) const
+	{
+		const SShadowCascade& cascade = m_frameDirCascades[inLightIndex * SPerDirectionalLightConstants::CascadeCount + inCascadeIndex];
+
+		// The depth shader renders with the light's view-projection matrix, so point it at the current cascade
+		SPerDirectionalLightConstants directionalLightConstants = m_frameDirLights[inLightIndex];
+		directionalLightConstants.m_directionalLight.m_viewProjectionMatrix = cascade.m_viewProjectionMatrix;
+		inRecordingDriver.UpdateBuffer(EConstantBufferSlot::PerDirectionalLight, &directionalLightConstants, sizeof(directionalLightConstants));
+
+		m_dirShadowMappingPassDescriptor.ApplyPassState(inRecordingDriver);
+
+		// The cascades of a light are executed in order, so the first one clears the whole atlas
+		if (inCascadeIndex == 0)
+		{
+			inRecordingDriver.ClearDepthStencil(m_dirShadowMappingPassDescriptor.m_depthStencilView, true, 1.0);
+		}
+
+		const float cascadeRes = static_cast<float>(RenderConstants::ShadowCascadeRes);
+		inRecordingDriver.SetViewport((inCascadeIndex % 2) * cascadeRes, (inCascadeIndex / 2) * cascadeRes, cascadeRes, cascadeRes);
+
+		DrawShadowCasters(inRecordingDriver, m_dirShadowMappingPassDescriptor, static_cast<ProgramId_t>(EProgramIdMask::Lighting_DirectionalLight), &cascade);
+	}
+
+	void URenderer::RecordPointShadowFace(UGraphicsDriver& inRecordingDriver, uint32_t inLightIndex, uint8_t inCubeFace) const
+	{
+		SPerPointLightConstants pointLightConstants = m_framePointLights[inLightIndex];
+
+		m_pointShadowMappingPassDescriptor.ApplyPassState(inRecordingDriver);
+
+		// Bind the current side of the shadow texture cube
+		m_depthTextureCube->BindCubeSideAsTarget(inRecordingDriver, inCubeFace);
+
+		// Update the view-projection matrix of the current cube side in the per point light constant buffer
+		pointLightConstants.m_pointLight.m_viewProjectionMatrix = pointLightConstants.m_pointLightVPMatrices[inCubeFace];
+		inRecordingDriver.UpdateBuffer(EConstantBufferSlot::PerPointLight, &pointLightConstants, sizeof(pointLightConstants));
+
+		DrawShadowCasters(inRecordingDriver, m_pointShadowMappingPassDescriptor, static_cast<ProgramId_t>(EProgramIdMask::Lighting_PointLight));
+	}
+
+	void URenderer::RecordDebugPrimitives(UGraphicsDriver& inRecordingDriver) const
+	{
+		m_debugPassDescriptor.ApplyPassState(inRecordingDriver);
+		m_debugPassDescriptor.m_renderPassProgram->SetProgramActive(inRecordingDriver, 0);
+
+		// Process the debug draw items
+		for (const auto& currentDebugDrawItem : m_debugDrawItems)
+		{
+			currentDebugDrawItem.m_debugDrawItem.Draw(inRecordingDriver, m_perFrameConstants, false);
+		}
+	}
+
+	void URenderer::DrawShadowCasters(UGraphicsDriver& inRecordingDriver, const SRenderPassDescriptor& inShadowPass, ProgramId_t inShadowProgramId, const SShadowCascade* inCascade) const
+	{
+		const RasterizerStatePtr_t rasterizerState = inShadowPass.m_rasterizerState;
+
+		// Cascades only need the casters that can reach the part of the frustum they cover
+		const auto canCastShadow = [inCascade](const Vector4& inWorldBounds)
+		{
+			return !inCascade || UShadowCascades::CanCastIntoCascade(*inCascade, Vector3(inWorldBounds.x, inWorldBounds.y, inWorldBounds.z), inWorldBounds.w);
+		};
+
+		inShadowPass.m_renderPassProgram->SetProgramActive(inRecordingDriver, inShadowProgramId);
+
+		GPU_MARKER_START(&inRecordingDriver, L"Static");
+		for (const auto& currentStaticItem : m_staticSnapshot)
+		{
+			if (canCastShadow(m_frameWorldBounds[currentStaticItem.m_objectToWorldIndex]))
 			{
-				m_reflectionPassDescriptor.m_renderPassProgram->SetProgramActive(g_graphicsDriver, programIdOverride & DetermineProgramId(currentDynamicDrawItem.second));
+				currentStaticItem.m_drawItem->Draw(inRecordingDriver, m_perFrameConstants, false, EInputLayoutSemantic::Position, rasterizerState, &currentStaticItem.m_uploadedConstants, currentStaticItem.m_shadowLOD);
+			}
+		}
+		GPU_MARKER_END(&inRecordingDriver);
 
-				currentDynamicDrawItem.second.Draw(g_graphicsDriver, inFramePercent, perFrameConstants, true, reflectionInputLayoutOverride);
+		GPU_MARKER_START(&inRecordingDriver, L"Dynamic");
+		for (const auto& currentDynamicItem : m_dynamicSnapshot)
+		{
+			if (canCastShadow(m_frameWorldBounds[currentDynamicItem.m_objectToWorldIndex]))
+			{
+				currentDynamicItem.m_drawItem->Draw(inRecordingDriver, m_perFrameConstants, false, EInputLayoutSemantic::Position, rasterizerState, &currentDynamicItem.m_uploadedConstants, currentDynamicItem.m_shadowLOD);
 			}
-			GPU_EVENT_END(&g_graphicsDriver);
+		}
+		GPU_MARKER_END(&inRecordingDriver);
 
-			GPU_EVENT_END(&g_graphicsDriver);
+		GPU_MARKER_START(&inRecordingDriver, L"Reflection_Probes");
+		for (const auto& currentProbeItem : m_reflectionProbeSnapshot)
+		{
+			if (canCastShadow(m_frameWorldBounds[currentProbeItem.m_objectToWorldIndex]))
+			{
+				currentProbeItem.m_drawItem->Draw(inRecordingDriver, m_perFrameConstants, false, EInputLayoutSemantic::Position, rasterizerState, &currentProbeItem.m_uploadedConstants);
+			}
 		}
+		GPU_MARKER_END(&inRecordingDriver);
 
-		GPU_EVENT_END(&g_graphicsDriver);
+		if (!m_instancedSnapshot.empty())
+		{
+			GPU_MARKER_START(&inRecordingDriver, L"Instanced");
+			inShadowPass.m_renderPassProgram->SetProgramActive(inRecordingDriver, inShadowProgramId | static_cast<ProgramId_t>(EProgramIdMask::Geometry_Instanced));
+			for (const auto& currentInstancedItem : m_instancedSnapshot)
+			{
+				// Groups are culled as a whole
+				if (canCastShadow(currentInstancedItem.m_worldBounds))
+				{
+					currentInstancedItem.m_snapshot.m_drawItem->DrawInstanced(inRecordingDriver, currentInstancedItem.m_instances, false, EInputLayoutSemantic::Position, rasterizerState, nullptr, currentInstancedItem.m_snapshot.m_shadowLOD);
+				}
+			}
+			GPU_MARKER_END(&inRecordingDriver);
+		}
+	}
 
-		BindPerFrameConstants();
-		SetViewport(m_screenViewport);
+	void URenderer::FitDirectionalShadowCascades(const Vector3& inWSLightDirection, SPerDirectionalLightConstants& inOutLightConstants)
+	{
+		const uint32_t cascadeCount = SPerDirectionalLightConstants::CascadeCount;
+		const float shadowDistance = eastl::min(m_perFrameConstants.m_cameraFarPlane, RenderConstants::ShadowCascadeDistance);
+
+		SShadowCascade cascades[cascadeCount];
+		UShadowCascades::FitCascades(inWSLightDirection,
+									 m_perFrameConstants.m_cameraInverseViewMatrix,
+									 m_perFrameConstants.m_cameraProjectionMatrix,
+									 m_perFrameConstants.m_cameraNearPlane,
+									 shadowDistance,
+									 RenderConstants::ShadowCascadeSplitLambda,
+									 cascadeCount,
+									 RenderConstants::ShadowCascadeRes,
+									 RenderConstants::ShadowCascadeDistance,
+									 cascades);
+
+		for (uint32_t i = 0; i < cascadeCount; ++i)
+		{
+			inOutLightConstants.m_cascadeViewProjectionMatrices[i] = cascades[i].m_viewProjectionMatrix;
+			inOutLightConstants.m_cascadeSplitDepths[i] = cascades[i].m_splitFar;
+			m_frameDirCascades.push_back(cascades[i]);
+		}
+
+		inOutLightConstants.m_directionalLight.m_viewProjectionMatrix = inOutLightConstants.m_cascadeViewProjectionMatrices[0];
+		inOutLightConstants.m_shadowAtlasTexelSize = 1.0f / (RenderConstants::ShadowCascadeRes * 2);
 	}
 
 	void URenderer::DoVisualizeGBuffer()
@@ -0,0 +1,138 @@
+#include "Rendering/ShadowCascades.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/fixed_vector.h>
+
+#include "Misc/Assert.h"
+
+namespace MAD
+{
+	void UShadowCascades::CalculateSplitDistances(float inNear, float inFar, float inSplitLambda, uint32_t inCascadeCount, float* outSplitDistances)
+	{
+		MAD_ASSERT_DESC(inNear > 0.0f && inFar > inNear, "Invalid shadow cascade range");
+
+		for (uint32_t i = 1; i <= inCascadeCount; ++i)
+		{
+			const float slicePercent = static_cast<float>(i) / inCascadeCount;
+			const float logSplit = inNear * powf(inFar / inNear, slicePercent);
+			const float uniformSplit = inNear + (inFar - inNear) * slicePercent;
+
+			outSplitDistances[i - 1] = inSplitLambda * logSplit + (1.0f - inSplitLambda) * uniformSplit;
+		}
+	}
+
+	SShadowCascade UShadowCascades::FitCascade(const Vector3& inLightDirection, const Matrix& inCameraInverseViewMatrix, const Matrix& inCameraProjectionMatrix, float inSliceNear, float inSliceFar, uint32_t inShadowMapResolution, float inCasterDepthExtension)
+	{
+		SShadowCascade cascade;
+		cascade.m_splitNear = inSliceNear;
+		cascade.m_splitFar = inSliceFar;
+
+		// Corners of the frustum slice in world space. The camera looks down -Z in view space
+		const float tanHalfFovX = 1.0f / inCameraProjectionMatrix._11;
+		const float tanHalfFovY = 1.0f / inCameraProjectionMatrix._22;
+		const float sliceDistances[2] = { inSliceNear, inSliceFar };
+
+		Vector3 vsCorners[8];
+		Vector3 wsCorners[8];
+		Vector3 vsSliceCenter = Vector3::Zero;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			const float distance = sliceDistances[i / 4];
+			const float x = (i & 1) ? distance * tanHalfFovX : -distance * tanHalfFovX;
+			const float y = (i & 2) ? distance * tanHalfFovY : -distance * tanHalfFovY;
+
+			vsCorners[i] = Vector3(x, y, -distance);
+			wsCorners[i] = Vector3::Transform(vsCorners[i], inCameraInverseViewMatrix);
+			vsSliceCenter += vsCorners[i];
+		}
+
+		vsSliceCenter /= 8.0f;
+
+		// The bounding sphere of the slice doesn't change as the camera moves or rotates, which keeps the size of a shadow
+		// texel constant. It's measured in view space, where the world space rounding errors can't nudge it over a step
+		float sliceRadius = 0.0f;
+		for (const auto& currentCorner : vsCorners)
+		{
+			sliceRadius = eastl::max(sliceRadius, Vector3::Distance(currentCorner, vsSliceCenter));
+		}
+
+		sliceRadius = ceilf(sliceRadius * 16.0f) / 16.0f;
+
+		// The light view sits at the origin so that its texel grid is fixed in world space
+		Vector3 lightDirection = inLightDirection;
+		lightDirection.Normalize();
+
+		const Vector3 lightUp = fabsf(lightDirection.y) > 0.99f ? Vector3::UnitZ : Vector3::Up;
+		cascade.m_lightViewMatrix = Matrix::CreateLookAt(Vector3::Zero, lightDirection, lightUp);
+
+		Vector3 lsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+		Vector3 lsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+		for (const auto& currentCorner : wsCorners)
+		{
+			const Vector3 lsCorner = Vector3::Transform(currentCorner, cascade.m_lightViewMatrix);
+
+			lsMin = Vector3::Min(lsMin, lsCorner);
+			lsMax = Vector3::Max(lsMax, lsCorner);
+		}
+
+		// The window is one texel wider than the sphere so that snapping its origin can never uncover the slice
+		const float texelSize = (2.0f * sliceRadius) / static_cast<float>(inShadowMapResolution - 1);
+		const float windowSize = texelSize * inShadowMapResolution;
+
+		const Vector2 lsSliceCenter((lsMin.x + lsMax.x) * 0.5f, (lsMin.y + lsMax.y) * 0.5f);
+
+		cascade.m_lightSpaceMin.x = floorf((lsSliceCenter.x - sliceRadius) / texelSize) * texelSize;
+		cascade.m_lightSpaceMin.y = floorf((lsSliceCenter.y - sliceRadius) / texelSize) * texelSize;
+		cascade.m_lightSpaceMax = cascade.m_lightSpaceMin + Vector2(windowSize, windowSize);
+
+		// Depth is tight around the slice, apart from the extension towards the light for casters in front of it
+		cascade.m_lightSpaceNear = -lsMax.z - inCasterDepthExtension;
+		cascade.m_lightSpaceFar = -lsMin.z;
+
+		const Matrix projectionMatrix = Matrix::CreateOrthographicOffCenter(cascade.m_lightSpaceMin.x, cascade.m_lightSpaceMax.x,
+																			cascade.m_lightSpaceMin.y, cascade.m_lightSpaceMax.y,
+																			cascade.m_lightSpaceNear, cascade.m_lightSpaceFar);
+
+		cascade.m_viewProjectionMatrix = cascade.m_lightViewMatrix * projectionMatrix;
+
+		return cascade;
+	}
+
+	void UShadowCascades::FitCascades(const Vector3& inLightDirection, const Matrix& inCameraInverseViewMatrix, const Matrix& inCameraProjectionMatrix, float inNear, float inShadowDistance, float inSplitLambda, uint32_t inCascadeCount, uint32_t inShadowMapResolution, float inCasterDepthExtension, SShadowCascade* outCascades)
+	{
+		eastl::fixed_vector<float, 8> splitDistances(inCascadeCount);
+		CalculateSplitDistances(inNear, inShadowDistance, inSplitLambda, inCascadeCount, splitDistances.data());
+
+		float sliceNear = inNear;
+		for (uint32_t i = 0; i < inCascadeCount; ++i)
+		{
+			outCascades[i] = FitCascade(inLightDirection, inCameraInverseViewMatrix, inCameraProjectionMatrix, sliceNear, splitDistances[i], inShadowMapResolution, inCasterDepthExtension);
+			sliceNear = splitDistances[i];
+		}
+	}
+
+	bool UShadowCascades::CanCastIntoCascade(const SShadowCascade& inCascade, const Vector3& inWSCenter, float inRadius)
+	{
+		if (inRadius < 0.0f)
+		{
+			return true;
+		}
+
+		const Vector3 lsCenter = Vector3::Transform(inWSCenter, inCascade.m_lightViewMatrix);
+
+		if (lsCenter.x + inRadius < inCascade.m_lightSpaceMin.x || lsCenter.x - inRadius > inCascade.m_lightSpaceMax.x ||
+			lsCenter.y + inRadius < inCascade.m_lightSpaceMin.y || lsCenter.y - inRadius > inCascade.m_lightSpaceMax.y)
+		{
+			return false;
+		}
+
+		// Anything between the light and the cascade still casts into it (it gets clamped onto the near plane), only
+		// casters completely behind the cascade can be skipped
+		return -lsCenter.z - inRadius <= inCascade.m_lightSpaceFar;
+	}
+}
@@ -2,12 +2,84 @@
 
 #include "Core/GameEngine.h"
 #include "Misc/AssetCache.h"
+#include "Misc/AsyncAssetLoader.h"
 #include "Misc/Logging.h"
+#include "Misc/MappedFile.h"
 #include "Rendering/GraphicsDriver.h"
 #include "Rendering/Renderer.h"
+#include "Rendering/TextureCooker.h"
+#include "Rendering/TextureStreamer.h"
 
 namespace MAD
 {
+	namespace
+	{
+		// Block compressed formats are handled by the caller, 0 for formats the textures are never created with
+		size_t GetBitsPerPixel(DXGI_FORMAT inFormat)
+		{
+			switch (inFormat)
+			{
+			case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			case DXGI_FORMAT_R32G32B32A32_UINT:
+				return 128;
+			case DXGI_FORMAT_R32G32B32_FLOAT:
+				return 96;
+			case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			case DXGI_FORMAT_R16G16B16A16_UNORM:
+			case DXGI_FORMAT_R32G32_FLOAT:
+				return 64;
+			case DXGI_FORMAT_R8G8B8A8_UNORM:
+			case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+			case DXGI_FORMAT_B8G8R8A8_UNORM:
+			case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+			case DXGI_FORMAT_B8G8R8X8_UNORM:
+			case DXGI_FORMAT_R10G10B10A2_UNORM:
+			case DXGI_FORMAT_R11G11B10_FLOAT:
+			case DXGI_FORMAT_R32_FLOAT:
+			case DXGI_FORMAT_R16G16_FLOAT:
+			case DXGI_FORMAT_R24G8_TYPELESS:
+			case DXGI_FORMAT_R32_TYPELESS:
+				return 32;
+			case DXGI_FORMAT_R16_FLOAT:
+			case DXGI_FORMAT_R16_UNORM:
+			case DXGI_FORMAT_R8G8_UNORM:
+			case DXGI_FORMAT_B5G6R5_UNORM:
+				return 16;
+			case DXGI_FORMAT_R8_UNORM:
+			case DXGI_FORMAT_A8_UNORM:
+				return 8;
+			default:
+				return 0;
+			}
+		}
+
+		// Bytes per 4x4 block, 0 if the format isn't block compressed
+		size_t GetBytesPerBlock(DXGI_FORMAT inFormat)
+		{
+			switch (inFormat)
+			{
+			case DXGI_FORMAT_BC1_UNORM:
+			case DXGI_FORMAT_BC1_UNORM_SRGB:
+			case DXGI_FORMAT_BC4_UNORM:
+			case DXGI_FORMAT_BC4_SNORM:
+				return 8;
+			case DXGI_FORMAT_BC2_UNORM:
+			case DXGI_FORMAT_BC2_UNORM_SRGB:
+			case DXGI_FORMAT_BC3_UNORM:
+			case DXGI_FORMAT_BC3_UNORM_SRGB:
+			case DXGI_FORMAT_BC5_UNORM:
+			case DXGI_FORMAT_BC5_SNORM:
+			case DXGI_FORMAT_BC6H_UF16:
+			case DXGI_FORMAT_BC6H_SF16:
+			case DXGI_FORMAT_BC7_UNORM:
+			case DXGI_FORMAT_BC7_UNORM_SRGB:
+				return 16;
+			default:
+				return 0;
+			}
+		}
+	}
+
 	eastl::shared_ptr<UTexture> UTexture::Load(const eastl::string& inRelativePath, bool inLoadAsSRGB, bool inGenerateMips, int32_t inMiscFlags)
 	{
 		if (auto cachedTexture = UAssetCache::GetCachedResource<UTexture>(inRelativePath))
@@ -15,6 +87,17 @@ namespace MAD
 			return cachedTexture;
 		}
 
+		// Cooked textures come with their whole mip chain. Misc flags are only used for special textures (e.g. cube maps)
+		if (inMiscFlags == 0)
+		{
+			if (auto cookedTexture = CreateFromCookedFile(inRelativePath, inLoadAsSRGB))
+			{
+				UTextureStreamer::Register(cookedTexture);
+				UAssetCache::InsertResource<UTexture>(inRelativePath, cookedTexture);
+				return cookedTexture;
+			}
+		}
+
 		eastl::string fullPath = UAssetCache::GetAssetRoot() + inRelativePath;
 
 		uint64_t width, height;
@@ -35,6 +118,123 @@ namespace MAD
 		return ret;
 	}
 
+	TAssetHandle<UTexture> UTexture::LoadAsync(const eastl::string& inRelativePath, bool inLoadAsSRGB, bool inGenerateMips, int32_t inMiscFlags)
+	{
+		bool isNewLoad = false;
+		TAssetHandle<UTexture> loadHandle = UAssetCache::FindOrBeginLoad<UTexture>(inRelativePath, isNewLoad);
+		if (!isNewLoad)
+		{
+			return loadHandle;
+		}
+
+		UAsyncAssetLoader::QueueLoad([loadHandle, inLoadAsSRGB, inGenerateMips, inMiscFlags]()
+		{
+			// Cooked textures never need the immediate context, only registering them with the streamer is main thread only
+			if (inMiscFlags == 0)
+			{
+				if (auto cookedTexture = CreateFromCookedFile(loadHandle.GetPath(), inLoadAsSRGB))
+				{
+					UAsyncAssetLoader::QueueFinalize([loadHandle, cookedTexture]()
+					{
+						UTextureStreamer::Register(cookedTexture);
+						UAssetCache::CompleteLoad(loadHandle, cookedTexture);
+						return true;
+					});
+					return;
+				}
+			}
+
+			// Keep the file mapped until the texture has been created from it
+			auto textureFile = eastl::make_shared<UMappedFile>();
+			const bool isFileMapped = textureFile->Open(UAssetCache::GetAssetRoot() + loadHandle.GetPath());
+
+			if (isFileMapped && !inGenerateMips)
+			{
+				if (auto texture = CreateFromMemory(loadHandle.GetPath(), textureFile->GetData(), textureFile->GetSize(), inLoadAsSRGB, false, inMiscFlags))
+				{
+					UAssetCache::CompleteLoad(loadHandle, texture);
+					return;
+				}
+			}
+
+			UAsyncAssetLoader::QueueFinalize([loadHandle, textureFile, isFileMapped, inLoadAsSRGB, inGenerateMips, inMiscFlags]()
+			{
+				eastl::shared_ptr<UTexture> texture;
+				if (isFileMapped && inGenerateMips)
+				{
+					texture = CreateFromMemory(loadHandle.GetPath(), textureFile->GetData(), textureFile->GetSize(), inLoadAsSRGB, true, inMiscFlags);
+				}
+
+				if (!texture)
+				{
+					LOG(LogDefault, Warning, "Failed to load texture: `%s`. Falling back to default checker.png", loadHandle.GetPath().c_str());
+					texture = GetDefaultTexture();
+				}
+
+				UAssetCache::CompleteLoad(loadHandle, texture);
+				return true;
+			});
+		});
+
+		return loadHandle;
+	}
+
+	eastl::shared_ptr<UTexture> UTexture::CreateFromMemory(const eastl::string& inRelativePath, const void* inData, size_t inDataSize, bool inLoadAsSRGB, bool inGenerateMips, int32_t inMiscFlags)
+	{
+		const size_t extensionStart = inRelativePath.find_last_of('.');
+		const eastl::string extension = extensionStart != eastl::string::npos ? inRelativePath.substr(extensionStart) : eastl::string();
+
+		uint64_t width, height;
+		auto tex = gEngine->GetRenderer().GetGraphicsDriver().CreateTextureFromMemory(inData, inDataSize, extension, width, height, inLoadAsSRGB, inGenerateMips, inMiscFlags);
+		if (!tex)
+		{
+			return nullptr;
+		}
+
+		auto ret = eastl::make_shared<UTexture>();
+		ret->m_width = width;
+		ret->m_height = height;
+		ret->m_textureSRV = tex;
+
+		LOG(LogDefault, Log, "Loaded texture `%s`. sRGB=%i generateMips=%i\n", inRelativePath.c_str(), inLoadAsSRGB, inGenerateMips);
+		return ret;
+	}
+
+	eastl::shared_ptr<UTexture> UTexture::CreateFromCookedFile(const eastl::string& inRelativePath, bool inLoadAsSRGB)
+	{
+		const eastl::string sourcePath = UAssetCache::GetAssetRoot() + inRelativePath;
+		const eastl::string cookedPath = UTextureCooker::GetCookedTexturePath(sourcePath);
+
+		UMappedFile cookedFile;
+		SCookedTextureInfo cookedInfo;
+		if (!cookedFile.Open(cookedPath) || !UTextureCooker::ReadCookedTextureInfo(cookedFile.GetData(), cookedFile.GetSize(), sourcePath, cookedInfo))
+		{
+			return nullptr;
+		}
+
+		// Start out with only the smallest mips, the mips are stored largest first so this only reads the end of the file
+		const uint32_t residentSize = eastl::min(UTextureStreamer::MinResidentSize, eastl::max(cookedInfo.m_width, cookedInfo.m_height));
+
+		uint64_t residentWidth, residentHeight;
+		auto tex = gEngine->GetRenderer().GetGraphicsDriver().CreateTextureFromMemory(cookedFile.GetData(), cookedFile.GetSize(), ".dds", residentWidth, residentHeight, inLoadAsSRGB, false, 0, residentSize);
+		if (!tex)
+		{
+			return nullptr;
+		}
+
+		auto ret = eastl::make_shared<UTexture>();
+		ret->m_width = cookedInfo.m_width;
+		ret->m_height = cookedInfo.m_height;
+		ret->m_textureSRV = tex;
+		ret->m_cookedPath = cookedPath;
+		ret->m_relativePath = inRelativePath;
+		ret->m_isSRGB = inLoadAsSRGB;
+		ret->m_residentSize = residentSize;
+
+		LOG(LogDefault, Log, "Loaded cooked texture `%s`. sRGB=%i mips=%u\n", inRelativePath.c_str(), inLoadAsSRGB, cookedInfo.m_mipCount);
+		return ret;
+	}
+
 	eastl::shared_ptr<UTexture> UTexture::GetDefaultTexture()
 	{
 		static const eastl::string defaultTexture = "engine\\meshes\\primitives\\checker.png";
@@ -62,7 +262,56 @@ namespace MAD
 		return ret;
 	}
 
+	size_t UTexture::GetMemorySize() const
+	{
+		if (!m_textureSRV.Get())
+		{
+			return 0;
+		}
+
+		ComPtr<ID3D11Resource> textureResource;
+		const_cast<ID3D11ShaderResourceView*>(m_textureSRV.Get())->GetResource(textureResource.GetAddressOf());
+
+		ComPtr<ID3D11Texture2D> texture2D;
+		if (FAILED(textureResource.As(&texture2D)))
+		{
+			return 0;
+		}
+
+		D3D11_TEXTURE2D_DESC textureDesc;
+		texture2D->GetDesc(&textureDesc);
+
+		size_t memorySize = 0;
+		UINT mipWidth = textureDesc.Width;
+		UINT mipHeight = textureDesc.Height;
+
+		const size_t bytesPerBlock = GetBytesPerBlock(textureDesc.Format);
+		const size_t bitsPerPixel = bytesPerBlock > 0 ? 0 : GetBitsPerPixel(textureDesc.Format);
+
+		for (UINT i = 0; i < textureDesc.MipLevels; ++i)
+		{
+			if (bytesPerBlock > 0)
+			{
+				memorySize += ((mipWidth + 3) / 4) * ((mipHeight + 3) / 4) * bytesPerBlock;
+			}
+			else
+			{
+				memorySize += (static_cast<size_t>(mipWidth) * mipHeight * bitsPerPixel) / 8;
+			}
+
+			mipWidth = eastl::max(mipWidth / 2, 1U);
+			mipHeight = eastl::max(mipHeight / 2, 1U);
+		}
+
+		return memorySize * textureDesc.ArraySize;
+	}
+
 	UTexture::UTexture(): m_width(0)
 	                    , m_height(0)
-	                    , m_textureSRV() { }
+	                    , m_textureSRV()
+	                    , m_isSRGB(false)
+	                    , m_isStreamingInFlight(false)
+	                    , m_residentSize(0)
+	                    , m_requestedSize(0)
+	                    , m_requestFrame(0) { }
 }
@@ -0,0 +1,671 @@
+#include "Rendering/TextureCooker.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <wincodec.h>
+#include <wrl/client.h>
+
+#include <EASTL/algorithm.h>
+#include <EASTL/vector.h>
+
+#include "Core/SimpleMath.h"
+#include "Misc/CookedFile.h"
+#include "Misc/Logging.h"
+#include "Misc/utf8conv.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogTextureImport);
+
+	const uint32_t UTextureCooker::CookedTextureVersion = 1;
+
+	namespace
+	{
+		const uint32_t g_ddsMagic = 0x20534444; // "DDS "
+		const uint32_t g_ddsFourCCDX10 = 0x30315844; // "DX10"
+		const uint32_t g_cookedTextureMagic = 0x5444414D; // "MADT"
+
+		// DDS header flags, only the ones the cooker writes
+		const uint32_t g_ddsdCaps = 0x1;
+		const uint32_t g_ddsdHeight = 0x2;
+		const uint32_t g_ddsdWidth = 0x4;
+		const uint32_t g_ddsdPitch = 0x8;
+		const uint32_t g_ddsdPixelFormat = 0x1000;
+		const uint32_t g_ddsdMipMapCount = 0x20000;
+		const uint32_t g_ddsdLinearSize = 0x80000;
+		const uint32_t g_ddpfFourCC = 0x4;
+		const uint32_t g_ddsCapsComplex = 0x8;
+		const uint32_t g_ddsCapsTexture = 0x1000;
+		const uint32_t g_ddsCapsMipMap = 0x400000;
+		const uint32_t g_ddsResourceDimensionTexture2D = 3;
+
+		struct SDDSPixelFormat
+		{
+			uint32_t m_size;
+			uint32_t m_flags;
+			uint32_t m_fourCC;
+			uint32_t m_rgbBitCount;
+			uint32_t m_rBitMask;
+			uint32_t m_gBitMask;
+			uint32_t m_bBitMask;
+			uint32_t m_aBitMask;
+		};
+
+		struct SDDSHeader
+		{
+			uint32_t m_size;
+			uint32_t m_flags;
+			uint32_t m_height;
+			uint32_t m_width;
+			uint32_t m_pitchOrLinearSize;
+			uint32_t m_depth;
+			uint32_t m_mipMapCount;
+			uint32_t m_reserved1[11]; // Unused by DDS readers, see ECookedReservedWord
+			SDDSPixelFormat m_pixelFormat;
+			uint32_t m_caps;
+			uint32_t m_caps2;
+			uint32_t m_caps3;
+			uint32_t m_caps4;
+			uint32_t m_reserved2;
+		};
+
+		struct SDDSHeaderDX10
+		{
+			uint32_t m_dxgiFormat;
+			uint32_t m_resourceDimension;
+			uint32_t m_miscFlag;
+			uint32_t m_arraySize;
+			uint32_t m_miscFlags2;
+		};
+
+		// Where the cooker's own data goes in SDDSHeader::m_reserved1
+		namespace ECookedReservedWord
+		{
+			enum Type
+			{
+				Magic,
+				Version,
+				SourceSizeLow,
+				SourceSizeHigh,
+				SourceWriteTimeLow,
+				SourceWriteTimeHigh
+			};
+		}
+
+		const size_t g_cookedHeaderSize = sizeof(uint32_t) + sizeof(SDDSHeader) + sizeof(SDDSHeaderDX10);
+
+		// One level of the mip chain, filtered in linear space
+		struct SMipImage
+		{
+			uint32_t m_width;
+			uint32_t m_height;
+			eastl::vector<Vector4> m_pixels;
+		};
+
+		float SRGBToLinear(float inValue)
+		{
+			return inValue <= 0.04045f ? inValue / 12.92f : powf((inValue + 0.055f) / 1.055f, 2.4f);
+		}
+
+		float LinearToSRGB(float inValue)
+		{
+			return inValue <= 0.0031308f ? inValue * 12.92f : 1.055f * powf(inValue, 1.0f / 2.4f) - 0.055f;
+		}
+
+		uint8_t ToUNorm8(float inValue)
+		{
+			return static_cast<uint8_t>(eastl::min(eastl::max(inValue, 0.0f), 1.0f) * 255.0f + 0.5f);
+		}
+
+		bool DecodeSourceImage(const eastl::string& inSourcePath, uint32_t& outWidth, uint32_t& outHeight, eastl::vector<uint8_t>& outRGBA)
+		{
+			ComPtr<IWICImagingFactory> imagingFactory;
+			if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(imagingFactory.GetAddressOf()))))
+			{
+				LOG(LogTextureImport, Error, "Failed to create the WIC imaging factory, is COM initialized?\n");
+				return false;
+			}
+
+			const eastl::wstring widePath = utf8util::UTF16FromUTF8(inSourcePath);
+
+			ComPtr<IWICBitmapDecoder> decoder;
+			ComPtr<IWICBitmapFrameDecode> frame;
+			ComPtr<IWICFormatConverter> converter;
+
+			if (FAILED(imagingFactory->CreateDecoderFromFilename(widePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf()))
+				|| FAILED(decoder->GetFrame(0, frame.GetAddressOf()))
+				|| FAILED(frame->GetSize(&outWidth, &outHeight))
+				|| FAILED(imagingFactory->CreateFormatConverter(converter.GetAddressOf()))
+				|| FAILED(converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)))
+			{
+				LOG(LogTextureImport, Error, "Failed to decode texture '%s'\n", inSourcePath.c_str());
+				return false;
+			}
+
+			outRGBA.resize(static_cast<size_t>(outWidth) * outHeight * 4);
+
+			if (FAILED(converter->CopyPixels(nullptr, outWidth * 4, static_cast<UINT>(outRGBA.size()), outRGBA.data())))
+			{
+				LOG(LogTextureImport, Error, "Failed to decode texture '%s'\n", inSourcePath.c_str());
+				return false;
+			}
+
+			return true;
+		}
+
+		void ConvertToMipImage(uint32_t inWidth, uint32_t inHeight, const eastl::vector<uint8_t>& inRGBA, ETextureUsage inUsage, SMipImage& outImage)
+		{
+			outImage.m_width = inWidth;
+			outImage.m_height = inHeight;
+			outImage.m_pixels.resize(static_cast<size_t>(inWidth) * inHeight);
+
+			float srgbToLinear[256];
+			for (int i = 0; i < 256; ++i)
+			{
+				srgbToLinear[i] = SRGBToLinear(i / 255.0f);
+			}
+
+			for (size_t i = 0; i < outImage.m_pixels.size(); ++i)
+			{
+				const uint8_t* sourcePixel = &inRGBA[i * 4];
+				Vector4& pixel = outImage.m_pixels[i];
+
+				switch (inUsage)
+				{
+				case ETextureUsage::Color:
+					pixel = Vector4(srgbToLinear[sourcePixel[0]], srgbToLinear[sourcePixel[1]], srgbToLinear[sourcePixel[2]], sourcePixel[3] / 255.0f);
+					break;
+				case ETextureUsage::NormalMap:
+					pixel = Vector4(sourcePixel[0] / 127.5f - 1.0f, sourcePixel[1] / 127.5f - 1.0f, sourcePixel[2] / 127.5f - 1.0f, sourcePixel[3] / 255.0f);
+					break;
+				case ETextureUsage::Mask:
+					pixel = Vector4(sourcePixel[0] / 255.0f);
+					break;
+				}
+			}
+		}
+
+		// 2x2 box filter. Odd dimensions clamp the last row or column
+		void DownsampleMipImage(const SMipImage& inSource, ETextureUsage inUsage, SMipImage& outImage)
+		{
+			outImage.m_width = eastl::max(inSource.m_width / 2, 1u);
+			outImage.m_height = eastl::max(inSource.m_height / 2, 1u);
+			outImage.m_pixels.resize(static_cast<size_t>(outImage.m_width) * outImage.m_height);
+
+			for (uint32_t y = 0; y < outImage.m_height; ++y)
+			{
+				const uint32_t sourceY0 = eastl::min(y * 2, inSource.m_height - 1);
+				const uint32_t sourceY1 = eastl::min(y * 2 + 1, inSource.m_height - 1);
+
+				for (uint32_t x = 0; x < outImage.m_width; ++x)
+				{
+					const uint32_t sourceX0 = eastl::min(x * 2, inSource.m_width - 1);
+					const uint32_t sourceX1 = eastl::min(x * 2 + 1, inSource.m_width - 1);
+
+					Vector4 pixel = inSource.m_pixels[sourceY0 * inSource.m_width + sourceX0]
+								  + inSource.m_pixels[sourceY0 * inSource.m_width + sourceX1]
+								  + inSource.m_pixels[sourceY1 * inSource.m_width + sourceX0]
+								  + inSource.m_pixels[sourceY1 * inSource.m_width + sourceX1];
+					pixel *= 0.25f;
+
+					// Averaged normals get shorter, which would darken the lighting of distant surfaces
+					if (inUsage == ETextureUsage::NormalMap)
+					{
+						Vector3 normal(pixel.x, pixel.y, pixel.z);
+						normal.Normalize();
+						pixel = Vector4(normal.x, normal.y, normal.z, pixel.w);
+					}
+
+					outImage.m_pixels[y * outImage.m_width + x] = pixel;
+				}
+			}
+		}
+
+		void ConvertToRGBA8(const SMipImage& inImage, ETextureUsage inUsage, eastl::vector<uint8_t>& outRGBA)
+		{
+			outRGBA.resize(inImage.m_pixels.size() * 4);
+
+			for (size_t i = 0; i < inImage.m_pixels.size(); ++i)
+			{
+				const Vector4& pixel = inImage.m_pixels[i];
+				uint8_t* targetPixel = &outRGBA[i * 4];
+
+				switch (inUsage)
+				{
+				case ETextureUsage::Color:
+					targetPixel[0] = ToUNorm8(LinearToSRGB(pixel.x));
+					targetPixel[1] = ToUNorm8(LinearToSRGB(pixel.y));
+					targetPixel[2] = ToUNorm8(LinearToSRGB(pixel.z));
+					break;
+				case ETextureUsage::NormalMap:
+					targetPixel[0] = ToUNorm8(pixel.x * 0.5f + 0.5f);
+					targetPixel[1] = ToUNorm8(pixel.y * 0.5f + 0.5f);
+					targetPixel[2] = ToUNorm8(pixel.z * 0.5f + 0.5f);
+					break;
+				case ETextureUsage::Mask:
+					targetPixel[0] = targetPixel[1] = targetPixel[2] = ToUNorm8(pixel.x);
+					break;
+				}
+
+				targetPixel[3] = ToUNorm8(pixel.w);
+			}
+		}
+
+		uint16_t PackColor565(int inRed, int inGreen, int inBlue)
+		{
+			return static_cast<uint16_t>((((inRed * 31 + 127) / 255) << 11) | (((inGreen * 63 + 127) / 255) << 5) | ((inBlue * 31 + 127) / 255));
+		}
+
+		void UnpackColor565(uint16_t inColor, int outColor[3])
+		{
+			const int red = (inColor >> 11) & 0x1F;
+			const int green = (inColor >> 5) & 0x3F;
+			const int blue = inColor & 0x1F;
+
+			outColor[0] = (red << 3) | (red >> 2);
+			outColor[1] = (green << 2) | (green >> 4);
+			outColor[2] = (blue << 3) | (blue >> 2);
+		}
+
+		/*
+			Range fit: the endpoints are the corners of the colors' bounding box, inset a little since the extremes are rarely
+			worth an endpoint of their own. The box's diagonal is flipped along the axes that are anti-correlated with green,
+			so that it follows the colors instead of cutting across them.
+		*/
+		void EncodeBC1Block(const uint8_t inPixels[16][4], uint8_t* outBlock)
+		{
+			int minColor[3] = { 255, 255, 255 };
+			int maxColor[3] = { 0, 0, 0 };
+			int colorSum[3] = { 0, 0, 0 };
+
+			for (int i = 0; i < 16; ++i)
+			{
+				for (int c = 0; c < 3; ++c)
+				{
+					minColor[c] = eastl::min(minColor[c], static_cast<int>(inPixels[i][c]));
+					maxColor[c] = eastl::max(maxColor[c], static_cast<int>(inPixels[i][c]));
+					colorSum[c] += inPixels[i][c];
+				}
+			}
+
+			int covarianceRG = 0;
+			int covarianceBG = 0;
+
+			for (int i = 0; i < 16; ++i)
+			{
+				const int centeredGreen = inPixels[i][1] * 16 - colorSum[1];
+				covarianceRG += (inPixels[i][0] * 16 - colorSum[0]) * centeredGreen;
+				covarianceBG += (inPixels[i][2] * 16 - colorSum[2]) * centeredGreen;
+			}
+
+			if (covarianceRG < 0)
+			{
+				eastl::swap(minColor[0], maxColor[0]);
+			}
+
+			if (covarianceBG < 0)
+			{
+				eastl::swap(minColor[2], maxColor[2]);
+			}
+
+			for (int c = 0; c < 3; ++c)
+			{
+				const int inset = (maxColor[c] - minColor[c]) / 16;
+				maxColor[c] -= inset;
+				minColor[c] += inset;
+			}
+
+			uint16_t color0 = PackColor565(maxColor[0], maxColor[1], maxColor[2]);
+			uint16_t color1 = PackColor565(minColor[0], minColor[1], minColor[2]);
+
+			// color0 > color1 selects the four color mode, equal endpoints just use color0 everywhere
+			if (color0 < color1)
+			{
+				eastl::swap(color0, color1);
+			}
+
+			uint32_t indices = 0;
+
+			if (color0 != color1)
+			{
+				int palette[4][3];
+				UnpackColor565(color0, palette[0]);
+				UnpackColor565(color1, palette[1]);
+
+				for (int c = 0; c < 3; ++c)
+				{
+					palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+				}
+
+				for (int i = 0; i < 16; ++i)
+				{
+					int bestIndex = 0;
+					int bestDistance = INT_MAX;
+
+					for (int p = 0; p < 4; ++p)
+					{
+						const int deltaRed = inPixels[i][0] - palette[p][0];
+						const int deltaGreen = inPixels[i][1] - palette[p][1];
+						const int deltaBlue = inPixels[i][2] - palette[p][2];
+						const int distance = deltaRed * deltaRed + deltaGreen * deltaGreen + deltaBlue * deltaBlue;
+
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							bestIndex = p;
+						}
+					}
+
+					indices |= static_cast<uint32_t>(bestIndex) << (i * 2);
+				}
+			}
+
+			memcpy(outBlock, &color0, sizeof(color0));
+			memcpy(outBlock + 2, &color1, sizeof(color1));
+			memcpy(outBlock + 4, &indices, sizeof(indices));
+		}
+
+		// Single channel block, also used for the alpha half of BC3. Always uses the eight value mode
+		void EncodeBC4Block(const uint8_t inPixels[16][4], int inChannel, uint8_t* outBlock)
+		{
+			int minValue = 255;
+			int maxValue = 0;
+
+			for (int i = 0; i < 16; ++i)
+			{
+				minValue = eastl::min(minValue, static_cast<int>(inPixels[i][inChannel]));
+				maxValue = eastl::max(maxValue, static_cast<int>(inPixels[i][inChannel]));
+			}
+
+			int palette[8];
+			palette[0] = maxValue;
+			palette[1] = minValue;
+
+			for (int p = 2; p < 8; ++p)
+			{
+				palette[p] = ((8 - p) * maxValue + (p - 1) * minValue) / 7;
+			}
+
+			uint64_t indices = 0;
+
+			for (int i = 0; i < 16; ++i)
+			{
+				int bestIndex = 0;
+				int bestDistance = INT_MAX;
+
+				for (int p = 0; p < 8; ++p)
+				{
+					const int distance = abs(inPixels[i][inChannel] - palette[p]);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestIndex = p;
+					}
+				}
+
+				indices |= static_cast<uint64_t>(bestIndex) << (i * 3);
+			}
+
+			outBlock[0] = static_cast<uint8_t>(maxValue);
+			outBlock[1] = static_cast<uint8_t>(minValue);
+
+			for (int i = 0; i < 6; ++i)
+			{
+				outBlock[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+			}
+		}
+
+		size_t GetBlockSize(DXGI_FORMAT inFormat)
+		{
+			return inFormat == DXGI_FORMAT_BC3_UNORM ? 16 : 8;
+		}
+
+		// Appends the mip in the cooked format. Blocks that hang over the edge of small mips repeat the edge pixels
+		void EncodeMip(const eastl::vector<uint8_t>& inRGBA, uint32_t inWidth, uint32_t inHeight, DXGI_FORMAT inFormat, eastl::vector<uint8_t>& inOutData)
+		{
+			if (inFormat == DXGI_FORMAT_R8G8B8A8_UNORM)
+			{
+				inOutData.insert(inOutData.end(), inRGBA.begin(), inRGBA.end());
+				return;
+			}
+
+			const uint32_t blocksWide = (inWidth + 3) / 4;
+			const uint32_t blocksHigh = (inHeight + 3) / 4;
+			const size_t blockSize = GetBlockSize(inFormat);
+
+			size_t blockOffset = inOutData.size();
+			inOutData.resize(blockOffset + blocksWide * blocksHigh * blockSize);
+
+			uint8_t blockPixels[16][4];
+
+			for (uint32_t blockY = 0; blockY < blocksHigh; ++blockY)
+			{
+				for (uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+				{
+					for (uint32_t i = 0; i < 16; ++i)
+					{
+						const uint32_t x = eastl::min(blockX * 4 + i % 4, inWidth - 1);
+						const uint32_t y = eastl::min(blockY * 4 + i / 4, inHeight - 1);
+						memcpy(blockPixels[i], &inRGBA[(static_cast<size_t>(y) * inWidth + x) * 4], 4);
+					}
+
+					uint8_t* block = &inOutData[blockOffset];
+
+					switch (inFormat)
+					{
+					case DXGI_FORMAT_BC1_UNORM:
+						EncodeBC1Block(blockPixels, block);
+						break;
+					case DXGI_FORMAT_BC3_UNORM:
+						EncodeBC4Block(blockPixels, 3, block);
+						EncodeBC1Block(blockPixels, block + 8);
+						break;
+					case DXGI_FORMAT_BC4_UNORM:
+						EncodeBC4Block(blockPixels, 0, block);
+						break;
+					default:
+						MAD_ASSERT_DESC(false, "Unhandled cooked texture format");
+						break;
+					}
+
+					blockOffset += blockSize;
+				}
+			}
+		}
+
+		DXGI_FORMAT SelectCookedFormat(const SMipImage& inTopMip, ETextureUsage inUsage)
+		{
+			// Block compressed textures need their top mip to be made of whole blocks
+			if (inTopMip.m_width % 4 != 0 || inTopMip.m_height % 4 != 0)
+			{
+				return DXGI_FORMAT_R8G8B8A8_UNORM;
+			}
+
+			switch (inUsage)
+			{
+			case ETextureUsage::Mask:
+				return DXGI_FORMAT_BC4_UNORM;
+			case ETextureUsage::NormalMap:
+				return DXGI_FORMAT_BC1_UNORM;
+			default:
+				for (const auto& currentPixel : inTopMip.m_pixels)
+				{
+					if (currentPixel.w < 1.0f)
+					{
+						return DXGI_FORMAT_BC3_UNORM;
+					}
+				}
+
+				return DXGI_FORMAT_BC1_UNORM;
+			}
+		}
+	}
+
+	eastl::string UTextureCooker::GetCookedTexturePath(const eastl::string& inSourcePath)
+	{
+		return inSourcePath + ".dds";
+	}
+
+	bool UTextureCooker::CookTexture(const eastl::string& inSourcePath, ETextureUsage inUsage)
+	{
+		uint64_t sourceFileSize = 0;
+		uint64_t sourceWriteTime = 0;
+		if (!UCookedFile::GetSourceFileStamp(inSourcePath, sourceFileSize, sourceWriteTime))
+		{
+			LOG(LogTextureImport, Error, "Failed to read the attributes of texture '%s'\n", inSourcePath.c_str());
+			return false;
+		}
+
+		uint32_t sourceWidth = 0;
+		uint32_t sourceHeight = 0;
+		eastl::vector<uint8_t> sourceRGBA;
+		if (!DecodeSourceImage(inSourcePath, sourceWidth, sourceHeight, sourceRGBA))
+		{
+			return false;
+		}
+
+		// Full chain down to 1x1, each level is filtered from the one above it
+		eastl::vector<SMipImage> mipChain(1);
+		ConvertToMipImage(sourceWidth, sourceHeight, sourceRGBA, inUsage, mipChain[0]);
+
+		while (mipChain.back().m_width > 1 || mipChain.back().m_height > 1)
+		{
+			SMipImage nextMip;
+			DownsampleMipImage(mipChain.back(), inUsage, nextMip);
+			mipChain.push_back(eastl::move(nextMip));
+		}
+
+		const DXGI_FORMAT cookedFormat = SelectCookedFormat(mipChain[0], inUsage);
+
+		eastl::vector<uint8_t> mipData;
+		eastl::vector<uint8_t> mipRGBA;
+		size_t topMipSize = 0;
+
+		for (const auto& currentMip : mipChain)
+		{
+			ConvertToRGBA8(currentMip, inUsage, mipRGBA);
+			EncodeMip(mipRGBA, currentMip.m_width, currentMip.m_height, cookedFormat, mipData);
+
+			if (topMipSize == 0)
+			{
+				topMipSize = mipData.size();
+			}
+		}
+
+		const bool isBlockCompressed = cookedFormat != DXGI_FORMAT_R8G8B8A8_UNORM;
+
+		SDDSHeader ddsHeader;
+		memset(&ddsHeader, 0, sizeof(ddsHeader));
+		ddsHeader.m_size = sizeof(SDDSHeader);
+		ddsHeader.m_flags = g_ddsdCaps | g_ddsdHeight | g_ddsdWidth | g_ddsdPixelFormat | g_ddsdMipMapCount | (isBlockCompressed ? g_ddsdLinearSize : g_ddsdPitch);
+		ddsHeader.m_height = sourceHeight;
+		ddsHeader.m_width = sourceWidth;
+		ddsHeader.m_pitchOrLinearSize = isBlockCompressed ? static_cast<uint32_t>(topMipSize) : sourceWidth * 4;
+		ddsHeader.m_mipMapCount = static_cast<uint32_t>(mipChain.size());
+		ddsHeader.m_reserved1[ECookedReservedWord::Magic] = g_cookedTextureMagic;
+		ddsHeader.m_reserved1[ECookedReservedWord::Version] = CookedTextureVersion;
+		ddsHeader.m_reserved1[ECookedReservedWord::SourceSizeLow] = static_cast<uint32_t>(sourceFileSize);
+		ddsHeader.m_reserved1[ECookedReservedWord::SourceSizeHigh] = static_cast<uint32_t>(sourceFileSize >> 32);
+		ddsHeader.m_reserved1[ECookedReservedWord::SourceWriteTimeLow] = static_cast<uint32_t>(sourceWriteTime);
+		ddsHeader.m_reserved1[ECookedReservedWord::SourceWriteTimeHigh] = static_cast<uint32_t>(sourceWriteTime >> 32);
+		ddsHeader.m_pixelFormat.m_size = sizeof(SDDSPixelFormat);
+		ddsHeader.m_pixelFormat.m_flags = g_ddpfFourCC;
+		ddsHeader.m_pixelFormat.m_fourCC = g_ddsFourCCDX10;
+		ddsHeader.m_caps = g_ddsCapsTexture | (mipChain.size() > 1 ? g_ddsCapsComplex | g_ddsCapsMipMap : 0);
+
+		SDDSHeaderDX10 dx10Header;
+		memset(&dx10Header, 0, sizeof(dx10Header));
+		dx10Header.m_dxgiFormat = cookedFormat;
+		dx10Header.m_resourceDimension = g_ddsResourceDimensionTexture2D;
+		dx10Header.m_arraySize = 1;
+
+		const eastl::string cookedPath = GetCookedTexturePath(inSourcePath);
+		std::ofstream cookedStream(cookedPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!cookedStream.is_open())
+		{
+			LOG(LogTextureImport, Error, "Failed to open cooked texture '%s' for writing\n", cookedPath.c_str());
+			return false;
+		}
+
+		// The mips are stored largest first, so a streamed load of the smaller mips only reads the end of the file
+		cookedStream.write(reinterpret_cast<const char*>(&g_ddsMagic), sizeof(g_ddsMagic));
+		cookedStream.write(reinterpret_cast<const char*>(&ddsHeader), sizeof(ddsHeader));
+		cookedStream.write(reinterpret_cast<const char*>(&dx10Header), sizeof(dx10Header));
+		cookedStream.write(reinterpret_cast<const char*>(mipData.data()), mipData.size());
+
+		if (!cookedStream.good())
+		{
+			LOG(LogTextureImport, Error, "Failed to write cooked texture '%s'\n", cookedPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool UTextureCooker::IsCookedTextureUpToDate(const eastl::string& inSourcePath)
+	{
+		std::ifstream cookedStream(GetCookedTexturePath(inSourcePath).c_str(), std::ios::in | std::ios::binary);
+		if (!cookedStream.is_open())
+		{
+			return false;
+		}
+
+		uint8_t cookedHeader[g_cookedHeaderSize];
+		if (!cookedStream.read(reinterpret_cast<char*>(cookedHeader), sizeof(cookedHeader)))
+		{
+			return false;
+		}
+
+		SCookedTextureInfo cookedInfo;
+		return ReadCookedTextureInfo(cookedHeader, sizeof(cookedHeader), inSourcePath, cookedInfo);
+	}
+
+	bool UTextureCooker::ReadCookedTextureInfo(const void* inCookedData, size_t inCookedDataSize, const eastl::string& inSourcePath, SCookedTextureInfo& outInfo)
+	{
+		if (inCookedDataSize < g_cookedHeaderSize)
+		{
+			return false;
+		}
+
+		const uint8_t* cursor = static_cast<const uint8_t*>(inCookedData);
+
+		uint32_t ddsMagic;
+		memcpy(&ddsMagic, cursor, sizeof(ddsMagic));
+
+		SDDSHeader ddsHeader;
+		memcpy(&ddsHeader, cursor + sizeof(ddsMagic), sizeof(ddsHeader));
+
+		if (ddsMagic != g_ddsMagic
+			|| ddsHeader.m_reserved1[ECookedReservedWord::Magic] != g_cookedTextureMagic
+			|| ddsHeader.m_reserved1[ECookedReservedWord::Version] != CookedTextureVersion)
+		{
+			return false;
+		}
+
+		uint64_t sourceFileSize = 0;
+		uint64_t sourceWriteTime = 0;
+
+		// Cooked files can ship without their source
+		if (UCookedFile::GetSourceFileStamp(inSourcePath, sourceFileSize, sourceWriteTime))
+		{
+			const uint64_t cookedSourceSize = (static_cast<uint64_t>(ddsHeader.m_reserved1[ECookedReservedWord::SourceSizeHigh]) << 32) | ddsHeader.m_reserved1[ECookedReservedWord::SourceSizeLow];
+			const uint64_t cookedSourceWriteTime = (static_cast<uint64_t>(ddsHeader.m_reserved1[ECookedReservedWord::SourceWriteTimeHigh]) << 32) | ddsHeader.m_reserved1[ECookedReservedWord::SourceWriteTimeLow];
+
+			if (cookedSourceSize != sourceFileSize || cookedSourceWriteTime != sourceWriteTime)
+			{
+				return false;
+			}
+		}
+
+		outInfo.m_width = ddsHeader.m_width;
+		outInfo.m_height = ddsHeader.m_height;
+		outInfo.m_mipCount = eastl::max(ddsHeader.m_mipMapCount, 1u);
+		return true;
+	}
+}
@@ -0,0 +1,207 @@
+#include "Rendering/TextureStreamer.h"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+
+#include "Core/GameEngine.h"
+#include "Misc/AssetCache.h"
+#include "Misc/AsyncAssetLoader.h"
+#include "Misc/Logging.h"
+#include "Misc/MappedFile.h"
+#include "Misc/Remotery.h"
+#include "Rendering/GraphicsDriver.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/Texture.h"
+
+namespace MAD
+{
+	DECLARE_LOG_CATEGORY(LogTextureStreamer);
+
+	namespace
+	{
+		// How long a texture keeps the mips it was last drawn with, so that looking away for a moment doesn't thrash them
+		const uint32_t g_requestLifetimeFrames = 120;
+
+		// Each reload rereads the cooked file and recreates the texture, so only a few run at a time
+		const uint32_t g_maxReloadsInFlight = 4;
+
+		uint32_t RoundUpToPowerOfTwo(uint32_t inValue)
+		{
+			uint32_t result = 1;
+			while (result < inValue && result < 0x80000000U)
+			{
+				result <<= 1;
+			}
+
+			return result;
+		}
+	}
+
+	eastl::vector<eastl::weak_ptr<UTexture>> UTextureStreamer::s_textures;
+	size_t UTextureStreamer::s_memoryBudget = 0;
+	size_t UTextureStreamer::s_residentMemory = 0;
+	uint32_t UTextureStreamer::s_currentFrame = 1;
+	uint32_t UTextureStreamer::s_reloadsInFlight = 0;
+
+	void UTextureStreamer::Register(const eastl::shared_ptr<UTexture>& inTexture)
+	{
+		if (inTexture && inTexture->IsStreamed())
+		{
+			s_textures.push_back(inTexture);
+		}
+	}
+
+	void UTextureStreamer::RequestSize(UTexture& inTexture, float inScreenSize)
+	{
+		const uint32_t screenSize = static_cast<uint32_t>(eastl::max(inScreenSize, 0.0f));
+
+		if (inTexture.m_requestFrame != s_currentFrame)
+		{
+			inTexture.m_requestFrame = s_currentFrame;
+			inTexture.m_requestedSize = screenSize;
+		}
+		else
+		{
+			inTexture.m_requestedSize = eastl::max(inTexture.m_requestedSize, screenSize);
+		}
+	}
+
+	void UTextureStreamer::Tick()
+	{
+		rmt_ScopedCPUSample(TextureStreamer_Tick, 0);
+
+		eastl::vector<SStreamingCandidate> candidates;
+		candidates.reserve(s_textures.size());
+
+		size_t wantedMemory = 0;
+		s_residentMemory = 0;
+
+		for (auto iter = s_textures.begin(); iter != s_textures.end();)
+		{
+			eastl::shared_ptr<UTexture> texture = iter->lock();
+			if (!texture || !texture->IsStreamed())
+			{
+				iter = s_textures.erase_unsorted(iter);
+				continue;
+			}
+
+			++iter;
+
+			const uint32_t fullSize = static_cast<uint32_t>(eastl::max(texture->m_width, texture->m_height));
+			const uint32_t minSize = eastl::min(MinResidentSize, fullSize);
+
+			const bool isRequested = texture->m_requestedSize > 0 && s_currentFrame - texture->m_requestFrame <= g_requestLifetimeFrames;
+			const uint32_t requestedSize = isRequested ? RoundUpToPowerOfTwo(texture->m_requestedSize) : minSize;
+
+			SStreamingCandidate candidate;
+			candidate.m_texture = texture;
+			candidate.m_wantedSize = eastl::max(minSize, eastl::min(requestedSize, fullSize));
+
+			// Every mip level is a quarter the size of the one above it
+			const size_t residentMemory = texture->GetMemorySize();
+			const double sizeRatio = static_cast<double>(candidate.m_wantedSize) / eastl::max(texture->m_residentSize, 1U);
+			candidate.m_wantedMemory = static_cast<size_t>(residentMemory * sizeRatio * sizeRatio);
+
+			s_residentMemory += residentMemory;
+			wantedMemory += candidate.m_wantedMemory;
+
+			candidates.push_back(candidate);
+		}
+
+		// Most important first, which is the texture that covers the most of the screen
+		eastl::sort(candidates.begin(), candidates.end(), [](const SStreamingCandidate& inLeft, const SStreamingCandidate& inRight)
+		{
+			return inLeft.m_wantedSize > inRight.m_wantedSize;
+		});
+
+		// Over budget, drop a mip from the least important textures until everything fits
+		bool isShrinking = s_memoryBudget > 0;
+		while (isShrinking && wantedMemory > s_memoryBudget)
+		{
+			isShrinking = false;
+
+			for (auto iter = candidates.rbegin(); iter != candidates.rend() && wantedMemory > s_memoryBudget; ++iter)
+			{
+				const uint32_t minSize = eastl::min(MinResidentSize, static_cast<uint32_t>(eastl::max(iter->m_texture->m_width, iter->m_texture->m_height)));
+				if (iter->m_wantedSize / 2 < minSize)
+				{
+					continue;
+				}
+
+				const size_t shrunkMemory = iter->m_wantedMemory / 4;
+
+				wantedMemory -= iter->m_wantedMemory - shrunkMemory;
+				iter->m_wantedSize /= 2;
+				iter->m_wantedMemory = shrunkMemory;
+				isShrinking = true;
+			}
+		}
+
+		for (const auto& currentCandidate : candidates)
+		{
+			if (s_reloadsInFlight >= g_maxReloadsInFlight)
+			{
+				break;
+			}
+
+			UTexture& texture = *currentCandidate.m_texture;
+			if (!texture.m_isStreamingInFlight && texture.m_residentSize != currentCandidate.m_wantedSize)
+			{
+				QueueReload(currentCandidate.m_texture, currentCandidate.m_wantedSize);
+			}
+		}
+
+		++s_currentFrame;
+	}
+
+	void UTextureStreamer::QueueReload(const eastl::shared_ptr<UTexture>& inTexture, uint32_t inWantedSize)
+	{
+		inTexture->m_isStreamingInFlight = true;
+		++s_reloadsInFlight;
+
+		eastl::weak_ptr<UTexture> weakTexture = inTexture;
+		const eastl::string cookedPath = inTexture->m_cookedPath;
+		const bool isSRGB = inTexture->m_isSRGB;
+
+		UAsyncAssetLoader::QueueLoad([weakTexture, cookedPath, isSRGB, inWantedSize]()
+		{
+			// Creating the texture only touches the device, so the whole reload except the swap happens here
+			ShaderResourcePtr_t streamedSRV;
+
+			UMappedFile cookedFile;
+			if (cookedFile.Open(cookedPath))
+			{
+				uint64_t residentWidth, residentHeight;
+				streamedSRV = gEngine->GetRenderer().GetGraphicsDriver().CreateTextureFromMemory(cookedFile.GetData(), cookedFile.GetSize(), ".dds", residentWidth, residentHeight, isSRGB, false, 0, inWantedSize);
+			}
+
+			UAsyncAssetLoader::QueueFinalize([weakTexture, cookedPath, streamedSRV, inWantedSize]()
+			{
+				--s_reloadsInFlight;
+
+				eastl::shared_ptr<UTexture> texture = weakTexture.lock();
+				if (!texture)
+				{
+					return true;
+				}
+
+				texture->m_isStreamingInFlight = false;
+
+				if (!streamedSRV)
+				{
+					// Keep whatever is resident and stop streaming, the cooked file is gone or broken
+					LOG(LogTextureStreamer, Warning, "Failed to stream cooked texture `%s`, keeping its resident mips\n", cookedPath.c_str());
+					texture->m_cookedPath.clear();
+					return true;
+				}
+
+				texture->m_textureSRV = streamedSRV;
+				texture->m_residentSize = inWantedSize;
+
+				// The cache only measured the mips that were resident when the texture was inserted
+				UAssetCache::UpdateMemorySize<UTexture>(texture->m_relativePath);
+				return true;
+			});
+		});
+	}
+}
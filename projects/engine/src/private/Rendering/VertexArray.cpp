@@ -8,16 +8,19 @@ namespace MAD
 								, m_bufferSize(0)
 								, m_arrayUsage()
 								, m_arraySemantic(EInputLayoutSemantic::INVALID)
+								, m_formatFlags(EInputLayoutFormat::None)
 	{ }
 
 	UVertexArray::UVertexArray(class UGraphicsDriver& inGraphicsDriver, VertexBufferSlotType_t inSlot, EInputLayoutSemantic::Type inSemantic,
-							   const void* inVertexData, uint32_t inVertexSize, uint32_t inVertexCount, EResourceUsage inUsage, ECPUAccess inCPUAccessFlag)
+							   const void* inVertexData, uint32_t inVertexSize, uint32_t inVertexCount, EResourceUsage inUsage, ECPUAccess inCPUAccessFlag,
+							   InputLayoutFlags_t inFormatFlags)
 	{
 		m_vertexSize = inVertexSize;
 		m_vertexCount = inVertexCount;
 		m_bufferSize = inVertexSize * m_vertexCount;
 		m_arrayUsage = inSlot;
 		m_arraySemantic = inSemantic;
+		m_formatFlags = inFormatFlags;
 		m_buffer = inGraphicsDriver.CreateVertexBuffer(inVertexData, m_bufferSize, inUsage, inCPUAccessFlag);
 	}
 